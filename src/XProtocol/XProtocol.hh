@@ -253,12 +253,14 @@ enum XPrepRequestOption {
 
 // Flags for kXR_decrypt and kXR_sigver
 enum XSecFlags {
-   kXR_nodata   = 1  // Request payload was not hashed or encrypted
+   kXR_nodata   = 1, // Request payload was not hashed or encrypted
+   kXR_hmackey  = 2  // The encrypted hmac key follows the hmac
 };
 
 // Cryptography used for kXR_sigver SigverRequest::crypto
 enum XSecCrypto {
    kXR_SHA256   = 0x01,   // Hash used
+   kXR_HMAC256  = 0x02,   // Keyed hash (HMAC-SHA256) used
    kXR_HashMask = 0x0f,   // Mak to extract the hash type
    kXR_rsaKey   = 0x80    // The rsa key was used
 };
@@ -687,6 +689,7 @@ struct ServerResponseReqs_Protocol {
 //
 #define kXR_secOData 0x01
 #define kXR_secOFrce 0x02
+#define kXR_secOHmac 0x04
 
 // Security level definitions (these are predefined but can be over-ridden)
 //
@@ -91,29 +91,22 @@ XrdAccGroups::XrdAccGroups()
 char *XrdAccGroups::AddName(const XrdAccGroupType gtype, const char *name)
 {
    char *np;
-   XrdOucHash<char> *hp;
+   XrdOucCHash<char> *hp;
 
 // Prepare to add a group name
 //
    if (gtype == XrdAccNetGroup) {hp = &NetGroup_Names; HaveNetGroups = 1;}
       else {hp = &Group_Names; HaveGroups = 1;}
 
-// Lock the Name hash table
-//
-   Group_Name_Context.Lock();
-
 // Add a name into the name hash table. We need to only keep a single
-// read/only copy of the group name to speed multi-threading.
+// read/only copy of the group name to speed multi-threading. Names are never
+// deleted so the one found remains valid.
 //
-   if (!(np = hp->Find(name)))
-      {hp->Add(name, 0, 0, Hash_data_is_key);
-       if (!(np = hp->Find(name)))
-           cerr <<"XrdAccGroups: Unable to add group " <<name <<endl;
-      }
+   if (!(np = hp->Add(name, 0, 0, Hash_data_is_key)) && !(np = hp->Find(name)))
+      cerr <<"XrdAccGroups: Unable to add group " <<name <<endl;
 
 // All done.
 //
-   Group_Name_Context.UnLock();
    return np;
 }
 
@@ -123,21 +116,11 @@ char *XrdAccGroups::AddName(const XrdAccGroupType gtype, const char *name)
   
 char *XrdAccGroups::FindName(const XrdAccGroupType gtype, const char *name)
 {
-   char *np;
-
-// Lock the Name hash table
-//
-   Group_Name_Context.Lock();
 
 // Lookup the actual name in the hash table
 //
-   if (gtype == XrdAccNetGroup) np = NetGroup_Names.Find(name);
-      else np = Group_Names.Find(name);
-
-// All done.
-//
-   Group_Name_Context.UnLock();
-   return np;
+   if (gtype == XrdAccNetGroup) return NetGroup_Names.Find(name);
+   return Group_Names.Find(name);
 }
   
 /******************************************************************************/
@@ -160,18 +143,13 @@ char *Gtab[NGROUPS_MAX];
    if (!HaveGroups) return (XrdAccGroupList *)0;
 
 
-// Check if we already have this user in the group cache. Since we may be
-// modifying the cache, we need to have exclusive control over it. We must
-// copy the group cache because the original may be deleted at any time.
+// Check if we already have this user in the group cache. We must copy the
+// group cache entry because the original may be deleted at any time.
 //
-   Group_Cache_Context.Lock();
-   if ((glist = Group_Cache.Find(user)))
-      {if (glist->First()) glist = new XrdAccGroupList(*glist);
-          else glist = 0;
-       Group_Cache_Context.UnLock();
+   if ((glist = Group_Cache.Copy(user)))
+      {if (!glist->First()) {delete glist; glist = 0;}
        return glist;
       }
-   Group_Cache_Context.UnLock();
 
 // If the user has no password file entry, then we have no groups for user.
 // All code that tries to construct a group list is protected by the
@@ -213,11 +191,10 @@ char *Gtab[NGROUPS_MAX];
 //
    glist = new XrdAccGroupList(gtabi, (const char **)Gtab);
 
-// Add this user to the group cache to speed things up the next time
+// Add this user to the group cache to speed things up the next time. Another
+// thread may have just done the same, ours simply replaces it.
 //
-   Group_Cache_Context.Lock();
-   Group_Cache.Add(user, glist, LifeTime);
-   Group_Cache_Context.UnLock();
+   Group_Cache.Rep(user, glist, LifeTime);
 
 // Return a copy of the group list since the original may be deleted
 //
@@ -249,20 +226,16 @@ int XrdAccCheckNetGroup(const char *netgroup, char *key, void *Arg);
    uh_key[i] = '@';
    strcpy(&uh_key[i+1], host);
 
-// Check if we already have this user in the group cache. Since we may be
-// modifying the cache, we need to have exclusive control over it. We must
-// copy the group cache entry because the original may be deleted at any time.
+// Check if we already have this user in the group cache. We must copy the
+// group cache entry because the original may be deleted at any time.
 //
-   NetGroup_Cache_Context.Lock();
-   if ((glist = NetGroup_Cache.Find(uh_key)))
-      {if (glist->First()) glist = new XrdAccGroupList(*glist);
-          else glist = 0;
-       NetGroup_Cache_Context.UnLock();
+   if ((glist = NetGroup_Cache.Copy(uh_key)))
+      {if (!glist->First()) {delete glist; glist = 0;}
        return glist;
       }
-   NetGroup_Cache_Context.UnLock();
 
-// For each known netgroup, check to see if the user is in the netgroup.
+// For each known netgroup, check to see if the user is in the netgroup. The
+// walk is serialized as innetgr() is not MT-safe.
 //
    GroupTab.user  = user;
    GroupTab.host  = host;
@@ -278,9 +251,7 @@ int XrdAccCheckNetGroup(const char *netgroup, char *key, void *Arg);
 
 // Add this user to the group cache to speed things up the next time
 //
-   NetGroup_Cache_Context.Lock();
-   NetGroup_Cache.Add((const char *)uh_key, glist, LifeTime);
-   NetGroup_Cache_Context.UnLock();
+   NetGroup_Cache.Rep((const char *)uh_key, glist, LifeTime);
 
 // Return a copy of the group list
 //
@@ -298,15 +269,11 @@ void XrdAccGroups::PurgeCache()
 
 // Purge the group cache
 //
-   Group_Cache_Context.Lock();
    Group_Cache.Purge();
-   Group_Cache_Context.UnLock();
 
 // Purge the netgroup cache
 //
-   NetGroup_Cache_Context.Lock();
    NetGroup_Cache.Purge();
-   NetGroup_Cache_Context.UnLock();
 }
   
 /******************************************************************************/
@@ -193,14 +193,26 @@ namespace
       // Run the task
       //------------------------------------------------------------------------
       time_t Run( time_t now )
+      {
+        return RunMs( (uint64_t)now*1000 )/1000;
+      }
+
+      //------------------------------------------------------------------------
+      // Run the task, the expiration checks are cheap so they are done
+      // at the pace of the task manager, the request deadlines are whole
+      // seconds though
+      //------------------------------------------------------------------------
+      uint64_t RunMs( uint64_t now )
       {
         using namespace XrdCl;
-        pChannel->Tick( now );
+        pChannel->Tick( now/1000 );
 
         Env *env = DefaultEnv::GetEnv();
-        int timeoutResolution = DefaultTimeoutResolution;
-        env->GetInt( "TimeoutResolution", timeoutResolution );
-        return now+timeoutResolution;
+        int timerResolution = DefaultTimerResolution;
+        env->GetInt( "TimerResolution", timerResolution );
+        if( timerResolution <= 0 )
+          timerResolution = DefaultTimerResolution;
+        return now+timerResolution;
       }
     private:
       XrdCl::Channel *pChannel;
@@ -217,7 +229,8 @@ namespace XrdCl
                     Poller           *poller,
                     TransportHandler *transport,
                     TaskManager      *taskManager,
-                    JobManager       *jobManager ):
+                    JobManager       *jobManager,
+                    Resolver         *resolver ):
     pUrl( url.GetHostId() ),
     pPoller( poller ),
     pTransport( transport ),
@@ -225,12 +238,8 @@ namespace XrdCl
     pTickGenerator( 0 ),
     pJobManager( jobManager )
   {
-    Env *env = DefaultEnv::GetEnv();
     Log *log = DefaultEnv::GetLog();
 
-    int  timeoutResolution = DefaultTimeoutResolution;
-    env->GetInt( "TimeoutResolution", timeoutResolution );
-
     pTransport->InitializeChannel( pChannelData );
     uint16_t numStreams = transport->StreamNumber( pChannelData );
     log->Debug( PostMasterMsg, "Creating new channel to: %s %d stream(s)",
@@ -250,6 +259,7 @@ namespace XrdCl
       pStreams[i]->SetIncomingQueue( &pIncoming );
       pStreams[i]->SetTaskManager( taskManager );
       pStreams[i]->SetJobManager( jobManager );
+      pStreams[i]->SetResolver( resolver );
       pStreams[i]->SetChannelData( &pChannelData );
       pStreams[i]->Initialize();
     }
@@ -258,7 +268,7 @@ namespace XrdCl
     // Register the task generating timeout events
     //--------------------------------------------------------------------------
     pTickGenerator = new TickGeneratorTask( this, pUrl.GetHostId() );
-    pTaskManager->RegisterTask( pTickGenerator, ::time(0)+timeoutResolution );
+    pTaskManager->RegisterTask( pTickGenerator, ::time(0)+1 );
   }
 
   //----------------------------------------------------------------------------
@@ -343,6 +353,15 @@ namespace XrdCl
       (*it)->Tick( now );
   }
 
+  //----------------------------------------------------------------------------
+  // Connect the channel if it is not connected yet
+  //----------------------------------------------------------------------------
+  Status Channel::Preconnect()
+  {
+    PathID path( 0, 0 );
+    return pStreams[0]->EnableLink( path );
+  }
+
   //----------------------------------------------------------------------------
   // Query the transport handler
   //----------------------------------------------------------------------------
@@ -37,6 +37,7 @@ namespace XrdCl
 {
   class Stream;
   class JobManager;
+  class Resolver;
   class VirtualRedirector;
 
   //----------------------------------------------------------------------------
@@ -53,12 +54,14 @@ namespace XrdCl
       //! @param transport   protocol specific transport handler
       //! @param taskManager async task handler to be used by the channel
       //! @param jobManager  worker thread handler to be used by the channel
+      //! @param resolver    host name resolver to be used by the channel
       //------------------------------------------------------------------------
       Channel( const URL        &url,
                Poller           *poller,
                TransportHandler *transport,
                TaskManager      *taskManager,
-               JobManager       *jobManager );
+               JobManager       *jobManager,
+               Resolver         *resolver );
 
       //------------------------------------------------------------------------
       //! Destructor
@@ -129,6 +132,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       Status Receive( IncomingMsgHandler *handler, time_t expires );
 
+      //------------------------------------------------------------------------
+      //! Connect the channel if it is not connected yet
+      //------------------------------------------------------------------------
+      Status Preconnect();
+
       //------------------------------------------------------------------------
       //! Query the transport handler
       //!
@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClCheckSumHelper.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClUtils.hh"
+#include "XrdCl/XrdClCheckSumManager.hh"
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksData.hh"
+
+#include <arpa/inet.h>
+#include <string.h>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  CheckSumHelper::CheckSumHelper( const std::string &name,
+                                  const std::string &ckSumType,
+                                  uint64_t           maxHeld ):
+    pName( name ),
+    pCkSumType( ckSumType ),
+    pCksCalcObj( 0 ),
+    pCombinable( false ),
+    pValue( 0 ),
+    pNextOffset( 0 ),
+    pQueued( 0 ),
+    pHeld( 0 ),
+    pMaxHeld( maxHeld ),
+    pOverflow( false ),
+    pRunning( false ),
+    pStop( false ),
+    pCond( 0 )
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  CheckSumHelper::~CheckSumHelper()
+  {
+    Stop();
+
+    while( !pQueue.empty() )
+    {
+      delete [] pQueue.front().buffer;
+      pQueue.pop();
+    }
+    std::map<uint64_t, Piece>::iterator itr;
+    for( itr = pPieces.begin(); itr != pPieces.end(); ++itr )
+      delete [] itr->second.buffer;
+
+    delete pCksCalcObj;
+  }
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  XRootDStatus CheckSumHelper::Initialize()
+  {
+    if( pCkSumType.empty() )
+      return XRootDStatus();
+
+    Log             *log    = DefaultEnv::GetLog();
+    CheckSumManager *cksMan = DefaultEnv::GetCheckSumManager();
+
+    if( !cksMan )
+    {
+      log->Error( UtilityMsg, "Unable to get the checksum manager" );
+      return XRootDStatus( stError, errInternal );
+    }
+
+    pCksCalcObj = cksMan->GetCalculator( pCkSumType );
+    if( !pCksCalcObj )
+    {
+      log->Error( UtilityMsg, "Unable to get a calculator for %s",
+                  pCkSumType.c_str() );
+      return XRootDStatus( stError, errCheckSumError );
+    }
+
+    pCombinable = ( pCkSumType == "adler32" || pCkSumType == "zcrc32" );
+    pValue      = ( pCkSumType == "adler32" ) ? adler32( 0L, Z_NULL, 0 ) :
+                                                crc32( 0L, Z_NULL, 0 );
+
+    int rc = XrdSysThread::Run( &pThread, Run, this, XRDSYSTHREAD_HOLD,
+                                "Checksum helper" );
+    if( rc )
+    {
+      log->Error( UtilityMsg, "Unable to start the checksum thread for "
+                  "%s: %s", pName.c_str(), strerror( rc ) );
+      return XRootDStatus( stError, errInternal, rc );
+    }
+    pRunning = true;
+
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Update the checksum
+  //----------------------------------------------------------------------------
+  void CheckSumHelper::Update( uint64_t offset, char *buffer, uint32_t size )
+  {
+    if( !pRunning )
+    {
+      delete [] buffer;
+      return;
+    }
+
+    XrdSysCondVarHelper lck( pCond );
+    while( pQueued >= kMaxQueued )
+      pCond.Wait();
+    pQueue.push( Piece( offset, size, buffer ) );
+    pQueued += size;
+    pCond.Broadcast();
+  }
+
+  //----------------------------------------------------------------------------
+  // Get checksum
+  //----------------------------------------------------------------------------
+  XRootDStatus CheckSumHelper::GetCheckSum( std::string &checkSum,
+                                            std::string &checkSumType )
+  {
+    Log *log = DefaultEnv::GetLog();
+
+    //--------------------------------------------------------------------------
+    // Sanity check
+    //--------------------------------------------------------------------------
+    if( !pCksCalcObj )
+    {
+      log->Error( UtilityMsg, "Calculator for %s was not initialized",
+                  pCkSumType.c_str() );
+      return XRootDStatus( stError, errCheckSumError );
+    }
+
+    int          calcSize = 0;
+    std::string  calcType = pCksCalcObj->Type( calcSize );
+
+    if( calcType != checkSumType )
+    {
+      log->Error( UtilityMsg, "Calculated checksum: %s, requested "
+                  "checksum: %s", pCkSumType.c_str(),
+                  checkSumType.c_str() );
+      return XRootDStatus( stError, errCheckSumError );
+    }
+
+    //--------------------------------------------------------------------------
+    // Wait for the checksum thread to consume everything
+    //--------------------------------------------------------------------------
+    Stop();
+    if( pOverflow )
+    {
+      log->Debug( UtilityMsg, "Checksum for %s: more than %llu bytes "
+                  "came out of order", pName.c_str(),
+                  (unsigned long long)pMaxHeld );
+      return XRootDStatus( stError, errCheckSumError );
+    }
+    if( !pPieces.empty() )
+    {
+      log->Error( UtilityMsg, "Checksum for %s: the data after offset "
+                  "%llu is not contiguous", pName.c_str(),
+                  (unsigned long long)pNextOffset );
+      return XRootDStatus( stError, errCheckSumError );
+    }
+
+    //--------------------------------------------------------------------------
+    // Response, the combined checksums have the same binary
+    // representation as the output of their calculators
+    //--------------------------------------------------------------------------
+    XrdCksData ckSum;
+    ckSum.Set( checkSumType.c_str() );
+    if( pCombinable )
+    {
+      uint32_t value = pValue;
+      if( pCkSumType == "adler32" ) value = htonl( value );
+      ckSum.Set( (void*)&value, sizeof( value ) );
+    }
+    else
+      ckSum.Set( (void*)pCksCalcObj->Final(), calcSize );
+    char *cksBuffer = new char[265];
+    ckSum.Get( cksBuffer, 256 );
+    checkSum  = checkSumType + ":";
+    checkSum += Utils::NormalizeChecksum( checkSumType, cksBuffer );
+    delete [] cksBuffer;
+
+    log->Dump( UtilityMsg, "Checksum for %s is: %s", pName.c_str(),
+               checkSum.c_str() );
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Tell if we gave up
+  //----------------------------------------------------------------------------
+  bool CheckSumHelper::Overflowed()
+  {
+    Stop();
+    return pOverflow;
+  }
+
+  //----------------------------------------------------------------------------
+  // Thread body
+  //----------------------------------------------------------------------------
+  void *CheckSumHelper::Run( void *arg )
+  {
+    static_cast<CheckSumHelper*>( arg )->Process();
+    return 0;
+  }
+
+  void CheckSumHelper::Process()
+  {
+    while( 1 )
+    {
+      Piece piece;
+      {
+        XrdSysCondVarHelper lck( pCond );
+        while( pQueue.empty() && !pStop )
+          pCond.Wait();
+        if( pQueue.empty() ) return;
+        piece = pQueue.front();
+        pQueue.pop();
+      }
+
+      //------------------------------------------------------------------------
+      // We gave up, just drop the data
+      //------------------------------------------------------------------------
+      if( pOverflow )
+        delete [] piece.buffer;
+      else if( pCombinable )
+      {
+        const Bytef *data = reinterpret_cast<const Bytef*>( piece.buffer );
+        piece.value = ( pCkSumType == "adler32" ) ?
+                      adler32( adler32( 0L, Z_NULL, 0 ), data, piece.length ) :
+                      crc32( crc32( 0L, Z_NULL, 0 ), data, piece.length );
+        delete [] piece.buffer;
+        piece.buffer = 0;
+      }
+      uint32_t size = piece.length;
+      if( !pOverflow ) Hold( piece );
+
+      XrdSysCondVarHelper lck( pCond );
+      pQueued -= size;
+      pCond.Broadcast();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Hold the piece until the data before it is there and consume whatever
+  // is contiguous; the pieces of the algorithms that cannot be combined
+  // keep their data, so we only hold so much of it, the producer cannot be
+  // blocked on that as it may be the one to deliver the missing piece
+  //----------------------------------------------------------------------------
+  void CheckSumHelper::Hold( const Piece &piece )
+  {
+    pPieces[piece.offset] = piece;
+    if( !pCombinable ) pHeld += piece.length;
+
+    //--------------------------------------------------------------------------
+    // Consume whatever is contiguous now
+    //--------------------------------------------------------------------------
+    std::map<uint64_t, Piece>::iterator itr = pPieces.begin();
+    while( itr != pPieces.end() && itr->first == pNextOffset )
+    {
+      Piece &p = itr->second;
+      if( !pCombinable )
+      {
+        pCksCalcObj->Update( p.buffer, p.length );
+        delete [] p.buffer;
+      }
+      else if( pCkSumType == "adler32" )
+        pValue = adler32_combine( pValue, p.value, p.length );
+      else
+        pValue = crc32_combine( pValue, p.value, p.length );
+      if( !pCombinable ) pHeld -= p.length;
+      pNextOffset += p.length;
+      pPieces.erase( itr++ );
+    }
+
+    if( pHeld <= pMaxHeld ) return;
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( UtilityMsg, "Checksum for %s: giving up, more than %llu "
+                "bytes came out of order", pName.c_str(),
+                (unsigned long long)pMaxHeld );
+    for( itr = pPieces.begin(); itr != pPieces.end(); ++itr )
+      delete [] itr->second.buffer;
+    pPieces.clear();
+    pHeld     = 0;
+    pOverflow = true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Process what is queued and stop the thread
+  //----------------------------------------------------------------------------
+  void CheckSumHelper::Stop()
+  {
+    if( !pRunning ) return;
+    {
+      XrdSysCondVarHelper lck( pCond );
+      pStop = true;
+      pCond.Broadcast();
+    }
+    XrdSysThread::Join( pThread, 0 );
+    pRunning = false;
+  }
+}
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_CHECKSUM_HELPER_HH__
+#define __XRD_CL_CHECKSUM_HELPER_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <zlib.h>
+#include <stdint.h>
+
+#include <map>
+#include <queue>
+#include <string>
+
+class XrdCksCalc;
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Check sum helper for local and stdio sources and destinations
+  //!
+  //! The chunks are checksummed by a thread of its own while the transfer
+  //! goes on. Adler32 and zcrc32 are computed for every chunk separately
+  //! and combined in offset order, so the chunks may come in any order,
+  //! for the other algorithms the out-of-order chunks are held back until
+  //! the gap before them is filled. If more than maxHeld bytes would have
+  //! to be held back the helper gives up, see Overflowed().
+  //----------------------------------------------------------------------------
+  class CheckSumHelper
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      CheckSumHelper( const std::string &name,
+                      const std::string &ckSumType,
+                      uint64_t           maxHeld = kMaxHeld );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      virtual ~CheckSumHelper();
+
+      //------------------------------------------------------------------------
+      //! Initialize
+      //------------------------------------------------------------------------
+      XRootDStatus Initialize();
+
+      //------------------------------------------------------------------------
+      //! Update the checksum, the helper takes over the buffer and
+      //! deletes it when done
+      //------------------------------------------------------------------------
+      void Update( uint64_t offset, char *buffer, uint32_t size );
+
+      //------------------------------------------------------------------------
+      //! Get checksum
+      //------------------------------------------------------------------------
+      XRootDStatus GetCheckSum( std::string &checkSum,
+                                std::string &checkSumType );
+
+      //------------------------------------------------------------------------
+      //! Tell if the checksum could not be computed because too much data
+      //! came out of order, the caller may then compute it from the data
+      //! at rest instead
+      //------------------------------------------------------------------------
+      bool Overflowed();
+
+    private:
+      //------------------------------------------------------------------------
+      // A chunk of data, or the checksum of a chunk for the
+      // combinable algorithms (then the buffer is null)
+      //------------------------------------------------------------------------
+      struct Piece
+      {
+        Piece( uint64_t o = 0, uint32_t l = 0, char *b = 0, uLong v = 0 ):
+          offset( o ), length( l ), buffer( b ), value( v ) {}
+        uint64_t  offset;
+        uint32_t  length;
+        char     *buffer;
+        uLong     value;
+      };
+
+      static void *Run( void *arg );
+      void Process();
+      void Hold( const Piece &piece );
+      void Stop();
+
+      static const uint64_t kMaxQueued = 67108864;
+      static const uint64_t kMaxHeld   = 67108864;
+
+      std::string                pName;
+      std::string                pCkSumType;
+      XrdCksCalc                *pCksCalcObj;
+      bool                       pCombinable;
+      uLong                      pValue;
+      uint64_t                   pNextOffset;
+      std::queue<Piece>          pQueue;
+      std::map<uint64_t, Piece>  pPieces;
+      uint64_t                   pQueued;
+      uint64_t                   pHeld;
+      uint64_t                   pMaxHeld;
+      bool                       pOverflow;
+      pthread_t                  pThread;
+      bool                       pRunning;
+      bool                       pStop;
+      XrdSysCondVar              pCond;
+  };
+}
+
+#endif // __XRD_CL_CHECKSUM_HELPER_HH__
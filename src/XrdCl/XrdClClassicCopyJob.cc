@@ -30,6 +30,7 @@
 #include "XrdCl/XrdClMonitor.hh"
 #include "XrdCl/XrdClUtils.hh"
 #include "XrdCl/XrdClCheckSumManager.hh"
+#include "XrdCl/XrdClCheckSumHelper.hh"
 #include "XrdCks/XrdCksCalc.hh"
 #include "XrdCl/XrdClUglyHacks.hh"
 #include "XrdCl/XrdClRedirectorRegistry.hh"
@@ -48,121 +49,6 @@
 
 namespace
 {
-  //----------------------------------------------------------------------------
-  //! Check sum helper for stdio
-  //----------------------------------------------------------------------------
-  class CheckSumHelper
-  {
-    public:
-      //------------------------------------------------------------------------
-      //! Constructor
-      //------------------------------------------------------------------------
-      CheckSumHelper( const std::string &name,
-                      const std::string &ckSumType ):
-        pName( name ),
-        pCkSumType( ckSumType ),
-        pCksCalcObj( 0 )
-      {};
-
-      //------------------------------------------------------------------------
-      //! Destructor
-      //------------------------------------------------------------------------
-      virtual ~CheckSumHelper()
-      {
-        delete pCksCalcObj;
-      }
-
-      //------------------------------------------------------------------------
-      //! Initialize
-      //------------------------------------------------------------------------
-      XrdCl::XRootDStatus Initialize()
-      {
-        using namespace XrdCl;
-        if( pCkSumType.empty() )
-          return XRootDStatus();
-
-        Log             *log    = DefaultEnv::GetLog();
-        CheckSumManager *cksMan = DefaultEnv::GetCheckSumManager();
-
-        if( !cksMan )
-        {
-          log->Error( UtilityMsg, "Unable to get the checksum manager" );
-          return XRootDStatus( stError, errInternal );
-        }
-
-        pCksCalcObj = cksMan->GetCalculator( pCkSumType );
-        if( !pCksCalcObj )
-        {
-          log->Error( UtilityMsg, "Unable to get a calculator for %s",
-                      pCkSumType.c_str() );
-          return XRootDStatus( stError, errCheckSumError );
-        }
-
-        return XRootDStatus();
-      }
-
-      //------------------------------------------------------------------------
-      // Update the checksum
-      //------------------------------------------------------------------------
-      void Update( const void *buffer, uint32_t size )
-      {
-        if( pCksCalcObj )
-          pCksCalcObj->Update( (const char *)buffer, size );
-      }
-
-      //------------------------------------------------------------------------
-      // Get checksum
-      //------------------------------------------------------------------------
-      XrdCl::XRootDStatus GetCheckSum( std::string &checkSum,
-                                       std::string &checkSumType )
-      {
-        using namespace XrdCl;
-        Log *log = DefaultEnv::GetLog();
-
-        //----------------------------------------------------------------------
-        // Sanity check
-        //----------------------------------------------------------------------
-        if( !pCksCalcObj )
-        {
-          log->Error( UtilityMsg, "Calculator for %s was not initialized",
-                      pCkSumType.c_str() );
-          return XRootDStatus( stError, errCheckSumError );
-        }
-
-        int          calcSize = 0;
-        std::string  calcType = pCksCalcObj->Type( calcSize );
-
-        if( calcType != checkSumType )
-        {
-          log->Error( UtilityMsg, "Calculated checksum: %s, requested "
-                      "checksum: %s", pCkSumType.c_str(),
-                      checkSumType.c_str() );
-          return XRootDStatus( stError, errCheckSumError );
-        }
-
-        //----------------------------------------------------------------------
-        // Response
-        //----------------------------------------------------------------------
-        XrdCksData ckSum;
-        ckSum.Set( checkSumType.c_str() );
-        ckSum.Set( (void*)pCksCalcObj->Final(), calcSize );
-        char *cksBuffer = new char[265];
-        ckSum.Get( cksBuffer, 256 );
-        checkSum  = checkSumType + ":";
-        checkSum += Utils::NormalizeChecksum( checkSumType, cksBuffer );
-        delete [] cksBuffer;
-
-        log->Dump( UtilityMsg, "Checksum for %s is: %s", pName.c_str(),
-                   checkSum.c_str() );
-        return XrdCl::XRootDStatus();
-      }
-
-    private:
-      std::string  pName;
-      std::string  pCkSumType;
-      XrdCksCalc  *pCksCalcObj;
-  };
-
   //----------------------------------------------------------------------------
   //! Abstract chunk source
   //----------------------------------------------------------------------------
@@ -301,7 +187,7 @@ namespace
         pCkSumHelper(0), pChunkSize( chunkSize )
       {
         if( !ckSumType.empty() )
-          pCkSumHelper = new CheckSumHelper( url->GetPath(), ckSumType );
+          pCkSumHelper = new XrdCl::CheckSumHelper( url->GetPath(), ckSumType );
       }
 
       //------------------------------------------------------------------------
@@ -396,7 +282,11 @@ namespace
         }
 
         if( pCkSumHelper )
-          pCkSumHelper->Update( buffer, bytesRead );
+        {
+          char *copy = new char[bytesRead];
+          memcpy( copy, buffer, bytesRead );
+          pCkSumHelper->Update( pCurrentOffset, copy, bytesRead );
+        }
 
         ci.offset = pCurrentOffset;
         ci.length = bytesRead;
@@ -424,7 +314,7 @@ namespace
       int             pFD;
       int64_t         pSize;
       uint64_t        pCurrentOffset;
-      CheckSumHelper *pCkSumHelper;
+      XrdCl::CheckSumHelper *pCkSumHelper;
       uint32_t        pChunkSize;
   };
 
@@ -441,7 +331,7 @@ namespace
         pCkSumHelper(0), pCurrentOffset(0), pChunkSize( chunkSize )
       {
         if( !ckSumType.empty() )
-          pCkSumHelper = new CheckSumHelper( "stdin", ckSumType );
+          pCkSumHelper = new XrdCl::CheckSumHelper( "stdin", ckSumType );
       }
 
       //------------------------------------------------------------------------
@@ -509,7 +399,11 @@ namespace
         }
 
         if( pCkSumHelper )
-          pCkSumHelper->Update( buffer, bytesRead );
+        {
+          char *copy = new char[bytesRead];
+          memcpy( copy, buffer, bytesRead );
+          pCkSumHelper->Update( pCurrentOffset, copy, bytesRead );
+        }
 
         ci.offset = pCurrentOffset;
         ci.length = bytesRead;
@@ -534,7 +428,7 @@ namespace
       StdInSource(const StdInSource &other);
       StdInSource &operator = (const StdInSource &other);
 
-      CheckSumHelper *pCkSumHelper;
+      XrdCl::CheckSumHelper *pCkSumHelper;
       uint64_t        pCurrentOffset;
       uint32_t        pChunkSize;
   };
@@ -1220,9 +1114,11 @@ namespace
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      LocalDestination( const XrdCl::URL *url ):
-        pPath( url->GetPath() ), pFD( -1 )
+      LocalDestination( const XrdCl::URL *url, const std::string &ckSumType ):
+        pPath( url->GetPath() ), pFD( -1 ), pCkSumHelper( 0 )
       {
+        if( !ckSumType.empty() )
+          pCkSumHelper = new XrdCl::CheckSumHelper( url->GetPath(), ckSumType );
       }
 
       //------------------------------------------------------------------------
@@ -1232,6 +1128,7 @@ namespace
       {
         if( pFD != -1 )
           Finalize();
+        delete pCkSumHelper;
       }
 
       //------------------------------------------------------------------------
@@ -1271,6 +1168,9 @@ namespace
         }
 
         pFD   = fd;
+
+        if( pCkSumHelper )
+          return pCkSumHelper->Initialize();
         return XRootDStatus();
       }
 
@@ -1328,7 +1228,15 @@ namespace
         }
         while( length );
 
-        delete [] (char*)ci.buffer; ci.buffer = 0;
+        //----------------------------------------------------------------------
+        // The checksum is computed from what we have written, so we don't
+        // need to read the file again at the end
+        //----------------------------------------------------------------------
+        if( pCkSumHelper )
+          pCkSumHelper->Update( ci.offset, (char*)ci.buffer, ci.length );
+        else
+          delete [] (char*)ci.buffer;
+        ci.buffer = 0;
         return XRootDStatus();
       }
 
@@ -1346,6 +1254,12 @@ namespace
       virtual XrdCl::XRootDStatus GetCheckSum( std::string &checkSum,
                                                std::string &checkSumType )
       {
+        //----------------------------------------------------------------------
+        // Too much data came out of order to be checksummed on the fly, read
+        // the file back
+        //----------------------------------------------------------------------
+        if( pCkSumHelper && !pCkSumHelper->Overflowed() )
+          return pCkSumHelper->GetCheckSum( checkSum, checkSumType );
         return XrdCl::Utils::GetLocalCheckSum( checkSum, checkSumType, pPath );
       }
 
@@ -1409,8 +1323,9 @@ namespace
       LocalDestination(const LocalDestination &other);
       LocalDestination &operator = (const LocalDestination &other);
 
-      std::string pPath;
-      int         pFD;
+      std::string     pPath;
+      int             pFD;
+      XrdCl::CheckSumHelper *pCkSumHelper;
   };
 
   //----------------------------------------------------------------------------
@@ -1487,8 +1402,8 @@ namespace
         }
         while( length );
 
-        pCkSumHelper.Update( ci.buffer, ci.length );
-        delete [] (char*)ci.buffer; ci.buffer = 0;
+        pCkSumHelper.Update( ci.offset, (char*)ci.buffer, ci.length );
+        ci.buffer = 0;
         return XRootDStatus();
       }
 
@@ -1512,7 +1427,7 @@ namespace
     private:
       StdOutDestination(const StdOutDestination &other);
       StdOutDestination &operator = (const StdOutDestination &other);
-      CheckSumHelper pCkSumHelper;
+      XrdCl::CheckSumHelper pCkSumHelper;
       uint64_t       pCurrentOffset;
   };
 
@@ -1798,7 +1713,11 @@ namespace XrdCl
     URL newDestUrl( GetTarget() );
 
     if( GetTarget().GetProtocol() == "file" )
-      dest.reset( new LocalDestination( &GetTarget() ) );
+    {
+      bool targetCheckSum = checkSumMode == "end2end" || checkSumMode == "target";
+      dest.reset( new LocalDestination( &GetTarget(),
+                                        targetCheckSum ? checkSumType : "" ) );
+    }
     else if( GetTarget().GetProtocol() == "stdio" )
       dest.reset( new StdOutDestination( checkSumType ) );
     //--------------------------------------------------------------------------
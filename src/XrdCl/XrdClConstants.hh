@@ -48,6 +48,7 @@ namespace XrdCl
   const int DefaultRequestTimeout       = 1800;
   const int DefaultStreamTimeout        = 60;
   const int DefaultTimeoutResolution    = 15;
+  const int DefaultTimerResolution      = 1000;
   const int DefaultStreamErrorWindow    = 1800;
   const int DefaultRunForkHandler       = 0;
   const int DefaultRedirectLimit        = 16;
@@ -67,6 +68,22 @@ namespace XrdCl
   const int DefaultMetalinkProcessing   = 1;
   const int DefaultLocalMetalinkFile    = 1;
   const int DefaultXCpBlockSize         = 134217728; // DefaultCPChunkSize * DefaultCPParallelChunks * 2
+  const int DefaultXCpMinRatePercent    = 10;
+  const int DefaultReadAhead            = 0;
+  const int DefaultReadAheadBlockSize   = 1048576;
+  const int DefaultReadAheadMaxWindow   = 67108864;
+  const int DefaultReadAheadPoolSize    = 268435456;
+  const int DefaultReadVGapThreshold    = 0;
+  const int DefaultReadVMaxChunks       = 1024;
+  const int DefaultReadVMaxChunkSize    = 262128;
+  const int DefaultCPPipelineJobs       = 0;
+  const int DefaultCPPipelineBuffer     = 268435456;
+  const int DefaultDirListParallel      = 16;
+  const int DefaultZipCDCacheSize       = 64;
+  const int DefaultDNSCacheTTL          = 60;
+  const int DefaultResolverThreads      = 2;
+  const int DefaultPreconnectLocated    = 0;
+  const int DefaultDeepLocateParallel   = 16;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
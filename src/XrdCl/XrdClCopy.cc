@@ -36,6 +36,7 @@
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sys/time.h>
 
 //------------------------------------------------------------------------------
 // Progress notifier
@@ -47,8 +48,11 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     //! Constructor
     //--------------------------------------------------------------------------
     ProgressDisplay(): pPrevious(0), pPrintProgressBar(true),
-      pPrintSourceCheckSum(false), pPrintTargetCheckSum(false)
-    {}
+      pPrintSourceCheckSum(false), pPrintTargetCheckSum(false),
+      pJobTotal(0), pFilesDone(0), pBytesDone(0)
+    {
+      pStarted.tv_sec = pStarted.tv_usec = 0;
+    }
 
     //--------------------------------------------------------------------------
     //! Begin job
@@ -69,6 +73,9 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
         }
       }
       pPrevious = 0;
+      pJobTotal = jobTotal;
+      if( !pStarted.tv_sec )
+        gettimeofday( &pStarted, 0 );
 
       JobData d;
       d.started = time(0);
@@ -112,8 +119,10 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
       }
 
       std::string checkSum;
-      uint64_t    size;
+      uint64_t    size = 0;
       results->Get( "size", size );
+      ++pFilesDone;
+      pBytesDone += size;
       if( pPrintSourceCheckSum )
       {
         results->Get( "sourceCheckSum", checkSum );
@@ -179,6 +188,26 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
       std::map<uint16_t, JobData>::iterator it;
       std::ostringstream o;
 
+      //------------------------------------------------------------------------
+      // Too many files at once to show them one by one
+      //------------------------------------------------------------------------
+      if( pOngoingJobs.size() > 4 )
+      {
+        uint64_t bytes = pBytesDone;
+        for( it = pOngoingJobs.begin(); it != pOngoingJobs.end(); ++it )
+          bytes += it->second.bytesProcessed;
+        time_t   elapsed = now - pStarted.tv_sec;
+        if( elapsed < 1 ) elapsed = 1;
+
+        o << "[" << pFilesDone << "/" << pJobTotal << " files]";
+        o << "[" << pOngoingJobs.size() << " ongoing]";
+        o << "[" << XrdCl::Utils::BytesToString( bytes ) << "B]";
+        o << "[" << pFilesDone/elapsed << " files/s]";
+        o << "[" << XrdCl::Utils::BytesToString( bytes/elapsed ) << "B/s]";
+        o << "        ";
+        return o.str();
+      }
+
       for( it = pOngoingJobs.begin(); it != pOngoingJobs.end(); ++it )
       {
         JobData  &d      = it->second;
@@ -237,6 +266,29 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
       }
     }
 
+    //--------------------------------------------------------------------------
+    //! Print the overall rate of a multi-file copy
+    //--------------------------------------------------------------------------
+    void PrintSummary()
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      if( !pPrintProgressBar || pJobTotal < 2 || !pStarted.tv_sec )
+        return;
+
+      timeval now;
+      gettimeofday( &now, 0 );
+      double elapsed = ( now.tv_sec - pStarted.tv_sec ) +
+                       ( now.tv_usec - pStarted.tv_usec ) / 1e6;
+      if( elapsed <= 0 ) elapsed = 1e-6;
+
+      std::cerr << "Copied " << pFilesDone << " files, ";
+      std::cerr << XrdCl::Utils::BytesToString( pBytesDone ) << "B in ";
+      std::cerr << std::fixed << std::setprecision( 2 ) << elapsed << "s ";
+      std::cerr << "[" << pFilesDone / elapsed << " files/s]";
+      std::cerr << "[" << XrdCl::Utils::BytesToString( pBytesDone / elapsed );
+      std::cerr << "B/s]" << std::endl;
+    }
+
     //--------------------------------------------------------------------------
     //! Print the checksum
     //--------------------------------------------------------------------------
@@ -286,6 +338,10 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     bool                        pPrintSourceCheckSum;
     bool                        pPrintTargetCheckSum;
     std::map<uint16_t, JobData> pOngoingJobs;
+    uint16_t                    pJobTotal;
+    uint64_t                    pFilesDone;
+    uint64_t                    pBytesDone;
+    timeval                     pStarted;
     XrdSysRecMutex              pMutex;
 };
 
@@ -843,6 +899,7 @@ int main( int argc, char **argv )
   }
 
   st = process.Run( &progress );
+  progress.PrintSummary();
   if( !st.IsOK() )
   {
     if( resultVect.size() == 1 )
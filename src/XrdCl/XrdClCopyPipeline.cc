@@ -0,0 +1,806 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClCopyPipeline.hh"
+#include "XrdCl/XrdClCopyProcess.hh"
+#include "XrdCl/XrdClCopyJob.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClMonitor.hh"
+#include "XrdCl/XrdClUtils.hh"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <sstream>
+#include <algorithm>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! A copy job driven by the callbacks of its requests
+  //----------------------------------------------------------------------------
+  class PipelinedCopy
+  {
+    public:
+      typedef void (PipelinedCopy::*Callback)( XRootDStatus &, AnyObject *,
+                                               ChunkInfo & );
+
+      //------------------------------------------------------------------------
+      // Call a member function when a request comes back
+      //------------------------------------------------------------------------
+      class Handler: public ResponseHandler
+      {
+        public:
+          Handler( PipelinedCopy *copy, Callback cb,
+                   const ChunkInfo &chunk = ChunkInfo() ):
+            pCopy( copy ), pCallback( cb ), pChunk( chunk ) {}
+
+          virtual void HandleResponse( XRootDStatus *status,
+                                       AnyObject    *response )
+          {
+            (pCopy->*pCallback)( *status, response, pChunk );
+            delete status;
+            delete response;
+            delete this;
+          }
+
+        private:
+          PipelinedCopy *pCopy;
+          Callback       pCallback;
+          ChunkInfo      pChunk;
+      };
+
+      PipelinedCopy( CopyPipeline *pipeline, CopyJob *job, uint16_t jobNum,
+                     uint16_t totalJobs ):
+        pPipeline( pipeline ), pJob( job ), pJobNum( jobNum ),
+        pTotalJobs( totalJobs ), pSrcFile( 0 ), pDstFile( 0 ), pSrcFD( -1 ),
+        pDstFD( -1 ), pSize( 0 ), pOffset( 0 ), pProcessed( 0 ),
+        pInFlight( 0 ), pClosing( 0 ), pDstCreated( false ), pFinished( false ),
+        pWaiting( false )
+      {
+        PropertyList *props = job->GetProperties();
+        props->Get( "chunkSize",      pChunkSize );
+        props->Get( "parallelChunks", pParallelChunks );
+        props->Get( "posc",           pPosc );
+        props->Get( "force",          pForce );
+        props->Get( "coerce",         pCoerce );
+        props->Get( "makeDir",        pMakeDir );
+        if( !pChunkSize )      pChunkSize      = DefaultCPChunkSize;
+        if( !pParallelChunks ) pParallelChunks = 1;
+      }
+
+      ~PipelinedCopy()
+      {
+        delete pSrcFile;
+        delete pDstFile;
+      }
+
+      void Start();
+      void Pump();
+
+      bool Waiting() const { return pWaiting; }
+      void SetWaiting( bool waiting ) { pWaiting = waiting; }
+
+    private:
+      void SourceOpened( XRootDStatus &st, AnyObject *rsp, ChunkInfo &chunk );
+      void TargetOpened( XRootDStatus &st, AnyObject *rsp, ChunkInfo &chunk );
+      void ChunkRead( XRootDStatus &st, AnyObject *rsp, ChunkInfo &chunk );
+      void ChunkWritten( XRootDStatus &st, AnyObject *rsp, ChunkInfo &chunk );
+      void FileClosed( XRootDStatus &st, AnyObject *rsp, ChunkInfo &chunk );
+
+      void         OpenTarget();
+      void         WriteChunk( ChunkInfo &chunk );
+      void         Fail( const XRootDStatus &st );
+      void         Close();
+      void         Finish();
+      XRootDStatus MkPath( const std::string &path );
+
+      CopyPipeline *pPipeline;
+      CopyJob      *pJob;
+      uint16_t      pJobNum;
+      uint16_t      pTotalJobs;
+      File         *pSrcFile;
+      File         *pDstFile;
+      int           pSrcFD;
+      int           pDstFD;
+      uint32_t      pChunkSize;
+      uint16_t      pParallelChunks;
+      bool          pPosc;
+      bool          pForce;
+      bool          pCoerce;
+      bool          pMakeDir;
+      XrdSysMutex   pMutex;
+      XRootDStatus  pStatus;
+      uint64_t      pSize;
+      uint64_t      pOffset;
+      uint64_t      pProcessed;
+      uint32_t      pInFlight;
+      uint32_t      pClosing;
+      bool          pDstCreated;
+      bool          pFinished;
+      bool          pWaiting;
+      timeval       pBTOD;
+  };
+
+  //----------------------------------------------------------------------------
+  // Report the beginning of the copy and open the source
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::Start()
+  {
+    Log *log = DefaultEnv::GetLog();
+    CopyProgressHandler *progress = pPipeline->pProgress;
+    if( progress )
+      progress->BeginJob( pJobNum, pTotalJobs, &pJob->GetSource(),
+                          &pJob->GetTarget() );
+
+    Monitor *mon = DefaultEnv::GetMonitor();
+    if( mon )
+    {
+      Monitor::CopyBInfo i;
+      i.transfer.origin = &pJob->GetSource();
+      i.transfer.target = &pJob->GetTarget();
+      mon->Event( Monitor::EvCopyBeg, &i );
+    }
+    gettimeofday( &pBTOD, 0 );
+
+    //--------------------------------------------------------------------------
+    // Local file, its size is there right away
+    //--------------------------------------------------------------------------
+    if( pJob->GetSource().GetProtocol() == "file" )
+    {
+      std::string path = pJob->GetSource().GetPath();
+      log->Debug( UtilityMsg, "CopyPipeline (job #%d): opening %s for reading",
+                  pJobNum, path.c_str() );
+      struct stat st;
+      pSrcFD = open( path.c_str(), O_RDONLY );
+      if( pSrcFD == -1 || fstat( pSrcFD, &st ) == -1 )
+      {
+        log->Debug( UtilityMsg, "Unable to open %s: %s", path.c_str(),
+                    strerror( errno ) );
+        Fail( XRootDStatus( stError, errOSError, errno ) );
+        Close();
+        return;
+      }
+      pSize = st.st_size;
+      OpenTarget();
+      return;
+    }
+
+    log->Debug( UtilityMsg, "CopyPipeline (job #%d): opening %s for reading",
+                pJobNum, pJob->GetSource().GetURL().c_str() );
+    pSrcFile = new File();
+    Handler *h = new Handler( this, &PipelinedCopy::SourceOpened );
+    XRootDStatus st = pSrcFile->Open( pJob->GetSource().GetURL(),
+                                      OpenFlags::Read, Access::None, h );
+    if( !st.IsOK() )
+    {
+      delete h;
+      Fail( st );
+      Close();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // The source is open, the stat info came with the open response
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::SourceOpened( XRootDStatus &st, AnyObject*, ChunkInfo& )
+  {
+    if( !st.IsOK() )
+    {
+      Fail( st );
+      Close();
+      return;
+    }
+
+    StatInfo *info = 0;
+    XRootDStatus s = pSrcFile->Stat( false, info );
+    if( !s.IsOK() )
+    {
+      Fail( s );
+      Close();
+      return;
+    }
+    pSize = info->GetSize();
+    delete info;
+    OpenTarget();
+  }
+
+  //----------------------------------------------------------------------------
+  // Open the target, the source is known to be there so truncating it is
+  // fine
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::OpenTarget()
+  {
+    Log *log = DefaultEnv::GetLog();
+    const URL &target = pJob->GetTarget();
+
+    if( target.GetProtocol() == "file" )
+    {
+      std::string path = target.GetPath();
+      if( pMakeDir )
+      {
+        XRootDStatus st = MkPath( path.substr( 0, path.find_last_of( "/" ) ) );
+        if( !st.IsOK() )
+        {
+          Fail( st );
+          Close();
+          return;
+        }
+      }
+
+      log->Debug( UtilityMsg, "CopyPipeline (job #%d): opening %s for writing",
+                  pJobNum, path.c_str() );
+      int flags = O_WRONLY|O_CREAT|O_TRUNC;
+      if( !pForce )
+        flags |= O_EXCL;
+      pDstFD = open( path.c_str(), flags, 0644 );
+      if( pDstFD == -1 )
+      {
+        log->Debug( UtilityMsg, "Unable to open %s: %s", path.c_str(),
+                    strerror( errno ) );
+        Fail( XRootDStatus( stError, errOSError, errno ) );
+        Close();
+        return;
+      }
+      pDstCreated = true;
+      Pump();
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Let the server know how much space we need
+    //--------------------------------------------------------------------------
+    URL url( target );
+    URL::ParamsMap params = url.GetParams();
+    std::ostringstream o; o << pSize;
+    params["oss.asize"] = o.str();
+    url.SetParams( params );
+
+    log->Debug( UtilityMsg, "CopyPipeline (job #%d): opening %s for writing",
+                pJobNum, url.GetURL().c_str() );
+
+    pDstFile = new File();
+    std::string value;
+    DefaultEnv::GetEnv()->GetString( "WriteRecovery", value );
+    pDstFile->SetProperty( "WriteRecovery", value );
+
+    OpenFlags::Flags flags = OpenFlags::Update;
+    if( pForce )
+      flags |= OpenFlags::Delete;
+    else
+      flags |= OpenFlags::New;
+    if( pPosc )
+      flags |= OpenFlags::POSC;
+    if( pCoerce )
+      flags |= OpenFlags::Force;
+    if( pMakeDir )
+      flags |= OpenFlags::MakePath;
+    Access::Mode mode = Access::UR|Access::UW|Access::GR|Access::OR;
+
+    Handler *h = new Handler( this, &PipelinedCopy::TargetOpened );
+    XRootDStatus st = pDstFile->Open( url.GetURL(), flags, mode, h );
+    if( !st.IsOK() )
+    {
+      delete h;
+      Fail( st );
+      Close();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // The target is open
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::TargetOpened( XRootDStatus &st, AnyObject*, ChunkInfo& )
+  {
+    if( !st.IsOK() )
+    {
+      Fail( st );
+      Close();
+      return;
+    }
+    Pump();
+  }
+
+  //----------------------------------------------------------------------------
+  // Issue as many reads as the chunk limit and the buffer budget allow
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::Pump()
+  {
+    std::vector<ChunkInfo> chunks;
+
+    pMutex.Lock();
+    if( pFinished || pClosing )
+    {
+      pMutex.UnLock();
+      return;
+    }
+    while( pStatus.IsOK() && pInFlight < pParallelChunks && pOffset < pSize )
+    {
+      uint32_t length = std::min( (uint64_t)pChunkSize, pSize - pOffset );
+      if( !pPipeline->Acquire( this, length ) )
+        break;
+      chunks.push_back( ChunkInfo( pOffset, length, new char[length] ) );
+      pOffset += length;
+      ++pInFlight;
+    }
+    bool done = ( pInFlight == 0 && ( !pStatus.IsOK() || pOffset >= pSize ) );
+    pMutex.UnLock();
+
+    if( done )
+    {
+      Close();
+      return;
+    }
+
+    for( size_t i = 0; i < chunks.size(); ++i )
+    {
+      ChunkInfo &chunk = chunks[i];
+
+      //------------------------------------------------------------------------
+      // Local source, read right away
+      //------------------------------------------------------------------------
+      if( pSrcFD != -1 )
+      {
+        XRootDStatus st;
+        char    *cursor = (char*)chunk.buffer;
+        uint64_t offset = chunk.offset;
+        uint32_t length = chunk.length;
+        while( length )
+        {
+          ssize_t rd = pread( pSrcFD, cursor, length, offset );
+          if( rd <= 0 )
+          {
+            st = rd == 0 ? XRootDStatus( stError, errDataError ) :
+                           XRootDStatus( stError, errOSError, errno );
+            break;
+          }
+          offset += rd;
+          cursor += rd;
+          length -= rd;
+        }
+        ChunkRead( st, 0, chunk );
+        continue;
+      }
+
+      Handler *h = new Handler( this, &PipelinedCopy::ChunkRead, chunk );
+      XRootDStatus st = pSrcFile->Read( chunk.offset, chunk.length,
+                                        chunk.buffer, h );
+      if( !st.IsOK() )
+      {
+        delete h;
+        ChunkRead( st, 0, chunk );
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // A chunk came from the source, pass it to the target
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::ChunkRead( XRootDStatus &st, AnyObject *rsp,
+                                 ChunkInfo &chunk )
+  {
+    if( st.IsOK() && rsp )
+    {
+      ChunkInfo *info = 0;
+      rsp->Get( info );
+      if( !info || info->length != chunk.length )
+      {
+        DefaultEnv::GetLog()->Error( UtilityMsg, "CopyPipeline (job #%d): "
+                                     "the declared source size is %ld bytes, "
+                                     "but received less data at offset %ld",
+                                     pJobNum, pSize, chunk.offset );
+        st = XRootDStatus( stError, errDataError );
+      }
+    }
+
+    if( !st.IsOK() )
+    {
+      ChunkWritten( st, 0, chunk );
+      return;
+    }
+    WriteChunk( chunk );
+  }
+
+  //----------------------------------------------------------------------------
+  // Write a chunk to the target
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::WriteChunk( ChunkInfo &chunk )
+  {
+    if( pDstFD != -1 )
+    {
+      XRootDStatus st;
+      char    *cursor = (char*)chunk.buffer;
+      uint64_t offset = chunk.offset;
+      uint32_t length = chunk.length;
+      while( length )
+      {
+        ssize_t wr = pwrite( pDstFD, cursor, length, offset );
+        if( wr == -1 )
+        {
+          DefaultEnv::GetLog()->Debug( UtilityMsg, "Unable to write to %s: %s",
+                                       pJob->GetTarget().GetPath().c_str(),
+                                       strerror( errno ) );
+          st = XRootDStatus( stError, errOSError, errno );
+          break;
+        }
+        offset += wr;
+        cursor += wr;
+        length -= wr;
+      }
+      ChunkWritten( st, 0, chunk );
+      return;
+    }
+
+    Handler *h = new Handler( this, &PipelinedCopy::ChunkWritten, chunk );
+    XRootDStatus st = pDstFile->Write( chunk.offset, chunk.length,
+                                       chunk.buffer, h );
+    if( !st.IsOK() )
+    {
+      delete h;
+      ChunkWritten( st, 0, chunk );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // A chunk is done with, free the buffer and carry on
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::ChunkWritten( XRootDStatus &st, AnyObject*,
+                                    ChunkInfo &chunk )
+  {
+    delete [] (char*)chunk.buffer;
+    chunk.buffer = 0;
+    pPipeline->Release( chunk.length );
+
+    pMutex.Lock();
+    --pInFlight;
+    if( !st.IsOK() && pStatus.IsOK() )
+      pStatus = st;
+    if( st.IsOK() )
+      pProcessed += chunk.length;
+    uint64_t processed = pProcessed;
+    pMutex.UnLock();
+
+    if( st.IsOK() && pPipeline->pProgress )
+      pPipeline->pProgress->JobProgress( pJobNum, processed, pSize );
+    Pump();
+  }
+
+  //----------------------------------------------------------------------------
+  // Remember the first error
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::Fail( const XRootDStatus &st )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( pStatus.IsOK() )
+      pStatus = st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Close whatever is open, the remote files asynchronously
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::Close()
+  {
+    pMutex.Lock();
+    if( pClosing || pFinished )
+    {
+      pMutex.UnLock();
+      return;
+    }
+    pClosing = 1;
+
+    if( pSrcFD != -1 )
+    {
+      ::close( pSrcFD );
+      pSrcFD = -1;
+    }
+    if( pDstFD != -1 )
+    {
+      if( ::close( pDstFD ) != 0 && pStatus.IsOK() )
+        pStatus = XRootDStatus( stError, errOSError, errno );
+      pDstFD = -1;
+    }
+
+    std::vector<File*> files;
+    if( pSrcFile && pSrcFile->IsOpen() ) files.push_back( pSrcFile );
+    if( pDstFile && pDstFile->IsOpen() ) files.push_back( pDstFile );
+    pClosing += files.size();
+    pMutex.UnLock();
+
+    ChunkInfo none;
+    for( size_t i = 0; i < files.size(); ++i )
+    {
+      Handler *h = new Handler( this, &PipelinedCopy::FileClosed );
+      XRootDStatus st = files[i]->Close( h );
+      if( !st.IsOK() )
+      {
+        delete h;
+        FileClosed( st, 0, none );
+      }
+    }
+
+    XRootDStatus ok;
+    FileClosed( ok, 0, none );
+  }
+
+  //----------------------------------------------------------------------------
+  // A file got closed, the last one finishes the job
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::FileClosed( XRootDStatus &st, AnyObject*, ChunkInfo& )
+  {
+    pMutex.Lock();
+    if( !st.IsOK() && pStatus.IsOK() )
+      pStatus = st;
+    bool last = ( --pClosing == 0 );
+    pMutex.UnLock();
+
+    if( last )
+      Finish();
+  }
+
+  //----------------------------------------------------------------------------
+  // Report the result and hand the copy back to the pipeline
+  //----------------------------------------------------------------------------
+  void PipelinedCopy::Finish()
+  {
+    pMutex.Lock();
+    pFinished = true;
+    if( pStatus.IsOK() && pProcessed != pSize )
+    {
+      DefaultEnv::GetLog()->Error( UtilityMsg, "The declared source size is "
+                                   "%ld bytes, but received %ld bytes.",
+                                   pSize, pProcessed );
+      pStatus = XRootDStatus( stError, errDataError );
+    }
+    XRootDStatus st = pStatus;
+    pMutex.UnLock();
+
+    if( st.IsOK() )
+      pJob->GetResults()->Set( "size", pProcessed );
+    else if( pPosc && pDstCreated )
+      unlink( pJob->GetTarget().GetPath().c_str() );
+    pJob->GetResults()->Set( "status", st );
+
+    Monitor *mon = DefaultEnv::GetMonitor();
+    if( mon )
+    {
+      std::vector<std::string> sources;
+      pJob->GetResults()->Get( "sources", sources );
+      Monitor::CopyEInfo i;
+      i.transfer.origin = &pJob->GetSource();
+      i.transfer.target = &pJob->GetTarget();
+      i.sources         = sources.size();
+      i.bTOD            = pBTOD;
+      gettimeofday( &i.eTOD, 0 );
+      i.status          = &st;
+      mon->Event( Monitor::EvCopyEnd, &i );
+    }
+
+    if( pPipeline->pProgress )
+      pPipeline->pProgress->EndJob( pJobNum, pJob->GetResults() );
+    pPipeline->Done( this );
+  }
+
+  //----------------------------------------------------------------------------
+  // Create a directory path
+  //----------------------------------------------------------------------------
+  XRootDStatus PipelinedCopy::MkPath( const std::string &path )
+  {
+    Log *log = DefaultEnv::GetLog();
+    if( path.empty() )
+      return XRootDStatus();
+
+    std::vector<std::string> elements;
+    Utils::splitString( elements, path, "/" );
+    std::string fullPath = path[0] == '/' ? "/" : "";
+
+    for( size_t i = 0; i < elements.size(); ++i )
+    {
+      fullPath += elements[i];
+      fullPath += "/";
+      if( mkdir( fullPath.c_str(), 0755 ) == 0 || errno == EEXIST )
+        continue;
+      log->Error( UtilityMsg, "Cannot create directory %s: %s",
+                  fullPath.c_str(), strerror( errno ) );
+      return XRootDStatus( stError, errOSError, errno );
+    }
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  CopyPipeline::CopyPipeline( CopyProgressHandler *progress,
+                              uint32_t             maxJobs,
+                              uint64_t             bufferSize ):
+    pCond( 0 ),
+    pProgress( progress ),
+    pMaxJobs( maxJobs ? maxJobs : 1 ),
+    pBufferSize( bufferSize ),
+    pBuffered( 0 ),
+    pWanted( 0 ),
+    pInFlight( 0 )
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  CopyPipeline::~CopyPipeline()
+  {
+    for( size_t i = 0; i < pQueue.size(); ++i )
+      delete pQueue[i];
+  }
+
+  //----------------------------------------------------------------------------
+  // Check if the pipeline can handle the job
+  //----------------------------------------------------------------------------
+  bool CopyPipeline::CanRun( CopyJob *job )
+  {
+    PropertyList *props = job->GetProperties();
+    std::string thirdParty, checkSumMode;
+    bool        zip = false, xcp = false, dynamicSource = false;
+    props->Get( "thirdParty",    thirdParty );
+    props->Get( "checkSumMode",  checkSumMode );
+    props->Get( "zipArchive",    zip );
+    props->Get( "xcp",           xcp );
+    props->Get( "dynamicSource", dynamicSource );
+
+    if( thirdParty != "none" || checkSumMode != "none" || zip || xcp ||
+        dynamicSource )
+      return false;
+
+    const std::string &src = job->GetSource().GetProtocol();
+    const std::string &dst = job->GetTarget().GetProtocol();
+    if( src == "stdio" || dst == "stdio" )
+      return false;
+    if( src == "file" && dst == "file" )
+      return false;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Queue a job
+  //----------------------------------------------------------------------------
+  void CopyPipeline::AddJob( CopyJob *job, uint16_t jobNum, uint16_t totalJobs )
+  {
+    pQueue.push_back( new PipelinedCopy( this, job, jobNum, totalJobs ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Run all the jobs
+  //----------------------------------------------------------------------------
+  void CopyPipeline::Run()
+  {
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( UtilityMsg, "CopyPipeline: running %d jobs, %d at a time",
+                (int)pQueue.size(), pMaxJobs );
+
+    std::vector<PipelinedCopy*> finished;
+    std::vector<PipelinedCopy*> start;
+    std::list<PipelinedCopy*>   resume;
+
+    pCond.Lock();
+    while( 1 )
+    {
+      //------------------------------------------------------------------------
+      // Collect the work to do, the copies are only ever deleted here
+      //------------------------------------------------------------------------
+      finished.swap( pFinished );
+      pInFlight -= finished.size();
+      while( !pQueue.empty() && pInFlight < pMaxJobs )
+      {
+        start.push_back( pQueue.front() );
+        pQueue.pop_front();
+        ++pInFlight;
+      }
+      if( !pWaiting.empty() && pBuffered + pWanted <= pBufferSize )
+      {
+        resume.swap( pWaiting );
+        pWanted = 0;
+        std::list<PipelinedCopy*>::iterator it;
+        for( it = resume.begin(); it != resume.end(); ++it )
+          (*it)->SetWaiting( false );
+      }
+
+      if( finished.empty() && start.empty() && resume.empty() )
+      {
+        if( !pInFlight && pQueue.empty() )
+          break;
+        pCond.Wait();
+        continue;
+      }
+      pCond.UnLock();
+
+      for( size_t i = 0; i < finished.size(); ++i )
+        delete finished[i];
+      finished.clear();
+
+      std::list<PipelinedCopy*>::iterator it;
+      for( it = resume.begin(); it != resume.end(); ++it )
+        (*it)->Pump();
+      resume.clear();
+
+      for( size_t i = 0; i < start.size(); ++i )
+        start[i]->Start();
+      start.clear();
+
+      pCond.Lock();
+    }
+    pCond.UnLock();
+  }
+
+  //----------------------------------------------------------------------------
+  // A copy is done
+  //----------------------------------------------------------------------------
+  void CopyPipeline::Done( PipelinedCopy *copy )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    if( copy->Waiting() )
+    {
+      pWaiting.remove( copy );
+      copy->SetWaiting( false );
+    }
+    pFinished.push_back( copy );
+    pCond.Signal();
+  }
+
+  //----------------------------------------------------------------------------
+  // Reserve buffer space, a copy that does not get it is resumed once some
+  // space has been released
+  //----------------------------------------------------------------------------
+  bool CopyPipeline::Acquire( PipelinedCopy *copy, uint32_t size )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    if( pBuffered && pBuffered + size > pBufferSize )
+    {
+      if( !copy->Waiting() )
+      {
+        pWaiting.push_back( copy );
+        copy->SetWaiting( true );
+      }
+      if( !pWanted || size < pWanted )
+        pWanted = size;
+      return false;
+    }
+    pBuffered += size;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Release buffer space
+  //----------------------------------------------------------------------------
+  void CopyPipeline::Release( uint32_t size )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    pBuffered -= size;
+    if( !pWaiting.empty() && pBuffered + pWanted <= pBufferSize )
+      pCond.Signal();
+  }
+}
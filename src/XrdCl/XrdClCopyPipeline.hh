@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_COPY_PIPELINE_HH__
+#define __XRD_CL_COPY_PIPELINE_HH__
+
+#include "XrdSys/XrdSysPthread.hh"
+#include <stdint.h>
+#include <deque>
+#include <list>
+#include <vector>
+
+namespace XrdCl
+{
+  class CopyJob;
+  class CopyProgressHandler;
+  class PipelinedCopy;
+
+  //----------------------------------------------------------------------------
+  //! Run many plain copy jobs at once with asynchronous requests
+  //!
+  //! Instead of dedicating a thread to every copy job, the pipeline keeps
+  //! up to maxJobs of them in flight, each one driven by the callbacks of
+  //! its own open, read, write and close requests. The jobs to the same
+  //! servers share the channels, so the open of the upcoming files overlaps
+  //! with the data transfer of the current ones. The data buffers of all
+  //! the jobs are bounded by bufferSize, a file smaller than the chunk size
+  //! is read with one request and written in one go.
+  //!
+  //! Only the copies between xrootd and local files, without checksums,
+  //! third party copy, zip archives, extreme copy or dynamic sources are
+  //! handled, see CanRun.
+  //----------------------------------------------------------------------------
+  class CopyPipeline
+  {
+    friend class PipelinedCopy;
+
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param progress   progress handler, may be 0
+      //! @param maxJobs    maximum number of jobs in flight
+      //! @param bufferSize maximum number of bytes buffered by all the jobs
+      //------------------------------------------------------------------------
+      CopyPipeline( CopyProgressHandler *progress,
+                    uint32_t             maxJobs,
+                    uint64_t             bufferSize );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~CopyPipeline();
+
+      //------------------------------------------------------------------------
+      //! Check if the pipeline can handle the job
+      //------------------------------------------------------------------------
+      static bool CanRun( CopyJob *job );
+
+      //------------------------------------------------------------------------
+      //! Queue a job
+      //!
+      //! @param job       the job
+      //! @param jobNum    number of the job reported to the progress handler
+      //! @param totalJobs total number of jobs
+      //------------------------------------------------------------------------
+      void AddJob( CopyJob *job, uint16_t jobNum, uint16_t totalJobs );
+
+      //------------------------------------------------------------------------
+      //! Run all the queued jobs and wait for them to finish, the status
+      //! of every job is set in its results
+      //------------------------------------------------------------------------
+      void Run();
+
+    private:
+      //------------------------------------------------------------------------
+      // Called by the copies
+      //------------------------------------------------------------------------
+      void Done( PipelinedCopy *copy );
+      bool Acquire( PipelinedCopy *copy, uint32_t size );
+      void Release( uint32_t size );
+
+      XrdSysCondVar               pCond;
+      CopyProgressHandler        *pProgress;
+      uint32_t                    pMaxJobs;
+      uint64_t                    pBufferSize;
+      uint64_t                    pBuffered;
+      uint32_t                    pWanted;
+      uint32_t                    pInFlight;
+      std::deque<PipelinedCopy*>  pQueue;
+      std::vector<PipelinedCopy*> pFinished;
+      std::list<PipelinedCopy*>   pWaiting;
+  };
+}
+
+#endif // __XRD_CL_COPY_PIPELINE_HH__
@@ -31,6 +31,7 @@
 #include "XrdCl/XrdClFileSystem.hh"
 #include "XrdCl/XrdClMonitor.hh"
 #include "XrdCl/XrdClCopyJob.hh"
+#include "XrdCl/XrdClCopyPipeline.hh"
 #include "XrdCl/XrdClUtils.hh"
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClUglyHacks.hh"
@@ -332,6 +333,10 @@ namespace XrdCl
     // Get the configuration
     //--------------------------------------------------------------------------
     uint8_t parallelThreads = 1;
+    int     pipelineJobs    = DefaultCPPipelineJobs;
+    int     pipelineBuffer  = DefaultCPPipelineBuffer;
+    DefaultEnv::GetEnv()->GetInt( "CPPipelineJobs",   pipelineJobs );
+    DefaultEnv::GetEnv()->GetInt( "CPPipelineBuffer", pipelineBuffer );
     if( pJobProperties.size() > 0 &&
         pJobProperties.rbegin()->HasProperty( "jobType" ) &&
         pJobProperties.rbegin()->Get<std::string>( "jobType" ) == "configuration" )
@@ -339,6 +344,8 @@ namespace XrdCl
       PropertyList &config = *pJobProperties.rbegin();
       if( config.HasProperty( "parallel" ) )
         parallelThreads = (uint8_t)config.Get<int>( "parallel" );
+      if( config.HasProperty( "pipeline" ) )
+        pipelineJobs = config.Get<int>( "pipeline" );
     }
 
     //--------------------------------------------------------------------------
@@ -349,26 +356,43 @@ namespace XrdCl
     uint16_t totalJobs  = pJobs.size();
 
     //--------------------------------------------------------------------------
-    // Single thread
+    // Push the plain copies through the pipeline first, the rest is done
+    // the usual way
     //--------------------------------------------------------------------------
-    if( parallelThreads == 1 )
+    std::vector<CopyJob *>  jobs;
+    std::vector<uint16_t>   jobNums;
+    if( pipelineJobs > 0 )
     {
-      XRootDStatus err;
-
-      for( it = pJobs.begin(); it != pJobs.end(); ++it )
+      CopyPipeline pipeline( progress, pipelineJobs, pipelineBuffer );
+      for( it = pJobs.begin(); it != pJobs.end(); ++it, ++currentJob )
       {
-        QueuedCopyJob j( *it, progress, currentJob, totalJobs );
-        j.Run(0);
-
-        XRootDStatus st = (*it)->GetResults()->Get<XRootDStatus>( "status" );
-        if( err.IsOK() && !st.IsOK() )
+        if( CopyPipeline::CanRun( *it ) )
+          pipeline.AddJob( *it, currentJob, totalJobs );
+        else
         {
-          err = st;
+          jobs.push_back( *it );
+          jobNums.push_back( currentJob );
         }
-        ++currentJob;
       }
+      pipeline.Run();
+    }
+    else
+    {
+      jobs = pJobs;
+      for( size_t i = 0; i < pJobs.size(); ++i )
+        jobNums.push_back( i + 1 );
+    }
 
-      if( !err.IsOK() ) return err;
+    //--------------------------------------------------------------------------
+    // Single thread
+    //--------------------------------------------------------------------------
+    if( parallelThreads == 1 || jobs.empty() )
+    {
+      for( size_t i = 0; i < jobs.size(); ++i )
+      {
+        QueuedCopyJob j( jobs[i], progress, jobNums[i], totalJobs );
+        j.Run(0);
+      }
     }
     //--------------------------------------------------------------------------
     // Multiple threads
@@ -376,7 +400,7 @@ namespace XrdCl
     else
     {
       uint16_t workers = std::min( (uint16_t)parallelThreads,
-                                   (uint16_t)pJobs.size() );
+                                   (uint16_t)jobs.size() );
       JobManager jm( workers );
       jm.Initialize();
       if( !jm.Start() )
@@ -385,14 +409,13 @@ namespace XrdCl
 
       Semaphore *sem = new Semaphore(0);
       std::vector<QueuedCopyJob*> queued;
-      for( it = pJobs.begin(); it != pJobs.end(); ++it )
+      for( size_t i = 0; i < jobs.size(); ++i )
       {
-        QueuedCopyJob *j = new QueuedCopyJob( *it, progress, currentJob,
+        QueuedCopyJob *j = new QueuedCopyJob( jobs[i], progress, jobNums[i],
                                               totalJobs, sem );
 
         queued.push_back( j );
         jm.QueueJob(j, 0);
-        ++currentJob;
       }
 
       std::vector<QueuedCopyJob*>::iterator itQ;
@@ -406,13 +429,13 @@ namespace XrdCl
       jm.Finalize();
       for( itQ = queued.begin(); itQ != queued.end(); ++itQ )
         delete *itQ;
+    }
 
-      for( it = pJobs.begin(); it != pJobs.end(); ++it )
-      {
-        XRootDStatus st = (*it)->GetResults()->Get<XRootDStatus>( "status" );
-        if( !st.IsOK() ) return st;
-      }
-    };
+    for( it = pJobs.begin(); it != pJobs.end(); ++it )
+    {
+      XRootDStatus st = (*it)->GetResults()->Get<XRootDStatus>( "status" );
+      if( !st.IsOK() ) return st;
+    }
     return XRootDStatus();
   }
 
@@ -150,6 +150,9 @@ namespace XrdCl
       //!
       //! jobType        [string]   - "configuration" - for configuraion
       //! parallel       [uint8_t]  - nomber of copy jobs to be run in parallel
+      //! pipeline       [uint32_t] - number of files kept in flight by the
+      //!                             asynchronous copy pipeline, 0 disables
+      //!                             it, see XRD_CPPIPELINEJOBS
       //!
       //! Results:
       //! sourceCheckSum [string]   - checksum at source, if requested
@@ -0,0 +1,464 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+
+#include "XrdCl/XrdClDeepLocator.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClTaskManager.hh"
+
+#include <sys/time.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Guards the links between the locators and their deadline tasks, the
+  // locator may be done and gone long before the task is run
+  //----------------------------------------------------------------------------
+  XrdSysMutex deadlineMutex;
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Handler of a single locate request, owns the file system object
+  // the request has been sent through
+  //----------------------------------------------------------------------------
+  class DeepLocator::Handler: public ResponseHandler
+  {
+    public:
+      Handler( DeepLocator *locator, const std::string &node,
+               FileSystem *fs ):
+        pLocator( locator ), pNode( node ), pFS( fs )
+      {
+        gettimeofday( &pSent, 0 );
+      }
+
+      virtual void HandleResponse( XRootDStatus *status,
+                                   AnyObject    *response )
+      {
+        timeval now;
+        gettimeofday( &now, 0 );
+        uint32_t latency = ( now.tv_sec - pSent.tv_sec ) * 1000 +
+                           ( now.tv_usec - pSent.tv_usec ) / 1000;
+        delete pFS;
+        pLocator->HandleResponse( pNode, latency, status, response );
+        delete this;
+      }
+
+    private:
+      DeepLocator *pLocator;
+      std::string  pNode;
+      FileSystem  *pFS;
+      timeval      pSent;
+  };
+
+  //----------------------------------------------------------------------------
+  // Stop the search at the deadline. The task holds a reference to the
+  // locator until it is run or the locator is done, whichever comes first;
+  // in the latter case it stays registered with nothing to do.
+  //----------------------------------------------------------------------------
+  class DeepLocator::DeadlineTask: public Task
+  {
+    public:
+      DeadlineTask( DeepLocator *locator ): pLocator( locator )
+      {
+        SetName( "DeepLocator deadline" );
+      }
+
+      virtual ~DeadlineTask()
+      {
+        DeepLocator *locator = Take();
+        if( locator )
+          locator->Release();
+      }
+
+      virtual time_t Run( time_t )
+      {
+        DeepLocator *locator = Take();
+        if( locator )
+        {
+          locator->Finish( true );
+          locator->Release();
+        }
+        return 0;
+      }
+
+      //------------------------------------------------------------------------
+      // Forget the locator, it is done and drops the reference itself; called
+      // with the deadline mutex held
+      //------------------------------------------------------------------------
+      void Detach()
+      {
+        pLocator = 0;
+      }
+
+    private:
+      DeepLocator *Take()
+      {
+        XrdSysMutexHelper scopedLock( deadlineMutex );
+        DeepLocator *locator = pLocator;
+        pLocator = 0;
+        if( locator )
+          locator->pDeadlineTask = 0;
+        return locator;
+      }
+
+      DeepLocator *pLocator;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  DeepLocator::DeepLocator( const URL          &url,
+                            const std::string  &path,
+                            OpenFlags::Flags    flags,
+                            uint32_t            maxLocations,
+                            uint32_t            deadline,
+                            DeepLocateCallback *callback,
+                            uint16_t            timeout ):
+    pUrl( url ),
+    pPath( path ),
+    pFlags( flags ),
+    pMaxLocations( maxLocations ),
+    pDeadline( deadline ),
+    pCallback( callback ),
+    pExpires( 0 ),
+    pPreconnect( DefaultPreconnectLocated ),
+    pLocations( new LocationInfo() ),
+    pInFlight( 0 ),
+    pRefs( 0 ),
+    pDeadlineTask( 0 ),
+    pFirst( true ),
+    pPartial( false ),
+    pDone( false )
+  {
+    if( timeout )
+      pExpires = ::time( 0 ) + timeout;
+
+    Env *env = DefaultEnv::GetEnv();
+    int maxInFlight = DefaultDeepLocateParallel;
+    env->GetInt( "DeepLocateParallel", maxInFlight );
+    pMaxInFlight = maxInFlight > 0 ? maxInFlight : 1;
+    env->GetInt( "PreconnectLocated", pPreconnect );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  DeepLocator::~DeepLocator()
+  {
+    delete pLocations;
+  }
+
+  //----------------------------------------------------------------------------
+  // Send the first request
+  //----------------------------------------------------------------------------
+  XRootDStatus DeepLocator::Start()
+  {
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileSystemMsg, "[0x%x@DeepLocate(%s)] Locating at %s, up to "
+                "%d requests in flight, stopping at %d locations or after "
+                "%d ms", this, pPath.c_str(), pUrl.GetHostId().c_str(),
+                pMaxInFlight, pMaxLocations, pDeadline );
+
+    //--------------------------------------------------------------------------
+    // One reference for the final answer, one for the request and one
+    // keeping us alive until we're done here, the response may come back
+    // and the search may be over before Send returns
+    //--------------------------------------------------------------------------
+    std::string node = pUrl.GetURL();
+    pVisited.insert( node );
+    pInFlight = 1;
+    pRefs     = 3;
+    XRootDStatus st = Send( node );
+    if( !st.IsOK() )
+      return st;
+
+    pMutex.Lock();
+    if( pDeadline && !pDone )
+    {
+      timeval now;
+      gettimeofday( &now, 0 );
+      uint64_t nowMs = (uint64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
+      ++pRefs;
+      DeadlineTask *task = new DeadlineTask( this );
+      deadlineMutex.Lock();
+      pDeadlineTask = task;
+      deadlineMutex.UnLock();
+      TaskManager *taskMgr = DefaultEnv::GetPostMaster()->GetTaskManager();
+      taskMgr->RegisterTaskMs( task, nowMs + pDeadline );
+    }
+    pMutex.UnLock();
+
+    Release();
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Send a locate request to a node
+  //----------------------------------------------------------------------------
+  XRootDStatus DeepLocator::Send( const std::string &node )
+  {
+    uint16_t timeout = 0;
+    if( pExpires )
+    {
+      time_t now = ::time( 0 );
+      if( now >= pExpires )
+        return XRootDStatus( stError, errOperationExpired );
+      timeout = pExpires - now;
+    }
+
+    FileSystem  *fs      = new FileSystem( URL( node ) );
+    Handler     *handler = new Handler( this, node, fs );
+    XRootDStatus st      = fs->Locate( pPath, pFlags, handler, timeout );
+    if( !st.IsOK() )
+    {
+      delete handler;
+      delete fs;
+    }
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle a response
+  //----------------------------------------------------------------------------
+  void DeepLocator::HandleResponse( const std::string &node,
+                                    uint32_t           latency,
+                                    XRootDStatus      *status,
+                                    AnyObject         *response )
+  {
+    Log          *log     = DefaultEnv::GetLog();
+    LocationInfo *info    = 0;
+    LocationInfo *servers = new LocationInfo();
+    if( status->IsOK() && response )
+      response->Get( info );
+
+    pMutex.Lock();
+    --pInFlight;
+    bool first = pFirst;
+    pFirst = false;
+
+    if( !pDone )
+    {
+      if( !status->IsOK() )
+      {
+        if( first )
+          pFirstError = *status;
+        else
+          pPartial = true;
+      }
+      else if( info )
+      {
+        LocationInfo::Iterator it;
+        for( it = info->Begin(); it != info->End(); ++it )
+        {
+          //--------------------------------------------------------------------
+          // A new server, log in to it while we're still looking for
+          // the others if we're asked to
+          //--------------------------------------------------------------------
+          if( it->IsServer() )
+          {
+            if( !pReported.insert( it->GetAddress() ).second )
+              continue;
+            pLocations->Add( *it );
+            servers->Add( *it );
+            if( pPreconnect )
+            {
+              Status st = DefaultEnv::GetPostMaster()->Preconnect(
+                                                        it->GetAddress() );
+              if( !st.IsOK() )
+                log->Debug( FileSystemMsg, "[0x%x@DeepLocate(%s)] Unable to "
+                            "preconnect to %s: %s", this, pPath.c_str(),
+                            it->GetAddress().c_str(), st.ToString().c_str() );
+            }
+          }
+
+          //--------------------------------------------------------------------
+          // A manager that we have not asked yet
+          //--------------------------------------------------------------------
+          else if( it->IsManager() )
+          {
+            if( pVisited.insert( it->GetAddress() ).second )
+              pQueue.push_back( it->GetAddress() );
+          }
+        }
+      }
+    }
+    pMutex.UnLock();
+
+    log->Debug( FileSystemMsg, "[0x%x@DeepLocate(%s)] %s answered in %d ms: "
+                "%s, %d new server(s)", this, pPath.c_str(), node.c_str(),
+                latency, status->ToStr().c_str(), servers->GetSize() );
+
+    Deliver( node, *status, servers, latency );
+    delete status;
+    delete response;
+
+    Dispatch();
+    Release();
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand the answer of a node to the callback
+  //----------------------------------------------------------------------------
+  void DeepLocator::Deliver( const std::string  &node,
+                             const XRootDStatus &status,
+                             LocationInfo       *servers,
+                             uint32_t            latency )
+  {
+    bool stop = false;
+    {
+      XrdSysMutexHelper scopedLock( pDeliverMutex );
+      bool done;
+      {
+        XrdSysMutexHelper lck( pMutex );
+        done = pDone;
+      }
+
+      if( done )
+      {
+        delete servers;
+        return;
+      }
+      stop = !pCallback->HandleLocations( node, status, servers, latency );
+    }
+
+    if( stop )
+      Finish( false );
+  }
+
+  //----------------------------------------------------------------------------
+  // Ask as many managers as the window allows, finish if we have enough
+  // locations or there is nothing left to do
+  //----------------------------------------------------------------------------
+  void DeepLocator::Dispatch()
+  {
+    pMutex.Lock();
+    bool finish = pMaxLocations && pReported.size() >= pMaxLocations;
+
+    while( !finish && !pDone && !pQueue.empty() && pInFlight < pMaxInFlight )
+    {
+      std::string node = pQueue.front();
+      pQueue.pop_front();
+      ++pInFlight;
+      ++pRefs;
+      pMutex.UnLock();
+
+      XRootDStatus st = Send( node );
+      if( !st.IsOK() )
+        Deliver( node, st, new LocationInfo(), 0 );
+
+      pMutex.Lock();
+      if( st.IsOK() )
+        continue;
+
+      //------------------------------------------------------------------------
+      // The caller holds a reference as well, so this one is never the last
+      //------------------------------------------------------------------------
+      --pInFlight;
+      --pRefs;
+      pPartial = true;
+    }
+
+    if( !pInFlight && pQueue.empty() )
+      finish = true;
+    pMutex.UnLock();
+
+    if( finish )
+      Finish( false );
+  }
+
+  //----------------------------------------------------------------------------
+  // Give the final answer
+  //----------------------------------------------------------------------------
+  void DeepLocator::Finish( bool expired )
+  {
+    pMutex.Lock();
+    if( pDone )
+    {
+      pMutex.UnLock();
+      return;
+    }
+    pDone = true;
+
+    XRootDStatus *st;
+    if( !pFirstError.IsOK() )
+      st = new XRootDStatus( pFirstError );
+    else if( !pLocations->GetSize() )
+    {
+      if( expired )
+        st = new XRootDStatus( stError, errOperationExpired );
+      else
+        st = new XRootDStatus( stError, errErrorResponse, kXR_NotFound,
+                               "No valid location found" );
+    }
+    else if( pPartial || pInFlight || !pQueue.empty() )
+      st = new XRootDStatus( stOK, suPartial );
+    else
+      st = new XRootDStatus();
+
+    LocationInfo *locations = pLocations;
+    pLocations = 0;
+    pQueue.clear();
+    pMutex.UnLock();
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileSystemMsg, "[0x%x@DeepLocate(%s)] Done%s, %d location(s): "
+                "%s", this, pPath.c_str(), expired ? " at the deadline" : "",
+                locations->GetSize(), st->ToStr().c_str() );
+
+    {
+      XrdSysMutexHelper scopedLock( pDeliverMutex );
+      pCallback->HandleDone( st, locations );
+    }
+
+    //--------------------------------------------------------------------------
+    // Take the reference back from the deadline task if it has not run yet
+    //--------------------------------------------------------------------------
+    deadlineMutex.Lock();
+    DeadlineTask *task = pDeadlineTask;
+    pDeadlineTask = 0;
+    if( task )
+      task->Detach();
+    deadlineMutex.UnLock();
+    if( task )
+      Release();
+
+    Release();
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop a reference, the last one deletes the object
+  //----------------------------------------------------------------------------
+  void DeepLocator::Release()
+  {
+    pMutex.Lock();
+    bool last = !--pRefs;
+    pMutex.UnLock();
+    if( last )
+      delete this;
+  }
+}
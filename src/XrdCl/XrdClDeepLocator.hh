@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+
+#ifndef __XRD_CL_DEEP_LOCATOR_HH__
+#define __XRD_CL_DEEP_LOCATOR_HH__
+
+#include "XrdCl/XrdClFileSystem.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <ctime>
+#include <deque>
+#include <set>
+#include <string>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Driver of FileSystem::DeepLocate and FileSystem::DeepLocateStream
+  //!
+  //! The managers still to be asked are kept in a queue, so the cluster
+  //! tree is walked breadth first, and at most DeepLocateParallel locate
+  //! requests are in flight. Every node is asked once and every server
+  //! is reported once, however many managers know of it. The final answer
+  //! may be given while some requests are still in flight, the object
+  //! deletes itself when the last of them and the deadline timer are gone.
+  //----------------------------------------------------------------------------
+  class DeepLocator
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      DeepLocator( const URL          &url,
+                   const std::string  &path,
+                   OpenFlags::Flags    flags,
+                   uint32_t            maxLocations,
+                   uint32_t            deadline,
+                   DeepLocateCallback *callback,
+                   uint16_t            timeout );
+
+      //------------------------------------------------------------------------
+      //! Send the first request, if it fails the object needs to be
+      //! deleted by the caller, otherwise it takes care of itself
+      //------------------------------------------------------------------------
+      XRootDStatus Start();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~DeepLocator();
+
+    private:
+      class Handler;
+      class DeadlineTask;
+      friend class Handler;
+      friend class DeadlineTask;
+
+      XRootDStatus Send( const std::string &node );
+      void HandleResponse( const std::string &node, uint32_t latency,
+                           XRootDStatus *status, AnyObject *response );
+      void Deliver( const std::string &node, const XRootDStatus &status,
+                    LocationInfo *servers, uint32_t latency );
+      void Dispatch();
+      void Finish( bool expired );
+      void Release();
+
+      XrdSysMutex                 pMutex;
+      XrdSysMutex                 pDeliverMutex;
+      URL                         pUrl;
+      std::string                 pPath;
+      OpenFlags::Flags            pFlags;
+      uint32_t                    pMaxLocations;
+      uint32_t                    pDeadline;
+      DeepLocateCallback         *pCallback;
+      time_t                      pExpires;
+      int                         pPreconnect;
+      std::deque<std::string>     pQueue;
+      std::set<std::string>       pVisited;
+      std::set<std::string>       pReported;
+      LocationInfo               *pLocations;
+      uint32_t                    pMaxInFlight;
+      uint32_t                    pInFlight;
+      uint32_t                    pRefs;
+      DeadlineTask               *pDeadlineTask;
+      XRootDStatus                pFirstError;
+      bool                        pFirst;
+      bool                        pPartial;
+      bool                        pDone;
+  };
+}
+
+#endif // __XRD_CL_DEEP_LOCATOR_HH__
@@ -268,6 +268,7 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "StreamTimeout",        DefaultStreamTimeout        );
     REGISTER_VAR_INT( varsInt, "SubStreamsPerChannel", DefaultSubStreamsPerChannel );
     REGISTER_VAR_INT( varsInt, "TimeoutResolution",    DefaultTimeoutResolution    );
+    REGISTER_VAR_INT( varsInt, "TimerResolution",      DefaultTimerResolution      );
     REGISTER_VAR_INT( varsInt, "StreamErrorWindow",    DefaultStreamErrorWindow    );
     REGISTER_VAR_INT( varsInt, "RunForkHandler",       DefaultRunForkHandler       );
     REGISTER_VAR_INT( varsInt, "RedirectLimit",        DefaultRedirectLimit        );
@@ -287,6 +288,22 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "MetalinkProcessing",   DefaultMetalinkProcessing   );
     REGISTER_VAR_INT( varsInt, "LocalMetalinkFile",    DefaultLocalMetalinkFile    );
     REGISTER_VAR_INT( varsInt, "XCpBlockSize",         DefaultXCpBlockSize    );
+    REGISTER_VAR_INT( varsInt, "XCpMinRatePercent",    DefaultXCpMinRatePercent    );
+    REGISTER_VAR_INT( varsInt, "ReadAhead",            DefaultReadAhead            );
+    REGISTER_VAR_INT( varsInt, "ReadAheadBlockSize",   DefaultReadAheadBlockSize   );
+    REGISTER_VAR_INT( varsInt, "ReadAheadMaxWindow",   DefaultReadAheadMaxWindow   );
+    REGISTER_VAR_INT( varsInt, "ReadAheadPoolSize",    DefaultReadAheadPoolSize    );
+    REGISTER_VAR_INT( varsInt, "ReadVGapThreshold",    DefaultReadVGapThreshold    );
+    REGISTER_VAR_INT( varsInt, "ReadVMaxChunks",       DefaultReadVMaxChunks       );
+    REGISTER_VAR_INT( varsInt, "ReadVMaxChunkSize",    DefaultReadVMaxChunkSize    );
+    REGISTER_VAR_INT( varsInt, "CPPipelineJobs",       DefaultCPPipelineJobs       );
+    REGISTER_VAR_INT( varsInt, "CPPipelineBuffer",     DefaultCPPipelineBuffer     );
+    REGISTER_VAR_INT( varsInt, "DirListParallel",      DefaultDirListParallel      );
+    REGISTER_VAR_INT( varsInt, "ZipCDCacheSize",       DefaultZipCDCacheSize       );
+    REGISTER_VAR_INT( varsInt, "DNSCacheTTL",          DefaultDNSCacheTTL          );
+    REGISTER_VAR_INT( varsInt, "ResolverThreads",      DefaultResolverThreads      );
+    REGISTER_VAR_INT( varsInt, "PreconnectLocated",    DefaultPreconnectLocated    );
+    REGISTER_VAR_INT( varsInt, "DeepLocateParallel",   DefaultDeepLocateParallel   );
 
     REGISTER_VAR_STR( varsStr, "PollerPreference",     DefaultPollerPreference     );
     REGISTER_VAR_STR( varsStr, "ClientMonitor",        DefaultClientMonitor        );
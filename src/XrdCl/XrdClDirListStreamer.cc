@@ -0,0 +1,565 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClDirListStreamer.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClBuffer.hh"
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Limits of a kXR_statx batch
+  //----------------------------------------------------------------------------
+  const uint32_t StatXMaxPaths = 1024;
+  const uint32_t StatXMaxBytes = 32768;
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Handler of a single request of the listing
+  //----------------------------------------------------------------------------
+  class DirListStreamer::Handler: public ResponseHandler
+  {
+    public:
+      Handler( DirListStreamer *streamer, const Task &task ):
+        pStreamer( streamer ), pTask( task ) {}
+
+      virtual void HandleResponse( XRootDStatus *status,
+                                   AnyObject    *response )
+      {
+        pStreamer->HandleResponse( pTask, status, response );
+        delete this;
+      }
+
+    private:
+      DirListStreamer *pStreamer;
+      Task             pTask;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  DirListStreamer::DirListStreamer( const URL           &url,
+                                    const std::string   &path,
+                                    DirListFlags::Flags  flags,
+                                    DirListCallback     *callback,
+                                    uint16_t             timeout ):
+    pUrl( url ),
+    pPath( path ),
+    pFlags( flags ),
+    pCallback( callback ),
+    pExpires( 0 ),
+    pLocator( 0 ),
+    pInFlight( 0 ),
+    pTopCount( 0 ),
+    pTopFailed( 0 ),
+    pPartial( false ),
+    pStopped( false ),
+    pFinished( false )
+  {
+    if( timeout )
+      pExpires = ::time( 0 ) + timeout;
+
+    int maxInFlight = DefaultDirListParallel;
+    DefaultEnv::GetEnv()->GetInt( "DirListParallel", maxInFlight );
+    pMaxInFlight = maxInFlight > 0 ? maxInFlight : 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  DirListStreamer::~DirListStreamer()
+  {
+    for( uint32_t i = 0; i < pServers.size(); ++i )
+      delete pServers[i];
+    delete pLocator;
+  }
+
+  //----------------------------------------------------------------------------
+  // Send the first request
+  //----------------------------------------------------------------------------
+  XRootDStatus DirListStreamer::Start()
+  {
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileSystemMsg, "[0x%x@%s] Streaming the listing of %s, up "
+                "to %d requests in flight", this, pUrl.GetHostId().c_str(),
+                pPath.c_str(), pMaxInFlight );
+
+    //--------------------------------------------------------------------------
+    // The response may come back before we return, so we cannot touch
+    // anything once the request is out
+    //--------------------------------------------------------------------------
+    pInFlight = 1;
+    if( pFlags & DirListFlags::Locate )
+      return Send( Task( Task::Locate ) );
+
+    pServers.push_back( new FileSystem( pUrl ) );
+    pTopCount = 1;
+    return Send( Task( Task::List, 0, pPath, true ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Send a request
+  //----------------------------------------------------------------------------
+  XRootDStatus DirListStreamer::Send( const Task &task )
+  {
+    uint16_t timeout = 0;
+    if( pExpires )
+    {
+      time_t now = ::time( 0 );
+      if( now >= pExpires )
+        return XRootDStatus( stError, errOperationExpired );
+      timeout = pExpires - now;
+    }
+
+    Handler     *handler = new Handler( this, task );
+    XRootDStatus st;
+
+    switch( task.type )
+    {
+      case Task::Locate:
+      {
+        //----------------------------------------------------------------------
+        // Deep locate needs an actual timeout to compute its deadline
+        //----------------------------------------------------------------------
+        if( !timeout )
+        {
+          int requestTimeout = DefaultRequestTimeout;
+          DefaultEnv::GetEnv()->GetInt( "RequestTimeout", requestTimeout );
+          timeout = requestTimeout;
+        }
+        if( !pLocator )
+          pLocator = new FileSystem( pUrl );
+        st = pLocator->DeepLocate( "*" + pPath, OpenFlags::PrefName, handler,
+                            timeout );
+        break;
+      }
+
+      case Task::List:
+      {
+        //----------------------------------------------------------------------
+        // We recurse ourselves, but we need the entry types to do so
+        //----------------------------------------------------------------------
+        DirListFlags::Flags flags = DirListFlags::None;
+        if( pFlags & ( DirListFlags::Stat | DirListFlags::Recursive ) )
+          flags = DirListFlags::Stat;
+        st = pServers[task.server]->DirList( task.path, flags, handler,
+                                             timeout );
+        break;
+      }
+
+      case Task::Stat:
+      {
+        DirectoryList *list = task.dir->list;
+        st = pServers[task.server]->Stat( list->GetParentName() +
+                                          list->At( task.first )->GetName(),
+                                          handler, timeout );
+        break;
+      }
+
+      case Task::StatX:
+      {
+        DirectoryList            *list = task.dir->list;
+        std::vector<std::string>  paths;
+        paths.reserve( task.count );
+        for( uint32_t i = task.first; i < task.first + task.count; ++i )
+          paths.push_back( list->GetParentName() + list->At( i )->GetName() );
+        st = pServers[task.server]->StatX( paths, handler, timeout );
+        break;
+      }
+    }
+
+    if( !st.IsOK() )
+      delete handler;
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle a response
+  //----------------------------------------------------------------------------
+  void DirListStreamer::HandleResponse( const Task   &task,
+                                        XRootDStatus *status,
+                                        AnyObject    *response )
+  {
+    std::vector<DirectoryList*> ready;
+    pMutex.Lock();
+    Process( task, status, response, ready );
+    pMutex.UnLock();
+
+    delete status;
+    delete response;
+
+    Deliver( ready );
+    Dispatch( true );
+  }
+
+  //----------------------------------------------------------------------------
+  // Process the outcome of a request, called with the mutex locked
+  //----------------------------------------------------------------------------
+  void DirListStreamer::Process( const Task                  &task,
+                                 XRootDStatus                *status,
+                                 AnyObject                   *response,
+                                 std::vector<DirectoryList*> &ready )
+  {
+    Log *log = DefaultEnv::GetLog();
+
+    if( !status->IsOK() )
+      log->Debug( FileSystemMsg, "[0x%x@%s] Request for %s failed: %s",
+                  this, pUrl.GetHostId().c_str(),
+                  task.dir ? task.dir->list->GetParentName().c_str() :
+                             task.path.c_str(),
+                  status->ToStr().c_str() );
+
+    switch( task.type )
+    {
+      //------------------------------------------------------------------------
+      // Got the servers holding the directory
+      //------------------------------------------------------------------------
+      case Task::Locate:
+      {
+        LocationInfo *locations = 0;
+        if( status->IsOK() && response )
+          response->Get( locations );
+
+        if( !locations || !locations->GetSize() )
+        {
+          pTopError = status->IsOK() ? XRootDStatus( stError, errNotFound ) :
+                                       *status;
+          pTopFailed = pTopCount = 1;
+          return;
+        }
+
+        if( status->code == suPartial )
+          pPartial = true;
+
+        for( uint32_t i = 0; i < locations->GetSize(); ++i )
+        {
+          pServers.push_back( new FileSystem( locations->At(i).GetAddress() ) );
+          pStack.push_back( Task( Task::List, i, pPath, true ) );
+        }
+        pTopCount = locations->GetSize();
+        return;
+      }
+
+      //------------------------------------------------------------------------
+      // Got a directory listing
+      //------------------------------------------------------------------------
+      case Task::List:
+      {
+        DirectoryList *list = 0;
+        if( status->IsOK() && response )
+        {
+          response->Get( list );
+          response->Set( (char*) 0 );
+        }
+
+        if( !list )
+        {
+          if( task.top )
+          {
+            ++pTopFailed;
+            pTopError = status->IsOK() ? XRootDStatus( stError, errInternal ) :
+                                         *status;
+          }
+          else if( !pStopped )
+            pPartial = true;
+          return;
+        }
+
+        if( pStopped )
+        {
+          delete list;
+          return;
+        }
+        ProcessList( task, list, ready );
+        return;
+      }
+
+      //------------------------------------------------------------------------
+      // Got the stat of an entry
+      //------------------------------------------------------------------------
+      case Task::Stat:
+      {
+        StatInfo *info = 0;
+        if( status->IsOK() && response )
+        {
+          response->Get( info );
+          response->Set( (char*) 0 );
+        }
+
+        if( info )
+        {
+          task.dir->list->At( task.first )->SetStatInfo( info );
+          if( ( pFlags & DirListFlags::Recursive ) &&
+              info->TestFlags( StatInfo::IsDir ) )
+            QueueSubDir( task.server, task.dir->list->GetParentName() +
+                         task.dir->list->At( task.first )->GetName() );
+        }
+        else if( !pStopped )
+          pPartial = true;
+
+        EntryDone( task.dir, ready );
+        return;
+      }
+
+      //------------------------------------------------------------------------
+      // Got the types of a batch of entries, stat them one by one if that
+      // did not work
+      //------------------------------------------------------------------------
+      case Task::StatX:
+      {
+        Buffer *flags = 0;
+        if( status->IsOK() && response )
+          response->Get( flags );
+
+        if( !flags || flags->GetSize() != task.count )
+        {
+          if( !pStopped )
+            QueueStats( task.dir, task.first, task.count );
+        }
+        else
+        {
+          DirectoryList *list = task.dir->list;
+          for( uint32_t i = 0; i < task.count; ++i )
+            if( flags->GetBuffer()[i] & StatInfo::IsDir )
+              QueueSubDir( task.server, list->GetParentName() +
+                           list->At( task.first + i )->GetName() );
+        }
+
+        EntryDone( task.dir, ready );
+        return;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle a directory listing
+  //----------------------------------------------------------------------------
+  void DirListStreamer::ProcessList( const Task                  &task,
+                                     DirectoryList               *list,
+                                     std::vector<DirectoryList*> &ready )
+  {
+    bool recursive = pFlags & DirListFlags::Recursive;
+
+    //--------------------------------------------------------------------------
+    // The server did kXR_dstat, we have all we need
+    //--------------------------------------------------------------------------
+    if( !list->GetSize() || list->At( 0 )->GetStatInfo() ||
+        !( pFlags & ( DirListFlags::Stat | DirListFlags::Recursive ) ) )
+    {
+      if( recursive )
+      {
+        DirectoryList::Iterator it;
+        for( it = list->Begin(); it != list->End(); ++it )
+        {
+          StatInfo *info = (*it)->GetStatInfo();
+          if( info && info->TestFlags( StatInfo::IsDir ) )
+            QueueSubDir( task.server, list->GetParentName() +
+                         (*it)->GetName() );
+        }
+      }
+      ready.push_back( list );
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // It did not, the directory needs to wait for its entries to be
+    // examined. If the user wants the stat info we have to ask for every
+    // entry, otherwise the types coming from kXR_statx are enough.
+    //--------------------------------------------------------------------------
+    PendingDir *dir = new PendingDir( list, task.server );
+    if( pFlags & DirListFlags::Stat )
+    {
+      QueueStats( dir, 0, list->GetSize() );
+      return;
+    }
+
+    uint32_t first = 0;
+    uint32_t bytes = 0;
+    for( uint32_t i = 0; i < list->GetSize(); ++i )
+    {
+      uint32_t len = list->GetParentName().length() +
+                     list->At( i )->GetName().length() + 1;
+      if( i > first && ( i - first == StatXMaxPaths ||
+                         bytes + len > StatXMaxBytes ) )
+      {
+        Task t( Task::StatX, task.server );
+        t.dir = dir; t.first = first; t.count = i - first;
+        pStack.push_back( t );
+        ++dir->outstanding;
+        first = i;
+        bytes = 0;
+      }
+      bytes += len;
+    }
+    Task t( Task::StatX, task.server );
+    t.dir = dir; t.first = first; t.count = list->GetSize() - first;
+    pStack.push_back( t );
+    ++dir->outstanding;
+  }
+
+  //----------------------------------------------------------------------------
+  // Queue the listing of a subdirectory
+  //----------------------------------------------------------------------------
+  void DirListStreamer::QueueSubDir( uint32_t           server,
+                                     const std::string &path )
+  {
+    if( pStopped )
+      return;
+    pStack.push_back( Task( Task::List, server, path ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Queue the stats of a range of entries
+  //----------------------------------------------------------------------------
+  void DirListStreamer::QueueStats( PendingDir *dir, uint32_t first,
+                                    uint32_t count )
+  {
+    for( uint32_t i = first; i < first + count; ++i )
+    {
+      Task t( Task::Stat, dir->server );
+      t.dir = dir; t.first = i; t.count = 1;
+      pStack.push_back( t );
+    }
+    dir->outstanding += count;
+  }
+
+  //----------------------------------------------------------------------------
+  // An entry request of a pending directory is done
+  //----------------------------------------------------------------------------
+  void DirListStreamer::EntryDone( PendingDir                  *dir,
+                                   std::vector<DirectoryList*> &ready )
+  {
+    if( --dir->outstanding )
+      return;
+    ready.push_back( dir->list );
+    delete dir;
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand the complete directories to the user, the calls are serialized
+  // and made while the caller still counts as a request in flight, so
+  // that HandleDone cannot overtake them
+  //----------------------------------------------------------------------------
+  void DirListStreamer::Deliver( std::vector<DirectoryList*> &ready )
+  {
+    if( ready.empty() )
+      return;
+
+    XrdSysMutexHelper scopedLock( pDeliverMutex );
+    for( uint32_t i = 0; i < ready.size(); ++i )
+    {
+      bool stopped;
+      {
+        XrdSysMutexHelper lck( pMutex );
+        stopped = pStopped;
+      }
+
+      if( stopped )
+      {
+        delete ready[i];
+        continue;
+      }
+
+      if( !pCallback->HandleEntries( ready[i] ) )
+      {
+        XrdSysMutexHelper lck( pMutex );
+        pStopped = true;
+      }
+    }
+    ready.clear();
+  }
+
+  //----------------------------------------------------------------------------
+  // Send as many requests as the window allows, finish if there is
+  // nothing left to do
+  //----------------------------------------------------------------------------
+  void DirListStreamer::Dispatch( bool release )
+  {
+    pMutex.Lock();
+    if( release )
+      --pInFlight;
+
+    while( !pStack.empty() && pInFlight < pMaxInFlight )
+    {
+      Task task = pStack.back();
+      pStack.pop_back();
+      ++pInFlight;
+
+      //------------------------------------------------------------------------
+      // Once stopped we just unwind the queued requests, the pending
+      // directories get released as their last entry goes
+      //------------------------------------------------------------------------
+      XRootDStatus st( stError, errInvalidOp );
+      if( !pStopped )
+      {
+        pMutex.UnLock();
+        st = Send( task );
+        pMutex.Lock();
+      }
+
+      if( st.IsOK() )
+        continue;
+
+      std::vector<DirectoryList*> ready;
+      Process( task, &st, 0, ready );
+      pMutex.UnLock();
+      Deliver( ready );
+      pMutex.Lock();
+      --pInFlight;
+    }
+
+    bool finish = !pInFlight && pStack.empty() && !pFinished;
+    if( finish )
+      pFinished = true;
+    pMutex.UnLock();
+
+    if( finish )
+      Finish();
+  }
+
+  //----------------------------------------------------------------------------
+  // Report the final status and clean up
+  //----------------------------------------------------------------------------
+  void DirListStreamer::Finish()
+  {
+    XRootDStatus *st;
+    if( pTopCount && pTopFailed == pTopCount )
+      st = new XRootDStatus( pTopError );
+    else if( pPartial || pTopFailed )
+      st = new XRootDStatus( stOK, suPartial );
+    else
+      st = new XRootDStatus();
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileSystemMsg, "[0x%x@%s] Done streaming the listing of %s: "
+                "%s", this, pUrl.GetHostId().c_str(), pPath.c_str(),
+                st->ToStr().c_str() );
+
+    pCallback->HandleDone( st );
+    delete this;
+  }
+}
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_DIR_LIST_STREAMER_HH__
+#define __XRD_CL_DIR_LIST_STREAMER_HH__
+
+#include "XrdCl/XrdClFileSystem.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <ctime>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Driver of FileSystem::DirListStream
+  //!
+  //! The requests to be sent (directory listings, stats of the entries of
+  //! a listed directory) are kept in a stack, so that the tree is walked
+  //! depth first and only the directories waiting for the stats of their
+  //! entries are held in memory. At most DirListParallel requests are in
+  //! flight, whatever server they go to. The object deletes itself after
+  //! calling DirListCallback::HandleDone.
+  //----------------------------------------------------------------------------
+  class DirListStreamer
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      DirListStreamer( const URL           &url,
+                       const std::string   &path,
+                       DirListFlags::Flags  flags,
+                       DirListCallback     *callback,
+                       uint16_t             timeout );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~DirListStreamer();
+
+      //------------------------------------------------------------------------
+      //! Send the first request, if it fails the object needs to be
+      //! deleted by the caller, otherwise it takes care of itself
+      //------------------------------------------------------------------------
+      XRootDStatus Start();
+
+    private:
+      class Handler;
+      friend class Handler;
+
+      //------------------------------------------------------------------------
+      // A listed directory waiting for the stats of its entries
+      //------------------------------------------------------------------------
+      struct PendingDir
+      {
+        PendingDir( DirectoryList *l, uint32_t s ):
+          list( l ), server( s ), outstanding( 0 ) {}
+        DirectoryList *list;
+        uint32_t       server;
+        uint32_t       outstanding;
+      };
+
+      //------------------------------------------------------------------------
+      // A request to be sent
+      //------------------------------------------------------------------------
+      struct Task
+      {
+        enum Type { Locate, List, Stat, StatX };
+
+        Task( Type t, uint32_t s = 0, const std::string &p = "",
+              bool tp = false ):
+          type( t ), server( s ), path( p ), top( tp ), dir( 0 ),
+          first( 0 ), count( 0 ) {}
+
+        Type         type;
+        uint32_t     server;
+        std::string  path;
+        bool         top;
+        PendingDir  *dir;
+        uint32_t     first;
+        uint32_t     count;
+      };
+
+      XRootDStatus Send( const Task &task );
+      void HandleResponse( const Task &task, XRootDStatus *status,
+                           AnyObject *response );
+      void Process( const Task &task, XRootDStatus *status,
+                    AnyObject *response, std::vector<DirectoryList*> &ready );
+      void ProcessList( const Task &task, DirectoryList *list,
+                        std::vector<DirectoryList*> &ready );
+      void QueueSubDir( uint32_t server, const std::string &path );
+      void QueueStats( PendingDir *dir, uint32_t first, uint32_t count );
+      void EntryDone( PendingDir *dir, std::vector<DirectoryList*> &ready );
+      void Deliver( std::vector<DirectoryList*> &ready );
+      void Dispatch( bool release );
+      void Finish();
+
+      XrdSysMutex                  pMutex;
+      XrdSysMutex                  pDeliverMutex;
+      URL                          pUrl;
+      std::string                  pPath;
+      DirListFlags::Flags          pFlags;
+      DirListCallback             *pCallback;
+      time_t                       pExpires;
+      FileSystem                  *pLocator;
+      std::vector<FileSystem*>     pServers;
+      std::deque<Task>             pStack;
+      uint32_t                     pMaxInFlight;
+      uint32_t                     pInFlight;
+      uint32_t                     pTopCount;
+      uint32_t                     pTopFailed;
+      XRootDStatus                 pTopError;
+      bool                         pPartial;
+      bool                         pStopped;
+      bool                         pFinished;
+  };
+}
+
+#endif // __XRD_CL_DIR_LIST_STREAMER_HH__
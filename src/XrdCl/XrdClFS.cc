@@ -205,6 +205,100 @@ XRootDStatus DoCD( FileSystem                      *fs,
   return XRootDStatus();
 }
 
+//------------------------------------------------------------------------------
+// Print a directory entry
+//------------------------------------------------------------------------------
+void PrintDirEntry( DirectoryList            *list,
+                    DirectoryList::ListEntry *entry,
+                    bool                      stats,
+                    bool                      showUrls )
+{
+  if( stats )
+  {
+    StatInfo *info = entry->GetStatInfo();
+    if( !info )
+    {
+      std::cout << "---- 0000-00-00 00:00:00            ? ";
+    }
+    else
+    {
+      if( info->TestFlags( StatInfo::IsDir ) )
+        std::cout << "d";
+      else
+        std::cout << "-";
+
+      if( info->TestFlags( StatInfo::IsReadable ) )
+        std::cout << "r";
+      else
+        std::cout << "-";
+
+      if( info->TestFlags( StatInfo::IsWritable ) )
+        std::cout << "w";
+      else
+        std::cout << "-";
+
+      if( info->TestFlags( StatInfo::XBitSet ) )
+        std::cout << "x";
+      else
+        std::cout << "-";
+
+      std::cout << " " << info->GetModTimeAsString();
+
+      std::cout << std::setw(12) << info->GetSize() << " ";
+    }
+  }
+  if( showUrls )
+    std::cout << "root://" << entry->GetHostAddress() << "/";
+  std::cout << list->GetParentName() << entry->GetName() << std::endl;
+}
+
+//------------------------------------------------------------------------------
+// Print the files of a recursive listing as the directories come in
+//------------------------------------------------------------------------------
+class RecursiveLSPrinter: public DirListCallback
+{
+  public:
+    RecursiveLSPrinter( bool stats, bool showUrls ):
+      pStats( stats ), pShowUrls( showUrls ), pStatus( 0 ), pSem( 0 ) {}
+
+    ~RecursiveLSPrinter()
+    {
+      delete pStatus;
+    }
+
+    virtual bool HandleEntries( DirectoryList *entries )
+    {
+      DirectoryList::Iterator it;
+      for( it = entries->Begin(); it != entries->End(); ++it )
+      {
+        StatInfo *info = (*it)->GetStatInfo();
+        if( info && info->TestFlags( StatInfo::IsDir ) )
+          continue;
+        PrintDirEntry( entries, *it, pStats, pShowUrls );
+      }
+      delete entries;
+      return true;
+    }
+
+    virtual void HandleDone( XRootDStatus *status )
+    {
+      pStatus = status;
+      pSem.Post();
+    }
+
+    XRootDStatus Wait()
+    {
+      pSem.Wait();
+      return *pStatus;
+    }
+
+  private:
+    bool             pStats;
+    bool             pShowUrls;
+    XRootDStatus    *pStatus;
+    XrdSysSemaphore  pSem;
+};
+
 //------------------------------------------------------------------------------
 // List a directory
 //------------------------------------------------------------------------------
@@ -259,6 +353,31 @@ XRootDStatus DoLS( FileSystem                      *fs,
 
   log->Debug( AppMsg, "Attempting to list: %s", newPath.c_str() );
 
+  //----------------------------------------------------------------------------
+  // Stream the recursive listings, we need the entry types to leave the
+  // directories out
+  //----------------------------------------------------------------------------
+  if( flags & DirListFlags::Recursive )
+  {
+    RecursiveLSPrinter printer( stats, showUrls );
+    XRootDStatus st = fs->DirListStream( newPath, flags | DirListFlags::Stat,
+                                         &printer );
+    if( st.IsOK() )
+      st = printer.Wait();
+    if( !st.IsOK() )
+    {
+      log->Error( AppMsg, "Unable to list the path: %s", st.ToStr().c_str() );
+      return st;
+    }
+
+    if( st.code == suPartial )
+    {
+      std::cerr << "[!] Some of the requests failed. The result may be ";
+      std::cerr << "incomplete." << std::endl;
+    }
+    return XRootDStatus();
+  }
+
   //----------------------------------------------------------------------------
   // Ask for the list
   //----------------------------------------------------------------------------
@@ -281,45 +400,7 @@ XRootDStatus DoLS( FileSystem                      *fs,
   //----------------------------------------------------------------------------
   DirectoryList::Iterator it;
   for( it = list->Begin(); it != list->End(); ++it )
-  {
-    if( stats )
-    {
-      StatInfo *info = (*it)->GetStatInfo();
-      if( !info )
-      {
-        std::cout << "---- 0000-00-00 00:00:00            ? ";
-      }
-      else
-      {
-        if( info->TestFlags( StatInfo::IsDir ) )
-          std::cout << "d";
-        else
-          std::cout << "-";
-
-        if( info->TestFlags( StatInfo::IsReadable ) )
-          std::cout << "r";
-        else
-          std::cout << "-";
-
-        if( info->TestFlags( StatInfo::IsWritable ) )
-          std::cout << "w";
-        else
-          std::cout << "-";
-
-        if( info->TestFlags( StatInfo::XBitSet ) )
-          std::cout << "x";
-        else
-          std::cout << "-";
-
-        std::cout << " " << info->GetModTimeAsString();
-
-        std::cout << std::setw(12) << info->GetSize() << " ";
-      }
-    }
-    if( showUrls )
-      std::cout << "root://" << (*it)->GetHostAddress() << "/";
-    std::cout << list->GetParentName() << (*it)->GetName() << std::endl;
-  }
+    PrintDirEntry( list, *it, stats, showUrls );
   delete list;
   return XRootDStatus();
 }
@@ -396,6 +396,10 @@ namespace XrdCl
       //! ReadRecovery     [true/false] - enable/disable read recovery
       //! WriteRecovery    [true/false] - enable/disable write recovery
       //! FollowRedirects  [true/false] - enable/disable following redirections
+      //! ReadAhead        [true/false] - enable/disable the adaptive read-ahead
+      //!                                 of sequential and strided reads
+      //!                                 (read-only files, default from the
+      //!                                 ReadAhead environment variable)
       //------------------------------------------------------------------------
       bool SetProperty( const std::string &name, const std::string &value );
 
@@ -37,6 +37,8 @@
 #include "XrdCl/XrdClResponseJob.hh"
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClUglyHacks.hh"
+#include "XrdCl/XrdClReadAhead.hh"
+#include "XrdCl/XrdClVectorReadPlanner.hh"
 #include "XrdClRedirectorRegistry.hh"
 
 #include <sstream>
@@ -223,6 +225,38 @@ namespace
       XrdCl::Message           *pMessage;
       XrdCl::MessageSendParams  pSendParams;
   };
+
+  //----------------------------------------------------------------------------
+  // Owns the message and the chunk list of a read-ahead request, these are
+  // not tracked by the state handler
+  //----------------------------------------------------------------------------
+  class PrefetchHolder: public XrdCl::ResponseHandler
+  {
+    public:
+      PrefetchHolder( XrdCl::ResponseHandler *handler,
+                      XrdCl::Message         *message,
+                      XrdCl::ChunkList       *chunkList ):
+        pHandler( handler ), pMessage( message ), pChunkList( chunkList ) {}
+
+      virtual ~PrefetchHolder()
+      {
+        delete pMessage;
+        delete pChunkList;
+      }
+
+      virtual void HandleResponseWithHosts( XrdCl::XRootDStatus *status,
+                                            XrdCl::AnyObject    *response,
+                                            XrdCl::HostList     *hostList )
+      {
+        pHandler->HandleResponseWithHosts( status, response, hostList );
+        delete this;
+      }
+
+    private:
+      XrdCl::ResponseHandler *pHandler;
+      XrdCl::Message         *pMessage;
+      XrdCl::ChunkList       *pChunkList;
+  };
 }
 
 namespace XrdCl
@@ -332,8 +366,13 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( true ),
+    pDoReadAhead( false ),
+    pReadAhead( 0 ),
     pReOpenHandler( 0 )
   {
+    int readAhead = DefaultReadAhead;
+    DefaultEnv::GetEnv()->GetInt( "ReadAhead", readAhead );
+    pDoReadAhead = readAhead;
     pFileHandle = new uint8_t[4];
     ResetMonitoringVars();
     DefaultEnv::GetForkHandler()->RegisterFileObject( this );
@@ -361,8 +400,13 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( useVirtRedirector ),
+    pDoReadAhead( false ),
+    pReadAhead( 0 ),
     pReOpenHandler( 0 )
   {
+    int readAhead = DefaultReadAhead;
+    DefaultEnv::GetEnv()->GetInt( "ReadAhead", readAhead );
+    pDoReadAhead = readAhead;
     pFileHandle = new uint8_t[4];
     ResetMonitoringVars();
     DefaultEnv::GetForkHandler()->RegisterFileObject( this );
@@ -377,6 +421,9 @@ namespace XrdCl
     if( pReOpenHandler )
       pReOpenHandler->Destroy();
 
+    if( pReadAhead )
+      pReadAhead->Detach();
+
     if( DefaultEnv::GetFileTimer() )
       DefaultEnv::GetFileTimer()->UnRegisterFileObject( this );
 
@@ -554,6 +601,9 @@ namespace XrdCl
 
     pFileState = CloseInProgress;
 
+    if( pReadAhead )
+      pReadAhead->Discard();
+
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a close command for handle 0x%x to "
                 "%s", this, pFileUrl->GetURL().c_str(),
@@ -663,6 +713,44 @@ namespace XrdCl
     if( pFileState != Opened && pFileState != Recovering )
       return XRootDStatus( stError, errInvalidOp );
 
+    //--------------------------------------------------------------------------
+    // Let the read-ahead have a look at the read
+    //--------------------------------------------------------------------------
+    if( pDoReadAhead && IsReadOnly() )
+    {
+      if( !pReadAhead )
+      {
+        int blockSize = DefaultReadAheadBlockSize;
+        int maxWindow = DefaultReadAheadMaxWindow;
+        DefaultEnv::GetEnv()->GetInt( "ReadAheadBlockSize", blockSize );
+        DefaultEnv::GetEnv()->GetInt( "ReadAheadMaxWindow", maxWindow );
+        if( blockSize <= 0 ) blockSize = DefaultReadAheadBlockSize;
+        if( maxWindow <= 0 ) maxWindow = DefaultReadAheadMaxWindow;
+        pReadAhead = new ReadAhead( this, blockSize, maxWindow );
+      }
+
+      uint64_t fileSize = pStatInfo ? pStatInfo->GetSize() : 0;
+      if( pReadAhead->Read( offset, size, buffer, handler, timeout,
+                            fileSize ) )
+      {
+        ++pRCount;
+        pRBytes += size;
+        return XRootDStatus();
+      }
+    }
+
+    return SendRead( offset, size, buffer, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Build and send a stateful read request
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::SendRead( uint64_t         offset,
+                                           uint32_t         size,
+                                           void            *buffer,
+                                           ResponseHandler *handler,
+                                           uint16_t         timeout )
+  {
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a read command for handle 0x%x to "
                 "%s", this, pFileUrl->GetURL().c_str(),
@@ -692,6 +780,69 @@ namespace XrdCl
     return SendOrQueue( *pDataServer, msg, stHandler, params );
   }
 
+  //----------------------------------------------------------------------------
+  // Read bypassing the read-ahead
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::ReRead( uint64_t         offset,
+                                         uint32_t         size,
+                                         void            *buffer,
+                                         ResponseHandler *handler,
+                                         uint16_t         timeout )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    if( pFileState != Opened && pFileState != Recovering )
+      return XRootDStatus( stError, errInvalidOp );
+
+    return SendRead( offset, size, buffer, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Send a read-ahead request
+  //----------------------------------------------------------------------------
+  Status FileStateHandler::SendPrefetch( uint64_t         offset,
+                                         uint32_t         size,
+                                         void            *buffer,
+                                         ResponseHandler *handler,
+                                         uint16_t         timeout )
+  {
+    if( pFileState != Opened )
+      return Status( stError, errInvalidOp );
+
+    Log *log = DefaultEnv::GetLog();
+    log->Dump( FileMsg, "[0x%x@%s] Sending a read-ahead of %d bytes at %ld "
+               "for handle 0x%x to %s", this, pFileUrl->GetURL().c_str(),
+               size, offset, *((uint32_t*)pFileHandle),
+               pDataServer->GetHostId().c_str() );
+
+    Message           *msg;
+    ClientReadRequest *req;
+    MessageUtils::CreateRequest( msg, req );
+
+    req->requestid  = kXR_read;
+    req->offset     = offset;
+    req->rlen       = size;
+    memcpy( req->fhandle, pFileHandle, 4 );
+
+    ChunkList *list   = new ChunkList();
+    list->push_back( ChunkInfo( offset, size, buffer ) );
+
+    XRootDTransport::SetDescription( msg );
+    msg->SetSessionId( pSessionId );
+    MessageSendParams params;
+    params.timeout         = timeout;
+    params.followRedirects = false;
+    params.stateful        = true;
+    params.chunkList       = list;
+    MessageUtils::ProcessSendParams( params );
+
+    PrefetchHolder *holder = new PrefetchHolder( handler, msg, list );
+    Status st = MessageUtils::SendMessage( *pDataServer, msg, holder, params );
+    if( !st.IsOK() )
+      delete holder;
+    return st;
+  }
+
   //----------------------------------------------------------------------------
   // Write a data chunk at a given offset - async
   //----------------------------------------------------------------------------
@@ -822,6 +973,78 @@ namespace XrdCl
     if( pFileState != Opened && pFileState != Recovering )
       return XRootDStatus( stError, errInvalidOp );
 
+    //--------------------------------------------------------------------------
+    // Work out the requests to be sent
+    //--------------------------------------------------------------------------
+    int maxGap       = DefaultReadVGapThreshold;
+    int maxChunks    = DefaultReadVMaxChunks;
+    int maxChunkSize = DefaultReadVMaxChunkSize;
+    DefaultEnv::GetEnv()->GetInt( "ReadVGapThreshold", maxGap );
+    DefaultEnv::GetEnv()->GetInt( "ReadVMaxChunks",    maxChunks );
+    DefaultEnv::GetEnv()->GetInt( "ReadVMaxChunkSize", maxChunkSize );
+    if( maxChunks <= 0 )    maxChunks    = DefaultReadVMaxChunks;
+    if( maxChunkSize <= 0 ) maxChunkSize = DefaultReadVMaxChunkSize;
+
+    //--------------------------------------------------------------------------
+    // Without a gap threshold the chunks go out as given
+    //--------------------------------------------------------------------------
+    if( maxGap <= 0 )
+      return SendReadV( chunks, buffer, handler, timeout );
+
+    VectorReadPlanner *planner = new VectorReadPlanner( chunks, buffer, maxGap,
+                                                        maxChunks,
+                                                        maxChunkSize );
+    if( planner->IsTrivial() )
+    {
+      XRootDStatus st = SendReadV( planner->GetChunks(), 0, handler,
+                                   timeout );
+      delete planner;
+      return st;
+    }
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[0x%x@%s] Vector read of %d chunks split into %d "
+                "requests", this, pFileUrl->GetURL().c_str(), (int)chunks.size(),
+                (int)planner->GetRequests().size() );
+
+    //--------------------------------------------------------------------------
+    // Send the requests, the collector calls the user handler back when
+    // all of them are done
+    //--------------------------------------------------------------------------
+    const std::vector<VectorReadPlanner::Request> &requests =
+      planner->GetRequests();
+    VectorReadCollector *collector = new VectorReadCollector( planner,
+                                                              handler );
+    for( size_t i = 0; i < requests.size(); ++i )
+    {
+      const VectorReadPlanner::Request &r = requests[i];
+      ResponseHandler *h = collector->GetHandler( i );
+      XRootDStatus st;
+      if( r.readv )
+        st = SendReadV( r.chunks, 0, h, timeout );
+      else
+        st = SendRead( r.chunks[0].offset, r.chunks[0].length,
+                       r.chunks[0].buffer, h, timeout );
+
+      if( !st.IsOK() )
+      {
+        delete h;
+        if( collector->SendFailed( i, st ) )
+          return st;
+        break;
+      }
+    }
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Build and send a stateful vector read request
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::SendReadV( const ChunkList &chunks,
+                                            void            *buffer,
+                                            ResponseHandler *handler,
+                                            uint16_t         timeout )
+  {
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a vector read command for handle "
                 "0x%x to %s", this, pFileUrl->GetURL().c_str(),
@@ -990,6 +1213,16 @@ namespace XrdCl
       else pFollowRedirects = false;
       return true;
     }
+    else if( name == "ReadAhead" )
+    {
+      if( value == "true" ) pDoReadAhead = true;
+      else
+      {
+        pDoReadAhead = false;
+        if( pReadAhead ) pReadAhead->Discard();
+      }
+      return true;
+    }
     return false;
   }
 
@@ -1018,6 +1251,12 @@ namespace XrdCl
       else value = "false";
       return true;
     }
+    else if( name == "ReadAhead" )
+    {
+      if( pDoReadAhead ) value = "true";
+      else value = "false";
+      return true;
+    }
     else if( name == "DataServer" && pDataServer )
       { value = pDataServer->GetHostId(); return true; }
     else if( name == "LastURL" && pDataServer )
@@ -37,12 +37,15 @@ namespace XrdCl
 {
   class ResponseHandlerHolder;
   class Message;
+  class ReadAhead;
 
   //----------------------------------------------------------------------------
   //! Handle the stateful operations
   //----------------------------------------------------------------------------
   class FileStateHandler
   {
+    friend class ReadAhead;
+
     public:
       //------------------------------------------------------------------------
       //! State of the file
@@ -329,6 +332,45 @@ namespace XrdCl
       };
       typedef std::list<RequestData> RequestList;
 
+      //------------------------------------------------------------------------
+      //! Build and send a stateful read request, the lock must be held
+      //------------------------------------------------------------------------
+      XRootDStatus SendRead( uint64_t         offset,
+                             uint32_t         size,
+                             void            *buffer,
+                             ResponseHandler *handler,
+                             uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! Build and send a stateful vector read request, the lock must be
+      //! held. If buffer is given the chunks are read into it one after
+      //! another, otherwise into their own buffers.
+      //------------------------------------------------------------------------
+      XRootDStatus SendReadV( const ChunkList &chunks,
+                              void            *buffer,
+                              ResponseHandler *handler,
+                              uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! Read bypassing the read-ahead, used to re-issue the user reads
+      //! that were waiting for a failed prefetch
+      //------------------------------------------------------------------------
+      XRootDStatus ReRead( uint64_t         offset,
+                           uint32_t         size,
+                           void            *buffer,
+                           ResponseHandler *handler,
+                           uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! Send a read-ahead request, the lock must be held. Prefetches are
+      //! not tracked nor recovered.
+      //------------------------------------------------------------------------
+      Status SendPrefetch( uint64_t         offset,
+                           uint32_t         size,
+                           void            *buffer,
+                           ResponseHandler *handler,
+                           uint16_t         timeout );
+
       //------------------------------------------------------------------------
       //! Send a message to a host or put it in the recovery queue
       //------------------------------------------------------------------------
@@ -431,6 +473,8 @@ namespace XrdCl
       bool                    pFollowRedirects;
       bool                    pDoneInitOpen;
       bool                    pUseVirtRedirector;
+      bool                    pDoReadAhead;
+      ReadAhead              *pReadAhead;
 
       //------------------------------------------------------------------------
       // Monitoring variables
@@ -34,6 +34,8 @@
 #include "XrdCl/XrdClForkHandler.hh"
 #include "XrdCl/XrdClPlugInInterface.hh"
 #include "XrdCl/XrdClPlugInManager.hh"
+#include "XrdCl/XrdClDirListStreamer.hh"
+#include "XrdCl/XrdClDeepLocator.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
 #include <memory>
@@ -41,208 +43,51 @@
 namespace
 {
   //----------------------------------------------------------------------------
-  //! Wrapper class used to delete FileSystem object
+  // Deep locate handler, gives the final answer of the deep locator to
+  // a response handler
   //----------------------------------------------------------------------------
-  class DeallocFSHandler: public XrdCl::ResponseHandler
-  {
-    public:
-      //------------------------------------------------------------------------
-      // Constructor and destructor
-      //------------------------------------------------------------------------
-      DeallocFSHandler( XrdCl::FileSystem *fs, ResponseHandler *userHandler ):
-        pFS(fs), pUserHandler(userHandler) {}
-
-      virtual ~DeallocFSHandler()
-      {
-        delete pFS;
-      }
-
-      //------------------------------------------------------------------------
-      // Handle the response
-      //------------------------------------------------------------------------
-      virtual void HandleResponse( XrdCl::XRootDStatus *status,
-                                   XrdCl::AnyObject    *response )
-      {
-        pUserHandler->HandleResponse(status, response);
-        delete this;
-      }
-
-    private:
-      XrdCl::FileSystem *pFS;
-      ResponseHandler   *pUserHandler;
-  };
-
-  //----------------------------------------------------------------------------
-  // Deep locate handler
-  //----------------------------------------------------------------------------
-  class DeepLocateHandler: public XrdCl::ResponseHandler
+  class DeepLocateResponder: public XrdCl::DeepLocateCallback
   {
     public:
       //------------------------------------------------------------------------
       // Constructor
       //------------------------------------------------------------------------
-      DeepLocateHandler( XrdCl::ResponseHandler   *handler,
-                         const std::string        &path,
-                         XrdCl::OpenFlags::Flags   flags,
-                         time_t                    expires ):
-        pFirstTime( true ),
-        pPartial( false ),
-        pOutstanding( 1 ),
-        pHandler( handler ),
-        pPath( path ),
-        pFlags( flags ),
-        pExpires(expires)
-      {
-        pLocations = new XrdCl::LocationInfo();
-      }
+      DeepLocateResponder( XrdCl::ResponseHandler *handler ):
+        pHandler( handler ) {}
 
       //------------------------------------------------------------------------
-      // Destructor
+      // We only care about the final answer
       //------------------------------------------------------------------------
-      ~DeepLocateHandler()
+      virtual bool HandleLocations( const std::string         &,
+                                    const XrdCl::XRootDStatus &,
+                                    XrdCl::LocationInfo       *servers,
+                                    uint32_t                   )
       {
-        delete pLocations;
-      }
-
-      //------------------------------------------------------------------------
-      // Handle the response
-      //------------------------------------------------------------------------
-      virtual void HandleResponse( XrdCl::XRootDStatus *status,
-                                   XrdCl::AnyObject    *response )
-      {
-        XrdSysMutexHelper scopedLock( pMutex );
-        using namespace XrdCl;
-        Log *log = DefaultEnv::GetLog();
-        --pOutstanding;
-
-        //----------------------------------------------------------------------
-        // We've got an error, react accordingly
-        //----------------------------------------------------------------------
-        if( !status->IsOK() )
-        {
-          log->Dump( FileSystemMsg, "[0x%x@DeepLocate(%s)] Got error "
-                     "response: %s", this, pPath.c_str(),
-                     status->ToStr().c_str() );
-
-          //--------------------------------------------------------------------
-          // We have failed with the first request
-          //--------------------------------------------------------------------
-          if( pFirstTime )
-          {
-            log->Debug( FileSystemMsg, "[0x%x@DeepLocate(%s)] Failed to get "
-                        "the initial location list: %s", this, pPath.c_str(),
-                        status->ToStr().c_str() );
-            pHandler->HandleResponse( status, response );
-            scopedLock.UnLock();
-            delete this;
-            return;
-          }
-
-          pPartial = true;
-
-          //--------------------------------------------------------------------
-          // We have no more outstanding requests, so let give to the client
-          // what we have
-          //--------------------------------------------------------------------
-          if( !pOutstanding )
-          {
-            log->Debug( FileSystemMsg, "[0x%x@DeepLocate(%s)] No outstanding "
-                        "requests, give out what we've got", this,
-                        pPath.c_str() );
-            scopedLock.UnLock();
-            HandleFinalResponse();
-          }
-          delete status;
-          return;
-        }
-        pFirstTime = false;
-
-        //----------------------------------------------------------------------
-        // Extract the answer
-        //----------------------------------------------------------------------
-        LocationInfo *info = 0;
-        response->Get( info );
-        LocationInfo::Iterator it;
-
-        log->Dump( FileSystemMsg, "[0x%x@DeepLocate(%s)] Got %d locations",
-                   this, pPath.c_str(), info->GetSize() );
-
-        for( it = info->Begin(); it != info->End(); ++it )
-        {
-          //--------------------------------------------------------------------
-          // Add the location to the list
-          //--------------------------------------------------------------------
-          if( it->IsServer() )
-          {
-            pLocations->Add( *it );
-            continue;
-          }
-
-          //--------------------------------------------------------------------
-          // Ask the manager for the location of servers
-          //--------------------------------------------------------------------
-          if( it->IsManager() )
-          {
-            FileSystem *fs = new FileSystem( it->GetAddress() );
-            if( fs->Locate( pPath, pFlags, new DeallocFSHandler(fs, this), pExpires-::time(0)).IsOK() )
-              ++pOutstanding;
-          }
-        }
-
-        //----------------------------------------------------------------------
-        // Clean up and check if we have anything else to do
-        //----------------------------------------------------------------------
-        delete response;
-        delete status;
-        if( !pOutstanding )
-        {
-          scopedLock.UnLock();
-          HandleFinalResponse();
-        }
+        delete servers;
+        return true;
       }
 
       //------------------------------------------------------------------------
       // Build the response for the client
       //------------------------------------------------------------------------
-      void HandleFinalResponse()
+      virtual void HandleDone( XrdCl::XRootDStatus *status,
+                               XrdCl::LocationInfo *locations )
       {
         using namespace XrdCl;
-
-        //----------------------------------------------------------------------
-        // Nothing found
-        //----------------------------------------------------------------------
-        if( !pLocations->GetSize() )
+        AnyObject *obj = 0;
+        if( status->IsOK() )
         {
-          pHandler->HandleResponse( new XRootDStatus( stError, errErrorResponse,
-                                                   kXR_NotFound,
-                                                   "No valid location found" ),
-                                    0 );
+          obj = new AnyObject();
+          obj->Set( locations );
         }
-        //----------------------------------------------------------------------
-        // We return an answer
-        //----------------------------------------------------------------------
         else
-        {
-          AnyObject *obj = new AnyObject();
-          obj->Set( pLocations );
-          pLocations = 0;
-          XRootDStatus *st = new XRootDStatus();
-          if( pPartial ) st->code = suPartial;
-          pHandler->HandleResponse( st, obj );
-        }
+          delete locations;
+        pHandler->HandleResponse( status, obj );
         delete this;
       }
 
     private:
-      bool                      pFirstTime;
-      bool                      pPartial;
-      uint16_t                  pOutstanding;
-      XrdCl::ResponseHandler   *pHandler;
-      XrdCl::LocationInfo      *pLocations;
-      std::string               pPath;
-      XrdCl::OpenFlags::Flags   pFlags;
-      time_t                    pExpires;
-      XrdSysMutex               pMutex;
+      XrdCl::ResponseHandler *pHandler;
   };
 
   //----------------------------------------------------------------------------
@@ -628,10 +473,12 @@ namespace XrdCl
                                        ResponseHandler   *handler,
                                        uint16_t           timeout )
   {
-    return Locate( path, flags,
-                   new DeepLocateHandler( handler, path, flags,
-                                          ::time(0)+timeout ),
-                   timeout );
+    DeepLocateResponder *responder = new DeepLocateResponder( handler );
+    XRootDStatus st = DeepLocateStream( path, flags, 0, 0, responder,
+                                        timeout );
+    if( !st.IsOK() )
+      delete responder;
+    return st;
   }
 
   //----------------------------------------------------------------------------
@@ -650,6 +497,28 @@ namespace XrdCl
     return MessageUtils::WaitForResponse( &handler, response );
   }
 
+  //----------------------------------------------------------------------------
+  // Locate a file, recursively locate disk servers, streaming them to
+  // the callback - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::DeepLocateStream( const std::string  &path,
+                                             OpenFlags::Flags    flags,
+                                             uint32_t            maxLocations,
+                                             uint32_t            deadline,
+                                             DeepLocateCallback *callback,
+                                             uint16_t            timeout )
+  {
+    if( !callback )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    DeepLocator *locator = new DeepLocator( *pUrl, path, flags, maxLocations,
+                                            deadline, callback, timeout );
+    XRootDStatus st = locator->Start();
+    if( !st.IsOK() )
+      delete locator;
+    return st;
+  }
+
   //----------------------------------------------------------------------------
   // Move a directory or a file - async
   //----------------------------------------------------------------------------
@@ -1245,6 +1114,57 @@ namespace XrdCl
     return XRootDStatus();
   }
 
+  //----------------------------------------------------------------------------
+  // List entries of a directory, streaming them to the callback - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::DirListStream( const std::string   &path,
+                                          DirListFlags::Flags  flags,
+                                          DirListCallback     *callback,
+                                          uint16_t             timeout )
+  {
+    if( !callback )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    DirListStreamer *streamer = new DirListStreamer( *pUrl, path, flags,
+                                                     callback, timeout );
+    XRootDStatus st = streamer->Start();
+    if( !st.IsOK() )
+      delete streamer;
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the type flags of a list of paths - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::StatX( const std::vector<std::string> &paths,
+                                  ResponseHandler                *handler,
+                                  uint16_t                        timeout )
+  {
+    if( pPlugIn )
+      return XRootDStatus( stError, errNotSupported );
+
+    std::string list;
+    for( size_t i = 0; i < paths.size(); ++i )
+    {
+      if( i ) list += "\n";
+      list += paths[i];
+    }
+
+    Message           *msg;
+    ClientStatRequest *req;
+    MessageUtils::CreateRequest( msg, req, list.length() );
+
+    req->requestid  = kXR_statx;
+    req->options    = 0;
+    req->dlen       = list.length();
+    msg->Append( list.c_str(), list.length(), 24 );
+    MessageSendParams params; params.timeout = timeout;
+    MessageUtils::ProcessSendParams( params );
+    XRootDTransport::SetDescription( msg );
+
+    return Send( msg, handler, params );
+  }
+
   //----------------------------------------------------------------------------
   // Send info to the server - async
   //----------------------------------------------------------------------------
@@ -181,6 +181,74 @@ namespace XrdCl
   };
   XRDOUC_ENUM_OPERATORS( PrepareFlags::Flags )
 
+  //----------------------------------------------------------------------------
+  //! Receive the entries of a streaming directory listing
+  //----------------------------------------------------------------------------
+  class DirListCallback
+  {
+    public:
+      virtual ~DirListCallback() {}
+
+      //------------------------------------------------------------------------
+      //! Called once for every directory that has been listed, the calls
+      //! are serialized
+      //!
+      //! @param entries the entries of the directory, the parent name is
+      //!                the full path of the directory, to be deleted by
+      //!                the user
+      //! @return        false to stop the listing
+      //------------------------------------------------------------------------
+      virtual bool HandleEntries( DirectoryList *entries ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Called once, when the listing is over and there will be no more
+      //! calls to HandleEntries
+      //!
+      //! @param status status of the listing, suPartial if some of the
+      //!               requests failed, to be deleted by the user
+      //------------------------------------------------------------------------
+      virtual void HandleDone( XRootDStatus *status ) = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Receive the answers of a streaming deep locate
+  //----------------------------------------------------------------------------
+  class DeepLocateCallback
+  {
+    public:
+      virtual ~DeepLocateCallback() {}
+
+      //------------------------------------------------------------------------
+      //! Called once for every node of the cluster that has answered or
+      //! failed to answer, the calls are serialized
+      //!
+      //! @param node    address of the node that has been asked
+      //! @param status  status of the locate request sent to the node
+      //! @param servers the data servers reported by the node that have
+      //!                not been reported before, to be deleted by the user
+      //! @param latency time it took the node to answer in milliseconds
+      //! @return        false to stop the search
+      //------------------------------------------------------------------------
+      virtual bool HandleLocations( const std::string  &node,
+                                    const XRootDStatus &status,
+                                    LocationInfo       *servers,
+                                    uint32_t            latency ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Called once, when the search is over and there will be no more
+      //! calls to HandleLocations
+      //!
+      //! @param status    status of the search, suPartial if some of the
+      //!                  nodes failed or have not been asked or answered
+      //!                  because of the deadline or because the search
+      //!                  was stopped, to be deleted by the user
+      //! @param locations all the data servers found, to be deleted by
+      //!                  the user
+      //------------------------------------------------------------------------
+      virtual void HandleDone( XRootDStatus *status,
+                               LocationInfo *locations ) = 0;
+  };
+
   //----------------------------------------------------------------------------
   //! Send file/filesystem queries to an XRootD cluster
   //----------------------------------------------------------------------------
@@ -188,6 +256,7 @@ namespace XrdCl
   {
     friend class AssignLBHandler;
     friend class ForkHandler;
+    friend class DirListStreamer;
 
     public:
       typedef std::vector<LocationInfo> LocationList; //!< Location list
@@ -273,6 +342,40 @@ namespace XrdCl
                                uint16_t            timeout  = 0 )
                                XRD_WARN_UNUSED_RESULT;
 
+      //------------------------------------------------------------------------
+      //! Locate a file, recursively locate disk servers, streaming them to
+      //! the callback as they are found - async
+      //!
+      //! The managers are asked concurrently, at most DeepLocateParallel
+      //! requests being in flight at any time. The search stops, ignoring
+      //! the requests that are still in flight, as soon as at least
+      //! maxLocations servers have been found or the deadline has passed.
+      //! The deadline is checked every TimerResolution milliseconds.
+      //!
+      //! @param path         path to the file to be located
+      //! @param flags        some of the OpenFlags::Flags
+      //! @param maxLocations number of servers to stop at, 0 for all
+      //! @param deadline     time in milliseconds after which the search
+      //!                     is stopped with whatever has been found,
+      //!                     0 for none
+      //! @param callback     callback receiving the locations, must stay
+      //!                     valid until its HandleDone method has been
+      //!                     called
+      //! @param timeout      timeout value for the whole search, every
+      //!                     request gets what is left of it, if 0 the
+      //!                     environment default will be used for every
+      //!                     request
+      //! @return             status of the operation, if it is not OK the
+      //!                     callback is not called
+      //------------------------------------------------------------------------
+      XRootDStatus DeepLocateStream( const std::string  &path,
+                                     OpenFlags::Flags    flags,
+                                     uint32_t            maxLocations,
+                                     uint32_t            deadline,
+                                     DeepLocateCallback *callback,
+                                     uint16_t            timeout = 0 )
+                                     XRD_WARN_UNUSED_RESULT;
+
       //------------------------------------------------------------------------
       //! Move a directory or a file - async
       //!
@@ -625,6 +728,38 @@ namespace XrdCl
                             uint16_t              timeout = 0 )
                             XRD_WARN_UNUSED_RESULT;
 
+      //------------------------------------------------------------------------
+      //! List entries of a directory, streaming them to the callback one
+      //! directory at a time - async
+      //!
+      //! Nothing is accumulated in memory: with DirListFlags::Recursive the
+      //! subdirectories are listed as they are found, at most DirListParallel
+      //! requests being in flight at any time, and every directory listing
+      //! (subdirectories included) is handed to the callback as soon as it
+      //! is complete. With DirListFlags::Locate all the servers holding the
+      //! directory are listed in parallel, each one its own subtree.
+      //! If the server does not support kXR_dstat, the stat information of
+      //! the entries is fetched with kXR_stat requests sharing the same
+      //! request window, or, if only the type of the entries is needed to
+      //! recurse, with one kXR_statx request for a batch of entries; in
+      //! that case the entries come without stat info unless
+      //! DirListFlags::Stat is set.
+      //!
+      //! @param path     directory path
+      //! @param flags    DirListFlags
+      //! @param callback callback receiving the entries, must stay valid
+      //!                 until its HandleDone method has been called
+      //! @param timeout  timeout value for the whole listing, if 0 the
+      //!                 environment default will be used
+      //! @return         status of the operation, if it is not OK the
+      //!                 callback is not called
+      //------------------------------------------------------------------------
+      XRootDStatus DirListStream( const std::string   &path,
+                                  DirListFlags::Flags  flags,
+                                  DirListCallback     *callback,
+                                  uint16_t             timeout = 0 )
+                                  XRD_WARN_UNUSED_RESULT;
+
       //------------------------------------------------------------------------
       //! Send info to the server (up to 1024 characters)- async
       //!
@@ -719,6 +854,14 @@ namespace XrdCl
                    ResponseHandler         *handler,
                    MessageSendParams       &params );
 
+      //------------------------------------------------------------------------
+      // Get the type flags of a list of paths in one go (kXR_statx), the
+      // response holds a Buffer with one StatInfo::Flags byte per path
+      //------------------------------------------------------------------------
+      XRootDStatus StatX( const std::vector<std::string> &paths,
+                          ResponseHandler                *handler,
+                          uint16_t                        timeout = 0 );
+
       //------------------------------------------------------------------------
       // Assign a load balancer if it has not already been assigned
       //------------------------------------------------------------------------
@@ -21,6 +21,7 @@
 
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdCl/XrdClTaskManager.hh"
+#include <set>
 
 namespace XrdCl
 {
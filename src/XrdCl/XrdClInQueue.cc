@@ -21,10 +21,56 @@
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
 #include "XrdCl/XrdClMessage.hh"
 
+#include <vector>
 #include <arpa/inet.h>              // for network unmarshalling stuff
 
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  InQueue::InQueue(): pTimers( ::time(0) )
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  InQueue::~InQueue()
+  {
+    HandlerMap::iterator it;
+    for( it = pHandlers.begin(); it != pHandlers.end(); ++it )
+      delete it->second;
+  }
+
+  //----------------------------------------------------------------------------
+  // Register the handler for the sid
+  //----------------------------------------------------------------------------
+  void InQueue::SetHandler( uint16_t            sid,
+                            IncomingMsgHandler *handler,
+                            time_t              expires )
+  {
+    HandlerEntry *&entry = pHandlers[sid];
+    if( !entry )
+      entry = new HandlerEntry( handler, expires, sid );
+    else
+    {
+      entry->handler = handler;
+      entry->expires = expires;
+    }
+    pTimers.Insert( entry, (uint64_t)( expires > 0 ? expires : 0 ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Unregister a handler
+  //----------------------------------------------------------------------------
+  void InQueue::EraseHandler( HandlerMap::iterator it )
+  {
+    pTimers.Cancel( it->second );
+    delete it->second;
+    pHandlers.erase( it );
+  }
+
   //----------------------------------------------------------------------------
   // Filter messages
   //----------------------------------------------------------------------------
@@ -79,11 +125,11 @@ namespace XrdCl
 
     if (it != pHandlers.end())
     {
-      handler = it->second.first;
+      handler = it->second->handler;
       action  = handler->Examine( msg );
 
       if( action & IncomingMsgHandler::RemoveHandler )
-	pHandlers.erase( it );
+	EraseHandler( it );
     }
 
     if( !(action & IncomingMsgHandler::Take) )
@@ -121,7 +167,7 @@ namespace XrdCl
     }
 
     if( !(action & IncomingMsgHandler::RemoveHandler) )
-      pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+      SetHandler( handlerSid, handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -147,12 +193,12 @@ namespace XrdCl
 
     if (it != pHandlers.end())
     {
-      handler = it->second.first;
+      handler = it->second->handler;
       act     = handler->Examine( msg );
-      exp     = it->second.second;
+      exp     = it->second->expires;
 
       if( act & IncomingMsgHandler::Take )
-	pHandlers.erase( it );
+	EraseHandler( it );
     }
 
     if( handler )
@@ -172,7 +218,7 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+    SetHandler( handlerSid, handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -182,7 +228,9 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers.erase(handlerSid);
+    HandlerMap::iterator it = pHandlers.find( handlerSid );
+    if( it != pHandlers.end() )
+      EraseHandler( it );
   }
 
   //----------------------------------------------------------------------------
@@ -196,10 +244,10 @@ namespace XrdCl
     XrdSysMutexHelper scopedLock( pMutex );
     for( HandlerMap::iterator it = pHandlers.begin(); it != pHandlers.end(); )
     {
-      action = it->second.first->OnStreamEvent( event, streamNum, status );
+      action = it->second->handler->OnStreamEvent( event, streamNum, status );
 
       if( action & IncomingMsgHandler::RemoveHandler )
-	pHandlers.erase( it++ );
+	EraseHandler( it++ );
       else
 	++it;
     }
@@ -214,17 +262,15 @@ namespace XrdCl
       now = ::time(0);
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.begin();
-    while( it != pHandlers.end() )
+    std::vector<TimerWheel::Timer*> expired;
+    pTimers.Advance( now, expired );
+    for( size_t i = 0; i < expired.size(); ++i )
     {
-      if( it->second.second <= now )
-      {
-	it->second.first->OnStreamEvent( IncomingMsgHandler::Timeout, 0,
-				  Status( stError, errOperationExpired ) );
-	pHandlers.erase( it++ );
-      }
-      else
-	++it;
+      HandlerEntry *entry = static_cast<HandlerEntry*>( expired[i] );
+      pHandlers.erase( entry->sid );
+      entry->handler->OnStreamEvent( IncomingMsgHandler::Timeout, 0,
+                                     Status( stError, errOperationExpired ) );
+      delete entry;
     }
   }
 }
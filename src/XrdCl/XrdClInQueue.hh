@@ -24,6 +24,7 @@
 #include <utility>
 #include "XrdCl/XrdClStatus.hh"
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
+#include "XrdCl/XrdClTimerWheel.hh"
 
 namespace XrdCl
 {
@@ -31,10 +32,23 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! A synchronize queue for incoming data
+  //!
+  //! The expiration times of the handlers are kept in a timer wheel, so
+  //! that timing them out does not require a scan of all of them
   //----------------------------------------------------------------------------
   class InQueue
   {
     public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      InQueue();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~InQueue();
+
       //------------------------------------------------------------------------
       //! Add a fully reconstructed message to the queue
       //------------------------------------------------------------------------
@@ -98,11 +112,36 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool DiscardMessage(Message* msg, uint16_t& sid) const;
 
-      typedef std::pair<IncomingMsgHandler *, time_t> HandlerAndExpire;
-      typedef std::map<uint16_t, HandlerAndExpire> HandlerMap;
+      //------------------------------------------------------------------------
+      // A registered handler and its expiration timer
+      //------------------------------------------------------------------------
+      struct HandlerEntry: public TimerWheel::Timer
+      {
+        HandlerEntry( IncomingMsgHandler *h, time_t e, uint16_t s ):
+          handler( h ), expires( e ), sid( s ) {}
+        IncomingMsgHandler *handler;
+        time_t              expires;
+        uint16_t            sid;
+      };
+
+      typedef std::map<uint16_t, HandlerEntry*> HandlerMap;
       typedef std::map<uint16_t, Message*> MessageMap;
+
+      //------------------------------------------------------------------------
+      //! Register the handler for the sid, replacing the previous one
+      //------------------------------------------------------------------------
+      void SetHandler( uint16_t            sid,
+                       IncomingMsgHandler *handler,
+                       time_t              expires );
+
+      //------------------------------------------------------------------------
+      //! Unregister a handler
+      //------------------------------------------------------------------------
+      void EraseHandler( HandlerMap::iterator it );
+
       MessageMap pMessages;
       HandlerMap pHandlers;
+      TimerWheel pTimers;   //!< ticks are seconds, like the deadlines
       XrdSysRecMutex pMutex;
   };
 }
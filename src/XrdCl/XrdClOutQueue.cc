@@ -29,7 +29,7 @@ namespace XrdCl
                            time_t                expires,
                            bool                  stateful )
   {
-    pMessages.push_back( MsgHelper( msg, handler, expires, stateful ) );
+    Append( MsgHelper( msg, handler, expires, stateful ) );
   }
 
   //----------------------------------------------------------------------------
@@ -40,6 +40,8 @@ namespace XrdCl
                             time_t                expires,
                             bool                  stateful )
   {
+    if( pMessages.empty() || expires < pMinExpires )
+      pMinExpires = expires;
     pMessages.push_front( MsgHelper( msg, handler, expires, stateful ) );
   }
 
@@ -98,17 +100,24 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void OutQueue::GrabExpired( OutQueue &queue, time_t exp )
   {
+    if( queue.pMessages.empty() || queue.pMinExpires > exp )
+      return;
+
     MessageList::iterator it;
+    time_t minExpires = 0;
     for( it = queue.pMessages.begin(); it != queue.pMessages.end(); )
     {
       if( it->expires > exp )
       {
+        if( !minExpires || it->expires < minExpires )
+          minExpires = it->expires;
         ++it;
         continue;
       }
-      pMessages.push_back( *it );
+      Append( *it );
       it = queue.pMessages.erase( it );
     }
+    queue.pMinExpires = minExpires;
   }
 
   //----------------------------------------------------------------------------
@@ -125,7 +134,7 @@ namespace XrdCl
         ++it;
         continue;
       }
-      pMessages.push_back( *it );
+      Append( *it );
       it = queue.pMessages.erase( it );
     }
   }
@@ -137,7 +146,7 @@ namespace XrdCl
   {
     MessageList::iterator it;
     for( it = queue.pMessages.begin(); it != queue.pMessages.end(); ++it )
-      pMessages.push_back( *it );
+      Append( *it );
     queue.pMessages.clear();
   }
 }
@@ -34,6 +34,11 @@ namespace XrdCl
   class OutQueue
   {
     public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      OutQueue(): pMinExpires( 0 ) {}
+
       //------------------------------------------------------------------------
       //! Add a message to the back the queue
       //!
@@ -108,7 +113,7 @@ namespace XrdCl
 
       //------------------------------------------------------------------------
       //! Remove all the expired messages from the queue and put them in
-      //! this one
+      //! this one, the queue is only scanned if it may hold any
       //!
       //! @param queue queue to take the message from
       //! @param exp   expiration timestamp
@@ -145,8 +150,20 @@ namespace XrdCl
         bool                  stateful;
       };
 
+      //------------------------------------------------------------------------
+      // Append a message and account for its expiration time
+      //------------------------------------------------------------------------
+      void Append( const MsgHelper &m )
+      {
+        if( pMessages.empty() || m.expires < pMinExpires )
+          pMinExpires = m.expires;
+        pMessages.push_back( m );
+      }
+
       typedef std::list<MsgHelper> MessageList;
       MessageList pMessages;
+      time_t      pMinExpires; //!< lower bound of the expiration times
+
   };
 }
 
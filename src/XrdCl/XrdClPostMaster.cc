@@ -25,6 +25,7 @@
 #include "XrdCl/XrdClPoller.hh"
 #include "XrdCl/XrdClTaskManager.hh"
 #include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClResolver.hh"
 #include "XrdCl/XrdClTransportManager.hh"
 #include "XrdCl/XrdClChannel.hh"
 #include "XrdCl/XrdClConstants.hh"
@@ -42,9 +43,12 @@ namespace XrdCl
     Env *env = DefaultEnv::GetEnv();
     int workerThreads = DefaultWorkerThreads;
     env->GetInt( "WorkerThreads", workerThreads );
+    int resolverThreads = DefaultResolverThreads;
+    env->GetInt( "ResolverThreads", resolverThreads );
 
     pTaskManager = new TaskManager();
     pJobManager  = new JobManager(workerThreads);
+    pResolver    = new Resolver(resolverThreads);
   }
 
   //----------------------------------------------------------------------------
@@ -55,6 +59,7 @@ namespace XrdCl
     delete pPoller;
     delete pTaskManager;
     delete pJobManager;
+    delete pResolver;
   }
 
   //----------------------------------------------------------------------------
@@ -130,6 +135,14 @@ namespace XrdCl
       return false;
     }
 
+    if( !pResolver->Start() )
+    {
+      pPoller->Stop();
+      pTaskManager->Stop();
+      pJobManager->Stop();
+      return false;
+    }
+
     return true;
   }
 
@@ -141,6 +154,8 @@ namespace XrdCl
     if( !pInitialized )
       return true;
 
+    if( !pResolver->Stop() )
+      return false;
     if( !pJobManager->Stop() )
       return false;
     if( !pTaskManager->Stop() )
@@ -229,6 +244,19 @@ namespace XrdCl
     return channel->Receive( handler, expires );
   }
 
+  //----------------------------------------------------------------------------
+  // Connect to the server in the background
+  //----------------------------------------------------------------------------
+  Status PostMaster::Preconnect( const URL &url )
+  {
+    Channel *channel = GetChannel( url );
+
+    if( !channel )
+      return Status( stError, errNotSupported );
+
+    return channel->Preconnect();
+  }
+
   //----------------------------------------------------------------------------
   // Query the transport handler
   //----------------------------------------------------------------------------
@@ -296,7 +324,8 @@ namespace XrdCl
         return 0;
       }
 
-      channel = new Channel( url, pPoller, trHandler, pTaskManager, pJobManager );
+      channel = new Channel( url, pPoller, trHandler, pTaskManager,
+                             pJobManager, pResolver );
       pChannelMap[url.GetHostId()] = channel;
     }
     else
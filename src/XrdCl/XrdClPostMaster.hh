@@ -35,6 +35,7 @@ namespace XrdCl
   class TaskManager;
   class Channel;
   class JobManager;
+  class Resolver;
 
   //----------------------------------------------------------------------------
   //! A hub for dispatching and receiving messages
@@ -150,6 +151,17 @@ namespace XrdCl
                       IncomingMsgHandler *handler,
                       time_t              expires );
 
+      //------------------------------------------------------------------------
+      //! Connect to the server in the background, so that the channel
+      //! is logged in and authenticated when the first message is sent
+      //! to it. Nothing is done if the channel is already connected.
+      //!
+      //! @param url the server to connect to
+      //! @return    status of the connection attempt, the failures that
+      //!            happen later on are not reported
+      //------------------------------------------------------------------------
+      Status Preconnect( const URL &url );
+
       //------------------------------------------------------------------------
       //! Query the transport handler for a given URL
       //!
@@ -201,6 +213,7 @@ namespace XrdCl
       XrdSysMutex       pChannelMapMutex;
       bool              pInitialized;
       JobManager       *pJobManager;
+      Resolver         *pResolver;
   };
 }
 
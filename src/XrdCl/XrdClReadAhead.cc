@@ -0,0 +1,598 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClReadAhead.hh"
+#include "XrdCl/XrdClFileStateHandler.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClResponseJob.hh"
+
+#include <sys/time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Upper bound of the prefetches in the fly for one file, so that a strided
+  // pattern of tiny reads does not flood the server
+  //----------------------------------------------------------------------------
+  const size_t MaxSegments = 256;
+
+  //----------------------------------------------------------------------------
+  // Wall clock in seconds
+  //----------------------------------------------------------------------------
+  double Now()
+  {
+    timeval tv;
+    gettimeofday( &tv, 0 );
+    return tv.tv_sec + tv.tv_usec / 1e6;
+  }
+
+  //----------------------------------------------------------------------------
+  // Per-process pool of read-ahead buffers. The total amount of memory held
+  // by the read-aheads of all the files, including the cached free buffers,
+  // never exceeds ReadAheadPoolSize.
+  //----------------------------------------------------------------------------
+  class BufferPool
+  {
+    public:
+      BufferPool(): pUsed( 0 ), pLimit( XrdCl::DefaultReadAheadPoolSize )
+      {
+        int limit = XrdCl::DefaultReadAheadPoolSize;
+        XrdCl::DefaultEnv::GetEnv()->GetInt( "ReadAheadPoolSize", limit );
+        if( limit > 0 ) pLimit = limit;
+      }
+
+      //------------------------------------------------------------------------
+      // Get a buffer, 0 if the pool is exhausted
+      //------------------------------------------------------------------------
+      char *Get( uint32_t size )
+      {
+        XrdSysMutexHelper scopedLock( pMutex );
+        for( size_t i = 0; i < pFree.size(); ++i )
+        {
+          if( pFree[i].first != size ) continue;
+          char *buffer = pFree[i].second;
+          pFree[i] = pFree.back();
+          pFree.pop_back();
+          return buffer;
+        }
+
+        //----------------------------------------------------------------------
+        // Make room by dropping the cached buffers of other sizes
+        //----------------------------------------------------------------------
+        while( pUsed + size > pLimit && !pFree.empty() )
+        {
+          pUsed -= pFree.back().first;
+          free( pFree.back().second );
+          pFree.pop_back();
+        }
+        if( pUsed + size > pLimit ) return 0;
+
+        char *buffer = (char*)malloc( size );
+        if( buffer ) pUsed += size;
+        return buffer;
+      }
+
+      //------------------------------------------------------------------------
+      // Give a buffer back
+      //------------------------------------------------------------------------
+      void Put( char *buffer, uint32_t size )
+      {
+        XrdSysMutexHelper scopedLock( pMutex );
+        pFree.push_back( std::make_pair( size, buffer ) );
+      }
+
+    private:
+      XrdSysMutex                                pMutex;
+      std::vector<std::pair<uint32_t, char*> >   pFree;
+      uint64_t                                   pUsed;
+      uint64_t                                   pLimit;
+  };
+
+  //----------------------------------------------------------------------------
+  // The pool lives as long as the process, prefetches may still come back
+  // while the static objects are being destroyed
+  //----------------------------------------------------------------------------
+  BufferPool *GetPool()
+  {
+    static BufferPool *pool = new BufferPool();
+    return pool;
+  }
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Handle the response to a prefetch
+  //----------------------------------------------------------------------------
+  class PrefetchHandler: public ResponseHandler
+  {
+    public:
+      PrefetchHandler( ReadAhead *ra, ReadAhead::Segment *seg ):
+        pReadAhead( ra ), pSegment( seg ) {}
+
+      virtual void HandleResponseWithHosts( XRootDStatus *status,
+                                            AnyObject    *response,
+                                            HostList     *hostList )
+      {
+        pReadAhead->OnPrefetch( pSegment, status, response, hostList );
+        delete this;
+      }
+
+    private:
+      ReadAhead          *pReadAhead;
+      ReadAhead::Segment *pSegment;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ReadAhead::ReadAhead( FileStateHandler *owner, uint32_t blockSize,
+                        uint32_t maxWindow ):
+    pOwner( owner ),
+    pRefs( 1 ),
+    pBlockSize( blockSize ),
+    pMaxWindow( maxWindow < 2 * blockSize ? 2 * blockSize : maxWindow ),
+    pWindow( 2 * blockSize ),
+    pAhead( 0 ),
+    pEOF( 0 ),
+    pPattern( None ),
+    pHits( 0 ),
+    pLastOffset( 0 ),
+    pLastSize( 0 ),
+    pStep( 0 ),
+    pNext( 0 ),
+    pMinLatency( 0 ),
+    pRate( 0 ),
+    pRateStart( 0 ),
+    pRateBytes( 0 )
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  ReadAhead::~ReadAhead()
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Account for a user read and try to serve it
+  //----------------------------------------------------------------------------
+  bool ReadAhead::Read( uint64_t         offset,
+                        uint32_t         size,
+                        void            *buffer,
+                        ResponseHandler *handler,
+                        uint16_t         timeout,
+                        uint64_t         fileSize )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( !pOwner || !size ) return false;
+    if( fileSize ) pEOF = fileSize;
+
+    //--------------------------------------------------------------------------
+    // Classify the read: sequential if it starts where the previous one
+    // ended, strided if it keeps the distance and the size of the previous
+    // one. Anything else throws away what has been read ahead.
+    //--------------------------------------------------------------------------
+    int64_t step = (int64_t)offset - (int64_t)pLastOffset;
+    if( pLastSize && offset == pLastOffset + pLastSize )
+    {
+      if( pPattern != Sequential ) pHits = 0;
+      pPattern = Sequential;
+      ++pHits;
+    }
+    else if( pLastSize && step > (int64_t)pLastSize && step == pStep &&
+             size == pLastSize )
+    {
+      if( pPattern != Strided ) pHits = 0;
+      pPattern = Strided;
+      ++pHits;
+    }
+    else
+    {
+      if( pPattern != None )
+      {
+        Log *log = DefaultEnv::GetLog();
+        log->Dump( FileMsg, "[0x%x] Read-ahead: pattern broken at %llu, "
+                   "dropping %llu bytes", this, (unsigned long long)offset,
+                   (unsigned long long)pAhead );
+        DropBefore( (uint64_t)-1 );
+        pWindow = 2 * pBlockSize;
+      }
+      pPattern = None;
+      pHits    = 0;
+    }
+    pStep       = step;
+    pLastOffset = offset;
+    pLastSize   = size;
+
+    //--------------------------------------------------------------------------
+    // Try to serve the read and forget what the consumer has passed
+    //--------------------------------------------------------------------------
+    bool served = Serve( offset, size, (char*)buffer, handler, timeout );
+    DropBefore( offset + size );
+
+    //--------------------------------------------------------------------------
+    // Keep the window full once the pattern is established
+    //--------------------------------------------------------------------------
+    if( pPattern != None && pHits >= 2 )
+    {
+      uint64_t minWindow = 2 * (uint64_t)std::max( pBlockSize, size );
+      if( pWindow < minWindow ) pWindow = minWindow;
+      uint64_t next = pPattern == Sequential ? offset + size : offset + pStep;
+      if( pNext < next || pNext > next + pWindow ) pNext = next;
+      Prefetch( size, timeout );
+    }
+
+    return served;
+  }
+
+  //----------------------------------------------------------------------------
+  // Serve the read from the segments, if they cover it entirely
+  //----------------------------------------------------------------------------
+  bool ReadAhead::Serve( uint64_t offset, uint32_t size, char *buffer,
+                         ResponseHandler *handler, uint16_t timeout )
+  {
+    if( !buffer || pSegments.empty() ) return false;
+
+    //--------------------------------------------------------------------------
+    // Find the segments covering [offset, offset+size)
+    //--------------------------------------------------------------------------
+    std::vector<Segment*> segs;
+    uint64_t end = offset + size;
+    uint64_t pos = offset;
+    SegmentMap::iterator it = pSegments.upper_bound( offset );
+    if( it == pSegments.begin() ) return false;
+    --it;
+    for( ; it != pSegments.end() && pos < end; ++it )
+    {
+      Segment *seg = it->second;
+      if( seg->offset > pos || seg->offset + seg->size <= pos ||
+          seg->state == Segment::Failed )
+        return false;
+      segs.push_back( seg );
+      if( seg->state == Segment::Done && seg->bytes < seg->size )
+      {
+        pos = end;  // end of file
+        break;
+      }
+      pos = seg->offset + seg->size;
+    }
+    if( pos < end ) return false;
+
+    //--------------------------------------------------------------------------
+    // Copy what is already there and wait for the rest
+    //--------------------------------------------------------------------------
+    Waiter *w   = new Waiter;
+    w->offset   = offset;
+    w->size     = size;
+    w->buffer   = buffer;
+    w->handler  = handler;
+    w->timeout  = timeout;
+    w->pending  = 0;
+    w->validEnd = end;
+    w->failed   = false;
+
+    for( size_t i = 0; i < segs.size(); ++i )
+    {
+      Segment *seg = segs[i];
+      if( seg->state == Segment::Pending )
+      {
+        seg->waiters.push_back( w );
+        ++w->pending;
+        continue;
+      }
+      uint64_t from = std::max( offset, seg->offset );
+      uint64_t to   = std::min( end, seg->offset + seg->bytes );
+      if( to > from )
+        memcpy( buffer + (from - offset), seg->buffer + (from - seg->offset),
+                to - from );
+      if( seg->bytes < seg->size && seg->offset + seg->bytes < w->validEnd )
+        w->validEnd = seg->offset + seg->bytes;
+    }
+
+    if( w->pending )
+    {
+      //------------------------------------------------------------------------
+      // The consumer caught up with the prefetches, the window is too small
+      //------------------------------------------------------------------------
+      if( pWindow < pMaxWindow )
+        pWindow = std::min( (uint64_t)pMaxWindow, 2 * pWindow );
+      return true;
+    }
+
+    uint32_t length = w->validEnd > offset ? w->validEnd - offset : 0;
+    JobManager *jobMan = DefaultEnv::GetPostMaster()->GetJobManager();
+    AnyObject *obj = new AnyObject();
+    obj->Set( new ChunkInfo( offset, length, buffer ) );
+    jobMan->QueueJob( new ResponseJob( handler, new XRootDStatus(), obj,
+                                       new HostList( pHosts ) ) );
+    delete w;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Issue prefetches until the window is full
+  //----------------------------------------------------------------------------
+  void ReadAhead::Prefetch( uint32_t size, uint16_t timeout )
+  {
+    while( pAhead < pWindow && pSegments.size() < MaxSegments )
+    {
+      if( pEOF && pNext >= pEOF ) break;
+
+      uint32_t len = size;
+      if( pPattern == Sequential ) len = std::max( pBlockSize, size );
+      if( pEOF && pNext + len > pEOF ) len = pEOF - pNext;
+
+      //------------------------------------------------------------------------
+      // Do not prefetch twice what is already there
+      //------------------------------------------------------------------------
+      SegmentMap::iterator it = pSegments.upper_bound( pNext );
+      if( it != pSegments.begin() )
+      {
+        --it;
+        if( it->second->offset + it->second->size > pNext )
+        {
+          pNext = pPattern == Sequential ?
+                  it->second->offset + it->second->size : pNext + pStep;
+          continue;
+        }
+        ++it;
+      }
+      if( it != pSegments.end() && it->first < pNext + len )
+        len = it->first - pNext;
+
+      char *buffer = GetPool()->Get( len );
+      if( !buffer ) break;
+
+      Segment *seg = new Segment;
+      seg->offset  = pNext;
+      seg->size    = len;
+      seg->bytes   = 0;
+      seg->buffer  = buffer;
+      seg->state   = Segment::Pending;
+      seg->orphan  = false;
+      seg->issued  = Now();
+
+      PrefetchHandler *handler = new PrefetchHandler( this, seg );
+      Status st = pOwner->SendPrefetch( seg->offset, len, buffer, handler,
+                                        timeout );
+      if( !st.IsOK() )
+      {
+        delete handler;
+        GetPool()->Put( buffer, len );
+        delete seg;
+        break;
+      }
+
+      ++pRefs;
+      pSegments[seg->offset] = seg;
+      pAhead += len;
+      pNext = pPattern == Sequential ? pNext + len : pNext + pStep;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Forget a segment, a pending one is freed when it comes back
+  //----------------------------------------------------------------------------
+  void ReadAhead::Release( SegmentMap::iterator it )
+  {
+    Segment *seg = it->second;
+    pAhead -= seg->size;
+    pSegments.erase( it );
+    if( seg->state == Segment::Pending )
+    {
+      seg->orphan = true;
+      return;
+    }
+    GetPool()->Put( seg->buffer, seg->size );
+    delete seg;
+  }
+
+  //----------------------------------------------------------------------------
+  // Release the segments ending before the given offset
+  //----------------------------------------------------------------------------
+  void ReadAhead::DropBefore( uint64_t offset )
+  {
+    SegmentMap::iterator it = pSegments.begin();
+    while( it != pSegments.end() && it->first < offset )
+    {
+      if( it->second->offset + it->second->size > offset &&
+          offset != (uint64_t)-1 )
+      {
+        ++it;
+        continue;
+      }
+      SegmentMap::iterator toGo = it++;
+      Release( toGo );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop everything
+  //----------------------------------------------------------------------------
+  void ReadAhead::Discard()
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    DropBefore( (uint64_t)-1 );
+    pPattern    = None;
+    pHits       = 0;
+    pLastSize   = 0;
+    pWindow     = 2 * pBlockSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Forget the owner
+  //----------------------------------------------------------------------------
+  void ReadAhead::Detach()
+  {
+    Discard();
+    pMutex.Lock();
+    pOwner = 0;
+    pMutex.UnLock();
+    UnRef();
+  }
+
+  //----------------------------------------------------------------------------
+  // Release a reference
+  //----------------------------------------------------------------------------
+  void ReadAhead::UnRef()
+  {
+    pMutex.Lock();
+    bool last = ( --pRefs == 0 );
+    pMutex.UnLock();
+    if( last ) delete this;
+  }
+
+  //----------------------------------------------------------------------------
+  // A prefetch came back
+  //----------------------------------------------------------------------------
+  void ReadAhead::OnPrefetch( Segment *seg, XRootDStatus *status,
+                              AnyObject *response, HostList *hostList )
+  {
+    std::vector<Waiter*> ready;
+    double now = Now();
+
+    pMutex.Lock();
+    if( status->IsOK() && response )
+    {
+      ChunkInfo *chunk = 0;
+      response->Get( chunk );
+      seg->bytes = chunk ? chunk->length : 0;
+      seg->state = Segment::Done;
+      if( seg->bytes < seg->size && ( !pEOF || seg->offset + seg->bytes < pEOF ) )
+        pEOF = seg->offset + seg->bytes;
+      if( hostList ) pHosts = *hostList;
+
+      //------------------------------------------------------------------------
+      // Estimate the bandwidth-delay product: the smallest latency seen
+      // times the delivery rate. As long as the window limits the transfer
+      // the measured product grows with it, so the window keeps doubling
+      // until the link, rather than the read-ahead, is the bottleneck.
+      //------------------------------------------------------------------------
+      double latency = now - seg->issued;
+      if( !pMinLatency || latency < pMinLatency ) pMinLatency = latency;
+      if( !pRateStart ) pRateStart = seg->issued;
+      pRateBytes += seg->bytes;
+      double elapsed = now - pRateStart;
+      if( elapsed > pMinLatency && elapsed > 0.01 )
+      {
+        double rate = pRateBytes / elapsed;
+        pRate = pRate ? 0.75 * pRate + 0.25 * rate : rate;
+        pRateStart = now;
+        pRateBytes = 0;
+
+        uint64_t bdp = (uint64_t)( 2 * pRate * pMinLatency );
+        if( bdp > pWindow && pWindow < pMaxWindow )
+        {
+          bdp = ( bdp + pBlockSize - 1 ) / pBlockSize * pBlockSize;
+          pWindow = std::min( bdp, (uint64_t)pMaxWindow );
+        }
+      }
+    }
+    else
+      seg->state = Segment::Failed;
+
+    std::list<Waiter*>::iterator it;
+    for( it = seg->waiters.begin(); it != seg->waiters.end(); ++it )
+    {
+      Waiter *w = *it;
+      if( seg->state == Segment::Failed )
+        w->failed = true;
+      else
+      {
+        uint64_t end  = w->offset + w->size;
+        uint64_t from = std::max( w->offset, seg->offset );
+        uint64_t to   = std::min( end, seg->offset + seg->bytes );
+        if( to > from )
+          memcpy( w->buffer + (from - w->offset),
+                  seg->buffer + (from - seg->offset), to - from );
+        if( seg->bytes < seg->size &&
+            seg->offset + seg->bytes < w->validEnd )
+          w->validEnd = seg->offset + seg->bytes;
+      }
+      if( --w->pending == 0 ) ready.push_back( w );
+    }
+    seg->waiters.clear();
+
+    if( seg->orphan || seg->state == Segment::Failed )
+    {
+      if( !seg->orphan )
+      {
+        pAhead -= seg->size;
+        pSegments.erase( seg->offset );
+      }
+      GetPool()->Put( seg->buffer, seg->size );
+      delete seg;
+    }
+    pMutex.UnLock();
+
+    delete status;
+    delete response;
+    delete hostList;
+
+    for( size_t i = 0; i < ready.size(); ++i )
+      Respond( ready[i] );
+    UnRef();
+  }
+
+  //----------------------------------------------------------------------------
+  // Call back a user read that waited for prefetches. The owner is still
+  // around: the user cannot close nor destroy the file with a read in the fly.
+  //----------------------------------------------------------------------------
+  void ReadAhead::Respond( Waiter *w )
+  {
+    if( w->failed )
+    {
+      pMutex.Lock();
+      FileStateHandler *owner = pOwner;
+      pMutex.UnLock();
+
+      XRootDStatus st( stError, errInvalidOp );
+      if( owner )
+        st = owner->ReRead( w->offset, w->size, w->buffer, w->handler,
+                            w->timeout );
+      if( !st.IsOK() )
+        w->handler->HandleResponseWithHosts( new XRootDStatus( st ), 0, 0 );
+      delete w;
+      return;
+    }
+
+    uint32_t length = w->validEnd > w->offset ? w->validEnd - w->offset : 0;
+    AnyObject *obj = new AnyObject();
+    obj->Set( new ChunkInfo( w->offset, length, w->buffer ) );
+    pMutex.Lock();
+    HostList *hosts = new HostList( pHosts );
+    pMutex.UnLock();
+    w->handler->HandleResponseWithHosts( new XRootDStatus(), obj, hosts );
+    delete w;
+  }
+}
@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_READ_AHEAD_HH__
+#define __XRD_CL_READ_AHEAD_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <stdint.h>
+#include <list>
+#include <map>
+
+namespace XrdCl
+{
+  class FileStateHandler;
+
+  //----------------------------------------------------------------------------
+  //! Adaptive read-ahead for a file opened in read-only mode
+  //!
+  //! The object watches the offsets of the reads issued by the user and,
+  //! once they follow a sequential or a strided pattern, keeps a window of
+  //! asynchronous reads in flight ahead of the consumer. The window starts
+  //! at two blocks (or two reads, if these are larger) and grows towards
+  //! twice the bandwidth-delay product measured on the completed prefetches,
+  //! bounded by ReadAheadMaxWindow.
+  //! The buffers come from a per-process pool bounded by ReadAheadPoolSize,
+  //! when the pool is exhausted the read-ahead simply stops growing.
+  //!
+  //! Prefetches are not stateful requests: they are not recovered and do
+  //! not hold the file open. A user read that waited on a failed prefetch
+  //! is re-issued through the regular, recoverable, path.
+  //----------------------------------------------------------------------------
+  class ReadAhead
+  {
+    friend class PrefetchHandler;
+
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param owner     the file state handler the prefetches are sent for
+      //! @param blockSize size of the sequential prefetch requests
+      //! @param maxWindow upper bound of the number of bytes read ahead
+      //------------------------------------------------------------------------
+      ReadAhead( FileStateHandler *owner, uint32_t blockSize,
+                 uint32_t maxWindow );
+
+      //------------------------------------------------------------------------
+      //! Account for a user read and try to serve it from the read-ahead
+      //! buffers, must be called with the owner's lock held
+      //!
+      //! @param fileSize size of the file if known, 0 otherwise
+      //! @return         true if the read has been taken over, the handler
+      //!                 will be called back, false if the caller needs to
+      //!                 send the read itself
+      //------------------------------------------------------------------------
+      bool Read( uint64_t         offset,
+                 uint32_t         size,
+                 void            *buffer,
+                 ResponseHandler *handler,
+                 uint16_t         timeout,
+                 uint64_t         fileSize );
+
+      //------------------------------------------------------------------------
+      //! Drop everything that has been read ahead, the prefetches still in
+      //! the fly release their buffers when they come back
+      //------------------------------------------------------------------------
+      void Discard();
+
+      //------------------------------------------------------------------------
+      //! Forget the owner and release its reference, the object goes away
+      //! when the last prefetch comes back
+      //------------------------------------------------------------------------
+      void Detach();
+
+    private:
+      ~ReadAhead();
+
+      //------------------------------------------------------------------------
+      // A user read waiting for prefetches to complete
+      //------------------------------------------------------------------------
+      struct Waiter
+      {
+        uint64_t         offset;
+        uint32_t         size;
+        char            *buffer;
+        ResponseHandler *handler;
+        uint16_t         timeout;
+        int              pending;
+        uint64_t         validEnd;
+        bool             failed;
+      };
+
+      //------------------------------------------------------------------------
+      // A prefetched chunk of the file
+      //------------------------------------------------------------------------
+      struct Segment
+      {
+        enum State { Pending, Done, Failed };
+        uint64_t           offset;
+        uint32_t           size;
+        uint32_t           bytes;
+        char              *buffer;
+        State              state;
+        bool               orphan;
+        double             issued;
+        std::list<Waiter*> waiters;
+      };
+      typedef std::map<uint64_t, Segment*> SegmentMap;
+
+      //------------------------------------------------------------------------
+      // Pattern of the user reads
+      //------------------------------------------------------------------------
+      enum Pattern { None, Sequential, Strided };
+
+      bool  Serve( uint64_t offset, uint32_t size, char *buffer,
+                   ResponseHandler *handler, uint16_t timeout );
+      void  Prefetch( uint32_t size, uint16_t timeout );
+      void  Release( SegmentMap::iterator it );
+      void  DropBefore( uint64_t offset );
+      void  OnPrefetch( Segment *seg, XRootDStatus *status,
+                        AnyObject *response, HostList *hostList );
+      void  Respond( Waiter *w );
+      void  UnRef();
+
+      XrdSysMutex       pMutex;
+      FileStateHandler *pOwner;
+      int               pRefs;
+      SegmentMap        pSegments;
+      HostList          pHosts;
+      uint32_t          pBlockSize;
+      uint32_t          pMaxWindow;
+      uint64_t          pWindow;
+      uint64_t          pAhead;
+      uint64_t          pEOF;
+
+      //------------------------------------------------------------------------
+      // Access pattern detection
+      //------------------------------------------------------------------------
+      Pattern           pPattern;
+      int               pHits;
+      uint64_t          pLastOffset;
+      uint32_t          pLastSize;
+      int64_t           pStep;
+      uint64_t          pNext;
+
+      //------------------------------------------------------------------------
+      // Bandwidth-delay product estimation
+      //------------------------------------------------------------------------
+      double            pMinLatency;
+      double            pRate;
+      double            pRateStart;
+      uint64_t          pRateBytes;
+  };
+}
+
+#endif // __XRD_CL_READ_AHEAD_HH__
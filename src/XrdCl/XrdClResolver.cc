@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+
+#include "XrdCl/XrdClResolver.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+
+#include <algorithm>
+#include <sstream>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  Resolver::Resolver( uint32_t workers ):
+    pWorkers( new JobManager( workers ) ),
+    pTTL( DefaultDNSCacheTTL ),
+    pCond( 0 )
+  {
+    pLookupJob = new LookupJob( this );
+    DefaultEnv::GetEnv()->GetInt( "DNSCacheTTL", pTTL );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  Resolver::~Resolver()
+  {
+    pWorkers->Finalize();
+    delete pWorkers;
+    delete pLookupJob;
+  }
+
+  //----------------------------------------------------------------------------
+  // Start the worker threads
+  //----------------------------------------------------------------------------
+  bool Resolver::Start()
+  {
+    return pWorkers->Start();
+  }
+
+  //----------------------------------------------------------------------------
+  // Stop the worker threads
+  //----------------------------------------------------------------------------
+  bool Resolver::Stop()
+  {
+    return pWorkers->Stop();
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the addresses of the host from the cache
+  //----------------------------------------------------------------------------
+  bool Resolver::GetCached( std::vector<XrdNetAddr> &addresses,
+                            const URL               &url,
+                            Utils::AddressType       type )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    CacheMap::iterator it = pCache.find( GetKey( url, type ) );
+    if( it == pCache.end() || it->second.expires <= ::time(0) )
+      return false;
+
+    addresses = it->second.addresses;
+    Utils::ShuffleHostAddresses( addresses );
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Resolve the host asynchronously
+  //----------------------------------------------------------------------------
+  void Resolver::ResolveAsync( const URL          &url,
+                               Utils::AddressType  type,
+                               Handler            *handler )
+  {
+    bool queue = false;
+    {
+      XrdSysCondVarHelper scopedLock( pCond );
+      std::string key = GetKey( url, type );
+      LookupMap::iterator it = pLookups.find( key );
+      if( it == pLookups.end() )
+      {
+        it = pLookups.insert( std::make_pair( key, Lookup( url, type ) ) ).first;
+        queue = true;
+      }
+      it->second.handlers.push_back( handler );
+    }
+
+    if( queue )
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Debug( UtilityMsg, "[%s] Resolving the host name asynchronously",
+                  url.GetHostId().c_str() );
+      pWorkers->QueueJob( pLookupJob );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Make sure that the handler is not going to be called anymore
+  //----------------------------------------------------------------------------
+  void Resolver::Cancel( Handler *handler )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    LookupMap::iterator it;
+    for( it = pLookups.begin(); it != pLookups.end(); ++it )
+      it->second.handlers.remove( handler );
+
+    while( std::find( pCalling.begin(), pCalling.end(), handler ) !=
+           pCalling.end() )
+      pCond.Wait();
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop the host from the cache
+  //----------------------------------------------------------------------------
+  void Resolver::Forget( const URL &url, Utils::AddressType type )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    pCache.erase( GetKey( url, type ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Cache key
+  //----------------------------------------------------------------------------
+  std::string Resolver::GetKey( const URL &url, Utils::AddressType type )
+  {
+    std::ostringstream o;
+    o << url.GetHostName() << ":" << url.GetPort() << "/" << type;
+    return o.str();
+  }
+
+  //----------------------------------------------------------------------------
+  // Run the lookup job
+  //----------------------------------------------------------------------------
+  void Resolver::LookupJob::Run( void * )
+  {
+    pResolver->Process();
+  }
+
+  //----------------------------------------------------------------------------
+  // Resolve the first host that nobody is working on and call the handlers
+  // waiting for it
+  //----------------------------------------------------------------------------
+  void Resolver::Process()
+  {
+    pCond.Lock();
+    LookupMap::iterator it;
+    for( it = pLookups.begin(); it != pLookups.end(); ++it )
+      if( !it->second.running )
+        break;
+
+    if( it == pLookups.end() )
+    {
+      pCond.UnLock();
+      return;
+    }
+
+    it->second.running = true;
+    std::string        key  = it->first;
+    URL                url  = it->second.url;
+    Utils::AddressType type = it->second.type;
+    pCond.UnLock();
+
+    std::vector<XrdNetAddr> addresses;
+    Status st = Utils::GetHostAddresses( addresses, url, type );
+
+    pCond.Lock();
+    time_t now = ::time(0);
+    if( st.IsOK() && pTTL > 0 )
+    {
+      //------------------------------------------------------------------------
+      // Make room for the new entry by dropping the expired ones
+      //------------------------------------------------------------------------
+      CacheMap::iterator cit = pCache.begin();
+      while( cit != pCache.end() )
+      {
+        if( cit->second.expires <= now )
+          pCache.erase( cit++ );
+        else
+          ++cit;
+      }
+
+      CacheEntry &entry = pCache[key];
+      entry.addresses = addresses;
+      entry.expires   = now + pTTL;
+    }
+
+    //--------------------------------------------------------------------------
+    // Call the handlers one by one, so that they can be cancelled until
+    // the very last moment, the ones that come in the meantime get the
+    // same answer
+    //--------------------------------------------------------------------------
+    it = pLookups.find( key );
+    while( !it->second.handlers.empty() )
+    {
+      Handler *handler = it->second.handlers.front();
+      it->second.handlers.pop_front();
+      pCalling.push_back( handler );
+      pCond.UnLock();
+
+      std::vector<XrdNetAddr> shuffled( addresses );
+      Utils::ShuffleHostAddresses( shuffled );
+      handler->HandleAddresses( st, shuffled );
+
+      pCond.Lock();
+      pCalling.erase( std::find( pCalling.begin(), pCalling.end(), handler ) );
+      pCond.Broadcast();
+      it = pLookups.find( key );
+    }
+    pLookups.erase( it );
+    pCond.UnLock();
+  }
+}
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_RESOLVER_HH__
+#define __XRD_CL_RESOLVER_HH__
+
+#include "XrdCl/XrdClStatus.hh"
+#include "XrdCl/XrdClURL.hh"
+#include "XrdCl/XrdClUtils.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdNet/XrdNetAddr.hh"
+
+#include <stdint.h>
+#include <ctime>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Host name resolver shared by all the channels
+  //!
+  //! The addresses are cached for DNSCacheTTL seconds. Host names that are
+  //! not in the cache are resolved by worker threads of the resolver, so
+  //! that a slow DNS does not hold up the caller, the concurrent requests
+  //! for the same host are served by a single lookup.
+  //----------------------------------------------------------------------------
+  class Resolver
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Interface for the receivers of the asynchronous lookups
+      //------------------------------------------------------------------------
+      class Handler
+      {
+        public:
+          virtual ~Handler() {}
+
+          //--------------------------------------------------------------------
+          //! Called by a resolver thread when the lookup is done, the
+          //! addresses are sorted and shuffled like the ones returned
+          //! by Utils::GetHostAddresses
+          //--------------------------------------------------------------------
+          virtual void HandleAddresses( const Status                  &status,
+                                        const std::vector<XrdNetAddr> &addresses ) = 0;
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param workers number of threads doing the lookups
+      //------------------------------------------------------------------------
+      Resolver( uint32_t workers );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~Resolver();
+
+      //------------------------------------------------------------------------
+      //! Start the worker threads
+      //------------------------------------------------------------------------
+      bool Start();
+
+      //------------------------------------------------------------------------
+      //! Stop the worker threads, the lookups in progress are abandoned
+      //------------------------------------------------------------------------
+      bool Stop();
+
+      //------------------------------------------------------------------------
+      //! Get the addresses of the host from the cache
+      //!
+      //! @return true if the host was cached and has not expired
+      //------------------------------------------------------------------------
+      bool GetCached( std::vector<XrdNetAddr> &addresses,
+                      const URL               &url,
+                      Utils::AddressType       type );
+
+      //------------------------------------------------------------------------
+      //! Resolve the host asynchronously, the handler is always called
+      //! by a resolver thread, never from within this call, so it is
+      //! safe to call it with locks held that the handler needs
+      //------------------------------------------------------------------------
+      void ResolveAsync( const URL          &url,
+                         Utils::AddressType  type,
+                         Handler            *handler );
+
+      //------------------------------------------------------------------------
+      //! Make sure that the handler is not going to be called anymore,
+      //! waits for it to return if it is being called right now
+      //------------------------------------------------------------------------
+      void Cancel( Handler *handler );
+
+      //------------------------------------------------------------------------
+      //! Drop the host from the cache, ie. because none of its addresses
+      //! could be connected to
+      //------------------------------------------------------------------------
+      void Forget( const URL &url, Utils::AddressType type );
+
+    private:
+      //------------------------------------------------------------------------
+      // Job doing a lookup
+      //------------------------------------------------------------------------
+      class LookupJob: public Job
+      {
+        public:
+          LookupJob( Resolver *resolver ): pResolver( resolver ) {}
+          virtual ~LookupJob() {}
+          virtual void Run( void *arg );
+        private:
+          Resolver *pResolver;
+      };
+
+      struct CacheEntry
+      {
+        CacheEntry(): expires( 0 ) {}
+        std::vector<XrdNetAddr> addresses;
+        time_t                  expires;
+      };
+
+      struct Lookup
+      {
+        Lookup( const URL &u = URL(), Utils::AddressType t = Utils::IPAll ):
+          url( u ), type( t ), running( false ) {}
+        URL                 url;
+        Utils::AddressType  type;
+        bool                running;
+        std::list<Handler*> handlers;
+      };
+
+      static std::string GetKey( const URL &url, Utils::AddressType type );
+      void Process();
+
+      typedef std::map<std::string, CacheEntry> CacheMap;
+      typedef std::map<std::string, Lookup>     LookupMap;
+
+      JobManager          *pWorkers;
+      LookupJob           *pLookupJob;
+      CacheMap             pCache;
+      LookupMap            pLookups;
+      std::list<Handler*>  pCalling;
+      int                  pTTL;
+      XrdSysCondVar        pCond;
+  };
+}
+
+#endif // __XRD_CL_RESOLVER_HH__
@@ -114,12 +114,14 @@ namespace XrdCl
     pPoller( 0 ),
     pTaskManager( 0 ),
     pJobManager( 0 ),
+    pResolver( 0 ),
     pIncomingQueue( 0 ),
     pChannelData( 0 ),
     pLastStreamError( 0 ),
     pConnectionCount( 0 ),
     pConnectionInitTime( 0 ),
     pAddressType( Utils::IPAll ),
+    pResolving( false ),
     pSessionId( 0 ),
     pQueueIncMsgJob(0),
     pBytesSent( 0 ),
@@ -127,6 +129,7 @@ namespace XrdCl
   {
     pConnectionStarted.tv_sec = 0; pConnectionStarted.tv_usec = 0;
     pConnectionDone.tv_sec = 0;    pConnectionDone.tv_usec = 0;
+    pResolveHandler = new ResolveHandler( this );
 
     std::ostringstream o;
     o << pUrl->GetHostId() << " #" << pStreamNum;
@@ -156,6 +159,10 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   Stream::~Stream()
   {
+    if( pResolver )
+      pResolver->Cancel( pResolveHandler );
+    delete pResolveHandler;
+
     Disconnect( true );
 
     Log *log = DefaultEnv::GetLog();
@@ -239,24 +246,58 @@ namespace XrdCl
     if( now-pLastStreamError < pStreamErrorWindow )
       return pLastFatalError;
 
+    //--------------------------------------------------------------------------
+    // The host name is still being resolved, the connection will be
+    // initiated when it's done
+    //--------------------------------------------------------------------------
+    if( pResolving )
+    {
+      pSubStreams[0]->status = Socket::Connecting;
+      return Status();
+    }
+
     gettimeofday( &pConnectionStarted, 0 );
     pConnectionInitTime = now;
     ++pConnectionCount;
 
     //--------------------------------------------------------------------------
-    // Resolve all the addresses of the host we're supposed to connect to
+    // Resolve all the addresses of the host we're supposed to connect to,
+    // if they are not cached the lookup is done by the resolver threads
+    // and we continue in OnResolved
     //--------------------------------------------------------------------------
-    Status st = Utils::GetHostAddresses( pAddresses, *pUrl, pAddressType );
-    if( !st.IsOK() )
+    if( pResolver )
     {
-      log->Error( PostMasterMsg, "[%s] Unable to resolve IP address for "
-                  "the host", pStreamName.c_str() );
-      pLastStreamError = now;
-      st.status        = stFatal;
-      pLastFatalError  = st;
-      return st;
+      if( !pResolver->GetCached( pAddresses, *pUrl, pAddressType ) )
+      {
+        pResolving = true;
+        pSubStreams[0]->status = Socket::Connecting;
+        pResolver->ResolveAsync( *pUrl, pAddressType, pResolveHandler );
+        return Status();
+      }
+    }
+    else
+    {
+      Status st = Utils::GetHostAddresses( pAddresses, *pUrl, pAddressType );
+      if( !st.IsOK() )
+      {
+        log->Error( PostMasterMsg, "[%s] Unable to resolve IP address for "
+                    "the host", pStreamName.c_str() );
+        pLastStreamError = now;
+        st.status        = stFatal;
+        pLastFatalError  = st;
+        return st;
+      }
     }
 
+    return ConnectResolved();
+  }
+
+  //----------------------------------------------------------------------------
+  // Start connecting the main stream to the resolved addresses
+  //----------------------------------------------------------------------------
+  Status Stream::ConnectResolved()
+  {
+    Log *log = DefaultEnv::GetLog();
     Utils::LogHostAddresses( log, PostMasterMsg, pUrl->GetHostId(),
                              pAddresses );
 
@@ -268,12 +309,48 @@ namespace XrdCl
     std::reverse( pAddresses.begin(), pAddresses.end() );
     pSubStreams[0]->socket->SetAddress( pAddresses.back() );
     pAddresses.pop_back();
-    st = pSubStreams[0]->socket->Connect( pConnectionWindow );
+    Status st = pSubStreams[0]->socket->Connect( pConnectionWindow );
     if( st.IsOK() )
       pSubStreams[0]->status = Socket::Connecting;
     return st;
   }
 
+  //----------------------------------------------------------------------------
+  // Call back when the host name has been resolved
+  //----------------------------------------------------------------------------
+  void Stream::OnResolved( const Status                  &status,
+                           const std::vector<XrdNetAddr> &addresses )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( !pResolving )
+      return;
+    pResolving = false;
+
+    //--------------------------------------------------------------------------
+    // The stream has been disconnected in the meantime
+    //--------------------------------------------------------------------------
+    if( pSubStreams[0]->status != Socket::Connecting )
+      return;
+
+    Status st = status;
+    if( st.IsOK() )
+    {
+      pAddresses = addresses;
+      st = ConnectResolved();
+      if( st.IsOK() )
+        return;
+    }
+    else
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Error( PostMasterMsg, "[%s] Unable to resolve IP address for "
+                  "the host", pStreamName.c_str() );
+    }
+
+    st.status = stFatal;
+    OnFatalError( 0, st, scopedLock );
+  }
+
   //----------------------------------------------------------------------------
   // Queue the message for sending
   //----------------------------------------------------------------------------
@@ -685,6 +762,13 @@ namespace XrdCl
       return;
     }
 
+    //--------------------------------------------------------------------------
+    // Make sure that the next attempt looks the host up again rather than
+    // reusing the cached addresses
+    //--------------------------------------------------------------------------
+    if( pResolver )
+      pResolver->Forget( *pUrl, pAddressType );
+
     //--------------------------------------------------------------------------
     // Check if we still have time to try and do something in the current window
     //--------------------------------------------------------------------------
@@ -27,6 +27,7 @@
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClInQueue.hh"
 #include "XrdCl/XrdClUtils.hh"
+#include "XrdCl/XrdClResolver.hh"
 
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdNet/XrdNetAddr.hh"
@@ -136,6 +137,14 @@ namespace XrdCl
         pJobManager = jobManager;
       }
 
+      //------------------------------------------------------------------------
+      //! Set the host name resolver
+      //------------------------------------------------------------------------
+      void SetResolver( Resolver *resolver )
+      {
+        pResolver = resolver;
+      }
+
       //------------------------------------------------------------------------
       //! Connect if needed, otherwise make sure that the underlying socket
       //! handler gets write readiness events, it will update the path with
@@ -293,6 +302,34 @@ namespace XrdCl
           IncomingMsgHandler *pHandler;
       };
 
+      //------------------------------------------------------------------------
+      // Receiver of the asynchronous host name lookups
+      //------------------------------------------------------------------------
+      class ResolveHandler: public Resolver::Handler
+      {
+        public:
+          ResolveHandler( Stream *stream ): pStream( stream ) {};
+          virtual ~ResolveHandler() {};
+          virtual void HandleAddresses( const Status                  &status,
+                                        const std::vector<XrdNetAddr> &addresses )
+          {
+            pStream->OnResolved( status, addresses );
+          }
+        private:
+          Stream *pStream;
+      };
+
+      //------------------------------------------------------------------------
+      //! Call back when the host name has been resolved
+      //------------------------------------------------------------------------
+      void OnResolved( const Status                  &status,
+                       const std::vector<XrdNetAddr> &addresses );
+
+      //------------------------------------------------------------------------
+      //! Start connecting the main stream to the resolved addresses
+      //------------------------------------------------------------------------
+      Status ConnectResolved();
+
       //------------------------------------------------------------------------
       //! On fatal error - unlocks the stream
       //------------------------------------------------------------------------
@@ -322,6 +359,7 @@ namespace XrdCl
       Poller                        *pPoller;
       TaskManager                   *pTaskManager;
       JobManager                    *pJobManager;
+      Resolver                      *pResolver;
       XrdSysRecMutex                 pMutex;
       InQueue                       *pIncomingQueue;
       AnyObject                     *pChannelData;
@@ -335,6 +373,7 @@ namespace XrdCl
       SubStreamList                  pSubStreams;
       std::vector<XrdNetAddr>        pAddresses;
       Utils::AddressType             pAddressType;
+      bool                           pResolving;
       ChannelHandlerList             pChannelEvHandlers;
       uint64_t                       pSessionId;
 
@@ -342,6 +381,7 @@ namespace XrdCl
       // Jobs
       //------------------------------------------------------------------------
       QueueIncMsgJob                *pQueueIncMsgJob;
+      ResolveHandler                *pResolveHandler;
 
       //------------------------------------------------------------------------
       // Monitoring info
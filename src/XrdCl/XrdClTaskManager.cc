@@ -24,6 +24,8 @@
 #include "XrdSys/XrdSysTimer.hh"
 
 #include <iostream>
+#include <vector>
+#include <sys/time.h>
 
 //------------------------------------------------------------------------------
 // The thread
@@ -39,23 +41,47 @@ extern "C"
   }
 }
 
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Current time in milliseconds
+  //----------------------------------------------------------------------------
+  uint64_t NowMs()
+  {
+    timeval tv;
+    gettimeofday( &tv, 0 );
+    return (uint64_t)tv.tv_sec*1000 + tv.tv_usec/1000;
+  }
+}
+
 namespace XrdCl
 {
   //----------------------------------------------------------------------------
   // Constructor
   //----------------------------------------------------------------------------
-  TaskManager::TaskManager(): pResolution(1), pRunnerThread(0), pRunning(false)
-  {}
+  TaskManager::TaskManager(): pResolution(1000), pWheel(0), pRunnerThread(0),
+    pRunning(false)
+  {
+    int resolution = DefaultTimerResolution;
+    DefaultEnv::GetEnv()->GetInt( "TimerResolution", resolution );
+    if( resolution > 0 )
+      pResolution = resolution;
+    pWheel = new TimerWheel( NowMs() / pResolution );
+  }
 
   //----------------------------------------------------------------------------
   // Destructor
   //----------------------------------------------------------------------------
   TaskManager::~TaskManager()
   {
-    TaskSet::iterator  it, itE;
+    TaskMap::iterator it;
     for( it = pTasks.begin(); it != pTasks.end(); ++it )
-      if( it->own )
-        delete it->task;
+    {
+      if( it->second->own )
+        delete it->second->task;
+      delete it->second;
+    }
+    delete pWheel;
   }
 
   //----------------------------------------------------------------------------
@@ -124,14 +150,25 @@ namespace XrdCl
   // Run the given task at the given time
   //----------------------------------------------------------------------------
   void TaskManager::RegisterTask( Task *task, time_t time, bool own )
+  {
+    RegisterTaskMs( task, (uint64_t)time*1000, own );
+  }
+
+  //----------------------------------------------------------------------------
+  // Run the given task at the given time in milliseconds
+  //----------------------------------------------------------------------------
+  void TaskManager::RegisterTaskMs( Task *task, uint64_t time, bool own )
   {
     Log *log = DefaultEnv::GetLog();
 
     log->Debug( TaskMgrMsg, "Registering task: \"%s\" to be run at: [%s]",
-                task->GetName().c_str(), Utils::TimeToString(time).c_str() );
+                task->GetName().c_str(),
+                Utils::TimeToString(time/1000).c_str() );
 
+    TaskHelper *helper = new TaskHelper( task, own );
     XrdSysMutexHelper scopedLock( pMutex );
-    pTasks.insert( TaskHelper( task, time, own ) );
+    pTasks.insert( std::make_pair( task, helper ) );
+    pWheel->Insert( helper, ToTicks( time ) );
   }
 
   //--------------------------------------------------------------------------
@@ -165,75 +202,72 @@ namespace XrdCl
       pMutex.Lock();
 
       //------------------------------------------------------------------------
-      // Remove the tasks from the active set - super inefficient,
-      // but, hopefully, never really necessary. We first need to build a list
-      // of iterators because it is impossible to remove elements from
-      // a multiset when iterating over it
+      // Remove the tasks from the wheel
       //------------------------------------------------------------------------
       TaskList::iterator listIt = pToBeUnregistered.begin();
-      TaskSet::iterator  it, itE;
-      std::list<TaskSet::iterator> iteratorList;
-      std::list<TaskSet::iterator>::iterator itRem;
       for( ; listIt != pToBeUnregistered.end(); ++listIt )
       {
-        for( it = pTasks.begin(); it != pTasks.end(); ++it )
+        std::pair<TaskMap::iterator, TaskMap::iterator> range;
+        range = pTasks.equal_range( *listIt );
+        for( TaskMap::iterator it = range.first; it != range.second; ++it )
         {
-          if( it->task == *listIt )
-            iteratorList.push_back( it );
+          TaskHelper *helper = it->second;
+          log->Debug( TaskMgrMsg, "Removing task: \"%s\"",
+                      helper->task->GetName().c_str() );
+          pWheel->Cancel( helper );
+          if( helper->own )
+            delete helper->task;
+          delete helper;
         }
-      }
-
-      for( itRem = iteratorList.begin(); itRem != iteratorList.end(); ++itRem )
-      {
-        Task *tsk = (*itRem)->task;
-        bool  own = (*itRem)->own;
-        log->Debug( TaskMgrMsg, "Removing task: \"%s\"", tsk->GetName().c_str() );
-        pTasks.erase( *itRem );
-        if( own )
-          delete tsk;
+        pTasks.erase( range.first, range.second );
       }
 
       pToBeUnregistered.clear();
 
       //------------------------------------------------------------------------
-      // Select the tasks to be run
+      // Select the tasks to be run, they stay in the task map so that
+      // they can be unregistered
       //------------------------------------------------------------------------
-      time_t                          now = time(0);
-      std::list<TaskHelper>           toRun;
-      std::list<TaskHelper>::iterator trIt;
-
-      it  = pTasks.begin();
-      itE = pTasks.upper_bound( TaskHelper( 0, now ) );
-
-      for( ; it != itE; ++it )
-        toRun.push_back( TaskHelper( it->task, 0, it->own ) );
-
-      pTasks.erase( pTasks.begin(), itE );
+      uint64_t                          now = NowMs();
+      std::vector<TimerWheel::Timer*>   toRun;
+      pWheel->Advance( now / pResolution, toRun );
       pMutex.UnLock();
 
       //------------------------------------------------------------------------
       // Run the tasks and reinsert them if necessary
       //------------------------------------------------------------------------
-      for( trIt = toRun.begin(); trIt != toRun.end(); ++trIt )
+      for( size_t i = 0; i < toRun.size(); ++i )
       {
+        TaskHelper *helper = static_cast<TaskHelper*>( toRun[i] );
         log->Dump( TaskMgrMsg, "Running task: \"%s\"",
-                   trIt->task->GetName().c_str() );
-        time_t schedule = trIt->task->Run( now );
+                   helper->task->GetName().c_str() );
+        uint64_t schedule = helper->task->RunMs( now );
         if( schedule )
         {
           log->Dump( TaskMgrMsg, "Will rerun task \"%s\" at [%s]",
-                     trIt->task->GetName().c_str(),
-                     Utils::TimeToString(schedule).c_str() );
+                     helper->task->GetName().c_str(),
+                     Utils::TimeToString(schedule/1000).c_str() );
           pMutex.Lock();
-          pTasks.insert( TaskHelper( trIt->task, schedule, trIt->own ) );
+          pWheel->Insert( helper, ToTicks( schedule ) );
           pMutex.UnLock();
         }
         else
         {
           log->Debug( TaskMgrMsg, "Done with task: \"%s\"",
-                      trIt->task->GetName().c_str() );
-          if( trIt->own )
-            delete trIt->task;
+                      helper->task->GetName().c_str() );
+          pMutex.Lock();
+          std::pair<TaskMap::iterator, TaskMap::iterator> range;
+          range = pTasks.equal_range( helper->task );
+          for( TaskMap::iterator it = range.first; it != range.second; ++it )
+            if( it->second == helper )
+            {
+              pTasks.erase( it );
+              break;
+            }
+          pMutex.UnLock();
+          if( helper->own )
+            delete helper->task;
+          delete helper;
         }
       }
 
@@ -241,7 +275,7 @@ namespace XrdCl
       // Enable the cancelation and go to sleep
       //------------------------------------------------------------------------
       pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, 0 );
-      XrdSysTimer::Wait( pResolution*1000 );
+      XrdSysTimer::Wait( pResolution );
     }
   }
 }
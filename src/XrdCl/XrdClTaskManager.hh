@@ -20,12 +20,13 @@
 #define __XRD_CL_TASK_MANAGER_HH__
 
 #include <ctime>
-#include <set>
+#include <map>
 #include <list>
 #include <string>
 #include <stdint.h>
 #include <pthread.h>
 #include "XrdSys/XrdSysPthread.hh"
+#include "XrdCl/XrdClTimerWheel.hh"
 
 namespace XrdCl
 {
@@ -46,6 +47,19 @@ namespace XrdCl
       //------------------------------------------------------------------------
       virtual time_t Run( time_t now ) = 0;
 
+      //------------------------------------------------------------------------
+      //! Perform the task, millisecond version, by default calls Run
+      //!
+      //! @param now current timestamp in milliseconds
+      //! @return 0 if the task is completed and should no longer be run or
+      //!         the time, in milliseconds, at which it should be run again
+      //------------------------------------------------------------------------
+      virtual uint64_t RunMs( uint64_t now )
+      {
+        time_t next = Run( now/1000 );
+        return next ? (uint64_t)next*1000 : 0;
+      }
+
       //------------------------------------------------------------------------
       //! Name of the task
       //------------------------------------------------------------------------
@@ -70,7 +84,8 @@ namespace XrdCl
   //! Run short tasks at a given time in the future
   //!
   //! The task manager just runs one extra thread so the execution of one tasks
-  //! may interfere with the execution of another
+  //! may interfere with the execution of another. The tasks are kept in
+  //! a timer wheel turning every TimerResolution milliseconds.
   //----------------------------------------------------------------------------
   class TaskManager
   {
@@ -107,6 +122,16 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void RegisterTask( Task *task, time_t time, bool own = true );
 
+      //------------------------------------------------------------------------
+      //! Run the given task at the given time in milliseconds
+      //!
+      //! @param task task to be run
+      //! @param time time, in milliseconds, at which the task should be run
+      //! @param own  determines whether the task object should be destroyed
+      //!             when no longer needed
+      //------------------------------------------------------------------------
+      void RegisterTaskMs( Task *task, uint64_t time, bool own = true );
+
       //------------------------------------------------------------------------
       //! Remove a task, the unregistration process is asynchronous and may
       //! be performed at any point in the future, the function just queues
@@ -123,33 +148,33 @@ namespace XrdCl
     private:
 
       //------------------------------------------------------------------------
-      // Task set helpers
+      // Task helpers
       //------------------------------------------------------------------------
-      struct TaskHelper
+      struct TaskHelper: public TimerWheel::Timer
       {
-        TaskHelper( Task *tsk, time_t tme, bool ow = true ):
-          task(tsk), execTime(tme), own(ow) {}
-        Task   *task;
-        time_t  execTime;
-        bool    own;
+        TaskHelper( Task *tsk, bool ow = true ): task(tsk), own(ow) {}
+        Task *task;
+        bool  own;
       };
 
-      struct TaskHelperCmp
-      {
-        bool operator () ( const TaskHelper &th1, const TaskHelper &th2 ) const
-        {
-          return th1.execTime < th2.execTime;
-        }
-      };
+      typedef std::multimap<Task*, TaskHelper*> TaskMap;
+      typedef std::list<Task*>                  TaskList;
 
-      typedef std::multiset<TaskHelper, TaskHelperCmp> TaskSet;
-      typedef std::list<Task*>                         TaskList;
+      //------------------------------------------------------------------------
+      // Convert milliseconds to wheel ticks, rounding up so that nothing
+      // runs early
+      //------------------------------------------------------------------------
+      uint64_t ToTicks( uint64_t time ) const
+      {
+        return ( time + pResolution - 1 ) / pResolution;
+      }
 
       //------------------------------------------------------------------------
       // Private variables
       //------------------------------------------------------------------------
-      uint16_t    pResolution;
-      TaskSet     pTasks;
+      uint32_t    pResolution;
+      TimerWheel *pWheel;
+      TaskMap     pTasks;
       TaskList    pToBeUnregistered;
       pthread_t   pRunnerThread;
       bool        pRunning;
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClTimerWheel.hh"
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  TimerWheel::TimerWheel( uint64_t now ): pNow( now ), pSize( 0 )
+  {
+    for( int l = 0; l < Levels; ++l )
+    {
+      for( uint32_t s = 0; s < Slots; ++s )
+        pSlots[l][s].pPrev = pSlots[l][s].pNext = &pSlots[l][s];
+      pCount[l] = 0;
+    }
+    pDue.pPrev = pDue.pNext = &pDue;
+  }
+
+  //----------------------------------------------------------------------------
+  // Arm a timer
+  //----------------------------------------------------------------------------
+  void TimerWheel::Insert( Timer *timer, uint64_t expires )
+  {
+    if( timer->IsArmed() )
+      Unlink( timer );
+    else
+      ++pSize;
+    timer->pExpires = expires;
+    Place( timer );
+  }
+
+  //----------------------------------------------------------------------------
+  // Disarm a timer
+  //----------------------------------------------------------------------------
+  void TimerWheel::Cancel( Timer *timer )
+  {
+    if( !timer->IsArmed() )
+      return;
+    Unlink( timer );
+    --pSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Move the clock forward
+  //----------------------------------------------------------------------------
+  void TimerWheel::Advance( uint64_t now, std::vector<Timer*> &expired )
+  {
+    Collect( pDue, expired );
+
+    while( pNow < now )
+    {
+      //------------------------------------------------------------------------
+      // Nothing to look at, just jump
+      //------------------------------------------------------------------------
+      if( !pSize )
+      {
+        pNow = now;
+        break;
+      }
+
+      //------------------------------------------------------------------------
+      // Nothing happens before the next turn of the lowest populated level
+      //------------------------------------------------------------------------
+      int low = 0;
+      while( low < Levels-1 && !pCount[low] ) ++low;
+      if( low )
+      {
+        uint64_t next = ( ( pNow >> ( Bits*low ) ) + 1 ) << ( Bits*low );
+        if( next > now )
+        {
+          pNow = now;
+          break;
+        }
+        pNow = next - 1;
+      }
+
+      ++pNow;
+      for( int l = 1; l < Levels; ++l )
+      {
+        if( ( pNow >> ( Bits*l ) ) << ( Bits*l ) != pNow )
+          break;
+        Cascade( l );
+      }
+      Collect( pSlots[0][pNow & Mask], expired );
+      Collect( pDue, expired );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Put the timer in the slot it belongs to
+  //----------------------------------------------------------------------------
+  void TimerWheel::Place( Timer *timer )
+  {
+    if( timer->pExpires <= pNow )
+    {
+      Link( pDue, timer, -1 );
+      return;
+    }
+
+    uint64_t delta = timer->pExpires - pNow;
+    for( int l = 0; l < Levels; ++l )
+    {
+      if( delta >> ( Bits*(l+1) ) == 0 )
+      {
+        Link( pSlots[l][( timer->pExpires >> ( Bits*l ) ) & Mask], timer, l );
+        return;
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    // Out of range, park it in the farthest top level slot
+    //--------------------------------------------------------------------------
+    uint64_t far = pNow + ( ( (uint64_t)1 << ( Bits*Levels ) ) - 1 );
+    Link( pSlots[Levels-1][( far >> ( Bits*(Levels-1) ) ) & Mask], timer,
+          Levels-1 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Move the timers of the current slot of a level down, the ones that
+  // expire right now land in the due list
+  //----------------------------------------------------------------------------
+  void TimerWheel::Cascade( int level )
+  {
+    Timer &head = pSlots[level][( pNow >> ( Bits*level ) ) & Mask];
+    while( head.pNext != &head )
+    {
+      Timer *timer = head.pNext;
+      Unlink( timer );
+      Place( timer );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Disarm all the timers of a slot
+  //----------------------------------------------------------------------------
+  void TimerWheel::Collect( Timer &head, std::vector<Timer*> &expired )
+  {
+    while( head.pNext != &head )
+    {
+      Timer *timer = head.pNext;
+      Unlink( timer );
+      --pSize;
+      expired.push_back( timer );
+    }
+  }
+}
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_TIMER_WHEEL_HH__
+#define __XRD_CL_TIMER_WHEEL_HH__
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Hierarchical timing wheel
+  //!
+  //! Four levels of 256 slots cover 2^32 ticks, the unit of a tick is up to
+  //! the user. Timers are intrusive, so inserting and cancelling them costs
+  //! O(1), advancing the clock costs one step per elapsed tick of the lowest
+  //! populated level plus the timers that move down a level or expire.
+  //! Timers further away than the wheel range are parked in the top level
+  //! and re-examined as it turns.
+  //!
+  //! The wheel is not synchronized, the owner needs to lock it.
+  //----------------------------------------------------------------------------
+  class TimerWheel
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! A timer, meant to be inherited by the objects to be expired
+      //------------------------------------------------------------------------
+      class Timer
+      {
+        friend class TimerWheel;
+        public:
+          Timer(): pPrev( 0 ), pNext( 0 ), pExpires( 0 ), pLevel( 0 ) {}
+
+          //--------------------------------------------------------------------
+          //! True if the timer is in a wheel
+          //--------------------------------------------------------------------
+          bool IsArmed() const
+          {
+            return pPrev != 0;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the expiration tick
+          //--------------------------------------------------------------------
+          uint64_t GetExpires() const
+          {
+            return pExpires;
+          }
+
+        private:
+          Timer( const Timer & );
+          Timer &operator = ( const Timer & );
+
+          Timer    *pPrev;
+          Timer    *pNext;
+          uint64_t  pExpires;
+          int       pLevel;
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param now the current tick
+      //------------------------------------------------------------------------
+      TimerWheel( uint64_t now );
+
+      //------------------------------------------------------------------------
+      //! Arm a timer, re-arm it if it is already in the wheel. A timer that
+      //! is already due expires on the next call to Advance.
+      //------------------------------------------------------------------------
+      void Insert( Timer *timer, uint64_t expires );
+
+      //------------------------------------------------------------------------
+      //! Disarm a timer, does nothing if it is not armed
+      //------------------------------------------------------------------------
+      void Cancel( Timer *timer );
+
+      //------------------------------------------------------------------------
+      //! Move the clock to now and disarm the timers that expired
+      //!
+      //! @param now     the current tick
+      //! @param expired the expired timers are appended here
+      //------------------------------------------------------------------------
+      void Advance( uint64_t now, std::vector<Timer*> &expired );
+
+      //------------------------------------------------------------------------
+      //! Get the number of armed timers
+      //------------------------------------------------------------------------
+      size_t GetSize() const
+      {
+        return pSize;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the current tick
+      //------------------------------------------------------------------------
+      uint64_t GetNow() const
+      {
+        return pNow;
+      }
+
+    private:
+      TimerWheel( const TimerWheel & );
+      TimerWheel &operator = ( const TimerWheel & );
+
+      static const int      Levels = 4;
+      static const int      Bits   = 8;
+      static const uint32_t Slots  = 1 << Bits;
+      static const uint32_t Mask   = Slots - 1;
+
+      void Place( Timer *timer );
+      void Cascade( int level );
+      void Collect( Timer &head, std::vector<Timer*> &expired );
+
+      void Link( Timer &head, Timer *timer, int level )
+      {
+        timer->pPrev        = head.pPrev;
+        timer->pNext        = &head;
+        timer->pLevel       = level;
+        head.pPrev->pNext   = timer;
+        head.pPrev          = timer;
+        if( level >= 0 ) ++pCount[level];
+      }
+
+      void Unlink( Timer *timer )
+      {
+        timer->pPrev->pNext = timer->pNext;
+        timer->pNext->pPrev = timer->pPrev;
+        timer->pPrev        = 0;
+        timer->pNext        = 0;
+        if( timer->pLevel >= 0 ) --pCount[timer->pLevel];
+      }
+
+      Timer    pSlots[Levels][Slots];
+      size_t   pCount[Levels];
+      Timer    pDue;
+      uint64_t pNow;
+      size_t   pSize;
+  };
+}
+
+#endif // __XRD_CL_TIMER_WHEEL_HH__
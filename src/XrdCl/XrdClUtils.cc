@@ -168,12 +168,17 @@ namespace XrdCl
       addresses.push_back( addrs[i] );
     delete [] addrs;
 
-    //--------------------------------------------------------------------------
-    // Sort and shuffle them
-    //--------------------------------------------------------------------------
+    ShuffleHostAddresses( addresses );
+    return Status();
+  }
+
+  //----------------------------------------------------------------------------
+  // Shuffle the addresses and put the IPv6 ones first
+  //----------------------------------------------------------------------------
+  void Utils::ShuffleHostAddresses( std::vector<XrdNetAddr> &addresses )
+  {
     std::random_shuffle( addresses.begin(), addresses.end() );
     std::sort( addresses.begin(), addresses.end(), PreferIPv6() );
-    return Status();
   }
 
   //----------------------------------------------------------------------------
@@ -105,6 +105,11 @@ namespace XrdCl
                                       const URL               &url,
                                       AddressType              type );
 
+      //------------------------------------------------------------------------
+      //! Shuffle the addresses and put the IPv6 ones first
+      //------------------------------------------------------------------------
+      static void ShuffleHostAddresses( std::vector<XrdNetAddr> &addresses );
+
       //------------------------------------------------------------------------
       //! Log all the addresses on the list
       //------------------------------------------------------------------------
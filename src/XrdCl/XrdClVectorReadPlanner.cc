@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClVectorReadPlanner.hh"
+#include "XProtocol/XProtocol.hh"
+
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Order the chunk indices by offset, then by length
+  //----------------------------------------------------------------------------
+  struct ByOffset
+  {
+    ByOffset( const XrdCl::ChunkList &c ): chunks( c ) {}
+    bool operator()( uint32_t a, uint32_t b ) const
+    {
+      if( chunks[a].offset != chunks[b].offset )
+        return chunks[a].offset < chunks[b].offset;
+      return chunks[a].length < chunks[b].length;
+    }
+    const XrdCl::ChunkList &chunks;
+  };
+
+  //----------------------------------------------------------------------------
+  // Handle the response to one request of a plan
+  //----------------------------------------------------------------------------
+  class PartHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      PartHandler( XrdCl::VectorReadCollector *collector, uint32_t expected ):
+        pCollector( collector ), pExpected( expected ) {}
+
+      virtual void HandleResponseWithHosts( XrdCl::XRootDStatus *status,
+                                            XrdCl::AnyObject    *response,
+                                            XrdCl::HostList     *hostList )
+      {
+        pCollector->Done( status, response, hostList, pExpected );
+        delete this;
+      }
+
+    private:
+      XrdCl::VectorReadCollector *pCollector;
+      uint32_t                    pExpected;
+  };
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  VectorReadPlanner::VectorReadPlanner( const ChunkList &chunks,
+                                        void            *buffer,
+                                        uint32_t         maxGap,
+                                        uint32_t         maxChunks,
+                                        uint32_t         maxChunkSize ):
+    pTrivial( false )
+  {
+    //--------------------------------------------------------------------------
+    // Work out where each chunk goes
+    //--------------------------------------------------------------------------
+    char *cursor = (char*)buffer;
+    for( size_t i = 0; i < chunks.size(); ++i )
+    {
+      void *chunkBuffer = chunks[i].buffer;
+      if( cursor )
+      {
+        chunkBuffer  = cursor;
+        cursor      += chunks[i].length;
+      }
+      pChunks.push_back( ChunkInfo( chunks[i].offset, chunks[i].length,
+                                    chunkBuffer ) );
+    }
+
+    std::vector<uint32_t> order( pChunks.size() );
+    for( uint32_t i = 0; i < order.size(); ++i ) order[i] = i;
+    std::sort( order.begin(), order.end(), ByOffset( pChunks ) );
+
+    //--------------------------------------------------------------------------
+    // Merge the overlapping and the close enough chunks
+    //--------------------------------------------------------------------------
+    for( size_t i = 0; i < order.size(); ++i )
+    {
+      const ChunkInfo &ch = pChunks[order[i]];
+      if( !pSegments.empty() )
+      {
+        Segment  &seg = pSegments.back();
+        uint64_t  end = seg.offset + seg.length;
+        if( ch.offset <= end + maxGap &&
+            std::max( end, ch.offset + ch.length ) - seg.offset <= 0x7fffffff )
+        {
+          if( ch.offset + ch.length > end )
+            seg.length = ch.offset + ch.length - seg.offset;
+          seg.members.push_back( order[i] );
+          continue;
+        }
+      }
+      Segment seg;
+      seg.offset  = ch.offset;
+      seg.length  = ch.length;
+      seg.buffer  = 0;
+      seg.scratch = false;
+      seg.members.push_back( order[i] );
+      pSegments.push_back( seg );
+    }
+
+    //--------------------------------------------------------------------------
+    // Nothing to gain, send the list as it is
+    //--------------------------------------------------------------------------
+    if( pSegments.size() == pChunks.size() && pChunks.size() <= maxChunks )
+    {
+      pTrivial = true;
+      for( size_t i = 0; i < pChunks.size(); ++i )
+        if( pChunks[i].length > maxChunkSize )
+        {
+          pTrivial = false;
+          break;
+        }
+      if( pTrivial ) return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Give the segments their buffers: single chunk segments go directly
+    // into the user buffer
+    //--------------------------------------------------------------------------
+    for( size_t i = 0; i < pSegments.size(); ++i )
+    {
+      Segment &seg = pSegments[i];
+      if( seg.members.size() == 1 )
+        seg.buffer = (char*)pChunks[seg.members[0]].buffer;
+      else
+      {
+        seg.buffer  = new char[seg.length];
+        seg.scratch = true;
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    // The large segments go as plain reads, the rest is packed into readv
+    // requests
+    //--------------------------------------------------------------------------
+    Request readv;
+    readv.readv = true;
+    for( size_t i = 0; i < pSegments.size(); ++i )
+    {
+      Segment &seg = pSegments[i];
+      ChunkInfo ch( seg.offset, seg.length, seg.buffer );
+      if( seg.length > maxChunkSize )
+      {
+        Request read;
+        read.readv = false;
+        read.chunks.push_back( ch );
+        pRequests.push_back( read );
+        continue;
+      }
+      readv.chunks.push_back( ch );
+      if( readv.chunks.size() == maxChunks )
+      {
+        pRequests.push_back( readv );
+        readv.chunks.clear();
+      }
+    }
+    if( !readv.chunks.empty() )
+      pRequests.push_back( readv );
+
+    for( size_t i = 0; i < pRequests.size(); ++i )
+      if( pRequests[i].chunks.size() == 1 )
+        pRequests[i].readv = false;
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  VectorReadPlanner::~VectorReadPlanner()
+  {
+    for( size_t i = 0; i < pSegments.size(); ++i )
+      if( pSegments[i].scratch )
+        delete [] pSegments[i].buffer;
+  }
+
+  //----------------------------------------------------------------------------
+  // Copy the merged segments to the user chunks
+  //----------------------------------------------------------------------------
+  void VectorReadPlanner::Scatter()
+  {
+    for( size_t i = 0; i < pSegments.size(); ++i )
+    {
+      Segment &seg = pSegments[i];
+      if( !seg.scratch ) continue;
+      for( size_t j = 0; j < seg.members.size(); ++j )
+      {
+        ChunkInfo &ch = pChunks[seg.members[j]];
+        memcpy( ch.buffer, seg.buffer + ( ch.offset - seg.offset ), ch.length );
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  VectorReadCollector::VectorReadCollector( VectorReadPlanner *planner,
+                                            ResponseHandler   *handler ):
+    pPlanner( planner ),
+    pHandler( handler ),
+    pPending( planner->GetRequests().size() ),
+    pHostList( 0 )
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  VectorReadCollector::~VectorReadCollector()
+  {
+    delete pPlanner;
+    delete pHostList;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get a handler for a request
+  //----------------------------------------------------------------------------
+  ResponseHandler *VectorReadCollector::GetHandler( size_t i )
+  {
+    const VectorReadPlanner::Request &req = pPlanner->GetRequests()[i];
+    uint32_t expected = req.readv ? 0 : req.chunks[0].length;
+    return new PartHandler( this, expected );
+  }
+
+  //----------------------------------------------------------------------------
+  // Some of the requests could not be sent
+  //----------------------------------------------------------------------------
+  bool VectorReadCollector::SendFailed( size_t i, const XRootDStatus &status )
+  {
+    pMutex.Lock();
+    if( pStatus.IsOK() ) pStatus = status;
+    pPending -= pPlanner->GetRequests().size() - i;
+    bool nothingSent = ( i == 0 );
+    bool done        = ( pPending == 0 );
+    pMutex.UnLock();
+
+    if( nothingSent )
+    {
+      delete this;
+      return true;
+    }
+    if( done ) Finish();
+    return false;
+  }
+
+  //----------------------------------------------------------------------------
+  // A request came back
+  //----------------------------------------------------------------------------
+  void VectorReadCollector::Done( XRootDStatus *status, AnyObject *response,
+                                  HostList *hostList, uint32_t expected )
+  {
+    //--------------------------------------------------------------------------
+    // A plain read must bring the whole segment, readv fails on its own
+    // when it cannot
+    //--------------------------------------------------------------------------
+    if( status->IsOK() && expected )
+    {
+      ChunkInfo *chunk = 0;
+      if( response ) response->Get( chunk );
+      if( !chunk || chunk->length != expected )
+        *status = XRootDStatus( stError, errErrorResponse, kXR_IOError,
+                                "readv past EOF" );
+    }
+
+    pMutex.Lock();
+    if( pStatus.IsOK() && !status->IsOK() ) pStatus = *status;
+    if( hostList )
+    {
+      delete pHostList;
+      pHostList = hostList;
+    }
+    bool done = ( --pPending == 0 );
+    pMutex.UnLock();
+
+    delete status;
+    delete response;
+    if( done ) Finish();
+  }
+
+  //----------------------------------------------------------------------------
+  // Call the user handler
+  //----------------------------------------------------------------------------
+  void VectorReadCollector::Finish()
+  {
+    ResponseHandler *handler  = pHandler;
+    HostList        *hostList = pHostList;
+    pHostList = 0;
+
+    if( !pStatus.IsOK() )
+    {
+      XRootDStatus *st = new XRootDStatus( pStatus );
+      delete this;
+      handler->HandleResponseWithHosts( st, 0, hostList );
+      return;
+    }
+
+    pPlanner->Scatter();
+    VectorReadInfo *info = new VectorReadInfo();
+    const ChunkList &chunks = pPlanner->GetChunks();
+    uint32_t size = 0;
+    for( size_t i = 0; i < chunks.size(); ++i )
+    {
+      info->GetChunks().push_back( chunks[i] );
+      size += chunks[i].length;
+    }
+    info->SetSize( size );
+    delete this;
+
+    AnyObject *obj = new AnyObject();
+    obj->Set( info );
+    handler->HandleResponseWithHosts( new XRootDStatus(), obj, hostList );
+  }
+}
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_VECTOR_READ_PLANNER_HH__
+#define __XRD_CL_VECTOR_READ_PLANNER_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <stdint.h>
+#include <vector>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Turn the chunk list of a vector read into the requests to be sent
+  //!
+  //! The chunks are sorted by offset and the ones that overlap or are less
+  //! than maxGap bytes apart are merged. The merged segments that are larger
+  //! than what a single readv element may carry are fetched with kXR_read,
+  //! the others are packed into as many kXR_readv requests of at most
+  //! maxChunks elements as needed. A kXR_readv that would carry a single
+  //! segment is sent as a kXR_read instead. Segments holding one chunk only
+  //! are read straight into the user buffer, the others into a scratch
+  //! buffer that is scattered to the user chunks once the data is there.
+  //----------------------------------------------------------------------------
+  class VectorReadPlanner
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! A request to be sent: a kXR_readv or, if readv is false, a kXR_read
+      //! of the single chunk
+      //------------------------------------------------------------------------
+      struct Request
+      {
+        bool      readv;
+        ChunkList chunks;
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param chunks       the chunks requested by the user
+      //! @param buffer       the user buffer, if 0 the chunk buffers are used
+      //! @param maxGap       merge the chunks this close to each other
+      //! @param maxChunks    maximum number of elements of a kXR_readv
+      //! @param maxChunkSize maximum size of a kXR_readv element
+      //------------------------------------------------------------------------
+      VectorReadPlanner( const ChunkList &chunks,
+                         void            *buffer,
+                         uint32_t         maxGap,
+                         uint32_t         maxChunks,
+                         uint32_t         maxChunkSize );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~VectorReadPlanner();
+
+      //------------------------------------------------------------------------
+      //! True if the user list can be sent as a single kXR_readv as it is
+      //------------------------------------------------------------------------
+      bool IsTrivial() const
+      {
+        return pTrivial;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the requests to be sent
+      //------------------------------------------------------------------------
+      const std::vector<Request> &GetRequests() const
+      {
+        return pRequests;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the user chunks, pointing to their destination buffers
+      //------------------------------------------------------------------------
+      const ChunkList &GetChunks() const
+      {
+        return pChunks;
+      }
+
+      //------------------------------------------------------------------------
+      //! Copy the merged segments to the user chunks
+      //------------------------------------------------------------------------
+      void Scatter();
+
+    private:
+      struct Segment
+      {
+        uint64_t              offset;
+        uint32_t              length;
+        char                 *buffer;
+        bool                  scratch;
+        std::vector<uint32_t> members;
+      };
+
+      ChunkList             pChunks;
+      std::vector<Segment>  pSegments;
+      std::vector<Request>  pRequests;
+      bool                  pTrivial;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Collect the responses to the requests of a plan and call the user
+  //! handler with a single VectorReadInfo when all of them are back
+  //----------------------------------------------------------------------------
+  class VectorReadCollector
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor, takes over the planner
+      //------------------------------------------------------------------------
+      VectorReadCollector( VectorReadPlanner *planner,
+                           ResponseHandler   *handler );
+
+      //------------------------------------------------------------------------
+      //! Get a handler for the request number i of the plan
+      //------------------------------------------------------------------------
+      ResponseHandler *GetHandler( size_t i );
+
+      //------------------------------------------------------------------------
+      //! The request number i could not be sent, nor any after it. Returns
+      //! true if the collector is done and the error has to be returned to
+      //! the caller rather than to the handler.
+      //------------------------------------------------------------------------
+      bool SendFailed( size_t i, const XRootDStatus &status );
+
+      //------------------------------------------------------------------------
+      //! A request came back
+      //------------------------------------------------------------------------
+      void Done( XRootDStatus *status, AnyObject *response, HostList *hostList,
+                 uint32_t expected );
+
+    private:
+      ~VectorReadCollector();
+      void Finish();
+
+      XrdSysMutex        pMutex;
+      VectorReadPlanner *pPlanner;
+      ResponseHandler   *pHandler;
+      size_t             pPending;
+      XRootDStatus       pStatus;
+      HostList          *pHostList;
+  };
+}
+
+#endif // __XRD_CL_VECTOR_READ_PLANNER_HH__
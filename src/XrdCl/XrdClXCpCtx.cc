@@ -35,10 +35,11 @@ namespace XrdCl
 
 XCpCtx::XCpCtx( const std::vector<std::string> &urls, uint64_t blockSize, uint8_t parallelSrc, uint64_t chunkSize, uint64_t parallelChunks, int64_t fileSize ) :
       pUrls( std::deque<std::string>( urls.begin(), urls.end() ) ), pBlockSize( blockSize ),
-      pParallelSrc( parallelSrc ), pChunkSize( chunkSize ), pParallelChunks( parallelChunks ),
-      pOffset( 0 ), pFileSize( -1 ), pFileSizeCV( 0 ), pDataReceived( 0 ), pDone( false ),
+      pParallelSrc( parallelSrc ), pChunkSize( chunkSize ), pMinRatePercent( DefaultXCpMinRatePercent ),
+      pParallelChunks( parallelChunks ), pOffset( 0 ), pFileSize( -1 ), pFileSizeCV( 0 ), pDataReceived( 0 ), pDone( false ),
       pDoneCV( 0 ), pRefCount( 1 )
 {
+  DefaultEnv::GetEnv()->GetInt( "XCpMinRatePercent", pMinRatePercent );
   SetFileSize( fileSize );
 }
 
@@ -66,18 +67,24 @@ bool XCpCtx::GetNextUrl( std::string & url )
 XCpSrc* XCpCtx::WeakestLink( XCpSrc *exclude )
 {
   uint64_t transferRate = -1; // set transferRate to max uint64 value
+  bool     unread = false;
   XCpSrc *ret = 0;
 
+  // a source with data it did not start reading yet comes first, taking
+  // that over costs nothing while racing chunks in flight costs bandwidth;
+  // a broken source counts as such, all its data has to be read again
   std::list<XCpSrc*>::iterator itr;
   for( itr = pSources.begin() ; itr != pSources.end() ; ++itr )
   {
     XCpSrc *src = *itr;
-    if( src == exclude ) continue;
+    if( src == exclude || !src->HasData() ) continue;
+    bool     tmpUnread = !src->IsRunning() || src->HasUnread();
     uint64_t tmp = src->TransferRate();
-    if( src->HasData() && tmp < transferRate )
+    if( ( tmpUnread && !unread ) || ( tmpUnread == unread && tmp < transferRate ) )
     {
       ret = src;
       transferRate = tmp;
+      unread = tmpUnread;
     }
   }
 
@@ -86,21 +93,88 @@ XCpSrc* XCpCtx::WeakestLink( XCpSrc *exclude )
 
 void XCpCtx::PutChunk( ChunkInfo* chunk )
 {
+  if( chunk )
+  {
+    // if the chunk has been read by two sources
+    // only the first copy goes to the sink
+    XrdSysMutexHelper lck( pMtx );
+    std::map<uint64_t, bool>::iterator itr = pSpeculative.find( chunk->offset );
+    if( itr != pSpeculative.end() )
+    {
+      if( itr->second )
+      {
+        lck.UnLock();
+        XCpSrc::DeleteChunk( chunk );
+        return;
+      }
+      itr->second = true;
+    }
+  }
+
   pSink.Put( chunk );
 }
 
-std::pair<uint64_t, uint64_t> XCpCtx::GetBlock()
+std::pair<uint64_t, uint64_t> XCpCtx::GetBlock( XCpSrc *src )
 {
   XrdSysMutexHelper lck( pMtx );
 
-  uint64_t blkSize = pBlockSize, offset = pOffset;
-  if( pOffset + blkSize > uint64_t( pFileSize ) )
-    blkSize = pFileSize - pOffset;
+  uint64_t remaining = pFileSize > int64_t( pOffset ) ? pFileSize - pOffset : 0;
+  uint64_t blkSize   = pBlockSize, offset = pOffset;
+
+  // the aggregated rate of the sources that are still in the game, a source
+  // that has not measured its rate yet is assumed to be as fast as we are,
+  // otherwise the first source to know its rate would take half of the file
+  uint64_t rate = src->TransferRate(), total = 0;
+  std::list<XCpSrc*>::iterator itr;
+  for( itr = pSources.begin() ; itr != pSources.end() ; ++itr )
+    if( (*itr)->IsRunning() && !(*itr)->IsDropped() )
+    {
+      uint64_t tmp = (*itr)->TransferRate();
+      total += tmp ? tmp : rate;
+    }
+
+  if( rate && total )
+  {
+    // half of our share of what is left
+    uint64_t share = uint64_t( double( remaining ) * rate / ( 2.0 * total ) );
+    if( share < blkSize ) blkSize = share;
+  }
+
+  // towards the end the share may be less than a chunk, this is what
+  // keeps the sources finishing together, but don't go below a quarter
+  // of a chunk and don't leave a smaller piece behind
+  uint64_t minSize = pChunkSize / 4 ? pChunkSize / 4 : 1;
+  if( blkSize < minSize )
+    blkSize = minSize;
+  if( blkSize + minSize > remaining )
+    blkSize = remaining;
   pOffset += blkSize;
 
   return std::make_pair( offset, blkSize );
 }
 
+bool XCpCtx::Speculate( uint64_t offset )
+{
+  XrdSysMutexHelper lck( pMtx );
+  return pSpeculative.insert( std::make_pair( offset, false ) ).second;
+}
+
+bool XCpCtx::IsSlow( XCpSrc *src )
+{
+  XrdSysMutexHelper lck( pMtx );
+
+  uint64_t rate = src->TransferRate();
+  if( pMinRatePercent <= 0 || !rate ) return false;
+
+  uint64_t best = 0;
+  std::list<XCpSrc*>::iterator itr;
+  for( itr = pSources.begin() ; itr != pSources.end() ; ++itr )
+    if( (*itr)->IsRunning() && (*itr)->TransferRate() > best )
+      best = (*itr)->TransferRate();
+
+  return rate * 100 < best * pMinRatePercent;
+}
+
 void XCpCtx::SetFileSize( int64_t size )
 {
   XrdSysMutexHelper lck( pMtx );
@@ -179,7 +253,7 @@ bool XCpCtx::AllDone()
   XrdSysCondVarHelper lck( pDoneCV );
 
   if( !pDone )
-    pDoneCV.Wait( 60 );
+    pDoneCV.Wait( 1 );
 
   return pDone;
 }
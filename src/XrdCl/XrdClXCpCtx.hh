@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 #include <iostream>
+#include <map>
 
 namespace XrdCl
 {
@@ -88,7 +89,9 @@ class XCpCtx
     bool GetNextUrl( std::string & url );
 
     /**
-     * Get the 'weakest' sources
+     * Get the 'weakest' sources: the slowest one that has data it
+     * did not start reading yet, or if there is none the slowest
+     * one with data in flight
      *
      * @param exclude : the source that is excluded from the
      *                  search
@@ -97,18 +100,47 @@ class XCpCtx
     XCpSrc* WeakestLink( XCpSrc *exclude );
 
     /**
-     * Put a chunk into the sink
+     * Put a chunk into the sink, the second copy of a chunk that
+     * has been read speculatively is dropped
      *
      * @param chunk : the chunk
      */
     void PutChunk( ChunkInfo* chunk );
 
     /**
-     * Get next block that has to be transfered
+     * Get next block that has to be transfered by given source.
      *
-     * @return : pair of offset and block size
+     * The block size follows the transfer rate of the source:
+     * until it is known the source gets an even share of the file
+     * (a slow one will have it stolen), afterwards it gets half of
+     * its share (proportional to its rate) of what remains to be
+     * allocated, so that the blocks get smaller towards the end of
+     * the file, down to a quarter of a chunk, and all the sources
+     * finish at about the same time.
+     *
+     * @param src : the source asking for work
+     * @return    : pair of offset and block size
+     */
+    std::pair<uint64_t, uint64_t> GetBlock( XCpSrc *src );
+
+    /**
+     * Register a chunk that is going to be read by a second source
+     * while the first one is still at it (tail of the transfer)
+     *
+     * @param offset : offset of the chunk
+     * @return       : false if the chunk has already been duplicated
      */
-    std::pair<uint64_t, uint64_t> GetBlock();
+    bool Speculate( uint64_t offset );
+
+    /**
+     * Check if given source is much slower than the best one
+     * (below XCpMinRatePercent of its rate), in which case it
+     * should not get any new blocks
+     *
+     * @param src : the source
+     * @return    : true if the source is too slow
+     */
+    bool IsSlow( XCpSrc *src );
 
     /**
      * Set the file size (GetSize will block until
@@ -179,7 +211,7 @@ class XCpCtx
     /**
      * Returns true if all chunks have been transfered,
      * otherwise blocks until NotifyIdleSrc is called,
-     * or a 1 minute timeout occurs.
+     * or a 1 second timeout occurs.
      *
      * @return : true is all chunks have been transfered,
      *           false otherwise.
@@ -234,6 +266,18 @@ class XCpCtx
      */
     uint32_t                   pChunkSize;
 
+    /**
+     * Sources slower than this percentage of the fastest
+     * one are not given new blocks (0 means never).
+     */
+    int                        pMinRatePercent;
+
+    /**
+     * Chunks read by more than one source, the value is
+     * true once the first copy has been put into the sink.
+     */
+    std::map<uint64_t, bool>   pSpeculative;
+
     /**
      * Number of parallel chunks per source.
      */
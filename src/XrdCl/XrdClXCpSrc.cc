@@ -30,6 +30,20 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <sys/time.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Current time in milliseconds
+  //----------------------------------------------------------------------------
+  uint64_t NowMs()
+  {
+    timeval now;
+    gettimeofday( &now, 0 );
+    return uint64_t( now.tv_sec ) * 1000 + now.tv_usec / 1000;
+  }
+}
 
 namespace XrdCl
 {
@@ -94,7 +108,8 @@ class ChunkHandler: public ResponseHandler
 XCpSrc::XCpSrc( uint32_t chunkSize, uint8_t parallel, int64_t fileSize, XCpCtx *ctx ) :
   pChunkSize( chunkSize ), pParallel( parallel ), pFileSize( fileSize ), pThread(),
   pCtx( ctx->Self() ), pFile( 0 ), pCurrentOffset( 0 ), pBlkEnd( 0 ), pDataTransfered( 0 ), pRefCount( 1 ),
-  pRunning( false ), pStartTime( 0 ), pTransferTime( 0 )
+  pRunning( false ), pStartTime( 0 ), pTransferTime( 0 ), pRate( 0 ), pRateBytes( 0 ),
+  pRateStamp( 0 ), pDropped( false )
 {
 
 }
@@ -144,6 +159,7 @@ void XCpSrc::StartDownloading()
 
   // start counting transfer time
   pStartTime = time( 0 );
+  pRateStamp = NowMs();
 
   while( pRunning )
   {
@@ -172,6 +188,9 @@ void XCpSrc::StartDownloading()
       {
         // reset start time after pause
         pStartTime = time( 0 );
+        XrdSysMutexHelper lck( pMtx );
+        pRateStamp = NowMs();
+        pRateBytes = 0;
         continue;
       }
       // stop counting
@@ -255,7 +274,7 @@ XRootDStatus XCpSrc::Initialize()
   }
   while( !st.IsOK() );
 
-  std::pair<uint64_t, uint64_t> p = pCtx->GetBlock();
+  std::pair<uint64_t, uint64_t> p = pCtx->GetBlock( this );
   pCurrentOffset = p.first;
   pBlkEnd        = p.second + p.first;
 
@@ -300,6 +319,10 @@ XRootDStatus XCpSrc::Recover()
   pTransferTime   = 0;
   pStartTime      = time( 0 );
   pDataTransfered = 0;
+  XrdSysMutexHelper lck( pMtx );
+  pRate           = 0;
+  pRateBytes      = 0;
+  pRateStamp      = NowMs();
 
   return st;
 }
@@ -349,7 +372,10 @@ XRootDStatus XCpSrc::ReadChunks()
 
   if( pOngoing.empty() ) return XRootDStatus( stOK, suDone );
 
-  if( pRecovered.empty() && pCurrentOffset >= pBlkEnd ) return XRootDStatus( stOK, suPartial );
+  // ask for a new block only if we could start reading it now, otherwise
+  // we would sit on it while the others run out of work
+  if( pRecovered.empty() && pCurrentOffset >= pBlkEnd && pOngoing.size() < pParallel )
+    return XRootDStatus( stOK, suPartial );
 
   return XRootDStatus( stOK, suContinue );
 }
@@ -404,6 +430,7 @@ void XCpSrc::ReportResponse( XRootDStatus *status, ChunkInfo *chunk, File *handl
 
   if( ignore )
   {
+    UpdateRate( chunk->length );
     DeleteChunk( chunk );
     return;
   }
@@ -411,10 +438,33 @@ void XCpSrc::ReportResponse( XRootDStatus *status, ChunkInfo *chunk, File *handl
   if( chunk )
   {
     pDataTransfered += chunk->length;
+    UpdateRate( chunk->length );
     pCtx->PutChunk( chunk );
   }
 }
 
+void XCpSrc::UpdateRate( uint64_t bytes )
+{
+  XrdSysMutexHelper lck( pMtx );
+
+  // sample the rate at most every 100ms, the average
+  // gives the same weight to the last sample and to
+  // the history so we follow changes quickly; the
+  // chunks are read in parallel and tend to arrive
+  // together, so a sample has to cover as many bytes
+  // as we have in flight, otherwise the first chunk
+  // of a round makes us look pParallel times slower
+  pRateBytes += bytes;
+  uint64_t now = NowMs();
+  if( now < pRateStamp + 100 ||
+      pRateBytes < uint64_t( pChunkSize ) * pParallel ) return;
+
+  uint64_t rate = pRateBytes * 1000 / ( now - pRateStamp );
+  pRate      = pRate ? ( pRate + rate ) / 2 : rate;
+  pRateBytes = 0;
+  pRateStamp = now;
+}
+
 void XCpSrc::Steal( XCpSrc *src )
 {
   if( !src ) return;
@@ -443,7 +493,7 @@ void XCpSrc::Steal( XCpSrc *src )
     // need to notify
     pCtx->NotifyIdleSrc();
 
-    log->Debug( UtilityMsg, "s%: Stealing everything from %s", myHost.c_str(), srcHost.c_str() );
+    log->Debug( UtilityMsg, "%s: Stealing everything from %s", myHost.c_str(), srcHost.c_str() );
 
     return;
   }
@@ -468,7 +518,7 @@ void XCpSrc::Steal( XCpSrc *src )
     pBlkEnd        = src->pBlkEnd;
     src->pBlkEnd  -= steal;
 
-    log->Debug( UtilityMsg, "s%: Stealing fraction (%f) of block from %s", myHost.c_str(), fraction, srcHost.c_str() );
+    log->Debug( UtilityMsg, "%s: Stealing fraction (%f) of block from %s", myHost.c_str(), fraction, srcHost.c_str() );
 
     return;
   }
@@ -483,7 +533,7 @@ void XCpSrc::Steal( XCpSrc *src )
       src->pRecovered.erase( itr );
     }
 
-    log->Debug( UtilityMsg, "s%: Stealing fraction (%f) of recovered chunks from %s", myHost.c_str(), fraction, srcHost.c_str() );
+    log->Debug( UtilityMsg, "%s: Stealing fraction (%f) of recovered chunks from %s", myHost.c_str(), fraction, srcHost.c_str() );
 
     return;
   }
@@ -494,23 +544,67 @@ void XCpSrc::Steal( XCpSrc *src )
   //   rate (similarly, it doesn't make sense to steal)
   // * the source needs to be really faster (though, this is an arbitrary
   //   choice) to actually steal something
+  //
+  // The ongoing chunks are not taken away from the source, we read them
+  // as well and whichever copy arrives first goes to the sink, this way
+  // the tail of the transfer does not depend on the slowest source
   if( !src->pOngoing.empty() && fraction > 0.7 )
   {
+    // if the source has not sampled its rate yet, the estimate is based on
+    // the few chunks that happened to arrive first and two sources of the
+    // same speed easily look a factor of three apart, so it is only worth
+    // it if we would have read everything the source got and everything it
+    // has in flight in the meantime
+    if( !src->pRate )
+    {
+      uint64_t ongoing = 0;
+      std::map<uint64_t, uint64_t>::iterator itr;
+      for( itr = src->pOngoing.begin(); itr != src->pOngoing.end(); ++itr )
+        ongoing += itr->second;
+      time_t elapsed = src->pTransferTime + time( 0 ) - src->pStartTime;
+      if( uint64_t( elapsed ) * myTransferRate < src->pDataTransfered + ongoing ) return;
+    }
+
     size_t count = static_cast<size_t>( round( fraction * src->pOngoing.size() ) );
-    while( count-- )
+    std::map<uint64_t, uint64_t>::iterator itr;
+    for( itr = src->pOngoing.begin(); itr != src->pOngoing.end() && count; ++itr )
     {
-      std::map<uint64_t, uint64_t>::iterator itr = src->pOngoing.begin();
+      if( !pCtx->Speculate( itr->first ) ) continue;
       pRecovered.insert( *itr );
-      src->pOngoing.erase( itr );
+      --count;
     }
 
-    log->Debug( UtilityMsg, "s%: Stealing fraction (%f) of ongoing chunks from %s", myHost.c_str(), fraction, srcHost.c_str() );
+    log->Debug( UtilityMsg, "%s: Speculatively reading fraction (%f) of ongoing chunks from %s", myHost.c_str(), fraction, srcHost.c_str() );
   }
 }
 
 XRootDStatus XCpSrc::GetWork()
 {
-  std::pair<uint64_t, uint64_t> p = pCtx->GetBlock();
+  Log *log = DefaultEnv::GetLog();
+
+  // if we are much slower than the others we don't take
+  // any new work, what we still have in flight will be
+  // read by the others as well if they run out of work
+  if( pCtx->IsSlow( this ) )
+  {
+    if( !pDropped )
+    {
+      std::string myHost = URL( pUrl ).GetHostName();
+      log->Warning( UtilityMsg, "%s is too slow (%llu B/s), not giving it new blocks",
+                    myHost.c_str(), (unsigned long long)TransferRate() );
+    }
+    pDropped = true;
+    return XRootDStatus( stError, errInvalidOp );
+  }
+  pDropped = false;
+
+  // until we know how fast we are we don't ask for more
+  // than what we already have, so that the other sources
+  // get their part of the file
+  if( !TransferRate() && HasData() )
+    return XRootDStatus( stError, errInvalidOp );
+
+  std::pair<uint64_t, uint64_t> p = pCtx->GetBlock( this );
 
   if( p.second > 0 )
   {
@@ -518,9 +612,9 @@ XRootDStatus XCpSrc::GetWork()
     pCurrentOffset = p.first;
     pBlkEnd        = p.first + p.second;
 
-    Log *log = DefaultEnv::GetLog();
     std::string myHost = URL( pUrl ).GetHostName();
-    log->Debug( UtilityMsg, "s% got next block", myHost.c_str() );
+    log->Debug( UtilityMsg, "%s got next block: %llu bytes at %llu", myHost.c_str(),
+                (unsigned long long)p.second, (unsigned long long)p.first );
 
     return XRootDStatus();
   }
@@ -536,6 +630,7 @@ XRootDStatus XCpSrc::GetWork()
 
 uint64_t XCpSrc::TransferRate()
 {
+  if( pRate ) return pRate;
   time_t duration = pTransferTime + time( 0 ) - pStartTime;
   return pDataTransfered / ( duration + 1 ); // add one to avoid floating point exception
 }
@@ -106,6 +106,15 @@ class XCpSrc
       return pCurrentOffset < pBlkEnd || !pRecovered.empty() || !pOngoing.empty();
     }
 
+    /**
+     * @return true if the source has data allocated that it
+     *         did not start reading yet, false otherwise
+     */
+    bool HasUnread()
+    {
+      XrdSysMutexHelper lck( pMtx );
+      return pCurrentOffset < pBlkEnd || !pRecovered.empty();
+    }
 
 
     /**
@@ -115,6 +124,16 @@ class XCpSrc
      */
     uint64_t TransferRate();
 
+    /**
+     * @return : true if the source has been found too slow
+     *           compared to the others and does not get new
+     *           blocks
+     */
+    bool IsDropped()
+    {
+      return pDropped;
+    }
+
     /**
      * Delete ChunkInfo object, and set the pointer to null.
      *
@@ -221,6 +240,13 @@ class XCpSrc
      */
     void ReportResponse( XRootDStatus *status, ChunkInfo *chunk, File *handle );
 
+    /**
+     * Account for received data in the transfer rate.
+     *
+     * @param bytes : size of the received chunk
+     */
+    void UpdateRate( uint64_t bytes );
+
     /**
      * Delets a pointer and sets it to null.
      */
@@ -357,6 +383,27 @@ class XCpSrc
      * the restart
      */
     time_t                        pTransferTime;
+
+    /**
+     * Recent transfer rate (exponential moving average) [B/s]
+     */
+    uint64_t                      pRate;
+
+    /**
+     * Data received since the last rate sample
+     */
+    uint64_t                      pRateBytes;
+
+    /**
+     * Time of the last rate sample [ms]
+     */
+    uint64_t                      pRateStamp;
+
+    /**
+     * A flag, true means the source is too slow to be
+     * given new blocks
+     */
+    bool                          pDropped;
 };
 
 } /* namespace XrdCl */
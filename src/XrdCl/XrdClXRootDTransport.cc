@@ -49,6 +49,7 @@
 #include <sstream>
 #include <iomanip>
 #include <set>
+#include <algorithm>
 
 XrdVERSIONINFOREF( XrdCl );
 
@@ -2122,6 +2123,20 @@ namespace XrdCl
         break;
       }
 
+      //------------------------------------------------------------------------
+      // kXR_statx
+      //------------------------------------------------------------------------
+      case kXR_statx:
+      {
+        ClientStatRequest *sreq = (ClientStatRequest *)msg->GetBuffer();
+        o << "kXR_statx (";
+        o << "paths: " << std::count( msg->GetBuffer( 24 ),
+                                      msg->GetBuffer( 24 ) + sreq->dlen,
+                                      '\n' ) + 1;
+        o << ")";
+        break;
+      }
+
       //------------------------------------------------------------------------
       // kXR_read
       //------------------------------------------------------------------------
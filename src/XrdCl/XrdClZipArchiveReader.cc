@@ -28,9 +28,14 @@
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClURL.hh"
 
 #include "XrdSys/XrdSysPthread.hh"
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <map>
 
@@ -80,12 +85,25 @@ struct CDFH
       pOffset            = *reinterpret_cast<uint32_t*>( buffer + 42 );
 
       uint16_t filenameLength = *reinterpret_cast<uint16_t*>( buffer + 28 );
-      uint16_t extraLength    = *reinterpret_cast<uint16_t*>( buffer + 30 );
-      uint16_t commentLength  = *reinterpret_cast<uint16_t*>( buffer + 32 );
 
       pFilename = std::string( buffer + 46, filenameLength );
 
-      pCdfhSize = kCdfhBaseSize + filenameLength +extraLength + commentLength;
+      pCdfhSize = GetSize( buffer );
+    }
+
+    //! the size of the record, only the fixed part has to be in the buffer
+    static uint32_t GetSize( const char *buffer )
+    {
+      uint16_t filenameLength = *reinterpret_cast<const uint16_t*>( buffer + 28 );
+      uint16_t extraLength    = *reinterpret_cast<const uint16_t*>( buffer + 30 );
+      uint16_t commentLength  = *reinterpret_cast<const uint16_t*>( buffer + 32 );
+      return uint32_t( kCdfhBaseSize ) + filenameLength + extraLength + commentLength;
+    }
+
+    //! the size of the file as stored in the archive
+    uint32_t StoredSize() const
+    {
+      return pCompressionMethod ? pCompressedSize : pUncompressedSize;
     }
 
     uint16_t    pZipVersion;
@@ -97,18 +115,259 @@ struct CDFH
     uint16_t    pDiskNb;
     uint32_t    pOffset;
     std::string pFilename;
-    uint16_t    pCdfhSize;
+    uint32_t    pCdfhSize;
 
     static const uint16_t kCdfhBaseSize = 46;
     static const uint32_t kCdfhSign     = 0x02014b50;
 };
 
 
+struct LFH
+{
+    LFH( char *buffer )
+    {
+      pFilenameLength = *reinterpret_cast<uint16_t*>( buffer + 26 );
+      pExtraLength    = *reinterpret_cast<uint16_t*>( buffer + 28 );
+    }
+
+    //! the offset of the file data relative to the header, the
+    //! extra field does not have to be the same as in the CDFH
+    uint32_t DataOffset() const
+    {
+      return kLfhBaseSize + pFilenameLength + pExtraLength;
+    }
+
+    uint16_t    pFilenameLength;
+    uint16_t    pExtraLength;
+
+    static const uint16_t kLfhBaseSize = 30;
+    static const uint32_t kLfhSign     = 0x04034b50;
+};
+
+
+//------------------------------------------------------------------------------
+// The parsed central directory of an archive, it is immutable once parsed
+// so it can be shared by all the readers of the same archive, except for
+// the offsets of the file data that are filled in as the local file
+// headers are read
+//------------------------------------------------------------------------------
+class ZipCentralDir
+{
+  public:
+
+    ZipCentralDir( EOCD *eocd ) : pEocd( eocd ), pRefCount( 1 ) { }
+
+    ZipCentralDir* Self()
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      ++pRefCount;
+      return this;
+    }
+
+    void Delete()
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      --pRefCount;
+      if( !pRefCount )
+      {
+        scopedLock.UnLock();
+        delete this;
+      }
+    }
+
+    const EOCD* GetEocd() const
+    {
+      return pEocd;
+    }
+
+    XRootDStatus Parse( char *buffer, uint16_t nbCdRecords, uint32_t bufferSize )
+    {
+      uint32_t offset = 0;
+      pCdRecords.reserve( nbCdRecords );
+
+      for( size_t i = 0; i < nbCdRecords; ++i )
+      {
+        if( bufferSize < CDFH::kCdfhBaseSize ) break;
+        // check the signature
+        uint32_t *signature = (uint32_t*)( buffer + offset );
+        if( *signature != CDFH::kCdfhSign ) return XRootDStatus( stError, errErrorResponse, errDataError, "Central-directory-file-header signature not found." );
+        // the record has to fit in what is left of the central directory
+        if( CDFH::GetSize( buffer + offset ) > bufferSize ) return XRootDStatus( stError, errErrorResponse, errDataError, "Central-directory-file-header exceeds the central directory." );
+        // parse the record
+        CDFH *cdfh = new CDFH( buffer + offset );
+        offset     += cdfh->pCdfhSize;
+        bufferSize -= cdfh->pCdfhSize;
+        pCdRecords.push_back( cdfh );
+        pDataOffsets.push_back( 0 );
+        pFileToCdfh[cdfh->pFilename] = i;
+      }
+
+      return XRootDStatus();
+    }
+
+    //--------------------------------------------------------------------------
+    // Find the record of the given file and the offset of its data, the
+    // offset is 0 as long as the local file header has not been read
+    //--------------------------------------------------------------------------
+    const CDFH* Find( const std::string &filename, uint64_t &dataOffset )
+    {
+      std::map<std::string, size_t>::const_iterator cditr = pFileToCdfh.find( filename );
+      if( cditr == pFileToCdfh.end() ) return 0;
+
+      XrdSysMutexHelper scopedLock( pMutex );
+      dataOffset = pDataOffsets[cditr->second];
+      return pCdRecords[cditr->second];
+    }
+
+    //--------------------------------------------------------------------------
+    // Set the offset of the data of the given file from its local file
+    // header. We cannot tell it from the central directory: the size of
+    // the header depends on its own extra field and the data may be
+    // followed by a data descriptor (general purpose bit 3).
+    //--------------------------------------------------------------------------
+    XRootDStatus SetDataOffset( const CDFH *cdfh, char *lfhBuffer )
+    {
+      uint32_t *signature = reinterpret_cast<uint32_t*>( lfhBuffer );
+      if( *signature != LFH::kLfhSign ) return XRootDStatus( stError, errErrorResponse, errDataError, "Local-file-header signature not found." );
+      LFH lfh( lfhBuffer );
+
+      XrdSysMutexHelper scopedLock( pMutex );
+      pDataOffsets[pFileToCdfh[cdfh->pFilename]] = uint64_t( cdfh->pOffset ) + lfh.DataOffset();
+      return XRootDStatus();
+    }
+
+    //--------------------------------------------------------------------------
+    // Set the offsets of the data of all the files if we have the whole
+    // archive in memory
+    //--------------------------------------------------------------------------
+    XRootDStatus SetDataOffsets( char *archive, uint64_t size )
+    {
+      for( size_t i = 0; i < pCdRecords.size(); ++i )
+      {
+        const CDFH *cdfh = pCdRecords[i];
+        if( uint64_t( cdfh->pOffset ) + LFH::kLfhBaseSize > size ) return XRootDStatus( stError, errErrorResponse, errDataError, "Local-file-header out of the archive." );
+        XRootDStatus st = SetDataOffset( cdfh, archive + cdfh->pOffset );
+        if( !st.IsOK() ) return st;
+      }
+      return XRootDStatus();
+    }
+
+  private:
+
+    ~ZipCentralDir()
+    {
+      delete pEocd;
+      for( std::vector<CDFH*>::iterator it = pCdRecords.begin(); it != pCdRecords.end(); ++it )
+        delete *it;
+    }
+
+    EOCD                          *pEocd;
+    std::vector<CDFH*>             pCdRecords;
+    std::vector<uint64_t>          pDataOffsets;
+    std::map<std::string, size_t>  pFileToCdfh;
+    XrdSysMutex                    pMutex;
+    size_t                         pRefCount;
+};
+
+
+//------------------------------------------------------------------------------
+// Process wide cache of the parsed central directories, keyed by the
+// location of the archive, an entry is valid only as long as the size
+// and the modification time of the archive are the same
+//------------------------------------------------------------------------------
+class ZipCDCache
+{
+  public:
+
+    ZipCDCache() : pTick( 0 ) { }
+
+    ~ZipCDCache()
+    {
+      std::map<std::string, Entry>::iterator itr;
+      for( itr = pEntries.begin(); itr != pEntries.end(); ++itr )
+        itr->second.cd->Delete();
+    }
+
+    static ZipCDCache &Instance()
+    {
+      static ZipCDCache cache;
+      return cache;
+    }
+
+    //--------------------------------------------------------------------------
+    // Get a reference to the central directory of the given archive or 0
+    //--------------------------------------------------------------------------
+    ZipCentralDir* Get( const std::string &url, uint64_t size, uint64_t mtime )
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      std::map<std::string, Entry>::iterator itr = pEntries.find( url );
+      if( itr == pEntries.end() ) return 0;
+      if( itr->second.size != size || itr->second.mtime != mtime )
+      {
+        // the archive has changed
+        itr->second.cd->Delete();
+        pEntries.erase( itr );
+        return 0;
+      }
+      itr->second.lastUse = ++pTick;
+      return itr->second.cd->Self();
+    }
+
+    //--------------------------------------------------------------------------
+    // Remember the central directory of the given archive
+    //--------------------------------------------------------------------------
+    void Put( const std::string &url, uint64_t size, uint64_t mtime, ZipCentralDir *cd )
+    {
+      int maxSize = DefaultZipCDCacheSize;
+      DefaultEnv::GetEnv()->GetInt( "ZipCDCacheSize", maxSize );
+      if( maxSize <= 0 ) return;
+
+      XrdSysMutexHelper scopedLock( pMutex );
+      std::map<std::string, Entry>::iterator itr = pEntries.find( url );
+      if( itr != pEntries.end() )
+      {
+        itr->second.cd->Delete();
+        pEntries.erase( itr );
+      }
+
+      // make room evicting the least recently used entries
+      while( pEntries.size() >= size_t( maxSize ) )
+      {
+        std::map<std::string, Entry>::iterator lru = pEntries.begin();
+        for( itr = pEntries.begin(); itr != pEntries.end(); ++itr )
+          if( itr->second.lastUse < lru->second.lastUse ) lru = itr;
+        lru->second.cd->Delete();
+        pEntries.erase( lru );
+      }
+
+      Entry &entry  = pEntries[url];
+      entry.size    = size;
+      entry.mtime   = mtime;
+      entry.lastUse = ++pTick;
+      entry.cd      = cd->Self();
+    }
+
+  private:
+
+    struct Entry
+    {
+      uint64_t       size;
+      uint64_t       mtime;
+      uint64_t       lastUse;
+      ZipCentralDir *cd;
+    };
+
+    std::map<std::string, Entry> pEntries;
+    uint64_t                     pTick;
+    XrdSysMutex                  pMutex;
+};
+
+
 class ZipArchiveReaderImpl
 {
   public:
 
-    ZipArchiveReaderImpl() : pArchiveSize( 0 ), pBuffer( 0 ), pEocd( 0 ), pRefCount( 1 ), pOpen( false ) { }
+    ZipArchiveReaderImpl() : pArchiveSize( 0 ), pArchiveMTime( 0 ), pBuffer( 0 ), pCd( 0 ), pRefCount( 1 ), pOpen( false ) { }
 
     ZipArchiveReaderImpl* Self()
     {
@@ -136,6 +395,16 @@ class ZipArchiveReaderImpl
 
     XRootDStatus Read( const std::string &filename, uint64_t relativeOffset, uint32_t size, void *buffer, ResponseHandler *userHandler, uint16_t timeout = 0 );
 
+    XRootDStatus VectorRead( const ZipChunkList &chunks, bool inflate, ResponseHandler *userHandler, uint16_t timeout = 0 );
+
+    XRootDStatus ReadLfh( const std::vector<const CDFH*> &records, const ZipChunkList &chunks, bool vector, bool inflate, ResponseHandler *userHandler, uint16_t timeout );
+
+    XRootDStatus SetDataOffset( const CDFH *cdfh, char *lfhBuffer )
+    {
+      if( !pCd ) return XRootDStatus( stError, errInvalidOp, errInvalidOp, "Archive not opened." );
+      return pCd->SetDataOffset( cdfh, lfhBuffer );
+    }
+
     XRootDStatus Close( ResponseHandler *handler, uint16_t timeout )
     {
       XRootDStatus st = pArchive.Close( handler, timeout );
@@ -153,12 +422,12 @@ class ZipArchiveReaderImpl
       return pArchive.SetProperty( name, value );
     }
 
-    XRootDStatus GetSize( const std::string & filename, uint32_t &size ) const
+    XRootDStatus GetSize( const std::string & filename, uint32_t &size, bool uncompressed ) const
     {
-      std::map<std::string, size_t>::const_iterator it = pFileToCdfh.find( filename );
-      if( it == pFileToCdfh.end() ) return XRootDStatus( stError, errNotFound );
-      CDFH *cdfh = pCdRecords[it->second];
-      size = cdfh->pCompressionMethod ? cdfh->pCompressedSize : cdfh->pUncompressedSize;
+      uint64_t dataOffset;
+      const CDFH *cdfh = pCd ? pCd->Find( filename, dataOffset ) : 0;
+      if( !cdfh ) return XRootDStatus( stError, errNotFound );
+      size = uncompressed ? cdfh->pUncompressedSize : cdfh->StoredSize();
       return XRootDStatus();
     }
 
@@ -172,6 +441,19 @@ class ZipArchiveReaderImpl
       pArchiveSize = size;
     }
 
+    //--------------------------------------------------------------------------
+    // Look for the central directory of the archive in the cache, the size
+    // of the archive has to be set beforehand
+    //--------------------------------------------------------------------------
+    bool LookupCd( uint64_t mtime )
+    {
+      pArchiveMTime = mtime;
+      pCd = ZipCDCache::Instance().Get( pUrl, pArchiveSize, pArchiveMTime );
+      if( !pCd ) return false;
+      pOpen = true;
+      return true;
+    }
+
     char* LookForEocd( uint64_t size )
     {
       for( ssize_t offset = size - EOCD::kEocdBaseSize; offset >= 0; --offset )
@@ -182,38 +464,18 @@ class ZipArchiveReaderImpl
       return 0;
     }
 
-    XRootDStatus ParseCdRecords( char *buffer, uint16_t nbCdRecords, uint32_t bufferSize )
-    {
-      uint32_t offset = 0;
-      pCdRecords.reserve( nbCdRecords );
-
-      for( size_t i = 0; i < nbCdRecords; ++i )
-      {
-        if( bufferSize < CDFH::kCdfhBaseSize ) break;
-        // check the signature
-        uint32_t *signature = (uint32_t*)( buffer + offset );
-        if( *signature != CDFH::kCdfhSign ) return XRootDStatus( stError, errErrorResponse, errDataError, "Central-directory-file-header signature not found." );
-        // parse the record
-        CDFH *cdfh = new CDFH( buffer + offset );
-        offset     += cdfh->pCdfhSize;
-        bufferSize -= cdfh->pCdfhSize;
-        pCdRecords.push_back( cdfh );
-        pFileToCdfh[cdfh->pFilename] = i;
-      }
-
-      pOpen = true;
-      return XRootDStatus();
-    }
-
     XRootDStatus HandleWholeArchive()
     {
       // create the End-of-Central-Directory record
       char *eocdBlock = LookForEocd( pArchiveSize );
       if( !eocdBlock ) return XRootDStatus( stError, errErrorResponse, errDataError, "End-of-central-directory signature not found." );
-      pEocd = new EOCD( eocdBlock );
+      pCd = new ZipCentralDir( new EOCD( eocdBlock ) );
 
       // parse Central-Directory-File-Header records
-      XRootDStatus st = ParseCdRecords( pBuffer + pEocd->pCdOffset, pEocd->pNbCdRec, pEocd->pCdSize );
+      const EOCD *eocd = pCd->GetEocd();
+      XRootDStatus st = pCd->Parse( pBuffer + eocd->pCdOffset, eocd->pNbCdRec, eocd->pCdSize );
+      if( st.IsOK() ) st = pCd->SetDataOffsets( pBuffer, pArchiveSize );
+      if( st.IsOK() ) pOpen = true;
 
       return st;
     }
@@ -221,10 +483,15 @@ class ZipArchiveReaderImpl
     XRootDStatus HandleCdfh( uint16_t nbCdRecords, uint32_t bufferSize )
     {
       // parse Central-Directory-File-Header records
-      XRootDStatus st = ParseCdRecords( pBuffer, nbCdRecords, bufferSize );
+      XRootDStatus st = pCd->Parse( pBuffer, nbCdRecords, bufferSize );
       // successful or not we don't need it anymore
       delete pBuffer;
       pBuffer = 0;
+      if( st.IsOK() )
+      {
+        pOpen = true;
+        ZipCDCache::Instance().Put( pUrl, pArchiveSize, pArchiveMTime, pCd );
+      }
       return st;
     }
 
@@ -232,13 +499,9 @@ class ZipArchiveReaderImpl
 
     void ClearRecords()
     {
-      delete pEocd;
-      pEocd = 0;
-
-      for( std::vector<CDFH*>::iterator it = pCdRecords.begin(); it != pCdRecords.end(); ++it )
-        delete *it;
-      pCdRecords.clear();
-      pFileToCdfh.clear();
+      if( pCd ) pCd->Delete();
+      pCd   = 0;
+      pOpen = false;
     }
 
     ~ZipArchiveReaderImpl()
@@ -257,12 +520,11 @@ class ZipArchiveReaderImpl
     }
 
     File                           pArchive;
-    std::string                    pFilename;
+    std::string                    pUrl;
     uint64_t                       pArchiveSize;
+    uint64_t                       pArchiveMTime;
     char*                          pBuffer;
-    EOCD                          *pEocd;
-    std::vector<CDFH*>             pCdRecords;
-    std::map<std::string, size_t>  pFileToCdfh;
+    ZipCentralDir                 *pCd;
     mutable XrdSysMutex            pMutex;
     size_t                         pRefCount;
     bool                           pOpen;
@@ -419,8 +681,18 @@ class StatArchiveHandler : public ZipHandlerBase<StatInfo>
       pImpl->SetArchiveSize( size );
 
       // if the size of the file is smaller than the maximum comment size +
-      // EOCD size simply download the whole file, otherwise download the EOCD
-      XRootDStatus st = ( size <= EOCD::kMaxCommentSize + EOCD::kEocdBaseSize ) ? pImpl->ReadArchive( pUserHandler ) : pImpl->ReadEocd( pUserHandler );
+      // EOCD size simply download the whole file, otherwise use the cached
+      // central directory or download the EOCD
+      bool small = size <= EOCD::kMaxCommentSize + EOCD::kEocdBaseSize;
+      if( !small && pImpl->LookupCd( response->GetModTime() ) )
+      {
+        delete response;
+        if( pUserHandler ) pUserHandler->HandleResponse( status, 0 );
+        else delete status;
+        return;
+      }
+
+      XRootDStatus st = small ? pImpl->ReadArchive( pUserHandler ) : pImpl->ReadEocd( pUserHandler );
       if( !st.IsOK() )
       {
         *status = st;
@@ -519,6 +791,204 @@ class ZipReadHandler : public ZipHandlerBase<ChunkInfo>
 };
 
 
+//------------------------------------------------------------------------------
+// Reads the local file headers of the files whose data offset is not known
+// yet and then carries on with the read or the vector read
+//------------------------------------------------------------------------------
+class ZipLfhHandler : public ZipHandlerBase<VectorReadInfo>
+{
+  public:
+
+    ZipLfhHandler( const ZipChunkList &chunks, bool vector, bool inflate, uint16_t timeout, ZipArchiveReaderImpl *impl, ResponseHandler *userHandler ) :
+      ZipHandlerBase<VectorReadInfo>( impl, userHandler ), pChunks( chunks ), pVector( vector ), pInflate( inflate ), pTimeout( timeout ) { }
+
+    virtual ~ZipLfhHandler()
+    {
+      for( size_t i = 0; i < pHeaders.size(); ++i )
+        delete [] pHeaders[i].second;
+    }
+
+    //--------------------------------------------------------------------------
+    // Add a header to be read, returns the buffer for it
+    //--------------------------------------------------------------------------
+    char* AddHeader( const CDFH *cdfh )
+    {
+      char *buffer = new char[LFH::kLfhBaseSize];
+      pHeaders.push_back( std::make_pair( cdfh, buffer ) );
+      return buffer;
+    }
+
+    virtual void HandleResponseImpl( XRootDStatus *status, VectorReadInfo *response )
+    {
+      delete response;
+
+      for( size_t i = 0; i < pHeaders.size(); ++i )
+      {
+        XRootDStatus st = pImpl->SetDataOffset( pHeaders[i].first, pHeaders[i].second );
+        if( !st.IsOK() )
+        {
+          *status = st;
+          throw ZipHandlerException<AnyObject>( status, 0 );
+        }
+      }
+
+      XRootDStatus st;
+      if( pVector )
+        st = pImpl->VectorRead( pChunks, pInflate, pUserHandler, pTimeout );
+      else
+        st = pImpl->Read( pChunks[0].filename, pChunks[0].offset, pChunks[0].length, pChunks[0].buffer, pUserHandler, pTimeout );
+      if( !st.IsOK() )
+      {
+        *status = st;
+        throw ZipHandlerException<AnyObject>( status, 0 );
+      }
+
+      delete status;
+    }
+
+  private:
+
+    std::vector<std::pair<const CDFH*, char*> >  pHeaders;
+    ZipChunkList                                 pChunks;
+    bool                                         pVector;
+    bool                                         pInflate;
+    uint16_t                                     pTimeout;
+};
+
+
+//------------------------------------------------------------------------------
+// Collects the data of a vector read of the archive: the chunks of the
+// stored files are read directly into the user buffers, the deflated
+// files are read as a whole and inflated once they arrive
+//------------------------------------------------------------------------------
+class ZipVectorReadHandler : public ZipHandlerBase<VectorReadInfo>
+{
+  public:
+
+    ZipVectorReadHandler( ZipArchiveReaderImpl *impl, ResponseHandler *userHandler ) : ZipHandlerBase<VectorReadInfo>( impl, userHandler ) { }
+
+    virtual ~ZipVectorReadHandler()
+    {
+      for( size_t i = 0; i < pMembers.size(); ++i )
+      {
+        delete [] pMembers[i].compressed;
+        delete [] pMembers[i].data;
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    // Add a file to be inflated, returns its index and the buffer for
+    // its compressed data
+    //--------------------------------------------------------------------------
+    size_t AddMember( const CDFH *cdfh, char *&buffer )
+    {
+      std::map<const CDFH*, size_t>::iterator itr = pIndex.find( cdfh );
+      if( itr != pIndex.end() )
+      {
+        buffer = 0;
+        return itr->second;
+      }
+      Member member;
+      member.cdfh       = cdfh;
+      member.compressed = new char[cdfh->pCompressedSize + 1];
+      member.data       = 0;
+      pMembers.push_back( member );
+      buffer = member.compressed;
+      return pIndex[cdfh] = pMembers.size() - 1;
+    }
+
+    //--------------------------------------------------------------------------
+    // Add a chunk of the response, either read directly (member < 0)
+    // or to be copied from the given inflated file
+    //--------------------------------------------------------------------------
+    void AddChunk( const ChunkInfo &chunk, ssize_t member )
+    {
+      pChunks.push_back( std::make_pair( chunk, member ) );
+    }
+
+    virtual void HandleResponseImpl( XRootDStatus *status, VectorReadInfo *response )
+    {
+      delete response;
+
+      VectorReadInfo *info  = new VectorReadInfo();
+      ChunkList      &list  = info->GetChunks();
+      uint32_t        total = 0;
+      list.reserve( pChunks.size() );
+
+      for( size_t i = 0; i < pChunks.size(); ++i )
+      {
+        ChunkInfo chunk = pChunks[i].first;
+        if( pChunks[i].second >= 0 )
+        {
+          Member &member = pMembers[pChunks[i].second];
+          XRootDStatus st = Inflate( member );
+          if( !st.IsOK() )
+          {
+            delete info;
+            *status = st;
+            throw ZipHandlerException<AnyObject>( status, 0 );
+          }
+          uint32_t size = member.cdfh->pUncompressedSize;
+          chunk.length  = chunk.offset < size ? std::min<uint64_t>( chunk.length, size - chunk.offset ) : 0;
+          if( chunk.length ) memcpy( chunk.buffer, member.data + chunk.offset, chunk.length );
+        }
+        total += chunk.length;
+        list.push_back( chunk );
+      }
+      info->SetSize( total );
+
+      if( pUserHandler ) pUserHandler->HandleResponse( status, PkgResp( info ) );
+      else DeleteArgs( status, info );
+    }
+
+  private:
+
+    struct Member
+    {
+      const CDFH *cdfh;
+      char       *compressed;
+      char       *data;
+    };
+
+    //--------------------------------------------------------------------------
+    // Inflate the raw deflate stream of the given file and check it
+    //--------------------------------------------------------------------------
+    static XRootDStatus Inflate( Member &member )
+    {
+      if( member.data ) return XRootDStatus();
+
+      const CDFH *cdfh = member.cdfh;
+      member.data = new char[cdfh->pUncompressedSize + 1];
+
+      z_stream strm;
+      memset( &strm, 0, sizeof( strm ) );
+      if( inflateInit2( &strm, -MAX_WBITS ) != Z_OK )
+        return XRootDStatus( stError, errInternal, 0, "Unable to initialize zlib." );
+
+      strm.next_in   = reinterpret_cast<Bytef*>( member.compressed );
+      strm.avail_in  = cdfh->pCompressedSize;
+      strm.next_out  = reinterpret_cast<Bytef*>( member.data );
+      strm.avail_out = cdfh->pUncompressedSize;
+      int rc = inflate( &strm, Z_FINISH );
+      uLong size = strm.total_out;
+      inflateEnd( &strm );
+
+      if( rc != Z_STREAM_END || size != cdfh->pUncompressedSize )
+        return XRootDStatus( stError, errErrorResponse, errDataError, "Unable to inflate " + cdfh->pFilename + "." );
+
+      uLong crc = crc32( 0L, reinterpret_cast<Bytef*>( member.data ), cdfh->pUncompressedSize );
+      if( crc != cdfh->pCrc32 )
+        return XRootDStatus( stError, errErrorResponse, errDataError, "CRC32 mismatch for " + cdfh->pFilename + "." );
+
+      return XRootDStatus();
+    }
+
+    std::vector<Member>                          pMembers;
+    std::map<const CDFH*, size_t>                pIndex;
+    std::vector<std::pair<ChunkInfo, ssize_t> >  pChunks;
+};
+
+
 ZipArchiveReader::ZipArchiveReader() : pImpl( new ZipArchiveReaderImpl() )
 {
 
@@ -533,6 +1003,7 @@ ZipArchiveReader::~ZipArchiveReader()
 
 XRootDStatus ZipArchiveReaderImpl::Open( const std::string &url, ResponseHandler *userHandler, uint16_t timeout )
 {
+  pUrl = URL( url ).GetLocation();
   ZipOpenHandler *handler = new ZipOpenHandler( this, userHandler );
   XRootDStatus st = pArchive.Open( url, OpenFlags::Read, Access::None, handler, timeout );
   if( !st.IsOK() ) delete handler;
@@ -596,12 +1067,13 @@ XRootDStatus ZipArchiveReaderImpl::ReadCdfh( uint64_t bytesRead, ResponseHandler
 {
   char *eocdBlock = LookForEocd( bytesRead );
   if( !eocdBlock ) throw ZipHandlerException<AnyObject>( new XRootDStatus( stError, errErrorResponse, errDataError, "End-of-central-directory signature not found." ), 0 );
-  pEocd = new EOCD( eocdBlock );
-  uint64_t offset = pEocd->pCdOffset;
-  uint32_t size   = pEocd->pCdSize;
+  pCd = new ZipCentralDir( new EOCD( eocdBlock ) );
+  const EOCD *eocd = pCd->GetEocd();
+  uint64_t offset = eocd->pCdOffset;
+  uint32_t size   = eocd->pCdSize;
   delete pBuffer;
   pBuffer = new char[size];
-  ReadCdfhHandler *handler = new ReadCdfhHandler( this, userHandler, pEocd->pNbCdRec );
+  ReadCdfhHandler *handler = new ReadCdfhHandler( this, userHandler, eocd->pNbCdRec );
   XRootDStatus st = pArchive.Read( offset, size, pBuffer, handler );
   if( !st.IsOK() ) delete handler;
   return st;
@@ -631,22 +1103,18 @@ XRootDStatus ZipArchiveReader::Read( const std::string &filename, uint64_t offse
 
 XRootDStatus ZipArchiveReaderImpl::Read( const std::string &filename, uint64_t relativeOffset, uint32_t size, void *buffer, ResponseHandler *userHandler, uint16_t timeout )
 {
-  if( !pArchive.IsOpen() ) return XRootDStatus( stError, errInvalidOp, errInvalidOp, "Archive not opened." );
-
-  std::map<std::string, size_t>::iterator cditr = pFileToCdfh.find( filename );
-  if( cditr == pFileToCdfh.end() ) return XRootDStatus( stError, errNotFound, errNotFound, "File not found." );
-  CDFH *cdfh = pCdRecords[cditr->second];
-
-  // Now the problem is that at the beginning of our
-  // file there is the Local-file-header, which size
-  // is not known because of the variable size 'extra'
-  // field, so we need to know the offset of the next
-  // record and shift it by the file size.
-  // The next record is either the next LFH (next file)
-  // or the start of the Central-directory.
-  uint64_t nextRecordOffset = ( cditr->second + 1 < pCdRecords.size() ) ? pCdRecords[cditr->second + 1]->pOffset : pEocd->pCdOffset;
-  uint32_t fileSize = cdfh->pCompressionMethod ? cdfh->pCompressedSize : cdfh->pUncompressedSize;
-  uint64_t offset = nextRecordOffset - fileSize + relativeOffset;
+  if( !pArchive.IsOpen() || !pOpen ) return XRootDStatus( stError, errInvalidOp, errInvalidOp, "Archive not opened." );
+
+  uint64_t dataOffset;
+  const CDFH *cdfh = pCd->Find( filename, dataOffset );
+  if( !cdfh ) return XRootDStatus( stError, errNotFound, errNotFound, "File not found." );
+
+  // the first time we read the file we need its local file header
+  if( !dataOffset )
+    return ReadLfh( std::vector<const CDFH*>( 1, cdfh ), ZipChunkList( 1, ZipChunk( filename, relativeOffset, size, buffer ) ), false, false, userHandler, timeout );
+
+  uint32_t fileSize = cdfh->StoredSize();
+  uint64_t offset = dataOffset + relativeOffset;
   uint32_t sizeTillEnd = fileSize - relativeOffset;
   if( size > sizeTillEnd ) size = sizeTillEnd;
 
@@ -675,6 +1143,119 @@ XRootDStatus ZipArchiveReaderImpl::Read( const std::string &filename, uint64_t r
   return st;
 }
 
+XRootDStatus ZipArchiveReader::VectorRead( const ZipChunkList &chunks, bool inflate, ResponseHandler *handler, uint16_t timeout )
+{
+  return pImpl->VectorRead( chunks, inflate, handler, timeout );
+}
+
+XRootDStatus ZipArchiveReader::VectorRead( const ZipChunkList &chunks, bool inflate, VectorReadInfo *&vReadInfo, uint16_t timeout )
+{
+  SyncResponseHandler handler;
+  Status st = VectorRead( chunks, inflate, &handler, timeout );
+  if( !st.IsOK() )
+    return st;
+
+  return MessageUtils::WaitForResponse( &handler, vReadInfo );
+}
+
+XRootDStatus ZipArchiveReaderImpl::VectorRead( const ZipChunkList &chunks, bool inflate, ResponseHandler *userHandler, uint16_t timeout )
+{
+  if( !pArchive.IsOpen() || !pOpen ) return XRootDStatus( stError, errInvalidOp, errInvalidOp, "Archive not opened." );
+
+  // the files we read for the first time need their
+  // local file headers to be read beforehand
+  std::vector<const CDFH*> unknown;
+  for( ZipChunkList::const_iterator itr = chunks.begin(); itr != chunks.end(); ++itr )
+  {
+    uint64_t dataOffset;
+    const CDFH *cdfh = pCd->Find( itr->filename, dataOffset );
+    if( cdfh && !dataOffset && std::find( unknown.begin(), unknown.end(), cdfh ) == unknown.end() )
+      unknown.push_back( cdfh );
+  }
+  if( !unknown.empty() )
+    return ReadLfh( unknown, chunks, true, inflate, userHandler, timeout );
+
+  // translate the chunks to chunks of the archive, every
+  // deflated file is read only once however many chunks
+  // of it have been requested
+  ZipVectorReadHandler *handler = new ZipVectorReadHandler( this, userHandler );
+  ChunkList archiveChunks;
+
+  for( ZipChunkList::const_iterator itr = chunks.begin(); itr != chunks.end(); ++itr )
+  {
+    uint64_t dataOffset;
+    const CDFH *cdfh = pCd->Find( itr->filename, dataOffset );
+    if( !cdfh )
+    {
+      delete handler;
+      return XRootDStatus( stError, errNotFound, errNotFound, "File not found: " + itr->filename + "." );
+    }
+    if( !itr->buffer )
+    {
+      delete handler;
+      return XRootDStatus( stError, errInvalidArgs, errInvalidArgs, "No buffer for " + itr->filename + "." );
+    }
+
+    ChunkInfo chunk( itr->offset, itr->length, itr->buffer );
+
+    if( inflate && cdfh->pCompressionMethod == Z_DEFLATED )
+    {
+      char *buffer = 0;
+      size_t member = handler->AddMember( cdfh, buffer );
+      if( buffer && cdfh->pCompressedSize )
+        archiveChunks.push_back( ChunkInfo( dataOffset, cdfh->pCompressedSize, buffer ) );
+      handler->AddChunk( chunk, member );
+      continue;
+    }
+
+    if( inflate && cdfh->pCompressionMethod )
+    {
+      delete handler;
+      return XRootDStatus( stError, errNotSupported, errNotSupported, "Unsupported compression method for " + itr->filename + "." );
+    }
+
+    uint32_t fileSize = cdfh->StoredSize();
+    chunk.length = chunk.offset < fileSize ? std::min<uint64_t>( chunk.length, fileSize - chunk.offset ) : 0;
+    if( chunk.length )
+      archiveChunks.push_back( ChunkInfo( dataOffset + chunk.offset, chunk.length, chunk.buffer ) );
+    handler->AddChunk( chunk, -1 );
+  }
+
+  // check if we have the whole file in our local buffer
+  // or if there is nothing to read
+  if( pBuffer || archiveChunks.empty() )
+  {
+    for( ChunkList::iterator itr = archiveChunks.begin(); itr != archiveChunks.end(); ++itr )
+    {
+      if( itr->offset + itr->length > pArchiveSize )
+      {
+        delete handler;
+        return XRootDStatus( stError, errDataError );
+      }
+      memcpy( itr->buffer, pBuffer + itr->offset, itr->length );
+    }
+    handler->HandleResponse( new XRootDStatus(), handler->PkgResp( new VectorReadInfo() ) );
+    return XRootDStatus();
+  }
+
+  XRootDStatus st = pArchive.VectorRead( archiveChunks, 0, handler, timeout );
+  if( !st.IsOK() ) delete handler;
+
+  return st;
+}
+
+XRootDStatus ZipArchiveReaderImpl::ReadLfh( const std::vector<const CDFH*> &records, const ZipChunkList &chunks, bool vector, bool inflate, ResponseHandler *userHandler, uint16_t timeout )
+{
+  ZipLfhHandler *handler = new ZipLfhHandler( chunks, vector, inflate, timeout, this, userHandler );
+  ChunkList headers;
+  for( size_t i = 0; i < records.size(); ++i )
+    headers.push_back( ChunkInfo( records[i]->pOffset, LFH::kLfhBaseSize, handler->AddHeader( records[i] ) ) );
+
+  XRootDStatus st = pArchive.VectorRead( headers, 0, handler, timeout );
+  if( !st.IsOK() ) delete handler;
+  return st;
+}
+
 XRootDStatus ZipArchiveReader::Close( ResponseHandler *handler, uint16_t timeout )
 {
   return pImpl->Close( handler, timeout );
@@ -697,7 +1278,12 @@ bool ZipArchiveReader::SetProperty( const std::string &name, const std::string &
 
 XRootDStatus ZipArchiveReader::GetSize( const std::string &filename, uint32_t &size ) const
 {
-  return pImpl->GetSize( filename, size );
+  return pImpl->GetSize( filename, size, false );
+}
+
+XRootDStatus ZipArchiveReader::GetUncompressedSize( const std::string &filename, uint32_t &size ) const
+{
+  return pImpl->GetSize( filename, size, true );
 }
 
 bool ZipArchiveReader::IsOpen() const
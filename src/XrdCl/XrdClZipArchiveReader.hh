@@ -27,20 +27,50 @@
 
 #include "XrdClXRootDResponses.hh"
 
+#include <string>
+#include <vector>
+
 namespace XrdCl
 {
 
 class ZipArchiveReaderImpl;
 
+//----------------------------------------------------------------------------
+//! Describe a part of a file inside of a ZIP archive to be read
+//----------------------------------------------------------------------------
+struct ZipChunk
+{
+  //--------------------------------------------------------------------------
+  //! Constructor
+  //--------------------------------------------------------------------------
+  ZipChunk( const std::string &file = "", uint64_t off = 0, uint32_t len = 0,
+            void *buff = 0 ):
+    filename( file ), offset( off ), length( len ), buffer( buff ) {}
+
+  std::string  filename; //! name of the file inside of the archive
+  uint64_t     offset;   //! offset in the file
+  uint32_t     length;   //! length of the chunk
+  void        *buffer;   //! optional buffer pointer
+};
+
+//----------------------------------------------------------------------------
+//! List of chunks of files inside of a ZIP archive
+//----------------------------------------------------------------------------
+typedef std::vector<ZipChunk> ZipChunkList;
+
 //----------------------------------------------------------------------------
 //! A wrapper class for the XrdCl::File.
 //!
 //! It is an abstraction for a ZIP file containing multiple sub-files.
-//! The class does not provide any unzip utilities, it just readjusts
-//! the offset so a respective file inside of the archive can be read.
-//! It is meant for ZIP archives containing uncompressed root files,
-//! so a single file can be accessed without downloading the whole
-//! archive.
+//! The class readjusts the offset so a respective file inside of the
+//! archive can be read. It is meant for ZIP archives containing
+//! uncompressed root files, so a single file can be accessed without
+//! downloading the whole archive. Deflated files can be inflated on
+//! the client side by VectorRead.
+//!
+//! The parsed central directories are kept in a process wide cache
+//! (see XRD_ZIPCDCACHESIZE), so opening again an archive that did not
+//! change costs a single stat.
 //----------------------------------------------------------------------------
 class ZipArchiveReader
 {
@@ -99,6 +129,32 @@ class ZipArchiveReader
     //------------------------------------------------------------------------
     XRootDStatus Read( const std::string &filename, uint64_t offset, uint32_t size, void *buffer, uint32_t &bytesRead, uint16_t timeout = 0 );
 
+    //------------------------------------------------------------------------
+    //! Async read of many chunks, from one or more files of the archive,
+    //! in a single vector read of the archive.
+    //!
+    //! The chunks of the response come in the same order as the requested
+    //! ones, with the offsets relative to their files. A chunk reaching
+    //! past the end of its file is truncated.
+    //!
+    //! @param chunks   : the chunks to be read
+    //! @param inflate  : if true, the deflated files are read as a whole,
+    //!                   inflated and checked against their CRC32, and the
+    //!                   offsets refer to the uncompressed data, otherwise
+    //!                   the files are read as they are in the archive
+    //! @param handler  : the handler for the async operation, the response
+    //!                   is a VectorReadInfo object
+    //! @param timeout  : the timeout of the async operation
+    //!
+    //! @return         : OK on success, error otherwise
+    //------------------------------------------------------------------------
+    XRootDStatus VectorRead( const ZipChunkList &chunks, bool inflate, ResponseHandler *handler, uint16_t timeout = 0 );
+
+    //------------------------------------------------------------------------
+    //! Sync read of many chunks, see above.
+    //------------------------------------------------------------------------
+    XRootDStatus VectorRead( const ZipChunkList &chunks, bool inflate, VectorReadInfo *&vReadInfo, uint16_t timeout = 0 );
+
     //------------------------------------------------------------------------
     //! Async close.
     //!
@@ -133,6 +189,15 @@ class ZipArchiveReader
     //------------------------------------------------------------------------
     XRootDStatus GetSize( const std::string &filename, uint32_t &size ) const;
 
+    //------------------------------------------------------------------------
+    //! Gets the uncompressed size of the given file
+    //!
+    //! @param filename : the name of the file
+    //!
+    //! @return         : the uncompressed size as in CDFH record
+    //------------------------------------------------------------------------
+    XRootDStatus GetUncompressedSize( const std::string &filename, uint32_t &size ) const;
+
     //------------------------------------------------------------------------
     //! Check if the archive is open
     //------------------------------------------------------------------------
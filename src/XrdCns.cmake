@@ -29,7 +29,7 @@ add_executable(
 target_link_libraries(
   XrdCnsd
   XrdCnsLib
-  XrdClient
+  XrdCl
   XrdServer
   XrdUtils
   pthread
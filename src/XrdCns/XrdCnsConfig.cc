@@ -37,8 +37,7 @@
 
 #include "Xrd/XrdTrace.hh"
 
-#include "XrdClient/XrdClientConst.hh"
-#include "XrdClient/XrdClientEnv.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
 
 #include "XrdNet/XrdNetAddr.hh"
 #include "XrdNet/XrdNetOpts.hh"
@@ -127,9 +126,10 @@ int XrdCnsConfig::Configure(int argc, char **argv, char *argt)
   Output:   1 upon success or 0 otherwise.
 */
 
+   static const char *clDbg[] = {"Error", "Warning", "Info", "Debug", "Dump"};
    const char *TraceID = "Config";
    XrdOucArgs Spec(&MLog,(argt ? "Cns_Config: ":"XrdCnsd: "),
-                          "a:b:B:c:dD:e:i:I:k:l:L:N:p:q:R:z");
+                          "a:b:B:c:dD:e:i:I:k:l:L:N:p:q:R:w:z");
    XrdNetAddr netHost;
    const char *dnsEtxt = 0;
    char buff[2048], *dP, *tP, *n2n = 0, *lroot = 0, *xpl = 0;
@@ -146,7 +146,7 @@ int XrdCnsConfig::Configure(int argc, char **argv, char *argt)
    while((theOpt = Spec.getopt()) != (char)-1) 
      {switch(theOpt)
        {
-       case 'a': if (*aPath == '/') aPath = Spec.argval;
+       case 'a': if (*Spec.argval == '/') aPath = Spec.argval;
                     else NoGo = NAPath("'-a'", Spec.argval);
                  break;
        case 'B': Opts |= optNoCns;
@@ -157,12 +157,12 @@ int XrdCnsConfig::Configure(int argc, char **argv, char *argt)
        case 'c': cPath = Spec.argval;
                  break;
        case 'D': NoGo |= XrdOuca2x::a2i(MLog,"-D value",Spec.argval,&n,0,4);
-                 if (!NoGo) EnvPutInt("DebugLevel", n);
+                 if (!NoGo) XrdCl::DefaultEnv::SetLogLevel(clDbg[n]);
                  break;
        case 'd': XrdTrace.What = TRACE_ALL;
                  XrdSysThread::setDebug(&MLog);
                  break;
-       case 'e': if (*ePath == '/') ePath = Spec.argval;
+       case 'e': if (*Spec.argval == '/') ePath = Spec.argval;
                     else NoGo = NAPath("'-e'", Spec.argval);
                  break;
        case 'k': if (!(bindArg = MLog.logger()->ParseKeep(optarg))) NoGo = 1;
@@ -186,6 +186,8 @@ int XrdCnsConfig::Configure(int argc, char **argv, char *argt)
        case 'R': Opts |= optRecr;
                  xpl   = Spec.argval;
                  break;
+       case 'w': NoGo |= XrdOuca2x::a2i(MLog,"-w value",Spec.argval,&wLim,1,1024);
+                 break;
        case 'z': MLog.logger()->setHiRes();
                  break;
        default:  NoGo = 1;
@@ -340,9 +342,10 @@ int XrdCnsConfig::Configure()
    strcat(buff, "/cns/");
    if (!XrdOucUtils::makePath(buff,0770) && chdir(buff)) {}
 
-// Do some XrdClient specific optimizations
+// Do some XrdCl specific optimizations
 //
-   EnvPutInt(NAME_DATASERVERCONN_TTL, 2147483647); // Prevent timeouts
+   XrdCl::DefaultEnv::GetEnv()->PutInt("DataServerTTL",   2147483647);
+   XrdCl::DefaultEnv::GetEnv()->PutInt("LoadBalancerTTL", 2147483647);
 
 // Get the directory where the meta information is to go
 //
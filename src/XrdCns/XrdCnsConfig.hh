@@ -56,6 +56,7 @@ int               Port;        // Xroot server port number for  Dest hosts
 int               mInt;        // Check interval for Inventory file
 int               cInt;        // Close interval for logfiles
 int               qLim;        // Close count    for logfiles
+int               wLim;        // Max requests in flight per destination
 int               Opts;
 
 static const int  optRecr = 0x0001;
@@ -75,7 +76,8 @@ int               MountPath(const char *oldp, char *newp, int newpsz);
                                    Dest(0),  bDest(0), Exports(0),
                                    LCLRoot(0), N2N(0), XrdCnsLog(0), Space(0),
                                    logfn(0), bindArg(0), Port(1095),
-                                   mInt(1800), cInt(1200), qLim(512), Opts(0)
+                                   mInt(1800), cInt(1200), qLim(512), wLim(64),
+                                   Opts(0)
                                  {}
                  ~XrdCnsConfig() {}
 
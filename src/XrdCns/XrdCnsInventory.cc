@@ -114,9 +114,11 @@ int XrdCnsInventory::Init(XrdCnsLogFile *theLF)
 {
    XrdCnsLogRec tRec(XrdCnsLogRec::lrTOD);
 
-// Establish the log file we will be using
+// Establish the log file we will be using. The inventory can be huge and
+// nobody is waiting on the records, so write them out in large batches.
 //
    lfP = theLF;
+   lfP->Batch(256*1024);
 
 // Insert time stamp
 //
@@ -39,8 +39,9 @@
 
 #include "Xrd/XrdTrace.hh"
 
-#include "XrdClient/XrdClient.hh"
-#include "XrdClient/XrdClientAdmin.hh"
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClFileSystem.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
 
 #include "XrdCns/XrdCnsConfig.hh"
 #include "XrdCns/XrdCnsInventory.hh"
@@ -73,12 +74,161 @@ extern XrdOucTrace  XrdTrace;
 
 using namespace XrdCns;
 
+/******************************************************************************/
+/*                     C l a s s   X r d C n s L o g O p                      */
+/******************************************************************************/
+
+// Each log record shipped to the name space becomes a request that runs
+// asynchronously. Creates take up to three steps: open, truncate (only for
+// inventory records, which carry the size) and close. The last step hands the
+// request back to the client via Done(), which deletes it.
+//
+class XrdCnsLogOp : public XrdCl::ResponseHandler
+{
+public:
+
+XrdCnsLogOp     *Next;
+XrdCnsLogFile   *LogF;
+char            *Lfn1;
+char            *Lfn2;
+long long        Size;
+long             Qtime;
+int              recOff;
+char             Type;
+
+void             HandleResponse(XrdCl::XRootDStatus *sP, XrdCl::AnyObject *rP);
+
+const char      *Name();
+
+void             Start(XrdCnsLogClient *cP, const char *Url, int Mode);
+
+                 XrdCnsLogOp(XrdCnsLogFile *lfP, XrdCnsLogRec *lrP,
+                             const char *lfn)
+                            : Next(0), LogF(lfP),
+                              Lfn1(strdup(lfn ? lfn : lrP->Lfn1())),
+                              Lfn2(lrP->Type() == XrdCnsLogRec::lrMv
+                                   ? strdup(lrP->Lfn2()) : 0),
+                              Size(lrP->Type() == XrdCnsLogRec::lrCreate
+                                   ? -1 : lrP->Size()),
+                              Qtime(lrP->Qtime()),
+                              recOff(lfP->recPos()), Type(lrP->Type()),
+                              Client(0), File(0), fStep(0) {}
+
+virtual         ~XrdCnsLogOp() {if (File) delete File;
+                                free(Lfn1);
+                                if (Lfn2) free(Lfn2);
+                               }
+private:
+
+void                Step(XrdCl::XRootDStatus xStat);
+
+XrdCnsLogClient    *Client;
+XrdCl::File        *File;
+XrdCl::XRootDStatus fStat;
+int                 fStep;
+};
+
+/******************************************************************************/
+/*                        H a n d l e R e s p o n s e                         */
+/******************************************************************************/
+  
+void XrdCnsLogOp::HandleResponse(XrdCl::XRootDStatus *sP, XrdCl::AnyObject *rP)
+{
+   XrdCl::XRootDStatus xStat(*sP);
+
+   delete sP;
+   if (rP) delete rP;
+   Step(xStat);
+}
+
+/******************************************************************************/
+/*                                  N a m e                                   */
+/******************************************************************************/
+  
+const char *XrdCnsLogOp::Name()
+{
+   switch(Type)
+         {case XrdCnsLogRec::lrClosew: return "trunc";
+          case XrdCnsLogRec::lrMkdir:  return "mkdir";
+          case XrdCnsLogRec::lrMv:     return "mv";
+          case XrdCnsLogRec::lrRm:     return "rm";
+          case XrdCnsLogRec::lrRmdir:  return "rmdir";
+          default:                     return "create";
+         }
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+  
+void XrdCnsLogOp::Start(XrdCnsLogClient *cP, const char *Url, int Mode)
+{
+   static const XrdCl::Access::Mode dMode = XrdCl::Access::UR
+                  | XrdCl::Access::UW | XrdCl::Access::UX | XrdCl::Access::GR
+                  | XrdCl::Access::GW | XrdCl::Access::GX | XrdCl::Access::OR
+                  | XrdCl::Access::OX;
+   static const XrdCl::OpenFlags::Flags oFlags = XrdCl::OpenFlags::Update
+                  | XrdCl::OpenFlags::Delete | XrdCl::OpenFlags::MakePath;
+   XrdCl::FileSystem *fsP = cP->Admin;
+   XrdCl::XRootDStatus xStat;
+
+// Issue the first (typically the only) step of the request
+//
+   Client = cP;
+   switch(Type)
+         {case XrdCnsLogRec::lrClosew: xStat = fsP->Truncate(Lfn1,Size,this);
+                                       break;
+          case XrdCnsLogRec::lrMkdir:  xStat = fsP->MkDir(Lfn1,
+                                               XrdCl::MkDirFlags::MakePath,
+                                               dMode, this);
+                                       break;
+          case XrdCnsLogRec::lrMv:     xStat = fsP->Mv(Lfn1, Lfn2, this);
+                                       break;
+          case XrdCnsLogRec::lrRm:     xStat = fsP->Rm(Lfn1, this);
+                                       break;
+          case XrdCnsLogRec::lrRmdir:  xStat = fsP->RmDir(Lfn1, this);
+                                       break;
+          default: File  = new XrdCl::File();
+                   xStat = File->Open(Url, oFlags,
+                                      static_cast<XrdCl::Access::Mode>(Mode),
+                                      this);
+                   break;
+         }
+
+// If the request could not be sent the handler will not be called
+//
+   if (!xStat.IsOK()) Client->Done(this, xStat);
+}
+
+/******************************************************************************/
+/* Private:                         S t e p                                   */
+/******************************************************************************/
+  
+void XrdCnsLogOp::Step(XrdCl::XRootDStatus xStat)
+{
+
+// Anything other than a create is done with the first response as is a create
+// whose open failed. Otherwise, truncate the file if need be and close it
+// (the first failure is the one reported).
+//
+   do {if (!File || fStep >= 2 || (!fStep && !xStat.IsOK()))
+          {Client->Done(this, (fStat.IsOK() ? xStat : fStat)); return;}
+       if (!xStat.IsOK()) fStat = xStat;
+       if (!fStep++ && Size >= 0) xStat = File->Truncate(Size, this);
+          else {fStep = 2; xStat = File->Close(this);}
+      } while(!xStat.IsOK());
+}
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
   
 XrdCnsLogClient::XrdCnsLogClient(XrdOucTList     *rP,
-                                 XrdCnsLogClient *pClient) : lfSem(0)
+                                 XrdCnsLogClient *pClient)
+                                : lfSem(0), opCond(0), opBusy(0), opNum(0),
+                                  opMax(Config.wLim), opHWM(0), opSync(0),
+                                  stDone(0), stFail(0), stLagSum(0),
+                                  stLagNum(0), stLagMax(0), stTime(time(0))
 {
    static int cNum = 0;
    static int bSfx = static_cast<int>(time(0)) - 1248126834;
@@ -110,11 +260,10 @@ XrdCnsLogClient::XrdCnsLogClient(XrdOucTList     *rP,
 //
    crtFN = crtURL + sprintf(crtURL, "root://%s/", urlHost);
 
-// Estalish the admin URL
+// Estalish the admin object (it connects when first used)
 //
-   sprintf(destBuff, "root://%s//tmp", urlHost);
-   admURL = strdup(destBuff);
-   Admin = 0;
+   sprintf(destBuff, "root://%s", urlHost);
+   Admin = new XrdCl::FileSystem(XrdCl::URL(destBuff));
 
 // Establish the backup operation processing
 //
@@ -233,7 +382,7 @@ int XrdCnsLogClient::Run(int Always)
    XrdCnsLogRec  *lrP;
    char invDir[MAXPATHLEN+1], *invFN = invDir;
    time_t mCheck = time(0) - 10;
-   int n, Ok = 0;
+   int n;
 
 // This may be a one time excution to recreate the name space (with out
 // without an inventory). Check if this is the case.
@@ -242,9 +391,12 @@ int XrdCnsLogClient::Run(int Always)
 
 // Process requests as they come in. We are always assured that we have at
 // least one log file in the chain of log files. Note that log records
-// returned by CnsLogFile are *not* recycleable!
+// returned by CnsLogFile are *not* recycleable! The records are shipped as
+// asynchronous requests (see Ship()) that commit the record when they succeed.
+// Mount, space and inventory directory records only establish context for the
+// following records and must be replayed after a restart; so never commit them.
 //
-   Admin = admConnect(Admin);
+   admConnect();
 
 do{if (arkFN && time(0) >= mCheck)
       {if (!Manifest())
@@ -265,20 +417,19 @@ do{if (arkFN && time(0) >= mCheck)
             {if (arkOnly) continue;
              TRACE(DEBUG, urlHost <<" log data: '" <<lrP->Data() <<"'");
              switch (lrP->Type())
-                    {case XrdCnsLogRec::lrClosew: Ok = do_Trunc (lrP); break;
-                     case XrdCnsLogRec::lrCreate: Ok = do_Create(lrP); break;
+                    {case XrdCnsLogRec::lrClosew:
+                     case XrdCnsLogRec::lrCreate:
+                     case XrdCnsLogRec::lrMkdir:
+                     case XrdCnsLogRec::lrMv:
+                     case XrdCnsLogRec::lrRm:
+                     case XrdCnsLogRec::lrRmdir:  Ship(lfP, lrP);      break;
                      case XrdCnsLogRec::lrInvD:   strcpy(invDir, lrP->Lfn1(n));
-                                                  invFN = invDir+n; Ok = 0;
+                                                  invFN = invDir+n;
                                                   *invFN++ = '/';
                                                   break;
                      case XrdCnsLogRec::lrInvF:   strcpy(invFN, lrP->Lfn1());
-                                        if ((Ok = do_Create(lrP, invDir)))
-                                             Ok = do_Trunc( lrP, invDir);
+                                                  Ship(lfP, lrP, invDir);
                                                   break;
-                     case XrdCnsLogRec::lrMkdir:  Ok = do_Mkdir (lrP); break;
-                     case XrdCnsLogRec::lrMv:     Ok = do_Mv    (lrP); break;
-                     case XrdCnsLogRec::lrRm:     Ok = do_Rm    (lrP); break;
-                     case XrdCnsLogRec::lrRmdir:  Ok = do_Rmdir (lrP); break;
                      case XrdCnsLogRec::lrMount:
                      case XrdCnsLogRec::lrSpace:
                           if (Config.Space)
@@ -286,10 +437,10 @@ do{if (arkFN && time(0) >= mCheck)
                                                                        break;
                      case XrdCnsLogRec::lrTOD:                         break;
                      default: MLog.Emsg("Run","Invalid logrec for",lrP->Lfn1());
-                              Ok = 0;
                     }
-             if (Ok) lfP->Commit();
             }
+       Drain(lfP);
+       Report();
        if (!arkFN || Archive(lfP)) lfP->Unlink();
        delete lfP;
       }
@@ -341,32 +492,18 @@ int XrdCnsLogClient::Start()
 /*                            a d m C o n n e c t                             */
 /******************************************************************************/
 
-XrdClientAdmin *XrdCnsLogClient::admConnect(XrdClientAdmin *adminP)
+void XrdCnsLogClient::admConnect()
 {
    const char *TraceID = "admConnect";
-   static XrdSysMutex xcMutex;
+   XrdCl::XRootDStatus xStat;
 
-// If we have a previous instance of the admin, delete it
-//
-   if (adminP) delete adminP;
-
-// Get a new admin
-//
-   xcMutex.Lock();
-   adminP = new XrdClientAdmin(admURL);
-   xcMutex.UnLock();
-
-// Loop until connected
+// Loop until the name space server responds
 //
    do {TRACE(DEBUG, "Connecting to " <<urlHost);
-       if (adminP->Connect()) break;
-       xrdEmsg("connect", admURL, adminP);
+       if ((xStat = Admin->Ping()).IsOK()) break;
+       xrdEmsg("connect to", urlHost, xStat);
        XrdSysTimer::Snooze(20);
       } while (1);
-
-// All done
-//
-   return adminP;
 }
 
 /******************************************************************************/
@@ -375,9 +512,13 @@ XrdClientAdmin *XrdCnsLogClient::admConnect(XrdClientAdmin *adminP)
   
 int XrdCnsLogClient::Archive(XrdCnsLogFile *lfP)
 {
-   static const int OMode = kXR_open_updt | kXR_delete | kXR_mkpath;
-   static const int AMode = kXR_ur | kXR_uw | kXR_gr | kXR_gw | kXR_or;
-   XrdClient *fP;
+   static const XrdCl::OpenFlags::Flags OMode = XrdCl::OpenFlags::Update
+                  | XrdCl::OpenFlags::Delete | XrdCl::OpenFlags::MakePath;
+   static const XrdCl::Access::Mode AMode = XrdCl::Access::UR
+                  | XrdCl::Access::UW | XrdCl::Access::GR | XrdCl::Access::GW
+                  | XrdCl::Access::OR;
+   XrdCl::XRootDStatus xStat;
+   XrdCl::File arkFile;
    int   Blen, rc = 1;
    const char *lFN;
    char *oP, oldName[2048], *Buff = lfP->getLog(Blen);
@@ -393,124 +534,125 @@ int XrdCnsLogClient::Archive(XrdCnsLogFile *lfP)
        return 0;
       } else lFN++;
 
-// Get a client instance
+// Construct the temporary name
 //
    strcpy(arkFN, lFN);
    MLog.Emsg("Archive", "Creating backup", arkURL);
    *arkFN = '.';
-   fP = new XrdClient(arkURL);
 
 // Open the target file and write out the log and close the file
 //
-   if (!fP->Open(AMode, OMode, 0) || (fP->LastServerResp()->status) != kXR_ok)
-      xrdEmsg("archive", lfP->FName(), fP);
-      else if (Buff && Blen && !fP->Write(Buff, 0, Blen))
-              xrdEmsg("write", lfP->FName(), fP);
+   if (!(xStat = arkFile.Open(arkURL, OMode, AMode)).IsOK())
+      xrdEmsg("archive", lfP->FName(), xStat);
+      else if (Buff && Blen
+           &&  !(xStat = arkFile.Write(0, Blen, Buff)).IsOK())
+              xrdEmsg("write", lfP->FName(), xStat);
+      else if (!(xStat = arkFile.Close()).IsOK())
+              xrdEmsg("close", lfP->FName(), xStat);
               else rc = 0;
 
 // Rename the file to what it really should be
 //
-   delete fP;
    strcpy(oldName, arkURL); *arkFN = (*lFN == 'i' ? 'I' : *lFN);
    oP = oldName + (arkPath - arkURL);
-   if (!Admin->Mv(oP, arkPath))
-      {xrdEmsg("rename", oldName, Admin); Admin->Rm(oP);  rc = 1;}
+   if (!(xStat = Admin->Mv(oP, arkPath)).IsOK())
+      {xrdEmsg("rename", oldName, xStat); xStat = Admin->Rm(oP);  rc = 1;}
    
    return rc == 0;
 }
-  
+
 /******************************************************************************/
-/*                             d o _ C r e a t e                              */
+/*                              C o n f l i c t                               */
 /******************************************************************************/
-  
-int XrdCnsLogClient::do_Create(XrdCnsLogRec *lrP, const char *lfn)
-{
-   static const int OMode = kXR_open_updt | kXR_delete | kXR_mkpath;
-   XrdClient *fP;
-   int AMode = kXR_ur | kXR_uw;
-   int CMode, Ok = 1;
-
-// Construct the Mode
-//
-   CMode = lrP->Mode();
-   if (CMode & S_IRGRP) AMode |= kXR_gr;
-   if (CMode & S_IWGRP) AMode |= kXR_gw;
-   if (CMode & S_IROTH) AMode |= kXR_or;
-
-// Get a client instance
-//
-   if (!lfn) strcpy(crtFN, lrP->Lfn1());
-      else {strcpy(crtFN, lfn);
-            if (Config.Space)
-               {char *spName = Config.Space->Key(lrP->Space());
-                if (spName && strcmp(spName, "public"))
-                   {strcat(crtFN, "?oss.cgroup="); strcat(crtFN, spName);}
-               }
-           }
-   fP = new XrdClient(crtURL);
 
-// Open the target file and write out the log
+// Two paths overlap when they are the same or one is a directory holding the
+// other one.
 //
-   if (!fP->Open(AMode, OMode, 0) || (fP->LastServerResp()->status) != kXR_ok)
-      Ok = xrdEmsg("create", lrP->Lfn1(), fP);
+namespace
+{
+int Overlap(const char *p1, const char *p2)
+{
+   int i = 0;
 
-// Finish up
-//
-   delete fP;
-   return Ok;
+   while(p1[i] && p1[i] == p2[i]) i++;
+   if (!p1[i]) return !p2[i] || p2[i] == '/' || (i && p1[i-1] == '/');
+   if (!p2[i]) return p1[i] == '/' || (i && p2[i-1] == '/');
+   return 0;
 }
-  
-/******************************************************************************/
-/*                              d o _ M k d i r                               */
-/******************************************************************************/
-  
-int XrdCnsLogClient::do_Mkdir(XrdCnsLogRec *lrP)
-{
-   if (!Admin->Mkdir(lrP->Lfn1(), 7, 7, 5))
-      return xrdEmsg("mkdir", lrP->Lfn1());
-   return 1;
 }
-
-/******************************************************************************/
-/*                                 d o _ M v                                  */
-/******************************************************************************/
   
-int XrdCnsLogClient::do_Mv(XrdCnsLogRec *lrP)
+int XrdCnsLogClient::Conflict(const char *Path)
 {
-   if (!Admin->Mv(lrP->Lfn1(), lrP->Lfn2()))
-      return xrdEmsg("mv", lrP->Lfn1());
-   return 1;
-}
+   XrdCnsLogOp *opP = opBusy;
 
-/******************************************************************************/
-/*                                 d o _ R m                                  */
-/******************************************************************************/
-  
-int XrdCnsLogClient::do_Rm(XrdCnsLogRec *lrP)
-{
-   if (!Admin->Rm(lrP->Lfn1())) return xrdEmsg("rm", lrP->Lfn1());
-   return 1;
+// Check if any request in flight overlaps with the path (caller has opCond)
+//
+   while(opP)
+        {if (Overlap(Path, opP->Lfn1)
+         ||  (opP->Lfn2 && Overlap(Path, opP->Lfn2))) return 1;
+         opP = opP->Next;
+        }
+   return 0;
 }
 
 /******************************************************************************/
-/*                              d o _ R m d i r                               */
+/*                                  D o n e                                   */
 /******************************************************************************/
   
-int XrdCnsLogClient::do_Rmdir(XrdCnsLogRec *lrP)
+void XrdCnsLogClient::Done(XrdCnsLogOp *opP, const XrdCl::XRootDStatus &Stat)
 {
-   if (!Admin->Rmdir(lrP->Lfn1())) return xrdEmsg("rmdir", lrP->Lfn1());
-   return 1;
+   XrdCnsLogOp *pP = 0, *xP;
+   int lag, Ok = Stat.IsOK();
+
+// Report the failure, if any
+//
+   if (!Ok) xrdEmsg(opP->Name(), opP->Lfn1, Stat);
+
+// Commit the record of a successful request. The log file is synced only
+// every so often; after a crash a few requests may be sent again.
+//
+   opCond.Lock();
+   if (Ok)
+      {if (++opSync >= 32) opSync = 0;
+       opP->LogF->Commit(opP->recOff, !opSync);
+      }
+
+// Account for the request
+//
+   stDone++;
+   if (!Ok) stFail++;
+   if (opP->Qtime)
+      {if ((lag = static_cast<int>(time(0) - opP->Qtime)) < 0) lag = 0;
+       stLagSum += lag; stLagNum++;
+       if (lag > stLagMax) stLagMax = lag;
+      }
+
+// Remove it from the requests in flight and let the log reader proceed
+//
+   xP = opBusy;
+   while(xP && xP != opP) {pP = xP; xP = xP->Next;}
+   if (xP) {if (pP) pP->Next = opP->Next;
+               else opBusy   = opP->Next;
+           }
+   opNum--;
+   opCond.Signal();
+   opCond.UnLock();
+   delete opP;
 }
 
 /******************************************************************************/
-/*                              d o _ T r u n c                               */
+/*                                 D r a i n                                  */
 /******************************************************************************/
   
-int XrdCnsLogClient::do_Trunc(XrdCnsLogRec *lrP, const char *lfn)
+void XrdCnsLogClient::Drain(XrdCnsLogFile *lfP)
 {
-   if (!Admin->Truncate((lfn ? lfn : lrP->Lfn1()), lrP->Size()))
-      return xrdEmsg("trunc", (lfn ? lfn : lrP->Lfn1()));
-   return 1;
+
+// Wait for all of the requests in flight to complete and sync the commits
+//
+   opCond.Lock();
+   while(opNum) opCond.Wait();
+   if (opSync) {lfP->Sync(); opSync = 0;}
+   opCond.UnLock();
 }
 
 /******************************************************************************/
@@ -524,8 +666,8 @@ int XrdCnsLogClient::Manifest()
    
    XrdCnsLogFile *lfP;
    XrdOucTList *xP;
-   long long vSize;
-   long V1, V2, V3;
+   XrdCl::XRootDStatus xStat;
+   XrdCl::StatInfo *sP = 0;
    char oldName[MAXPATHLEN+1];
 
 // Check if we will be processing an inventory log file
@@ -542,9 +684,11 @@ int XrdCnsLogClient::Manifest()
 //
    if (arkFN)
       {strcpy(arkFN, XrdCnsLog::invFNz);
-       if (Admin->Stat(arkPath, V1, vSize, V2, V3)) return 1;
-       if (Admin->LastServerError()->errnum != kXR_NotFound)
-          {xrdEmsg("find inventory", arkPath, Admin); return 0;}
+       xStat = Admin->Stat(arkPath, sP);
+       if (sP) delete sP;
+       if (xStat.IsOK()) return 1;
+       if (xStat.code != XrdCl::errErrorResponse || xStat.errNo != kXR_NotFound)
+          {xrdEmsg("find inventory", arkPath, xStat); return 0;}
        TRACE(DEBUG, "Creating inventory...");
       }
 
@@ -611,35 +755,100 @@ int XrdCnsLogClient::mapError(int rc)
 }
   
 /******************************************************************************/
-/*                               x r d E m s g                                */
+/*                                R e p o r t                                 */
 /******************************************************************************/
-
-int XrdCnsLogClient::xrdEmsg(const char *Opname, const char *theFN,
-                             XrdClientAdmin *aP)
+  
+void XrdCnsLogClient::Report()
 {
-   char *etext  =  aP->LastServerError()->errmsg;
-   int rc=mapError(aP->LastServerError()->errnum);
+   char buff[256], lBuff[80];
+   time_t Now = time(0);
+
+// Tell how well we are keeping up with the name space events
+//
+   opCond.Lock();
+   if (stDone)
+      {if (!stLagNum) strcpy(lBuff, "unknown");
+          else snprintf(lBuff, sizeof(lBuff), "avg %lld max %d seconds",
+                        stLagSum/stLagNum, stLagMax);
+       snprintf(buff, sizeof(buff), "%lld requests (%lld failed) in %d "
+                "seconds; at most %d in flight; lag %s.", stDone, stFail,
+                static_cast<int>(Now - stTime), opHWM, lBuff);
+       MLog.Emsg("LogClient", urlHost, buff);
+      }
 
-   if (rc == ECANCELED && etext && *etext) MLog.Emsg("LogClient", etext);
-      else MLog.Emsg("LogClient", rc, Opname, theFN);
-   return 0;
+// Reset the statistics
+//
+   stDone = stFail = stLagSum = stLagNum = 0;
+   stLagMax = opHWM = 0;
+   stTime = Now;
+   opCond.UnLock();
 }
 
 /******************************************************************************/
-
-int XrdCnsLogClient::xrdEmsg(const char *Opname, const char *theFN)
+/*                                  S h i p                                   */
+/******************************************************************************/
+  
+void XrdCnsLogClient::Ship(XrdCnsLogFile *lfP, XrdCnsLogRec *lrP,
+                           const char *lfn)
 {
-   return xrdEmsg(Opname, theFN, Admin);
-}
+   XrdCnsLogOp *opP = new XrdCnsLogOp(lfP, lrP, lfn);
+   int CMode, AMode = 0;
+
+// Creates need the url and the access mode
+//
+   if (lrP->Type() == XrdCnsLogRec::lrCreate
+   ||  lrP->Type() == XrdCnsLogRec::lrInvF)
+      {CMode = lrP->Mode();
+       AMode = kXR_ur | kXR_uw;
+       if (CMode & S_IRGRP) AMode |= kXR_gr;
+       if (CMode & S_IWGRP) AMode |= kXR_gw;
+       if (CMode & S_IROTH) AMode |= kXR_or;
+       if (!lfn) strcpy(crtFN, lrP->Lfn1());
+          else {strcpy(crtFN, lfn);
+                if (Config.Space)
+                   {char *spName = Config.Space->Key(lrP->Space());
+                    if (spName && strcmp(spName, "public"))
+                       {strcat(crtFN, "?oss.cgroup="); strcat(crtFN, spName);}
+                   }
+               }
+      }
 
+// Wait until the request may be sent. Requests on the same path, or on a path
+// in a directory being worked on, must be done in log order; so the request
+// waits for any such request that is still in flight.
+//
+   opCond.Lock();
+   while(opNum >= opMax || Conflict(opP->Lfn1)
+   ||    (opP->Lfn2 && Conflict(opP->Lfn2))) opCond.Wait();
+   opP->Next = opBusy; opBusy = opP;
+   if (++opNum > opHWM) opHWM = opNum;
+   opCond.UnLock();
+
+// Send it off
+//
+   opP->Start(this, crtURL, AMode);
+}
+  
+/******************************************************************************/
+/*                               x r d E m s g                                */
 /******************************************************************************/
 
-int XrdCnsLogClient::xrdEmsg(const char *Opn, const char *Fn, XrdClient *fP)
+int XrdCnsLogClient::xrdEmsg(const char *Opname, const char *theFN,
+                             const XrdCl::XRootDStatus &Stat)
 {
-   char *etext  =  fP->LastServerError()->errmsg;
-   int rc=mapError(fP->LastServerError()->errnum);
+   char buff[1024];
+   int rc;
 
-   if (rc == ECANCELED && etext && *etext) MLog.Emsg("LogClient", etext);
-      else MLog.Emsg("LogClient", rc, Opn, Fn);
+// Server errors are reported as before, anything else is a client error
+//
+   if (Stat.code == XrdCl::errErrorResponse)
+      {rc = mapError(Stat.errNo);
+       if (rc == ECANCELED && !Stat.GetErrorMessage().empty())
+          MLog.Emsg("LogClient", Stat.GetErrorMessage().c_str());
+          else MLog.Emsg("LogClient", rc, Opname, theFN);
+      } else {
+       snprintf(buff, sizeof(buff), "%s; %s", theFN, Stat.ToString().c_str());
+       MLog.Emsg("LogClient", "Unable to", Opname, buff);
+      }
    return 0;
 }
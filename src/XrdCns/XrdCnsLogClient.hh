@@ -31,18 +31,25 @@
 /******************************************************************************/
 
 #include <sys/param.h>
+#include <time.h>
   
 #include "XrdSys/XrdSysPthread.hh"
 
-class XrdClient;
-class XrdClientAdmin;
+namespace XrdCl
+{
+class FileSystem;
+class XRootDStatus;
+}
+
 class XrdCnsLogFile;
+class XrdCnsLogOp;
 class XrdCnsLogRec;
 class XrdCnsXref;
 class XrdOucTList;
 
 class XrdCnsLogClient
 {
+friend class XrdCnsLogOp;
 public:
 
 int   Activate(XrdCnsLogFile *basefile);
@@ -57,36 +64,48 @@ int   Start();
      ~XrdCnsLogClient() {}
 
 private:
-XrdClientAdmin *admConnect(XrdClientAdmin *adminP);
+void admConnect();
 
 int  Archive(XrdCnsLogFile *lfP);
-int  do_Create(XrdCnsLogRec *lrP, const char *lfn=0);
-int  do_Mkdir(XrdCnsLogRec *lrP);
-int  do_Mv(XrdCnsLogRec *lrP);
-int  do_Rm(XrdCnsLogRec *lrP);
-int  do_Rmdir(XrdCnsLogRec *lrP);
-int  do_Trunc(XrdCnsLogRec *lrP, const char *lfn=0);
+int  Conflict(const char *Path);
+void Done(XrdCnsLogOp *opP, const XrdCl::XRootDStatus &Stat);
+void Drain(XrdCnsLogFile *lfP);
 char getMount(char *Lfn, char *Pfn, XrdCnsXref &Mount);
 int  Inventory(XrdCnsLogFile *lfp, const char *dPath);
 int  Manifest();
 int  mapError(int rc);
-int  xrdEmsg(const char *Opname, const char *theFN, XrdClientAdmin *aP);
-int  xrdEmsg(const char *Opname, const char *theFN);
-int  xrdEmsg(const char *Opname, const char *theFN, XrdClient *fP);
+void Report();
+void Ship(XrdCnsLogFile *lfP, XrdCnsLogRec *lrP, const char *lfn=0);
+int  xrdEmsg(const char *Opname, const char *theFN,
+             const XrdCl::XRootDStatus &Stat);
 
 XrdSysMutex      lfMutex;
 XrdSysSemaphore  lfSem;
 XrdCnsLogClient *Next;
-XrdClientAdmin  *Admin;
+XrdCl::FileSystem *Admin;
 
 XrdCnsLogFile   *logFirst;
 XrdCnsLogFile   *logLast;
 
+// The requests in flight to the name space (see Ship()) and their statistics
+//
+XrdSysCondVar    opCond;
+XrdCnsLogOp     *opBusy;
+int              opNum;
+int              opMax;
+int              opHWM;       // Most requests in flight since Report()
+int              opSync;      // Commits not yet synced to the log file
+long long        stDone;      // Requests completed since Report()
+long long        stFail;      // Requests that failed   since Report()
+long long        stLagSum;    // Total lag of the events with a known time
+long long        stLagNum;    // Number of such events
+int              stLagMax;
+time_t           stTime;      // Time of the last Report()
+
 int              pfxNF;
 int              sfxFN;
 int              arkOnly;
 
-char            *admURL;
 char            *urlHost;
 
 char             arkURL[MAXPATHLEN+512];
@@ -70,6 +70,7 @@ XrdCnsLogFile::~XrdCnsLogFile()
    if (logFD >= 0) close(logFD);
    if (logFN)      free(logFN);
    if (logBuff)    free(logBuff);
+   if (batBuff)    free(batBuff);
 }
 
 /******************************************************************************/
@@ -87,6 +88,14 @@ int XrdCnsLogFile::Add(XrdCnsLogRec *lrP, int doSync)
    bL = lrP->setLen() + XrdCnsLogRec::MinSize;
    bP = lrP->Record();
 
+// If we are batching, add the record to the batch and write it out when full
+//
+   if (batMax)
+      {if (batLen + bL > batMax && !Flush()) return 0;
+       memcpy(batBuff+batLen, bP, bL); batLen += bL; batNum++;
+       return 1;
+      }
+
 // Write out record
 //
    do {do {rc = write(logFD, bP, bL);} while (rc < 0 && errno == EINTR);
@@ -109,6 +118,25 @@ int XrdCnsLogFile::Add(XrdCnsLogRec *lrP, int doSync)
    return 1;
 }
 
+/******************************************************************************/
+/*                                 B a t c h                                  */
+/******************************************************************************/
+  
+void XrdCnsLogFile::Batch(int bsz)
+{
+// Make sure we can hold at least one record of any size
+//
+   if (bsz < XrdCnsLogRec::MinSize + XrdCnsLogRec::MaxSize)
+      bsz = XrdCnsLogRec::MinSize + XrdCnsLogRec::MaxSize;
+
+// Allocate the batch buffer
+//
+   Flush();
+   if (batBuff) free(batBuff);
+   batBuff = (char *)malloc(bsz);
+   batMax  = (batBuff ? bsz : 0);
+}
+
 /******************************************************************************/
 /*                                C o m m i t                                 */
 /******************************************************************************/
@@ -132,6 +160,24 @@ int XrdCnsLogFile::Commit()
    return 1;
 }
 
+/******************************************************************************/
+
+int XrdCnsLogFile::Commit(int recOff, int doSync)
+{
+   static char dVal = 1;
+   int dOffs = recOff + XrdCnsLogRec::OffDone + logRdr, rc;
+
+// Mark the record as done
+//
+   do {rc = pwrite(logFD, &dVal, 1, dOffs);} while(rc < 0 && errno == EINTR);
+   if (rc <= 0)
+      {MLog.Emsg("Commit", errno, "commit log rec in", logFN); return 0;}
+
+// Sync it if so wanted
+//
+   return (doSync ? Sync() : 1);
+}
+
 /******************************************************************************/
 /*                                   E o l                                    */
 /******************************************************************************/
@@ -143,6 +189,10 @@ int XrdCnsLogFile::Eol()
    int rc, bL = XrdCnsLogRec::MinSize + lRec.DLen();
    char *bP = (char *)&lRec;
 
+// Write out any records that are still in the batch
+//
+   Flush();
+
 // Write out record end of log record
 //
    do {do {rc = write(logFD, bP, bL);} while (rc < 0 && errno == EINTR);
@@ -167,6 +217,41 @@ int XrdCnsLogFile::Eol()
    return 1;
 }
 
+/******************************************************************************/
+/*                                 F l u s h                                  */
+/******************************************************************************/
+  
+int XrdCnsLogFile::Flush()
+{
+   XrdCnsLogFile *lfP;
+   char *bP = batBuff;
+   int   rc, bL = batLen;
+
+// Write out the batch, if any
+//
+   while(bL > 0)
+        {do {rc = write(logFD, bP, bL);} while (rc < 0 && errno == EINTR);
+         if (rc < 0) {MLog.Emsg("Flush", errno, "add log recs to", logFN);
+                      batLen = batNum = 0;
+                      return 0;
+                     }
+         bP += rc; bL -= rc;
+        }
+
+// Notify all subscribers, once for each record
+//
+   while(batNum)
+        {lfP = subNext;
+         while(lfP) {lfP->logSem.Post(); lfP = lfP->subNext;}
+         batNum--;
+        }
+
+// All done
+//
+   batLen = 0;
+   return 1;
+}
+
 /******************************************************************************/
 /*                                g e t R e c                                 */
 /******************************************************************************/
@@ -287,6 +372,17 @@ XrdCnsLogFile *XrdCnsLogFile::Subscribe(const char *Path, int cNum)
    return lfP;
 }
 
+/******************************************************************************/
+/*                                  S y n c                                   */
+/******************************************************************************/
+  
+int XrdCnsLogFile::Sync()
+{
+   if (fdatasync(logFD))
+      {MLog.Emsg("Sync", errno, "fsync log", logFN); return 0;}
+   return 1;
+}
+
 /******************************************************************************/
 /*                                U n l i n k                                 */
 /******************************************************************************/
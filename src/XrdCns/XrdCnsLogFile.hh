@@ -41,10 +41,22 @@ XrdCnsLogFile *Next;
 
 int            Add(XrdCnsLogRec *Rec, int doSync=1);
 
+// Batch() makes Add() collect up to bsz bytes of records and write them out
+// in one go; Flush() and Eol() write out whatever has been collected.
+//
+void           Batch(int bsz);
+
 int            Commit();
 
+// Commit the record that started at recOff (see recPos()) which need not be
+// the last one returned by getRec(). It may be called by any thread.
+//
+int            Commit(int recOff, int doSync=1);
+
 int            Eol();
 
+int            Flush();
+
 const char    *FName() {return logFN;}
 
 char          *getLog(int &Dlen) {Dlen = logNext-logBuff; return logBuff;}
@@ -57,15 +69,20 @@ static void    maxRecs(int nRecs) {logRMax = nRecs;
 
 int            Open(int aBuff=1, off_t thePos=0);
 
+int            recPos() {return recOffset;}
+
 XrdCnsLogFile *Subscribe(const char *Path, int cNum);
 
+int            Sync();
+
 int            Unlink();
 
                XrdCnsLogFile(const char *Path, int cnum=0, int Wait=1)
                             : Next(0), logSem(0), subNext(0),
                               logBuff(0),logNext(0), logFN(strdup(Path)),
                               logFD(-1), logRdr(cnum), logWait(Wait),
-                              logOffset(0), recOffset(0) {}
+                              logOffset(0), recOffset(0),
+                              batBuff(0), batLen(0), batMax(0), batNum(0) {}
               ~XrdCnsLogFile();
 
 private:
@@ -90,5 +107,9 @@ int                   logRdr;
 int                   logWait;
 int                   logOffset;
 int                   recOffset;
+char                 *batBuff;
+int                   batLen;
+int                   batMax;
+int                   batNum;
 };
 #endif
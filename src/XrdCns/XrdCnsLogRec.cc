@@ -116,6 +116,10 @@ XrdCnsLogRec *XrdCnsLogRec::Get(char &lrType)
 void XrdCnsLogRec::Queue()
 {
 
+// Record when the event happened so that the log clients can tell their lag
+//
+   Rec.Hdr.Qtime = static_cast<int>(time(0) - tBase);
+
 // Put request on the queue
 //
    qMutex.Lock();
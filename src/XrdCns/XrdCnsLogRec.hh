@@ -52,7 +52,7 @@ struct Ctl
        short     lfn2Len;           // strlen(lfn2)
        short     Mode;              // File mode (create and mkdir)
        char      Done[maxClients];  // 1->Record processed
-       int       Rsvd;              // Reserved field
+       int       Qtime;             // Time queued - tBase (0 if unknown)
        long long Size;              // Valid when Closew
       };
 
@@ -113,6 +113,8 @@ inline mode_t        Mode() {return static_cast<mode_t>(Rec.Hdr.Mode);}
 
        void          Queue();
 
+inline long          Qtime() {return (Rec.Hdr.Qtime ? Rec.Hdr.Qtime+tBase : 0);}
+
        void          Recycle();
 
 inline char         *Record() {return (char *)&Rec;}
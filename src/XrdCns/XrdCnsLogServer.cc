@@ -81,7 +81,7 @@ void *StartLogServer(void *parg)
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
   
-XrdCnsLogServer::XrdCnsLogServer()
+XrdCnsLogServer::XrdCnsLogServer() : Client(0), logFile(0)
 {
 // Construct our logfile path
 //
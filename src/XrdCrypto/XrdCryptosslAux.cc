@@ -547,8 +547,14 @@ int XrdCryptosslX509ParseBucket(XrdSutBucket *b, XrdCryptoX509Chain *chain)
    // If we found something, and we are asked to extract a key,
    // refill the BIO and search again for the key (this is mandatory
    // as read operations modify the BIO contents; a read-only BIO
-   // may be more efficient)
-   if (nci && BIO_write(bmem,(const void *)(b->buffer),b->size) == b->size) {
+   // may be more efficient). Failing to decode a key is expensive,
+   // so only try if there is one (certificates sent by peers have none).
+   static const char keytag[] = "PRIVATE KEY-----";
+   bool haskey = 0;
+   for (int i = 0; !haskey && i <= b->size - (int)sizeof(keytag) + 1; i++)
+      haskey = !memcmp(b->buffer + i, keytag, sizeof(keytag) - 1);
+   if (nci && haskey &&
+       BIO_write(bmem,(const void *)(b->buffer),b->size) == b->size) {
       RSA  *rsap = 0;
       if (!PEM_read_bio_RSAPrivateKey(bmem, &rsap, 0, 0)) {
          DEBUG("no RSA private key found in bucket ");
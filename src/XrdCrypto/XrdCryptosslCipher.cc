@@ -34,6 +34,8 @@
 #include <string.h>
 
 #include "XrdSut/XrdSutRndm.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysTimer.hh"
 #include "XrdCrypto/XrdCryptosslTrace.hh"
 #include "XrdCrypto/XrdCryptosslCipher.hh"
 
@@ -112,6 +114,12 @@ static int DH_set0_key(DH *dh, BIGNUM *pub_key, BIGNUM *priv_key)
     return 1;
 }
 
+static int DH_set_length(DH *dh, long length)
+{
+    dh->length = length;
+    return 1;
+}
+
 static int DSA_set0_key(DSA *d, BIGNUM *pub_key, BIGNUM *priv_key)
 {
     /* If the field pub_key in d is NULL, the corresponding input
@@ -132,6 +140,148 @@ static int DSA_set0_key(DSA *d, BIGNUM *pub_key, BIGNUM *priv_key)
 }
 #endif
 
+// ---------------------------------------------------------------------------//
+//
+// Key agreement group
+//
+// Generating DH parameters takes seconds for a reasonable size, so requests
+// for up to kDHFIXBITS use this 2048 bits safe prime with generator 5 instead
+// (the generator used when generating). Being known, it does not need to be
+// checked when received from the counterpart. On the side offering the group
+// (i.e. servers) keys for it are generated ahead of time by a background
+// thread; a forked child starts its own, the keys of the parent are dropped.
+//
+// ---------------------------------------------------------------------------//
+
+static const char *dhFixedPEM =
+"-----BEGIN DH PARAMETERS-----\n"
+"MIIBCAKCAQEAgPh26j0XLcojUoevBlO4FimUzSQLbGt/ZXbDq+4S7COprIYkuNca\n"
+"84arXDkapqi/vUXEmFC7rT92hlEyON9fVlO72KWzwxTSEONwYUXtn+bXUv4Q/JxK\n"
+"U6s3gINHZgFr/5FugfaMcxbOQaUgNstt8VRW3QCQOLRGXnLoG7/9+BNrPCUozK3l\n"
+"7COFWk9HKlp6BmAvq6XSFcwPOY6VevA0QXV1c0CxJlqSqxADn25sB6rlOG9yy1RR\n"
+"kHW8PxqDoFY7kimLGKLAh3/QU/7yRYT+GT+A14nVsxvXT2SoroKVqxabFCeOqA2U\n"
+"j98a4e7OSBo9hQ4jsaW25cbag0bTGinTQwIBBQ==\n"
+"-----END DH PARAMETERS-----\n";
+
+// Never destroyed: the filler thread waits on it until the process ends
+static XrdSysCondVar &dhPoolCond = *new XrdSysCondVar(0, "DH key pool");
+static DH   *dhFixed = 0;
+static DH   *dhPool[kDHPOOLSIZE];
+static int   dhPoolNum = 0;
+static bool  dhPoolRun = 0;
+
+//_____________________________________________________________________________
+static DH *DHFixedGroup()
+{
+   // Return the fixed group, reading it the first time
+
+   XrdSysCondVarHelper cHelp(dhPoolCond);
+   if (!dhFixed) {
+      BIO *biop = BIO_new_mem_buf((void *)dhFixedPEM, -1);
+      if (biop) {
+         dhFixed = PEM_read_bio_DHparams(biop, 0, 0, 0);
+         BIO_free(biop);
+      }
+   }
+   return dhFixed;
+}
+
+//_____________________________________________________________________________
+static bool DHIsFixedGroup(DH *dh)
+{
+   // Check if dh uses the fixed group
+
+   const BIGNUM *p, *g, *fp, *fg;
+   DH *fdh = DHFixedGroup();
+   if (!fdh || !dh) return 0;
+   DH_get0_pqg(dh, &p, NULL, &g);
+   DH_get0_pqg(fdh, &fp, NULL, &fg);
+   return (p && g && !BN_cmp(p, fp) && !BN_cmp(g, fg));
+}
+
+//_____________________________________________________________________________
+static DH *DHNewFixedKey()
+{
+   // Generate a key for the fixed group. The private exponent is
+   // kDHPRIVBITS long, plenty for the strength of the group.
+
+   const BIGNUM *p, *g;
+   DH *fdh = DHFixedGroup(), *dh = 0;
+   if (fdh && (dh = DH_new())) {
+      DH_get0_pqg(fdh, &p, NULL, &g);
+      if (!DH_set0_pqg(dh, BN_dup(p), NULL, BN_dup(g)) ||
+          !DH_set_length(dh, kDHPRIVBITS) || !DH_generate_key(dh)) {
+         DH_free(dh);
+         dh = 0;
+      }
+   }
+   return dh;
+}
+
+//_____________________________________________________________________________
+static void *DHPoolFill(void *)
+{
+   // Keep the pool of keys for the fixed group full
+
+   DH *dh;
+   while (1) {
+      dhPoolCond.Lock();
+      while (dhPoolNum >= kDHPOOLSIZE) dhPoolCond.Wait();
+      dhPoolCond.UnLock();
+      if (!(dh = DHNewFixedKey())) {
+         XrdSysTimer::Snooze(1);
+         continue;
+      }
+      dhPoolCond.Lock();
+      dhPool[dhPoolNum++] = dh;
+      dhPoolCond.UnLock();
+   }
+   return (void *)0;
+}
+
+//_____________________________________________________________________________
+extern "C"
+{
+static void DHPoolPrepare() {dhPoolCond.Lock();}
+
+static void DHPoolParent() {dhPoolCond.UnLock();}
+
+static void DHPoolChild()
+{
+   // The filler thread is not there and the keys must not be shared with
+   // the parent: empty the pool, it is restarted when needed
+
+   while (dhPoolNum > 0) DH_free(dhPool[--dhPoolNum]);
+   dhPoolRun = 0;
+   dhPoolCond.UnLock();
+}
+}
+
+//_____________________________________________________________________________
+static DH *DHFixedKey(bool start)
+{
+   // Get a key for the fixed group from the pool, starting the filler if
+   // requested; if the pool is empty (e.g. for a burst of handshakes or on
+   // the side just answering) generate it here
+
+   static bool atFork = 0;
+   DH *dh = 0;
+   dhPoolCond.Lock();
+   if (start && !dhPoolRun) {
+      pthread_t tid;
+      if (!atFork)
+         atFork = !pthread_atfork(DHPoolPrepare, DHPoolParent, DHPoolChild);
+      if (atFork)
+         dhPoolRun = !XrdSysThread::Run(&tid, DHPoolFill, (void *)0, 0,
+                                        "DH key pool");
+   }
+   if (dhPoolNum > 0) dh = dhPool[--dhPoolNum];
+   dhPoolCond.Signal();
+   dhPoolCond.UnLock();
+
+   return (dh ? dh : DHNewFixedKey());
+}
+
 //_____________________________________________________________________________
 bool XrdCryptosslCipher::IsSupported(const char *cip)
 {
@@ -459,9 +609,18 @@ XrdCryptosslCipher::XrdCryptosslCipher(int bits, char *pub,
       // at least 128 bits
       bits = (bits < kDHMINBITS) ? kDHMINBITS : bits;
       //
-      // Generate params for DH object
-      fDH = DH_new();
-      if (fDH && DH_generate_parameters_ex(fDH, bits, DH_GENERATOR_5, NULL)) {
+      // Up to kDHFIXBITS take a ready key for the fixed group
+      if (bits <= kDHFIXBITS) {
+         if ((fDH = DHFixedKey(1))) {
+            // Init context
+            ctx = EVP_CIPHER_CTX_new();
+            if (ctx)
+               valid = 1;
+         }
+      //
+      // Otherwise generate params for DH object
+      } else if ((fDH = DH_new()) &&
+                 DH_generate_parameters_ex(fDH, bits, DH_GENERATOR_5, NULL)) {
          int prc = 0;
          DH_check(fDH,&prc);
          if (prc == 0) {
@@ -507,19 +666,27 @@ XrdCryptosslCipher::XrdCryptosslCipher(int bits, char *pub,
                // Read parms from BIO
                PEM_read_bio_DHparams(biop,&fDH,0,0);
                int prc = 0;
-               DH_check(fDH,&prc);
-               if (prc == 0) {
+               bool gotkey = 0;
+               if (DHIsFixedGroup(fDH)) {
+                  //
+                  // Known group: take a ready key
+                  DH_free(fDH);
+                  gotkey = ((fDH = DHFixedKey(0)) != 0);
+               } else {
+                  DH_check(fDH,&prc);
                   //
                   // generate DH key
-                  if (DH_generate_key(fDH)) {
-                     // Now we can compute the cipher
-                     ktmp = new char[DH_size(fDH)];
-                     memset(ktmp, 0, DH_size(fDH));
-                     if (ktmp) {
-                        if ((ltmp = DH_compute_key((unsigned char *)ktmp,
-                                                    bnpub,fDH)) > 0)
-                           valid = 1;
-                     }
+                  if (prc == 0)
+                     gotkey = DH_generate_key(fDH);
+               }
+               if (fDH && gotkey) {
+                  // Now we can compute the cipher
+                  ktmp = new char[DH_size(fDH)];
+                  memset(ktmp, 0, DH_size(fDH));
+                  if (ktmp) {
+                     if ((ltmp = DH_compute_key((unsigned char *)ktmp,
+                                                 bnpub,fDH)) > 0)
+                        valid = 1;
                   }
                }
             }
@@ -604,10 +771,8 @@ XrdCryptosslCipher::XrdCryptosslCipher(const XrdCryptosslCipher &c)
          const BIGNUM *pub, *pri;
          DH_get0_key(c.fDH, &pub, &pri);
          DH_set0_key(fDH, pub ? BN_dup(pub) : NULL, pri ? BN_dup(pri) : NULL);
-         int dhrc = 0;
-         DH_check(fDH,&dhrc);
-         if (dhrc == 0)
-            valid = 1;
+         // The parameters were checked when the original was built
+         valid = 1;
       }
    }
    if (valid) {
@@ -40,6 +40,9 @@
 #include <openssl/dh.h>
 
 #define kDHMINBITS 128
+#define kDHFIXBITS 2048   // Up to this size the fixed group is used
+#define kDHPRIVBITS 256   // Private exponent size for the fixed group
+#define kDHPOOLSIZE 16    // Keys for the fixed group generated ahead
 
 // ---------------------------------------------------------------------------//
 //
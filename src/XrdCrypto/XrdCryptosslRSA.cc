@@ -62,6 +62,12 @@ static void RSA_get0_key(const RSA *r,
     if (d != NULL)
         *d = r->d;
 }
+
+static int EVP_PKEY_up_ref(EVP_PKEY *pkey)
+{
+    CRYPTO_add(&pkey->references, 1, CRYPTO_LOCK_EVP_PKEY);
+    return 1;
+}
 #endif
 
 //_____________________________________________________________________________
@@ -192,40 +198,12 @@ XrdCryptosslRSA::XrdCryptosslRSA(const XrdCryptosslRSA &r) : XrdCryptoRSA()
       return;
    }
 
-   // If the given key is set, copy it via a bio
-   const BIGNUM *d;
-   RSA_get0_key(EVP_PKEY_get0_RSA(r.fEVP), NULL, NULL, &d);
-   bool publiconly = (d == 0);
-   //
-   // Bio for exporting the pub key
-   BIO *bcpy = BIO_new(BIO_s_mem());
-   if (bcpy) {
-      bool ok;
-      if (publiconly) {
-        // Write kref public key to BIO
-        ok = (PEM_write_bio_PUBKEY(bcpy, r.fEVP) != 0);
-      } else {
-        // Write kref private key to BIO
-        ok = (PEM_write_bio_PrivateKey(bcpy,r.fEVP,0,0,0,0,0) != 0);
-      }
-      if (ok) {
-         if (publiconly) {
-            // Read public key from BIO
-            if ((fEVP = PEM_read_bio_PUBKEY(bcpy, 0, 0, 0))) {
-               status = kPublic;
-            }
-          } else {
-            if ((fEVP = PEM_read_bio_PrivateKey(bcpy,0,0,0))) {
-               // Check consistency
-               if (RSA_check_key(EVP_PKEY_get0_RSA(fEVP)) != 0) {
-                  // Update status
-                  status = kComplete;
-               }
-            }
-         }
-      }
-      // Cleanup bio
-      BIO_free(bcpy);
+   // Keys are never changed once set (imports replace them), so share the
+   // given one: it was checked when it was created and copying it via a bio
+   // and checking it again costs more than the handshake it is needed for
+   if (EVP_PKEY_up_ref(r.fEVP)) {
+      fEVP = r.fEVP;
+      status = r.status;
    }
 }
 
@@ -311,8 +289,12 @@ int XrdCryptosslRSA::ImportPrivate(const char *pri, int lpri)
    // Write key from private export to BIO
    BIO_write(bpri,(void *)pri,lpri);
 
-   // Read private key from BIO
-   if (PEM_read_bio_PrivateKey(bpri, &fEVP, 0, 0)) {
+   // Read private key from BIO into a new key, the current one may be shared
+   EVP_PKEY *keytmp = PEM_read_bio_PrivateKey(bpri, 0, 0, 0);
+   BIO_free(bpri);
+   if (keytmp) {
+      EVP_PKEY_free(fEVP);
+      fEVP = keytmp;
       // Update status
       status = kComplete;
       return 0;
@@ -28,6 +28,7 @@
 /******************************************************************************/
 
 #include "XrdFfs/XrdFfsDent.hh"
+#include "XrdOuc/XrdOucHash.hh"
 
 #ifdef __cplusplus
   extern "C" {
@@ -149,6 +150,8 @@ void XrdFfsDent_dentcache_fill(struct XrdFfsDentcache *cache, char *dname, char
     
     for (i = 0; i < nents; i++)
         cache->dnarray[i] = strdup((*dnarray)[i]);
+/* _search() uses bsearch(), but the names come in the order the data servers answered */
+    qsort(cache->dnarray, nents, sizeof(char*), XrdFfsDent_cstr_cmp);
 }
 
 void XrdFfsDent_dentcache_free(struct XrdFfsDentcache *cache)
@@ -265,6 +268,71 @@ void XrdFfsDent_cache_destroy()
         XrdFfsDent_dentcache_free(&XrdFfsDentCaches[i]);
 }
 
+/* 
+   managing the attribute cache. Entries are keyed by the path as seen by 
+   FUSE and expire after XrdFfsDentAttrLife seconds. They are filled by 
+   readdir (which asks the data servers for the stat info of all entries in
+   one request) and by getattr, and cleared by anything that changes a path.
+ */
+
+#define XrdFfsDent_MAXATTRS 262144  /* about 64MB worth of cached stat() */
+
+XrdOucHash<struct stat> XrdFfsDentAttrs;
+pthread_mutex_t XrdFfsDentAttrs_mutex = PTHREAD_MUTEX_INITIALIZER;
+int XrdFfsDentAttrLife = 0;
+
+void XrdFfsDent_attr_init(int life)
+{
+    XrdFfsDentAttrLife = (life > 0? life : 0);
+}
+
+int XrdFfsDent_attr_enabled()
+{
+    return (XrdFfsDentAttrLife > 0);
+}
+
+void XrdFfsDent_attr_fill(const char *path, const struct stat *stbuf)
+{
+    struct stat *st;
+
+    if (XrdFfsDentAttrLife == 0) return;
+
+    st = new struct stat;
+    memcpy(st, stbuf, sizeof(struct stat));
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+/* expired entries are only dropped when looked up, so start over if it gets too big */
+    if (XrdFfsDentAttrs.Num() >= XrdFfsDent_MAXATTRS)
+        XrdFfsDentAttrs.Purge();
+    XrdFfsDentAttrs.Rep(path, st, XrdFfsDentAttrLife);
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+}
+
+int XrdFfsDent_attr_search(const char *path, struct stat *stbuf)
+{
+    struct stat *st;
+    int rval = 0;
+
+    if (XrdFfsDentAttrLife == 0) return 0;
+
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+    if ((st = XrdFfsDentAttrs.Find(path)) != NULL)
+    {
+        memcpy(stbuf, st, sizeof(struct stat));
+        rval = 1;
+    }
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+    return rval;
+}
+
+void XrdFfsDent_attr_clear(const char *path)
+{
+    if (XrdFfsDentAttrLife == 0) return;
+
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+    XrdFfsDentAttrs.Del(path);
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+}
+
 /*
 #include <stdio.h>
 
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <pthread.h>
+#include <sys/stat.h>
 
 #ifdef __cplusplus
   extern "C" {
@@ -51,6 +52,16 @@ void XrdFfsDent_cache_destroy();
 int  XrdFfsDent_cache_fill(char *dname, char ***dnarray, int nents);
 int  XrdFfsDent_cache_search(char *dname, char *dentname);
 
+/*
+   attribute cache: stat() results of recently listed or stat'ed paths,
+   kept for "life" seconds. A life of 0 (the default) disables the cache.
+ */
+void XrdFfsDent_attr_init(int life);
+int  XrdFfsDent_attr_enabled();
+void XrdFfsDent_attr_fill(const char *path, const struct stat *stbuf);
+int  XrdFfsDent_attr_search(const char *path, struct stat *stbuf);
+void XrdFfsDent_attr_clear(const char *path);
+
 #ifdef __cplusplus
   }
 #endif
@@ -106,6 +106,7 @@ int XrdFfsFsinfo_cache_search(int (*func)(const char*, const char*, struct statv
         }   
         pthread_mutex_unlock(&XrdFfsFsinfo_cache_mutex_wr);
     }
+    else if (dofree) free(s);  // another thread is updating the cache, don't leak ours
     free(sname);
     return rc;
 } 
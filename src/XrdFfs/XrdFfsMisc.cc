@@ -187,7 +187,7 @@ int XrdFfsMisc_get_all_urls(const char *oldurl, char **newurls, const int nnodes
         XrdFfsMiscUrlcachetime = currtime;
         strcpy(XrdFfsMiscCururl, oldurl);
         XrdFfsMiscNcachedurls = XrdFfsMisc_get_all_urls_real(oldurl, XrdFfsMiscUrlcache, nnodes);
-        for (i = XrdFfsMiscNcachedurls; i < XrdFfs_MAX_NUM_NODES; i++)
+        for (i = (XrdFfsMiscNcachedurls > 0? XrdFfsMiscNcachedurls : 0); i < XrdFfs_MAX_NUM_NODES; i++)
             if (XrdFfsMiscUrlcache[i] != NULL) free(XrdFfsMiscUrlcache[i]);
     }
 
@@ -47,10 +47,13 @@
 #include <stdlib.h>
 #include <syslog.h>
 #include "XrdFfs/XrdFfsPosix.hh"
+#include "XrdPosix/XrdPosixAdmin.hh"
+#include "XrdPosix/XrdPosixMap.hh"
 #include "XrdPosix/XrdPosixXrootd.hh"
 #include "XrdFfs/XrdFfsMisc.hh"
 #include "XrdFfs/XrdFfsDent.hh"
 #include "XrdFfs/XrdFfsQueue.hh"
+#include "XrdOuc/XrdOucHash.hh"
 
 #ifdef __cplusplus
   extern "C" {
@@ -58,19 +61,24 @@
 
 #define MAXROOTURLLEN 1024 // this is also defined in other files
 
-int XrdFfsPosix_stat(const char *path, struct stat *buf)
+void XrdFfsPosix_fixmode(struct stat *buf)
 {
-    int rc; 
-    errno = 0;
-    rc = XrdPosixXrootd::Stat(path, buf);
-    if (rc == 0 && S_ISBLK(buf->st_mode)) /* If 'buf' come from HPSS, xrootd will return it as a block device! */
-    {                                     /* So we re-mark it to a regular file */
+    if (S_ISBLK(buf->st_mode))  /* If 'buf' come from HPSS, xrootd will return it as a block device! */
+    {                           /* So we re-mark it to a regular file */
         buf->st_mode &= 0007777;
         if ( buf->st_mode & S_IXUSR )
             buf->st_mode |= 0040000;   /* a directory */
         else
             buf->st_mode |= 0100000;   /* a file */
     }
+}
+
+int XrdFfsPosix_stat(const char *path, struct stat *buf)
+{
+    int rc; 
+    errno = 0;
+    rc = XrdPosixXrootd::Stat(path, buf);
+    if (rc == 0) XrdFfsPosix_fixmode(buf);
     return rc;
 }
 
@@ -253,7 +261,9 @@ int XrdFfsPosix_deleteall(const char *rdrurl, const char *path, uid_t user_uid,
     int res_i[XrdFfs_MAX_NUM_NODES];
     int errno_i[XrdFfs_MAX_NUM_NODES];
     struct XrdFfsPosixX_deleteall_args args[XrdFfs_MAX_NUM_NODES];
-    struct XrdFfsQueueTasks *jobs[XrdFfs_MAX_NUM_NODES];
+#ifndef NOUSE_QUEUE
+    struct XrdFfsQueueGroup *jobs;
+#endif
 
     nurls = XrdFfsMisc_get_all_urls(rdrurl, newurls, XrdFfs_MAX_NUM_NODES);
 
@@ -266,17 +276,17 @@ int XrdFfsPosix_deleteall(const char *rdrurl, const char *path, uid_t user_uid,
         args[i].err = &errno_i[i];
         args[i].res = &res_i[i];
         args[i].st_mode = st_mode;
+    }
 #ifdef NOUSE_QUEUE
+    for (i = 0; i < nurls; i++)
         XrdFfsPosix_x_deleteall((void*) &args[i]);
-    }
 #else
-        jobs[i] = XrdFfsQueue_create_task(XrdFfsPosix_x_deleteall, (void**)(&args[i]), 0);
-    }
+    jobs = XrdFfsQueue_create_group(nurls);
     for (i = 0; i < nurls; i++)
-    {
-        XrdFfsQueue_wait_task(jobs[i]);
-        XrdFfsQueue_free_task(jobs[i]);
-    }
+        XrdFfsQueue_group_task(jobs, i, XrdFfsPosix_x_deleteall, (void**)(&args[i]));
+    XrdFfsQueue_start_group(jobs);
+    XrdFfsQueue_wait_group(jobs);
+    XrdFfsQueue_free_group(jobs, NULL, NULL);
 #endif
     res = -1;
     errno = ENOENT;
@@ -409,6 +419,7 @@ int XrdFfsPosix_truncateall(const char *rdrurl, const char *path, off_t size, ui
 
 struct XrdFfsPosixX_readdirall_args {
     char *url;
+    const char *path;
     int *res;
     int *err;
     struct XrdFfsDentnames **dents;
@@ -429,6 +440,17 @@ void* XrdFfsPosix_x_readdirall(void* x)
     DIR *dp;
     struct dirent *de;
 
+/* 
+   With the attribute cache on, get the names and the stat info together so that
+   the getattr() calls of an "ls -l" do not have to go to the data servers again.
+ */
+    if (args->path != NULL)
+    {
+        *(args->res) = XrdFfsPosix_dirlist(args->url, args->path, args->dents);
+        if (*(args->res) != 0) *(args->err) = errno;
+        return NULL;
+    }
+
 /*
    Xrootd's Opendir will not return NULL even under some error. For instance,
    when it is supposed to return ENOENT or ENOTDIR, it actually returns 
@@ -452,9 +474,70 @@ void* XrdFfsPosix_x_readdirall(void* x)
     return NULL;
 }
 
+/*
+   XrdFfsPosix_dirlist() lists a directory on one data server with a single
+   request that also returns the stat info of every entry, instead of the 
+   one stat() per entry that would otherwise follow a readdir(). The names
+   are added to *dents and the stat info goes to the attribute cache under
+   "path/name" (path being the directory as seen by FUSE).
+ */
+int XrdFfsPosix_dirlist(const char *url, const char *path, struct XrdFfsDentnames **dents)
+{
+    XrdPosixAdmin adm(url);
+    XrdCl::DirectoryList *dlist = 0;
+    XrdCl::DirectoryList::ListEntry *ent;
+    XrdCl::StatInfo *info;
+    struct stat stbuf;
+    char entpath[MAXROOTURLLEN];
+    int plen;
+    unsigned int i;
+
+    if (!adm.isOK()) return -1;
+    if (XrdPosixMap::Result(adm.Xrd.DirList(adm.Url.GetPathWithParams(),
+                                            XrdCl::DirListFlags::Stat, dlist)))
+    {
+        delete dlist;
+        return -1;
+    }
+
+    plen = snprintf(entpath, MAXROOTURLLEN, "%s", path);
+    if (plen >= MAXROOTURLLEN) plen = MAXROOTURLLEN -1;
+    if (plen == 0 || entpath[plen -1] != '/') 
+    {
+        if (plen < MAXROOTURLLEN -1) entpath[plen++] = '/';
+        entpath[plen] = '\0';
+    }
+
+    memset(&stbuf, 0, sizeof(struct stat));
+    stbuf.st_nlink   = 1;
+    stbuf.st_uid     = getuid();
+    stbuf.st_gid     = getgid();
+    stbuf.st_blksize = 64*1024;
+
+    for (i = 0; i < dlist->GetSize(); i++)
+    {
+        ent = dlist->At(i);
+        XrdFfsDent_names_add(dents, (char*)ent->GetName().c_str());
+        if ((info = ent->GetStatInfo()) == NULL) continue;  /* some entries may fail the stat */
+
+/* fill in the same fields as XrdPosixXrootd::Stat() does */
+        stbuf.st_mode  = XrdPosixMap::Flags2Mode(&stbuf.st_rdev, info->GetFlags());
+        stbuf.st_size  = static_cast<off_t>(info->GetSize());
+        stbuf.st_blocks = stbuf.st_size/512+1;
+        stbuf.st_atime = stbuf.st_mtime = stbuf.st_ctime = static_cast<time_t>(info->GetModTime());
+        stbuf.st_ino   = static_cast<ino_t>(strtoll(info->GetId().c_str(), 0, 10));
+        XrdFfsPosix_fixmode(&stbuf);
+
+        snprintf(entpath + plen, MAXROOTURLLEN - plen, "%s", ent->GetName().c_str());
+        XrdFfsDent_attr_fill(entpath, &stbuf);
+    }
+    delete dlist;
+    return 0;
+}
+
 int XrdFfsPosix_readdirall(const char *rdrurl, const char *path, char*** direntarray, uid_t user_uid)
 {
-    int i, j, n, nents, nurls; 
+    int i, n, len, nents, maxents, nurls; 
     bool hasDirLock = false;
 
     char *newurls[XrdFfs_MAX_NUM_NODES];
@@ -462,10 +545,12 @@ int XrdFfsPosix_readdirall(const char *rdrurl, const char *path, char*** direnta
     int errno_i[XrdFfs_MAX_NUM_NODES];
     struct XrdFfsDentnames *dir_i[XrdFfs_MAX_NUM_NODES] = {0};
     struct XrdFfsPosixX_readdirall_args args[XrdFfs_MAX_NUM_NODES];
-    struct XrdFfsQueueTasks *jobs[XrdFfs_MAX_NUM_NODES];
-
-//    for (i = 0; i < XrdFfs_MAX_NUM_NODES; i++)
-//        dir_i[i] = NULL;
+#ifndef NOUSE_QUEUE
+    struct XrdFfsQueueGroup *jobs;
+#endif
+    struct XrdFfsDentnames *dent;
+    XrdOucHash<char> names;
+    char *name, *base;
 
     nurls = XrdFfsMisc_get_all_urls(rdrurl, newurls, XrdFfs_MAX_NUM_NODES);
 /* 
@@ -491,20 +576,63 @@ int XrdFfsPosix_readdirall(const char *rdrurl, const char *path, char*** direnta
         strncat(newurls[i], path,  MAXROOTURLLEN - strlen(newurls[i]) -1);
         XrdFfsMisc_xrd_secsss_editurl(newurls[i], user_uid, 0);
         args[i].url = newurls[i];
+        args[i].path = (XrdFfsDent_attr_enabled()? path : NULL);
         args[i].err = &errno_i[i];
         args[i].res = &res_i[i];
         args[i].dents = &dir_i[i];
+    }
+
+/*
+   Merge the names from each data server as soon as it answers, while the others are 
+   still listing. A name may come from many data servers (directories always do), the 
+   hash table tells if it has been seen already. Note that *direntarray is not sorted.
+ */
+    nents = 0;
+    maxents = 256;
+    *direntarray = (char **) malloc(sizeof(char*) * maxents);
+
 #ifdef NOUSE_QUEUE
+    for (i = 0; i < nurls; i++)
         XrdFfsPosix_x_readdirall((void*) &args[i]);
-    }   
+    for (i = 0; i < nurls; i++)
+    {
 #else
-        jobs[i] = XrdFfsQueue_create_task(XrdFfsPosix_x_readdirall, (void**)(&args[i]), 0);
-    }
+    jobs = XrdFfsQueue_create_group(nurls);
     for (i = 0; i < nurls; i++)
+        XrdFfsQueue_group_task(jobs, i, XrdFfsPosix_x_readdirall, (void**)(&args[i]));
+    XrdFfsQueue_start_group(jobs);
+    while ((i = XrdFfsQueue_group_next(jobs)) != -1)
     {
-        XrdFfsQueue_wait_task(jobs[i]);
-        XrdFfsQueue_free_task(jobs[i]);
+#endif
+        while (dir_i[i] != NULL)
+        {
+            dent = dir_i[i];
+            name = dent->name;
+            dir_i[i] = dent->next;
+            XrdFfsDent_names_del(&dent);
+
+            // put DIR_LOCK to the last one to allow rm -rf to work...
+            //
+            if (! strcmp(name, "DIR_LOCK"))
+            {
+                hasDirLock = true;
+                free(name);
+            }
+            else if (names.Add(name, name, 0, Hash_keep) != NULL)
+                free(name);
+            else
+            {
+                if (nents == maxents)
+                {
+                    maxents *= 2;
+                    *direntarray = (char **) realloc(*direntarray, sizeof(char*) * maxents);
+                }
+                (*direntarray)[nents++] = name;
+            }
+        }
     }
+#ifndef NOUSE_QUEUE
+    XrdFfsQueue_free_group(jobs, NULL, NULL);
 #endif
 
     errno = 0;
@@ -518,59 +646,28 @@ int XrdFfsPosix_readdirall(const char *rdrurl, const char *path, char*** direnta
 
     for (i = 0; i < nurls; i++)
         free(newurls[i]);
-    for (i = 1; i < nurls; i++)
-        XrdFfsDent_names_join(&dir_i[i], &dir_i[i-1]);
-
-    char *last = NULL, **dnarraytmp;
 
-    n = XrdFfsDent_names_extract(&dir_i[nurls-1], &dnarraytmp);
-    *direntarray = (char **) malloc(sizeof(char*) * n);
+/* filter out the .lock/.fail files of the files that are listed */
 
-// note that dnarraytmp[] may contain redundant entries
-
-    nents = 0;
-    for (i = 0; i < n; i++)
+    for (i = 0, n = 0; i < nents; i++)
     {
-        // put DIR_LOCK to the last one to allow rm -rf to work...
-        //
-        if (! strcmp(dnarraytmp[i], "DIR_LOCK")) 
+        name = (*direntarray)[i];
+        len = strlen(name);
+        if (len > 5 && (! strcmp(name + len - 5, ".lock") || ! strcmp(name + len - 5, ".fail")))
         {
-            hasDirLock = true;
-            continue;  
-        }
-
-        if (i != 0)   // can be used to filter out .lock .fail, etc. 
-        {
-            char *tmp, *tmp_dot;
-            tmp = strdup(dnarraytmp[i]);
-            tmp_dot = tmp + strlen(tmp) - 5;
-
-            if (! strcmp(tmp_dot, ".lock") || ! strcmp(tmp_dot, ".fail"))   // filter out .lock/.fail files
+            base = strdup(name);
+            base[len - 5] = '\0';
+            if (names.Find(base) != NULL)
             {
-                for (j = nents - 1; j >= 0; j--)
-                {
-                    tmp_dot[0] = '\0';
-                    if (! strcmp(tmp, (*direntarray)[j]))
-                    {
-                        tmp_dot[0] = '.';
-                        free(tmp);
-                        break;
-                    }
-                }
-                if (j >= 0) continue;  // found the file cooresponding to the .lock/.fail
+                names.Del(name);
+                free(name);
+                name = NULL;
             }
-            free(tmp);
-        }
-
-        if (last == NULL || strcmp(last, dnarraytmp[i]) != 0)
-        {
-            last = dnarraytmp[i];
-            (*direntarray)[nents++] = strdup(dnarraytmp[i]);
+            free(base);
         }
+        if (name != NULL) (*direntarray)[n++] = name;
     }
-    
-    for (i = 0; i < n; i++) free(dnarraytmp[i]);  // do not mergo with the above because the above loop has 'break'.
-    free(dnarraytmp);
+    nents = n;
 
 /* inject this list into dent cache */
 
@@ -579,7 +676,12 @@ int XrdFfsPosix_readdirall(const char *rdrurl, const char *path, char*** direnta
     XrdFfsDent_cache_fill(p, direntarray, nents);
     free(p);
 
-    if (hasDirLock) (*direntarray)[nents++] = strdup("DIR_LOCK");
+    if (hasDirLock) 
+    {
+        if (nents == maxents) 
+            *direntarray = (char **) realloc(*direntarray, sizeof(char*) * (maxents +1));
+        (*direntarray)[nents++] = strdup("DIR_LOCK");
+    }
 
     return nents;
 }
@@ -665,7 +767,9 @@ int XrdFfsPosix_statvfsall(const char *rdrurl, const char *path, struct statvfs
     int errno_i[XrdFfs_MAX_NUM_NODES];
     struct statvfs stbuf_i[XrdFfs_MAX_NUM_NODES];
     struct XrdFfsPosixX_statvfsall_args args[XrdFfs_MAX_NUM_NODES];
-    struct XrdFfsQueueTasks *jobs[XrdFfs_MAX_NUM_NODES];
+#ifndef NOUSE_QUEUE
+    struct XrdFfsQueueGroup *jobs;
+#endif
 
     nurls = XrdFfsMisc_get_all_urls(rdrurl, newurls, XrdFfs_MAX_NUM_NODES);
     if (nurls < 0)
@@ -688,17 +792,17 @@ int XrdFfsPosix_statvfsall(const char *rdrurl, const char *path, struct statvfs
         stbuf_i[i].f_bsize = stbuf->f_bsize;
         args[i].stbuf = &(stbuf_i[i]);
         args[i].osscgroup = osscgroup;
+    }
 #ifdef NOUSE_QUEUE
+    for (i = 0; i < nurls; i++)
         XrdFfsPosix_x_statvfsall((void*) &args[i]);
-    }
 #else
-        jobs[i] = XrdFfsQueue_create_task(XrdFfsPosix_x_statvfsall, (void**)(&args[i]), 0);
-    }
+    jobs = XrdFfsQueue_create_group(nurls);
     for (i = 0; i < nurls; i++)
-    {
-        XrdFfsQueue_wait_task(jobs[i]);
-        XrdFfsQueue_free_task(jobs[i]);
-    }
+        XrdFfsQueue_group_task(jobs, i, XrdFfsPosix_x_statvfsall, (void**)(&args[i]));
+    XrdFfsQueue_start_group(jobs);
+    XrdFfsQueue_wait_group(jobs);
+    XrdFfsQueue_free_group(jobs, NULL, NULL);
 #endif
  /*
    for statfs call, we don't care about return code and errno 
@@ -721,32 +825,47 @@ int XrdFfsPosix_statvfsall(const char *rdrurl, const char *path, struct statvfs
 
 /* XrdFfsPosiXrdFfsPosix_x_statall() */
 
+/*
+   The stat() results are kept with the arguments because XrdFfsPosix_statall() 
+   returns with the first data server that has the file, and the tasks against
+   the other data servers may still be running. The last one frees them all.
+ */
 struct XrdFfsPosixX_statall_args {
     char *url;
-    int *res;
-    int *err;
-    struct stat *stbuf;
+    int res;
+    int err;
+    struct stat stbuf;
 };
 
 void* XrdFfsPosix_x_statall(void *x)
 {
     struct XrdFfsPosixX_statall_args *args = (struct XrdFfsPosixX_statall_args *)x;
 
-    *(args->res) = XrdFfsPosix_stat(args->url, args->stbuf);
-    *(args->err) = errno;
+    args->res = XrdFfsPosix_stat(args->url, &args->stbuf);
+    args->err = errno;
     return (void *)0;
 }
 
+/* args[] ends with an entry with url == NULL */
+void XrdFfsPosix_statall_free(void *x)
+{
+    struct XrdFfsPosixX_statall_args *args = (struct XrdFfsPosixX_statall_args *)x;
+    int i;
+
+    for (i = 0; args[i].url != NULL; i++)
+        free(args[i].url);
+    free(args);
+}
+
 int XrdFfsPosix_statall(const char *rdrurl, const char *path, struct stat *stbuf, uid_t user_uid)
 {
-    int i, res, nurls;
+    int i, res, err, nurls;
 
     char *newurls[XrdFfs_MAX_NUM_NODES];
-    int res_i[XrdFfs_MAX_NUM_NODES];
-    int errno_i[XrdFfs_MAX_NUM_NODES];
-    struct stat stbuf_i[XrdFfs_MAX_NUM_NODES];
-    struct XrdFfsPosixX_statall_args args[XrdFfs_MAX_NUM_NODES];
-    struct XrdFfsQueueTasks *jobs[XrdFfs_MAX_NUM_NODES];
+    struct XrdFfsPosixX_statall_args *args;
+#ifndef NOUSE_QUEUE
+    struct XrdFfsQueueGroup *jobs;
+#endif
 
     char *p1, *p2, *dir, *file, rootpath[MAXROOTURLLEN];
 
@@ -777,47 +896,53 @@ int XrdFfsPosix_statall(const char *rdrurl, const char *path, struct stat *stbuf
     free(p2);    
 
     nurls = XrdFfsMisc_get_all_urls(rdrurl, newurls, XrdFfs_MAX_NUM_NODES);
+    if (nurls < 0) nurls = 0;
 
+    args = (struct XrdFfsPosixX_statall_args*) calloc(nurls +1, sizeof(struct XrdFfsPosixX_statall_args));
     for (i = 0; i < nurls; i++)
     {
-        strncat(newurls[i], path, MAXROOTURLLEN - strlen(path) -1);
+        strncat(newurls[i], path, MAXROOTURLLEN - strlen(newurls[i]) -1);
         XrdFfsMisc_xrd_secsss_editurl(newurls[i], user_uid, 0);
         args[i].url = newurls[i];
-        args[i].res = &res_i[i];
-        args[i].err = &errno_i[i];
-        args[i].stbuf = &(stbuf_i[i]);
+    }
+    args[nurls].url = NULL;
+
+    res = -1;
+    err = ENOENT;
 #ifdef NOUSE_QUEUE
+    for (i = 0; i < nurls; i++)
         XrdFfsPosix_x_statall((void*) &args[i]);
-    }
+    for (i = 0; i < nurls; i++)
+    {
 #else
-        jobs[i] = XrdFfsQueue_create_task(XrdFfsPosix_x_statall, (void**)(&args[i]), 0);
-    }
+    jobs = XrdFfsQueue_create_group(nurls);
     for (i = 0; i < nurls; i++)
+        XrdFfsQueue_group_task(jobs, i, XrdFfsPosix_x_statall, (void**)(&args[i]));
+    XrdFfsQueue_start_group(jobs);
+/* the first data server that has the file answers, don't wait for the others */
+    while ((i = XrdFfsQueue_group_next(jobs)) != -1)
     {
-        XrdFfsQueue_wait_task(jobs[i]);
-        XrdFfsQueue_free_task(jobs[i]);
-    }
 #endif
-    res = -1;
-    errno = ENOENT;
-    for (i = 0; i < nurls; i++)
-        if (res_i[i] == 0) 
+        if (args[i].res == 0) 
         {
             res = 0;
-            errno = 0;
-            memcpy((void*)stbuf, (void*)(&stbuf_i[i]), sizeof(struct stat));
+            err = 0;
+            memcpy((void*)stbuf, (void*)(&args[i].stbuf), sizeof(struct stat));
             break;
         }
-        else if (res_i[i] != 0 && errno_i[i] == 125) // when host i is down
+        else if (args[i].err == 125) // when host i is down
         {
-            res = -1;
-            errno = ETIMEDOUT;
-            syslog(LOG_WARNING, "WARNING: stat(%s) failed (connection timeout)", newurls[i]);
+            err = ETIMEDOUT;
+            syslog(LOG_WARNING, "WARNING: stat(%s) failed (connection timeout)", args[i].url);
         }
+    }
+#ifdef NOUSE_QUEUE
+    XrdFfsPosix_statall_free(args);
+#else
+    XrdFfsQueue_free_group(jobs, XrdFfsPosix_statall_free, args);
+#endif
 
-    for (i = 0; i < nurls; i++)
-        free(newurls[i]);
-
+    errno = err;
     return res;
 }
 
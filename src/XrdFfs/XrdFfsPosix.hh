@@ -72,6 +72,13 @@ long long      XrdFfsPosix_getxattr(const char *path, const char *name, void *va
 */ 
 void           XrdFfsPosix_clear_from_rdr_cache(const char *rdrurl);
 
+/*
+   XrdFfsPosix_dirlist() adds the names in directory "url" to *dents and puts their stat info 
+   in the attribute cache (see XrdFfsDent.hh) as "path/name".
+*/
+struct XrdFfsDentnames;
+int            XrdFfsPosix_dirlist(const char *url, const char *path, struct XrdFfsDentnames **dents);
+
 int            XrdFfsPosix_unlinkall(const char *rdrurl, const char *path, uid_t user_uid);
 int            XrdFfsPosix_rmdirall(const char *rdrurl, const char *path, uid_t user_uid);
 int            XrdFfsPosix_renameall(const char *rdrurl, const char *from, const char *to, uid_t user_uid);
@@ -38,30 +38,38 @@
 struct XrdFfsQueueTasks *XrdFfsQueueTaskque_head = NULL;
 struct XrdFfsQueueTasks *XrdFfsQueueTaskque_tail = NULL;
 unsigned int XrdFfsQueueNext_task_id = 0;
+unsigned int XrdFfsQueueNtasks = 0;  /* tasks waiting in the queue */
+unsigned int XrdFfsQueueNidle = 0;   /* workers waiting for a task */
 pthread_mutex_t XrdFfsQueueTaskque_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t XrdFfsQueueTaskque_cond = PTHREAD_COND_INITIALIZER;
 
-void XrdFfsQueue_enqueue(struct XrdFfsQueueTasks *task)
+/* the caller holds XrdFfsQueueTaskque_mutex */
+void XrdFfsQueue_enqueue_locked(struct XrdFfsQueueTasks *task)
 {
-    pthread_mutex_lock(&XrdFfsQueueTaskque_mutex);
-
     task->id = XrdFfsQueueNext_task_id + 1;
     XrdFfsQueueNext_task_id = task->id;
+    task->next = NULL;
     if (XrdFfsQueueTaskque_tail == NULL) 
     {
+        task->prev = NULL;
         XrdFfsQueueTaskque_head = task;
         XrdFfsQueueTaskque_tail = task;
-        task->next = NULL;
-        pthread_cond_broadcast(&XrdFfsQueueTaskque_cond);
     }
     else
     {
         task->prev = XrdFfsQueueTaskque_tail;
-        task->next = NULL;
         XrdFfsQueueTaskque_tail->next = task;
         XrdFfsQueueTaskque_tail = task;
     }
+    XrdFfsQueueNtasks++;
+    if (XrdFfsQueueNidle > 0)
+        pthread_cond_signal(&XrdFfsQueueTaskque_cond);
+}
 
+void XrdFfsQueue_enqueue(struct XrdFfsQueueTasks *task)
+{
+    pthread_mutex_lock(&XrdFfsQueueTaskque_mutex);
+    XrdFfsQueue_enqueue_locked(task);
     pthread_mutex_unlock(&XrdFfsQueueTaskque_mutex);
     return;
 }
@@ -69,14 +77,14 @@ void XrdFfsQueue_enqueue(struct XrdFfsQueueTasks *task)
 struct XrdFfsQueueTasks *XrdFfsQueue_dequeue()
 {
     struct XrdFfsQueueTasks *head;
-    while (pthread_mutex_lock(&XrdFfsQueueTaskque_mutex) == 0)
-        if (XrdFfsQueueTaskque_head == NULL)
-        {
-            pthread_cond_wait(&XrdFfsQueueTaskque_cond, &XrdFfsQueueTaskque_mutex);
-            pthread_mutex_unlock(&XrdFfsQueueTaskque_mutex);
-        }
-        else
-            break;
+
+    pthread_mutex_lock(&XrdFfsQueueTaskque_mutex);
+    while (XrdFfsQueueTaskque_head == NULL)
+    {
+        XrdFfsQueueNidle++;
+        pthread_cond_wait(&XrdFfsQueueTaskque_cond, &XrdFfsQueueTaskque_mutex);
+        XrdFfsQueueNidle--;
+    }
 
     head = XrdFfsQueueTaskque_head;
     XrdFfsQueueTaskque_head = XrdFfsQueueTaskque_head->next;
@@ -86,6 +94,7 @@ struct XrdFfsQueueTasks *XrdFfsQueue_dequeue()
 
     if (XrdFfsQueueTaskque_head == NULL)
         XrdFfsQueueTaskque_tail = NULL;
+    XrdFfsQueueNtasks--;
 
     pthread_mutex_unlock(&XrdFfsQueueTaskque_mutex);
     return head;
@@ -99,6 +108,8 @@ struct XrdFfsQueueTasks* XrdFfsQueue_create_task(void* (*func)(void*), void **ar
     task->func = func;
     task->args = args;
     task->done = ( (initstat == -1)? -1 : 0); /* -1 means this task is meant to kill a worker thread */
+    task->group = NULL;
+    task->gidx = 0;
 
     pthread_mutex_init(&task->mutex, NULL);
     pthread_cond_init(&task->cond, NULL);
@@ -122,34 +133,24 @@ void XrdFfsQueue_free_task(struct XrdFfsQueueTasks *task)
 void XrdFfsQueue_wait_task(struct XrdFfsQueueTasks *task)
 {
     pthread_mutex_lock(&task->mutex);
-    if (task->done != 1)
+    while (task->done != 1)
         pthread_cond_wait(&task->cond, &task->mutex);
     pthread_mutex_unlock(&task->mutex);
 }
 
 unsigned int XrdFfsQueue_count_tasks()
 {
-    unsigned int que_len = 0;
+    unsigned int que_len;
     pthread_mutex_lock(&XrdFfsQueueTaskque_mutex);
-    if (XrdFfsQueueTaskque_head != NULL && XrdFfsQueueTaskque_tail != NULL) {
-        if (XrdFfsQueueTaskque_tail->id > XrdFfsQueueTaskque_head->id)
-            que_len = XrdFfsQueueTaskque_tail->id - XrdFfsQueueTaskque_head->id;
-        else
-// this is wrong: 
-//          que_len = (unsigned int)2147483647 - (XrdFfsQueueTaskque_head->id - XrdFfsQueueTaskque_tail->id) + 1;
-
-//not accepted by c89
-//          que_len = (unsigned int)4294967295 - (XrdFfsQueueTaskque_head->id - XrdFfsQueueTaskque_tail->id) + 1;
-
-//this is not quite correct, but I imagine that the queue will never by so long >= 2147483647
-          que_len = (unsigned int)2147483647 - (XrdFfsQueueTaskque_head->id - XrdFfsQueueTaskque_tail->id) + 1+(unsigned int)2147483647+1;
-    }
+    que_len = XrdFfsQueueNtasks;
     pthread_mutex_unlock(&XrdFfsQueueTaskque_mutex);
     return que_len;
 }
 
 /* workers */
 
+void XrdFfsQueue_group_done(struct XrdFfsQueueTasks *task);
+
 void *XrdFfsQueue_worker(void* x)
 {
     struct XrdFfsQueueTasks *task;
@@ -158,6 +159,13 @@ void *XrdFfsQueue_worker(void* x)
     loop:
     task = XrdFfsQueue_dequeue();
 
+    if (task->group != NULL)
+    {
+        (task->func)(task->args);
+        XrdFfsQueue_group_done(task);
+        goto loop;
+    }
+
     if (task->done == -1) // terminate this worker thread
         quit = 1;
 
@@ -184,11 +192,13 @@ void *XrdFfsQueue_worker(void* x)
         goto loop;
 }
 
-pthread_mutex_t XrdFfsQueueWorker_mutex;
+pthread_mutex_t XrdFfsQueueWorker_mutex = PTHREAD_MUTEX_INITIALIZER;
 unsigned short XrdFfsQueueNworkers = 0;
 unsigned int XrdFfsQueueWorker_id = 0;
+int XrdFfsQueueMaxworkers = 0;
 
-int XrdFfsQueue_create_workers(int n)
+/* the caller holds XrdFfsQueueWorker_mutex */
+int XrdFfsQueue_create_workers_locked(int n)
 {
     int i, rc, *id;
     pthread_t *thread;
@@ -199,7 +209,6 @@ int XrdFfsQueue_create_workers(int n)
     pthread_attr_setstacksize(&attr, stacksize);
     pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
     
-    pthread_mutex_lock(&XrdFfsQueueWorker_mutex);
     for (i = 0; i < n; i++)
     {
         id = (int*) malloc(sizeof(int));
@@ -214,17 +223,50 @@ int XrdFfsQueue_create_workers(int n)
         if (rc != 0) 
         {
             XrdFfsQueueWorker_id--;
+            free(thread);
+            free(id);
             break;
         }
-        pthread_detach(*thread);
         free(thread);
     }
     pthread_attr_destroy(&attr);
     XrdFfsQueueNworkers += i;
+    return i;
+}
+
+int XrdFfsQueue_create_workers(int n)
+{
+    int i;
+    pthread_mutex_lock(&XrdFfsQueueWorker_mutex);
+    i = XrdFfsQueue_create_workers_locked(n);
     pthread_mutex_unlock(&XrdFfsQueueWorker_mutex);
     return i;
 }
 
+/*
+   With a maximum set, a group that finds fewer idle workers than it has tasks
+   starts more workers (up to the maximum) instead of running its tasks a few 
+   at a time. The extra workers stay. Zero (the default) keeps the number of 
+   workers fixed.
+ */
+void XrdFfsQueue_set_max_workers(int n)
+{
+    pthread_mutex_lock(&XrdFfsQueueWorker_mutex);
+    XrdFfsQueueMaxworkers = n;
+    pthread_mutex_unlock(&XrdFfsQueueWorker_mutex);
+}
+
+void XrdFfsQueue_grow_workers(int n)
+{
+/* don't wait behind XrdFfsQueue_remove_workers(), growing is only an optimization */
+    if (pthread_mutex_trylock(&XrdFfsQueueWorker_mutex) != 0) return;
+    if (n > XrdFfsQueueMaxworkers - XrdFfsQueueNworkers)
+        n = XrdFfsQueueMaxworkers - XrdFfsQueueNworkers;
+    if (n > 0)
+        XrdFfsQueue_create_workers_locked(n);
+    pthread_mutex_unlock(&XrdFfsQueueWorker_mutex);
+}
+
 int XrdFfsQueue_remove_workers(int n)
 {
     int i;
@@ -259,6 +301,113 @@ int XrdFfsQueue_count_workers()
     return i;
 }
 
+/* groups of tasks */
+
+struct XrdFfsQueueGroup* XrdFfsQueue_create_group(int ntasks)
+{
+    struct XrdFfsQueueGroup *group = (struct XrdFfsQueueGroup*) malloc(sizeof(struct XrdFfsQueueGroup));
+
+    if (ntasks < 0) ntasks = 0;
+    pthread_mutex_init(&group->mutex, NULL);
+    pthread_cond_init(&group->cond, NULL);
+    group->ntasks = ntasks;
+    group->ndone = 0;
+    group->nread = 0;
+    group->refs = 1;
+    group->order = (int*) malloc(sizeof(int) * (ntasks +1));
+    group->tasks = (struct XrdFfsQueueTasks*) calloc(ntasks +1, sizeof(struct XrdFfsQueueTasks));
+    group->cleanup = NULL;
+    group->cleanup_arg = NULL;
+    return group;
+}
+
+void XrdFfsQueue_group_task(struct XrdFfsQueueGroup *group, int i, void* (*func)(void*), void **args)
+{
+    group->tasks[i].func = func;
+    group->tasks[i].args = args;
+    group->tasks[i].group = group;
+    group->tasks[i].gidx = i;
+}
+
+void XrdFfsQueue_start_group(struct XrdFfsQueueGroup *group)
+{
+    int i, grow = 0;
+
+    if (group->ntasks == 0) return;
+
+    pthread_mutex_lock(&group->mutex);
+    group->refs += group->ntasks;
+    pthread_mutex_unlock(&group->mutex);
+
+    pthread_mutex_lock(&XrdFfsQueueTaskque_mutex);
+    for (i = 0; i < group->ntasks; i++)
+        XrdFfsQueue_enqueue_locked(&group->tasks[i]);
+    if (XrdFfsQueueNtasks > XrdFfsQueueNidle)
+        grow = XrdFfsQueueNtasks - XrdFfsQueueNidle;
+    pthread_mutex_unlock(&XrdFfsQueueTaskque_mutex);
+
+    if (grow > 0) XrdFfsQueue_grow_workers(grow);
+}
+
+void XrdFfsQueue_destroy_group(struct XrdFfsQueueGroup *group)
+{
+    if (group->cleanup != NULL)
+        (group->cleanup)(group->cleanup_arg);
+    pthread_mutex_destroy(&group->mutex);
+    pthread_cond_destroy(&group->cond);
+    free(group->order);
+    free(group->tasks);
+    free(group);
+}
+
+void XrdFfsQueue_group_done(struct XrdFfsQueueTasks *task)
+{
+    struct XrdFfsQueueGroup *group = task->group;
+    int refs;
+
+    pthread_mutex_lock(&group->mutex);
+    group->order[group->ndone++] = task->gidx;
+    refs = --group->refs;
+    pthread_cond_signal(&group->cond);
+    pthread_mutex_unlock(&group->mutex);
+    if (refs == 0)
+        XrdFfsQueue_destroy_group(group);
+}
+
+/* returns the index of the next task to finish, or -1 once all of them were returned */
+int XrdFfsQueue_group_next(struct XrdFfsQueueGroup *group)
+{
+    int i = -1;
+
+    pthread_mutex_lock(&group->mutex);
+    if (group->nread < group->ntasks)
+    {
+        while (group->nread == group->ndone)
+            pthread_cond_wait(&group->cond, &group->mutex);
+        i = group->order[group->nread++];
+    }
+    pthread_mutex_unlock(&group->mutex);
+    return i;
+}
+
+void XrdFfsQueue_wait_group(struct XrdFfsQueueGroup *group)
+{
+    while (XrdFfsQueue_group_next(group) != -1) ;
+}
+
+void XrdFfsQueue_free_group(struct XrdFfsQueueGroup *group, void (*cleanup)(void*), void *cleanup_arg)
+{
+    int refs;
+
+    pthread_mutex_lock(&group->mutex);
+    group->cleanup = cleanup;
+    group->cleanup_arg = cleanup_arg;
+    refs = --group->refs;
+    pthread_mutex_unlock(&group->mutex);
+    if (refs == 0)
+        XrdFfsQueue_destroy_group(group);
+}
+
 
 /* Test program below
    ==================
@@ -34,6 +34,8 @@
 #include <stdlib.h>
 #include <pthread.h>
 
+struct XrdFfsQueueGroup;
+
 struct XrdFfsQueueTasks {
     pthread_mutex_t mutex;
     pthread_cond_t cond;
@@ -44,6 +46,9 @@ struct XrdFfsQueueTasks {
     unsigned int id;
     struct XrdFfsQueueTasks *next;
     struct XrdFfsQueueTasks *prev;
+
+    struct XrdFfsQueueGroup *group;  /* NULL unless the task belongs to a group */
+    int gidx;                        /* index of the task in its group */
 };
 
 struct XrdFfsQueueTasks* XrdFfsQueue_create_task(void* (*func)(void*), void **args, short initstat);
@@ -51,9 +56,38 @@ void XrdFfsQueue_free_task(struct XrdFfsQueueTasks *task);
 void XrdFfsQueue_wait_task(struct XrdFfsQueueTasks *task);
 unsigned int XrdFfsQueue_count_tasks();
 
+/*
+   A group runs the same kind of task against many data servers. All tasks of
+   the group are queued at once, and the caller picks up the results in the 
+   order the tasks finish, so it can use the first answer or merge the answers
+   while the slow servers are still working. The caller may free the group 
+   before all tasks finish; the group is then released by the last task, 
+   calling cleanup(cleanup_arg) so that the task arguments can be freed.
+ */
+struct XrdFfsQueueGroup {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int ntasks;
+    int ndone;        /* tasks finished */
+    int nread;        /* finished tasks returned by XrdFfsQueue_group_next() */
+    int refs;         /* the caller plus the tasks not yet finished */
+    int *order;       /* indexes of the finished tasks, in finishing order */
+    struct XrdFfsQueueTasks *tasks;
+    void (*cleanup)(void*);
+    void *cleanup_arg;
+};
+
+struct XrdFfsQueueGroup* XrdFfsQueue_create_group(int ntasks);
+void XrdFfsQueue_group_task(struct XrdFfsQueueGroup *group, int i, void* (*func)(void*), void **args);
+void XrdFfsQueue_start_group(struct XrdFfsQueueGroup *group);
+int XrdFfsQueue_group_next(struct XrdFfsQueueGroup *group);
+void XrdFfsQueue_wait_group(struct XrdFfsQueueGroup *group);
+void XrdFfsQueue_free_group(struct XrdFfsQueueGroup *group, void (*cleanup)(void*), void *cleanup_arg);
+
 int XrdFfsQueue_create_workers(int n);
 int XrdFfsQueue_remove_workers(int n);
 int XrdFfsQueue_count_workers();
+void XrdFfsQueue_set_max_workers(int n);
  
 #ifdef __cplusplus
   }
@@ -146,10 +146,14 @@ void XrdFfsWcache_destroy(int fd)
     XrdFfsWcacheFbufs[fd].mlock = NULL;
 }
 
-ssize_t XrdFfsWcache_flush(int fd)
+/* 
+   _dflush() writes out the buffer of (0 based) fd, the caller holds its mlock. 
+   FUSE may run several requests on the same file at once, so every access to
+   the buffer must be done under mlock.
+*/
+ssize_t XrdFfsWcache_dflush(int fd)
 {
     ssize_t rc;
-    fd -= XrdFfsPosix_baseFD;
 
     if (XrdFfsWcacheFbufs[fd].len == 0 || XrdFfsWcacheFbufs[fd].buf == NULL )
         return 0;
@@ -164,6 +168,20 @@ ssize_t XrdFfsWcache_flush(int fd)
     return rc;
 }
 
+ssize_t XrdFfsWcache_flush(int fd)
+{
+    ssize_t rc;
+    fd -= XrdFfsPosix_baseFD;
+
+    if (fd < 0 || fd >= XrdFfsWcacheNFILES || XrdFfsWcacheFbufs[fd].mlock == NULL)
+        return 0;
+
+    pthread_mutex_lock(XrdFfsWcacheFbufs[fd].mlock);
+    rc = XrdFfsWcache_dflush(fd);
+    pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+    return rc;
+}
+
 ssize_t XrdFfsWcache_pwrite(int fd, char *buf, size_t len, off_t offset)
 {
     ssize_t rc;
@@ -176,13 +194,26 @@ ssize_t XrdFfsWcache_pwrite(int fd, char *buf, size_t len, off_t offset)
     }
 
 /* do not use caching under these cases */
-    if (len > XrdFfsWcacheBufsize/2 || fd >= XrdFfsWcacheNFILES)
+    if (fd >= XrdFfsWcacheNFILES || XrdFfsWcacheFbufs[fd].mlock == NULL)
     {
         rc = XrdFfsPosix_pwrite(fd + XrdFfsPosix_baseFD, buf, len, offset);
         return rc;
     }
 
     pthread_mutex_lock(XrdFfsWcacheFbufs[fd].mlock);
+/* 
+   a large write goes directly, but after what is in the buffer so that 
+   an overlapping older write can not overwrite it later 
+*/
+    if (len > XrdFfsWcacheBufsize/2)
+    {
+        rc = XrdFfsWcache_dflush(fd);
+        if (rc >= 0)
+            rc = XrdFfsPosix_pwrite(fd + XrdFfsPosix_baseFD, buf, len, offset);
+        pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+        return rc;
+    }
+
     rc = XrdFfsWcacheFbufs[fd].len;
 /* 
    in the following two cases, a XrdFfsWcache_flush is required:
@@ -191,7 +222,7 @@ ssize_t XrdFfsWcache_pwrite(int fd, char *buf, size_t len, off_t offset)
 */ 
     if (offset != (off_t)(XrdFfsWcacheFbufs[fd].offset + XrdFfsWcacheFbufs[fd].len) ||
         (off_t)(offset + len) > (XrdFfsWcacheFbufs[fd].offset + XrdFfsWcacheBufsize))
-        rc = XrdFfsWcache_flush(fd + XrdFfsPosix_baseFD);
+        rc = XrdFfsWcache_dflush(fd);
 
     errno = 0;
     if (rc < 0) 
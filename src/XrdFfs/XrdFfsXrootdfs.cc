@@ -64,7 +64,7 @@
 #include "XrdFfs/XrdFfsMisc.hh"
 #include "XrdFfs/XrdFfsWcache.hh"
 #include "XrdFfs/XrdFfsQueue.hh"
-//#include "XrdFfs/XrdFfsDent.hh"
+#include "XrdFfs/XrdFfsDent.hh"
 #include "XrdFfs/XrdFfsFsinfo.hh"
 #include "XrdPosix/XrdPosixXrootd.hh"
 
@@ -79,13 +79,16 @@ struct XROOTDFS {
     char *urlcachelife;
     bool ofsfwd;
     int  nworkers;
+    int  maxworkers;
     int  maxfd;
+    int  attrcache;
+    int  readahead;
 };
 
 int cwdfd; // File descript of the initial working dir
 
 struct XROOTDFS xrootdfs;
-static struct fuse_opt xrootdfs_opts[14];
+static struct fuse_opt xrootdfs_opts[17];
 
 enum { OPT_KEY_HELP, OPT_KEY_SECSSS, };
 
@@ -128,6 +131,22 @@ static void* xrootdfs_init(struct fuse_conn_info *conn)
     XrdPosixXrootd *abc = new XrdPosixXrootd(-xrootdfs.maxfd);
     XrdFfsMisc_xrd_init(xrootdfs.rdr,xrootdfs.urlcachelife,0);
     XrdFfsWcache_init(abc->fdOrigin(), xrootdfs.maxfd);
+/*
+   The attribute cache is shared by all users. With sss the servers answer 
+   each user according to their own identity, so the cache could hand one user 
+   what another one was allowed to see. Don't use it then.
+ */
+    if (xrootdfs.attrcache > 0 && getenv("XROOTDFS_SECMOD") != NULL && !strcmp(getenv("XROOTDFS_SECMOD"), "sss"))
+    {
+        syslog(LOG_INFO, "INFO: attribute cache disabled, it can not be used with sss");
+        xrootdfs.attrcache = 0;
+    }
+    XrdFfsDent_attr_init(xrootdfs.attrcache);
+/* 
+   Let the client prefetch ahead of sequential readers, so the kernel's 
+   readahead-sized requests are served from data already on the way.
+ */
+    XrdPosixXrootd::setEnv("ReadAhead", xrootdfs.readahead);
 /*
    From FAQ:
       Miscellaneous threads should be started from the init() method.
@@ -137,6 +156,7 @@ static void* xrootdfs_init(struct fuse_conn_info *conn)
 
 #ifndef NOUSE_QUEUE
     XrdFfsQueue_create_workers(xrootdfs.nworkers);
+    XrdFfsQueue_set_max_workers(xrootdfs.maxworkers);
 
     syslog(LOG_INFO, "INFO: Starting %d workers", XrdFfsQueue_count_workers());
 #else
@@ -152,7 +172,7 @@ static void* xrootdfs_init(struct fuse_conn_info *conn)
 static int xrootdfs_getattr(const char *path, struct stat *stbuf)
 {
 //  int res, fd;
-    int res;
+    int res, cached;
     char rootpath[MAXROOTURLLEN];
 //    uid_t user_uid, uid;
 //    gid_t user_gid, gid;
@@ -163,6 +183,11 @@ static int xrootdfs_getattr(const char *path, struct stat *stbuf)
 //    user_gid = fuse_get_context()->gid;
 //    gid = getgid();
 
+/* 
+   An "ls -l" asks for the attributes of every entry right after readdir(), 
+   which has already put them in the attribute cache. 
+ */
+    cached = XrdFfsDent_attr_search(path, stbuf);
     XrdFfsMisc_xrd_secsss_register(fuse_get_context()->uid, fuse_get_context()->gid, 0);
 
     rootpath[0]='\0';
@@ -179,7 +204,9 @@ static int xrootdfs_getattr(const char *path, struct stat *stbuf)
     res = XrdFfsPosix_stat(rootpath, stbuf);
 */
 
-    if (xrootdfs.cns != NULL && xrootdfs.fastls != NULL)
+    if (cached)
+        res = 0;
+    else if (xrootdfs.cns != NULL && xrootdfs.fastls != NULL)
     {
         strncat(rootpath,xrootdfs.cns, MAXROOTURLLEN - strlen(rootpath) -1);
         strncat(rootpath,path, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -208,10 +235,10 @@ static int xrootdfs_getattr(const char *path, struct stat *stbuf)
    don't exist). They also expect correct file size. For this type of application, we
    can set 'xrootdfs.fastls = RDR'.
 
-   Allowing multi-thread may solve this problem. However, XrootdFS crashs under some 
-   situation, and we have to add -s (single thread) option when runing XrootdFS.
+   Run multi-threaded (without -s), a slow stat() does not hold up the others, 
+   and the attribute cache (if enabled) answers repeated checks.
  */
-            if (xrootdfs.cns != NULL && xrootdfs.fastls != NULL && strcmp(xrootdfs.fastls,"RDR") == 0)
+            if (!cached && xrootdfs.cns != NULL && xrootdfs.fastls != NULL && strcmp(xrootdfs.fastls,"RDR") == 0)
             {
                 rootpath[0]='\0';
                 strncat(rootpath,xrootdfs.rdr, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -224,12 +251,14 @@ static int xrootdfs_getattr(const char *path, struct stat *stbuf)
             stbuf->st_mode |= 0666;
             stbuf->st_mode &= 0772777;  /* remove sticky bit and suid bit */
             stbuf->st_blksize = 32768;  /* unfortunately, it is ignored, see include/fuse.h */
+            if (!cached) XrdFfsDent_attr_fill(path, stbuf);
             return 0;
         }
         else if (S_ISDIR(stbuf->st_mode))
         {
             stbuf->st_mode |= 0777;
             stbuf->st_mode &= 0772777;  /* remove sticky bit and suid bit */
+            if (!cached) XrdFfsDent_attr_fill(path, stbuf);
             return 0;
         }
         else
@@ -415,6 +444,7 @@ static int xrootdfs_mknod(const char *path, mode_t mode, dev_t rdev)
 
         res = XrdFfsPosix_open(rootpath, O_CREAT | O_EXCL | O_WRONLY, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH); 
 */
+    XrdFfsDent_attr_clear(path);
     res = xrootdfs_do_create(path, xrootdfs.rdr, O_CREAT | O_WRONLY, false, &fd);
     XrdFfsPosix_close(fd);
     if (xrootdfs.cns != NULL)
@@ -439,6 +469,7 @@ static int xrootdfs_create(const char *path, mode_t mode, struct fuse_file_info
     int res, fd;
     if (!S_ISREG(mode))
         return -EPERM;
+    XrdFfsDent_attr_clear(path);
     res = xrootdfs_do_create(path, xrootdfs.rdr, O_CREAT | O_WRONLY, true, &fd);
     fi->fh = fd;
     XrdFfsWcache_create(fd);    // Unlike mknod and like open, prepare wcache.
@@ -473,6 +504,7 @@ static int xrootdfs_mkdir(const char *path, mode_t mode)
     XrdFfsMisc_xrd_secsss_register(fuse_get_context()->uid, fuse_get_context()->gid, 0);
     XrdFfsMisc_xrd_secsss_editurl(rootpath, fuse_get_context()->uid, 0);
 
+    XrdFfsDent_attr_clear(path);
     res = XrdFfsPosix_mkdir(rootpath, mode);
     if (res == 0) return 0;
 /* 
@@ -493,6 +525,7 @@ static int xrootdfs_unlink(const char *path)
     int res;
     char rootpath[MAXROOTURLLEN];
 
+    XrdFfsDent_attr_clear(path);
     rootpath[0]='\0';
     strncat(rootpath,xrootdfs.rdr, MAXROOTURLLEN - strlen(rootpath) -1);
     strncat(rootpath,path, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -529,6 +562,7 @@ static int xrootdfs_rmdir(const char *path)
 //  struct stat stbuf;
     char rootpath[MAXROOTURLLEN];
 
+    XrdFfsDent_attr_clear(path);
     rootpath[0]='\0';
     strncat(rootpath,xrootdfs.rdr, MAXROOTURLLEN - strlen(rootpath) -1);
     strncat(rootpath,path, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -610,6 +644,9 @@ static int xrootdfs_rename(const char *from, const char *to)
     if (S_ISDIR(stbuf.st_mode)) /* && xrootdfs.cns == NULL && xrootdfs.ofsfwd == false) */
         return -EXDEV;
 
+    XrdFfsDent_attr_clear(from);
+    XrdFfsDent_attr_clear(to);
+
     if (xrootdfs.ofsfwd == true)
         res = XrdFfsPosix_rename(from_path, to_path);
     else
@@ -684,6 +721,7 @@ static int xrootdfs_ftruncate(const char *path, off_t size,
 //  char rootpath[1024];
                                                                                                                                            
     fd = (int) fi->fh;
+    XrdFfsDent_attr_clear(path);
     XrdFfsWcache_flush(fd);
     res = XrdFfsPosix_ftruncate(fd, size);
     if (res == -1)
@@ -712,6 +750,7 @@ static int xrootdfs_truncate(const char *path, off_t size)
     int res;
     char rootpath[MAXROOTURLLEN];
 
+    XrdFfsDent_attr_clear(path);
     rootpath[0]='\0';
     strncat(rootpath,xrootdfs.rdr, MAXROOTURLLEN - strlen(rootpath) -1);
     strncat(rootpath,path, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -813,6 +852,7 @@ static int xrootdfs_write(const char *path, const char *buf, size_t size,
    truncate a file before calling xrootdfs_write() 
 */
     fd = (int) fi->fh;
+    XrdFfsDent_attr_clear(path);  /* the size is changing */
 //    res = XrdFfsPosix_pwrite(fd, buf, size, offset);
     res = XrdFfsWcache_pwrite(fd, (char *)buf, size, offset);
     if (res == -1)
@@ -902,6 +942,8 @@ static int xrootdfs_release(const char *path, struct fuse_file_info *fi)
     XrdFfsWcache_destroy(fd);
     XrdFfsPosix_close(fd);
     fi->fh = 0;
+    if ((fi->flags & O_ACCMODE) != O_RDONLY)
+        XrdFfsDent_attr_clear(path);
 /* 
    Return at here because the current version of Cluster Name Space daemon 
    doesn't implement the 'truncate' functon we originally planned.
@@ -1223,7 +1265,12 @@ static void xrootdfs_usage(const char *progname)
 "                                 Absents of this option will disable automatically refreshing\n"
 "    -o maxfd=N               number of virtual file descriptors for posix requests, default 8192 (min 2048)\n"
 "    -o nworkers=N            number of workers to handle parallel requests to data servers, default 4\n"
+"    -o maxworkers=N          start more workers, up to N, when there are more data servers than idle workers,\n"
+"                             default 128\n"
 "    -o fastls=RDR            set to RDR when CNS is presented will cause stat() to go to redirector\n"
+"    -o attrcache=N           keep file attributes from readdir()/stat() for N seconds, default 0 (disabled),\n"
+"                             not used with sss\n"
+"    -o readahead=0|1         prefetch ahead of sequential reads, default 1\n"
 "\n", progname);
 }
 
@@ -1359,7 +1406,22 @@ int main(int argc, char *argv[])
     xrootdfs_opts[12].offset = offsetof(struct XROOTDFS, maxfd);
     xrootdfs_opts[12].value = 0;
 
-    xrootdfs_opts[13].templ = NULL;
+/* life time of the attribute cache */
+    xrootdfs_opts[13].templ = "attrcache=%d";
+    xrootdfs_opts[13].offset = offsetof(struct XROOTDFS, attrcache);
+    xrootdfs_opts[13].value = 0;
+
+/* read ahead of sequential readers */
+    xrootdfs_opts[14].templ = "readahead=%d";
+    xrootdfs_opts[14].offset = offsetof(struct XROOTDFS, readahead);
+    xrootdfs_opts[14].value = 0;
+
+/* upper limit of the workers started on demand */
+    xrootdfs_opts[15].templ = "maxworkers=%d";
+    xrootdfs_opts[15].offset = offsetof(struct XROOTDFS, maxworkers);
+    xrootdfs_opts[15].value = 0;
+
+    xrootdfs_opts[16].templ = NULL;
 
 /* initialize struct xrootdfs */
 //    memset(&xrootdfs, 0, sizeof(xrootdfs));
@@ -1371,7 +1433,10 @@ int main(int argc, char *argv[])
     xrootdfs.ssskeytab = NULL;
     xrootdfs.urlcachelife = strdup("3650d"); /* 10 years */
     xrootdfs.nworkers = 4;
+    xrootdfs.maxworkers = 128;
     xrootdfs.maxfd = 8192;
+    xrootdfs.attrcache = 0;
+    xrootdfs.readahead = 1;
 
 /* Get options from environment variables first */
     xrootdfs.rdr = getenv("XROOTDFS_RDRURL");
@@ -1381,7 +1446,10 @@ int main(int argc, char *argv[])
     xrootdfs.daemon_user = getenv("XROOTDFS_USER");
     if (getenv("XROOTDFS_OFSFWD") != NULL && ! strcmp(getenv("XROOTDFS_OFSFWD"),"1")) xrootdfs.ofsfwd = true;
     if (getenv("XROOTDFS_NWORKERS") != NULL) sscanf(getenv("XROOTDFS_NWORKERS"), "%d", &xrootdfs.nworkers);
+    if (getenv("XROOTDFS_MAXWORKERS") != NULL) sscanf(getenv("XROOTDFS_MAXWORKERS"), "%d", &xrootdfs.maxworkers);
     if (getenv("XROOTDFS_MAXFD") != NULL) sscanf(getenv("XROOTDFS_MAXFD"), "%d", &xrootdfs.maxfd);
+    if (getenv("XROOTDFS_ATTRCACHE") != NULL) sscanf(getenv("XROOTDFS_ATTRCACHE"), "%d", &xrootdfs.attrcache);
+    if (getenv("XROOTDFS_READAHEAD") != NULL) sscanf(getenv("XROOTDFS_READAHEAD"), "%d", &xrootdfs.readahead);
 
 /* Parse XrootdFS options, will overwrite those defined in environment variables */
     fuse_opt_parse(&args, &xrootdfs, xrootdfs_opts, xrootdfs_opt_proc);
@@ -31,6 +31,7 @@
 #include <string.h>
 #include <strings.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
@@ -38,6 +39,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <vector>
+
 #include "XrdFrc/XrdFrcCID.hh"
 #include "XrdFrc/XrdFrcReqFile.hh"
 #include "XrdFrc/XrdFrcTrace.hh"
@@ -57,7 +60,7 @@ XrdSysMutex XrdFrcReqFile::rqMonitor::rqMutex;
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
 
-XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal)
+XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal) : cmCond(0)
 {
    char buff[1200];
 
@@ -67,6 +70,10 @@ XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal)
    lokFN = strdup(buff);
    lokFD = reqFD = -1;
    isAgent = aVal;
+   cmFirst = cmLast = 0;
+   cmBusy  = 0;
+   idxEnd  = 0;
+   idxBase = idxRecs = 0;
 }
   
 /******************************************************************************/
@@ -75,47 +82,15 @@ XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal)
   
 void XrdFrcReqFile::Add(XrdFrcRequest *rP)
 {
-   rqMonitor rqMon(isAgent);
-   XrdFrcRequest tmpReq;
-   int fP;
-
-// Lock the file
-//
-   if (!FileLock()) {FailAdd(rP->LFN, 0); return;}
+   LogRec theRec;
 
-// Obtain a free slot
+// Log the request, it is on disk once the commit returns
 //
-   if ((fP = HdrData.Free))
-      {if (!reqRead((void *)&tmpReq, fP)) {FailAdd(rP->LFN, 1); return;}
-       HdrData.Free = tmpReq.Next;
-      } else {
-       struct stat buf;
-       if (fstat(reqFD, &buf))
-          {Say.Emsg("Add",errno,"stat",reqFN); FailAdd(rP->LFN, 1); return;}
-       fP = buf.st_size;
-      }
-
-// Chain in the request (registration requests go fifo)
-//
-   if (rP->Options & XrdFrcRequest::Register)
-      {if (!(rP->Next = HdrData.First)) HdrData.Last = fP;
-       HdrData.First = fP;
-      } else {
-       if (HdrData.First && HdrData.Last)
-          {if (!reqRead((void *)&tmpReq, HdrData.Last))
-              {FailAdd(rP->LFN, 1); return;}
-           tmpReq.Next = fP;
-           if (!reqWrite((void *)&tmpReq, HdrData.Last, 0))
-              {FailAdd(rP->LFN, 1); return;}
-          } else HdrData.First = fP;
-       HdrData.Last = fP; rP->Next = 0;
-      }
-
-// Write out the file
-//
-   rP->This = fP;
-   if (!reqWrite(rP, fP)) FailAdd(rP->LFN, 0);
-   FileLock(lkNone);
+   theRec.reqData = *rP;
+   theRec.Op      = opAdd;
+   theRec.Magic   = recMagic;
+   if (!Commit(theRec)) FailAdd(rP->LFN, 0);
+      else rP->This = theRec.reqData.This;
 }
   
 /******************************************************************************/
@@ -125,38 +100,33 @@ void XrdFrcReqFile::Add(XrdFrcRequest *rP)
 void XrdFrcReqFile::Can(XrdFrcRequest *rP)
 {
    rqMonitor rqMon(isAgent);
-   XrdFrcRequest tmpReq;
-   int Offs, numCan = 0, numBad = 0;
-   struct stat buf;
+   idxMap::iterator it;
+   LogRec theRec;
+   int numCan = 0, numBad = 0;
    char txt[128];
 
-// Lock the file and get its size
-//
-   if (!FileLock() || fstat(reqFD, &buf)) {FailCan(rP->ID, 0); return;}
-
-// Run through all of the file entries removing matching requests
+// Lock the file and find out whether there is anything to cancel
 //
-   for (Offs = ReqSize; Offs < buf.st_size; Offs += ReqSize)
-       {if (!reqRead((void *)&tmpReq, Offs)) return FailCan(rP->ID);
-        if (!strcmp(tmpReq.ID, rP->ID))
-           {tmpReq.LFN[0] = '\0';
-            if (!reqWrite((void *)&tmpReq, Offs, 0)) numBad++;
-               else numCan++;
-           }
-       }
+   if (!FileLock(lkShare)) {FailCan(rP->ID, 0); return;}
+   if (!Tail()) {FailCan(rP->ID); return;}
+   for (it = idxLive.begin(); it != idxLive.end(); it++)
+       if (!strcmp(it->second.ID, rP->ID)) numCan++;
+   FileLock(lkNone);
+   if (!numCan) return;
 
-// Make sure this is written to disk
+// Log the cancellation, the requests go away when the log is replayed
 //
-   if (numCan) fsync(reqFD);
+   memset(&theRec, 0, sizeof(theRec));
+   strlcpy(theRec.reqData.ID, rP->ID, sizeof(theRec.reqData.ID));
+   theRec.Op    = opCan;
+   theRec.Magic = recMagic;
+   if (!Commit(theRec)) {numBad = numCan; numCan = 0;}
 
 // Document the action
 //
-   if (numCan || numBad)
-      {sprintf(txt, "has %d entries; %d removed (%d failures).",
-                    numCan+numBad, numCan, numBad);
-       Say.Emsg("Can", rP->ID, txt);
-      }
-   FileLock(lkNone);
+   sprintf(txt, "has %d entries; %d removed (%d failures).",
+                numCan+numBad, numCan, numBad);
+   Say.Emsg("Can", rP->ID, txt);
 }
   
 /******************************************************************************/
@@ -165,20 +135,15 @@ void XrdFrcReqFile::Can(XrdFrcRequest *rP)
 
 void XrdFrcReqFile::Del(XrdFrcRequest *rP)
 {
-   rqMonitor rqMon(isAgent);
-   XrdFrcRequest tmpReq;
-
-// Lock the file
-//
-   if (!FileLock()) {FailDel(rP->LFN, 0); return;}
+   LogRec theRec;
 
-// Put entry on the free chain
+// Log the deletion of the request with this key
 //
-   memset(&tmpReq, 0, sizeof(tmpReq));
-   tmpReq.Next  = HdrData.Free;
-   HdrData.Free = rP->This;
-   if (!reqWrite((void *)&tmpReq, rP->This)) FailDel(rP->LFN, 0);
-   FileLock(lkNone);
+   memset(&theRec, 0, sizeof(theRec));
+   theRec.reqData.This = rP->This;
+   theRec.Op           = opDel;
+   theRec.Magic        = recMagic;
+   if (!Commit(theRec)) FailDel(rP->LFN, 0);
 }
 
 /******************************************************************************/
@@ -187,24 +152,29 @@ void XrdFrcReqFile::Del(XrdFrcRequest *rP)
   
 int XrdFrcReqFile::Get(XrdFrcRequest *rP)
 {
-   int fP, rc;
+   idxMap::iterator it;
+   int rc = 0;
 
-// Lock the file
+// Lock the file and pick up whatever was added to the log
 //
    if (!FileLock()) return 0;
+   if (!Tail()) {FileLock(lkNone); return 0;}
+
+// Get the next request that is still live, the request stays in the log
+// until it is deleted.
+//
+   while(!idxPend.empty())
+        {if ((it = idxLive.find(idxPend.front())) == idxLive.end())
+            {idxPend.pop_front(); continue;}
+         if (!reqRead((void *)rP, it->second.Offs)) break;
+         idxPend.pop_front();
+         rc = (idxPend.empty() ? -1 : 1);
+         break;
+        }
 
-// Get the next request
+// Compact the log once it mostly holds dead requests
 //
-   while((fP = HdrData.First))
-        {if (!reqRead((void *)rP, fP)) {FileLock(lkNone); return 0;}
-         HdrData.First= rP->Next;
-         if (*(rP->LFN)) {reqWrite(0,0,1); break;}
-         rP->Next     = HdrData.Free;
-         HdrData.Free = fP;
-         if (!reqWrite(rP, fP)) {fP = 0; break;}
-      }
-   if (fP) rc = (HdrData.First ? 1 : -1);
-      else rc = 0;
+   if (idxRecs > 1024 && idxRecs/4 > int(idxLive.size())) ReWrite(0);
    FileLock(lkNone);
    return rc;
 }
@@ -217,10 +187,8 @@ int XrdFrcReqFile::Init()
 {
    EPNAME("Init");
    static const int Mode = S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH;
-   XrdFrcRequest tmpReq;
    struct stat buf;
-   recEnt *RegList = 0, *First = 0, *rP, *pP, *tP;
-   int    Offs, rc, numreq = 0;
+   int rc;
 
 // Open the lock file first in r/w mode
 //
@@ -242,61 +210,30 @@ int XrdFrcReqFile::Init()
 // Check for a new file here
 //
    if (fstat(reqFD, &buf)) return FailIni("stat");
-   if (buf.st_size < ReqSize)
-      {memset(&tmpReq, 0, sizeof(tmpReq));
-       HdrData.Free = ReqSize;
-       if (!reqWrite((void *)&tmpReq, ReqSize)) return FailIni("init file");
+   if (buf.st_size < RecSize)
+      {idxBase = 1;
+       rc = ReWrite(1);
        FileLock(lkNone);
-       return 1;
+       return rc;
       }
 
-// We are done if this is a agent
+// Convert a file in the old format (a chain of request slots)
 //
-   if (isAgent)
-      {FileLock(lkNone);
-       return 1;
-      }
-
-// Read the full file
-//
-   for (Offs = ReqSize; Offs < buf.st_size; Offs += ReqSize)
-       {if (!reqRead((void *)&tmpReq, Offs)) return FailIni("read file");
-        if (*tmpReq.LFN == '\0' || !tmpReq.addTOD
-        ||  tmpReq.Opaque >= int(sizeof(tmpReq.LFN))) continue;
-        pP = 0; rP = First; tP = new recEnt(tmpReq); numreq++;
-        if (tmpReq.Options & XrdFrcRequest::Register)
-           {tP->Next = RegList; RegList = tP;
-           } else {
-            while(rP && rP->reqData.addTOD < tmpReq.addTOD) {pP=rP;rP=rP->Next;}
-            if (pP) pP->Next = tP;
-               else First    = tP;
-            tP->Next = rP;
-           }
-       }
-
-// Plase registration requests in the front
-//
-   while((rP = RegList))
-        {RegList = rP->Next;
-         rP->Next = First;
-         First = rP;
-        }
-
-// Now write out the file
-//
-   DEBUG(numreq <<" request(s) recovered from " <<reqFN);
-   rc = ReWrite(First);
+   do {rc = pread(reqFD, (void *)&HdrData, sizeof(HdrData), 0);}
+       while(rc < 0 && errno == EINTR);
+   if (rc < 0) return FailIni("read header");
+   if (HdrData.Magic != logMagic) rc = Convert(buf.st_size);
 
-// Delete all the entries in memory while referencing known instance names
+// We are done if this is a agent. Otherwise replay the log and write out a
+// fresh copy of it holding only the live requests.
 //
-   while((tP = First)) 
-        {First = tP->Next;
-         CID.Ref(tP->reqData.iName);
-         delete tP;
-        }
+      else if (isAgent) rc = 1;
+              else rc = Tail() && ReWrite(1);
 
 // All done
 //
+   if (rc && !isAgent)
+      {DEBUG(idxLive.size() <<" request(s) recovered from " <<reqFN);}
    FileLock(lkNone);
    return rc;
 }
@@ -310,40 +247,32 @@ char  *XrdFrcReqFile::List(char *Buff, int bsz, int &Offs,
 {
    rqMonitor rqMon(isAgent);
    XrdFrcRequest tmpReq;
-   int rc;
-
-// Set Offs argument
-//
-   if (Offs < ReqSize) Offs = ReqSize;
+   idxMap::iterator it;
 
-// Lock the file
+// Lock the file and pick up whatever was added to the log
 //
    if (!FileLock(lkShare)) return 0;
+   if (!Tail()) {FileLock(lkNone); return 0;}
 
-// Return next valid filename
-//
-   do{do {rc = pread(reqFD, (void *)&tmpReq, ReqSize, Offs);}
-          while(rc < 0 && errno == EINTR);
-      if (rc == ReqSize)
-         {Offs += ReqSize;
-          if (*tmpReq.LFN == '\0' || !tmpReq.addTOD
-          ||  tmpReq.Opaque >= int(sizeof(tmpReq.LFN))
-          ||  tmpReq.Options & XrdFrcRequest::Register) continue;
-          FileLock(lkNone);
-          if (!ITNum || !ITList) strlcpy(Buff, tmpReq.LFN, bsz);
-             else ListL(tmpReq, Buff, bsz, ITList, ITNum);
-          return Buff;
-         }
-     } while(rc == ReqSize);
+// Find the next request, Offs holds the key to start with
+//
+   for (it = idxLive.lower_bound(Offs); it != idxLive.end(); it++)
+       if (!(it->second.isReg)) break;
 
-// Diagnose ending condition
+// Return end of list if there is none
 //
-   if (rc < 0) Say.Emsg("List",errno,"read",reqFN);
+   if (it == idxLive.end() || !reqRead((void *)&tmpReq, it->second.Offs))
+      {FileLock(lkNone);
+       return 0;
+      }
 
-// Return end of list
+// Return the filename
 //
+   Offs = it->first + 1;
    FileLock(lkNone);
-   return 0;
+   if (!ITNum || !ITList) strlcpy(Buff, tmpReq.LFN, bsz);
+      else ListL(tmpReq, Buff, bsz, ITList, ITNum);
+   return Buff;
 }
 
 /******************************************************************************/
@@ -533,11 +462,139 @@ int XrdFrcReqFile::FileLock(LockType lktype)
    return 1;
 }
 
+/******************************************************************************/
+/*                                A p p e n d                                 */
+/******************************************************************************/
+  
+int XrdFrcReqFile::Append(XrdFrcReqFile::cmReq *rP)
+{
+   struct stat buf;
+   cmReq *tP;
+   char *buff;
+   long long Offs;
+   int n = 0, doSync = 0, aOK;
+
+// Get a buffer for all of the records
+//
+   for (tP = rP; tP; tP = tP->Next) n++;
+   if (!(buff = (char *)malloc(n*RecSize)))
+      {Say.Emsg("Append", ENOMEM, "append to", reqFN); return 0;}
+
+// Lock the file, records are appended past the last complete record
+//
+   if (!FileLock()) {free(buff); return 0;}
+   if (fstat(reqFD, &buf))
+      {Say.Emsg("Append",errno,"stat",reqFN);
+       FileLock(lkNone); free(buff);
+       return 0;
+      }
+   Offs = (buf.st_size + RecSize - 1) / RecSize * RecSize;
+
+// Key the new requests by where they land in the log and gather the records
+//
+   for (tP = rP, n = 0; tP; tP = tP->Next, n++)
+       {if (tP->Rec->Op == opAdd)
+           tP->Rec->reqData.This = HdrData.Base + n
+                                 + static_cast<int>((Offs-RecSize)/RecSize);
+        if (tP->Rec->Op != opDel) doSync = 1;
+        memcpy(buff + n*RecSize, tP->Rec, RecSize);
+       }
+
+// Write them out at once. Losing a deletion merely redoes the request after
+// a crash, so only additions and cancellations need to be synced.
+//
+   aOK = reqWrite(buff, n*RecSize, Offs);
+   if (aOK && doSync && fsync(reqFD))
+      {Say.Emsg("Append",errno,"sync",reqFN); aOK = 0;}
+   FileLock(lkNone);
+   free(buff);
+   return aOK;
+}
+
+/******************************************************************************/
+/*                                C o m m i t                                 */
+/******************************************************************************/
+  
+int XrdFrcReqFile::Commit(XrdFrcReqFile::LogRec &theRec)
+{
+   cmReq myReq(&theRec), *bP, *nP;
+   int aOK;
+
+// Queue the record
+//
+   cmCond.Lock();
+   if (cmLast) cmLast->Next = &myReq;
+      else     cmFirst      = &myReq;
+   cmLast = &myReq;
+
+// Wait for whoever is writing, if nobody is we write out everything that has
+// been queued so far (our record included).
+//
+   while(!myReq.Done)
+        {if (cmBusy) {cmCond.Wait(); continue;}
+         bP = cmFirst; cmFirst = cmLast = 0; cmBusy = 1;
+         cmCond.UnLock();
+         aOK = Append(bP);
+         cmCond.Lock();
+         while(bP) {nP = bP->Next; bP->aOK = aOK; bP->Done = 1; bP = nP;}
+         cmBusy = 0;
+         cmCond.Broadcast();
+        }
+
+// All done
+//
+   aOK = myReq.aOK;
+   cmCond.UnLock();
+   return aOK;
+}
+
+/******************************************************************************/
+/*                               C o n v e r t                                */
+/******************************************************************************/
+  
+int XrdFrcReqFile::Convert(long long fSize)
+{
+   typedef std::multimap<long long, idxEnt> todMap;
+   XrdFrcRequest tmpReq;
+   todMap byTOD;
+   todMap::iterator it;
+   idxEnt theEnt;
+   long long Offs;
+   int Key = 1;
+
+// Pick up the requests in the old style file
+//
+   for (Offs = ReqSize; Offs + ReqSize <= fSize; Offs += ReqSize)
+       {if (!reqRead((void *)&tmpReq, Offs)) return 0;
+        if (*tmpReq.LFN == '\0' || !tmpReq.addTOD
+        ||  tmpReq.Opaque >= int(sizeof(tmpReq.LFN))) continue;
+        theEnt.Offs  = Offs;
+        theEnt.isReg = (tmpReq.Options & XrdFrcRequest::Register) != 0;
+        strlcpy(theEnt.ID, tmpReq.ID, sizeof(theEnt.ID));
+        byTOD.insert(todMap::value_type(tmpReq.addTOD, theEnt));
+       }
+
+// Index them oldest first placing registration requests in the front
+//
+   idxLive.clear(); idxPend.clear();
+   for (it = byTOD.begin(); it != byTOD.end(); it++, Key++)
+       {idxLive[Key] = it->second;
+        if (it->second.isReg) idxPend.push_front(Key);
+           else idxPend.push_back(Key);
+       }
+   idxBase = 1; idxRecs = 0;
+
+// Now write out the log
+//
+   Say.Emsg("Init", "Converting", reqFN, "to a request log.");
+   return ReWrite(1);
+}
+
 /******************************************************************************/
 /*                               r e q R e a d                                */
 /******************************************************************************/
   
-int XrdFrcReqFile::reqRead(void *Buff, int Offs)
+int XrdFrcReqFile::reqRead(void *Buff, long long Offs)
 {
    int rc;
 
@@ -550,74 +607,209 @@ int XrdFrcReqFile::reqRead(void *Buff, int Offs)
 /*                              r e q W r i t e                               */
 /******************************************************************************/
   
-int XrdFrcReqFile::reqWrite(void *Buff, int Offs, int updthdr)
+int XrdFrcReqFile::reqWrite(void *Buff, int Blen, long long Offs, int theFD)
 {
-   int rc = 0;
+   int rc;
 
-   if (Buff && Offs)       do {rc = pwrite(reqFD, Buff, ReqSize, Offs);}
-                              while(rc < 0 && errno == EINTR);
-   if (rc >= 0 && updthdr){do {rc = pwrite(reqFD,&HdrData, sizeof(HdrData), 0);}
-                              while(rc < 0 && errno == EINTR);
-                           if (rc >= 0) rc = fsync(reqFD);
-                          }
+   if (theFD < 0) theFD = reqFD;
+   do {rc = pwrite(theFD, Buff, Blen, Offs);} while(rc < 0 && errno == EINTR);
+   if (rc >= 0 && rc != Blen) {rc = -1; errno = ENOSPC;}
    if (rc < 0) {Say.Emsg("reqWrite",errno,"write", reqFN); return 0;}
    return 1;
 }
 
+/******************************************************************************/
+/*                                R e p l a y                                 */
+/******************************************************************************/
+  
+void XrdFrcReqFile::Replay(XrdFrcReqFile::LogRec &theRec, long long Offs)
+{
+   XrdFrcRequest &Req = theRec.reqData;
+   idxMap::iterator it;
+   idxEnt theEnt;
+
+   switch(theRec.Op)
+         {case opAdd:
+               if (*Req.LFN == '\0' || !Req.addTOD
+               ||  Req.Opaque >= int(sizeof(Req.LFN))) break;
+               theEnt.Offs  = Offs;
+               theEnt.isReg = (Req.Options & XrdFrcRequest::Register) != 0;
+               strlcpy(theEnt.ID, Req.ID, sizeof(theEnt.ID));
+               if (!idxLive.insert(idxMap::value_type(Req.This,theEnt)).second)
+                  break;
+               if (theEnt.isReg) idxPend.push_front(Req.This);
+                  else idxPend.push_back(Req.This);
+               break;
+
+          case opDel:
+               idxLive.erase(Req.This);
+               break;
+
+          case opCan:
+               for (it = idxLive.begin(); it != idxLive.end();)
+                   if (!strcmp(it->second.ID, Req.ID)) idxLive.erase(it++);
+                      else it++;
+               break;
+
+          default: break;
+         }
+}
+
 /******************************************************************************/
 /*                               R e W r i t e                                */
 /******************************************************************************/
   
-int XrdFrcReqFile::ReWrite(XrdFrcReqFile::recEnt *rP)
+int XrdFrcReqFile::ReWrite(int Fresh)
 {
-   static const int Mode = S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH;
-   char newFN[MAXPATHLEN], *oldFN;
-   int  newFD, oldFD, Offs = ReqSize, aOK = 1;
+   static const int Mode  = S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH;
+   static const int bRecs = 64;
+   idxMap newLive;
+   std::list<int> newPend;
+   std::list<int>::iterator pit;
+   std::vector<int> Keys;
+   idxMap::iterator it;
+   FileHdr newHdr;
+   LogRec *lrP;
+   char newFN[MAXPATHLEN], *buff;
+   long long Offs = RecSize, bOffs = 0;
+   int newFD, Key, n = 1, aOK = 1;
+
+// Pick the requests to keep. A fresh log holds the pending requests in
+// processing order under new keys. Otherwise we keep all the live requests,
+// keys and all, as some of them may be in progress.
+//
+   if (Fresh)
+      {for (pit = idxPend.begin(); pit != idxPend.end(); pit++)
+           if (idxLive.find(*pit) != idxLive.end()) Keys.push_back(*pit);
+      } else {
+       for (it = idxLive.begin(); it != idxLive.end(); it++)
+           Keys.push_back(it->first);
+      }
+
+// The keys in the new log must not collide with the old ones
+//
+   memset(&newHdr, 0, sizeof(newHdr));
+   newHdr.Magic = logMagic;
+   newHdr.Base  = Key = idxBase + idxRecs;
+   if (Fresh)
+      {if (Key > 0x40000000) Key = 1;
+       newHdr.Base = Key + Keys.size();
+      }
 
 // Construct new file and open it
 //
    strcpy(newFN, reqFN); strcat(newFN, ".new");
    if ((newFD = XrdSysFD_Open(newFN, O_RDWR|O_CREAT|O_TRUNC, Mode)) < 0)
-      {Say.Emsg("ReWrite",errno,"open",newFN); FileLock(lkNone); return 0;}
-
-// Setup to write/swap the file
-//
-   oldFD = reqFD; reqFD = newFD;
-   oldFN = reqFN; reqFN = newFN;
+      {Say.Emsg("ReWrite",errno,"open",newFN); return 0;}
+   if (!(buff = (char *)calloc(bRecs, RecSize)))
+      {Say.Emsg("ReWrite", ENOMEM, "rewrite", reqFN);
+       close(newFD); unlink(newFN);
+       return 0;
+      }
+   memcpy(buff, &newHdr, sizeof(newHdr));
 
-// Rewrite all records if we have any
+// Copy the requests over
 //
-   if (rP)
-      {HdrData.First = Offs;
-       while(rP)
-            {rP->reqData.This = Offs;
-             rP->reqData.Next = (rP->Next ? Offs+ReqSize : 0);
-             if (!reqWrite((void *)&rP->reqData, Offs, 0)) {aOK = 0; break;}
-             Offs += ReqSize;
-             rP = rP->Next;
-            }
-       HdrData.Last = Offs - ReqSize;
-      } else {
-       HdrData.First = HdrData.Last = 0;
-       if (ftruncate(newFD, ReqSize) < 0)
-          {Say.Emsg("ReWrite",errno,"trunc",newFN); aOK = 0;}
-      }
+   for (int i = 0; i < int(Keys.size()) && aOK; i++)
+       {idxEnt theEnt = idxLive[Keys[i]];
+        lrP = (LogRec *)(buff + n*RecSize);
+        if (!reqRead((void *)&lrP->reqData, theEnt.Offs)) {aOK = 0; break;}
+        if (Fresh)
+           {lrP->reqData.This = Key++;
+            if (!isAgent) CID.Ref(lrP->reqData.iName);
+           }
+        lrP->Op    = opAdd;
+        lrP->Magic = recMagic;
+        theEnt.Offs = Offs; Offs += RecSize;
+        newLive[lrP->reqData.This] = theEnt;
+        if (Fresh) newPend.push_back(lrP->reqData.This);
+        if (++n >= bRecs)
+           {aOK = reqWrite(buff, n*RecSize, bOffs, newFD);
+            bOffs += n*RecSize; n = 0;
+           }
+       }
 
-// Update the header
+// Write out what is left and make sure it is on disk
 //
-   HdrData.Free = 0;
-   if (aOK && !(aOK = reqWrite(0, 0)))
-      Say.Emsg("ReWrite",errno,"write header",newFN);
+   if (aOK && n) aOK = reqWrite(buff, n*RecSize, bOffs, newFD);
+   if (aOK && fsync(newFD))
+      {Say.Emsg("ReWrite",errno,"sync",newFN); aOK = 0;}
+   free(buff);
 
 // If all went well, rename the file
 //
-   if (aOK && rename(newFN, oldFN) < 0)
+   if (aOK && rename(newFN, reqFN) < 0)
       {Say.Emsg("ReWrite",errno,"rename",newFN); aOK = 0;}
+   if (!aOK) {close(newFD); unlink(newFN); return 0;}
 
-// Perform post processing
+// The rename only survives a crash once the directory is on disk as well.
+// The new log is complete either way, so a failure here is merely noted.
 //
-   if (aOK)  close(oldFD);
-      else  {close(newFD); reqFD = oldFD;}
-   reqFN = oldFN;
-   return aOK;
+   if ((buff = strrchr(newFN, '/'))) *(buff+1) = 0;
+      else strcpy(newFN, ".");
+   if ((n = XrdSysFD_Open(newFN, O_RDONLY)) < 0 || fsync(n))
+      Say.Emsg("ReWrite", errno, "sync directory", newFN);
+   if (n >= 0) close(n);
+
+// Switch over to the new log. Requests in progress remain in progress.
+//
+   if (!Fresh)
+      {for (pit = idxPend.begin(); pit != idxPend.end(); pit++)
+           if (newLive.find(*pit) != newLive.end()) newPend.push_back(*pit);
+      }
+   close(reqFD); reqFD = newFD;
+   HdrData = newHdr;
+   idxLive.swap(newLive);
+   idxPend.swap(newPend);
+   idxBase = newHdr.Base;
+   idxRecs = Keys.size();
+   idxEnd  = Offs;
+   return 1;
+}
+
+/******************************************************************************/
+/*                                  T a i l                                   */
+/******************************************************************************/
+  
+int XrdFrcReqFile::Tail()
+{
+   static const int bRecs = 64;
+   struct stat buf;
+   long long Last;
+   char *buff;
+   int i, n, rc;
+
+// Start over if the log was rewritten since we last looked at it
+//
+   if (fstat(reqFD, &buf)) {Say.Emsg("Tail",errno,"stat",reqFN); return 0;}
+   if (HdrData.Base != idxBase || buf.st_size < idxEnd)
+      {idxLive.clear(); idxPend.clear();
+       idxBase = HdrData.Base; idxRecs = 0; idxEnd = RecSize;
+      }
+
+// Replay the complete records appended since then
+//
+   Last = buf.st_size / RecSize * RecSize;
+   if (idxEnd >= Last) return 1;
+   if (!(buff = (char *)malloc(bRecs*RecSize)))
+      {Say.Emsg("Tail", ENOMEM, "replay", reqFN); return 0;}
+
+   while(idxEnd < Last)
+        {n = (Last - idxEnd)/RecSize;
+         if (n > bRecs) n = bRecs;
+         do {rc = pread(reqFD, buff, n*RecSize, idxEnd);}
+            while(rc < 0 && errno == EINTR);
+         if (rc < 0) {Say.Emsg("Tail",errno,"read",reqFN); free(buff); return 0;}
+         if (!(n = rc/RecSize)) break;
+         for (i = 0; i < n; i++, idxEnd += RecSize)
+             {LogRec *lrP = (LogRec *)(buff + i*RecSize);
+              if (lrP->Magic == recMagic) Replay(*lrP, idxEnd);
+             }
+         idxRecs += n;
+        }
+
+// All done
+//
+   free(buff);
+   return 1;
 }
@@ -30,9 +30,21 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <list>
+#include <map>
+#include <sys/types.h>
+
 #include "XrdFrc/XrdFrcRequest.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
+// The request file is a log of fixed length records, each one adding a
+// request, deleting a request that has been processed, or cancelling all of
+// the requests with a given id. Records are only ever appended and the
+// appends of concurrent callers are committed by a single write and fsync.
+// The queue itself is an index in memory built by replaying the log (the
+// agents only build it when they list the queue). The server compacts the
+// log once it mostly holds dead requests.
+//
 class XrdFrcReqFile
 {
 public:
@@ -61,21 +73,42 @@ enum LockType {lkNone, lkShare, lkExcl, lkInit};
 
 static const int ReqSize  = sizeof(XrdFrcRequest);
 
+// Log records, the magic number at the end marks a complete record
+//
+static const int logMagic = 0x46524c47;   // Header ("FRLG")
+static const int recMagic = 0x46525251;   // Record ("FRRQ")
+static const int opAdd    = 1;
+static const int opDel    = 2;            // This holds the key
+static const int opCan    = 3;            // ID   holds the request id
+
+struct LogRec
+{
+XrdFrcRequest reqData;
+int           Op;
+int           Magic;
+};
+
+static const int RecSize  = sizeof(LogRec);
+
 void   FailAdd(char *lfn, int unlk=1);
 void   FailCan(char *rid, int unlk=1);
 void   FailDel(char *lfn, int unlk=1);
 int    FailIni(const char *lfn);
 int    FileLock(LockType ltype=lkExcl);
-int    reqRead(void *Buff, int Offs);
-int    reqWrite(void *Buff, int Offs, int updthdr=1);
+int    reqRead(void *Buff, long long Offs);
+int    reqWrite(void *Buff, int Blen, long long Offs, int theFD=-1);
 
 XrdSysMutex flMutex;
 
+// The header occupies the first record (record 0), so the key of a request
+// added in record r is Base+r-1 (i.e., Base plus the number of records that
+// precede it after the header). Keys are never reused, so the Base of a
+// rewritten log is always past the keys of the log it replaces.
+//
 struct FileHdr
 {
-int    First;
-int    Last;
-int    Free;
+int    Magic;
+int    Base;
 }      HdrData;
 
 char  *lokFN;
@@ -85,11 +118,44 @@ char  *reqFN;
 
 int    isAgent;
 
-struct recEnt {recEnt       *Next;
-               XrdFrcRequest reqData;
-               recEnt(XrdFrcRequest &reqref) {Next = 0; reqData = reqref;}
+// Group commit, callers queue their records and the first one in line writes
+// all of the queued records while the others wait for it.
+//
+struct cmReq {cmReq  *Next;
+              LogRec *Rec;
+              int     Done;
+              int     aOK;
+              cmReq(LogRec *rP) : Next(0), Rec(rP), Done(0), aOK(0) {}
+             };
+
+int    Append(cmReq *rP);
+int    Commit(LogRec &theRec);
+
+XrdSysCondVar cmCond;
+cmReq        *cmFirst;
+cmReq        *cmLast;
+int           cmBusy;
+
+// The index, all of the live requests by key and the keys that have not yet
+// been handed out by Get() in processing order (it may hold dead keys).
+//
+struct idxEnt {long long Offs;
+               char      isReg;
+               char      ID[sizeof(XrdFrcRequest::ID)];
               };
-int    ReWrite(recEnt *rP);
+
+typedef std::map<int, idxEnt> idxMap;
+
+int    Convert(long long fSize);
+void   Replay(LogRec &theRec, long long Offs);
+int    ReWrite(int Fresh);
+int    Tail();
+
+idxMap         idxLive;
+std::list<int> idxPend;
+long long      idxEnd;
+int            idxBase;
+int            idxRecs;
 
 class rqMonitor
 {
@@ -42,8 +42,8 @@ char      Reserved[88];
 char      iName[32];    // Instance name
 char      csValue[64];  // Checksum value (dependent on csType).
 long long addTOD;       // Time added to queue
-int       This;         // Offset to this request
-int       Next;         // Offset to next request
+int       This;         // Key of this request in the queue
+int       Next;         // Unused (was the offset to next request)
 int       Options;      // Processing options (see below)
 short     LFO;          // Offset to lfn in url if LFN is a url (o/w 0)
 short     Opaque;       // Offset to '?' in LFN if exists, 0 o/w
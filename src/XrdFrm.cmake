@@ -8,6 +8,7 @@ add_library(
   XrdFrm
   STATIC
   XrdFrm/XrdFrmConfig.cc        XrdFrm/XrdFrmConfig.hh
+  XrdFrm/XrdFrmDirIndex.cc      XrdFrm/XrdFrmDirIndex.hh
   XrdFrm/XrdFrmFiles.cc         XrdFrm/XrdFrmFiles.hh
   XrdFrm/XrdFrmMonitor.cc       XrdFrm/XrdFrmMonitor.hh
   XrdFrm/XrdFrmTSort.cc         XrdFrm/XrdFrmTSort.hh
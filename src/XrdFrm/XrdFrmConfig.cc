@@ -154,6 +154,9 @@ XrdFrmConfig::XrdFrmConfig(SubSys ss, const char *vopts, const char *uinfo)
    IdleHold = 10*60;
    WaitMigr = 60*60;
    WaitPurge= 600;
+   ScanThds = 1;
+   ScanIncr = 0;
+   ScanFull = 24*60*60;
    WaitQChk = 300;
    MSSCmd   = 0;
    memset(&xfrCmd, 0, sizeof(xfrCmd));
@@ -1043,6 +1046,7 @@ int XrdFrmConfig::ConfigXeq(char *var, int mbok)
        if (!strcmp(var, "oss.remoteroot")) return Grab(var, &RemoteRoot, 0);
        if (!strcmp(var, "oss.xfr"       )) return xxfr();
        if (!strcmp(var, "frm.all.monitor"))return xmon();
+       if (!strcmp(var, "frm.all.scan"  )) return xscan();
 
        if (!strcmp(var, "copycmd"       )) return xcopy();
        if (!strcmp(var, "copymax"       )) return xcmax();
@@ -1068,6 +1072,7 @@ int XrdFrmConfig::ConfigXeq(char *var, int mbok)
        if (!strcmp(var, "oss.space"     )) return xspace(1);
        if (!strcmp(var, "waittime"      )) return xitm("purge wait",WaitPurge);
        if (!strcmp(var, "frm.all.monitor"))return xmon();
+       if (!strcmp(var, "frm.all.scan"  )) return xscan();
       }
 
    // No match found, complain.
@@ -1943,6 +1948,65 @@ int XrdFrmConfig::xqchk()
    return 0;
 }
 
+/******************************************************************************/
+/*                                 x s c a n                                  */
+/******************************************************************************/
+
+/* Function: xscan
+
+   Purpose:  To parse directive: scan [threads <n>] [incremental [full <tm>]]
+                                      [noincremental]
+
+             threads      the number of threads that index directories during
+                          a name space scan. The default is 1.
+             incremental  skip directories that did not change since the
+                          previous scan. An index of the directories is kept
+                          in the admin path for this purpose.
+             full         how often a full scan is done anyway, as changes to
+                          existing files may not be seen otherwise. The
+                          default is 24h, 0 means never.
+             noincremental always do full scans (the default).
+
+   Output: 0 upon success or 1 upon failure.
+*/
+
+int XrdFrmConfig::xscan()
+{
+    char *val;
+    int num;
+
+    if (!(val = cFile->GetWord()))
+       {Say.Emsg("Config", "scan option not specified"); return 1;}
+
+    while(val)
+         {     if (!strcmp(val, "threads"))
+                  {if (!(val = cFile->GetWord()))
+                      {Say.Emsg("Config", "scan threads not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2i(Say,"scan threads",val,&num,1,256))
+                      return 1;
+                   ScanThds = num;
+                  }
+          else if (!strcmp(val, "incremental"))
+                  {ScanIncr = 1;
+                   if ((val = cFile->GetWord()) && !strcmp(val, "full"))
+                      {if (!(val = cFile->GetWord()))
+                          {Say.Emsg("Config", "scan full time not specified");
+                           return 1;
+                          }
+                       if (XrdOuca2x::a2tm(Say,"scan full time",val,&num,0))
+                          return 1;
+                       ScanFull = num;
+                      } else continue;
+                  }
+          else if (!strcmp(val, "noincremental")) ScanIncr = 0;
+          else {Say.Emsg("Config", "invalid scan option '",val,"'."); return 1;}
+          val = cFile->GetWord();
+         }
+    return 0;
+}
+
 /******************************************************************************/
 /*                                  x s i t                                   */
 /******************************************************************************/
@@ -102,6 +102,9 @@ int                 IdleHold;
 int                 WaitQChk;
 int                 WaitPurge;
 int                 WaitMigr;
+int                 ScanThds;  // Threads used by a name space scan
+int                 ScanIncr;  // Skip unchanged directories when scanning
+int                 ScanFull;  // Seconds between full scans when ScanIncr
 int                 haveCMS;
 int                 isOTO;
 int                 Fix;
@@ -206,6 +209,7 @@ int          xmon();
 int          xpol();
 int          xpolprog();
 int          xqchk();
+int          xscan();
 int          xsit();
 int          xspace(int isPrg=0, int isXA=1);
 void         xspaceBuild(char *grp, char *fn, int isxa);
@@ -0,0 +1,255 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d F r m D i r I n d e x . c c                      */
+/*                                                                            */
+/* (c) 2026 by European Organization for Nuclear Research (CERN)              */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/param.h>
+
+#include <set>
+
+#include "XrdFrc/XrdFrcTrace.hh"
+#include "XrdFrm/XrdFrmConfig.hh"
+#include "XrdFrm/XrdFrmDirIndex.hh"
+
+using namespace XrdFrc;
+using namespace XrdFrm;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+  
+XrdFrmDirIndex::XrdFrmDirIndex(const char *Name)
+              : numDirs(0), numSkip(0), idxPath(Name), fullTime(0),
+                nextFull(0), scanTime(0), isLoaded(0)
+{}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+XrdFrmDirIndex::DirEnt *XrdFrmDirIndex::Add(const char *dPath,
+                                            struct stat &dStat,
+                                            const DirEnt *oldP)
+{
+   DirEnt *dP;
+
+// Get a new entry (the map never moves them around)
+//
+   dirMutex.Lock();
+   dP = &newMap[dPath];
+   numDirs++;
+   if (oldP) numSkip++;
+   dirMutex.UnLock();
+
+// Fill it out. A directory changed less than two seconds ago may still change
+// without its modification time showing it, we cannot trust it to be stable.
+//
+   dP->mTime = static_cast<long long>(dStat.st_mtime);
+   dP->Inode = static_cast<long long>(dStat.st_ino);
+   if (oldP) {dP->Stable = oldP->Stable; dP->Subs = oldP->Subs;}
+      else    dP->Stable = dStat.st_mtime < time(0) - 1;
+   return dP;
+}
+
+/******************************************************************************/
+/*                                C o m m i t                                 */
+/******************************************************************************/
+  
+void XrdFrmDirIndex::Commit()
+{
+
+// The current scan becomes the previous one
+//
+   oldMap.swap(newMap);
+   newMap.clear();
+   fullTime = nextFull;
+
+// Save it for the next incarnation
+//
+   Save();
+}
+
+/******************************************************************************/
+/*                                  S k i p                                   */
+/******************************************************************************/
+  
+const XrdFrmDirIndex::DirEnt *XrdFrmDirIndex::Skip(const char *dPath,
+                                                   struct stat &dStat)
+{
+   dirMap::const_iterator it = oldMap.find(dPath);
+
+// The previous map is not changed during a scan, so no lock is needed
+//
+   if (it == oldMap.end() || !it->second.Stable
+   ||  it->second.mTime != static_cast<long long>(dStat.st_mtime)
+   ||  it->second.Inode != static_cast<long long>(dStat.st_ino)) return 0;
+   return &(it->second);
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+  
+int XrdFrmDirIndex::Start(int fullInt)
+{
+
+// Pick up the index left by a previous incarnation the first time around
+//
+   if (!isLoaded)
+      {idxPath = std::string(Config.AdminPath) + "frm_" + idxPath + ".dirindex";
+       if (!Load()) {oldMap.clear(); fullTime = 0;}
+       isLoaded = 1;
+      }
+
+// Initialize for a new scan
+//
+   newMap.clear();
+   numDirs = numSkip = 0;
+   scanTime = time(0);
+
+// Determine whether this needs to be a full scan
+//
+   if (!fullTime || (fullInt > 0 && scanTime - fullTime >= fullInt))
+      {oldMap.clear(); nextFull = scanTime; return 0;}
+   nextFull = fullTime;
+   return 1;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                  L o a d                                   */
+/******************************************************************************/
+  
+int XrdFrmDirIndex::Load()
+{
+   dirMap::iterator it, pIt;
+   char buff[MAXPATHLEN+128];
+   long long mTime, Inode, fTime = 0;
+   int Stable, n, isBad = 0;
+   size_t k;
+   FILE *fP;
+
+// Open the index, it is not an error for it to be missing
+//
+   if (!(fP = fopen(idxPath.c_str(), "r")))
+      {if (errno != ENOENT) Say.Emsg("DirIndex",errno,"open",idxPath.c_str());
+       return 0;
+      }
+
+// Read the header and then each directory entry
+//
+   if (!fgets(buff, sizeof(buff), fP)
+   ||  sscanf(buff, "frmdirindex 1 %lld", &fTime) != 1) isBad = 1;
+      else while(fgets(buff, sizeof(buff), fP))
+                {if (!(n = strlen(buff)) || buff[n-1] != '\n')
+                    {isBad = 1; break;}
+                 buff[n-1] = '\0';
+                 if (sscanf(buff,"%lld %lld %d %n",&mTime,&Inode,&Stable,&n)!=3
+                 ||  buff[n] != '/') {isBad = 1; break;}
+                 DirEnt &dE = oldMap[buff+n];
+                 dE.mTime = mTime; dE.Inode = Inode; dE.Stable = Stable;
+                }
+   fclose(fP);
+
+// A damaged index is simply ignored
+//
+   if (isBad)
+      {Say.Emsg("DirIndex", idxPath.c_str(), "is damaged; doing a full scan.");
+       return 0;
+      }
+
+// Reconstruct the subdirectory lists from the paths
+//
+   for (it = oldMap.begin(); it != oldMap.end(); it++)
+       {const std::string &dP = it->first;
+        if (dP.size() < 2
+        ||  (k = dP.rfind('/', dP.size()-2)) == std::string::npos) continue;
+        if ((pIt = oldMap.find(dP.substr(0, k+1))) != oldMap.end())
+           pIt->second.Subs.push_back(dP.substr(k+1, dP.size()-k-2));
+       }
+
+// All done
+//
+   fullTime = static_cast<time_t>(fTime);
+   return 1;
+}
+
+/******************************************************************************/
+/*                                  S a v e                                   */
+/******************************************************************************/
+  
+void XrdFrmDirIndex::Save()
+{
+   dirMap::const_iterator it;
+   std::set<std::string> noSubs;
+   std::string tmpPath = idxPath + ".new";
+   size_t k;
+   FILE *fP;
+   int rc = 0;
+
+// Create a new index next to the current one
+//
+   if (!(fP = fopen(tmpPath.c_str(), "w")))
+      {Say.Emsg("DirIndex", errno, "create", tmpPath.c_str()); return;}
+
+// Names that would not survive being read back line by line are left out.
+// As Load() rebuilds the subdirectory lists from the names that were saved,
+// a skipped parent would never get to them again. So, their parents are
+// saved as unstable to have them scanned (and the names found) next time.
+//
+   for (it = oldMap.begin(); it != oldMap.end(); it++)
+       {const std::string &dP = it->first;
+        if (dP.find('\n') == std::string::npos || dP.size() < 2
+        ||  (k = dP.rfind('/', dP.size()-2)) == std::string::npos) continue;
+        noSubs.insert(dP.substr(0, k+1));
+       }
+
+// Write out the header and an entry per directory
+//
+   if (fprintf(fP,"frmdirindex 1 %lld\n",static_cast<long long>(fullTime)) < 0)
+      rc = errno;
+   for (it = oldMap.begin(); it != oldMap.end() && !rc; it++)
+       {if (it->first.find('\n') != std::string::npos) continue;
+        if (fprintf(fP, "%lld %lld %d %s\n", it->second.mTime, it->second.Inode,
+                    (it->second.Stable && !noSubs.count(it->first)),
+                    it->first.c_str()) < 0) rc = errno;
+       }
+
+// Make sure it is on disk before replacing the current one
+//
+   if (!rc && (fflush(fP) || fsync(fileno(fP)))) rc = errno;
+   if (fclose(fP) && !rc) rc = errno;
+   if (!rc && rename(tmpPath.c_str(), idxPath.c_str())) rc = errno;
+   if (rc)
+      {Say.Emsg("DirIndex", rc, "save", idxPath.c_str());
+       unlink(tmpPath.c_str());
+      }
+}
@@ -0,0 +1,106 @@
+#ifndef __FRMDIRINDEX__
+#define __FRMDIRINDEX__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d F r m D i r I n d e x . h h                      */
+/*                                                                            */
+/* (c) 2026 by European Organization for Nuclear Research (CERN)              */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                  C l a s s   X r d F r m D i r I n d e x                   */
+/******************************************************************************/
+
+// The directory index records the modification time of every directory seen
+// by a name space scan so that the next scan can skip the directories that
+// did not change. A directory is only skipped when the scanner left it marked
+// as stable (i.e., nothing in it needs to be looked at again). The index is
+// kept in the admin path and survives restarts. Since changes to files that
+// leave the directory alone (e.g., in-place updates, new extended attributes)
+// are not seen this way, a full scan is still done every so often.
+//
+class XrdFrmDirIndex
+{
+public:
+
+struct DirEnt
+      {long long                mTime;   // Directory modification time
+       long long                Inode;   // Directory inode number
+       int                      Stable;  // Skip it the next time if unchanged
+       std::vector<std::string> Subs;    // Names of the subdirectories
+
+       DirEnt() : mTime(0), Inode(0), Stable(0) {}
+      };
+
+// Add() records a directory seen by the current scan. When oldP is passed the
+// directory was skipped and inherits the subdirectories and stability of the
+// previous scan; otherwise, the caller fills in the subdirectories. The entry
+// remains valid until the next Start().
+//
+DirEnt       *Add(const char *dPath, struct stat &dStat, const DirEnt *oldP=0);
+
+// Commit() replaces the previous scan by the current one and saves it. It
+// should only be called when the scan completed.
+//
+void          Commit();
+
+// Skip() returns the previous entry of an unchanged stable directory or zero
+// when the directory has to be indexed again. It is MT-safe during a scan.
+//
+const DirEnt *Skip(const char *dPath, struct stat &dStat);
+
+// Start() starts a scan and returns 1 if it may be incremental and 0 if it
+// needs to be a full one (no index or the last full scan is fullInt old).
+//
+int           Start(int fullInt);
+
+int           numDirs;   // Directories seen by the current scan
+int           numSkip;   // Directories skipped by the current scan
+
+              XrdFrmDirIndex(const char *Name);
+             ~XrdFrmDirIndex() {}
+
+private:
+int           Load();
+void          Save();
+
+typedef std::map<std::string, DirEnt> dirMap;
+
+XrdSysMutex   dirMutex;
+dirMap        oldMap;
+dirMap        newMap;
+std::string   idxPath;
+time_t        fullTime;  // When the last full scan started
+time_t        nextFull;  // Value of fullTime once the current scan commits
+time_t        scanTime;  // When the current scan started
+int           isLoaded;
+};
+#endif
@@ -29,6 +29,8 @@
 /******************************************************************************/
 
 #include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <unistd.h>
@@ -39,6 +41,7 @@
 
 #include "XrdFrc/XrdFrcTrace.hh"
 #include "XrdFrm/XrdFrmConfig.hh"
+#include "XrdFrm/XrdFrmDirIndex.hh"
 #include "XrdFrm/XrdFrmFiles.hh"
 #include "XrdOuc/XrdOucTList.hh"
 #include "XrdSys/XrdSysPlatform.hh"
@@ -60,7 +63,7 @@ XrdOucHash<char>  XrdFrmFileset::BadFiles;
 /******************************************************************************/
   
 XrdFrmFileset::XrdFrmFileset(XrdFrmFileset *sP, XrdOucTList *diP)
-              : Next(sP), dInfo(diP)
+              : Next(sP), dInfo(diP), dStable(0), cpyRC(-1)
 {  memset(File, 0, sizeof(File));
    if (diP) diP->ival[dRef]++;
 }
@@ -150,6 +153,7 @@ int XrdFrmFileset::Refresh(int isMig, int doLock)
       }
 
    if (!isMig) pinInfo.Get(pnP, lkFD);
+   cpyRC = -1;
 
    if ((lP = lockFile()))
       {strcpy(fnP, lP->File);
@@ -208,20 +212,24 @@ int XrdFrmFileset::setCpyTime(int Refresh)
 {
    XrdOucNSWalk::NSEnt *lP;
 
+// If we already did this (e.g., while scanning), return the previous result
+//
+   if (!Refresh && cpyRC >= 0) return cpyRC;
+
 // In new run mode the copy time comes from the extended attributes
 //
-   if (Config.runNew) return cpyInfo.Get(basePath()) > 0;
+   if (Config.runNew) return (cpyRC = (cpyInfo.Get(basePath()) > 0));
 
 // If there is no lock file, indicate so
 //
-   if (!(lP = lockFile())) return 0;
+   if (!(lP = lockFile())) return (cpyRC = 0);
 
 // Use the lock file as the source of information
 //
    if (Refresh && stat(lockPath(), &(lP->Stat)))
-      {Say.Emsg("setCpyTime", errno, "stat", lockPath()); return 0;}
+      {Say.Emsg("setCpyTime", errno, "stat", lockPath()); return (cpyRC = 0);}
    cpyInfo.Attr.cpyTime = static_cast<long long>(lP->Stat.st_mtime);
-   return 1;
+   return (cpyRC = 1);
 }
 
 /******************************************************************************/
@@ -294,6 +302,30 @@ void XrdFrmFileset::Remfix(const char *fType, const char *fPath)
       Say.Emsg("Remfix", fType, "file orphan fixed; removed", fPath);
 }
   
+/******************************************************************************/
+/*                   C l a s s   X r d F r m F i l e s C B                    */
+/******************************************************************************/
+
+// The empty directory call back is not expected to be MT-safe, so when the
+// directories are indexed by several threads we serialize it.
+//
+class XrdFrmFilesCB : public XrdOucNSWalk::CallBack
+{
+public:
+
+void isEmpty(struct stat *dStat, const char *dPath, const char *lkFn)
+            {XrdSysMutexHelper cbHelp(cbMutex);
+             cbP->isEmpty(dStat, dPath, lkFn);
+            }
+
+     XrdFrmFilesCB(XrdOucNSWalk::CallBack *cb) : cbP(cb) {}
+    ~XrdFrmFilesCB() {}
+
+private:
+XrdSysMutex             cbMutex;
+XrdOucNSWalk::CallBack *cbP;
+};
+  
 /******************************************************************************/
 /*                     C l a s s   X r d F r m F i l e s                      */
 /******************************************************************************/
@@ -302,7 +334,8 @@ void XrdFrmFileset::Remfix(const char *fType, const char *fPath)
 /******************************************************************************/
   
 XrdFrmFiles::XrdFrmFiles(const char *dname, int opts,
-                        XrdOucTList *XList, XrdOucNSWalk::CallBack *cbP)
+                        XrdOucTList *XList, XrdOucNSWalk::CallBack *cbP,
+                        int nThreads, XrdFrmDirIndex *dIdx)
             : nsObj(&Say, dname, 0,
                     XrdOucNSWalk::retFile | XrdOucNSWalk::retLink
                    |XrdOucNSWalk::retStat | XrdOucNSWalk::skpErrs
@@ -310,12 +343,60 @@ XrdFrmFiles::XrdFrmFiles(const char *dname, int opts,
                    | (opts & CompressD  ?   XrdOucNSWalk::noPath  : 0)
                    | (opts & Recursive  ?   XrdOucNSWalk::Recurse : 0), XList),
               fsList(0), manMem(opts & NoAutoDel ? Hash_keep : Hash_default),
-              shareD(opts & CompressD), getCPT(opts & GetCpyTim)
+              shareD(opts & CompressD), getCPT(opts & GetCpyTim), curStable(0),
+              wkCond(0), wkDirs(0), wkXList(0), wkFirst(0), wkLast(0),
+              wkCBP(0), dirIdx(0), wkTID(0), wkNum(0), wkBusy(0), wkReady(0),
+              wkRC(0), wkEnd(0)
 {
+   char *dP;
+   int i, n, rc;
 
 // Set Call Back method
 //
    nsObj.setCallBack(cbP);
+
+// A single-threaded full scan is left to the name space walker. Otherwise,
+// we do the walk ourselves. This requires the filesets to be managed by the
+// caller as they outlive the per-thread hash table of their directory.
+//
+   if (!(opts & Recursive) || !manMem || (nThreads <= 1 && !dIdx)) return;
+
+// Copy the exclude list and serialize the call back
+//
+   while(XList)
+        {wkXList = new XrdOucTList(XList->text, 0, wkXList);
+         XList = XList->next;
+        }
+   if (cbP) wkCBP = new XrdFrmFilesCB(cbP);
+   dirIdx = dIdx;
+
+// Queue the starting directory, we always keep the trailing slash
+//
+   n = strlen(dname);
+   dP = (char *)malloc(n+2);
+   strcpy(dP, dname);
+   if (!n || dP[n-1] != '/') strcpy(dP+n, "/");
+   wkDirs = new XrdOucTList;
+   wkDirs->text = dP;
+
+// Start the threads that will do the indexing
+//
+   if (nThreads < 1) nThreads = 1;
+   wkTID = new pthread_t[nThreads];
+   for (i = 0; i < nThreads; i++)
+       {if ((rc = XrdSysThread::Run(&wkTID[wkNum], Worker, (void *)this,
+                                    XRDSYSTHREAD_HOLD, "name space scan")))
+           Say.Emsg("Files", rc, "create name space scan thread");
+           else wkNum++;
+       }
+
+// If we could not start any thread, fall back to a regular scan
+//
+   if (!wkNum)
+      {delete [] wkTID; wkTID = 0;
+       delete wkDirs;   wkDirs = 0;
+       dirIdx = 0;
+      }
 }
 
 /******************************************************************************/
@@ -325,6 +406,21 @@ XrdFrmFiles::XrdFrmFiles(const char *dname, int opts,
 XrdFrmFiles::~XrdFrmFiles()
 {
    XrdFrmFileset *fsetP;
+   XrdOucTList   *tP;
+   int i;
+
+// Stop the scan threads if we have any and get rid of what they left behind
+//
+   if (wkTID)
+      {wkCond.Lock(); wkEnd = 1; wkCond.Broadcast(); wkCond.UnLock();
+       for (i = 0; i < wkNum; i++) XrdSysThread::Join(wkTID[i], 0);
+       delete [] wkTID;
+       while((tP = wkDirs)) {wkDirs = tP->next; delete tP;}
+       while((fsetP = wkFirst))
+            {wkFirst = fsetP->Next; fsetP->Next = 0; delete fsetP;}
+      }
+   while((tP = wkXList)) {wkXList = tP->next; delete tP;}
+   if (wkCBP) delete wkCBP;
 
 // If manual memory is wante then we must delete any unreturned objects
 //
@@ -349,17 +445,25 @@ do{while ((fsetP = fsList))
          {fsList = fsetP->Next; fsetP->Next = 0;
                if (fsetP->File[XrdOssPath::isBase])
                   {if (getCPT) fsetP->setCpyTime();
+                   curStable = fsetP->dStable;
                    rc = 0; return fsetP;
                   }
-          else if (noBase) {rc = 0; return fsetP;}
+          else if (noBase) {curStable = fsetP->dStable; rc = 0; return fsetP;}
           else if (manMem) delete fsetP;
          }
 
+// When the scan threads do the indexing, get whatever they have so far
+//
+   if (wkTID)
+      {if (!(fsList = Ready(rc))) return 0;
+       continue;
+      }
+
 // Start with next directory (we return when no directories left).
 //
    do {if (!(nP = nsObj.Index(rc, &dPath))) return 0;
        fsTab.Purge(); fsList = 0;
-      } while(!Process(nP, dPath));
+      } while(!Process(nP, dPath, fsTab, fsList));
 
   } while(1);
 
@@ -379,6 +483,8 @@ void XrdFrmFiles::Complain(const char *dPath)
 {
    static const int OneDay = 24*60*60;
    static XrdOucHash<char> dTab;
+   static XrdSysMutex      dMutex;
+   XrdSysMutexHelper       dHelp(dMutex);
 
 // We want to complain about old=style directories only once every 24 hours
 //
@@ -390,6 +496,93 @@ void XrdFrmFiles::Complain(const char *dPath)
    Say.Emsg("Complain","In new run mode, migrate & purge will skip them.");
 }
 
+/******************************************************************************/
+/*                                 I n d e x                                  */
+/******************************************************************************/
+
+int XrdFrmFiles::Index(const char *dPath, XrdOucHash<XrdFrmFileset> &theTab,
+                       XrdFrmFileset *&theList)
+{
+   static const int wOpts = XrdOucNSWalk::retFile | XrdOucNSWalk::retLink
+                          | XrdOucNSWalk::retStat | XrdOucNSWalk::skpErrs
+                          | XrdOucNSWalk::retIILO | XrdOucNSWalk::retDir;
+   const XrdFrmDirIndex::DirEnt *odP;
+   XrdFrmDirIndex::DirEnt *deP = 0;
+   XrdOucNSWalk::NSEnt *nP, *fP, *fList = 0, *fLast = 0;
+   XrdOucTList *sdList = 0, *xP;
+   XrdFrmFileset *sP;
+   struct stat dStat;
+   char pBuff[MAXPATHLEN+8];
+   int i, n, rc, nDirs = 0, nFiles = 0;
+
+// In incremental mode, a directory that did not change since the previous
+// scan is skipped. We still need to look at its subdirectories, though.
+//
+   if (dirIdx)
+      {if (stat(dPath, &dStat))
+          {if ((rc = errno) == ENOENT) return 0;
+           Say.Emsg("Index", rc, "stat directory", dPath);
+           return rc;
+          }
+       if ((odP = dirIdx->Skip(dPath, dStat)))
+          {deP = dirIdx->Add(dPath, dStat, odP);
+           for (i = 0; i < (int)deP->Subs.size(); i++)
+               {n = snprintf(pBuff, sizeof(pBuff), "%s%s/", dPath,
+                             deP->Subs[i].c_str());
+                if (n < (int)sizeof(pBuff))
+                   sdList = new XrdOucTList(pBuff, 0, sdList);
+               }
+           if (sdList) Push(sdList);
+           return 0;
+          }
+       deP = dirIdx->Add(dPath, dStat);
+      }
+
+// Index this directory only (the walker opens it once and uses fstatat())
+//
+   XrdOucNSWalk nsWalk(&Say, dPath, 0,
+                       wOpts | (shareD ? XrdOucNSWalk::noPath : 0));
+   nsWalk.setCallBack(wkCBP);
+   nP = nsWalk.Index(rc);
+
+// Split off the subdirectories (but not links to them) and queue them up
+//
+   while((fP = nP))
+        {nP = fP->Next; fP->Next = 0;
+         if (fP->Type == XrdOucNSWalk::NSEnt::isDir && !fP->Link)
+            {n = snprintf(pBuff, sizeof(pBuff)-1, "%s%s", dPath, fP->File);
+             xP = wkXList;
+             while(xP && strcmp(pBuff, xP->text)) xP = xP->next;
+             if (!xP && n < (int)sizeof(pBuff)-1)
+                {if (deP) deP->Subs.push_back(fP->File);
+                 strcpy(pBuff+n, "/");
+                 sdList = new XrdOucTList(pBuff, 0, sdList);
+                }
+             delete fP; nDirs++;
+            } else {
+             if (fLast) fLast->Next = fP;
+                else    fList       = fP;
+             fLast = fP; nFiles++;
+            }
+        }
+   if (sdList) Push(sdList);
+
+// Build the filesets and do whatever else is needed while we are here
+//
+   theTab.Purge();
+   if (fList && Process(fList, dPath, theTab, theList))
+      for (sP = theList; sP; sP = sP->Next)
+          {if (deP) sP->dStable = &(deP->Stable);
+           if (getCPT && sP->baseFile()) sP->setCpyTime();
+          }
+
+// An empty directory is cheap to index, so we always do it as it needs to
+// be seen by the empty directory call back. Errors also force a new look.
+//
+   if (deP && (rc || (!nDirs && !nFiles))) deP->Stable = 0;
+   return rc;
+}
+
 /******************************************************************************/
 /*                               o l d F i l e                                */
 /******************************************************************************/
@@ -424,7 +617,9 @@ int XrdFrmFiles::oldFile(XrdOucNSWalk::NSEnt *fP, XrdOucTList *dP, int fType)
 /*                               P r o c e s s                                */
 /******************************************************************************/
   
-int XrdFrmFiles::Process(XrdOucNSWalk::NSEnt *nP, const char *dPath)
+int XrdFrmFiles::Process(XrdOucNSWalk::NSEnt *nP, const char *dPath,
+                         XrdOucHash<XrdFrmFileset> &theTab,
+                         XrdFrmFileset *&theList)
 {
    XrdOucNSWalk::NSEnt *fP;
    XrdFrmFileset       *sP;
@@ -460,9 +655,9 @@ int XrdFrmFiles::Process(XrdOucNSWalk::NSEnt *nP, const char *dPath)
                      }
                   *dotP = '\0';
                  }
-         if (!(sP = fsTab.Find(fP->File)))
-            {sP = fsList = new XrdFrmFileset(fsList, dP);
-             fsTab.Add(fP->File, sP, 0, manMem);
+         if (!(sP = theTab.Find(fP->File)))
+            {sP = theList = new XrdFrmFileset(theList, dP);
+             theTab.Add(fP->File, sP, 0, manMem);
             }
          if (dotP) *dotP = '.';
          sP->File[fType] = fP;
@@ -474,7 +669,104 @@ int XrdFrmFiles::Process(XrdOucNSWalk::NSEnt *nP, const char *dPath)
 
 // Indicate whether we have anything here
 //
-   if (fsList) return 1;
+   if (theList) return 1;
    if (dP) delete dP;
    return 0;
 }
+
+/******************************************************************************/
+/*                                  P u s h                                   */
+/******************************************************************************/
+  
+void XrdFrmFiles::Push(XrdOucTList *dP)
+{
+   XrdOucTList *lP = dP;
+
+// Find the end of the list
+//
+   while(lP->next) lP = lP->next;
+
+// Put the directories on top of the stack (i.e., depth-first)
+//
+   wkCond.Lock();
+   lP->next = wkDirs; wkDirs = dP;
+   wkCond.Broadcast();
+   wkCond.UnLock();
+}
+
+/******************************************************************************/
+/*                                 R e a d y                                  */
+/******************************************************************************/
+  
+XrdFrmFileset *XrdFrmFiles::Ready(int &rc)
+{
+   XrdFrmFileset *fsetP;
+
+// Wait for a directory to be indexed or for the scan to end
+//
+   wkCond.Lock();
+   while(!wkFirst && (wkDirs || wkBusy)) wkCond.Wait();
+
+// Take everything that is ready and let the threads continue
+//
+   fsetP = wkFirst; wkFirst = wkLast = 0;
+   if (wkReady) {wkReady = 0; wkCond.Broadcast();}
+   rc = (fsetP ? 0 : wkRC);
+   wkCond.UnLock();
+
+// All done
+//
+   if (!fsetP) curStable = 0;
+   return fsetP;
+}
+
+/******************************************************************************/
+/*                                  W o r k                                   */
+/******************************************************************************/
+  
+void *XrdFrmFiles::Worker(void *pp)
+{
+   ((XrdFrmFiles *)pp)->Work();
+   return (void *)0;
+}
+
+/******************************************************************************/
+
+void XrdFrmFiles::Work()
+{
+   XrdOucHash<XrdFrmFileset> theTab;
+   XrdFrmFileset *theList, *lastP;
+   XrdOucTList   *tP;
+   int rc;
+
+// Index directories until there are none left. We stop taking new ones when
+// Get() is lagging too far behind so that we don't fill up memory.
+//
+   wkCond.Lock();
+   do {while(!wkEnd && (wkReady >= wkMaxQ || (!wkDirs && wkBusy)))
+             wkCond.Wait();
+       if (wkEnd || !(tP = wkDirs)) break;
+       wkDirs = tP->next; wkBusy++;
+       wkCond.UnLock();
+
+       theList = 0;
+       rc = Index(tP->text, theTab, theList);
+       delete tP;
+       for (lastP = theList; lastP && lastP->Next; lastP = lastP->Next) {}
+
+       wkCond.Lock();
+       wkBusy--;
+       if (rc && !wkRC) wkRC = rc;
+       if (theList)
+          {if (wkLast) wkLast->Next = theList;
+              else     wkFirst      = theList;
+           wkLast = lastP; wkReady++;
+          }
+       wkCond.Broadcast();
+      } while(1);
+
+// Make sure everyone sees that we are done
+//
+   wkCond.Broadcast();
+   wkCond.UnLock();
+}
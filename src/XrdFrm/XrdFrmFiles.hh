@@ -38,7 +38,9 @@
 #include "XrdOuc/XrdOucHash.hh"
 #include "XrdOuc/XrdOucNSWalk.hh"
 #include "XrdOuc/XrdOucXAttr.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
+class  XrdFrmDirIndex;
 class  XrdOucTList;
 
 /******************************************************************************/
@@ -101,6 +103,8 @@ void        Remfix(const char *fType, const char *fPath);
 XrdOucNSWalk::NSEnt *File[XrdOssPath::sfxNum];
 
 XrdOucTList         *dInfo;     // Shared directory information
+int                 *dStable;   // -> Stable flag of the directory index entry
+int                  cpyRC;     // Result of setCpyTime() (-1 if not called)
 
 static XrdOucHash<char> BadFiles;
 
@@ -118,20 +122,41 @@ public:
 
 XrdFrmFileset *Get(int &rc, int noBase=0);
 
+// Rescan() tells an incremental scan that the directory holding the fileset
+// last returned by Get() needs to be indexed again the next time around.
+//
+void           Rescan() {if (curStable) *curStable = 0;}
+
 static const int Recursive = 0x0001;   // List filesets recursively
 static const int CompressD = 0x0002;   // Use shared directory object (not MT)
 static const int NoAutoDel = 0x0004;   // Do not automatically delete objects
 static const int GetCpyTim = 0x0008;   // Initialize cpyInfo attribute on Get()
 
+// When nThreads > 1 a recursive NoAutoDel listing is done by that many threads,
+// each indexing whole directories (Get() still needs to be called by a single
+// thread, the call back is serialized). When dIdx is passed, directories
+// that did not change since the previous scan recorded in it are skipped.
+//
             XrdFrmFiles(const char *dname, int opts=Recursive,
-                        XrdOucTList *XList=0, XrdOucNSWalk::CallBack *cbP=0);
+                        XrdOucTList *XList=0, XrdOucNSWalk::CallBack *cbP=0,
+                        int nThreads=1, XrdFrmDirIndex *dIdx=0);
 
            ~XrdFrmFiles();
 
 private:
-void Complain(const char *dPath);
-int  oldFile(XrdOucNSWalk::NSEnt *fP, XrdOucTList *dP, int fType);
-int  Process(XrdOucNSWalk::NSEnt *nP, const char *dPath);
+void           Complain(const char *dPath);
+int            Index(const char *dPath, XrdOucHash<XrdFrmFileset> &theTab,
+                     XrdFrmFileset *&theList);
+int            oldFile(XrdOucNSWalk::NSEnt *fP, XrdOucTList *dP, int fType);
+int            Process(XrdOucNSWalk::NSEnt *nP, const char *dPath,
+                       XrdOucHash<XrdFrmFileset> &theTab,
+                       XrdFrmFileset *&theList);
+void           Push(XrdOucTList *dP);
+XrdFrmFileset *Ready(int &rc);
+void           Work();
+static void   *Worker(void *pp);
+
+static const int         wkMaxQ = 64; // Max directories waiting for Get()
 
 XrdOucHash<XrdFrmFileset>fsTab;
 
@@ -140,5 +165,22 @@ XrdFrmFileset           *fsList;
 XrdOucHash_Options       manMem;
 int                      shareD;
 int                      getCPT;
+int                     *curStable;
+
+// The following are only used by a multi-threaded scan
+//
+XrdSysCondVar            wkCond;
+XrdOucTList             *wkDirs;    // Directories waiting to be indexed
+XrdOucTList             *wkXList;   // Directories not to be indexed
+XrdFrmFileset           *wkFirst;   // Filesets waiting for Get()
+XrdFrmFileset           *wkLast;
+XrdOucNSWalk::CallBack  *wkCBP;     // Serialized call back
+XrdFrmDirIndex          *dirIdx;
+pthread_t               *wkTID;
+int                      wkNum;     // Number of threads
+int                      wkBusy;    // Number of threads indexing
+int                      wkReady;   // Number of directories waiting for Get()
+int                      wkRC;
+int                      wkEnd;
 };
 #endif
@@ -43,6 +43,7 @@
 #include "XrdFrc/XrdFrcTrace.hh"
 #include "XrdFrm/XrdFrmFiles.hh"
 #include "XrdFrm/XrdFrmConfig.hh"
+#include "XrdFrm/XrdFrmDirIndex.hh"
 #include "XrdFrm/XrdFrmMigrate.hh"
 #include "XrdFrm/XrdFrmTransfer.hh"
 #include "XrdFrm/XrdFrmXfrQueue.hh"
@@ -60,12 +61,17 @@ using namespace XrdFrm;
 XrdFrmFileset    *XrdFrmMigrate::fsDefer = 0;
 
 int               XrdFrmMigrate::numMig = 0;
+
+static const char *fileUnchanged = "file unchanged";
   
 /******************************************************************************/
 /* Private:                          A d d                                    */
 /******************************************************************************/
+
+// Returns 0 if the file was already migrated and has not changed since, so that
+// its directory may be skipped by the next incremental scan, and 1 otherwise.
   
-void XrdFrmMigrate::Add(XrdFrmFileset *sP)
+int XrdFrmMigrate::Add(XrdFrmFileset *sP)
 {
    EPNAME("Add");
    const char *Why;
@@ -76,13 +82,14 @@ void XrdFrmMigrate::Add(XrdFrmFileset *sP)
    if ((Why = Eligible(sP, xTime)))
       {DEBUG(sP->basePath() <<"cannot be migrated; " <<Why);
        delete sP;
-       return;
+       return Why != fileUnchanged;
       }
 
 // Add the file to the migr queue or the defer queue based on mod time
 //
    if (xTime < Config.IdleHold) Defer(sP);
       else Queue(sP);
+   return 1;
 }
   
 /******************************************************************************/
@@ -172,7 +179,7 @@ const char *XrdFrmMigrate::Eligible(XrdFrmFileset *sP, time_t &xTime)
 // File is ineligible if it has not changed since last migration
 //
    mTimeBF = baseFile->Stat.st_mtime;
-   if (mTimeLK >= mTimeBF) return "file unchanged";
+   if (mTimeLK >= mTimeBF) return fileUnchanged;
 
 // File is ineligible if it has a fail file that is still recent
 //
@@ -263,12 +270,15 @@ void XrdFrmMigrate::Queue(XrdFrmFileset *sP)
 void XrdFrmMigrate::Scan()
 {
    static const int Opts = XrdFrmFiles::Recursive | XrdFrmFiles::CompressD
-                         | XrdFrmFiles::NoAutoDel;
+                         | XrdFrmFiles::NoAutoDel | XrdFrmFiles::GetCpyTim;
    static time_t lastHP = time(0), nowT = time(0);
+   static XrdFrmDirIndex dirIndex("migr");
 
    XrdFrmConfig::VPInfo *vP = Config.pathList;
+   XrdFrmDirIndex *dIdx = 0;
    XrdFrmFileset *sP;
    XrdFrmFiles   *fP;
+   const char *How = "Name space";
    char buff[128];
    int ec = 0, Bad = 0, aFiles = 0, bFiles = 0;
 
@@ -276,22 +286,40 @@ void XrdFrmMigrate::Scan()
 //
    if (nowT - lastHP >= 86400) {XrdFrmFileset::Purge(); lastHP = nowT;}
 
+// Determine if we can skip the directories that did not change
+//
+   if (Config.ScanIncr)
+      {dIdx = &dirIndex;
+       if (dIdx->Start(Config.ScanFull)) How = "Incremental name space";
+      }
+
 // Indicate scan started
 //
-   VMSG("Scan", "Name space scan started. . .");
+   VMSG("Scan", How, "scan started. . .");
 
-// Process each directory
+// Process each directory. Only directories whose files all migrated (and did
+// not change since) can be skipped the next time around.
 //
-   do {fP = new XrdFrmFiles(vP->Name, Opts, vP->Dir);
+   do {fP = new XrdFrmFiles(vP->Name,Opts,vP->Dir,0,Config.ScanThds,dIdx);
        while((sP = fP->Get(ec,1)))
             {aFiles++;
-             if (sP->Screen()) Add(sP);
-                else {delete sP; bFiles++;}
+             if (!sP->Screen())
+                {delete sP; bFiles++; fP->Rescan();}
+                else if (Add(sP)) fP->Rescan();
             }
        if (ec) Bad = 1;
        delete fP;
       } while((vP = vP->Next));
 
+// Remember what the directories looked like for the next time around
+//
+   if (dIdx)
+      {dIdx->Commit();
+       sprintf(buff, "%d of %d director%s skipped", dIdx->numSkip,
+                     dIdx->numDirs, (dIdx->numDirs != 1 ? "ies" : "y"));
+       VMSG("Scan", "Directory index updated;", buff);
+      }
+
 // Indicate scan ended
 //
    sprintf(buff, "%d file%s with %d error%s", aFiles, (aFiles != 1 ? "s":""),
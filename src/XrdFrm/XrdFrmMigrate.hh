@@ -54,7 +54,7 @@ private:
 
 // Methods
 //
-static void          Add(XrdFrmFileset *fsp);
+static int           Add(XrdFrmFileset *fsp);
 static int           Advance();
 static void          Defer(XrdFrmFileset *sP);
 static const char   *Eligible(XrdFrmFileset *sP, time_t &xTime);
@@ -47,6 +47,7 @@
 #include "XrdFrm/XrdFrmFiles.hh"
 #include "XrdFrm/XrdFrmCns.hh"
 #include "XrdFrm/XrdFrmConfig.hh"
+#include "XrdFrm/XrdFrmDirIndex.hh"
 #include "XrdFrm/XrdFrmMonitor.hh"
 #include "XrdFrm/XrdFrmPurge.hh"
 #include "XrdSys/XrdSysPlatform.hh"
@@ -182,14 +183,17 @@ XrdFrmPurge::XrdFrmPurge(const char *snp, XrdFrmPurge *spp) : FSTab(1)
 /******************************************************************************/
 /* Private:                          A d d                                    */
 /******************************************************************************/
+
+// Returns 0 if the file will not become purgeable unless its directory changes
   
-void XrdFrmPurge::Add(XrdFrmFileset *sP)
+int XrdFrmPurge::Add(XrdFrmFileset *sP)
 {
    EPNAME("Add");
    XrdOucNSWalk::NSEnt *baseFile = sP->baseFile();
    XrdFrmPurge *psP = Default;
    const char *Why;
    time_t xTime;
+   int Again;
 
 // First, get the space name associated with the base file
 //
@@ -201,21 +205,24 @@ void XrdFrmPurge::Add(XrdFrmFileset *sP)
 
 // Ignore the file is the space is not enabled for purging
 //
-   if (!(psP->Enabled)) {delete sP; return;}
+   if (!(psP->Enabled)) {delete sP; return 1;}
    psP->numFiles++;
 
-// Check to see if the file is really eligible for purging
+// Check to see if the file is really eligible for purging. A fail file only
+// goes away by being removed, anything else can change behind our back.
 //
    if ((Why = psP->Eligible(sP, xTime)))
       {DEBUG(sP->basePath() <<"cannot be purged; " <<Why);
+       Again = (sP->failFile() == 0);
        delete sP;
-       return;
+       return Again;
       }
 
 // Add the file to the purge table or the defer queue based on access time
 //
    if (xTime >= psP->Hold) psP->FSTab.Add(sP);
       else psP->Defer(sP, xTime);
+   return 1;
 }
   
 /******************************************************************************/
@@ -708,13 +715,15 @@ void XrdFrmPurge::Scan()
    static time_t lastHP = time(0), nextDP = 0, nowT = time(0);
    static XrdFrmPurgeDir purgeDir;
    static XrdOucNSWalk::CallBack *cbP;
+   static XrdFrmDirIndex dirIndex("purge");
 
    XrdFrmConfig::VPInfo *vP = Config.pathList;
+   XrdFrmDirIndex *dIdx = 0;
    XrdFrmFileset *sP;
    XrdFrmFiles   *fP;
-   const char *Extra;
+   const char *Extra, *How = "Name space";
    char buff[128];
-   int needLF, ec = 0, Bad = 0, aFiles = 0, bFiles = 0;
+   int needLF, fOpts, ec = 0, Bad = 0, aFiles = 0, bFiles = 0;
 
 // Purge that bad file table evey 24 hours to keep complaints down
 //
@@ -729,23 +738,42 @@ void XrdFrmPurge::Scan()
             Extra = "and empty directory";
            }
 
+// Determine if we can skip the directories that did not change
+//
+   if (Config.ScanIncr)
+      {dIdx = &dirIndex;
+       if (dIdx->Start(Config.ScanFull)) How = "Incremental name space";
+      }
+
 // Indicate scan started
 //
-   VMSG("Scan", "Name space", Extra, "scan started. . .");
+   VMSG("Scan", How, Extra, "scan started. . .");
 
-// Process each directory
+// Process each directory. Any file that may become purgeable without its
+// directory changing forces the directory to be looked at the next time.
 //
-   do {fP = new XrdFrmFiles(vP->Name, Opts, vP->Dir, cbP);
-       needLF = vP->Val;
+   do {needLF = vP->Val;
+       fOpts  = Opts | (needLF ? XrdFrmFiles::GetCpyTim : 0);
+       fP = new XrdFrmFiles(vP->Name,fOpts,vP->Dir,cbP,Config.ScanThds,dIdx);
        while((sP = fP->Get(ec,1)))
             {aFiles++;
-             if (sP->Screen(needLF)) Add(sP);
-                else {delete sP; bFiles++;}
+             if (!sP->Screen(needLF))
+                {delete sP; bFiles++; fP->Rescan();}
+                else if (Add(sP)) fP->Rescan();
             }
        if (ec) Bad = 1;
        delete fP;
       } while((vP = vP->Next));
 
+// Remember what the directories looked like for the next time around
+//
+   if (dIdx)
+      {dIdx->Commit();
+       sprintf(buff, "%d of %d director%s skipped", dIdx->numSkip,
+                     dIdx->numDirs, (dIdx->numDirs != 1 ? "ies" : "y"));
+       VMSG("Scan", "Directory index updated;", buff);
+      }
+
 // If we did a directory purge, schedule the next one and say what we did
 //
    if (cbP)
@@ -62,7 +62,7 @@ private:
 
 // Methods
 //
-static void          Add(XrdFrmFileset *fsp);
+static int           Add(XrdFrmFileset *fsp);
        XrdFrmFileset*Advance();
        void          Clear();
        void          Defer(XrdFrmFileset *sP, time_t xTime);
@@ -48,6 +48,8 @@ set( XROOTD_PUBLIC_HEADERS
   XrdOuc/XrdOucCRC.hh
   XrdOuc/XrdOucCache.hh
   XrdOuc/XrdOucCallBack.hh
+  XrdOuc/XrdOucCHash.hh
+  XrdOuc/XrdOucCHash.icc
   XrdOuc/XrdOucChain.hh
   XrdOuc/XrdOucDLlist.hh
   XrdOuc/XrdOucEnv.hh
@@ -23,6 +23,7 @@ if( BUILD_HTTP )
                                   XrdHttp/XrdHttpSecXtractor.hh
     XrdHttp/XrdHttpExtHandler.cc  XrdHttp/XrdHttpExtHandler.hh
                                   XrdHttp/XrdHttpStatic.hh
+                                  XrdHttp/XrdHttpHeaders.hh
     XrdHttp/XrdHttpTrace.cc       XrdHttp/XrdHttpTrace.hh
     XrdHttp/XrdHttpUtils.cc       XrdHttp/XrdHttpUtils.hh )
 
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+/** @file  XrdHttpHeaders.hh
+ * @brief  In-place tokenization of HTTP request header lines
+ *
+ * The helpers here work directly on the bytes of the request buffer, so that
+ * the header lines do not have to be copied before they are parsed.
+ * They are header-only so that they can be exercised outside of the plugin.
+ */
+
+#ifndef XRDHTTPHEADERS_HH
+#define	XRDHTTPHEADERS_HH
+
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+/// The header lines that XrdHttpReq reacts to. Everything else is only
+/// memorized in the header map
+enum XrdHttpHdrID {
+  hdrOther = 0,
+  hdrConnection,
+  hdrHost,
+  hdrRange,
+  hdrContentLength,
+  hdrDestination,
+  hdrDepth,
+  hdrExpect
+};
+
+/// Find the end of a line in [start, end). Returns a pointer to the '\n' or
+/// zero if the line is not complete yet. memchr is vectorized by the C library,
+/// which is much faster than a byte by byte loop on long header lines
+inline char *XrdHttpFindEOL(char *start, char *end) {
+  if (end <= start) return 0;
+  return (char *) memchr(start, '\n', end - start);
+}
+
+/// Identify a header name of klen bytes (not necessarily null terminated).
+/// The lookup is a perfect hash on the name length and its first character,
+/// followed by a single case insensitive comparison
+inline XrdHttpHdrID XrdHttpHeaderID(const char *key, int klen) {
+  static const struct {
+    const char *name;
+    int len;
+    XrdHttpHdrID id;
+  } hTab[16] = {
+    {0, 0, hdrOther},                                  //  0
+    {"Content-Length", 14, hdrContentLength},          //  1
+    {0, 0, hdrOther},                                  //  2
+    {0, 0, hdrOther},                                  //  3
+    {0, 0, hdrOther},                                  //  4
+    {0, 0, hdrOther},                                  //  5
+    {0, 0, hdrOther},                                  //  6
+    {"Range", 5, hdrRange},                            //  7
+    {0, 0, hdrOther},                                  //  8
+    {"Depth", 5, hdrDepth},                            //  9
+    {0, 0, hdrOther},                                  // 10
+    {"Expect", 6, hdrExpect},                          // 11
+    {"Host", 4, hdrHost},                              // 12
+    {"Connection", 10, hdrConnection},                 // 13
+    {0, 0, hdrOther},                                  // 14
+    {"Destination", 11, hdrDestination}                // 15
+  };
+
+  if (klen <= 0) return hdrOther;
+
+  int h = (klen + tolower((unsigned char) key[0])) & 0x0f;
+
+  if ((hTab[h].len != klen) || strncasecmp(key, hTab[h].name, klen))
+    return hdrOther;
+
+  return hTab[h].id;
+}
+
+#endif	/* XRDHTTPHEADERS_HH */
@@ -38,6 +38,7 @@
 
 #include <sys/stat.h>
 #include "XrdHttpUtils.hh"
+#include "XrdHttpHeaders.hh"
 #include "XrdHttpSecXtractor.hh"
 #include "XrdHttpExtHandler.hh"
 
@@ -46,6 +47,7 @@
 #include <vector>
 #include <arpa/inet.h>
 #include <ctype.h>
+#include <limits.h>
 
 #define XRHTTP_TK_GRACETIME     600
 
@@ -80,6 +82,7 @@ XrdOucHash<XrdHttpProtocol::StaticPreloadInfo> *XrdHttpProtocol::staticpreload =
 
 kXR_int32 XrdHttpProtocol::myRole = kXR_isManager;
 bool XrdHttpProtocol::selfhttps2http = false;
+bool XrdHttpProtocol::ktls = false;
 bool XrdHttpProtocol::isdesthttps = false;
 char *XrdHttpProtocol::sslcafile = 0;
 char *XrdHttpProtocol::secretkey = 0;
@@ -500,6 +503,13 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
 
       if (res != X509_V_OK) return -1;
       ssldone = true;
+
+      // See if the kernel took over the encryption of what we send. If so,
+      // the data can be written straight to the socket, sendfile included
+#ifdef SSL_OP_ENABLE_KTLS
+      if (ktls) ktlssend = (BIO_get_ktls_send(SSL_get_wbio(ssl)) > 0);
+#endif
+      TRACEI(DEBUG, " Kernel TLS send offload: " << (ktlssend ? "on" : "off"));
     }
 
 
@@ -532,10 +542,12 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
   if (!CurrentReq.headerok) {
 
     // Read as many lines as possible into the buffer. An empty line breaks
-    while ((rc = BuffgetLine(tmpline)) > 0) {
-      TRACE(DEBUG, " rc:" << rc << " got hdr line: " << tmpline);
+    char *hdrline;
+    while ((rc = BuffgetLine(hdrline)) > 0) {
+      TRACE(DEBUG, " rc:" << rc << " got hdr line: " << hdrline);
 
-      if ((rc == 2) && (tmpline[rc - 1] == '\n')) {
+      // Just "\r\n", whose '\n' has been nulled by BuffgetLine
+      if (rc == 2) {
         CurrentReq.headerok = true;
         TRACE(DEBUG, " rc:" << rc << " detected header end.");
         break;
@@ -543,11 +555,11 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
 
 
       if (CurrentReq.request == CurrentReq.rtUnknown) {
-        TRACE(DEBUG, " Parsing first line: " << tmpline);
-        CurrentReq.parseFirstLine((char *)tmpline.c_str(), rc);
+        TRACE(DEBUG, " Parsing first line: " << hdrline);
+        CurrentReq.parseFirstLine(hdrline, rc);
       }
       else
-        CurrentReq.parseLine((char *)tmpline.c_str(), rc);
+        CurrentReq.parseLine(hdrline, rc);
 
 
     }
@@ -859,6 +871,7 @@ int XrdHttpProtocol::Config(const char *ConfigFN) {
       else if TS_Xeq("secxtractor", xsecxtractor);
       else if TS_Xeq("exthandler", xexthandler);
       else if TS_Xeq("selfhttps2http", xselfhttps2http);
+      else if TS_Xeq("ktls", xktls);
       else if TS_Xeq("embeddedstatic", xembeddedstatic);
       else if TS_Xeq("listingredir", xlistredir);
       else if TS_Xeq("staticredir", xstaticredir);
@@ -895,91 +908,57 @@ int XrdHttpProtocol::Config(const char *ConfigFN) {
 
 /******************************************************************************/
 
-/// Copy a full line of text from the buffer into dest. Zero if no line can be found in the buffer
+/// Locate a full line of text in the buffer. Zero if no line can be found in the buffer
+/// The line is not copied: its '\n' is replaced by a null byte and 'line' points
+/// into the buffer, so it stays valid only until the buffer is refilled.
+/// Lines wrapping around the end of the buffer are rare; they get linearized in tmpline
 
-int XrdHttpProtocol::BuffgetLine(XrdOucString &dest) {
+int XrdHttpProtocol::BuffgetLine(char *&line) {
 
-  dest = "";
-  char save;
+  char *bEnd = myBuff->buff + myBuff->bsize;
+  char *p;
+  int l;
+
+  line = 0;
 
   // Easy case
   if (myBuffEnd >= myBuffStart) {
-    int l = 0;
-    for (char *p = myBuffStart; p < myBuffEnd; p++) {
-      l++;
-      if (*p == '\n') {
-        save = *(p+1);
-        *(p+1) = '\0';
-        dest.assign(myBuffStart, 0, l-1);
-        *(p+1) = save;
-
-        //strncpy(dest, myBuffStart, l);
-        //dest[l] = '\0';
-        BuffConsume(l);
-
-        //if (dest[l-1] == '\n') dest[l - 1] = '\0';
-        return l;
-      }
+    if (!(p = XrdHttpFindEOL(myBuffStart, myBuffEnd))) return 0;
 
-    }
-
-    return 0;
-  } else {
-    // More complex case... we have to do it in two segments
-
-    // Segment 1: myBuffStart->myBuff->buff+myBuff->bsize
-    int l = 0;
-    for (char *p = myBuffStart; p < myBuff->buff + myBuff->bsize; p++) {
-      l++;
-      if ((*p == '\n') || (*p == '\0')) {
-        save = *(p+1);
-        *(p+1) = '\0';
-        dest.assign(myBuffStart, 0, l-1);
-        *(p+1) = save;
-
-        //strncpy(dest, myBuffStart, l);
-
-        BuffConsume(l);
-
-        //if (dest[l-1] == '\n') dest[l - 1] = '\0';
-        return l;
-      }
-
-    }
+    l = p - myBuffStart + 1;
+    *p = '\0';
+    line = myBuffStart;
+    BuffConsume(l);
+    return l;
+  }
 
-    // We did not find the \n, let's keep on searching in the 2nd segment
-    // Segment 2: myBuff->buff --> myBuffEnd
-    l = 0;
-    for (char *p = myBuff->buff; p < myBuffEnd; p++) {
-      l++;
-      if ((*p == '\n') || (*p == '\0')) {
-        save = *(p+1);
-        *(p+1) = '\0';
-        // Remember the 1st segment
-        int l1 = myBuff->buff + myBuff->bsize - myBuffStart;
-
-        dest.assign(myBuffStart, 0, l1-1);
-        //strncpy(dest, myBuffStart, l1);
-        BuffConsume(l1);
-
-        dest.insert(myBuffStart, l1, l-1);
-        //strncpy(dest + l1, myBuffStart, l);
-        //dest[l + l1] = '\0';
-        BuffConsume(l);
-
-        *(p+1) = save;
-
-        //if (dest[l + l1 - 1] == '\n') dest[l + l1 - 1] = '\0';
-        return l + l1;
-      }
+  // More complex case... we have to do it in two segments
+  // Segment 1: myBuffStart->myBuff->buff+myBuff->bsize
+  if ((p = XrdHttpFindEOL(myBuffStart, bEnd))) {
+    l = p - myBuffStart + 1;
+    *p = '\0';
+    line = myBuffStart;
+    BuffConsume(l);
+    return l;
+  }
 
-    }
+  // We did not find the \n, let's keep on searching in the 2nd segment
+  // Segment 2: myBuff->buff --> myBuffEnd
+  if (!(p = XrdHttpFindEOL(myBuff->buff, myBuffEnd))) return 0;
 
+  // Remember the 1st segment
+  int l1 = bEnd - myBuffStart;
 
+  l = p - myBuff->buff + 1;
+  *p = '\0';
 
-  }
+  tmpline.assign(myBuffStart, 0, l1 - 1);
+  BuffConsume(l1);
+  tmpline.insert(myBuffStart, l1);
+  BuffConsume(l);
 
-  return 0;
+  line = (char *) tmpline.c_str();
+  return l + l1;
 }
 
 int XrdHttpProtocol::getDataOneShot(int blen, bool wait) {
@@ -1185,6 +1164,32 @@ int XrdHttpProtocol::SendData(char *body, int bodylen) {
   return 0;
 }
 
+/// Sends a list of buffers, e.g. the parts of a multipart response. On plain
+/// http (or kernel TLS) connections they go out with writev(), no intermediate copy is made
+/// Returns 0 if OK
+
+int XrdHttpProtocol::SendData(const struct iovec *iov, int iovn) {
+
+  // With kernel TLS the socket encrypts by itself
+  if (ishttps && !ktlssend) {
+    for (int i = 0; i < iovn; i++)
+      if (SendData((char *) iov[i].iov_base, iov[i].iov_len)) return -1;
+    return 0;
+  }
+
+  TRACE(REQ, "Sending " << iovn << " buffers");
+
+  // writev() refuses vectors longer than IOV_MAX
+  while (iovn > 0) {
+    int n = (iovn > IOV_MAX ? IOV_MAX : iovn);
+    if (Link->Send(iov, n) < 0) return -1;
+    iov += n;
+    iovn -= n;
+  }
+
+  return 0;
+}
+
 /// Sends a basic response. If the length is < 0 then it is calculated internally
 /// Header_to_add is a set of header lines each CRLF terminated to be added to the header
 /// Returns 0 if OK
@@ -1243,16 +1248,19 @@ int XrdHttpProtocol::SendSimpleResp(int code, char *desc, char *header_to_add, c
   //
   TRACEI(RSP, "Sending resp: " << code << " len:" << l);
 
-  if (SendData(outhdr, hdrlen))
-    return -1;
+  if (!body)
+    return SendData(outhdr, hdrlen);
 
   //
-  // Send the data
+  // Send the data together with the header
   //
-  if (body)
-    return SendData(body, l);
+  struct iovec iov[2];
+  iov[0].iov_base = outhdr;
+  iov[0].iov_len = hdrlen;
+  iov[1].iov_base = body;
+  iov[1].iov_len = l;
 
-  return 0;
+  return SendData(iov, 2);
 
 }
 
@@ -1469,6 +1477,18 @@ int XrdHttpProtocol::InitSecurity() {
 
 
   SSL_CTX_set_cipher_list(sslctx, "ALL:!LOW:!EXP:!MD5:!MD2");
+
+  // Ask OpenSSL to install the session keys into the kernel after the
+  // handshake. If the kernel or the negotiated cipher cannot do it, the
+  // connection silently stays with the user space encryption
+  if (ktls) {
+#ifdef SSL_OP_ENABLE_KTLS
+    SSL_CTX_set_options(sslctx, SSL_OP_ENABLE_KTLS);
+#else
+    eDest.Say("Config warning: this OpenSSL does not support kernel TLS; ignoring http.ktls");
+    ktls = false;
+#endif
+  }
   //SSL_CTX_set_purpose(sslctx, X509_PURPOSE_ANY);
   SSL_CTX_set_mode(sslctx, SSL_MODE_AUTO_RETRY);
 
@@ -1557,6 +1577,7 @@ void XrdHttpProtocol::Reset() {
   myBuffStart = myBuffEnd = myBuff->buff;
 
   DoingLogin = false;
+  ktlssend = false;
 
   ResumeBytes = 0;
   Resume = 0;
@@ -2134,6 +2155,41 @@ int XrdHttpProtocol::xselfhttps2http(XrdOucStream & Config) {
 
 
 
+/******************************************************************************/
+/*                                 x k t l s                                  */
+/******************************************************************************/
+
+/* Function: xktls
+
+   Purpose:  To parse the directive: ktls <yes|no|0|1>
+
+             <val>    offload the TLS encryption of https connections to the
+                      kernel when possible, so that sendfile can be used
+
+  Output: 0 upon success or !0 upon failure.
+ */
+
+int XrdHttpProtocol::xktls(XrdOucStream & Config) {
+  char *val;
+
+  // Get the flag
+  //
+  val = Config.GetWord();
+  if (!val || !val[0]) {
+    eDest.Emsg("Config", "ktls flag not specified");
+    return 1;
+  }
+
+  // Record the value
+  //
+  ktls = (!strcasecmp(val, "true") || !strcasecmp(val, "yes") || !strcmp(val, "1"));
+
+
+  return 0;
+}
+
+
+
 /******************************************************************************/
 /*                            x s e c x t r a c t o r                         */
 /******************************************************************************/
@@ -37,6 +37,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -133,6 +134,9 @@ private:
   /// Send some generic data to the client
   int SendData(char *body, int bodylen);
 
+  /// Send a gathered list of buffers to the client, without coalescing them
+  int SendData(const struct iovec *iov, int iovn);
+
   /// Deallocate resources, in order to reutilize an object of this class
   void Cleanup();
 
@@ -160,6 +164,7 @@ private:
   static int xlistdeny(XrdOucStream &Config);
   static int xlistredir(XrdOucStream &Config);
   static int xselfhttps2http(XrdOucStream &Config);
+  static int xktls(XrdOucStream &Config);
   static int xembeddedstatic(XrdOucStream &Config);
   static int xstaticredir(XrdOucStream &Config);
   static int xstaticpreload(XrdOucStream &Config);
@@ -184,7 +189,7 @@ private:
   /// The circular pointers
   char *myBuffStart, *myBuffEnd;
   
-  /// A nice var to hold the current header line
+  /// A nice var to hold a header line that wraps around the end of the buffer
   XrdOucString tmpline;
   
   /// How many bytes still fit into the buffer in a contiguous way
@@ -198,8 +203,8 @@ private:
   void BuffConsume(int blen);
   /// Get a pointer, valid for up to blen bytes from the buffer. Returns the validity
   int BuffgetData(int blen, char **data, bool wait);
-  /// Copy a full line of text from the buffer into dest. Zero if no line can be found in the buffer
-  int BuffgetLine(XrdOucString &dest);
+  /// Locate a full line of text in the buffer, without copying it. Zero if no line can be found in the buffer
+  int BuffgetLine(char *&line);
   
   
   
@@ -235,6 +240,9 @@ private:
   /// connection being established
   bool ssldone;
 
+  /// Tells if the kernel encrypts what we send on this https connection
+  bool ktlssend;
+
   
   
   static XrdCryptoFactory *myCryptoFactory;
@@ -325,6 +333,9 @@ protected:
   
   /// If client is HTTPS, self-redirect with HTTP+token
   static bool selfhttps2http;
+
+  /// If true, try to offload the TLS encryption to the kernel
+  static bool ktls;
   
   /// If true, use the embedded css and icons
   static bool embeddedstatic;
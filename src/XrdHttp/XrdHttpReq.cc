@@ -51,17 +51,24 @@
 #include "Xrd/XrdBuffer.hh"
 
 #include <algorithm> 
+#include <deque>
 #include <functional> 
 #include <cctype>
 #include <locale>
 
 #include "XrdHttpUtils.hh"
+#include "XrdHttpHeaders.hh"
 
 #include "XrdHttpStatic.hh"
 
 #define MAX_TK_LEN      256
 #define MAX_RESOURCE_LEN 16384
 
+// Multi-range GETs on plain http whose ranges are on average at least this
+// large are served with one kXR_read per range, so that sendfile can be used.
+// Smaller ranges are cheaper to fetch all together with a single kXR_readv
+#define MULTIRANGE_READ_MINAVG (128*1024)
+
 // This is to fix the trace macros
 #define TRACELINK prot->Link
 
@@ -141,8 +148,10 @@ int XrdHttpReq::parseLine(char *line, int len) {
   // Do the parsing
   if (!line) return -1;
 
+  // The line is tokenized in place, the terminator (if any) is not part of it
+  char *lineEnd = line + strnlen(line, len);
 
-  char *p = strchr((char *) line, (int) ':');
+  char *p = (char *) memchr(line, ':', lineEnd - line);
   if (!p) {
 
     request = rtMalformed;
@@ -160,8 +169,10 @@ int XrdHttpReq::parseLine(char *line, int len) {
     line[pos] = 0;
     char *val = line + pos + 1;
 
-    // Trim left
-    while ( (!isgraph(*val) || (!*val)) && (val < line+len)) val++;
+    // Trim left and right, the trailing CR included
+    while ((val < lineEnd) && !isgraph(*val)) val++;
+    while ((lineEnd > val) && !isgraph(*(lineEnd - 1))) lineEnd--;
+    *lineEnd = 0;
 
     // Here we are supposed to initialize whatever flag or variable that is needed
     // by looking at the first token of the line
@@ -169,36 +180,39 @@ int XrdHttpReq::parseLine(char *line, int len) {
     // The value is val
     
     // Screen out the needed header lines
-    if (!strcmp(key, "Connection")) {
-
-
-      if (!strcmp(val, "Keep-Alive"))
-        keepalive = true;
-
-    } else if (!strcmp(key, "Host")) {
-      parseHost(val);
-    } else if (!strcmp(key, "Range")) {
-      parseContentRange(val);
-    } else if (!strcmp(key, "Content-Length")) {
-      length = atoll(val);
-
-    } else if (!strcmp(key, "Destination")) {
-      destination.assign(val, line+len-val);
-      trim(destination);
-    } else if (!strcmp(key, "Depth")) {
-      depth = -1;
-      if (strcmp(val, "infinity"))
-        depth = atoll(val);
-
-    } else if (!strcmp(key, "Expect") && strstr(val, "100-continue")) {
-      sendcontinue = true;
+    switch (XrdHttpHeaderID(key, pos)) {
+      case hdrConnection:
+        if (!strcasecmp(val, "Keep-Alive"))
+          keepalive = true;
+        break;
+      case hdrHost:
+        parseHost(val);
+        break;
+      case hdrRange:
+        parseContentRange(val);
+        break;
+      case hdrContentLength:
+        length = atoll(val);
+        break;
+      case hdrDestination:
+        destination.assign(val, lineEnd - val);
+        break;
+      case hdrDepth:
+        depth = -1;
+        if (strcmp(val, "infinity"))
+          depth = atoll(val);
+        break;
+      case hdrExpect:
+        if (strstr(val, "100-continue"))
+          sendcontinue = true;
+        break;
+      default:
+        break;
     }
 
     // We memorize the heaers also as a string
     // because external plugins may need to process it differently
-    std::string ss = val;
-    trim(ss);
-    allheaders[key] = ss;
+    allheaders[key].assign(val, lineEnd - val);
     line[pos] = ':';
   }
 
@@ -339,31 +353,34 @@ int XrdHttpReq::parseFirstLine(char *line, int len) {
 
     *p = ' ';
 
-    // Xlate the known header lines
-    if (!strcmp(key, "GET")) {
-      request = rtGET;
-    } else if (!strcmp(key, "HEAD")) {
-      request = rtHEAD;
-    } else if (!strcmp(key, "PUT")) {
-      request = rtPUT;
-    } else if (!strcmp(key, "POST")) {
-      request = rtPOST;
-    } else if (!strcmp(key, "PATCH")) {
-      request = rtPATCH;
-    } else if (!strcmp(key, "OPTIONS")) {
-      request = rtOPTIONS;
-    } else if (!strcmp(key, "DELETE")) {
-      request = rtDELETE;
-    } else if (!strcmp(key, "PROPFIND")) {
-      request = rtPROPFIND;
-
-    } else if (!strcmp(key, "MKCOL")) {
-      request = rtMKCOL;
-
-    } else if (!strcmp(key, "MOVE")) {
-      request = rtMOVE;
-    } else {
-      request = rtUnknown;
+    // Xlate the known header lines. Dispatch on the verb length first,
+    // so that at most a couple of comparisons are needed
+    request = rtUnknown;
+    switch (pos) {
+      case 3:
+        if (!memcmp(key, "GET", 3)) request = rtGET;
+        else if (!memcmp(key, "PUT", 3)) request = rtPUT;
+        break;
+      case 4:
+        if (!memcmp(key, "HEAD", 4)) request = rtHEAD;
+        else if (!memcmp(key, "POST", 4)) request = rtPOST;
+        else if (!memcmp(key, "MOVE", 4)) request = rtMOVE;
+        break;
+      case 5:
+        if (!memcmp(key, "PATCH", 5)) request = rtPATCH;
+        else if (!memcmp(key, "MKCOL", 5)) request = rtMKCOL;
+        break;
+      case 6:
+        if (!memcmp(key, "DELETE", 6)) request = rtDELETE;
+        break;
+      case 7:
+        if (!memcmp(key, "OPTIONS", 7)) request = rtOPTIONS;
+        break;
+      case 8:
+        if (!memcmp(key, "PROPFIND", 8)) request = rtPROPFIND;
+        break;
+      default:
+        break;
     }
     
     requestverb = key;
@@ -473,6 +490,54 @@ std::string XrdHttpReq::buildPartialHdrEnd(char *token) {
   return s.str();
 }
 
+int XrdHttpReq::sendRangePiece(XrdXrootd::Bridge::Context *info,
+        const struct iovec *iov, int iovn, int dlen) {
+
+  struct iovec head, tail;
+  int headn = 0, tailn = 0;
+  std::string trailer;
+
+  if (rwOpDone >= rwOps.size()) return -1;
+
+  ReadWriteOp &op = rwOps[rwOpDone];
+
+  // The first piece of a range is preceded by its part header
+  if (rwOpPartialDone == 0) {
+    partHdr = buildPartialHdr(op.bytestart, op.byteend, filesize, (char *) "123456");
+    TRACEI(REQ, "Sending multipart: " << op.bytestart << "-" << op.byteend);
+    head.iov_base = (char *) partHdr.c_str();
+    head.iov_len = partHdr.size();
+    headn = 1;
+  }
+
+  // The last piece of the last range is followed by the closing boundary
+  rwOpPartialDone += dlen;
+  if (rwOpPartialDone >= op.byteend - op.bytestart + 1) {
+    rwOpDone++;
+    rwOpPartialDone = 0;
+
+    if (rwOpDone == rwOps.size()) {
+      trailer = buildPartialHdrEnd((char *) "123456");
+      tail.iov_base = (char *) trailer.c_str();
+      tail.iov_len = trailer.size();
+      tailn = 1;
+    }
+  }
+
+  // The sendfile case, the framing goes out in the same call
+  if (info)
+    return (info->Send((headn ? &head : 0), headn, (tailn ? &tail : 0), tailn) ? -1 : 0);
+
+  // The data is in memory, send everything in one go
+  std::vector<struct iovec> parts;
+  parts.reserve(iovn + 2);
+  if (headn) parts.push_back(head);
+  parts.insert(parts.end(), iov, iov + iovn);
+  if (tailn) parts.push_back(tail);
+
+  return prot->SendData(&parts[0], parts.size());
+}
+
 bool XrdHttpReq::Data(XrdXrootd::Bridge::Context &info, //!< the result context
         const
         struct iovec *iovP_, //!< pointer to data array
@@ -500,6 +565,13 @@ int XrdHttpReq::File(XrdXrootd::Bridge::Context &info, //!< the result context
         int dlen //!< byte  count
         ) {
 
+  // The pieces of a multipart response are framed around the sendfile data
+  if (multiRangeByRead) {
+    int rc = sendRangePiece(&info, 0, 0, dlen);
+    TRACE(REQ, " XrdHttpReq::File multipart dlen:" << dlen << " send rc:" << rc);
+    return (rc ? false : true);
+  }
+
   //prot->SendSimpleResp(200, NULL, NULL, NULL, dlen);
   int rc = info.Send(0, 0, 0, 0);
   TRACE(REQ, " XrdHttpReq::File dlen:" << dlen << " send rc:" << rc);
@@ -933,8 +1005,9 @@ int XrdHttpReq::ProcessHTTPReq() {
         default: // Read() or Close()
         {
 
-          if ( ((reqstate == 3) && (rwOps.size() > 1)) ||
-            (writtenbytes >= filesize) ) {
+          if ( ((reqstate == 3) && (rwOps.size() > 1) && !multiRangeByRead) ||
+            (multiRangeByRead && (rwOpDone >= rwOps.size())) ||
+            (!multiRangeByRead && (writtenbytes >= filesize)) ) {
 
             // Close() if this was a readv or we have finished, otherwise read the next chunk
 
@@ -954,8 +1027,9 @@ int XrdHttpReq::ProcessHTTPReq() {
 
           }
 	  
-          if (rwOps.size() <= 1) {
+          if ((rwOps.size() <= 1) || multiRangeByRead) {
             // No chunks or one chunk... Request the whole file or single read
+            // Several large chunks are also read one by one
 
             long l;
             long long offs;
@@ -971,6 +1045,11 @@ int XrdHttpReq::ProcessHTTPReq() {
               offs = writtenbytes;
               xrdreq.read.offset = htonll(writtenbytes);
               xrdreq.read.rlen = htonl(l);
+            } else if (multiRangeByRead) {
+              l = min(rwOps[rwOpDone].byteend - rwOps[rwOpDone].bytestart + 1 - rwOpPartialDone, (long long)1024*1024);
+              offs = rwOps[rwOpDone].bytestart + rwOpPartialDone;
+              xrdreq.read.offset = htonll(offs);
+              xrdreq.read.rlen = htonl(l);
             } else {
               l = min(rwOps[0].byteend - rwOps[0].bytestart + 1 - writtenbytes, (long long)1024*1024);
               offs = rwOps[0].bytestart + writtenbytes;
@@ -978,7 +1057,8 @@ int XrdHttpReq::ProcessHTTPReq() {
               xrdreq.read.rlen = htonl(l);
             }
 
-            if (prot->ishttps) {
+            // No sendfile for https, unless the kernel does the encryption
+            if (prot->ishttps && !prot->ktlssend) {
               if (!prot->Bridge->setSF((kXR_char *) fhandle, false)) {
                 TRACE(REQ, " XrdBridge::SetSF(false) failed.");
 
@@ -1708,6 +1788,21 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
                 }
                 cnt += buildPartialHdrEnd((char *) "123456").size();
 
+                // On plain http (or kernel TLS), large ranges are read one by one
+                // so that they can go out with sendfile. Only well formed ranges qualify
+                long long datalen = 0;
+                multiRangeByRead = (!prot->ishttps || prot->ktlssend);
+                for (size_t i = 0; multiRangeByRead && (i < rwOps.size()); i++) {
+                  if ((rwOps[i].bytestart < 0) || (rwOps[i].bytestart >= filesize) ||
+                      (rwOps[i].byteend < rwOps[i].bytestart))
+                    multiRangeByRead = false;
+                  else
+                    datalen += rwOps[i].byteend - rwOps[i].bytestart + 1;
+                }
+                if (datalen < (long long)rwOps.size() * MULTIRANGE_READ_MINAVG)
+                  multiRangeByRead = false;
+                TRACEI(REQ, "Multipart response, " << rwOps.size() << " ranges, by read: " << multiRangeByRead);
+
                 prot->SendSimpleResp(206, NULL, (char *) "Content-Type: multipart/byteranges; boundary=123456", NULL, cnt);
                 return 0;
               }
@@ -1736,6 +1831,9 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
             
 	    // Close() if this was the third state of a readv, otherwise read the next chunk
 	    if ((reqstate == 3) && (ntohs(xrdreq.header.requestid) == kXR_readv)) return 1;
+
+            // A close has no data to send
+            if (ntohs(xrdreq.header.requestid) == kXR_close) return 1;
 	    
             // If we are here it's too late to send a proper error message...
             if (xrdresp == kXR_error) return -1;
@@ -1747,6 +1845,13 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
               char *p;
               int len;
 
+              // The part headers and the data are gathered and sent together,
+              // straight from the buffers of the bridge. A deque does not move
+              // the headers around while it grows
+              std::deque<std::string> hdrs;
+              std::vector<struct iovec> parts;
+              struct iovec v;
+
               // Cycle on all the data that is coming from the server
               for (int i = 0; i < iovN; i++) {
 
@@ -1757,17 +1862,21 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
                   // Now we have a chunk coming from the server. This may be a partial chunk
 
                   if (rwOpPartialDone == 0) {
-                    string s = buildPartialHdr(rwOps[rwOpDone].bytestart,
+                    hdrs.push_back(buildPartialHdr(rwOps[rwOpDone].bytestart,
                             rwOps[rwOpDone].byteend,
                             filesize,
-                            (char *) "123456");
+                            (char *) "123456"));
 
                     TRACEI(REQ, "Sending multipart: " << rwOps[rwOpDone].bytestart << "-" << rwOps[rwOpDone].byteend);
-                    if (prot->SendData((char *) s.c_str(), s.size())) return -1;
+                    v.iov_base = (char *) hdrs.back().c_str();
+                    v.iov_len = hdrs.back().size();
+                    parts.push_back(v);
                   }
 
-                  // Send all the data we have
-                  if (prot->SendData(p + sizeof (readahead_list), len)) return -1;
+                  // All the data we have
+                  v.iov_base = p + sizeof (readahead_list);
+                  v.iov_len = len;
+                  parts.push_back(v);
 
                   // If we sent all the data relative to the current original chunk request
                   // then pass to the next chunk, otherwise wait for more data
@@ -1784,10 +1893,16 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
               }
 
               if (rwOpDone == rwOps.size()) {
-                string s = buildPartialHdrEnd((char *) "123456");
-                if (prot->SendData((char *) s.c_str(), s.size())) return -1;
+                hdrs.push_back(buildPartialHdrEnd((char *) "123456"));
+                v.iov_base = (char *) hdrs.back().c_str();
+                v.iov_len = hdrs.back().size();
+                parts.push_back(v);
               }
 
+              if (parts.size() && prot->SendData(&parts[0], parts.size())) return -1;
+
+            } else if (multiRangeByRead) {
+              if (sendRangePiece(0, iovP, iovN, iovL)) return -1;
             } else
               for (int i = 0; i < iovN; i++) {
 		if (prot->SendData((char *) iovP[i].iov_base, iovP[i].iov_len)) return -1;
@@ -2183,6 +2298,7 @@ void XrdHttpReq::reset() {
   rwOps_split.clear();
   rwOpDone = 0;
   rwOpPartialDone = 0;
+  multiRangeByRead = false;
   writtenbytes = 0;
   etext.clear();
   redirdest = "";
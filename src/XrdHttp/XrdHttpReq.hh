@@ -107,6 +107,7 @@ public:
     writtenbytes = 0;
     fopened = false;
     headerok = false;
+    multiRangeByRead = false;
   };
 
   virtual ~XrdHttpReq();
@@ -132,6 +133,12 @@ public:
   /// Build the closing part for a multipart response
   std::string buildPartialHdrEnd(char *token);
 
+  /// Send a piece of the current range of a multipart response served by
+  /// kXR_read, framed with the part header and trailer as needed. If info is
+  /// given the data is sent with sendfile, otherwise it is in iov
+  int sendRangePiece(XrdXrootd::Bridge::Context *info,
+                     const struct iovec *iov, int iovn, int dlen);
+
   // Appends to s the opaque info that we have
   void appendOpaque(XrdOucString &s, XrdSecEntity *secent, char *hash, time_t tnow);
 
@@ -201,7 +208,16 @@ public:
 
 
   /// To coordinate multipart responses across multiple calls
-  unsigned int rwOpDone, rwOpPartialDone;
+  unsigned int rwOpDone;
+  /// Bytes of the current range already sent, a range may exceed 4GB
+  long long rwOpPartialDone;
+
+  /// True if a multipart response is served with one kXR_read per range, so
+  /// that the data can go out with sendfile instead of through a kXR_readv
+  bool multiRangeByRead;
+
+  /// The multipart header of the range being sent, it must outlive the send
+  std::string partHdr;
 
   /// The last issued xrd request, often pending
   ClientRequest xrdreq;
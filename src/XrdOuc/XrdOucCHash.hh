@@ -0,0 +1,191 @@
+#ifndef __OUC_CHASH__
+#define __OUC_CHASH__
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O u c C H a s h . h h                         */
+/*                                                                            */
+/* (c) 2026 by European Organization for Nuclear Research (CERN)              */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+// This templated class is an MT-safe replacement for XrdOucHash. It keeps the
+// same <char *key, T *data> interface and item options (see XrdOucHash.hh,
+// Hash_count is not supported) so that tables can be moved over as is.
+//
+// The table is split into shards each with its own read/write lock so that
+// lookups run in parallel and updates only hold up their own shard. A shard
+// is an open addressed (linear probing) table that keeps the full 64-bit hash
+// of each key, keys are only compared when their hashes are equal and are
+// never hashed again. When a shard is 3/4 full it gets a table twice the size
+// and the items are moved over a few at a time by the following updates, so
+// no update ever has to move all of them. Items added with a lifetime are not
+// found once it has passed, updates remove them a few at a time.
+//
+// Find() returns the item's data after the lock was released. Use it only for
+// tables whose items are not deleted while others may still look at them
+// (e.g. tables that are only added to or are replaced as a whole). Otherwise
+// use Copy() which makes a copy of the data while it is being protected.
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "XrdOuc/XrdOucHash.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+template<class T>
+class XrdOucCHash
+{
+public:
+
+// Add() adds a new item to the hash. If it exists and has not expired and
+//       Hash_replace is not specified, the existing data is returned and the
+//       new data is not added. Otherwise, the new item replaces the existing
+//       one and 0 is returned. LifeTime is the number of seconds the item is
+//       to be considered valid, zero keeps it until it is explicitly deleted.
+//
+T           *Add(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default)
+                {return Add(HashVal(KeyVal), KeyVal, KeyData, LifeTime, opt);}
+
+T           *Add(unsigned long long KeyHash, const char *KeyVal, T *KeyData,
+                 const int LifeTime=0, XrdOucHash_Options opt=Hash_default);
+
+// Apply() applies the specified function to every item in the hash with the
+//         same arguments and return value semantics as XrdOucHash::Apply().
+//         Each shard is write locked while the function is applied to its
+//         items, so the function must not use the table itself. Only one
+//         shard is locked at a time, so the function may run concurrently
+//         in several threads, each walking a different shard.
+//
+T           *Apply(int (*func)(const char *, T *, void *), void *Arg);
+
+// Copy() returns a new copy (new T(data)) of the data of an unexpired item or
+//        zero if there is none. The copy is made while the item is locked.
+//
+T           *Copy(const char *KeyVal, time_t *KeyTime=0)
+                 {return Copy(HashVal(KeyVal), KeyVal, KeyTime);}
+
+T           *Copy(unsigned long long KeyHash, const char *KeyVal,
+                  time_t *KeyTime=0);
+
+// Del() deletes the item from the hash. If it doesn't exist, it returns
+//       -ENOENT. Otherwise 0 is returned.
+//
+int          Del(const char *KeyVal) {return Del(HashVal(KeyVal), KeyVal);}
+
+int          Del(unsigned long long KeyHash, const char *KeyVal);
+
+// Expire() removes all of the expired items now and returns how many.
+//
+int          Expire();
+
+// Find() looks up an unexpired item and optionally returns its expiration
+//        time (zero if it never expires). See above for when it may be used.
+//
+T           *Find(const char *KeyVal, time_t *KeyTime=0)
+                 {return Find(HashVal(KeyVal), KeyVal, KeyTime);}
+
+T           *Find(unsigned long long KeyHash, const char *KeyVal,
+                  time_t *KeyTime=0);
+
+// HashVal() returns the hash of a key. Callers that look up the same key in
+//           several tables may compute it once and use the methods above that
+//           take it as the first argument.
+//
+static
+unsigned long long HashVal(const char *KeyVal);
+
+// Num() returns the number of items in the hash table (expired ones included)
+//
+int          Num();
+
+// Purge() deletes all of the items in the table.
+//
+void         Purge();
+
+// Rep() is simply Add() that allows replacement.
+//
+T           *Rep(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default)
+                {return Add(HashVal(KeyVal), KeyVal, KeyData, LifeTime,
+                            (XrdOucHash_Options)(opt | Hash_replace));}
+
+// The size is the number of items expected, the table grows as needed. The
+// number of shards is rounded up to a power of two.
+//
+     XrdOucCHash(int size=256, int shards=16);
+    ~XrdOucCHash();
+
+private:
+
+struct Item
+      {unsigned long long  hash;
+       const char         *key;     // Null if the slot is free
+       T                  *data;
+       time_t              ktime;   // Expiration time, zero if none
+       int                 opts;
+      };
+
+struct Shard
+      {XrdSysRWLock        lock;
+       Item               *tab;     // Current table
+       Item               *old;     // Table being moved into tab, if any
+       int                 tabMask;
+       int                 tabNum;  // Items in tab
+       int                 oldSize;
+       int                 oldNum;  // Items still in old
+       int                 oldNext; // Next slot in old to be moved
+       int                 sweep;   // Next slot in tab to check for expiration
+       char                pad[64]; // Keep other shard locks off this line
+      };
+
+static bool  Expired(Item *ip, time_t &now)
+                    {if (!ip->ktime) return false;
+                     if (!now) now = time(0);
+                     return ip->ktime < now;
+                    }
+void         Free(Item *ip);
+Item        *Locate(Shard &sp, unsigned long long khash, const char *kval,
+                    bool &inOld);
+void         Grow(Shard &sp);
+void         Insert(Shard &sp, Item &item);
+int          Move(Shard &sp, int n);
+void         Remove(Shard &sp, Item *ip, bool inOld);
+Shard       &ShardOf(unsigned long long khash)
+                    {return shards[(khash >> 48) & shardMask];}
+int          Sweep(Shard &sp, int n);
+
+static char  Tomb;                  // Key of items deleted from an old table
+
+Shard       *shards;
+int          shardMask;
+int          initSize;
+};
+
+/******************************************************************************/
+/*                 A c t u a l   I m p l e m e n t a t i o n                  */
+/******************************************************************************/
+
+#include "XrdOuc/XrdOucCHash.icc"
+#endif
@@ -83,7 +83,7 @@
                 is adjusted, as follows:
                 o If the count is < minPages, it is set to minPages.
                 o The count must be > 0 at this point.
-             c) Normally, pre-read pages participate in the LRU scheme. However,
+             c) Normally, pre-read pages participate in the CLOCK scheme. However,
                 if the preread was triggered using 'maxiRead' then the pages are
                 marked for single use only. This means that the moment data is
                 delivered from the page, the page is recycled.
@@ -57,12 +57,13 @@ void *XrdOucCacheRealPRXeq(void *parg)
   
 XrdOucCacheReal::XrdOucCacheReal(int &rc, XrdOucCache::Parms      &ParmV,
                                           XrdOucCacheIO::aprParms *aprP)
-                : Slots(0), Slash(0), Base((char *)MAP_FAILED), Dbg(0), Lgs(0),
+                : Slots(0), Slash(0), Parts(0), PMask(0),
+                  Base((char *)MAP_FAILED), Dbg(0), Lgs(0),
                   AZero(0), Attached(0), prFirst(0), prLast(0),
                   prReady(0), prStop(0), prNum(0)
 {
    size_t Bytes;
-   int n, minPag, isServ = ParmV.Options & isServer;
+   int n, nParts, minPag, isServ = ParmV.Options & isServer;
 
 // Copy over options
 //
@@ -110,7 +111,19 @@ XrdOucCacheReal::XrdOucCacheReal(int &rc, XrdOucCache::Parms      &ParmV,
 // do not have any memory backing but serve as anchors for memory mappings.
 //
    if (!(Slots = new XrdOucCacheSlot[SegCnt+maxFiles])) return;
-   XrdOucCacheSlot::Init(Slots, SegCnt);
+
+// Split the slots into partitions of at least 128 slots each. Partition n gets
+// the slots whose number modulo the number of partitions is n. Slot zero is
+// never used as its page holds the file hash table (see below).
+//
+   nParts = 1;
+   while(nParts < maxParts && SegCnt/(nParts*2) >= 128) nParts *= 2;
+   PMask = nParts-1;
+   Parts = new Part[nParts];
+   for (n = 0; n < nParts; n++)
+       {Parts[n].First = Parts[n].Hand = (n ? n : nParts);
+        Parts[n].Num   = (SegCnt - Parts[n].First + PMask)/nParts;
+       }
 
 // Set pointers to be able to keep track of CacheIO objects and map them to
 // CacheData objects. The hash table will be the first page of slot memory.
@@ -122,10 +135,7 @@ XrdOucCacheReal::XrdOucCacheReal(int &rc, XrdOucCache::Parms      &ParmV,
 
 // Now iniialize the slots to be used for the CacheIO objects
 //
-   for (n = sBeg; n < sEnd; n++)
-       {Slots[n].Own.Next = Slots[n].Own.Prev = n;
-        Slots[n].HLink = n+1;
-       }
+   for (n = sBeg; n < sEnd; n++) Slots[n].HLink = n+1;
    Slots[sEnd-1].HLink = 0;
 
 // Setup the pre-readers if pre-read is enabled
@@ -177,7 +187,8 @@ XrdOucCacheReal::~XrdOucCacheReal()
 
 // Delete the slots
 //
-   delete Slots; Slots = 0;
+   delete [] Slots; Slots = 0;
+   delete [] Parts; Parts = 0;
 
 // Unmap cache memory and associated hash table
 //
@@ -248,8 +259,8 @@ XrdOucCacheIO *XrdOucCacheReal::Attach(XrdOucCacheIO *ioP, int Opts)
 int XrdOucCacheReal::Detach(XrdOucCacheIO *ioP)
 {
    XrdSysMutexHelper Monitor(CMutex);
-   XrdOucCacheSlot  *sP, *oP;
-   int sNum, Fnum, Free = 0, Faults = 0;
+   long long vKey;
+   int sNum, Fnum, Free, Faults = 0;
 
 // Now we delete this CacheIO from the cache set and see if its still ref'd.
 //
@@ -258,17 +269,8 @@ int XrdOucCacheReal::Detach(XrdOucCacheIO *ioP)
 
 // We will be deleting the CacheData object. So, we need to recycle its slots.
 //
-   oP = &Slots[Fnum];
-   while(oP->Own.Next != Fnum)
-        {sP = &Slots[oP->Own.Next];
-         sP->Owner(Slots);
-         if (sP->Contents < 0 || sP->Status.LRU.Next < 0) Faults++;
-            else {sP->Hide(Slots, Slash, sP->Contents%HNum);
-                  sP->Pull(Slots);
-                  sP->unRef(Slots);
-                  Free++;
-                 }
-        }
+   vKey = static_cast<long long>(Fnum-SegCnt) << Shift;
+   Free = Purge(~((1LL << Shift) - 1), vKey, 0, Faults);
 
 // Reduce attach count and check if the cache is being deleted
 //
@@ -309,10 +311,11 @@ void XrdOucCacheReal::eMsg(const char *Path, const char *What, long long xOff,
 char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
                        int &rAmt, int &noIO)
 {
-   XrdSysMutexHelper Monitor(CMutex);
+   int nUse, Slot, segHash = lAddr%HNum;
+   Part *pP = &Parts[segHash & PMask];
+   XrdSysMutexHelper Monitor(pP->Mutex);
    XrdOucCacheSlot::ioQ *Waiter;
    XrdOucCacheSlot *sP;
-   int nUse, Fnum, Slot, segHash = lAddr%HNum;
    char *cBuff;
 
 // See if we have this logical address in the cache. Check if the page is in
@@ -327,12 +330,10 @@ char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
            XrdOucCacheSlot::ioQ ioTrans(sP->Status.waitQ, &ioSem);
            sP->Status.waitQ = &ioTrans;
            if (Dbg > 1) cerr <<"Cache: Wait slot " <<Slot <<endl;
-           CMutex.UnLock(); ioSem.Wait(); CMutex.Lock();
+           pP->Mutex.UnLock(); ioSem.Wait(); pP->Mutex.Lock();
            if (sP->Contents != lAddr) {rAmt = -EIO; return 0;}
-          } else {
-            if (sP->Status.inUse < 0) sP->Status.inUse--;
-               else {sP->Pull(Slots); sP->Status.inUse = -1;}
-          }
+          } else sP->Status.inUse--;
+       sP->reRef();
        rAmt = (sP->Count < 0 ? sP->Count & XrdOucCacheSlot::lenMask : SegSize);
        if (sP->Count & XrdOucCacheSlot::isNew)
           {noIO = -1; sP->Count &= ~XrdOucCacheSlot::isNew;}
@@ -344,25 +345,22 @@ char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
 // Page is not here. If no allocation wanted or we cannot obtain a free slot
 // return and indicate there is no associated cache page.
 //
-   if (!ioP || !(Slot = Slots[Slots->Status.LRU.Next].Pull(Slots)))
+   if (!ioP || !(Slot = Evict(segHash & PMask)))
       {rAmt = -ENOMEM; return 0;}
 
-// Remove ownership over this slot and remove it from the hash table
+// Remove the slot from the hash table
 //
    sP = &Slots[Slot];
-   if (sP->Contents >= 0)
-      {if (sP->Own.Next != Slot) sP->Owner(Slots);
-       sP->Hide(Slots, Slash, sP->Contents%HNum);
-      }
+   if (sP->Contents >= 0) sP->Hide(Slots, Slash, sP->Contents%HNum);
 
 // Read the data into the buffer
 //
    sP->Count |= XrdOucCacheSlot::inTrans;
    sP->Status.waitQ = 0;
-   CMutex.UnLock();
+   pP->Mutex.UnLock();
    cBuff = Base+(static_cast<long long>(Slot)*SegSize);
    rAmt = ioP->Read(cBuff, (lAddr & Strip) << SegShft, SegSize);
-   CMutex.Lock();
+   pP->Mutex.Lock();
 
 // Post anybody waiting for this slot. We hold the cache lock which will give us
 // time to complete the slot definition before the waiting thread looks at it.
@@ -381,17 +379,18 @@ char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
       {sP->Contents   = lAddr;
        sP->HLink      = Slash[segHash];
        Slash[segHash] = Slot;
-       Fnum = (lAddr >> Shift) + SegCnt;
-       Slots[Fnum].Owner(Slots, sP);
        sP->Count = (rAmt == SegSize ? SegFull : rAmt|XrdOucCacheSlot::isShort);
        sP->Status.inUse = nUse;
+       sP->unRef();
        if (Dbg > 2) cerr <<"Cache: Miss slot " <<Slot <<" sz "
                          <<(sP->Count & XrdOucCacheSlot::lenMask) <<endl;
       } else {
        eMsg(ioP->Path(), "reading", (lAddr & Strip) << SegShft, SegSize, rAmt);
        cBuff = 0;
        sP->Contents = -1;
-       sP->unRef(Slots);
+       sP->Count    = 0;
+       sP->Status.inUse = 0;
+       sP->unRef();
       }
 
 // Return the associated buffer or zero, as per above
@@ -399,6 +398,31 @@ char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
    return cBuff;
 }
 
+/******************************************************************************/
+/*                                 E v i c t                                  */
+/******************************************************************************/
+
+int XrdOucCacheReal::Evict(int pNum)
+{
+   Part *pP = &Parts[pNum];
+   XrdOucCacheSlot *sP;
+   int Slot, Spin = pP->Num*2;
+
+// Sweep the clock over the slots of the partition, the caller holds its lock.
+// A referenced page gets a second chance, pages in use or in transit are
+// skipped. Two full turns without a slot mean that all of them are in use.
+//
+   while(Spin-- > 0)
+        {Slot = pP->Hand;
+         if ((pP->Hand += PMask+1) >= SegCnt) pP->Hand = pP->First;
+         sP = &Slots[Slot];
+         if (!sP->isIdle()) continue;
+         if (sP->Contents >= 0 && sP->Refd) {sP->unRef(); continue;}
+         return Slot;
+        }
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 i o A d d                                  */
 /******************************************************************************/
@@ -499,18 +523,47 @@ void XrdOucCacheReal::PreRead(XrdOucCacheReal::prTask *prReq)
    prMutex.UnLock();
 }
 
+/******************************************************************************/
+/*                                 P u r g e                                  */
+/******************************************************************************/
+
+int XrdOucCacheReal::Purge(long long vMask, long long vKey, long long lAddr,
+                           int &Busy)
+{
+   XrdOucCacheSlot *sP;
+   int n, Slot, Free = 0;
+
+// Run through every partition and drop the pages that match the key and are
+// at or above the logical address. Pages in use are hidden and marked gone so
+// that nobody finds them anymore and the last user to let go frees them.
+//
+   for (n = 0; n <= PMask; n++)
+       {XrdSysMutexHelper Monitor(Parts[n].Mutex);
+        for (Slot = Parts[n].First; Slot < SegCnt; Slot += PMask+1)
+            {sP = &Slots[Slot];
+             if (sP->Contents < lAddr || (sP->Contents & vMask) != vKey)
+                continue;
+             sP->Hide(Slots, Slash, sP->Contents%HNum);
+             if (sP->Status.inUse) {sP->Count = XrdOucCacheSlot::isGone; Busy++;}
+                else {sP->unRef(); Free++;}
+            }
+       }
+   return Free;
+}
+
 /******************************************************************************/
 /*                                   R e f                                    */
 /******************************************************************************/
   
 int XrdOucCacheReal::Ref(char *Addr, int rAmt, int sFlags)
 {
-    XrdOucCacheSlot *sP = &Slots[(Addr-Base)>>SegShft];
+    int Slot = (Addr-Base)>>SegShft;
+    XrdOucCacheSlot *sP = &Slots[Slot];
     int eof = 0;
 
 // Indicate how much data was not yet referenced
 //
-   CMutex.Lock();
+   Parts[Slot & PMask].Mutex.Lock();
    if (sP->Contents >= 0)
       {if (sP->Count < 0) eof = 1;
        sP->Status.inUse++;
@@ -518,22 +571,26 @@ int XrdOucCacheReal::Ref(char *Addr, int rAmt, int sFlags)
           {if (sFlags) sP->Count |= sFlags;
               else if (!eof && (sP->Count -= rAmt) < 0) sP->Count = 0;
           } else {
-           if (sFlags) {sP->Count |= sFlags;                 sP->reRef(Slots);}
+           if (sFlags) {sP->Count |= sFlags;                 sP->reRef();}
               else {     if (sP->Count & XrdOucCacheSlot::isSUSE)
-                                                             sP->unRef(Slots);
-                    else if (eof || (sP->Count -= rAmt) > 0) sP->reRef(Slots);
-                    else   {sP->Count = SegSize/2;           sP->unRef(Slots);}
+                                                             sP->unRef();
+                    else if (!eof && (sP->Count -= rAmt) <= 0)
+                           {sP->Count = SegSize/2;           sP->unRef();}
                    }
           }
-      } else eof = 1;
+      } else {
+       if (sP->Count & XrdOucCacheSlot::isGone && ++sP->Status.inUse >= 0)
+          {sP->Count = 0; sP->unRef();}
+       eof = 1;
+      }
 
 // All done
 //
    if (Dbg > 2) cerr <<"Cache: Ref " <<std::hex <<sP->Contents <<std::dec
-                     << " slot " <<((Addr-Base)>>SegShft)
+                     << " slot " <<Slot
                      <<" sz " <<(sP->Count & XrdOucCacheSlot::lenMask)
                      <<" uc " <<sP->Status.inUse <<endl;
-   CMutex.UnLock();
+   Parts[Slot & PMask].Mutex.UnLock();
    return !eof;
 }
 
@@ -543,29 +600,16 @@ int XrdOucCacheReal::Ref(char *Addr, int rAmt, int sFlags)
 
 void XrdOucCacheReal::Trunc(XrdOucCacheIO *ioP, long long lAddr)
 {
-   XrdSysMutexHelper Monitor(CMutex);
-   XrdOucCacheSlot  *sP, *oP;
-   int sNum, Free = 0, Left = 0, Fnum = (lAddr >> Shift) + SegCnt;
+   int Free, Busy = 0, Fnum = (lAddr >> Shift) + SegCnt;
 
 // We will be truncating CacheData pages. So, we need to recycle those slots.
 //
-   oP = &Slots[Fnum]; sP = &Slots[oP->Own.Next];
-   while(oP != sP)
-        {sNum = sP->Own.Next;
-         if (sP->Contents < lAddr) Left++;
-            else {sP->Owner(Slots);
-                  sP->Hide(Slots, Slash, sP->Contents%HNum);
-                  sP->Pull(Slots);
-                  sP->unRef(Slots);
-                  Free++;
-                 }
-         sP = &Slots[sNum];
-        }
+   Free = Purge(~Strip, lAddr & ~Strip, lAddr, Busy);
 
 // Issue debugging message
 //
    if (Dbg) cerr <<"Cache: Trunc " <<Free <<" slots; "
-                 <<Left <<" Left; " <<std::hex << Fnum <<std::dec <<' '
+                 <<Busy <<" Busy; " <<std::hex << Fnum <<std::dec <<' '
                  <<ioP->Path() <<endl;
 }
   
@@ -575,27 +619,31 @@ void XrdOucCacheReal::Trunc(XrdOucCacheIO *ioP, long long lAddr)
   
 void XrdOucCacheReal::Upd(char *Addr, int wLen, int wOff)
 {
-    XrdOucCacheSlot *sP = &Slots[(Addr-Base)>>SegShft];
+    int Slot = (Addr-Base)>>SegShft;
+    XrdOucCacheSlot *sP = &Slots[Slot];
 
 // Check if we extended a short page
 //
-   CMutex.Lock();
+   Parts[Slot & PMask].Mutex.Lock();
    if (sP->Count < 0)
       {int theLen = sP->Count & XrdOucCacheSlot::lenMask;
        if (wLen + wOff > theLen)
           sP->Count = (wLen+wOff) | XrdOucCacheSlot::isShort;
       }
 
-// Adjust the reference counter and if no references, place on the LRU chain
+// Adjust the reference counter and if no references, let the clock see it
 //
    sP->Status.inUse++;
-   if (sP->Status.inUse >= 0) sP->reRef(Slots);
+   if (sP->Status.inUse >= 0)
+      {if (sP->Count & XrdOucCacheSlot::isGone) {sP->Count = 0; sP->unRef();}
+          else sP->reRef();
+      }
 
 // All done
 //
    if (Dbg > 2) cerr <<"Cache: Upd " <<std::hex <<sP->Contents <<std::dec
-                     << " slot " <<((Addr-Base)>>SegShft)
+                     << " slot " <<Slot
                      <<" sz " <<(sP->Count & XrdOucCacheSlot::lenMask)
                      <<" uc " <<sP->Status.inUse <<endl;
-   CMutex.UnLock();
+   Parts[Slot & PMask].Mutex.UnLock();
 }
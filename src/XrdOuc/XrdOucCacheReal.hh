@@ -34,7 +34,14 @@
 #include "XrdOuc/XrdOucCacheSlot.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
-/* This class defines an actual implementation of an XrdOucCache object. */
+/* This class defines an actual implementation of an XrdOucCache object.
+
+   The pages are spread over independently locked partitions: the hash
+   bucket of a page selects its partition and a partition only ever places
+   its pages into its own slots (slot number modulo number of partitions).
+   Hits on pages of different partitions therefore never share a lock and
+   each partition replaces its slots with a CLOCK sweep of its own.
+*/
 
 class XrdOucCacheReal : public XrdOucCacheDram
 {
@@ -63,6 +70,8 @@ void      eMsg(const char *Path, const char *What, long long xOff,
 int       Detach(XrdOucCacheIO *ioP);
 char     *Get(XrdOucCacheIO *ioP, long long lAddr, int &rGot, int &bIO);
 
+int       Evict(int pNum);
+
 int       ioAdd(XrdOucCacheIO *KeyVal, int &iNum);
 int       ioDel(XrdOucCacheIO *KeyVal, int &iNum);
 
@@ -80,6 +89,8 @@ int       ioLookup(int &pip, int hip, void *kval)
                    return hip;
                   }
 
+int       Purge(long long vMask, long long vKey, long long lAddr, int &Busy);
+
 int       Ref(char *Addr, int rAmt, int sFlags=0);
 void      Trunc(XrdOucCacheIO *ioP, long long lAddr);
 void      Upd(char *Addr, int wAmt, int wOff);
@@ -90,9 +101,24 @@ static const long long MaxFO = 0x000007ffffffffffLL;  // Min 4K page -> 8TB-1
 
 XrdOucCacheIO::aprParms aprDefault; // Default automatic preread
 
-XrdSysMutex      CMutex;
+// Each partition has its own lock and clock hand. The slot hash table is
+// shared but a bucket is only touched under the lock of its partition.
+//
+struct Part
+      {XrdSysMutex  Mutex;
+       int          Hand;     // Next slot the clock looks at
+       int          First;    // First slot of the partition
+       int          Num;      // Number of slots in the partition
+       char         Pad[64];  // Keep the locks on separate cache lines
+      };
+
+static const int maxParts = 64;
+
+XrdSysMutex      CMutex;      // Serializes attach, detach and the file table
 XrdOucCacheSlot *Slots;       // 1-to-1 slot to memory map
 int             *Slash;       // Slot hash table
+Part            *Parts;       // Slot partitions
+int              PMask;       // Number of partitions - 1
 char            *Base;        // Base of memory cache
 long long        HNum;
 long long        SegCnt;
@@ -31,7 +31,11 @@
 /******************************************************************************/
   
 /* This class is used to support a memory cache used by an XrdOucCache actual
-   implementation.
+   implementation. The slots are replaced using the CLOCK algorithm: a page
+   that is hit gets its Refd flag set and the clock hand sweeping over the
+   slots clears it, a slot is only reused once the hand finds it unreferenced
+   and not in use. A freshly read page starts unreferenced so that pages that
+   are read only once go first.
 */
 
 class XrdOucCacheData;
@@ -60,64 +64,13 @@ inline void       Hide(XrdOucCacheSlot *Base, int *hTab, int hI)
                        Count = 0; Contents = -1;
                       }
 
-static void       Init(XrdOucCacheSlot *Base, int Num)
-                     {int i;
-                      Base->Status.LRU.Next = Base->Status.LRU.Prev = 0;
-                      Base->Own.Next        = Base->Own.Prev = 0;
-                      for (i = 1; i < Num; i++)
-                          {Base[i].Status.LRU.Next = Base[i].Status.LRU.Prev = i;
-                           Base[i].Own.Next = Base[i].Own.Prev = i;
-                           Base->Push(Base, &Base[i]);
-                          }
-                     }
+inline int        isIdle() {return !(Count & (inTrans | isGone))
+                                && (Contents < 0 || !Status.inUse);
+                           }
 
-inline int        Pull(XrdOucCacheSlot *Base)
-                      {Base[Status.LRU.Prev].Status.LRU.Next = Status.LRU.Next;
-                       Base[Status.LRU.Next].Status.LRU.Prev = Status.LRU.Prev;
-                       Status.LRU.Next = Status.LRU.Prev = this-Base;
-                       return Status.LRU.Next;
-                      }
-
-inline int        Push(XrdOucCacheSlot *Base, XrdOucCacheSlot *sP)
-                      {int UrNum = sP-Base, MyNum = this-Base;
-                       sP->Status.LRU.Next = MyNum;
-                       sP->Status.LRU.Prev = Status.LRU.Prev;
-                       Base[Status.LRU.Prev].Status.LRU.Next = UrNum;
-                       Status.LRU.Prev = UrNum;
-                       return UrNum;
-                      }
-
-inline void       Owner(XrdOucCacheSlot *Base)
-                      {Base[Own.Prev].Own.Next = Own.Next;
-                       Base[Own.Next].Own.Prev = Own.Prev;
-                       Own.Next = Own.Prev = this-Base;
-                      }
-
-inline void       Owner(XrdOucCacheSlot *Base, XrdOucCacheSlot *sP)
-                      {int UrNum = sP-Base, MyNum = this-Base;
-                       sP->Own.Next = MyNum;        sP->Own.Prev = Own.Prev;
-                       Base[Own.Prev].Own.Next = UrNum; Own.Prev = UrNum;
-                      }
-
-inline void       reRef(XrdOucCacheSlot *Base)
-                      {      Status.LRU.Prev           = Base->Status.LRU.Prev;
-                       Base[ Status.LRU.Prev].Status.LRU.Next = this-Base;
-                       Base->Status.LRU.Prev           = this-Base;
-                             Status.LRU.Next           = 0;
-                      }
+inline void       reRef() {Refd = 1;}  // Survive the next sweep of the clock
 
-inline void       unRef(XrdOucCacheSlot *Base)
-                      {      Status.LRU.Next           = Base->Status.LRU.Next;
-                       Base [Status.LRU.Next].Status.LRU.Prev = this-Base;
-                       Base->Status.LRU.Next           = this-Base;
-                             Status.LRU.Prev           = 0;
-                      }
-
-struct SlotList
-      {
-       int              Next;
-       int              Prev;
-      };
+inline void       unRef() {Refd = 0;}  // Be taken by the next sweep
 
 struct ioQ
       {ioQ             *Next;
@@ -129,25 +82,26 @@ struct ioQ
 union  SlotState
       {struct  ioQ     *waitQ;
        XrdOucCacheData *Data;
-       struct  SlotList LRU;
-       int              inUse;
+       int              inUse;  // Negative number of users, 0 if not in use
       };
 
 union {long long        Contents;
        XrdOucCacheIO   *Key;
       };
 SlotState               Status;
-SlotList                Own;
 int                     HLink;
 int                     Count;
+char                    Refd;
 
 static const int  lenMask = 0x01ffffff; // Mask to get true value in Count
 static const int  isShort = 0x80000000; // Short page, Count & lenMask == size
 static const int  inTrans = 0x40000000; // Segment is in transit
 static const int  isSUSE  = 0x20000000; // Segment is single use
 static const int  isNew   = 0x10000000; // Segment is new (not yet referenced)
+static const int  isGone  = 0x08000000; // Segment purged while in use
 
-                  XrdOucCacheSlot() : Contents(-1), HLink(0), Count(0) {}
+                  XrdOucCacheSlot() : Contents(-1), HLink(0), Count(0), Refd(0)
+                                    {Status.Data = 0;}
 
                  ~XrdOucCacheSlot() {}
 };
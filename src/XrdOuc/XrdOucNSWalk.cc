@@ -180,8 +180,12 @@ int XrdOucNSWalk::Build()
    DPfd = -1;
 #endif
 
-// Open the directory
+// Open the directory, reusing the file descriptor if we have one
 //
+#ifdef HAVE_FSTATAT
+   if (DPfd >= 0 && (theEnt.D = fdopendir(DPfd))) theEnt.F = -1;
+      else
+#endif
    if (!(theEnt.D = opendir(DPath)))
       return Emsg("Build", errno, "open directory", DPath);
 
@@ -172,9 +172,10 @@ void XrdPosixConfig::initEnv(char *eData)
    if (!XrdPosixGlobals::myCache) XrdPosixGlobals::myCache = &dramCache;
 
 // Now allocate a cache. Indicate that we already serialize the I/O to avoid
-// additional but unnecessary locking.
+// additional but unnecessary locking. Our files read through XrdCl which is
+// MT-safe, so reads of the same file need not be serialized by the cache.
 //
-   myParms.Options |= XrdOucCache::Serialized;
+   myParms.Options |= XrdOucCache::Serialized | XrdOucCache::ioMTSafe;
    if (!(v1Cache = XrdPosixGlobals::myCache->Create(myParms, &apParms)))
       {DMSG("initEnv", strerror(errno) <<" creating cache.");}
       else XrdPosixGlobals::theCache = new XrdPosixCacheBC(v1Cache);
@@ -38,7 +38,10 @@
 #ifdef __APPLE__
 #define COMMON_DIGEST_FOR_OPENSSL
 #include "CommonCrypto/CommonDigest.h"
+#include <stdlib.h>
 #else
+#include "openssl/evp.h"
+#include "openssl/rand.h"
 #include "openssl/sha.h"
 #endif
 
@@ -97,6 +100,78 @@ char  Vec[XrdSecProtectParms::secFence-1][kXR_REQFENCE-kXR_auth];
 };
 }
 
+/******************************************************************************/
+/*                      C l a s s   X r d S e c S H A 2                       */
+/******************************************************************************/
+
+// Outside of MacOS the hash goes through EVP so that openssl picks the best
+// implementation for this cpu (e.g. the SHA extensions) and, as of openssl
+// 3.0, the digest is fetched from the provider only once and not per request.
+//
+namespace
+{
+#ifndef __APPLE__
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+#define EVP_MD_CTX_new  EVP_MD_CTX_create
+#define EVP_MD_CTX_free EVP_MD_CTX_destroy
+#endif
+
+const EVP_MD *SHA256MD()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+   static const EVP_MD *mdP = EVP_MD_fetch(0, "SHA256", 0);
+   return (mdP ? mdP : EVP_sha256());
+#else
+   return EVP_sha256();
+#endif
+}
+#endif
+
+class XrdSecSHA2
+{
+public:
+
+#ifdef __APPLE__
+bool  Init() {return 0 != SHA256_Init(&sha256);}
+
+bool  Update(const void *data, size_t dlen)
+            {return 1 == SHA256_Update(&sha256, data, dlen);}
+
+bool  Final(unsigned char *hBuff)
+           {return 1 == SHA256_Final(hBuff, &sha256);}
+
+      XrdSecSHA2() {}
+     ~XrdSecSHA2() {}
+
+private:
+SHA256_CTX sha256;
+#else
+bool  Init() {return mdCtx && 1 == EVP_DigestInit_ex(mdCtx, SHA256MD(), 0);}
+
+bool  Update(const void *data, size_t dlen)
+            {return 1 == EVP_DigestUpdate(mdCtx, data, dlen);}
+
+bool  Final(unsigned char *hBuff)
+           {return 1 == EVP_DigestFinal_ex(mdCtx, hBuff, 0);}
+
+      XrdSecSHA2() : mdCtx(EVP_MD_CTX_new()) {}
+     ~XrdSecSHA2() {if (mdCtx) EVP_MD_CTX_free(mdCtx);}
+
+private:
+EVP_MD_CTX *mdCtx;
+#endif
+};
+
+// Compare two hashes in constant time
+//
+bool SameHash(const unsigned char *h1, const unsigned char *h2, int hlen)
+{
+   unsigned char diff = 0;
+   for (int i = 0; i < hlen; i++) diff |= h1[i] ^ h2[i];
+   return diff == 0;
+}
+}
+
 /******************************************************************************/
 /*                        S e c u r i t y   T a b l e                         */
 /******************************************************************************/
@@ -146,22 +221,51 @@ kXR_write,     kXR_signIgnore, kXR_signIgnore, kXR_signNeeded, kXR_signNeeded,
 
 bool XrdSecProtect::GetSHA2(unsigned char *hBuff, struct iovec *iovP, int iovN)
 {
-   SHA256_CTX sha256;
+   XrdSecSHA2 sha256;
 
 // Initialize the hash calculattion
 //
-   if (0 == SHA256_Init(&sha256)) return false;
+   if (!sha256.Init()) return false;
 
 // Go through the iovec updating the hash
 //
    for (int i = 0; i < iovN; i++)
-       {if (1 != SHA256_Update(&sha256, iovP[i].iov_base, iovP[i].iov_len))
-           return false;
+       {if (!sha256.Update(iovP[i].iov_base, iovP[i].iov_len)) return false;
        }
 
 // Compute final hash and return result
 //
-  return (1 == SHA256_Final(hBuff, &sha256));
+  return sha256.Final(hBuff);
+}
+
+/******************************************************************************/
+/* Private:                      G e t H M A C                                */
+/******************************************************************************/
+
+bool XrdSecProtect::GetHMAC(unsigned char *hBuff, const unsigned char *key,
+                            struct iovec *iovP, int iovN)
+{
+   static const int blkLen = 64; // The SHA256 block size
+   XrdSecSHA2    sha256;
+   unsigned char kPad[blkLen], iHash[SHA256_DIGEST_LENGTH];
+   int i;
+
+// Compute the inner hash, H((K ^ ipad) || request)
+//
+   memset(kPad, 0x36, blkLen);
+   for (i = 0; i < hmacKeyLen; i++) kPad[i] ^= key[i];
+   if (!sha256.Init() || !sha256.Update(kPad, blkLen)) return false;
+   for (i = 0; i < iovN; i++)
+       {if (!sha256.Update(iovP[i].iov_base, iovP[i].iov_len)) return false;
+       }
+   if (!sha256.Final(iHash)) return false;
+
+// Compute the outer hash, H((K ^ opad) || inner hash)
+//
+   memset(kPad, 0x5c, blkLen);
+   for (i = 0; i < hmacKeyLen; i++) kPad[i] ^= key[i];
+   return sha256.Init() && sha256.Update(kPad, blkLen)
+       && sha256.Update(iHash, sizeof(iHash)) && sha256.Final(hBuff);
 }
 
 /******************************************************************************/
@@ -245,7 +349,7 @@ int XrdSecProtect::Secure(SecurityRequest *&newreq,
    kXR_unt64     mySeq;
    const char    *sigBuff, *payload = thedata;
    unsigned char secHash[SHA256_DIGEST_LENGTH];
-   int           sigSize, n, newSize, rc, paysize = 0;
+   int           sigSize, n, newSize, rc, paysize = 0, keySize = 0;
    bool          nodata = false;
 
 // Generate a new sequence number
@@ -274,25 +378,48 @@ int XrdSecProtect::Secure(SecurityRequest *&newreq,
             iov[2].iov_len  = paysize;
            }
 
+// When the server offered the keyed hash we pick a random key and send it,
+// encrypted with the session key, along with the first signature. After that
+// the hash need not be encrypted anymore.
+//
+   if (secHmac)
+      {if (!hmacSet)
+          {
+#ifdef __APPLE__
+           arc4random_buf(hmacKey, hmacKeyLen);
+#else
+           if (1 != RAND_bytes(hmacKey, hmacKeyLen)) return -EDOM;
+#endif
+           rc = authProt->Encrypt((const char *)hmacKey, hmacKeyLen, &myReq.bP);
+           if (rc < 0) return rc;
+           keySize = myReq.bP->size;
+          }
+       if (!GetHMAC(secHash, hmacKey, iov, n)) return -EDOM;
+       sigSize = sizeof(secHash);
+       sigBuff = (char *)secHash;
+      } else {
+
 // Compute the hash
 //
-   if (!GetSHA2(secHash, iov, n)) return -EDOM;
+       if (!GetSHA2(secHash, iov, n)) return -EDOM;
 
 // Now encrypt the hash
 //
-   if (edOK)
-      {rc = authProt->Encrypt((const char *)secHash,sizeof(secHash),&myReq.bP);
-       if (rc < 0) return rc;
-       sigSize = myReq.bP->size;
-       sigBuff = myReq.bP->buffer;
-      } else {
-       sigSize = sizeof(secHash);
-       sigBuff = (char *)secHash;
+       if (edOK)
+          {rc = authProt->Encrypt((const char *)secHash, sizeof(secHash),
+                                  &myReq.bP);
+           if (rc < 0) return rc;
+           sigSize = myReq.bP->size;
+           sigBuff = myReq.bP->buffer;
+          } else {
+           sigSize = sizeof(secHash);
+           sigBuff = (char *)secHash;
+          }
       }
 
 // Allocate a new request object
 //
-   newSize = sizeof(SecurityRequest) + sigSize;
+   newSize = sizeof(SecurityRequest) + sigSize + keySize;
    myReq.P = (XrdSecReq *)malloc(newSize);
    if (!myReq.P) return -ENOMEM;
 
@@ -305,11 +432,17 @@ int XrdSecProtect::Secure(SecurityRequest *&newreq,
           sizeof(myReq.P->secReq.sigver.expectrid));
    myReq.P->secReq.sigver.seqno = mySeq;
    if (nodata) myReq.P->secReq.sigver.flags |= kXR_nodata;
-   myReq.P->secReq.sigver.dlen   = htonl(sigSize);
+   if (secHmac) myReq.P->secReq.sigver.crypto = kXR_HMAC256;
+   myReq.P->secReq.sigver.dlen   = htonl(sigSize + keySize);
 
-// Append the signature to the request
+// Append the signature to the request followed by the key, if any
 //
    memcpy(&(myReq.P->secSig), sigBuff, sigSize);
+   if (keySize)
+      {memcpy(&(myReq.P->secSig)+sigSize, myReq.bP->buffer, keySize);
+       myReq.P->secReq.sigver.flags |= kXR_hmackey;
+       hmacSet = true;
+      }
 
 // Return pointer to he security request and its size
 //
@@ -331,6 +464,7 @@ void XrdSecProtect::SetProtection(const ServerResponseReqs_Protocol &inReqs)
       {memset(&myReqs, 0, sizeof(myReqs));
        secVec     = 0;
        secVerData = false;
+       secHmac    = false;
        return;
       }
 
@@ -350,6 +484,7 @@ void XrdSecProtect::SetProtection(const ServerResponseReqs_Protocol &inReqs)
 // Set options
 //
    secVerData    = (inReqs.secopt & kXR_secOData) != 0;
+   secHmac       = (inReqs.secopt & kXR_secOHmac) != 0 && edOK;
 
 // Create a modified vectr if there are overrides
 //
@@ -384,8 +519,8 @@ const char *XrdSecProtect::Verify(SecurityRequest  &secreq,
    static const  int iovNum = 3;
    struct iovec  iov[iovNum];
    buffHold      myReq;
-   unsigned char *inHash, secHash[SHA256_DIGEST_LENGTH];
-   int           dlen, n, rc;
+   unsigned char *inHash, *inKey = 0, secHash[SHA256_DIGEST_LENGTH];
+   int           dlen, n, rc, hType;
 
 // First check for replay attacks. The incomming sequence number must be greater
 // the previous one we have seen. Since it is in network byte order we can use
@@ -403,7 +538,8 @@ const char *XrdSecProtect::Verify(SecurityRequest  &secreq,
       return "Signature requestid mismatch";
    if (secreq.sigver.version   != kXR_secver_0)
       return "Unsupported signature version";
-   if ((secreq.sigver.crypto & kXR_HashMask) != kXR_SHA256)
+   hType = secreq.sigver.crypto & kXR_HashMask;
+   if (hType != kXR_SHA256 && (hType != kXR_HMAC256 || !secHmac))
       return "Unsupported signature hash";
    if (secreq.sigver.crypto & kXR_rsaKey)
       return "Unsupported signature key";
@@ -413,9 +549,31 @@ const char *XrdSecProtect::Verify(SecurityRequest  &secreq,
    dlen = ntohl(secreq.header.dlen);
    inHash = ((unsigned char *)&secreq)+sizeof(SecurityRequest);
 
+// A keyed hash is sent in the clear. The first one is followed by the key
+// encrypted with the session key, which we use from then on.
+//
+   if (hType == kXR_HMAC256)
+      {if (secreq.sigver.flags & kXR_hmackey)
+          {if (hmacSet) return "Duplicate signature key";
+           if (dlen <= (int)sizeof(secHash))
+              return "Invalid signature hash length";
+           rc = authProt->Decrypt((const char *)inHash+sizeof(secHash),
+                                  dlen-sizeof(secHash), &myReq.bP);
+           if (rc < 0) return strerror(-rc);
+           if (myReq.bP->size != hmacKeyLen)
+              return "Invalid signature key length";
+           inKey = (unsigned char *)myReq.bP->buffer;
+          } else {
+           if (!hmacSet) return "Missing signature key";
+           if (dlen != (int)sizeof(secHash))
+              return "Invalid signature hash length";
+           inKey = hmacKey;
+          }
+      }
+
 // Now decrypt the hash
 //
-   if (edOK)
+   else if (edOK)
       {rc = authProt->Decrypt((const char *)inHash, dlen, &myReq.bP);
        if (rc < 0) return strerror(-rc);
        if (myReq.bP->size != (int)sizeof(secHash))
@@ -440,16 +598,20 @@ const char *XrdSecProtect::Verify(SecurityRequest  &secreq,
 
 // Compute the hash
 //
-   if (!GetSHA2(secHash, iov, n))
+   if (!(inKey ? GetHMAC(secHash, inKey, iov, n) : GetSHA2(secHash, iov, n)))
       return "Signature hash computation failed";
 
 // Compare this hash with the hash we were given
 //
-   if (memcmp(secHash, inHash, sizeof(secHash)))
+   if (!SameHash(secHash, inHash, sizeof(secHash)))
       return "Signature hash mismatch";
 
-// This request has been verified (update the seqno)
+// This request has been verified (update the seqno and record the key)
 //
    lastSeqno = secreq.sigver.seqno;
+   if (inKey && !hmacSet)
+      {memcpy(hmacKey, inKey, hmacKeyLen);
+       hmacSet = true;
+      }
    return 0;
 }
@@ -138,7 +138,8 @@ protected:
          XrdSecProtect(XrdSecProtocol *aprot=0, bool edok=true)     // Client!
                       : Need2Secure(&XrdSecProtect::Screen),
                         authProt(aprot), secVec(0), lastSeqno(1),
-                        edOK(edok), secVerData(false)
+                        edOK(edok), secVerData(false), secHmac(false),
+                        hmacSet(false)
                         {}
 
          XrdSecProtect(XrdSecProtocol *aprot, XrdSecProtect &pRef, // Server!
@@ -146,11 +147,14 @@ protected:
                       : Need2Secure(&XrdSecProtect::Screen),
                         authProt(aprot), secVec(pRef.secVec),
                         lastSeqno(0), edOK(edok),
-                        secVerData(pRef.secVerData) {}
+                        secVerData(pRef.secVerData),
+                        secHmac(pRef.secHmac && edok), hmacSet(false) {}
 
 void     SetProtection(const ServerResponseReqs_Protocol &inReqs);
 
 private:
+bool            GetHMAC(unsigned char *hBuff, const unsigned char *key,
+                        struct iovec *iovP, int iovN);
 bool            GetSHA2(unsigned char *hBuff, struct iovec *iovP, int iovN);
 bool            Screen(ClientRequest &thereq);
 
@@ -162,6 +166,10 @@ union {kXR_unt64             lastSeqno;  // Used by Secure()
       };
 bool                         edOK;
 bool                         secVerData;
+bool                         secHmac;    // Sign with the keyed hash
+bool                         hmacSet;    // hmacKey sent or received
+static const int             hmacKeyLen = 32;
+unsigned char                hmacKey[hmacKeyLen];
 static const unsigned int    maxRIX = kXR_REQFENCE-kXR_auth;
 char                         myVec[maxRIX];
 };
@@ -157,6 +157,8 @@ void XrdSecProtector::Config(const XrdSecProtectParms    &parms,
       reqs.secopt |= kXR_secOData;
    if ((parms.opts & XrdSecProtectParms::force)  != 0)
       reqs.secopt |= kXR_secOFrce;
+   if ((parms.opts & XrdSecProtectParms::doHmac) != 0)
+      reqs.secopt |= kXR_secOHmac;
 
 // Setup level
 //
@@ -50,6 +50,7 @@ int        opts;    //!< In:  Options:
 static const int   doData = 0x0000001; //!< Secure data
 static const int   relax  = 0x0000002; //!< relax old clients
 static const int   force  = 0x0000004; //!< Allow unencryted hash
+static const int   doHmac = 0x0000008; //!< Offer the keyed hash
 
             XrdSecProtectParms() : level(secNone), opts(0) {}
            ~XrdSecProtectParms() {}
@@ -401,6 +401,7 @@ int XrdSecServer::Configure(const char *cfn)
    extern XrdSecProtector *XrdSecLoadProtection(XrdSysError &erP);
    static const int isRlx = XrdSecProtectParms::relax;
    static const int isFrc = XrdSecProtectParms::force;
+   static const int isHmc = XrdSecProtectParms::doHmac;
    XrdSecProtector *protObj;
    const char *lName = "none", *rName = "none";
    char *var;
@@ -452,10 +453,12 @@ int XrdSecServer::Configure(const char *cfn)
    if (!NoGo)
       {eDest.Say("Config ","Local  protection level: ",
                  (lclParms.opts & isRlx ? "relaxed " : 0), lName,
-                 (lclParms.opts & isFrc ? " force"   : 0));
+                 (lclParms.opts & isFrc ? " force"   : 0),
+                 (lclParms.opts & isHmc ? " hmac"    : 0));
        eDest.Say("Config ","Remote protection level: ",
                  (rmtParms.opts & isRlx ? "relaxed " : 0), rName,
-                 (rmtParms.opts & isFrc ? " force"   : 0));
+                 (rmtParms.opts & isFrc ? " force"   : 0),
+                 (rmtParms.opts & isHmc ? " hmac"    : 0));
       }
 
 // Now we are done
@@ -567,7 +570,8 @@ int XrdSecServer::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute
 
 /* Function: xlevel
 
-   Purpose:  To parse the directive: level [<type>] [relaxed] <level> [force]
+   Purpose:  To parse the directive: level [<type>] [relaxed] <level>
+                                             [force] [hmac]
 
              <type>  all | local | remote
              <level> none | compatible | standard | intense | pedantic
@@ -586,6 +590,7 @@ int XrdSecServer::xlevel(XrdOucStream &Config, XrdSysError &Eroute)
                  };
    int i, numopts = sizeof(ltab)/sizeof(struct lvltab);
    bool isLcl = true, isRmt = true, isSpec = false, isRlx = false, isFRC=false;
+   bool isHMC = false;
    char *val;
 
 // Get the template host
@@ -623,14 +628,13 @@ int XrdSecServer::xlevel(XrdOucStream &Config, XrdSysError &Eroute)
    if (i >= numopts)
       {Eroute.Emsg("Config", "invalid level option -", val); return 1;}
 
-// Check for final keyword
+// Check for final keywords
 //
-   val = Config.GetWord();
-   if (val && val[0])
-      {if (strcmp(val, "force"))
-          {Eroute.Emsg("Config","invalid level modifier - ", val); return 1;}
-       isFRC = true;
-      }
+   while((val = Config.GetWord()) && val[0])
+        {     if (!strcmp(val, "force")) isFRC = true;
+         else if (!strcmp(val, "hmac"))  isHMC = true;
+         else {Eroute.Emsg("Config","invalid level modifier - ", val); return 1;}
+        }
 
 // Set appropriate levels
 //
@@ -640,6 +644,8 @@ int XrdSecServer::xlevel(XrdOucStream &Config, XrdSysError &Eroute)
           else    lclParms.opts  &= ~XrdSecProtectParms::relax;
        if (isFRC) lclParms.opts  |=  XrdSecProtectParms::force;
           else    lclParms.opts  &= ~XrdSecProtectParms::force;
+       if (isHMC) lclParms.opts  |=  XrdSecProtectParms::doHmac;
+          else    lclParms.opts  &= ~XrdSecProtectParms::doHmac;
       }
    if (isRmt)
       {rmtParms.level = ltab[i].lvl;
@@ -647,6 +653,8 @@ int XrdSecServer::xlevel(XrdOucStream &Config, XrdSysError &Eroute)
           else    rmtParms.opts  &= ~XrdSecProtectParms::relax;
        if (isFRC) rmtParms.opts  |=  XrdSecProtectParms::force;
           else    rmtParms.opts  &= ~XrdSecProtectParms::force;
+       if (isHMC) rmtParms.opts  |=  XrdSecProtectParms::doHmac;
+          else    rmtParms.opts  &= ~XrdSecProtectParms::doHmac;
       }
    return 0;
 }
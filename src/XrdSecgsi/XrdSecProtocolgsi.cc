@@ -156,6 +156,7 @@ XrdSecgsiAuthzKey_t XrdSecProtocolgsi::AuthzKey = 0;
 int    XrdSecProtocolgsi::AuthzCertFmt = -1;
 int    XrdSecProtocolgsi::GMAPCacheTimeOut = -1;
 int    XrdSecProtocolgsi::AuthzCacheTimeOut = 43200;  // 12h, default
+int    XrdSecProtocolgsi::ChainCacheTimeOut = 0;  // no cache, default
 String XrdSecProtocolgsi::SrvAllowedNames;
 int    XrdSecProtocolgsi::VOMSAttrOpt = 1;
 XrdSecgsiAuthz_t XrdSecProtocolgsi::VOMSFun = 0;
@@ -176,6 +177,7 @@ XrdSutCache  XrdSecProtocolgsi::cacheCert(8,13); // Server certificates info cac
 XrdSutCache  XrdSecProtocolgsi::cachePxy(8,13);  // Client proxies cache (Fibonacci-based sizes)
 XrdSutCache  XrdSecProtocolgsi::cacheGMAPFun; // Entries mapped by GMAPFun (default size 144)
 XrdSutCache  XrdSecProtocolgsi::cacheAuthzFun; // Entities filled by AuthzFun (default size 144)
+XrdSutCache  XrdSecProtocolgsi::cacheChain; // Verified client chains (default size 144)
 //
 // Services
 XrdOucGMap *XrdSecProtocolgsi::servGMap = 0; // Grid map service
@@ -751,6 +753,12 @@ char *XrdSecProtocolgsi::Init(gsiOptions opt, XrdOucErrInfo *erp)
          GMAPCacheTimeOut = opt.gmapto;
          DEBUG("grid-map cache entries expire after "<<GMAPCacheTimeOut<<" secs");
       }
+      //
+      // Expiration of verified client chains cache entries
+      if (opt.chainto >= 0) {
+         ChainCacheTimeOut = opt.chainto;
+         DEBUG("verified chains cache entries expire after "<<ChainCacheTimeOut<<" secs");
+      }
 
       //
       // Request for delegated proxies
@@ -1567,6 +1575,33 @@ static bool AuthzFunCheck(XrdSutCacheEntry *e, void *a) {
    return false;
 }
 
+//_____________________________________________________________________________
+typedef struct {
+   XrdSutCacheArg_t arg;
+   const char      *fp;   // Fingerprint of the chain presented by the client
+} gsiChainArg_t;
+
+static bool ChainCheck(XrdSutCacheEntry *e, void *a) {
+
+   int st_ref = (*((gsiChainArg_t *)a)).arg.arg1;
+   time_t ts_ref = (time_t)(*((gsiChainArg_t *)a)).arg.arg2;
+   long to_ref = (*((gsiChainArg_t *)a)).arg.arg3;
+   int st_exp = (*((gsiChainArg_t *)a)).arg.arg4;
+   const char *fp = (*((gsiChainArg_t *)a)).fp;
+
+   if (e) {
+      // Valid if it is the same chain, verified less than to_ref secs ago,
+      // and none of its certificates expired in the meantime
+      if (e->status == st_ref && e->buf2.buf && e->buf3.buf &&
+          !strcmp(e->buf3.buf, fp) &&
+          (ts_ref - e->mtime) <= to_ref && ts_ref < *((int *) e->buf2.buf))
+         return true;
+      // Invalidate the entry
+      e->status = st_exp;
+   }
+   return false;
+}
+
 /******************************************************************************/
 /*                          A u t h e n t i c a t e                           */
 /******************************************************************************/
@@ -1622,6 +1657,10 @@ int XrdSecProtocolgsi::Authenticate(XrdSecCredentials *cred,
    // Proxy export related
    XrdOucString spxy;
    XrdSutBucket *bpxy = 0;
+   // Verified chains cache related
+   XrdSutCERef chref;
+   XrdSutCacheEntry *chent = 0;
+   bool idcached = 0;
 
    //
    // Decode received buffer
@@ -1712,7 +1751,28 @@ int XrdSecProtocolgsi::Authenticate(XrdSecCredentials *cred,
       kS_rc = kgST_ok;
       nextstep = kXGS_none;
 
-      if (GMAPOpt > 0) {
+      //
+      // The identity mapped to a recently verified chain is cached with it;
+      // if it is not there, the entry stays write-locked until we have it
+      if (hs->ChainTag.length() > 0) {
+         bool rdlock = false;
+         gsiChainArg_t arg = {{kCE_ok, hs->TimeStamp, ChainCacheTimeOut, kCE_disabled},
+                              hs->ChainFP.c_str()};
+         if ((chent = cacheChain.Get(hs->ChainTag.c_str(), rdlock,
+                                     ChainCheck, (void *) &arg))) {
+            chref.Set(&(chent->rwmtx));
+            if (rdlock) {
+               CopyEntity((XrdSecEntity *) chent->buf1.buf, &Entity);
+               chref.UnLock();
+               chent = 0;
+               idcached = 1;
+               DEBUG("identity from verified chains cache: "<<
+                     (Entity.name ? Entity.name : "<none>"));
+            }
+         }
+      }
+
+      if (!idcached && GMAPOpt > 0) {
          // Get name from gridmap
          String name;
          QueryGMAP(hs->Chain, hs->TimeStamp, name);
@@ -1776,11 +1836,11 @@ int XrdSecProtocolgsi::Authenticate(XrdSecCredentials *cred,
       }
 
       // Add the DN as default moninfo if requested (the authz plugin may change this)
-      if (MonInfoOpt > 0) {
+      if (!idcached && MonInfoOpt > 0) {
          Entity.moninfo = strdup(hs->Chain->EECname());
       }
 
-      if (VOMSAttrOpt > 0) {
+      if (!idcached && VOMSAttrOpt > 0) {
          if (VOMSFun) {
             // Fill the information needed by the external function
             if (VOMSCertFmt == 1) {
@@ -1816,6 +1876,40 @@ int XrdSecProtocolgsi::Authenticate(XrdSecCredentials *cred,
          NOTIFY("VOMS: Entity.endorsements: "<< (Entity.endorsements ? Entity.endorsements : "<none>"));
       }
 
+      //
+      // Save the identity with the verified chain
+      if (chent) {
+         XrdSecEntity *se = new XrdSecEntity();
+         int slen = 0;
+         CopyEntity(&Entity, se, &slen);
+         // The host is the one of this connection
+         SafeFree(se->host);
+         if (chent->buf1.buf) {
+            FreeEntity((XrdSecEntity *) chent->buf1.buf);
+            delete (XrdSecEntity *) chent->buf1.buf;
+         }
+         chent->buf1.buf = (char *) se;
+         chent->buf1.len = slen;
+         // Valid until the first certificate of the chain expires
+         int notafter = -1;
+         XrdCryptoX509 *xc = hs->Chain->Begin();
+         while (xc) {
+            if (notafter < 0 || xc->NotAfter() < notafter)
+               notafter = xc->NotAfter();
+            xc = hs->Chain->Next();
+         }
+         if (chent->buf2.buf) delete (int *) chent->buf2.buf;
+         chent->buf2.buf = (char *) new int(notafter);
+         chent->buf2.len = sizeof(int);
+         // The chain it was verified for
+         chent->buf3.SetBuf(hs->ChainFP.c_str(), hs->ChainFP.length() + 1);
+         chent->status = kCE_ok;
+         chent->cnt = 0;
+         chent->mtime = hs->TimeStamp;
+         chref.UnLock();
+         chent = 0;
+      }
+
       // Here prepare/extract the information for authorization
       spxy = "";
       bpxy = 0;
@@ -2206,6 +2300,7 @@ void gsiOptions::Print(XrdOucTrace *t)
       POPTS(t, " GRIDmap file: " << (gridmap ? gridmap : XrdSecProtocolgsi::GMAPFile));
       POPTS(t, " GRIDmap option: "<< ogmap);
       POPTS(t, " GRIDmap cache entries expiration (secs): "<< gmapto);
+      POPTS(t, " Verified chains cache entries expiration (secs): "<< chainto);
       if (gmapfun) {
          POPTS(t, " DN mapping function: " << gmapfun);
          if (gmapfunparms) POPTS(t, " DN mapping function parms: " << gmapfunparms);
@@ -2466,6 +2561,7 @@ char *XrdSecProtocolgsiInit(const char mode,
       //              [-authzfunparms:<authz_function_init_parameters>]
       //              [-authzto:<authz_cache_entry_validity_in_secs>]
       //              [-gmapto:<grid_map_cache_entry_validity_in_secs>]
+      //              [-chainto:<verified_chain_cache_entry_validity_in_secs>]
       //              [-gmapopt:<grid_map_check_option>]
       //              [-dlgpxy:<proxy_req_option>]
       //              [-exppxy:<filetemplate>]
@@ -2498,6 +2594,7 @@ char *XrdSecProtocolgsiInit(const char mode,
       int ogmap = 1;
       int gmapto = 600;
       int authzto = -1;
+      int chainto = 0;
       int dlgpxy = 0;
       int authzpxy = 0;
       int vomsat = 1;
@@ -2546,6 +2643,8 @@ char *XrdSecProtocolgsiInit(const char mode,
                authzto = atoi(op+9);
             } else if (!strncmp(op, "-gmapto:",8)) {
                gmapto = atoi(op+8);
+            } else if (!strncmp(op, "-chainto:",9)) {
+               chainto = atoi(op+9);
             } else if (!strncmp(op, "-dlgpxy:",8)) {
                dlgpxy = atoi(op+8);
             } else if (!strncmp(op, "-exppxy:",8)) {
@@ -2582,6 +2681,7 @@ char *XrdSecProtocolgsiInit(const char mode,
       opts.ogmap = ogmap;
       opts.gmapto = gmapto;
       opts.authzto = authzto;
+      opts.chainto = chainto;
       opts.dlgpxy = dlgpxy;
       opts.authzpxy = authzpxy;
       opts.vomsat = vomsat;
@@ -3496,10 +3596,54 @@ int XrdSecProtocolgsi::ServerDoCert(XrdSutBuffer *br,  XrdSutBuffer **bm,
       return -1;
    }
    //
+   // The same certificates may have been verified recently (e.g. a batch job
+   // reconnecting with its proxy). There is one entry per EEC subject and
+   // requested user, so the cache grows with the number of clients and not
+   // with the number of proxies they use; the entry keeps the fingerprint of
+   // the chain last verified and the identity mapped to it in the kXGC_cert
+   // step. A hit skips the chain verification, CRL check included, so a
+   // revocation may only be seen up to ChainCacheTimeOut secs later.
+   bool verified = 0;
+   hs->ChainTag = "";
+   hs->ChainFP = "";
+   XrdCryptoMsgDigest *fpmd = 0;
+   if (ChainCacheTimeOut > 0 && hs->Chain->Reorder() == 0 &&
+       hs->Chain->EECname() && (fpmd = sessionCF->MsgDigest("sha256"))) {
+      fpmd->Update(bck->buffer, bck->size);
+      fpmd->Final();
+      hs->ChainFP = fpmd->AsHexString();
+      delete fpmd;
+      hs->ChainTag = hs->Chain->EECname();
+      XrdSutBucket *bcku = (*bm)->GetBucket(kXRS_user);
+      if (bcku) {
+         String user;
+         bcku->ToString(user);
+         hs->ChainTag += ":";
+         hs->ChainTag += user;
+      }
+      XrdSutCERef ceref;
+      bool rdlock = false;
+      gsiChainArg_t arg = {{kCE_ok, hs->TimeStamp, ChainCacheTimeOut, kCE_disabled},
+                           hs->ChainFP.c_str()};
+      XrdSutCacheEntry *cent = cacheChain.Get(hs->ChainTag.c_str(), rdlock,
+                                              ChainCheck, (void *) &arg);
+      if (cent) {
+         ceref.Set(&(cent->rwmtx));
+         verified = rdlock;
+      }
+   }
+   //
    // Verify the chain
    x509ChainVerifyOpt_t vopt = {0,static_cast<int>(hs->TimeStamp),-1,hs->Crl};
    XrdCryptoX509Chain::EX509ChainErr ecode = XrdCryptoX509Chain::kNone;
-   if (!(hs->Chain->Verify(ecode, &vopt))) {
+   if (verified) {
+      // Just put it in order, as Verify does
+      DEBUG("client chain verified recently: "<<hs->ChainTag);
+      if (hs->Chain->Reorder() != 0) {
+         cmsg = "certificate chain is inconsistent";
+         return -1;
+      }
+   } else if (!(hs->Chain->Verify(ecode, &vopt))) {
       cmsg = "certificate chain verification failed: ";
       cmsg += hs->Chain->LastError();
       return -1;
@@ -186,6 +186,8 @@ public:
    char  *authzfun;// [s] file with the function to fill entities [0]
    char  *authzfunparms;// [s] parameters for the function to fill entities [0]
    int    authzto; // [s] validity in secs of authz cache entries [-1 => unlimited]
+   int    chainto; // [s] validity in secs of verified client chains cache entries [0 => no cache];
+                  // [s] a cached chain is not checked again, CRL included
    int    ogmap;  // [s] gridmap file checking option 
    int    dlgpxy; // [c] explicitely ask the creation of a delegated proxy 
                   // [s] ask client for proxies
@@ -206,6 +208,7 @@ public:
                   proxy = 0; valid = 0; deplen = 0; bits = 512;
                   gridmap = 0; gmapto = 600;
                   gmapfun = 0; gmapfunparms = 0; authzfun = 0; authzfunparms = 0; authzto = -1;
+                  chainto = 0;
                   ogmap = 1; dlgpxy = 0; sigpxy = 1; srvnames = 0;
                   exppxy = 0; authzpxy = 0;
                   vomsat = 1; vomsfun = 0; vomsfunparms = 0; moninfo = 0; hashcomp = 1; }
@@ -311,6 +314,7 @@ private:
    static XrdSecgsiAuthzKey_t AuthzKey; 
    static int              AuthzCertFmt; 
    static int              AuthzCacheTimeOut;
+   static int              ChainCacheTimeOut;
    static int              PxyReqOpts;
    static int              AuthzPxyWhat;
    static int              AuthzPxyWhere;
@@ -334,6 +338,7 @@ private:
    static XrdSutCache   cachePxy;  // Client proxies cache; 
    static XrdSutCache   cacheGMAPFun; // Cache for entries mapped by GMAPFun
    static XrdSutCache   cacheAuthzFun; // Cache for entities filled by AuthzFun
+   static XrdSutCache   cacheChain; // Verified client chains and their identity
    //
    // Services
    static XrdOucGMap      *servGMap;  // Grid mapping service 
@@ -465,6 +470,8 @@ public:
    XrdSutPFEntry    *Cref;          // Cache reference
    XrdSutPFEntry    *Pent;          // Pointer to relevant file entry 
    X509Chain        *Chain;         // Chain to be eventually verified 
+   String            ChainTag;      // Tag of Chain in the verified chains cache
+   String            ChainFP;       // Fingerprint of Chain (sha256 of the bucket)
    XrdCryptoX509Crl *Crl;           // Pointer to CRL, if required 
    X509Chain        *PxyChain;      // Proxy Chain on clients
    bool              RtagOK;        // Rndm tag checked / not checked
@@ -477,7 +484,7 @@ public:
    gsiHSVars() { Iter = 0; TimeStamp = -1; CryptoMod = "";
                  RemVers = -1; Rcip = 0;
                  Cbck = 0;
-                 ID = ""; Cref = 0; Pent = 0; Chain = 0; Crl = 0; PxyChain = 0;
+                 ID = ""; Cref = 0; Pent = 0; Chain = 0; ChainTag = ""; ChainFP = ""; Crl = 0; PxyChain = 0;
                  RtagOK = 0; Tty = 0; LastStep = 0; Options = 0; HashAlg = 0; Parms = 0;}
 
    ~gsiHSVars() { SafeDelete(Cref);
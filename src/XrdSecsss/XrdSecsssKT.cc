@@ -42,7 +42,76 @@
 #include "XrdOuc/XrdOucErrInfo.hh"
 #include "XrdOuc/XrdOucStream.hh"
 #include "XrdOuc/XrdOucUtils.hh"
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysHeaders.hh"
+#include "XrdSys/XrdSysTimer.hh"
+
+extern unsigned long XrdOucHashVal(const char *KeyVal);
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+// A keytab as it was read in: the key list never changes once it is published
+// so lookups need no lock. The first key for each key name and for each key
+// ID is found via open addressed tables built when the snapshot is made.
+//
+class XrdSecsssKT::ktSnap
+{
+public:
+
+ktEnt *Find(long long ID)
+           {int i = IDHash(ID) & tabMask;
+            while(idTab[i] && idTab[i]->Data.ID != ID) i = (i+1) & tabMask;
+            return idTab[i];
+           }
+
+ktEnt *Find(const char *Name)
+           {int i = XrdOucHashVal(Name) & tabMask;
+            while(nmTab[i] && strcmp(nmTab[i]->Data.Name, Name))
+                 i = (i+1) & tabMask;
+            return nmTab[i];
+           }
+
+void   Index()
+           {ktEnt *ktP;
+            int i, n = 0;
+            if (idTab) {delete [] idTab; delete [] nmTab;}
+            for (ktP = List; ktP; ktP = ktP->Next) n++;
+            for (tabMask = 15; tabMask < n*2; tabMask = tabMask*2+1) {}
+            idTab = new ktEnt*[tabMask+1]();
+            nmTab = new ktEnt*[tabMask+1]();
+            for (ktP = List; ktP; ktP = ktP->Next)
+                {i = IDHash(ktP->Data.ID) & tabMask;
+                 while(idTab[i] && idTab[i]->Data.ID != ktP->Data.ID)
+                      i = (i+1) & tabMask;
+                 if (!idTab[i]) idTab[i] = ktP;
+                 i = XrdOucHashVal(ktP->Data.Name) & tabMask;
+                 while(nmTab[i] && strcmp(nmTab[i]->Data.Name,ktP->Data.Name))
+                      i = (i+1) & tabMask;
+                 if (!nmTab[i]) nmTab[i] = ktP;
+                }
+           }
+
+ktEnt *List;
+
+       ktSnap(ktEnt *kList) : List(kList), idTab(0), nmTab(0) {Index();}
+      ~ktSnap() {ktEnt *ktP;
+                 while((ktP = List)) {List = List->Next; delete ktP;}
+                 delete [] idTab; delete [] nmTab;
+                }
+private:
+
+static
+unsigned int IDHash(long long ID)
+                   {unsigned long long h = ID * 0x9e3779b97f4a7c15ULL;
+                    return static_cast<unsigned int>(h >> 32);
+                   }
+
+ktEnt **idTab;
+ktEnt **nmTab;
+int     tabMask;
+};
   
 /******************************************************************************/
 /*                    S t a t i c   D e f i n i t i o n s                     */
@@ -82,7 +151,8 @@ XrdSecsssKT::XrdSecsssKT(XrdOucErrInfo *eInfo, const char *kPath,
 //
    ktRefID= 0;
    ktPath = (kPath ? strdup(kPath) : 0);
-   ktList = 0; kthiID = 0; ktMode = oMode; ktRefT = (time_t)refrInt;
+   ktTab = new ktSnap(0); kthiID = 0; ktMode = oMode; ktRefT = (time_t)refrInt;
+   rdEpoch = rdCount[0] = rdCount[1] = 0;
    if (eInfo) eInfo->setErrCode(0);
 
 // Prepare /dev/random if we have it
@@ -110,7 +180,9 @@ XrdSecsssKT::XrdSecsssKT(XrdOucErrInfo *eInfo, const char *kPath,
 
 // Now read in the whole key table and start possible refresh thread
 //
-   if ((ktList = getKeyTab(eInfo, sbuf.st_mtime, sbuf.st_mode))
+   if ((ktTab->List = getKeyTab(eInfo, sbuf.st_mtime, sbuf.st_mode)))
+      ktTab->Index();
+   if (ktTab->List
    && (oMode != isAdmin) && (!eInfo || eInfo->getErrInfo() == 0))
       {if ((retc = XrdSysThread::Run(&ktRefID,XrdSecsssKTRefresh, (void *)this,
                                      XRDSYSTHREAD_HOLD)))
@@ -124,13 +196,8 @@ XrdSecsssKT::XrdSecsssKT(XrdOucErrInfo *eInfo, const char *kPath,
 
 XrdSecsssKT::~XrdSecsssKT()
 {
-   ktEnt *ktP;
    void  *Dummy;
 
-// Lock against others
-//
-   myMutex.Lock();
-
 // Kill the refresh thread first
 //
    if (ktRefID && !XrdSysThread::Kill(ktRefID))
@@ -141,9 +208,7 @@ XrdSecsssKT::~XrdSecsssKT()
 //
    if (ktPath) {free(ktPath); ktPath = 0;}
 
-   while((ktP = ktList)) {ktList = ktList->Next; delete ktP;}
-
-   myMutex.UnLock();
+   delete ktTab; ktTab = 0;
 }
   
 /******************************************************************************/
@@ -161,16 +226,18 @@ void XrdSecsssKT::addKey(ktEnt &ktNew)
    ktNew.Data.ID  = static_cast<long long>(ktNew.Data.Crt & 0x7fffffff) << 32L
                   | static_cast<long long>(++kthiID);
 
-// Locate place to insert this key
+// Locate place to insert this key (only the admin changes a keytab in place
+// and it has no concurrent readers)
 //
-   ktP = ktList;
+   ktP = ktTab->List;
    while(ktP && !isKey(*ktP, &ktNew, 0)) {ktPP = ktP; ktP = ktP->Next;}
 
 // Now chain in the entry
 //
-   if (ktPP) ktPP->Next = &ktNew;
-      else   ktList     = &ktNew;
+   if (ktPP) ktPP->Next    = &ktNew;
+      else   ktTab->List = &ktNew;
    ktNew.Next = ktP;
+   ktTab->Index();
 }
 
 /******************************************************************************/
@@ -179,19 +246,20 @@ void XrdSecsssKT::addKey(ktEnt &ktNew)
   
 int XrdSecsssKT::delKey(ktEnt &ktDel)
 {
-   ktEnt *ktN, *ktPP = 0, *ktP = ktList;
+   ktEnt *ktN, *ktPP = 0, *ktP = ktTab->List;
    int nDel = 0;
 
 // Remove all matching keys
 //
    while(ktP)
         {if (isKey(ktDel, ktP))
-            {if (ktPP) ktPP->Next = ktP->Next;
-                else   ktList     = ktP->Next;
+            {if (ktPP) ktPP->Next    = ktP->Next;
+                else   ktTab->List = ktP->Next;
              ktN = ktP; ktP = ktP->Next; delete ktN; nDel++;
             } else {ktPP = ktP; ktP = ktP->Next;}
         }
 
+   if (nDel) ktTab->Index();
    return nDel;
 }
 
@@ -201,20 +269,22 @@ int XrdSecsssKT::delKey(ktEnt &ktDel)
   
 int XrdSecsssKT::getKey(ktEnt &theEnt)
 {
-   ktEnt *ktP, *ktN;
+   ktSnap *ktS;
+   ktEnt  *ktP, *ktN;
+   int rdE;
 
-// Lock the keytab to prevent modification
+// Keep the current keytab from being deleted while we look at it
 //
-   myMutex.Lock();
-   ktP = ktList;
+   rdE = rdEnter();
+   ktS = ktTab;
 
 // Find first key by key name (used normally by clients) or by keyID
 //
    if (!*theEnt.Data.Name)
-      {if (theEnt.Data.ID >= 0) 
-          while(ktP && ktP->Data.ID != theEnt.Data.ID)  ktP = ktP->Next;
+      {if (theEnt.Data.ID >= 0) ktP = ktS->Find(theEnt.Data.ID);
+          else ktP = ktS->List;
       }
-      else {while(ktP && strcmp(ktP->Data.Name,theEnt.Data.Name)) ktP=ktP->Next;
+      else {ktP = ktS->Find(theEnt.Data.Name);
             while(ktP && ktP->Data.Exp <= time(0))
                  {if (!(ktN=ktP->Next) 
                   ||  strcmp(ktN->Data.Name,theEnt.Data.Name)) break;
@@ -225,7 +295,7 @@ int XrdSecsssKT::getKey(ktEnt &theEnt)
 // If we found a match, export it
 //
    if (ktP) theEnt = *ktP;
-   myMutex.UnLock();
+   rdLeave(rdE);
 
 // Indicate if key expired
 //
@@ -295,6 +365,15 @@ void XrdSecsssKT::genKey(char *kBP, int kLen)
         }
 }
 
+/******************************************************************************/
+/*                               k e y L i s t                                */
+/******************************************************************************/
+
+XrdSecsssKT::ktEnt *XrdSecsssKT::keyList()
+{
+   return ktTab->List;
+}
+
 /******************************************************************************/
 /*                               R e f r e s h                                */
 /******************************************************************************/
@@ -302,20 +381,31 @@ void XrdSecsssKT::genKey(char *kBP, int kLen)
 void XrdSecsssKT::Refresh()
 {
    XrdOucErrInfo eInfo;
-   ktEnt *ktNew, *ktOld, *ktNext;
+   ktEnt *ktNew, *ktNext;
+   ktSnap *ktOld, *ktSnew;
    struct stat sbuf;
    int retc = 0;
 
-// Get change time of keytable and if changed, update it
+// Get change time of keytable and if changed, update it. The new keytab is
+// built on the side and replaces the current one as a whole, the swap is a
+// full barrier so a reader never sees the new keytab before its contents. The
+// old one is deleted once no reader can still be looking at it.
 //
    if (stat(ktPath, &sbuf) == 0)
       {if (sbuf.st_mtime == ktMtime) return;
        if ((ktNew = getKeyTab(&eInfo, sbuf.st_mtime, sbuf.st_mode))
        && eInfo.getErrInfo() == 0)
-          {myMutex.Lock(); ktOld = ktList; ktList = ktNew; myMutex.UnLock();
-          } else ktOld = ktNew;
-       while(ktOld) {ktNext = ktOld->Next; delete ktOld; ktOld = ktNext;}
-       if ((retc == eInfo.getErrInfo()) == 0) return;
+          {ktSnew = new ktSnap(ktNew);
+           AtomicBeg(myMutex);
+           ktOld = ktTab;
+           AtomicCAS(ktTab, ktOld, ktSnew);
+           AtomicEnd(myMutex);
+           rdWait();
+           delete ktOld;
+          } else {
+           while(ktNew) {ktNext = ktNew->Next; delete ktNew; ktNew = ktNext;}
+          }
+       if ((retc = eInfo.getErrInfo()) == 0) return;
       } else retc = errno;
 
 // Refresh failed
@@ -355,7 +445,7 @@ int XrdSecsssKT::Rewrite(int Keep, int &numKeys, int &numTot, int &numExp)
 // Write all of the keytable
 //
    ktCurr.Data.Name[0] = ktCurr.Data.User[0] = ktCurr.Data.Grup[0] = 3;
-   ktN = ktList; numKeys = numTot = numExp = 0;
+   ktN = ktTab->List; numKeys = numTot = numExp = 0;
    while((ktP = ktN))
         {ktN = ktN->Next; numTot++;
          if (ktP->Data.Name[0] == '\0') continue;
@@ -686,3 +776,56 @@ while((tp = kTab.GetToken()) && !Prob)
 //
    return ktNew;
 }
+
+/******************************************************************************/
+/*                               r d E n t e r                                */
+/******************************************************************************/
+
+// Readers never wait: they only count themselves under the current epoch.
+//
+int XrdSecsssKT::rdEnter()
+{
+   int rdE;
+
+   AtomicBeg(myMutex);
+   rdE = AtomicGet(rdEpoch) & 1;
+   AtomicInc(rdCount[rdE]);
+   AtomicEnd(myMutex);
+   return rdE;
+}
+
+/******************************************************************************/
+/*                               r d L e a v e                                */
+/******************************************************************************/
+  
+void XrdSecsssKT::rdLeave(int rdE)
+{
+   AtomicBeg(myMutex);
+   AtomicDec(rdCount[rdE]);
+   AtomicEnd(myMutex);
+}
+
+/******************************************************************************/
+/*                                r d W a i t                                 */
+/******************************************************************************/
+
+// Called after a new keytab is published: wait for all readers that may still
+// use the previous one. A reader may fetch the epoch before a flip and count
+// itself after we found its epoch drained, so it is only sure to be gone once
+// the epoch was flipped twice (the readers are only around for a lookup).
+//
+void XrdSecsssKT::rdWait()
+{
+   int i, rdE, n;
+
+   for (i = 0; i < 2; i++)
+       {AtomicBeg(myMutex);
+        rdE = AtomicInc(rdEpoch) & 1;
+        AtomicEnd(myMutex);
+        do {AtomicBeg(myMutex);
+            n = AtomicGet(rdCount[rdE]);
+            AtomicEnd(myMutex);
+            if (n) XrdSysTimer::Wait(1);
+           } while(n);
+       }
+}
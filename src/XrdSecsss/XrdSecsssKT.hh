@@ -97,7 +97,7 @@ void   genKey(char *Buff, int blen);
 
 int    getKey(ktEnt &ktEql);
 
-ktEnt *keyList() {return ktList;}
+ktEnt *keyList();
 
 void   Refresh();
 
@@ -116,6 +116,8 @@ enum   xMode {isAdmin = 0, isClient, isServer};
       ~XrdSecsssKT();
 
 private:
+class  ktSnap;
+
 int    eMsg(const char *epn, int rc, const char *txt1,
             const char *txt2=0, const char *txt3=0, const char *txt4=0);
 ktEnt *getKeyTab(XrdOucErrInfo *eInfo, time_t Mtime, mode_t Amode);
@@ -124,10 +126,15 @@ int    isKey(ktEnt &ktRef, ktEnt *ktP, int Full=1);
 void   keyB2X(ktEnt *theKT, char *buff);
 void   keyX2B(ktEnt *theKT, char *xKey);
 ktEnt *ktDecode0(XrdOucStream &kTab, XrdOucErrInfo *eInfo);
+int    rdEnter();
+void   rdLeave(int epoch);
+void   rdWait();
 
 XrdSysMutex myMutex;
 char       *ktPath;
-ktEnt      *ktList;
+ktSnap * volatile ktTab;    // Current keytab, replaced as a whole
+int         rdEpoch;        // Readers register under the parity of this
+int         rdCount[2];     // Readers per epoch parity
 time_t      ktMtime;
 xMode       ktMode;
 time_t      ktRefT;
@@ -39,6 +39,7 @@
 #include "Xrd/XrdScheduler.hh"
 #include "Xrd/XrdTrace.hh"
 
+#include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 
 #include "XrdNet/XrdNetAddr.hh"
@@ -76,6 +77,8 @@ extern XrdSsiLogger::MCB_t *msgCBCl;
        bool          dsTTLSet = false;
        bool          reqTOSet = false;
        bool          strTOSet = false;
+       bool          reqMux   = false;
+       bool          reqPipe  = false;
 }
 
 using namespace XrdSsi;
@@ -141,6 +144,16 @@ XrdSsiService *XrdSsiClientProvider::GetService(XrdSsiErrInfo     &eInfo,
       if (!dsTTLSet) clEnvP->PutInt("DataServerTTL",  maxTMO);
       if (!reqTOSet) clEnvP->PutInt("RequestTimeout", maxTMO);
       if (!strTOSet) clEnvP->PutInt("StreamTimeout",  maxTMO);
+// Multiplexed mode lets requests share sessions and pipelines the response
+// wait behind the request. The latter relies on in-order delivery, which is
+// only assured when a single stream is used per channel.
+//
+      if (getenv("XRDSSIMUX"))
+         {int subStrm = XrdCl::DefaultSubStreamsPerChannel;
+          clEnvP->GetInt("SubStreamsPerChannel", subStrm);
+          reqMux  = true;
+          reqPipe = subStrm <= 1;
+         }
       initDone = true;
       clMutex.UnLock();
      }
@@ -315,14 +315,20 @@ void XrdSsiFileReq::Done(int &retc, XrdOucErrInfo *eiP, const char *name)
    DEBUGXQ("wtrsp sent; resp "
            <<(XrdSsiRRAgent::RespP(this)->rType ? "here" : "pend"));
 
-// We are invoked when sync() waitresp has been sent, check if a response was
-// posted while this was going on. If so, make sure to send a wakeup. Note
-// that the respWait flag is at this moment false as this is called in the
-// sync response path for fctl() and the response may have been posted.
-//
-   if (XrdSsiRRAgent::RespP(this)->rType == XrdSsiRespInfo::isNone)
-      respWait = true;
-      else WakeUp();
+// We are invoked when sync() waitresp has been sent, check if an alert or a
+// response was posted while this was going on. If so, make sure to send a
+// wakeup; alerts go first as they precede the response. Note that the
+// respWait flag is at this moment false as this is called in the sync
+// response path for fctl() and the response may have been posted.
+//
+   if (alrtPend)
+      {XrdSsiAlert *aP = alrtPend;
+       if (!(alrtPend = alrtPend->next)) alrtLast = 0;
+       WakeUp(aP);
+      }
+   else if (XrdSsiRRAgent::RespP(this)->rType == XrdSsiRespInfo::isNone)
+           respWait = true;
+   else WakeUp();
 }
 
 /******************************************************************************/
@@ -502,6 +508,11 @@ void XrdSsiFileReq::Init(const char *cID)
    strmEOF    = false;
    isEnding   = false;
    XrdSsiRRAgent::SetMutex(this, &frqMutex);
+
+// A recycled object still holds the previous response until the request is
+// bound. Clear it as the client may ask for the response before that happens.
+//
+   XrdSsiRRAgent::RespP(this)->Init();
 }
 
 /******************************************************************************/
@@ -46,6 +46,7 @@
 namespace XrdSsi
 {
        XrdSsiScale   sidScale;
+extern bool          reqMux;
 }
 
 using namespace XrdSsi;
@@ -185,7 +186,7 @@ void XrdSsiServReal::ProcessRequest(XrdSsiRequest  &reqRef,
 // Check if this is a reusable resource. Reusable resources are a bit more
 // complicated to pull off. In any case, we need to hold the cache lock.
 //
-   if (resRef.rOpts & useCache)
+   if (resRef.rOpts & useCache || reqMux)
       {mHelp.Lock(&rcMutex);
        if (ResReuse(reqRef, resRef, resKey)) return;
       }
@@ -216,14 +217,24 @@ void XrdSsiServReal::ProcessRequest(XrdSsiRequest  &reqRef,
 // Now just provision this resource which will execute the request should it
 // be successful. If Provision() fails, we need to delete the session object
 // because its file object now is in an usable state (funky client interface).
+// The session never made it into the cache, so drop the cache lock first.
 //
-   if (!(sObj->Provision(&reqRef, epURL))) Recycle(sObj, false);
+   if (!(sObj->Provision(&reqRef, epURL)))
+      {mHelp.UnLock();
+       Recycle(sObj, false);
+       return;
+      }
 
 // If this was started with a reusable resource, put the session in the cache.
-// The resource key was constructed by the call to ResReuse() and teh cache
-// mutex is still held at this point (will be released upon return).
+// In multiplexed mode every session is cached so that subsequent requests for
+// the same resource run in it while it has active requests. The resource key
+// was constructed by the call to ResReuse() and the cache mutex is still held
+// at this point (will be released upon return).
 //
-   if (hold) resCache[resKey] = sObj;
+   if (hold || reqMux)
+      {resCache[resKey] = sObj;
+       sObj->SetCacheKey(resKey.c_str());
+      }
 }
 
 /******************************************************************************/
@@ -239,6 +250,18 @@ void XrdSsiServReal::Recycle(XrdSsiSessReal *sObj, bool reuse)
 //
    sObj->ClrEvent();
 
+// If the session was cached, make sure the cache no longer refers to it as
+// it may be deleted or reused for another resource.
+//
+   rcMutex.Lock();
+   if (sObj->CacheKey())
+      {std::map<std::string, XrdSsiSessReal *>::iterator it;
+       it = resCache.find(sObj->CacheKey());
+       if (it != resCache.end() && it->second == sObj) resCache.erase(it);
+       sObj->SetCacheKey();
+      }
+   rcMutex.UnLock();
+
 // Add to queue unless we have too many of these
 //
    myMutex.Lock();
@@ -280,8 +303,10 @@ bool XrdSsiServReal::ResReuse(XrdSsiRequest  &reqRef,
 // Entry found, check if this session can actually be reused
 //
    sesP = it->second;
-   if (resRef.rOpts & XrdSsiResource::Discard || !sesP->Run(&reqRef))
+   if (resRef.rOpts & XrdSsiResource::Discard
+   || !sesP->Run(&reqRef, (resRef.rOpts & XrdSsiResource::Reusable) != 0))
       {resCache.erase(it);
+       sesP->SetCacheKey();
        sesP->UnHold();
        return false;
       }
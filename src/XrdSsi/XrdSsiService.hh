@@ -153,6 +153,15 @@ virtual bool   Prepare(XrdSsiErrInfo &eInfo, const XrdSsiResource &rDesc);
 //!         For background queries, the XrdSsiRequest::ProcessResponse() is 
 //!         called with a response type of isHandle when the request is handed
 //!         off to the endpoint for execution (see XrdSsiRequest::SetDetachTTL).
+//!
+//! Special notes for client-side processing:
+//!
+//! When the envar XRDSSIMUX is set before the first service is obtained, all
+//! requests for the same resource and user are multiplexed over one session
+//! for as long as that session has active requests, as if the resource were
+//! Reusable. Each request's response is then asked for together with the
+//! request itself, so a request costs a single round trip. The latter is only
+//! done when the client uses a single stream per channel (the default).
 //-----------------------------------------------------------------------------
 
 virtual void   ProcessRequest(XrdSsiRequest  &reqRef,
@@ -129,6 +129,7 @@ XrdSsiSessReal::~XrdSsiSessReal()
 
    if (sessName) free(sessName);
    if (sessNode) free(sessNode);
+   if (cacheKey) free(cacheKey);
 
    while((tP = freeTask)) {freeTask = tP->attList.next; delete tP;}
 }
@@ -149,11 +150,14 @@ void XrdSsiSessReal::InitSession(XrdSsiServReal *servP, const char *sName,
    alocLeft  = XrdSsiRRInfo::idMax;
    isHeld    = hold;
    inOpen    = false;
+   inClose   = false;
    noReuse   = false;
    if (sessName) free(sessName);
    sessName  = (sName ? strdup(sName) : 0);
    if (sessNode) free(sessNode);
    sessNode  = 0;
+   if (cacheKey) free(cacheKey);
+   cacheKey  = 0;
 }
 
 /******************************************************************************/
@@ -250,14 +254,16 @@ void XrdSsiSessReal::RelTask(XrdSsiTaskReal *tP) // sessMutex locked!
 /*                                   R u n                                    */
 /******************************************************************************/
 
-bool XrdSsiSessReal::Run(XrdSsiRequest *reqP)
+bool XrdSsiSessReal::Run(XrdSsiRequest *reqP, bool hold)
 {
    XrdSsiMutexMon sessMon(sessMutex);
    XrdSsiTaskReal *tP;
 
-// If we are not allowed to be reused, return to indicated try someone else
+// If we are not allowed to be reused, return to indicated try someone else.
+// The same applies if the session is being closed, which happens to sessions
+// shared in multiplexed mode once their last request has finished.
 //
-   if (noReuse) return false;
+   if (noReuse || inClose) return false;
 
 // Reserve a stream ID. If we cannot then indicate we cannot be reused
 //
@@ -266,6 +272,7 @@ bool XrdSsiSessReal::Run(XrdSsiRequest *reqP)
 // Queue a new task
 //
    tP = NewTask(reqP);
+   if (hold) isHeld = true;
 
 // If we are already open and we have a task, send off the request
 //
@@ -349,7 +356,7 @@ void XrdSsiSessReal::UnHold()
 // Turn off the hold flag and if we have no attached tasks, schedule shutdown
 //
    isHeld = false;
-   if (!attBase) XrdSsi::schedP->Schedule(new CleanUp(this));
+   if (!attBase && !inClose) XrdSsi::schedP->Schedule(new CleanUp(this));
 }
 
 /******************************************************************************/
@@ -367,6 +374,7 @@ void XrdSsiSessReal::Unprovision() // Called with sessMutex locked!
 //
    DEBUG("Closing " <<sessName);
    ClrEvent();
+   inClose = true;
 
 // If the file is not open (it might be due to an open error) then do a
 // shutdown right away. Otherwise, try to close if successful the event
@@ -29,6 +29,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "XrdCl/XrdClFile.hh"
@@ -47,6 +48,8 @@ public:
 
 XrdSsiSessReal  *nextSess;
 
+const   char    *CacheKey() {return cacheKey;}
+
         void     InitSession(XrdSsiServReal *servP,
                              const char     *sName,
                              int             uent,
@@ -58,7 +61,12 @@ XrdSsiMutex     *MutexP() {return &sessMutex;}
 
         bool     Provision(XrdSsiRequest *reqP, const char *epURL);
 
-        bool     Run(XrdSsiRequest *reqP);
+        bool     Run(XrdSsiRequest *reqP, bool hold=false);
+
+        void     SetCacheKey(const char *key=0)
+                            {if (cacheKey) free(cacheKey);
+                             cacheKey = (key ? strdup(key) : 0);
+                            }
 
         void     TaskFinished(XrdSsiTaskReal *tP);
 
@@ -77,7 +85,7 @@ XrdSsiMutex     *MutexP() {return &sessMutex;}
                                 bool            hold=false)
                                : XrdSsiEvent("SessReal"),
                                  sessMutex(XrdSsiMutex::Recursive),
-                                 sessName(0), sessNode(0)
+                                 sessName(0), sessNode(0), cacheKey(0)
                                  {InitSession(servP, sName, uent, hold);}
 
                 ~XrdSsiSessReal();
@@ -96,11 +104,13 @@ XrdSsiTaskReal  *freeTask;
 XrdSsiRequest   *requestP;
 char            *sessName;
 char            *sessNode;
+char            *cacheKey; // Set while in the service's resource cache
 uint32_t         nextTID;
 uint32_t         alocLeft;
 int16_t          uEnt;     // User index for scaling
 bool             isHeld;
 bool             inOpen;
+bool             inClose;
 bool             noReuse;
 };
 #endif
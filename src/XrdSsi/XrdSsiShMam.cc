@@ -68,13 +68,14 @@ struct ShmInfo
        int   highUse;       // Offset to high memory that is used
        char  reUse;         // When non-zero items can be reused (r/o locking)
        char  multW;         // When non-zero multiple writers are allowed
-       char  rsvd1;
+       char  seqLock;       // When non-zero updates are versioned in seqNum
        char  rsvd2;
        int   maxKeys;       // Maximum number of keys
        int   maxKeySz;      // Longest allowed key (not including null byte)
        int   hashID;        // The name of the hash
        char  typeID[64];    // Name of the type stored here
        char  myName[64];    // Name of the implementation
+       unsigned int seqNum; // Update sequence number (odd while updating)
       };
 #define SHMINFO(x) ((ShmInfo *)shmBase)->x
 
@@ -90,8 +91,49 @@ struct ShmInfo
 
 int       PageMask = ~(sysconf(_SC_PAGESIZE)-1);
 int       PageSize =   sysconf(_SC_PAGESIZE);
+
+// Number of times a reader tries to get a consistent view of a versioned map
+// before falling back to locking the file.
+//
+const int SeqTries = 64;
+
+// Versioned maps record the implementation name with this suffix. Attachers
+// that would update such a map without versioning it (i.e. older releases and
+// builds without atomics) do not know the name and refuse to attach the map.
+//
+const char SeqMark[] = "+seq";
+
+// Check if the recorded implementation name is impl, returning in isSeq whether
+// the map is versioned.
+//
+bool ImplName(const char *name, const char *impl, bool &isSeq)
+{
+   int n = strlen(impl);
+
+   if (strncmp(name, impl, n)) return false;
+   if (!name[n]) {isSeq = false; return true;}
+#ifndef NEED_ATOMIC_MUTEX
+   if (!strcmp(name+n, SeqMark)) {isSeq = true; return true;}
+#endif
+   return false;
+}
 }
 
+/******************************************************************************/
+/*                         M e m o r y   F e n c e s                          */
+/******************************************************************************/
+
+#if defined(NEED_ATOMIC_MUTEX)
+#define SEQ_FENCE_ACQ
+#define SEQ_FENCE_REL
+#elif __cplusplus >= 201103L
+#define SEQ_FENCE_ACQ std::atomic_thread_fence(std::memory_order_acquire)
+#define SEQ_FENCE_REL std::atomic_thread_fence(std::memory_order_release)
+#else
+#define SEQ_FENCE_ACQ __sync_synchronize()
+#define SEQ_FENCE_REL __sync_synchronize()
+#endif
+
 /******************************************************************************/
 /*                         L o c a l   C l a s s e s                          */
 /******************************************************************************/
@@ -138,6 +180,30 @@ pthread_rwlock_t *mtxP;
 
                 ~MutexHelper() {if (mtxP)  pthread_rwlock_unlock(mtxP);}
 };
+
+// Versioned maps let readers proceed without the file lock. Writers, which
+// always hold the file lock for such maps, make the sequence number odd while
+// they change the map and even once done. A sequence number left odd by a
+// writer that died is made even by the next one locking the file (see Lock()).
+//
+class SeqHelper
+{
+public:
+void             Begin(Atomic(unsigned int) *seq)
+                      {if (seqP || !seq) return;
+                       seqP = seq;
+                       seqN = Atomic_GET((*seq));
+                       seqN += (seqN & 1 ? 2 : 1);
+                       Atomic_SET((*seq), seqN);
+                       SEQ_FENCE_REL;
+                      }
+
+                 SeqHelper() : seqP(0), seqN(0) {}
+                ~SeqHelper() {if (seqP) Atomic_SET_STRICT((*seqP), seqN+1);}
+private:
+Atomic(unsigned int) *seqP;
+unsigned int     seqN;
+};
 }
 
 /******************************************************************************/
@@ -216,6 +282,7 @@ XrdSsiShMam::XrdSsiShMam(XrdSsiShMat::NewParms &parms) : XrdSsiShMat(parms)
    shmTemp   = 0;
    shmSize   = 0;
    shmBase   = 0;
+   shmSeq    = 0;
    shmFD     =-1;
    timeOut   =-1;
    lkCount   = 0;
@@ -245,6 +312,7 @@ bool XrdSsiShMam::AddItem(void *newdata, void *olddata, const char *key,
                           int   hash,    bool  replace)
 {
    XLockHelper lockInfo(this, RWLock);
+   SeqHelper   seqInfo;
    MemItem  *theItem, *prvItem, *newItem;
    int hEnt, kLen, iOff, retEno = 0;
 
@@ -278,6 +346,7 @@ bool XrdSsiShMam::AddItem(void *newdata, void *olddata, const char *key,
    if (hEnt)
       {if (olddata) memcpy(olddata, ITEM_VAL(theItem), shmTypeSz);
        if (!replace) {errno = EEXIST; return false;}
+       seqInfo.Begin(shmSeq);
        if (reUse)
           {memcpy(ITEM_VAL(theItem), newdata, shmTypeSz);
            if (syncOn) Updated(ITEM_VOF(theItem), shmTypeSz);
@@ -287,8 +356,9 @@ bool XrdSsiShMam::AddItem(void *newdata, void *olddata, const char *key,
        retEno = EEXIST;
       }
 
-// Get a new item
+// Get a new item. From here on lock-free readers may see the map changing.
 //
+   seqInfo.Begin(shmSeq);
    if (!(newItem = NewItem())) {errno = ENOSPC; return false;}
 
 // Construct the new item
@@ -346,7 +416,9 @@ bool XrdSsiShMam::Attach(int tout, bool isrw)
    XLockHelper lockInfo(this, (isrw ? RWLock : ROLock));
    struct stat Stat1, Stat2;
    int mMode, oMode;
+   bool isSeq;
    union {int *intP; Atomic(int) *antP;} xntP;
+   union {unsigned int *intP; Atomic(unsigned int) *antP;} xseqP;
 
 // Compute open and mmap options
 //
@@ -397,7 +469,8 @@ bool XrdSsiShMam::Attach(int tout, bool isrw)
 // Verify tha the objects in this mapping are compatible with this object
 //
    if (SHMINFO(typeSz) != shmTypeSz    || strcmp(shmType, SHMINFO(typeID))
-   || strcmp(shmImpl, SHMINFO(myName)) || shmHash != SHMINFO(hashID))
+   || !ImplName(SHMINFO(myName), shmImpl, isSeq)
+   || shmHash != SHMINFO(hashID))
       {errno = EDOM; return false;}
 
 // Copy out the information we can use locally
@@ -409,6 +482,8 @@ bool XrdSsiShMam::Attach(int tout, bool isrw)
    shmSlots   = SHMINFO(slots);
    shmItemSz  = SHMINFO(itemSz);
    shmInfoSz  = SHMINFO(infoSz);
+   xseqP.intP = &SHMINFO(seqNum);
+   shmSeq     = (isSeq ? xseqP.antP : 0);
 
 // Now, there is a loophole here as the file could have been exported while
 // we were trying to attach it. If this happened, the inode would change.
@@ -439,6 +514,7 @@ bool XrdSsiShMam::Create(XrdSsiShMat::CRZParms &parms)
    ShmInfo theInfo;
    int n, maxEnts, totSz, indexSz;
    union {int *intP; Atomic(int) *antP;} xntP;
+   union {unsigned int *intP; Atomic(unsigned int) *antP;} xseqP;
 
 // Validate parameter list values
 //
@@ -494,12 +570,16 @@ bool XrdSsiShMam::Create(XrdSsiShMat::CRZParms &parms)
    theInfo.highUse  = theInfo.index;
    theInfo.reUse    = reUse;
    theInfo.multW    = multW;
+#ifndef NEED_ATOMIC_MUTEX
+   theInfo.seqLock  = strlen(shmImpl)+sizeof(SeqMark) <= sizeof(theInfo.myName);
+#endif
    theInfo.keyPos   = keyPos = shmTypeSz + sizeof(MemItem);
    theInfo.maxKeys  = maxEnts;
    theInfo.maxKeySz = maxKLen = parms.maxKLen;
    theInfo.hashID   = shmHash;
    strncpy(theInfo.typeID, shmType, sizeof(theInfo.typeID)-1);
    strncpy(theInfo.myName, shmImpl, sizeof(theInfo.myName)-1);
+   if (theInfo.seqLock) strcat(theInfo.myName, SeqMark);
 
 // Create the new filename of the new file we will create
 //
@@ -534,6 +614,8 @@ bool XrdSsiShMam::Create(XrdSsiShMat::CRZParms &parms)
    memcpy(shmBase, &theInfo, sizeof(theInfo));
    xntP.intP  = SHMADDR(int, SHMINFO(index)); shmIndex = xntP.antP;
    shmSlots = parms.indexSz;
+   xseqP.intP = &SHMINFO(seqNum);
+   shmSeq     = (theInfo.seqLock ? xseqP.antP : 0);
 
 // A created table has, by definition, a single writer until it is exported.
 // So, we simply keep the r/w lock on the file until we export the file. Other
@@ -551,6 +633,7 @@ bool XrdSsiShMam::Create(XrdSsiShMat::CRZParms &parms)
 bool XrdSsiShMam::DelItem(void *data, const char *key, int hash)
 {
    XLockHelper lockInfo(this, RWLock);
+   SeqHelper   seqInfo;
    MemItem  *theItem, *prvItem;
    int hEnt, iOff;
 
@@ -582,6 +665,7 @@ bool XrdSsiShMam::DelItem(void *data, const char *key, int hash)
 // Delete the item from the index. The update of the count need not be atomic.
 // Also fetching of the next offset need not be atomic as we are the only one.
 //
+   seqInfo.Begin(shmSeq);
    iOff = theItem->next;
    SHMINFO(itemCount)--;
    if (prvItem)  Atomic_SET_STRICT(prvItem->next, iOff); // Atomic
@@ -616,6 +700,7 @@ void XrdSsiShMam::Detach()
    if (shmSize)    {munmap(shmBase, shmSize); shmSize = 0;}
    if (shmTemp)    {free(shmTemp); shmTemp = 0;}
    shmIndex = 0;
+   shmSeq   = 0;
 }
 
 /******************************************************************************/
@@ -640,7 +725,8 @@ bool XrdSsiShMam::Enumerate(void *&jar, char *&key, void *&val)
    EnumJar  *theJar  = (EnumJar *)jar;
    MemItem  *theItem;
    long long iTest;
-   int rc, newFD, fence, iOff, hash = 0;
+   int rc, newFD, fence, iOff, hash = 0, seqTry;
+   unsigned int seqNum = 0;
 
 // Make sure we can get an item
 //
@@ -661,11 +747,15 @@ bool XrdSsiShMam::Enumerate(void *&jar, char *&key, void *&val)
                  return false;
                 }
 
-// Lock the file if we have multiple writers or recycling items
+// Lock the file if we have multiple writers or recycling items. A versioned
+// map is read without the lock as long as we get a consistent view of it.
 //
-   if (lockRO && !lockInfo.FLock())
+   seqTry = (lockRO && shmSeq ? SeqTries : 0);
+   if (lockRO && !seqTry && !lockInfo.FLock())
       {rc = errno; Enumerate(jar); errno = rc; return false;}
 
+do{if (seqTry) seqNum = Atomic_GET_STRICT((*shmSeq));
+
 // Compute the next key we should start the search at but make sure it will not
 // generate an overflow. In the process we fetch the stopping point only once.
 //
@@ -677,6 +767,7 @@ bool XrdSsiShMam::Enumerate(void *&jar, char *&key, void *&val)
 // Now start the search. Note that pread() must do a memory fence.
 //
    theItem = (MemItem *)(theJar->buff);
+   hash    = 0;
    while(iOff < fence)
       {rc = pread(theJar->fd, theJar->buff, shmItemSz, iOff);
        if (rc < 0) return false;
@@ -685,6 +776,16 @@ bool XrdSsiShMam::Enumerate(void *&jar, char *&key, void *&val)
        iOff += shmItemSz;
       }
 
+// If we read without the file lock, make sure no update happened meanwhile.
+// Should we not succeed after a number of tries, lock the file and redo it.
+//
+   if (!seqTry) break;
+   SEQ_FENCE_ACQ;
+   if (!(seqNum & 1) && Atomic_GET((*shmSeq)) == seqNum) break;
+   if (!(--seqTry) && !lockInfo.FLock())
+      {rc = errno; Enumerate(jar); errno = rc; return false;}
+  } while(true);
+
 // Check if we found a key
 //
    if (!hash) {Enumerate(jar); errno = ENOENT; return false;}
@@ -859,9 +960,17 @@ bool XrdSsiShMam::GetItem(void *data, const char *key, int hash)
 //
    if (verNum != SHMINFO(verNum)) ReMap(ROLock);
 
-// Lock the file if we have multiple writers or recycling items
+// Lock the file if we have multiple writers or recycling items. If the map is
+// versioned, we first try to get a consistent view without locking the file.
 //
-   if (lockRO && !lockInfo.FLock()) return false;
+   if (lockRO)
+      {if (shmSeq && (hEnt = SeqGet(data, key, hash)) >= 0)
+          {if (hEnt) return true;
+           errno = ENOENT;
+           return false;
+          }
+       if (!lockInfo.FLock()) return false;
+      }
 
 // First try to find the item
 //
@@ -941,6 +1050,14 @@ bool XrdSsiShMam::Lock(bool xrw, bool nowait)
                else  lkCount--;
            }
 
+// An odd sequence number seen with the r/w lock was left by a writer that died
+// while updating the map. Make it even so readers need not lock the file.
+//
+   if (!rc && xrw && shmSeq)
+      {unsigned int seqNum = Atomic_GET((*shmSeq));
+       if (seqNum & 1) Atomic_SET_STRICT((*shmSeq), seqNum+1);
+      }
+
 // Unlock the mutex if we still have it locked and return result
 //
    if (!xrw) pthread_mutex_unlock(&lkMutex);
@@ -971,9 +1088,9 @@ int  XrdSsiShMam::Info(const char *vname, char *buff, int blen)
        return strlen(buff);
       }
    if (!strcmp(vname, "impl"))
-      {int n = strlen(SHMINFO(myName));
-       if (!buff || blen < n) {errno = EMSGSIZE; return -1;}
-       strcpy(buff, SHMINFO(myName));
+      {int n = strlen(SHMINFO(myName)) - (shmSeq ? sizeof(SeqMark)-1 : 0);
+       if (!buff || blen <= n) {errno = EMSGSIZE; return -1;}
+       strncpy(buff, SHMINFO(myName), n); buff[n] = 0;
        return n;
       }
    if (!strcmp(vname, "flockro"))   return lockRO;
@@ -987,6 +1104,7 @@ int  XrdSsiShMam::Info(const char *vname, char *buff, int blen)
    if (!strcmp(vname, "maxkeylen")) return SHMINFO(maxKeySz);
    if (!strcmp(vname, "multw"))     return multW;
    if (!strcmp(vname, "reuse"))     return reUse;
+   if (!strcmp(vname, "seqlock"))   return shmSeq != 0;
    if (!strcmp(vname, "type"))
       {int n = strlen(SHMINFO(typeID));
        if (!buff || blen < n) {errno = EMSGSIZE; return -1;}
@@ -1186,6 +1304,76 @@ void XrdSsiShMam::RetItem(MemItem *iP)
       }
 }
 
+/******************************************************************************/
+/* Private:                      S e q F i n d                                */
+/******************************************************************************/
+
+// This is Find() for readers that do not hold the file lock. Items may be
+// recycled under us, so offsets and keys are checked before being used and the
+// chain cannot be longer than the number of keys the map can hold. The result
+// is only meaningful if the sequence number did not change meanwhile.
+  
+int XrdSsiShMam::SeqFind(XrdSsiShMam::MemItem *&theItem,
+                         const char *key, int hash)
+{
+   int hEnt, iOff, iEnd, n = SHMINFO(maxKeys);
+
+// Compute index table entry and atomically fetch the entry
+//
+   hEnt = (unsigned int)hash % shmSlots;
+   if (hEnt == 0) hEnt = 1;
+   iOff = Atomic_GET_STRICT(shmIndex[hEnt]);
+   iEnd = SHMINFO(index) - shmItemSz;
+
+// Find the item
+//
+   while(iOff && n--)
+      {if (iOff < shmInfoSz || iOff > iEnd
+       ||  (iOff - shmInfoSz) % shmItemSz) return 0;
+       theItem = SHMADDR(MemItem, iOff);
+       if (hash == theItem->hash
+       &&  !strncmp(key, ITEM_KEY(theItem), maxKLen+1)) return hEnt;
+       iOff = Atomic_GET_STRICT(theItem->next);
+      }
+
+// We did not find the item
+//
+   return 0;
+}
+
+/******************************************************************************/
+/* Private:                       S e q G e t                                 */
+/******************************************************************************/
+
+// Returns 1 if the item was found, 0 if it was not, and -1 if no consistent
+// view of the map could be had without locking the file. Should an attempt
+// fail, the data buffer may have been written with an inconsistent value.
+  
+int XrdSsiShMam::SeqGet(void *data, const char *key, int &hash)
+{
+   MemItem *theItem;
+   unsigned int seqNum;
+   int hEnt;
+
+// If no hash was supplied, get one
+//
+   if (!hash) hash = HashVal(key);
+
+// Look up the item until no writer changed the map while we were doing so
+//
+   for (int i = 0; i < SeqTries; i++)
+       {if ((seqNum = Atomic_GET_STRICT((*shmSeq))) & 1) continue;
+        if ((hEnt = SeqFind(theItem, key, hash)) && data)
+           memcpy(data, ITEM_VAL(theItem), shmTypeSz);
+        SEQ_FENCE_ACQ;
+        if (Atomic_GET((*shmSeq)) == seqNum) return hEnt != 0;
+       }
+
+// Too many writers, the caller needs to lock the file
+//
+   return -1;
+}
+
 /******************************************************************************/
 /* Private:                   S e t L o c k i n g                             */
 /******************************************************************************/
@@ -1251,6 +1439,8 @@ void XrdSsiShMam::SwapMap(XrdSsiShMam &newMap)
    newMap.shmBase  =  0;
    shmIndex        = newMap.shmIndex;
    newMap.shmIndex =  0;
+   shmSeq          = newMap.shmSeq;
+   newMap.shmSeq   =  0;
    lockRO          = newMap.lockRO;
    lockRW          = newMap.lockRW;
    reUse           = newMap.reUse;
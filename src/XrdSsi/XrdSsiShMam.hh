@@ -85,6 +85,8 @@ bool     Lock(bool doRW=false, bool nowait=false);
 MemItem *NewItem();
 bool     ReMap(LockType iHave);
 void     RetItem(MemItem *iP);
+int      SeqFind(MemItem *&theItem, const char *key, int hash);
+int      SeqGet(void *data, const char *key, int &hash);
 void     SetLocking(bool isrw);
 void     SwapMap(XrdSsiShMam &newMap);
 void     Snooze(int sec);
@@ -126,6 +128,7 @@ char       *shmTemp;
 long long   shmSize;
 char       *shmBase;
 Atomic(int)*shmIndex;
+Atomic(unsigned int)*shmSeq; // Update sequence number, nil if not versioned
 int         shmSlots;
 int         shmItemSz;
 int         shmInfoSz;
@@ -73,6 +73,7 @@ namespace XrdSsi
 extern XrdSysError   Log;
 extern XrdScheduler *schedP;
 extern XrdSsiScale   sidScale;
+extern bool          reqPipe;
 }
   
 /******************************************************************************/
@@ -122,28 +123,11 @@ XrdSsiTaskReal *taskP;
 
 bool XrdSsiTaskReal::Ask4Resp()
 {
-   EPNAME("Ask4Resp");
-
    XrdCl::XRootDStatus epStatus;
-   XrdSsiRRInfo        rInfo;
-   XrdCl::Buffer       qBuff(sizeof(unsigned long long));
-
-// Disable read recovery
-//
-   sessP->epFile.SetProperty(pName, pValue);
-
-// Compose request to wait for the response
-//
-   rInfo.Id(tskID); rInfo.Cmd(XrdSsiRRInfo::Rwt);
-   memcpy(qBuff.GetBuffer(), rInfo.Data(), sizeof(long long));
-
-// Do some debugging
-//
-   DEBUG("Calling fcntl id=" <<tskID);
 
 // Issue the command to field the response
 //
-   epStatus = sessP->epFile.Fcntl(qBuff, (ResponseHandler *)this, tmOut);
+   epStatus = SendWait();
 
 // Dianose any errors. If any occurred we simply return an error response but
 // otherwise let this go as it really is not a logic error.
@@ -289,12 +273,12 @@ bool XrdSsiTaskReal::Kill() // Called with session mutex locked!
           case isSync:  break;
           case isReady: break;
           case isDone:  tStat = isDead;
-                        return !(mhPend || defer);
+                        return !(mhPend || wrtPend || defer);
                         break;
-          case isDead:  return !(mhPend || defer);
+          case isDead:  return !(mhPend || wrtPend || defer);
                         break;
           case isPend:  tStat = isDead;
-                        return !(mhPend || defer);
+                        return !(mhPend || wrtPend || defer);
                         break;
           default: char mBuff[32];
                    snprintf(mBuff, sizeof(mBuff), "%d", tStat);
@@ -330,7 +314,7 @@ bool XrdSsiTaskReal::Kill() // Called with session mutex locked!
 // the message handler will dispose of the task.
 //
    tStat = isDead;
-   return !(mhPend || defer);
+   return !(mhPend || wrtPend || defer);
 }
   
 /******************************************************************************/
@@ -489,9 +473,46 @@ bool XrdSsiTaskReal::SendRequest(const char *node)
 // Indicate a message handler call outstanding
 //
    mhPend = true;
+
+// In multiplexed mode we immediately queue the request for the response right
+// behind the request itself. The server handles both in order, so the response
+// costs no additional round trip. Should this fail, we ask after the write.
+//
+   if (reqPipe && SendWait().IsOK()) wrtPend = true;
    return true;
 }
 
+/******************************************************************************/
+/* Private:                     S e n d W a i t                               */
+/******************************************************************************/
+
+// Called with session mutex locked!
+
+XrdCl::XRootDStatus XrdSsiTaskReal::SendWait()
+{
+   EPNAME("SendWait");
+
+   XrdSsiRRInfo        rInfo;
+   XrdCl::Buffer       qBuff(sizeof(unsigned long long));
+
+// Disable read recovery
+//
+   sessP->epFile.SetProperty(pName, pValue);
+
+// Compose request to wait for the response
+//
+   rInfo.Id(tskID); rInfo.Cmd(XrdSsiRRInfo::Rwt);
+   memcpy(qBuff.GetBuffer(), rInfo.Data(), sizeof(long long));
+
+// Do some debugging
+//
+   DEBUG("Calling fcntl id=" <<tskID);
+
+// Issue the command to field the response
+//
+   return sessP->epFile.Fcntl(qBuff, (ResponseHandler *)this, tmOut);
+}
+
 /******************************************************************************/
 /*                               S e t B u f f                                */
 /******************************************************************************/
@@ -599,10 +620,18 @@ bool XrdSsiTaskReal::XeqEnd(bool getLock)
 //
    if (getLock) sessP->Lock();
 
-// Check if finished has been called while we were defered
+// Check if finished has been called while we were defered. The task cannot be
+// disposed of while a reply is still outstanding (e.g. the write reply after a
+// pipelined response wait or a data read).
 //
    if (tStat == isDead)
-      {DEBUG("Task Handler calling TaskFinished.");
+      {if (mhPend || wrtPend)
+          {DEBUG("Task Handler awaiting queued response.");
+           defer = false;
+           sessP->UnLock();
+           return true;
+          }
+       DEBUG("Task Handler calling TaskFinished.");
        sessP->UnLock();
        sessP->TaskFinished(this);
        return false;
@@ -615,6 +644,117 @@ bool XrdSsiTaskReal::XeqEnd(bool getLock)
    return true;
 }
 
+/******************************************************************************/
+/* Private:                      X e q P e n d                                */
+/******************************************************************************/
+
+// Called with session mutex locked and returns with it unlocked!
+
+bool XrdSsiTaskReal::XeqPend()
+{
+   EPNAME("TaskXeqPend");
+   const char *eTxt;
+   int eNum;
+
+// A dead task is disposed of once no more replies are outstanding
+//
+   if (tStat == isDead)
+      {if (mhPend || wrtPend)
+          {DEBUG("Task Handler awaiting queued response.");
+           defer = false;
+           sessP->UnLock();
+           return true;
+          }
+       if (sessP != &voidSession)
+          {DEBUG("Task Handler calling TaskFinished.");
+           sessP->UnLock();
+           sessP->TaskFinished(this);
+          } else {
+           DEBUG("Deleting task.");
+           sessP->UnLock();
+           delete this;
+          }
+       return false;
+      }
+
+// If a queued write failed, reflect its error once both replies are in
+//
+   if (wrtErr && !mhPend)
+      {wrtErr = false;
+       tStat  = isDone;
+       defer  = false;
+       eTxt   = errInfo.Get(eNum).c_str();
+       sessP->UnLock();
+       SetErrResponse(eTxt, eNum);
+       return false;
+      }
+
+// Otherwise, simply wait for the next reply
+//
+   return XeqEnd(false);
+}
+
+/******************************************************************************/
+/* Private:                      X e q P i p e                                */
+/******************************************************************************/
+
+// Called with session mutex locked! Returns true if the event is the response
+// to be handled by XeqEvent() and false if XeqPend() is to dispose of it.
+
+bool XrdSsiTaskReal::XeqPipe(XrdCl::XRootDStatus *status,
+                             XrdCl::AnyObject    *response)
+{
+   EPNAME("TaskXeqPipe");
+   bool aOK = status->IsOK();
+
+// This is the last of the two replies after one of them failed. Reflect the
+// failure regardless of what this one says.
+//
+   if (wrtErr)
+      {mhPend = false;
+       if (wPost) {wPost->Post(); wPost = 0; wrtErr = false;}
+       return false;
+      }
+
+// The write reply carries no response object. Once the write is done the task
+// waits for the response which may have already been handled.
+//
+   if (aOK && !response)
+      {DEBUG("Queued write complete id=" <<tskID);
+       wrtPend = false;
+       if (wPost) {wPost->Post(); wPost = 0;}
+          else if (tStat == isWrite)
+                  {ReleaseRequestBuffer();
+                   tStat = isSync;
+                  }
+       return false;
+      }
+
+// Before the response arrived, either reply may have failed and we can't tell
+// which. Remember the error and reflect it when the other one arrives. Later
+// on, errors can only be for the response or a data read.
+//
+   if (!aOK && tStat == isWrite)
+      {DEBUG("Queued write or wait failed id=" <<tskID);
+       XrdSsiUtils::SetErr(*status, errInfo);
+       wrtPend = false;
+       wrtErr  = true;
+       return false;
+      }
+
+// The response (or a data read reply) arrived ahead of the write reply. The
+// server has the whole request so its buffer is no longer needed. If a Kill()
+// is waiting on the write, let it proceed and ignore the response.
+//
+   mhPend = false;
+   if (tStat == isWrite)
+      {if (wPost) {wPost->Post(); wPost = 0; return false;}
+       ReleaseRequestBuffer();
+       tStat = isSync;
+      }
+   return true;
+}
+
 /******************************************************************************/
 /*                              X e q E v e n t                               */
 /******************************************************************************/
@@ -638,7 +778,12 @@ bool XrdSsiTaskReal::XeqEvent(XrdCl::XRootDStatus *status,
 //
    sessP->Lock();
    defer  = true;
-   mhPend = false;
+
+// In multiplexed mode the replies to the write and to the response wait are
+// both outstanding and may arrive in either order. Sort out which one this is.
+//
+   if (!(wrtPend || wrtErr)) mhPend = false;
+      else if (!XeqPipe(status, response)) return XeqPend();
 
 // Do some debugging
 //
@@ -690,6 +835,12 @@ bool XrdSsiTaskReal::XeqEvent(XrdCl::XRootDStatus *status,
                break;
 
           case isDead:
+               if (mhPend || wrtPend)
+                  {DEBUG("Task Handler awaiting queued response.");
+                   defer = false;
+                   sessP->UnLock();
+                   return true;
+                  }
                if (sessP != &voidSession)
                   {DEBUG("Task Handler calling TaskFinished.");
                    sessP->UnLock();
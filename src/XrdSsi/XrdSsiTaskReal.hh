@@ -62,7 +62,7 @@ int    ID() {return tskID;}
 inline
 void   Init(XrdSsiRequest *rP, unsigned short tmo=0)
            {rqstP = rP, tStat = isPend; tmOut = tmo; wPost = 0;
-            mhPend = false; defer = false;
+            mhPend = false; defer = false; wrtPend = false; wrtErr = false;
             attList.next = attList.prev = this;
             if (mdResp) {delete mdResp; mdResp = 0;}
            }
@@ -91,7 +91,8 @@ bool   XeqEvent(XrdCl::XRootDStatus *status, XrdCl::AnyObject **respP);
                      : XrdSsiEvent("TaskReal"),
                        XrdSsiStream(XrdSsiStream::isPassive),
                        sessP(sP), mdResp(0), wPost(0), tskID(tid),
-                       mhPend(false), defer(false)
+                       mhPend(false), defer(false), wrtPend(false),
+                       wrtErr(false)
                     {}
 
       ~XrdSsiTaskReal() {if (mdResp) delete mdResp;}
@@ -107,6 +108,10 @@ bool              Ask4Resp();
 respType          GetResp(XrdCl::AnyObject **respP, char *&dbuf, int &dlen);
 bool              RespErr(XrdCl::XRootDStatus *status);
 bool              XeqEnd(bool getLock);
+bool              XeqPend();
+bool              XeqPipe(XrdCl::XRootDStatus *status,
+                          XrdCl::AnyObject    *response);
+XrdCl::XRootDStatus SendWait();
 
 XrdSsiErrInfo     errInfo;
 XrdSsiSessReal   *sessP;
@@ -120,5 +125,7 @@ unsigned short    tmOut;
 short             tskID;
 bool              mhPend;
 bool              defer;
+bool              wrtPend;  // Write reply outstanding, response wait queued
+bool              wrtErr;   // Write or wait failed, errInfo holds the reason
 };
 #endif
@@ -28,7 +28,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
-#include "XrdOuc/XrdOucHash.hh"
+#include "XrdOuc/XrdOucCHash.hh"
 #include "XrdSut/XrdSutCacheEntry.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
@@ -48,7 +48,7 @@ typedef struct {
 
 class XrdSutCache {
 public:
-   XrdSutCache(int psize = 89, int size = 144, int load = 80) : table(psize, size, load) {}
+   XrdSutCache(int psize = 89, int size = 144, int load = 80) : table(size) {}
    virtual ~XrdSutCache() {}
 
    XrdSutCacheEntry *Get(const char *tag) {
@@ -59,9 +59,6 @@ public:
 
       XrdSutCacheEntry *cent = 0;
 
-      // Exclusive access to the table
-      XrdSysMutexHelper raii(mtx);
-
       // Look for an entry
       if (!(cent = table.Find(tag))) {
          // none found
@@ -90,12 +87,9 @@ public:
       rdlock = false;
       XrdSutCacheEntry *cent = 0;
 
-      // Exclusive access to the table
-      XrdSysMutexHelper raii(mtx);
-
       // Look for an entry
       if (!(cent = table.Find(tag))) {
-         // If none, create a new one and write-lock for validation
+         // If none, create a new one and write-lock it for validation
          cent = new XrdSutCacheEntry(tag);
          int status = 0;
          cent->rwmtx.WriteLock( status );
@@ -104,9 +98,12 @@ public:
             delete cent;
             return (XrdSutCacheEntry *)0;
          }
-         // Register it in the table
-         table.Add(tag, cent);
-         return cent;
+         // Register it in the table, unless another thread added one meanwhile
+         XrdSutCacheEntry *other = table.Add(tag, cent);
+         if (!other) return cent;
+         cent->rwmtx.UnLock();
+         delete cent;
+         cent = other;
       }
 
       // We found an existing entry:
@@ -147,8 +144,10 @@ public:
    inline void Reset() { return table.Purge(); }
 
 private:
-   XrdSysRecMutex         mtx;  // Protect access to table
-   XrdOucHash<XrdSutCacheEntry> table; // table with content
+   // Entries do not expire in the table and are only removed by Reset(), so
+   // they can be locked after the lookup (waiting on one being validated does
+   // not block the others)
+   XrdOucCHash<XrdSutCacheEntry> table; // table with content
 };
 
 #endif
@@ -69,6 +69,8 @@ add_library(
   XrdOuc/XrdOucCacheReal.cc     XrdOuc/XrdOucCacheReal.hh
                                 XrdOuc/XrdOucCacheSlot.hh
   XrdOuc/XrdOucCallBack.cc      XrdOuc/XrdOucCallBack.hh
+                                XrdOuc/XrdOucCHash.hh
+                                XrdOuc/XrdOucCHash.icc
   XrdOuc/XrdOucCRC.cc           XrdOuc/XrdOucCRC.hh
   XrdOuc/XrdOucEnv.cc           XrdOuc/XrdOucEnv.hh
                                 XrdOuc/XrdOucHash.hh
@@ -344,7 +344,7 @@ XrdSecProtect             *Protect;
 
 ClientRequest              sigReq2Ver;   // Request to verify
 SecurityRequest            sigReq;       // Signature request
-char                       sigBuff[64];  // Signature payload SHA256 + blowfish
+char                       sigBuff[128]; // Signature payload (hash + key)
 bool                       sigNeed;      // Signature target  present
 bool                       sigHere;      // Signature request present
 bool                       sigRead;      // Signature being read
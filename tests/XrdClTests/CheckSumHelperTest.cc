@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Feed the CheckSumHelper used by the copy jobs with the chunks of a buffer
+// of random data in various orders and check that
+//
+//   - adler32 combined out of order matches zlib over the whole buffer
+//   - crc32 and md5 held back out of order match their calculators over
+//     the whole buffer
+//   - the data held back for md5 is bounded: the helper gives up and says
+//     so instead of holding everything, while adler32 in the same order
+//     holds nothing and still gets it right
+//
+// Usage: xrdcl-cksum-test
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClCheckSumHelper.hh"
+#include "XrdCl/XrdClUtils.hh"
+#include "XrdCks/XrdCksCalccrc32.hh"
+#include "XrdCks/XrdCksCalcmd5.hh"
+#include "XrdCks/XrdCksData.hh"
+
+#include <zlib.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace XrdCl;
+
+namespace
+{
+  const uint32_t kChunk  = 65536;
+  const uint32_t kChunks = 128;
+
+  int errors = 0;
+
+  void Fail( const std::string &test, const std::string &what )
+  {
+    fprintf( stderr, "%s: %s\n", test.c_str(), what.c_str() );
+    ++errors;
+  }
+
+  //----------------------------------------------------------------------------
+  // The checksum of the whole buffer as the copy job prints it
+  //----------------------------------------------------------------------------
+  std::string Reference( const std::string &type, const char *data,
+                         uint32_t size )
+  {
+    if( type == "adler32" )
+    {
+      uLong value = adler32( adler32( 0L, Z_NULL, 0 ),
+                             (const Bytef*)data, size );
+      char buff[32];
+      snprintf( buff, sizeof( buff ), "adler32:%08lx", value );
+      return buff;
+    }
+
+    XrdCksCalc *calc = ( type == "md5" ) ? (XrdCksCalc*)new XrdCksCalcmd5() :
+                                           (XrdCksCalc*)new XrdCksCalccrc32();
+    int len;
+    calc->Update( data, size );
+    XrdCksData ckSum;
+    ckSum.Set( type.c_str() );
+    ckSum.Set( (void*)calc->Final(), calc->Type( len ) ? len : 0 );
+    char buff[256];
+    ckSum.Get( buff, sizeof( buff ) );
+    delete calc;
+    return type + ":" + Utils::NormalizeChecksum( type, buff );
+  }
+
+  //----------------------------------------------------------------------------
+  // Run the chunks through a helper in the given order
+  //----------------------------------------------------------------------------
+  XRootDStatus Run( const std::string &type, const char *data,
+                    const std::vector<uint32_t> &order, uint64_t maxHeld,
+                    std::string &result, bool &overflowed )
+  {
+    CheckSumHelper helper( "test", type, maxHeld );
+    XRootDStatus st = helper.Initialize();
+    if( !st.IsOK() ) return st;
+
+    for( size_t i = 0; i < order.size(); ++i )
+    {
+      char *copy = new char[kChunk];
+      memcpy( copy, data + uint64_t( order[i] ) * kChunk, kChunk );
+      helper.Update( uint64_t( order[i] ) * kChunk, copy, kChunk );
+    }
+
+    std::string cksType = type;
+    overflowed = helper.Overflowed();
+    return helper.GetCheckSum( result, cksType );
+  }
+
+  void Check( const std::string &test, const std::string &type,
+              const char *data, const std::vector<uint32_t> &order,
+              uint64_t maxHeld = 67108864 )
+  {
+    std::string  result;
+    bool         overflowed;
+    XRootDStatus st = Run( type, data, order, maxHeld, result, overflowed );
+    if( overflowed )
+      Fail( test, "gave up" );
+    else if( !st.IsOK() )
+      Fail( test, st.ToStr() );
+    else if( result != Reference( type, data, kChunk * kChunks ) )
+      Fail( test, "got " + result + ", expected " +
+                  Reference( type, data, kChunk * kChunks ) );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  std::vector<char> buffer( kChunk * kChunks );
+  srand( 1234 );
+  for( size_t i = 0; i < buffer.size(); ++i )
+    buffer[i] = rand();
+  const char *data = &buffer[0];
+
+  std::vector<uint32_t> inOrder, shuffled, swapped, reversed;
+  for( uint32_t i = 0; i < kChunks; ++i ) inOrder.push_back( i );
+  shuffled = inOrder;
+  std::random_shuffle( shuffled.begin(), shuffled.end() );
+  swapped = inOrder;
+  for( uint32_t i = 0; i + 1 < kChunks; i += 2 )
+    std::swap( swapped[i], swapped[i+1] );
+  reversed.assign( inOrder.rbegin(), inOrder.rend() );
+
+  //----------------------------------------------------------------------------
+  // The checksums come out right whatever the order
+  //----------------------------------------------------------------------------
+  Check( "adler32 in order", "adler32", data, inOrder );
+  Check( "adler32 shuffled", "adler32", data, shuffled );
+  Check( "crc32 in order",   "crc32",   data, inOrder );
+  Check( "crc32 shuffled",   "crc32",   data, shuffled );
+  Check( "md5 in order",     "md5",     data, inOrder );
+  Check( "md5 swapped",      "md5",     data, swapped );
+  Check( "md5 shuffled",     "md5",     data, shuffled );
+
+  //----------------------------------------------------------------------------
+  // Reversed, md5 would have to hold back everything but the last chunk,
+  // adler32 holds back no data at all
+  //----------------------------------------------------------------------------
+  Check( "adler32 reversed, bounded", "adler32", data, reversed, 1048576 );
+  Check( "md5 swapped, bounded",      "md5",     data, swapped,  1048576 );
+
+  std::string  result;
+  bool         overflowed;
+  XRootDStatus st = Run( "md5", data, reversed, 1048576, result, overflowed );
+  if( !overflowed )
+    Fail( "md5 reversed, bounded", "did not give up" );
+  if( st.IsOK() )
+    Fail( "md5 reversed, bounded", "got a checksum: " + result );
+
+  printf( "checksum helper: %d errors\n", errors );
+
+  //----------------------------------------------------------------------------
+  // Don't tear down the client threads at exit
+  //----------------------------------------------------------------------------
+  fflush( stdout );
+  _exit( errors ? 1 : 0 );
+}
@@ -38,6 +38,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <sstream>
 
 using namespace XrdClTests;
 
@@ -54,6 +56,7 @@ class FileCopyTest: public CppUnit::TestCase
       CPPUNIT_TEST( MultiStreamUploadTest );
       CPPUNIT_TEST( ThirdPartyCopyTest );
       CPPUNIT_TEST( NormalCopyTest );
+      CPPUNIT_TEST( PipelineCopyTest );
     CPPUNIT_TEST_SUITE_END();
     void DownloadTestFunc();
     void UploadTestFunc();
@@ -64,6 +67,7 @@ class FileCopyTest: public CppUnit::TestCase
     void CopyTestFunc( bool thirdParty = true );
     void ThirdPartyCopyTest();
     void NormalCopyTest();
+    void PipelineCopyTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( FileCopyTest );
@@ -455,3 +459,102 @@ void FileCopyTest::NormalCopyTest()
 {
   CopyTestFunc( false );
 }
+
+//------------------------------------------------------------------------------
+// Pipelined copy test
+//------------------------------------------------------------------------------
+void FileCopyTest::PipelineCopyTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string remoteFile;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "RemoteFile",    remoteFile ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath",      dataPath ) );
+
+  std::string sourceURL = address + "/" + remoteFile;
+  FileSystem  fs( address );
+  StatInfo   *stat = 0;
+  CPPUNIT_ASSERT_XRDST( fs.Stat( remoteFile, stat ) );
+  CPPUNIT_ASSERT( stat );
+  uint64_t size = stat->GetSize();
+  delete stat;
+
+  //----------------------------------------------------------------------------
+  // Download the file a couple of times plus a file that does not exist,
+  // more jobs than the pipeline keeps in flight
+  //----------------------------------------------------------------------------
+  const int                  nFiles = 8;
+  CopyProcess                download;
+  PropertyList               properties, results[nFiles+1], config;
+  std::vector<std::string>   local;
+
+  for( int i = 0; i < nFiles; ++i )
+  {
+    std::ostringstream o; o << "/tmp/pipelineFile" << i;
+    local.push_back( o.str() );
+    properties.Clear();
+    properties.Set( "source",    sourceURL );
+    properties.Set( "target",    "file://localhost" + o.str() );
+    properties.Set( "force",     true );
+    properties.Set( "chunkSize", 1024*1024 );
+    CPPUNIT_ASSERT_XRDST( download.AddJob( properties, &results[i] ) );
+  }
+  properties.Clear();
+  properties.Set( "source", address + "/" + dataPath + "/doesNotExist" );
+  properties.Set( "target", "file://localhost/tmp/pipelineFileMissing" );
+  CPPUNIT_ASSERT_XRDST( download.AddJob( properties, &results[nFiles] ) );
+
+  config.Set( "jobType",  "configuration" );
+  config.Set( "pipeline", 4 );
+  CPPUNIT_ASSERT_XRDST( download.AddJob( config, 0 ) );
+  CPPUNIT_ASSERT_XRDST( download.Prepare() );
+  CPPUNIT_ASSERT( !download.Run( 0 ).IsOK() );
+
+  for( int i = 0; i < nFiles; ++i )
+  {
+    CPPUNIT_ASSERT_XRDST( results[i].Get<XRootDStatus>( "status" ) );
+    CPPUNIT_ASSERT( results[i].Get<uint64_t>( "size" ) == size );
+    struct stat localStat;
+    CPPUNIT_ASSERT( ::stat( local[i].c_str(), &localStat ) == 0 );
+    CPPUNIT_ASSERT( (uint64_t)localStat.st_size == size );
+  }
+  CPPUNIT_ASSERT( !results[nFiles].Get<XRootDStatus>( "status" ).IsOK() );
+  CPPUNIT_ASSERT( ::access( "/tmp/pipelineFileMissing", F_OK ) != 0 );
+
+  //----------------------------------------------------------------------------
+  // Upload them back
+  //----------------------------------------------------------------------------
+  CopyProcess upload;
+  for( int i = 0; i < nFiles; ++i )
+  {
+    std::ostringstream o; o << dataPath << "/pipelineFile" << i;
+    properties.Clear();
+    properties.Set( "source", "file://localhost" + local[i] );
+    properties.Set( "target", address + "/" + o.str() );
+    properties.Set( "force",  true );
+    results[i].Clear();
+    CPPUNIT_ASSERT_XRDST( upload.AddJob( properties, &results[i] ) );
+  }
+  CPPUNIT_ASSERT_XRDST( upload.AddJob( config, 0 ) );
+  CPPUNIT_ASSERT_XRDST( upload.Prepare() );
+  CPPUNIT_ASSERT_XRDST( upload.Run( 0 ) );
+
+  for( int i = 0; i < nFiles; ++i )
+  {
+    std::ostringstream o; o << dataPath << "/pipelineFile" << i;
+    CPPUNIT_ASSERT_XRDST( fs.Stat( o.str(), stat ) );
+    CPPUNIT_ASSERT( stat && stat->GetSize() == size );
+    delete stat;
+    CPPUNIT_ASSERT_XRDST( fs.Rm( o.str() ) );
+    CPPUNIT_ASSERT( ::unlink( local[i].c_str() ) == 0 );
+  }
+}
@@ -24,6 +24,7 @@
 #include "CppUnitXrdHelpers.hh"
 
 #include <pthread.h>
+#include <set>
 
 #include "TestEnv.hh"
 #include "IdentityPlugIn.hh"
@@ -49,6 +50,7 @@ class FileSystemTest: public CppUnit::TestCase
       CPPUNIT_TEST( ProtocolTest );
       CPPUNIT_TEST( DeepLocateTest );
       CPPUNIT_TEST( DirListTest );
+      CPPUNIT_TEST( DirListStreamTest );
       CPPUNIT_TEST( SendInfoTest );
       CPPUNIT_TEST( PrepareTest );
       CPPUNIT_TEST( PlugInTest );
@@ -65,6 +67,7 @@ class FileSystemTest: public CppUnit::TestCase
     void ProtocolTest();
     void DeepLocateTest();
     void DirListTest();
+    void DirListStreamTest();
     void SendInfoTest();
     void PrepareTest();
     void PlugInTest();
@@ -362,6 +365,42 @@ void FileSystemTest::ProtocolTest()
   delete response;
 }
 
+//------------------------------------------------------------------------------
+// Collect the answers of a streaming deep locate
+//------------------------------------------------------------------------------
+class DeepLocateCollector: public XrdCl::DeepLocateCallback
+{
+  public:
+    DeepLocateCollector(): nodes( 0 ), servers( 0 ), status( 0 ),
+      locations( 0 ), sem( 0 ) {}
+    ~DeepLocateCollector() { delete status; delete locations; }
+
+    virtual bool HandleLocations( const std::string         &,
+                                  const XrdCl::XRootDStatus &,
+                                  XrdCl::LocationInfo       *found,
+                                  uint32_t                   )
+    {
+      ++nodes;
+      if( found ) servers += found->GetSize();
+      delete found;
+      return true;
+    }
+
+    virtual void HandleDone( XrdCl::XRootDStatus *st,
+                             XrdCl::LocationInfo *found )
+    {
+      status    = st;
+      locations = found;
+      sem.Post();
+    }
+
+    uint32_t               nodes;
+    uint32_t               servers;
+    XrdCl::XRootDStatus   *status;
+    XrdCl::LocationInfo   *locations;
+    XrdSysSemaphore        sem;
+};
+
 //------------------------------------------------------------------------------
 // Deep locate test
 //------------------------------------------------------------------------------
@@ -395,6 +434,27 @@ void FileSystemTest::DeepLocateTest()
   LocationInfo::Iterator it = locations->Begin();
   for( ; it != locations->End(); ++it )
     CPPUNIT_ASSERT( it->IsServer() );
+
+  //----------------------------------------------------------------------------
+  // The streaming version needs to find the same servers, and to stop at
+  // the first answer if one location is enough
+  //----------------------------------------------------------------------------
+  DeepLocateCollector all;
+  CPPUNIT_ASSERT_XRDST( fs.DeepLocateStream( remoteFile, OpenFlags::Refresh,
+                                             0, 0, &all ) );
+  all.sem.Wait();
+  CPPUNIT_ASSERT_XRDST( *all.status );
+  CPPUNIT_ASSERT( all.locations->GetSize() == locations->GetSize() );
+  CPPUNIT_ASSERT( all.servers == locations->GetSize() );
+  CPPUNIT_ASSERT( all.nodes > 1 );
+
+  DeepLocateCollector one;
+  CPPUNIT_ASSERT_XRDST( fs.DeepLocateStream( remoteFile, OpenFlags::Refresh,
+                                             1, 0, &one ) );
+  one.sem.Wait();
+  CPPUNIT_ASSERT_XRDST( *one.status );
+  CPPUNIT_ASSERT( one.locations->GetSize() >= 1 );
+  CPPUNIT_ASSERT( one.nodes <= all.nodes );
   delete locations;
 }
 
@@ -435,6 +495,111 @@ void FileSystemTest::DirListTest()
 }
 
 
+//------------------------------------------------------------------------------
+// Collect the entries of a streaming directory listing
+//------------------------------------------------------------------------------
+class DirListCollector: public XrdCl::DirListCallback
+{
+  public:
+    DirListCollector(): dirs( 0 ), withStat( 0 ), status( 0 ), sem( 0 ) {}
+    ~DirListCollector() { delete status; }
+
+    virtual bool HandleEntries( XrdCl::DirectoryList *entries )
+    {
+      using namespace XrdCl;
+      ++dirs;
+      DirectoryList::Iterator it;
+      for( it = entries->Begin(); it != entries->End(); ++it )
+      {
+        StatInfo *info = (*it)->GetStatInfo();
+        if( info ) ++withStat;
+        if( !info || !info->TestFlags( StatInfo::IsDir ) )
+          files.insert( entries->GetParentName() + (*it)->GetName() );
+      }
+      delete entries;
+      return true;
+    }
+
+    virtual void HandleDone( XrdCl::XRootDStatus *st )
+    {
+      status = st;
+      sem.Post();
+    }
+
+    uint32_t               dirs;
+    uint32_t               withStat;
+    std::set<std::string>  files;
+    XrdCl::XRootDStatus   *status;
+    XrdSysSemaphore        sem;
+};
+
+//------------------------------------------------------------------------------
+// Streaming directory list
+//------------------------------------------------------------------------------
+void FileSystemTest::DirListStreamTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Get the environment variables
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  FileSystem fs( url );
+
+  //----------------------------------------------------------------------------
+  // One big directory on all the servers
+  //----------------------------------------------------------------------------
+  DirListCollector big;
+  CPPUNIT_ASSERT_XRDST( fs.DirListStream( dataPath + "/bigdir",
+                                          DirListFlags::Stat |
+                                          DirListFlags::Locate, &big ) );
+  big.sem.Wait();
+  CPPUNIT_ASSERT_XRDST( *big.status );
+  CPPUNIT_ASSERT( big.files.size() == 40000 );
+  CPPUNIT_ASSERT( big.withStat == 40000 );
+
+  //----------------------------------------------------------------------------
+  // The recursive listing needs to match the one built in memory
+  //----------------------------------------------------------------------------
+  DirectoryList *list = 0;
+  CPPUNIT_ASSERT_XRDST( fs.DirList( dataPath, DirListFlags::Recursive, list ) );
+  CPPUNIT_ASSERT( list );
+
+  DirListCollector rec;
+  CPPUNIT_ASSERT_XRDST( fs.DirListStream( dataPath, DirListFlags::Recursive,
+                                          &rec ) );
+  rec.sem.Wait();
+  CPPUNIT_ASSERT_XRDST( *rec.status );
+  CPPUNIT_ASSERT( rec.dirs > 1 );
+  CPPUNIT_ASSERT( rec.files.size() == list->GetSize() );
+
+  DirectoryList::Iterator it;
+  for( it = list->Begin(); it != list->End(); ++it )
+    CPPUNIT_ASSERT( rec.files.count( list->GetParentName() +
+                                     (*it)->GetName() ) );
+  delete list;
+
+  //----------------------------------------------------------------------------
+  // Nothing to list
+  //----------------------------------------------------------------------------
+  DirListCollector none;
+  CPPUNIT_ASSERT_XRDST( fs.DirListStream( dataPath + "/nonexistent",
+                                          DirListFlags::Recursive, &none ) );
+  none.sem.Wait();
+  CPPUNIT_ASSERT( !none.status->IsOK() );
+  CPPUNIT_ASSERT( none.dirs == 0 );
+}
+
 //------------------------------------------------------------------------------
 // Set
 //------------------------------------------------------------------------------
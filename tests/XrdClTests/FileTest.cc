@@ -45,6 +45,7 @@ class FileTest: public CppUnit::TestCase
     CPPUNIT_TEST_SUITE( FileTest );
       CPPUNIT_TEST( RedirectReturnTest );
       CPPUNIT_TEST( ReadTest );
+      CPPUNIT_TEST( ReadAheadTest );
       CPPUNIT_TEST( WriteTest );
       CPPUNIT_TEST( VectorReadTest );
       CPPUNIT_TEST( VirtualRedirectorTest );
@@ -52,6 +53,7 @@ class FileTest: public CppUnit::TestCase
     CPPUNIT_TEST_SUITE_END();
     void RedirectReturnTest();
     void ReadTest();
+    void ReadAheadTest();
     void WriteTest();
     void VectorReadTest();
     void VirtualRedirectorTest();
@@ -237,9 +239,109 @@ void FileTest::ReadTest()
   }
 
   CPPUNIT_ASSERT_XRDST( zip.Close() );
+
+  //----------------------------------------------------------------------------
+  // Open again (the central directory comes from the cache) and read
+  // everything in one go
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( zip.Open( archiveUrl ) );
+
+  char         vbuffer[3][100];
+  ZipChunkList chunks;
+  for( int i = 0; i < 3; ++i )
+    chunks.push_back( ZipChunk( testset[i].file, testset[i].offset,
+                                testset[i].size, vbuffer[i] ) );
+
+  VectorReadInfo *vrInfo = 0;
+  CPPUNIT_ASSERT_XRDST( zip.VectorRead( chunks, false, vrInfo ) );
+  CPPUNIT_ASSERT( vrInfo->GetChunks().size() == 3 );
+  for( int i = 0; i < 3; ++i )
+  {
+    ChunkInfo &ch = vrInfo->GetChunks()[i];
+    CPPUNIT_ASSERT( ch.offset == testset[i].offset );
+    std::string result( (char*)ch.buffer, ch.length );
+    CPPUNIT_ASSERT( testset[i].expected == result );
+  }
+  delete vrInfo;
+
+  CPPUNIT_ASSERT_XRDST( zip.Close() );
 }
 
 
+//------------------------------------------------------------------------------
+// Read-ahead test
+//------------------------------------------------------------------------------
+void FileTest::ReadAheadTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  const uint32_t MB = 1024*1024;
+  char *buffer = new char[40*MB];
+  uint32_t bytesRead = 0;
+  File f;
+
+  //----------------------------------------------------------------------------
+  // Open the file with the read-ahead enabled
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( f.SetProperty( "ReadAhead", "true" ) );
+  CPPUNIT_ASSERT_XRDST( f.Open( fileUrl, OpenFlags::Read ) );
+
+  //----------------------------------------------------------------------------
+  // The same data as in the read test, read sequentially in small pieces
+  //----------------------------------------------------------------------------
+  for( uint32_t i = 0; i < 160; ++i )
+  {
+    CPPUNIT_ASSERT_XRDST( f.Read( 10*MB + i*256*1024, 256*1024,
+                                  buffer + i*256*1024, bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == 256*1024 );
+  }
+  uint32_t crc = Utils::ComputeCRC32( buffer, 40*MB );
+  CPPUNIT_ASSERT( crc == 3303853367UL );
+
+  //----------------------------------------------------------------------------
+  // A random read in between breaks the pattern and must not be affected
+  //----------------------------------------------------------------------------
+  char small[16];
+  CPPUNIT_ASSERT_XRDST( f.Read( 10*MB, 16, small, bytesRead ) );
+  CPPUNIT_ASSERT( bytesRead == 16 );
+  CPPUNIT_ASSERT( memcmp( small, buffer, 16 ) == 0 );
+
+  //----------------------------------------------------------------------------
+  // Read across the end of the file
+  //----------------------------------------------------------------------------
+  uint32_t total = 0;
+  for( uint32_t i = 0; i < 10; ++i )
+  {
+    CPPUNIT_ASSERT_XRDST( f.Read( 1008576000 + i*4*MB, 4*MB,
+                                  buffer + i*4*MB, bytesRead ) );
+    total += bytesRead;
+  }
+  CPPUNIT_ASSERT( total == 40000000 );
+  crc = Utils::ComputeCRC32( buffer, 40000000 );
+  CPPUNIT_ASSERT( crc == 898701504UL );
+
+  delete [] buffer;
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+}
+
 //------------------------------------------------------------------------------
 // Read test
 //------------------------------------------------------------------------------
@@ -391,10 +493,47 @@ void FileTest::VectorReadTest()
   crc = Utils::ComputeCRC32( buffer2, 40*256000 );
   CPPUNIT_ASSERT( crc == 3492603530UL );
 
+  //----------------------------------------------------------------------------
+  // An unsorted list of overlapping chunks too long for a single request,
+  // compare with what plain reads return
+  //----------------------------------------------------------------------------
+  ChunkList chunkList3;
+  uint32_t  size3 = 0;
+  for( int i = 0; i < 3000; ++i )
+  {
+    uint64_t offset = ( ( i * 7919 ) % 3000 ) * 3000;
+    uint32_t length = 1000 + ( i % 7 ) * 1000;
+    chunkList3.push_back( ChunkInfo( offset, length ) );
+    size3 += length;
+  }
+  chunkList3.push_back( ChunkInfo( 20*MB, 3*MB ) );
+  size3 += 3*MB;
+
+  char *buffer3 = new char[size3];
+  char *buffer4 = new char[size3];
+  info = 0;
+  CPPUNIT_ASSERT_XRDST( f.VectorRead( chunkList3, buffer3, info ) );
+  CPPUNIT_ASSERT( info->GetSize() == size3 );
+  CPPUNIT_ASSERT( info->GetChunks().size() == chunkList3.size() );
+  delete info;
+
+  char *cursor = buffer4;
+  for( size_t i = 0; i < chunkList3.size(); ++i )
+  {
+    uint32_t bytesRead = 0;
+    CPPUNIT_ASSERT_XRDST( f.Read( chunkList3[i].offset, chunkList3[i].length,
+                                  cursor, bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == chunkList3[i].length );
+    cursor += bytesRead;
+  }
+  CPPUNIT_ASSERT( memcmp( buffer3, buffer4, size3 ) == 0 );
+
   CPPUNIT_ASSERT_XRDST( f.Close() );
 
   delete [] buffer1;
   delete [] buffer2;
+  delete [] buffer3;
+  delete [] buffer4;
 }
 
 void FileTest::VirtualRedirectorTest()
@@ -0,0 +1,326 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Read a file synchronously, with and without the read-ahead, through a
+// loopback proxy that delays the traffic to emulate a WAN link.
+//
+// Usage: xrdcl-readahead-bench [-d <rtt ms>] [-b <read KB>] [-s <stride KB>]
+//                              [-n <MB>] root://host:port//path
+//
+// The proxy listens on an ephemeral loopback port and forwards to the host
+// of the URL, holding every piece of data for half the round trip time in
+// each direction. With -s the reads skip <stride> KB after each block.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClURL.hh"
+
+#include <errno.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <deque>
+#include <iostream>
+#include <string>
+
+namespace
+{
+  double           delay  = 0.025;
+  struct addrinfo *target = 0;
+
+  //----------------------------------------------------------------------------
+  // FNV-1a, only to compare the data of the two runs
+  //----------------------------------------------------------------------------
+  uint32_t Hash( const char *buffer, uint32_t len, uint32_t hash )
+  {
+    for( uint32_t i = 0; i < len; ++i )
+      hash = ( hash ^ (unsigned char)buffer[i] ) * 16777619;
+    return hash;
+  }
+
+  double Now()
+  {
+    timeval tv;
+    gettimeofday( &tv, 0 );
+    return tv.tv_sec + tv.tv_usec / 1e6;
+  }
+
+  //----------------------------------------------------------------------------
+  // One direction of a proxied connection: the reader timestamps what it
+  // gets, the writer holds it back until the delay has passed
+  //----------------------------------------------------------------------------
+  struct Pipe
+  {
+    struct Piece
+    {
+      double      due;
+      std::string data;
+    };
+
+    int                from;
+    int                to;
+    bool               eof;
+    std::deque<Piece>  queue;
+    pthread_mutex_t    mutex;
+    pthread_cond_t     cond;
+  };
+
+  void *PipeWriter( void *arg )
+  {
+    Pipe *p = (Pipe*)arg;
+    while( 1 )
+    {
+      pthread_mutex_lock( &p->mutex );
+      while( p->queue.empty() && !p->eof )
+        pthread_cond_wait( &p->cond, &p->mutex );
+      if( p->queue.empty() )
+      {
+        pthread_mutex_unlock( &p->mutex );
+        break;
+      }
+      Pipe::Piece piece = p->queue.front();
+      p->queue.pop_front();
+      pthread_mutex_unlock( &p->mutex );
+
+      double wait = piece.due - Now();
+      if( wait > 0 ) usleep( (useconds_t)( wait * 1e6 ) );
+
+      const char *data = piece.data.data();
+      size_t      left = piece.data.size();
+      while( left )
+      {
+        ssize_t n = write( p->to, data, left );
+        if( n <= 0 ) break;
+        data += n; left -= n;
+      }
+    }
+    shutdown( p->to, SHUT_WR );
+    return 0;
+  }
+
+  void *PipeReader( void *arg )
+  {
+    Pipe *p = (Pipe*)arg;
+    pthread_t writer;
+    pthread_create( &writer, 0, PipeWriter, p );
+
+    char buffer[65536];
+    ssize_t n;
+    while( ( n = read( p->from, buffer, sizeof( buffer ) ) ) > 0 )
+    {
+      Pipe::Piece piece;
+      piece.due = Now() + delay / 2;
+      piece.data.assign( buffer, n );
+      pthread_mutex_lock( &p->mutex );
+      p->queue.push_back( piece );
+      pthread_cond_signal( &p->cond );
+      pthread_mutex_unlock( &p->mutex );
+    }
+
+    pthread_mutex_lock( &p->mutex );
+    p->eof = true;
+    pthread_cond_signal( &p->cond );
+    pthread_mutex_unlock( &p->mutex );
+    pthread_join( writer, 0 );
+    return 0;
+  }
+
+  Pipe *NewPipe( int from, int to )
+  {
+    Pipe *p = new Pipe;
+    p->from = from;
+    p->to   = to;
+    p->eof  = false;
+    pthread_mutex_init( &p->mutex, 0 );
+    pthread_cond_init( &p->cond, 0 );
+    pthread_t tid;
+    pthread_create( &tid, 0, PipeReader, p );
+    pthread_detach( tid );
+    return p;
+  }
+
+  //----------------------------------------------------------------------------
+  // Accept the client connections and plug them to the server
+  //----------------------------------------------------------------------------
+  void *Proxy( void *arg )
+  {
+    int lfd = *(int*)arg;
+    while( 1 )
+    {
+      int cfd = accept( lfd, 0, 0 );
+      if( cfd < 0 ) continue;
+      int sfd = socket( target->ai_family, SOCK_STREAM, 0 );
+      if( connect( sfd, target->ai_addr, target->ai_addrlen ) )
+      {
+        perror( "connect to the server" );
+        close( cfd ); close( sfd );
+        continue;
+      }
+      int one = 1;
+      setsockopt( cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+      setsockopt( sfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+      NewPipe( cfd, sfd );
+      NewPipe( sfd, cfd );
+    }
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Read the file, return the throughput in MB/s and a checksum of the data
+  //----------------------------------------------------------------------------
+  double Run( const std::string &url, bool readAhead, uint32_t blockSize,
+              uint32_t stride, uint64_t toRead, uint32_t &cksum )
+  {
+    using namespace XrdCl;
+    File f;
+    f.SetProperty( "ReadAhead", readAhead ? "true" : "false" );
+    XRootDStatus st = f.Open( url, OpenFlags::Read );
+    if( !st.IsOK() )
+    {
+      std::cerr << "Open: " << st.ToStr() << std::endl;
+      exit( 1 );
+    }
+
+    char     *buffer = new char[blockSize];
+    uint64_t  offset = 0, total = 0;
+    double    start  = Now();
+    cksum = 2166136261U;
+    while( total < toRead )
+    {
+      uint32_t bytesRead = 0;
+      st = f.Read( offset, blockSize, buffer, bytesRead );
+      if( !st.IsOK() )
+      {
+        std::cerr << "Read: " << st.ToStr() << std::endl;
+        exit( 1 );
+      }
+      if( !bytesRead ) break;
+      cksum  = Hash( buffer, bytesRead, cksum );
+      total  += bytesRead;
+      offset += blockSize + stride;
+    }
+    double elapsed = Now() - start;
+    delete [] buffer;
+    st = f.Close();
+    return total / ( 1024.0 * 1024.0 ) / elapsed;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Start up
+//------------------------------------------------------------------------------
+int main( int argc, char **argv )
+{
+  uint32_t blockSize = 256*1024;
+  uint32_t stride    = 0;
+  uint64_t toRead    = 256ULL*1024*1024;
+  int c;
+
+  while( ( c = getopt( argc, argv, "d:b:s:n:" ) ) != -1 )
+  {
+    switch( c )
+    {
+      case 'd': delay     = atof( optarg ) / 1000;            break;
+      case 'b': blockSize = atoi( optarg ) * 1024;            break;
+      case 's': stride    = atoi( optarg ) * 1024;            break;
+      case 'n': toRead    = atoll( optarg ) * 1024 * 1024;    break;
+      default:
+        std::cerr << "Usage: xrdcl-readahead-bench [-d <rtt ms>] "
+                  << "[-b <read KB>] [-s <stride KB>] [-n <MB>] "
+                  << "root://host:port//path" << std::endl;
+        return 1;
+    }
+  }
+
+  if( optind >= argc || !blockSize )
+  {
+    std::cerr << "Usage: xrdcl-readahead-bench [-d <rtt ms>] "
+              << "[-b <read KB>] [-s <stride KB>] [-n <MB>] "
+              << "root://host:port//path" << std::endl;
+    return 1;
+  }
+
+  XrdCl::URL url( argv[optind] );
+  if( !url.IsValid() )
+  {
+    std::cerr << "Invalid URL: " << argv[optind] << std::endl;
+    return 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Start the delaying proxy
+  //----------------------------------------------------------------------------
+  char port[16];
+  snprintf( port, sizeof( port ), "%d", url.GetPort() );
+  struct addrinfo hints;
+  memset( &hints, 0, sizeof( hints ) );
+  hints.ai_socktype = SOCK_STREAM;
+  if( getaddrinfo( url.GetHostName().c_str(), port, &hints, &target ) )
+  {
+    std::cerr << "Unable to resolve " << url.GetHostId() << std::endl;
+    return 1;
+  }
+
+  int lfd = socket( AF_INET, SOCK_STREAM, 0 );
+  struct sockaddr_in sa;
+  socklen_t slen = sizeof( sa );
+  memset( &sa, 0, sizeof( sa ) );
+  sa.sin_family      = AF_INET;
+  sa.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  if( bind( lfd, (struct sockaddr*)&sa, sizeof( sa ) ) || listen( lfd, 16 ) ||
+      getsockname( lfd, (struct sockaddr*)&sa, &slen ) )
+  {
+    perror( "proxy listen" );
+    return 1;
+  }
+  pthread_t tid;
+  pthread_create( &tid, 0, Proxy, &lfd );
+
+  url.SetHostName( "127.0.0.1" );
+  url.SetPort( ntohs( sa.sin_port ) );
+  std::string proxied = url.GetURL();
+
+  std::cout << "Reading " << toRead / ( 1024*1024 ) << " MB in "
+            << blockSize / 1024 << " KB reads";
+  if( stride ) std::cout << " every " << ( blockSize + stride ) / 1024 << " KB";
+  std::cout << ", " << delay * 1000 << " ms round trip" << std::endl;
+
+  uint32_t ck1, ck2;
+  double mb1 = Run( proxied, false, blockSize, stride, toRead, ck1 );
+  printf( "no read-ahead : %8.2f MB/s\n", mb1 );
+  fflush( stdout );
+  double mb2 = Run( proxied, true, blockSize, stride, toRead, ck2 );
+  printf( "read-ahead    : %8.2f MB/s\n", mb2 );
+  fflush( stdout );
+
+  if( ck1 != ck2 )
+  {
+    std::cerr << "Data mismatch between the two runs!" << std::endl;
+    return 1;
+  }
+  return 0;
+}
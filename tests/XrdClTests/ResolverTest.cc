@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Resolve host names with the asynchronous Resolver shared by the channels and
+// check that
+//
+//   - the handler is called exactly once, by a resolver thread and never
+//     from within ResolveAsync
+//   - concurrent requests for the same host all get the answer
+//   - the answer is cached, the cache entry expires after DNSCacheTTL and
+//     can be dropped with Forget
+//   - a failed lookup reaches the handler as an error and is not cached
+//   - a cancelled handler is not called once Cancel has returned
+//
+// Usage: xrdcl-resolver-test
+//
+// Only localhost and a name under the reserved .invalid domain are looked up,
+// so no network is needed.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClResolver.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClEnv.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+using namespace XrdCl;
+
+namespace
+{
+  int errors = 0;
+
+  void Fail( const std::string &test, const std::string &what )
+  {
+    fprintf( stderr, "%s: %s\n", test.c_str(), what.c_str() );
+    ++errors;
+  }
+
+  //----------------------------------------------------------------------------
+  // Record what the resolver hands over
+  //----------------------------------------------------------------------------
+  class TestHandler: public Resolver::Handler
+  {
+    public:
+      TestHandler( const std::string &test ):
+        pTest( test ), pCalls( 0 ), pCaller( pthread_self() ), pInCall( false ),
+        pCancelled( false ), pCond( 0 ) {}
+
+      void Resolve( Resolver &resolver, const URL &url )
+      {
+        {
+          XrdSysCondVarHelper lck( pCond );
+          pInCall = true;
+        }
+        resolver.ResolveAsync( url, Utils::IPAll, this );
+        XrdSysCondVarHelper lck( pCond );
+        pInCall = false;
+      }
+
+      virtual void HandleAddresses( const Status                  &status,
+                                    const std::vector<XrdNetAddr> &addresses )
+      {
+        XrdSysCondVarHelper lck( pCond );
+        if( pCancelled ) Fail( pTest, "called after Cancel" );
+        if( pInCall && pthread_equal( pCaller, pthread_self() ) )
+          Fail( pTest, "called from within ResolveAsync" );
+        if( ++pCalls > 1 ) Fail( pTest, "called twice" );
+        pStatus    = status;
+        pAddresses = addresses;
+        pCond.Broadcast();
+      }
+
+      bool Wait( int seconds = 10 )
+      {
+        XrdSysCondVarHelper lck( pCond );
+        time_t deadline = ::time(0) + seconds;
+        while( !pCalls && ::time(0) < deadline )
+          pCond.Wait( 1 );
+        if( !pCalls )
+        {
+          Fail( pTest, "not called" );
+          return false;
+        }
+        return true;
+      }
+
+      void Cancelled()
+      {
+        XrdSysCondVarHelper lck( pCond );
+        pCancelled = true;
+      }
+
+      const Status                  &GetStatus()    { return pStatus; }
+      const std::vector<XrdNetAddr> &GetAddresses() { return pAddresses; }
+
+    private:
+      std::string              pTest;
+      int                      pCalls;
+      pthread_t                pCaller;
+      bool                     pInCall;
+      bool                     pCancelled;
+      Status                   pStatus;
+      std::vector<XrdNetAddr>  pAddresses;
+      XrdSysCondVar            pCond;
+  };
+
+  bool Cached( Resolver &resolver, const URL &url )
+  {
+    std::vector<XrdNetAddr> addresses;
+    return resolver.GetCached( addresses, url, Utils::IPAll );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  DefaultEnv::GetEnv()->PutInt( "DNSCacheTTL", 2 );
+
+  Resolver resolver( 2 );
+  if( !resolver.Start() )
+  {
+    fprintf( stderr, "Unable to start the resolver\n" );
+    return 1;
+  }
+
+  URL good( "root://localhost:1094" );
+  URL bad( "root://no-such-host.invalid:1094" );
+
+  //----------------------------------------------------------------------------
+  // Concurrent lookups of the same host
+  //----------------------------------------------------------------------------
+  {
+    std::string test = "lookup";
+    if( Cached( resolver, good ) ) Fail( test, "cached before the lookup" );
+
+    TestHandler h1( test ), h2( test );
+    h1.Resolve( resolver, good );
+    h2.Resolve( resolver, good );
+    if( h1.Wait() && h2.Wait() )
+    {
+      if( !h1.GetStatus().IsOK() || !h2.GetStatus().IsOK() )
+        Fail( test, "failed: " + h1.GetStatus().ToString() );
+      else if( h1.GetAddresses().empty() ||
+               h1.GetAddresses().size() != h2.GetAddresses().size() )
+        Fail( test, "wrong addresses" );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // The cache
+  //----------------------------------------------------------------------------
+  {
+    std::string test = "cache";
+    std::vector<XrdNetAddr> addresses;
+    if( !resolver.GetCached( addresses, good, Utils::IPAll ) ||
+        addresses.empty() )
+      Fail( test, "not cached after the lookup" );
+    if( Cached( resolver, URL( "root://localhost:1095" ) ) )
+      Fail( test, "cached for another port" );
+
+    //--------------------------------------------------------------------------
+    // Let the first lookup wind up, a request coming in while it is still
+    // calling back would get its answer instead of a new lookup
+    //--------------------------------------------------------------------------
+    usleep( 100000 );
+    resolver.Forget( good, Utils::IPAll );
+    if( Cached( resolver, good ) ) Fail( test, "cached after Forget" );
+
+    TestHandler h( test );
+    h.Resolve( resolver, good );
+    h.Wait();
+    if( !Cached( resolver, good ) ) Fail( test, "not cached again" );
+
+    sleep( 3 );
+    if( Cached( resolver, good ) ) Fail( test, "cached after the TTL" );
+  }
+
+  //----------------------------------------------------------------------------
+  // Failure
+  //----------------------------------------------------------------------------
+  {
+    std::string test = "failure";
+    TestHandler h1( test ), h2( test );
+    h1.Resolve( resolver, bad );
+    h2.Resolve( resolver, bad );
+    if( h1.Wait() && h2.Wait() )
+    {
+      if( h1.GetStatus().IsOK() || h2.GetStatus().IsOK() )
+        Fail( test, "no error" );
+      if( !h1.GetAddresses().empty() ) Fail( test, "got addresses" );
+    }
+    if( Cached( resolver, bad ) ) Fail( test, "failure cached" );
+  }
+
+  //----------------------------------------------------------------------------
+  // Cancel, whether the lookup is still queued, running or calling back
+  //----------------------------------------------------------------------------
+  for( int i = 0; i < 100; ++i )
+  {
+    std::string test = "cancel";
+    resolver.Forget( good, Utils::IPAll );
+    TestHandler *h = new TestHandler( test );
+    h->Resolve( resolver, good );
+    if( i % 2 ) usleep( i * 10 );
+    resolver.Cancel( h );
+    h->Cancelled();
+    usleep( 1000 );
+    delete h;
+  }
+
+  printf( "resolver: %d errors\n", errors );
+
+  //----------------------------------------------------------------------------
+  // Don't tear down the client threads at exit
+  //----------------------------------------------------------------------------
+  fflush( stdout );
+  _exit( errors ? 1 : 0 );
+}
@@ -27,6 +27,7 @@
 #include "XrdCl/XrdClURL.hh"
 #include "XrdCl/XrdClAnyObject.hh"
 #include "XrdCl/XrdClTaskManager.hh"
+#include "XrdCl/XrdClTimerWheel.hh"
 #include "XrdCl/XrdClSIDManager.hh"
 #include "XrdCl/XrdClPropertyList.hh"
 
@@ -40,12 +41,14 @@ class UtilsTest: public CppUnit::TestCase
       CPPUNIT_TEST( URLTest );
       CPPUNIT_TEST( AnyTest );
       CPPUNIT_TEST( TaskManagerTest );
+      CPPUNIT_TEST( TimerWheelTest );
       CPPUNIT_TEST( SIDManagerTest );
       CPPUNIT_TEST( PropertyListTest );
     CPPUNIT_TEST_SUITE_END();
     void URLTest();
     void AnyTest();
     void TaskManagerTest();
+    void TimerWheelTest();
     void SIDManagerTest();
     void PropertyListTest();
 };
@@ -372,6 +375,78 @@ void UtilsTest::TaskManagerTest()
   CPPUNIT_ASSERT( taskMan.Stop() );
 }
 
+//------------------------------------------------------------------------------
+// Timer wheel test
+//------------------------------------------------------------------------------
+namespace
+{
+  struct TestTimer: public XrdCl::TimerWheel::Timer
+  {
+    uint64_t deadline;
+  };
+}
+
+void UtilsTest::TimerWheelTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Timers spread over all the levels of the wheel and beyond, every
+  // third one cancelled, the rest has to expire neither early nor late
+  //----------------------------------------------------------------------------
+  const uint64_t start = 1000000;
+  const int      n     = 3000;
+  TimerWheel     wheel( start );
+  TestTimer     *timers = new TestTimer[n];
+
+  for( int i = 0; i < n; ++i )
+  {
+    uint64_t delta = 1;
+    for( int j = 0; j < i % 6; ++j )
+      delta *= 97;
+    timers[i].deadline = start + delta * ( i + 1 );
+    wheel.Insert( &timers[i], timers[i].deadline );
+  }
+  CPPUNIT_ASSERT( wheel.GetSize() == (size_t)n );
+
+  for( int i = 0; i < n; i += 3 )
+    wheel.Cancel( &timers[i] );
+  CPPUNIT_ASSERT( wheel.GetSize() == (size_t)( n - n/3 ) );
+
+  //----------------------------------------------------------------------------
+  // Re-arming moves the timer, arming in the past fires right away
+  //----------------------------------------------------------------------------
+  timers[1].deadline = start + 5;
+  wheel.Insert( &timers[1], timers[1].deadline );
+  timers[2].deadline = start - 10;
+  wheel.Insert( &timers[2], timers[2].deadline );
+
+  std::vector<TimerWheel::Timer*> expired;
+  wheel.Advance( start, expired );
+  CPPUNIT_ASSERT( expired.size() == 1 && expired[0] == &timers[2] );
+
+  size_t   fired = 1;
+  uint64_t now   = start;
+  uint64_t steps[] = { 1, 7, 255, 256, 1000, 65536, 100000, 16777216 };
+  for( int round = 0; wheel.GetSize() && round < 100000; ++round )
+  {
+    uint64_t prev = now;
+    now += steps[round % 8] * ( round + 1 );
+    expired.clear();
+    wheel.Advance( now, expired );
+    for( size_t i = 0; i < expired.size(); ++i )
+    {
+      TestTimer *t = static_cast<TestTimer*>( expired[i] );
+      CPPUNIT_ASSERT( t->deadline <= now && t->deadline > prev );
+      CPPUNIT_ASSERT( !t->IsArmed() );
+    }
+    fired += expired.size();
+  }
+  CPPUNIT_ASSERT( fired == (size_t)( n - n/3 ) );
+  CPPUNIT_ASSERT( wheel.GetSize() == 0 );
+  delete [] timers;
+}
+
 //------------------------------------------------------------------------------
 // SID Manager test
 //------------------------------------------------------------------------------
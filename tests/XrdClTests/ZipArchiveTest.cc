@@ -0,0 +1,395 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Write ZIP archives into a directory exported by a server and read them back
+// with the ZipArchiveReader, checking that
+//
+//   - the data of a file is found whatever the local file header looks like:
+//     its extra field differs from the one in the central directory and the
+//     data may be followed by a data descriptor (general purpose bit 3), both
+//     for archives read whole and for the ones read piece by piece
+//   - deflated files inflate to the original data with VectorRead
+//   - a central directory cached for an archive is not used once the archive
+//     has changed, whether or not its size did
+//
+// Usage: xrdcl-zip-test <exported directory> <url of the directory>
+//
+// See zip-test.sh for a way to run it against a throw away server.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClZipArchiveReader.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+
+#include <zlib.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <string>
+#include <vector>
+
+using namespace XrdCl;
+
+namespace
+{
+  int errors = 0;
+
+  void Fail( const std::string &test, const std::string &what )
+  {
+    fprintf( stderr, "%s: %s\n", test.c_str(), what.c_str() );
+    ++errors;
+  }
+
+  //----------------------------------------------------------------------------
+  // A file to be put in an archive
+  //----------------------------------------------------------------------------
+  struct Member
+  {
+    Member( const std::string &n, const std::string &d, bool defl, bool desc,
+            const std::string &lExtra = "", const std::string &cExtra = "" ):
+      name( n ), data( d ), deflate( defl ), descriptor( desc ),
+      lfhExtra( lExtra ), cdExtra( cExtra ) {}
+
+    std::string name;
+    std::string data;
+    bool        deflate;
+    bool        descriptor;
+    std::string lfhExtra;
+    std::string cdExtra;
+    std::string stored;   // filled in by Archive
+  };
+
+  void Put16( std::string &buf, uint16_t v )
+  {
+    buf.append( 1, char( v & 0xff ) );
+    buf.append( 1, char( v >> 8 ) );
+  }
+
+  void Put32( std::string &buf, uint32_t v )
+  {
+    Put16( buf, v & 0xffff );
+    Put16( buf, v >> 16 );
+  }
+
+  std::string Deflate( const std::string &data )
+  {
+    z_stream strm;
+    memset( &strm, 0, sizeof( strm ) );
+    deflateInit2( &strm, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                  Z_DEFAULT_STRATEGY );
+    std::string out( deflateBound( &strm, data.size() ), '\0' );
+    strm.next_in   = (Bytef*)data.data();
+    strm.avail_in  = data.size();
+    strm.next_out  = (Bytef*)&out[0];
+    strm.avail_out = out.size();
+    deflate( &strm, Z_FINISH );
+    out.resize( strm.total_out );
+    deflateEnd( &strm );
+    return out;
+  }
+
+  //----------------------------------------------------------------------------
+  // Build an archive the way a streaming zip writer does: the members that
+  // have a data descriptor have zero sizes and CRC in their local header
+  //----------------------------------------------------------------------------
+  std::string Archive( std::vector<Member> &members )
+  {
+    std::string zip, cd;
+    for( size_t i = 0; i < members.size(); ++i )
+    {
+      Member &m = members[i];
+      m.stored = m.deflate ? Deflate( m.data ) : m.data;
+      uint32_t crc    = crc32( 0L, (Bytef*)m.data.data(), m.data.size() );
+      uint16_t flags  = m.descriptor ? 0x0008 : 0;
+      uint16_t method = m.deflate ? Z_DEFLATED : 0;
+      uint32_t offset = zip.size();
+
+      Put32( zip, 0x04034b50 );
+      Put16( zip, 20 );
+      Put16( zip, flags );
+      Put16( zip, method );
+      Put16( zip, 0 );
+      Put16( zip, 0x21 );
+      Put32( zip, m.descriptor ? 0 : crc );
+      Put32( zip, m.descriptor ? 0 : m.stored.size() );
+      Put32( zip, m.descriptor ? 0 : m.data.size() );
+      Put16( zip, m.name.size() );
+      Put16( zip, m.lfhExtra.size() );
+      zip += m.name + m.lfhExtra + m.stored;
+      if( m.descriptor )
+      {
+        Put32( zip, 0x08074b50 );
+        Put32( zip, crc );
+        Put32( zip, m.stored.size() );
+        Put32( zip, m.data.size() );
+      }
+
+      Put32( cd, 0x02014b50 );
+      Put16( cd, 20 );
+      Put16( cd, 20 );
+      Put16( cd, flags );
+      Put16( cd, method );
+      Put16( cd, 0 );
+      Put16( cd, 0x21 );
+      Put32( cd, crc );
+      Put32( cd, m.stored.size() );
+      Put32( cd, m.data.size() );
+      Put16( cd, m.name.size() );
+      Put16( cd, m.cdExtra.size() );
+      Put16( cd, 0 );
+      Put16( cd, 0 );
+      Put16( cd, 0 );
+      Put32( cd, 0 );
+      Put32( cd, offset );
+      cd += m.name + m.cdExtra;
+    }
+
+    uint32_t cdOffset = zip.size();
+    zip += cd;
+    Put32( zip, 0x06054b50 );
+    Put16( zip, 0 );
+    Put16( zip, 0 );
+    Put16( zip, members.size() );
+    Put16( zip, members.size() );
+    Put32( zip, cd.size() );
+    Put32( zip, cdOffset );
+    Put16( zip, 0 );
+    return zip;
+  }
+
+  bool WriteFile( const std::string &path, const std::string &data )
+  {
+    FILE *f = fopen( path.c_str(), "w" );
+    if( !f ) return false;
+    bool ok = fwrite( data.data(), 1, data.size(), f ) == data.size();
+    return fclose( f ) == 0 && ok;
+  }
+
+  std::string Text( const std::string &seed, size_t size )
+  {
+    std::string text;
+    for( size_t i = 0; text.size() < size; ++i )
+    {
+      char buff[64];
+      snprintf( buff, sizeof( buff ), "%s line %zu\n", seed.c_str(), i );
+      text += buff;
+    }
+    text.resize( size );
+    return text;
+  }
+
+  std::string Random( size_t size, unsigned seed )
+  {
+    std::string data( size, '\0' );
+    for( size_t i = 0; i < size; ++i )
+    {
+      seed = seed * 1103515245 + 12345;
+      data[i] = char( seed >> 16 );
+    }
+    return data;
+  }
+
+  //----------------------------------------------------------------------------
+  // The members of the archives, with the padding the archive is too big to
+  // be read whole
+  //----------------------------------------------------------------------------
+  std::vector<Member> Members( bool pad )
+  {
+    std::vector<Member> members;
+    members.push_back( Member( "stored.txt", Text( "stored", 3000 ), false,
+                               false, std::string( 8, 'l' ) ) );
+    members.push_back( Member( "deflated.txt", Text( "deflated", 50000 ),
+                               true, true, std::string( 4, 'l' ),
+                               std::string( 12, 'c' ) ) );
+    if( pad )
+      members.push_back( Member( "pad.bin", Random( 100000, 7 ), false,
+                                 false ) );
+    members.push_back( Member( "after.txt", Text( "after", 2000 ), false,
+                               true, "", std::string( 20, 'c' ) ) );
+    members.push_back( Member( "last.txt", Text( "last", 1000 ), true,
+                               true ) );
+    return members;
+  }
+
+  //----------------------------------------------------------------------------
+  // Read all the members one by one: the stored data as is and the deflated
+  // data as stored
+  //----------------------------------------------------------------------------
+  void CheckRead( const std::string &test, const std::string &url,
+                  const std::vector<Member> &members )
+  {
+    ZipArchiveReader zip;
+    XRootDStatus st = zip.Open( url );
+    if( !st.IsOK() ) return Fail( test, "open: " + st.ToString() );
+
+    for( size_t i = 0; i < members.size(); ++i )
+    {
+      const Member &m = members[i];
+      uint64_t offset = m.stored.size() / 3;
+      std::string want = m.stored.substr( offset, 500 );
+      std::string buffer( 500, '\0' );
+      uint32_t bytesRead = 0;
+      st = zip.Read( m.name, offset, 500, &buffer[0], bytesRead );
+      if( !st.IsOK() )
+        Fail( test, m.name + ": read: " + st.ToString() );
+      else if( buffer.substr( 0, bytesRead ) != want )
+        Fail( test, m.name + ": read the wrong data" );
+    }
+    zip.Close();
+  }
+
+  //----------------------------------------------------------------------------
+  // Read a piece of every member in one go, inflating the deflated ones
+  //----------------------------------------------------------------------------
+  void CheckVectorRead( const std::string &test, const std::string &url,
+                        const std::vector<Member> &members )
+  {
+    ZipArchiveReader zip;
+    XRootDStatus st = zip.Open( url );
+    if( !st.IsOK() ) return Fail( test, "open: " + st.ToString() );
+
+    std::vector<std::string> buffers( members.size(), std::string( 700, '\0' ) );
+    ZipChunkList chunks;
+    for( size_t i = 0; i < members.size(); ++i )
+      chunks.push_back( ZipChunk( members[i].name, members[i].data.size() / 2,
+                                  700, &buffers[i][0] ) );
+
+    VectorReadInfo *info = 0;
+    st = zip.VectorRead( chunks, true, info );
+    if( !st.IsOK() )
+    {
+      zip.Close();
+      return Fail( test, "vector read: " + st.ToString() );
+    }
+
+    ChunkList &got = info->GetChunks();
+    if( got.size() != members.size() )
+      Fail( test, "vector read returned the wrong number of chunks" );
+    for( size_t i = 0; i < got.size() && i < members.size(); ++i )
+    {
+      std::string want = members[i].data.substr( members[i].data.size() / 2,
+                                                  700 );
+      if( std::string( (char*)got[i].buffer, got[i].length ) != want )
+        Fail( test, members[i].name + ": vector read the wrong data" );
+    }
+    delete info;
+    zip.Close();
+  }
+
+  //----------------------------------------------------------------------------
+  // Read the one member of the given archive
+  //----------------------------------------------------------------------------
+  std::string ReadOne( const std::string &url, const std::string &name )
+  {
+    ZipArchiveReader zip;
+    if( !zip.Open( url ).IsOK() ) return "<open failed>";
+    std::string buffer( 100, '\0' );
+    uint32_t bytesRead = 0;
+    if( !zip.Read( name, 0, buffer.size(), &buffer[0], bytesRead ).IsOK() )
+      buffer = "<read failed>";
+    else
+      buffer.resize( bytesRead );
+    zip.Close();
+    return buffer;
+  }
+
+  //----------------------------------------------------------------------------
+  // Change the archive, once with a new size and once with the same size
+  // and a new modification time, the reader has to see the new content
+  //----------------------------------------------------------------------------
+  void CheckCache( const std::string &dir, const std::string &url )
+  {
+    std::string path = dir + "/cache.zip", test = "cache";
+    std::string contents[] = { "the first version",
+                               "the second, longer version",
+                               "the third, longer version!" };
+
+    for( int i = 0; i < 3; ++i )
+    {
+      std::vector<Member> members;
+      members.push_back( Member( "pad.bin", Random( 100000, 3 ), false,
+                                 false ) );
+      members.push_back( Member( "version.txt", contents[i], false,
+                                 false ) );
+      if( !WriteFile( path, Archive( members ) ) )
+        return Fail( test, "unable to write " + path );
+      if( i == 2 )
+      {
+        struct utimbuf times;
+        times.actime = times.modtime = time( 0 ) + 60;
+        utime( path.c_str(), &times );
+      }
+
+      // twice, the second time from the cache
+      for( int j = 0; j < 2; ++j )
+      {
+        std::string got = ReadOne( url + "/cache.zip", "version.txt" );
+        if( got != contents[i] )
+          Fail( test, "version " + std::string( 1, char( '1' + i ) ) +
+                ": read '" + got + "'" );
+      }
+    }
+  }
+}
+
+int main( int argc, char **argv )
+{
+  if( argc != 3 )
+  {
+    fprintf( stderr, "Usage: %s <exported directory> <url of the directory>\n",
+             argv[0] );
+    return 1;
+  }
+  std::string dir = argv[1], url = argv[2];
+
+  //----------------------------------------------------------------------------
+  // Archives read piece by piece, first read one by one and first read with
+  // a vector read, so that both look up the local file headers, and a small
+  // one that is read whole
+  //----------------------------------------------------------------------------
+  std::vector<Member> big = Members( true ), small = Members( false );
+  std::string bigZip = Archive( big ), smallZip = Archive( small );
+  if( !WriteFile( dir + "/read.zip", bigZip ) ||
+      !WriteFile( dir + "/vread.zip", bigZip ) ||
+      !WriteFile( dir + "/small.zip", smallZip ) )
+  {
+    fprintf( stderr, "Unable to write the archives to %s\n", dir.c_str() );
+    return 1;
+  }
+
+  CheckRead( "read", url + "/read.zip", big );
+  CheckVectorRead( "read", url + "/read.zip", big );
+  CheckVectorRead( "vread", url + "/vread.zip", big );
+  CheckRead( "vread", url + "/vread.zip", big );
+  CheckRead( "small", url + "/small.zip", small );
+  CheckVectorRead( "small", url + "/small.zip", small );
+  CheckCache( dir, url );
+
+  printf( "%d errors\n", errors );
+
+  //----------------------------------------------------------------------------
+  // Don't tear down the client threads at exit
+  //----------------------------------------------------------------------------
+  fflush( stdout );
+  _exit( errors ? 1 : 0 );
+}
@@ -0,0 +1,99 @@
+#!/bin/bash
+#-------------------------------------------------------------------------------
+# Extreme copy benchmark: start a few local xrootd servers sharing the same
+# data directory, each one throttled to its own data rate, and copy a file
+# from all of them at once with xrdcp --sources.
+#
+# Usage: xcp-bench.sh <build dir> [file size in MB] [rate1 rate2 ...]
+#
+# The rates are given in bytes per second (k, m and g suffixes allowed),
+# 0 meaning no throttle. The default is two fast servers and a slow one.
+#-------------------------------------------------------------------------------
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <build dir> [file size in MB] [rate1 rate2 ...]" 1>&2
+  exit 1
+fi
+
+BUILD=`cd $1 && pwd`
+SIZE=${2:-256}
+shift; shift
+RATES=${@:-"40m 40m 4m"}
+PORT=${XCP_BENCH_PORT:-21300}
+
+XROOTD=$BUILD/src/xrootd
+XRDCP=$BUILD/src/XrdCl/xrdcp
+export LD_LIBRARY_PATH=$BUILD/src:$BUILD/src/XrdCl:$LD_LIBRARY_PATH
+
+WORK=`mktemp -d /tmp/xcp-bench.XXXXXX`
+mkdir -p $WORK/data $WORK/run
+PIDS=""
+
+cleanup()
+{
+  for PID in $PIDS; do kill $PID 2> /dev/null; done
+  rm -rf $WORK
+}
+trap cleanup EXIT
+
+#-------------------------------------------------------------------------------
+# The data
+#-------------------------------------------------------------------------------
+dd if=/dev/urandom of=$WORK/data/file bs=1M count=$SIZE 2> /dev/null
+SUM=`md5sum < $WORK/data/file`
+
+RUNAS=""
+if [ `id -u` -eq 0 ]; then
+  RUNAS="-R nobody"
+  chown -R nobody $WORK
+fi
+
+#-------------------------------------------------------------------------------
+# The servers and the metalink file pointing to all of them
+#-------------------------------------------------------------------------------
+META=$WORK/file.meta4
+echo '<?xml version="1.0" encoding="UTF-8"?>' > $META
+echo '<metalink xmlns="urn:ietf:params:xml:ns:metalink">' >> $META
+echo "  <file name=\"file\">" >> $META
+echo "    <size>$((SIZE*1048576))</size>" >> $META
+
+N=0
+for RATE in $RATES; do
+  P=$((PORT+N))
+  CFG=$WORK/run/xrd$N.cf
+  echo "all.export $WORK/data" > $CFG
+  echo "xrd.port $P" >> $CFG
+  if [ "$RATE" != "0" ]; then
+    echo "xrootd.fslib throttle default" >> $CFG
+    echo "throttle.throttle data $RATE" >> $CFG
+  fi
+  $XROOTD $RUNAS -c $CFG -l $WORK/run/xrd$N.log -s $WORK/run/xrd$N.pid \
+    -n xcp$N > /dev/null 2>&1 &
+  PIDS="$PIDS $!"
+  echo "    <url priority=\"$((N+1))\">root://localhost:$P/$WORK/data/file</url>" >> $META
+  N=$((N+1))
+done
+
+echo "  </file>" >> $META
+echo "</metalink>" >> $META
+sleep 2
+
+#-------------------------------------------------------------------------------
+# Copy
+#-------------------------------------------------------------------------------
+echo "Copying $SIZE MB from $N servers throttled at: $RATES"
+START=`date +%s.%N`
+XRD_LOCALMETALINKFILE=1 $XRDCP $XCP_BENCH_XRDCP_OPTS -f -s --sources $N root://localfile/$META $WORK/copy
+END=`date +%s.%N`
+
+if [ ! -f $WORK/copy ]; then
+  echo "xrdcp failed"
+  exit 1
+fi
+
+if [ "`md5sum < $WORK/copy`" != "$SUM" ]; then
+  echo "The copy is corrupted"
+  exit 1
+fi
+
+echo $START $END $SIZE | awk '{ printf "%.2f s, %.1f MB/s\n", $2-$1, $3/($2-$1) }'
@@ -0,0 +1,61 @@
+#!/bin/bash
+#-------------------------------------------------------------------------------
+# ZIP archive test: start a throw away xrootd exporting a scratch directory
+# and run xrdcl-zip-test against it, the test writes its archives there.
+#
+# Usage: zip-test.sh <build dir>
+#
+# The server listens on XRDCL_ZIP_PORT, 21095 by default.
+#-------------------------------------------------------------------------------
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <build dir>" 1>&2
+  exit 1
+fi
+
+BUILD=`cd $1 && pwd`
+PORT=${XRDCL_ZIP_PORT:-21095}
+
+TEST=$BUILD/tests/XrdClTests/xrdcl-zip-test
+export LD_LIBRARY_PATH=$BUILD/src:$BUILD/src/XrdCl:$LD_LIBRARY_PATH
+
+WORK=`mktemp -d /tmp/zip-test.XXXXXX`
+mkdir -p $WORK/data
+PID=
+
+cleanup()
+{
+  [ -n "$PID" ] && kill $PID 2> /dev/null && wait $PID 2> /dev/null
+  rm -rf $WORK
+}
+trap cleanup EXIT
+
+#-------------------------------------------------------------------------------
+# The server
+#-------------------------------------------------------------------------------
+cat > $WORK/xrootd.cfg <<EOF
+all.export $WORK/data
+all.adminpath $WORK
+all.pidpath $WORK
+EOF
+
+RUNAS=""
+if [ `id -u` -eq 0 ]; then
+  RUNAS="-R nobody"
+  chown -R nobody $WORK
+fi
+
+$BUILD/src/xrootd -p $PORT -c $WORK/xrootd.cfg -l $WORK/xrootd.log -n zip \
+  $RUNAS > /dev/null 2>&1 &
+PID=$!
+sleep 2
+if ! kill -0 $PID 2> /dev/null; then
+  echo "xrootd did not start, see below" 1>&2
+  cat `find $WORK -name 'xrootd.log*'` 1>&2
+  exit 1
+fi
+
+#-------------------------------------------------------------------------------
+# Run
+#-------------------------------------------------------------------------------
+$TEST $WORK/data root://localhost:$PORT/$WORK/data
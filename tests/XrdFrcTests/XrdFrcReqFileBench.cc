@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Bulk prepare against the persistent request queue of the file residency
+// manager: many threads add stage requests to the queue at once, the way the
+// xrootd threads do during a prepare storm, after which the queue is listed,
+// some of the prepares are cancelled and the queue is recovered and drained
+// the way frm_xfrd does it.
+//
+// Usage: xrdfrc-reqfile-bench [-t <threads>] [-n <requests per thread>]
+//                             [-p <files per prepare>] [-c <cancels>]
+//                             [-d <directory>]
+//
+// The queue is created in a temporary directory under the given one (default
+// /tmp), so that it lives on the file system whose fsync is to be measured.
+//------------------------------------------------------------------------------
+
+#include "BenchUtils.hh"
+#include "XrdFrc/XrdFrcReqFile.hh"
+#include "XrdFrc/XrdFrcRequest.hh"
+#include "XrdFrc/XrdFrcTrace.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Settings
+  //----------------------------------------------------------------------------
+  int         nThreads = 16;
+  int         nReqs    = 1000;
+  int         perPrep  = 100;
+  int         nCancels = 4;
+  std::string topDir   = "/tmp";
+
+  XrdFrcReqFile *agentQ = 0;
+
+  inline double Now()
+  {
+    return XrdBench::Now() / 1e9;
+  }
+
+  struct Worker: public XrdBench::Worker
+  {
+    Worker(): thread( 0 ) {}
+    int thread;
+  };
+
+  //----------------------------------------------------------------------------
+  // Fill in a stage request, each prepare carries perPrep files
+  //----------------------------------------------------------------------------
+  void MakeRequest( XrdFrcRequest &req, int thread, int num )
+  {
+    memset( &req, 0, sizeof( req ) );
+    snprintf( req.LFN, sizeof( req.LFN ), "/store/bench/t%d/file%d.root",
+              thread, num );
+    snprintf( req.User, sizeof( req.User ), "bench.%d:%d@localhost",
+              getpid(), thread );
+    snprintf( req.ID, sizeof( req.ID ), "%d:%d", thread, num / perPrep );
+    strcpy( req.iName, "anon" );
+    req.addTOD = time( 0 );
+    req.OPc    = '+';
+    req.Prty   = 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Add the requests of one thread
+  //----------------------------------------------------------------------------
+  void *Prepare( void *arg )
+  {
+    int           thread = ( (Worker*)arg )->thread;
+    XrdFrcRequest req;
+
+    for( int i = 0; i < nReqs; ++i )
+    {
+      MakeRequest( req, thread, i );
+      agentQ->Add( &req );
+    }
+    return 0;
+  }
+
+  void Usage( const char *prog )
+  {
+    XrdBench::Usage( prog, "[-t <threads>] [-n <requests per thread>] "
+                     "[-p <files per prepare>] [-c <cancels>] "
+                     "[-d <directory>]" );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  int opt;
+  while( ( opt = getopt( argc, argv, "t:n:p:c:d:" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 't': nThreads = atoi( optarg ); break;
+      case 'n': nReqs    = atoi( optarg ); break;
+      case 'p': perPrep  = atoi( optarg ); break;
+      case 'c': nCancels = atoi( optarg ); break;
+      case 'd': topDir   = optarg;         break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( nThreads < 1 || nReqs < 1 || perPrep < 1 || nCancels < 0 )
+    Usage( argv[0] );
+
+  XrdSysLogger logger;
+  XrdFrc::Say.logger( &logger );
+
+  std::string dirTmpl = topDir + "/xrdfrc-bench.XXXXXX";
+  std::vector<char> dir( dirTmpl.begin(), dirTmpl.end() );
+  dir.push_back( 0 );
+  if( !mkdtemp( &dir[0] ) )
+  {
+    perror( "mkdtemp" );
+    return 1;
+  }
+  std::string qFile = std::string( &dir[0] ) + "/stageQ.0";
+  long total = long( nThreads ) * nReqs;
+  int  rc    = 0;
+
+  //----------------------------------------------------------------------------
+  // Bulk prepare through an agent, like xrootd does
+  //----------------------------------------------------------------------------
+  agentQ = new XrdFrcReqFile( qFile.c_str(), 1 );
+  if( !agentQ->Init() )
+  {
+    fprintf( stderr, "Unable to initialize the queue in %s\n", &dir[0] );
+    return 1;
+  }
+
+  std::vector<Worker> workers( nThreads );
+  for( int i = 0; i < nThreads; ++i )
+    workers[i].thread = i;
+  double elapsed = XrdBench::Run( workers, Prepare );
+  printf( "add:     %ld requests by %d threads in %.2f s, %.0f requests/s\n",
+          total, nThreads, elapsed, total / elapsed );
+
+  //----------------------------------------------------------------------------
+  // List the queue
+  //----------------------------------------------------------------------------
+  char buff[8192];
+  int  offs = 0;
+  long listed = 0;
+  double start = Now();
+  while( agentQ->List( buff, sizeof( buff ), offs ) ) ++listed;
+  elapsed = Now() - start;
+  printf( "list:    %ld requests in %.2f s\n", listed, elapsed );
+  if( listed != total )
+  {
+    printf( "expected %ld requests in the listing\n", total );
+    rc = 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Cancel a few of the prepares
+  //----------------------------------------------------------------------------
+  long cancelled = 0;
+  start = Now();
+  for( int i = 0; i < nCancels; ++i )
+  {
+    XrdFrcRequest req;
+    int thread = i % nThreads, num = ( i / nThreads ) * perPrep;
+    if( num >= nReqs ) break;
+    MakeRequest( req, thread, num );
+    agentQ->Can( &req );
+    cancelled += std::min( perPrep, nReqs - num );
+  }
+  elapsed = Now() - start;
+  printf( "cancel:  %ld requests in %.2f s\n", cancelled, elapsed );
+  delete agentQ;
+
+  //----------------------------------------------------------------------------
+  // Recover the queue and drain it, like frm_xfrd does
+  //----------------------------------------------------------------------------
+  XrdFrcReqFile *bossQ = new XrdFrcReqFile( qFile.c_str(), 0 );
+  start = Now();
+  if( !bossQ->Init() )
+  {
+    fprintf( stderr, "Unable to recover the queue in %s\n", &dir[0] );
+    return 1;
+  }
+  elapsed = Now() - start;
+  printf( "recover: %.2f s\n", elapsed );
+
+  XrdFrcRequest req;
+  long drained = 0;
+  start = Now();
+  while( bossQ->Get( &req ) )
+  {
+    bossQ->Del( &req );
+    ++drained;
+  }
+  elapsed = Now() - start;
+  printf( "drain:   %ld requests in %.2f s, %.0f requests/s\n", drained,
+          elapsed, drained / elapsed );
+  if( drained != total - cancelled )
+  {
+    printf( "expected %ld requests to be drained\n", total - cancelled );
+    rc = 1;
+  }
+  delete bossQ;
+
+  //----------------------------------------------------------------------------
+  // Nothing should be left after a restart
+  //----------------------------------------------------------------------------
+  bossQ = new XrdFrcReqFile( qFile.c_str(), 0 );
+  drained = 0;
+  if( bossQ->Init() )
+    while( bossQ->Get( &req ) ) ++drained;
+  if( drained )
+  {
+    printf( "%ld requests left in the queue after draining it\n", drained );
+    rc = 1;
+  }
+  delete bossQ;
+
+  std::string cmd = "rm -rf " + std::string( &dir[0] );
+  if( system( cmd.c_str() ) ) {}
+  return rc;
+}
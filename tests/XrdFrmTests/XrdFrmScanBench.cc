@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Name space scan of the file residency manager: a tree of directories full
+// of migrated files is scanned the way frm_xfrd looks for files to migrate,
+// first on a single thread, then with many threads and finally incrementally
+// after a few directories got a new file.
+//
+// Usage: xrdfrm-scan-bench [-D <top dirs>] [-S <subdirs per top dir>]
+//                          [-f <files per subdir>] [-t <threads>]
+//                          [-c <% of subdirs changed>] [-d <directory>] [-C]
+//
+// The tree is created in a temporary directory under the given one (default
+// /tmp). With -C the page cache is dropped before each scan (root only), so
+// that the scans have to go to the disk as they do on a busy server.
+//------------------------------------------------------------------------------
+
+#include "BenchUtils.hh"
+#include "XrdFrc/XrdFrcTrace.hh"
+#include "XrdFrc/XrdFrcXAttr.hh"
+#include "XrdFrm/XrdFrmConfig.hh"
+#include "XrdFrm/XrdFrmDirIndex.hh"
+#include "XrdFrm/XrdFrmFiles.hh"
+#include "XrdOuc/XrdOucXAttr.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <string>
+
+//------------------------------------------------------------------------------
+// The scanner takes its settings from here
+//------------------------------------------------------------------------------
+XrdFrmConfig XrdFrm::Config( XrdFrmConfig::ssXfr, "", "" );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Settings
+  //----------------------------------------------------------------------------
+  int         nTop     = 16;
+  int         nSub     = 64;
+  int         nFiles   = 100;
+  int         nThreads = 8;
+  int         pctChg   = 2;
+  bool        coldScan = false;
+  std::string baseDir  = "/tmp";
+
+  //----------------------------------------------------------------------------
+  // Create a file marked as copied at the given time
+  //----------------------------------------------------------------------------
+  bool MakeFile( const std::string &path, long long cpyTime )
+  {
+    int fd = open( path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644 );
+    if( fd < 0 ) return false;
+    XrdOucXAttr<XrdFrcXAttrCpy> cpyInfo;
+    cpyInfo.Attr.cpyTime = cpyTime;
+    bool ok = cpyInfo.Set( path.c_str(), fd ) == 0;
+    close( fd );
+    return ok;
+  }
+
+  std::string SubDir( const std::string &root, int i, int j )
+  {
+    char buff[64];
+    snprintf( buff, sizeof( buff ), "/d%03d/s%03d/", i, j );
+    return root + buff;
+  }
+
+  //----------------------------------------------------------------------------
+  // Scan the tree like XrdFrmMigrate::Scan does
+  //----------------------------------------------------------------------------
+  struct Result
+  {
+    Result(): sets( 0 ), toMigrate( 0 ), secs( 0 ) {}
+    long   sets;
+    long   toMigrate;
+    double secs;
+  };
+
+  Result Scan( const std::string &root, int threads, XrdFrmDirIndex *index )
+  {
+    static const int opts = XrdFrmFiles::Recursive | XrdFrmFiles::CompressD |
+                            XrdFrmFiles::NoAutoDel | XrdFrmFiles::GetCpyTim;
+    Result         res;
+    XrdFrmFileset *sP;
+    int            rc;
+
+    if( coldScan )
+    {
+      sync();
+      FILE *fp = fopen( "/proc/sys/vm/drop_caches", "w" );
+      if( !fp || fputs( "3\n", fp ) < 0 )
+        perror( "Unable to drop the page cache" );
+      if( fp ) fclose( fp );
+    }
+
+    uint64_t start = XrdBench::Now();
+
+    XrdFrmFiles files( root.c_str(), opts, 0, 0, threads, index );
+    while( ( sP = files.Get( rc, 1 ) ) )
+    {
+      ++res.sets;
+      if( !sP->Screen() || sP->cpyInfo.Attr.cpyTime <
+          static_cast<long long>( sP->baseFile()->Stat.st_mtime ) )
+      {
+        ++res.toMigrate;
+        files.Rescan();
+      }
+      delete sP;
+    }
+    res.secs = ( XrdBench::Now() - start ) / 1e9;
+    return res;
+  }
+
+  void Report( const char *what, const Result &res, XrdFrmDirIndex *index )
+  {
+    printf( "%-22s %8ld filesets %6ld to migrate %8.3f s %10.0f files/s",
+            what, res.sets, res.toMigrate, res.secs,
+            res.secs > 0 ? res.sets / res.secs : 0.0 );
+    if( index )
+      printf( ", %d of %d dirs skipped", index->numSkip, index->numDirs );
+    printf( "\n" );
+  }
+
+  void Usage( const char *prog )
+  {
+    XrdBench::Usage( prog, "[-D <top dirs>] [-S <subdirs per top dir>] "
+                     "[-f <files per subdir>] [-t <threads>] "
+                     "[-c <% changed>] [-d <directory>] [-C]" );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  int opt;
+  while( ( opt = getopt( argc, argv, "D:S:f:t:c:d:C" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 'D': nTop     = atoi( optarg ); break;
+      case 'S': nSub     = atoi( optarg ); break;
+      case 'f': nFiles   = atoi( optarg ); break;
+      case 't': nThreads = atoi( optarg ); break;
+      case 'c': pctChg   = atoi( optarg ); break;
+      case 'd': baseDir  = optarg;         break;
+      case 'C': coldScan = true;           break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( nTop < 1 || nSub < 1 || nFiles < 1 || nThreads < 1 || pctChg < 0 ||
+      pctChg > 100 )
+    Usage( argv[0] );
+
+  XrdSysLogger logger;
+  XrdFrc::Say.logger( &logger );
+
+  //----------------------------------------------------------------------------
+  // Create the tree, all the files have been migrated
+  //----------------------------------------------------------------------------
+  std::string work = baseDir + "/xrdfrm-scan-bench.XXXXXX";
+  if( !mkdtemp( &work[0] ) )
+  {
+    perror( "mkdtemp" );
+    return 1;
+  }
+  std::string root  = work + "/data";
+  std::string admin = work + "/admin/";
+  mkdir( root.c_str(), 0755 );
+  mkdir( admin.c_str(), 0755 );
+  XrdFrm::Config.AdminPath = strdup( admin.c_str() );
+
+  long long migrated = time( 0 ) + 3600;
+  char      name[32];
+  for( int i = 0; i < nTop; ++i )
+  {
+    snprintf( name, sizeof( name ), "/d%03d", i );
+    mkdir( ( root + name ).c_str(), 0755 );
+    for( int j = 0; j < nSub; ++j )
+    {
+      std::string dir = SubDir( root, i, j );
+      mkdir( dir.c_str(), 0755 );
+      for( int k = 0; k < nFiles; ++k )
+      {
+        snprintf( name, sizeof( name ), "f%05d", k );
+        if( !MakeFile( dir + name, migrated ) )
+        {
+          perror( "Unable to create the files (do extended attributes work?)" );
+          return 1;
+        }
+      }
+    }
+  }
+  printf( "%d directories, %ld files, %d threads\n", 1 + nTop + nTop * nSub,
+          (long)nTop * nSub * nFiles, nThreads );
+
+  //----------------------------------------------------------------------------
+  // Full scans
+  //----------------------------------------------------------------------------
+  Result serial   = Scan( root, 1, 0 );
+  Report( "single thread:", serial, 0 );
+  Result parallel = Scan( root, nThreads, 0 );
+  Report( "multi-threaded:", parallel, 0 );
+
+  //----------------------------------------------------------------------------
+  // Incremental scans, the first one builds the index. Directories changed
+  // in the last two seconds are not trusted, so give them time to settle.
+  //----------------------------------------------------------------------------
+  sleep( 2 );
+  XrdFrmDirIndex index( "bench" );
+  index.Start( 0 );
+  Result first = Scan( root, nThreads, &index );
+  index.Commit();
+  Report( "indexing:", first, &index );
+
+  int changed = 0;
+  int step    = pctChg ? 100 / pctChg : 0;
+  for( int n = 0; step && n < nTop * nSub; n += step )
+  {
+    if( !MakeFile( SubDir( root, n / nSub, n % nSub ) + "new", 1 ) )
+    {
+      perror( "Unable to create a new file" );
+      return 1;
+    }
+    ++changed;
+  }
+
+  index.Start( 0 );
+  Result incr = Scan( root, nThreads, &index );
+  index.Commit();
+  Report( "incremental:", incr, &index );
+
+  index.Start( 0 );
+  Result again = Scan( root, nThreads, &index );
+  index.Commit();
+  Report( "incremental again:", again, &index );
+
+  //----------------------------------------------------------------------------
+  // Check that every scan saw what it should have
+  //----------------------------------------------------------------------------
+  long total  = (long)nTop * nSub * nFiles;
+  int  errors = 0;
+  if( serial.sets != total || parallel.sets != total || first.sets != total )
+  {
+    printf( "A full scan missed files\n" );
+    ++errors;
+  }
+  if( incr.toMigrate != changed || again.toMigrate != changed )
+  {
+    printf( "An incremental scan found %ld and %ld of the %d new files\n",
+            incr.toMigrate, again.toMigrate, changed );
+    ++errors;
+  }
+
+  std::string cmd = "rm -rf " + work;
+  if( system( cmd.c_str() ) ) {}
+  return errors ? 1 : 0;
+}
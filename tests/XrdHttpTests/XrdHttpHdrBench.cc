@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+/** @file  XrdHttpHdrBench.cc
+ * @brief  Replays request headers through the old and the in-place header
+ *         parsing strategies of XrdHttp and compares their cost
+ *
+ * Usage: xrdhttp-hdrbench [-n <iterations>] [<capture file>]
+ *
+ * The capture file holds raw HTTP requests (CRLF terminated lines), each
+ * request ending with an empty line, as e.g. saved with tcpflow. Without
+ * a capture file a few typical GET and PROPFIND requests are replayed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "XrdOuc/XrdOucString.hh"
+#include "XrdHttp/XrdHttpHeaders.hh"
+
+namespace
+{
+const char *defReqs[] =
+{"GET /store/data/run1/file.root HTTP/1.1\r\n"
+ "Host: eosserver.cern.ch:1094\r\n"
+ "User-Agent: ROOT/6.08\r\n"
+ "Accept: */*\r\n"
+ "Connection: Keep-Alive\r\n"
+ "Range: bytes=0-1023,4096-8191\r\n"
+ "\r\n",
+
+ "PROPFIND /store/data/run1/ HTTP/1.1\r\n"
+ "Host: eosserver.cern.ch:1094\r\n"
+ "User-Agent: davix/0.6.4 libneon/0.0.29\r\n"
+ "Keep-Alive: \r\n"
+ "Connection: Keep-Alive\r\n"
+ "Depth: 1\r\n"
+ "Content-Type: application/xml; charset=\"utf-8\"\r\n"
+ "Content-Length: 0\r\n"
+ "\r\n",
+
+ "GET /store/user/someone/ntuple_42.root HTTP/1.1\r\n"
+ "Host: eosserver.cern.ch:1094\r\n"
+ "User-Agent: curl/7.29.0\r\n"
+ "Accept: */*\r\n"
+ "\r\n"
+};
+
+// The header names the old parser looked for, in the order it tested them
+const char *oldKeys[] = {"Connection", "Host", "Range", "Content-Length",
+                         "Destination", "Depth", "Expect"};
+
+/******************************************************************************/
+/*                         O l d   S t r a t e g y                            */
+/******************************************************************************/
+
+// Byte by byte scan, copy of the line into an XrdOucString, strcmp chain
+
+int OldParse(char *buff, int blen, XrdOucString &line)
+{
+   int found = 0;
+   char *start = buff, *bend = buff + blen;
+
+   while(start < bend)
+        {char *p = start;
+         int l = 0;
+         while(p < bend) {l++; if (*p++ == '\n') break;}
+         line.assign(start, 0, l-1);
+         start += l;
+         if (l == 2) break;
+
+         char *key = (char *)line.c_str();
+         char *col = strchr(key, ':');
+         if (!col) continue;
+         *col = 0;
+         for (unsigned int i = 0; i < sizeof(oldKeys)/sizeof(char *); i++)
+             if (!strcmp(key, oldKeys[i])) {found++; break;}
+        }
+   return found;
+}
+
+/******************************************************************************/
+/*                         N e w   S t r a t e g y                            */
+/******************************************************************************/
+
+// memchr scan, in place tokenization, perfect hash dispatch
+
+int NewParse(char *buff, int blen)
+{
+   int found = 0;
+   char *start = buff, *bend = buff + blen, *p;
+
+   while((p = XrdHttpFindEOL(start, bend)))
+        {int l = p - start + 1;
+         *p = 0;
+         char *line = start;
+         start += l;
+         if (l == 2) break;
+
+         char *col = (char *)memchr(line, ':', l - 1);
+         if (!col) continue;
+         if (XrdHttpHeaderID(line, col - line) != hdrOther) found++;
+        }
+   return found;
+}
+
+double Now()
+{
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   return tv.tv_sec + tv.tv_usec / 1e6;
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char **argv)
+{
+   std::vector<std::string> reqs;
+   long iters = 200000;
+   int c;
+
+// Process the options
+//
+   while ((c = getopt(argc, argv, "n:")) != -1)
+         {switch(c)
+                {case 'n': iters = atol(optarg);
+                           break;
+                 default:  std::cerr <<"Usage: xrdhttp-hdrbench [-n <iterations>] "
+                                       "[<capture file>]" <<std::endl;
+                           return 1;
+                }
+         }
+
+// Load the captured requests or use the default ones
+//
+   if (optind < argc)
+      {std::ifstream in(argv[optind], std::ios::binary);
+       if (!in)
+          {std::cerr <<"Unable to open " <<argv[optind] <<std::endl; return 1;}
+       std::stringstream ss;
+       ss <<in.rdbuf();
+       std::string all = ss.str();
+       size_t pos = 0, eoh;
+       while((eoh = all.find("\r\n\r\n", pos)) != std::string::npos)
+            {reqs.push_back(all.substr(pos, eoh + 4 - pos));
+             pos = eoh + 4;
+            }
+      } else {
+       for (unsigned int i = 0; i < sizeof(defReqs)/sizeof(char *); i++)
+           reqs.push_back(defReqs[i]);
+      }
+
+   if (reqs.empty())
+      {std::cerr <<"No complete request found" <<std::endl; return 1;}
+
+// Both strategies must agree on what they recognize
+//
+   std::vector<char> buff(1024*1024);
+   XrdOucString line;
+   long long totBytes = 0;
+   for (unsigned int i = 0; i < reqs.size(); i++)
+       {int n = reqs[i].size();
+        if (n > (int)buff.size()) buff.resize(n);
+        memcpy(&buff[0], reqs[i].data(), n);
+        int o = OldParse(&buff[0], n, line);
+        memcpy(&buff[0], reqs[i].data(), n);
+        int w = NewParse(&buff[0], n);
+        if (o != w) std::cerr <<"Warning: request " <<i <<" recognized "
+                              <<o <<" vs " <<w <<" headers (case differences?)"
+                              <<std::endl;
+        totBytes += n;
+       }
+
+// Replay the requests, the copy into the buffer mimics the socket read
+//
+   double t0, tOld, tNew;
+   long sink = 0;
+
+   t0 = Now();
+   for (long k = 0; k < iters; k++)
+       {const std::string &r = reqs[k % reqs.size()];
+        memcpy(&buff[0], r.data(), r.size());
+        sink += OldParse(&buff[0], r.size(), line);
+       }
+   tOld = Now() - t0;
+
+   t0 = Now();
+   for (long k = 0; k < iters; k++)
+       {const std::string &r = reqs[k % reqs.size()];
+        memcpy(&buff[0], r.data(), r.size());
+        sink += NewParse(&buff[0], r.size());
+       }
+   tNew = Now() - t0;
+
+   double mb = (double)totBytes / reqs.size() * iters / (1024.0*1024.0);
+   printf("%lu requests, %ld iterations (%ld headers matched)\n",
+          (unsigned long)reqs.size(), iters, sink);
+   printf("copy+strcmp : %8.1f ns/req %8.1f MB/s\n", tOld*1e9/iters, mb/tOld);
+   printf("in place    : %8.1f ns/req %8.1f MB/s\n", tNew*1e9/iters, mb/tNew);
+   return 0;
+}
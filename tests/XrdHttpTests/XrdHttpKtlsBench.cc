@@ -0,0 +1,258 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+/** @file  XrdHttpKtlsBench.cc
+ * @brief  Loopback throughput of a TLS file transfer, done as XrdHttp does
+ *         it: pread()+SSL_write() in user space, or sendfile() on a socket
+ *         whose encryption was offloaded to the kernel (http.ktls)
+ *
+ * Usage: xrdhttp-ktlsbench [-s <MB>] [-b <KB>] [-2]
+ *
+ * -s is the amount of data to transfer (default 256MB), -b the size of the
+ * reads/sendfile calls (default 1024KB, as XrdHttp does) and -2 restricts
+ * the connection to TLS 1.2. The kernel TLS run is reported as unavailable
+ * when the OpenSSL build, the kernel (tls module) or the cipher cannot do it.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+namespace
+{
+long long   xferSize = 256LL*1024*1024;
+int         blkSize  = 1024*1024;
+bool        tls12    = false;
+int         dataFD   = -1;
+int         cliPort  = 0;
+long long   cliBytes = 0;
+
+double Now()
+{
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+void Fatal(const char *what)
+{
+   fprintf(stderr, "ktlsbench: %s failed; %s\n", what, strerror(errno));
+   ERR_print_errors_fp(stderr);
+   exit(1);
+}
+
+/******************************************************************************/
+/*                    S e l f   S i g n e d   C r e d s                       */
+/******************************************************************************/
+
+void MakeCreds(SSL_CTX *ctx)
+{
+   EVP_PKEY *pkey = 0;
+   EVP_PKEY_CTX *kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, 0);
+
+   if (!kctx || EVP_PKEY_keygen_init(kctx) <= 0
+   ||  EVP_PKEY_CTX_set_ec_paramgen_curve_nid(kctx, NID_X9_62_prime256v1) <= 0
+   ||  EVP_PKEY_keygen(kctx, &pkey) <= 0) Fatal("key generation");
+   EVP_PKEY_CTX_free(kctx);
+
+   X509 *x509 = X509_new();
+   ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+   X509_gmtime_adj(X509_get_notBefore(x509), 0);
+   X509_gmtime_adj(X509_get_notAfter(x509), 3600);
+   X509_set_pubkey(x509, pkey);
+   X509_NAME *name = X509_get_subject_name(x509);
+   X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                              (const unsigned char *)"localhost", -1, -1, 0);
+   X509_set_issuer_name(x509, name);
+   if (!X509_sign(x509, pkey, EVP_sha256())) Fatal("certificate signing");
+
+   if (SSL_CTX_use_certificate(ctx, x509) <= 0
+   ||  SSL_CTX_use_PrivateKey(ctx, pkey) <= 0) Fatal("credentials setup");
+   X509_free(x509);
+   EVP_PKEY_free(pkey);
+}
+
+/******************************************************************************/
+/*                                C l i e n t                                 */
+/******************************************************************************/
+
+void *Client(void *)
+{
+   SSL_CTX *ctx = SSL_CTX_new(SSLv23_client_method());
+   SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, 0);
+
+   int sfd = socket(AF_INET, SOCK_STREAM, 0);
+   struct sockaddr_in sa;
+   memset(&sa, 0, sizeof(sa));
+   sa.sin_family = AF_INET;
+   sa.sin_port = htons(cliPort);
+   sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   if (connect(sfd, (struct sockaddr *)&sa, sizeof(sa))) Fatal("connect");
+
+   SSL *ssl = SSL_new(ctx);
+   SSL_set_fd(ssl, sfd);
+   if (SSL_connect(ssl) <= 0) Fatal("SSL_connect");
+
+   char *buff = (char *)malloc(blkSize);
+   int n;
+   cliBytes = 0;
+   while(cliBytes < xferSize && (n = SSL_read(ssl, buff, blkSize)) > 0)
+        cliBytes += n;
+
+   free(buff);
+   SSL_free(ssl);
+   close(sfd);
+   SSL_CTX_free(ctx);
+   return 0;
+}
+
+/******************************************************************************/
+/*                                S e r v e r                                 */
+/******************************************************************************/
+
+// Returns the throughput in MB/s, 0 if kernel TLS was asked but unavailable
+
+double Run(bool useKtls)
+{
+   SSL_CTX *ctx = SSL_CTX_new(SSLv23_server_method());
+   MakeCreds(ctx);
+   if (tls12) SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1_3);
+#ifdef SSL_OP_ENABLE_KTLS
+   if (useKtls) SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
+   int lfd = socket(AF_INET, SOCK_STREAM, 0), one = 1;
+   setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+   struct sockaddr_in sa;
+   socklen_t slen = sizeof(sa);
+   memset(&sa, 0, sizeof(sa));
+   sa.sin_family = AF_INET;
+   sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   if (bind(lfd, (struct sockaddr *)&sa, sizeof(sa)) || listen(lfd, 1)
+   ||  getsockname(lfd, (struct sockaddr *)&sa, &slen)) Fatal("listen");
+   cliPort = ntohs(sa.sin_port);
+
+   pthread_t tid;
+   pthread_create(&tid, 0, Client, 0);
+
+   int sfd = accept(lfd, 0, 0);
+   if (sfd < 0) Fatal("accept");
+   SSL *ssl = SSL_new(ctx);
+   SSL_set_fd(ssl, sfd);
+   if (SSL_accept(ssl) <= 0) Fatal("SSL_accept");
+
+   bool ktlsOn = false;
+#ifdef SSL_OP_ENABLE_KTLS
+   ktlsOn = (BIO_get_ktls_send(SSL_get_wbio(ssl)) > 0);
+#endif
+
+   double t0 = Now();
+   long long done = 0;
+   if (useKtls && ktlsOn)
+      {off_t off = 0;
+       while(done < xferSize)
+            {ssize_t n = sendfile(sfd, dataFD, &off, blkSize);
+             if (n <= 0) Fatal("sendfile");
+             done += n;
+            }
+      } else if (!useKtls) {
+       char *buff = (char *)malloc(blkSize);
+       while(done < xferSize)
+            {ssize_t n = pread(dataFD, buff, blkSize, done);
+             if (n <= 0 || SSL_write(ssl, buff, n) != n) Fatal("pread/SSL_write");
+             done += n;
+            }
+       free(buff);
+      }
+   if (done < xferSize) shutdown(sfd, SHUT_WR);
+   pthread_join(tid, 0);
+   double dt = Now() - t0;
+
+   SSL_free(ssl);
+   close(sfd);
+   close(lfd);
+   SSL_CTX_free(ctx);
+
+   if (useKtls && !ktlsOn) return 0;
+   return (cliBytes / (1024.0*1024.0)) / dt;
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char **argv)
+{
+   char path[] = "/tmp/xrdhttp-ktlsbench.XXXXXX";
+   int c;
+
+   while ((c = getopt(argc, argv, "s:b:2")) != -1)
+         {switch(c)
+                {case 's': xferSize = atoll(optarg)*1024*1024; break;
+                 case 'b': blkSize  = atoi(optarg)*1024;       break;
+                 case '2': tls12    = true;                    break;
+                 default:  fprintf(stderr, "Usage: xrdhttp-ktlsbench "
+                                           "[-s <MB>] [-b <KB>] [-2]\n");
+                           return 1;
+                }
+         }
+   if (xferSize <= 0 || blkSize <= 0) {fprintf(stderr, "Invalid sizes\n"); return 1;}
+
+   SSL_library_init();
+   SSL_load_error_strings();
+
+// Prepare the file to send
+//
+   if ((dataFD = mkstemp(path)) < 0) Fatal("mkstemp");
+   unlink(path);
+   char *buff = (char *)malloc(blkSize);
+   for (int i = 0; i < blkSize; i++) buff[i] = (char)(i * 131);
+   for (long long done = 0; done < xferSize; done += blkSize)
+       if (write(dataFD, buff, blkSize) != blkSize) Fatal("write");
+   free(buff);
+
+   printf("%lld MB over loopback in %d KB blocks%s\n", xferSize/(1024*1024),
+          blkSize/1024, (tls12 ? ", TLS 1.2" : ""));
+
+   double mbs = Run(false);
+   printf("pread+SSL_write     : %8.1f MB/s\n", mbs);
+
+   mbs = Run(true);
+   if (mbs > 0) printf("kernel TLS sendfile : %8.1f MB/s\n", mbs);
+      else      printf("kernel TLS sendfile : not available (OpenSSL, kernel or cipher)\n");
+
+   close(dataFD);
+   return 0;
+}
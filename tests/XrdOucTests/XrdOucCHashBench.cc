@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Look up keys in a table from many threads at once, the way the security and
+// authorization caches do, and report the lookup rate and latency of
+//
+//   hash  - XrdOucHash<long> protected by a mutex (how it is used today)
+//   rash  - XrdOucRash<int,long> protected by a mutex (integer keys)
+//   chash - XrdOucCHash<long>
+//
+// Usage: xrdouc-chash-bench [-m hash|rash|chash] [-t <threads>]
+//                           [-n <operations per thread>] [-k <keys>]
+//                           [-u <update percent>] [-l <lifetime>]
+//
+// Without -m all three are run. With -u that share of the operations replaces
+// the key's item instead of looking it up, with -l items are added with that
+// lifetime in seconds.
+//------------------------------------------------------------------------------
+
+#include "BenchUtils.hh"
+#include "XrdOuc/XrdOucCHash.hh"
+#include "XrdOuc/XrdOucHash.hh"
+#include "XrdOuc/XrdOucRash.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Settings and per thread state
+  //----------------------------------------------------------------------------
+  enum Mode { mHash, mRash, mCHash };
+
+  int         nThreads = 8;
+  long        nOps     = 200000;
+  int         nKeys    = 10000;
+  int         upPct    = 0;
+  int         lifeTime = 0;
+  Mode        mode     = mHash;
+
+  std::vector<std::string> keys;
+  std::vector<long>        vals;   // items point here, it never changes
+
+  XrdSysMutex                 tabMutex;
+  XrdOucHash<long>           *hashTab  = 0;
+  XrdOucRash<int, long>      *rashTab  = 0;
+  XrdOucCHash<long>          *chashTab = 0;
+
+  struct Worker: public XrdBench::Worker
+  {
+    Worker(): misses( 0 ) {}
+    long misses;
+  };
+
+  //----------------------------------------------------------------------------
+  // One lookup (returns the value or -1) and one update
+  //----------------------------------------------------------------------------
+  inline long Lookup( int i )
+  {
+    long *vp, v = -1;
+    switch( mode )
+    {
+      case mHash:
+        tabMutex.Lock();
+        if( ( vp = hashTab->Find( keys[i].c_str() ) ) ) v = *vp;
+        tabMutex.UnLock();
+        break;
+      case mRash:
+        tabMutex.Lock();
+        if( ( vp = rashTab->Find( i ) ) ) v = *vp;
+        tabMutex.UnLock();
+        break;
+      case mCHash:
+        if( ( vp = chashTab->Find( keys[i].c_str() ) ) ) v = *vp;
+        break;
+    }
+    return v;
+  }
+
+  inline void Update( int i )
+  {
+    switch( mode )
+    {
+      case mHash:
+        tabMutex.Lock();
+        hashTab->Rep( keys[i].c_str(), &vals[i], lifeTime, Hash_keepdata );
+        tabMutex.UnLock();
+        break;
+      case mRash:
+        tabMutex.Lock();
+        rashTab->Rep( i, vals[i], lifeTime );
+        tabMutex.UnLock();
+        break;
+      case mCHash:
+        chashTab->Rep( keys[i].c_str(), &vals[i], lifeTime, Hash_keepdata );
+        break;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Do the operations
+  //----------------------------------------------------------------------------
+  void *Run( void *arg )
+  {
+    Worker *w = (Worker*)arg;
+    w->latency.reserve( nOps );
+    for( long n = 0; n < nOps; ++n )
+    {
+      uint64_t r  = XrdBench::Next( w->seed );
+      int      i  = r % nKeys;
+      bool     up = upPct && int( ( r >> 32 ) % 100 ) < upPct;
+      long     v  = 0;
+
+      uint64_t start = XrdBench::Now();
+      if( up ) Update( i );
+        else v = Lookup( i );
+      XrdBench::Record( w->latency, start );
+
+      if( up ) continue;
+      if( v < 0 ) ++w->misses;
+        else if( v != i ) ++w->errors;
+    }
+    return 0;
+  }
+
+  void Usage( const char *prog )
+  {
+    XrdBench::Usage( prog, "[-m hash|rash|chash] [-t <threads>] "
+                     "[-n <operations per thread>] [-k <keys>] "
+                     "[-u <update percent>] [-l <lifetime>]" );
+  }
+
+  //----------------------------------------------------------------------------
+  // Fill the table, run the threads and report
+  //----------------------------------------------------------------------------
+  long Bench( Mode m )
+  {
+    static const char *names[] = { "XrdOucHash+mutex", "XrdOucRash+mutex",
+                                   "XrdOucCHash" };
+    mode = m;
+    switch( mode )
+    {
+      case mHash:  hashTab  = new XrdOucHash<long>();        break;
+      case mRash:  rashTab  = new XrdOucRash<int, long>();   break;
+      case mCHash: chashTab = new XrdOucCHash<long>();       break;
+    }
+    for( int i = 0; i < nKeys; ++i ) Update( i );
+
+    std::vector<Worker> workers( nThreads );
+    double elapsed = XrdBench::Run( workers, Run );
+
+    std::vector<uint32_t> all;
+    long misses = 0, errors = XrdBench::Collect( workers, all );
+    for( int i = 0; i < nThreads; ++i )
+      misses += workers[i].misses;
+
+    printf( "%-17s %10.0f ops/s, %s\n", names[m], all.size() / elapsed,
+            XrdBench::Percentiles( all ).c_str() );
+    if( misses )
+      printf( "%-17s %ld lookups found no item\n", "", misses );
+    if( errors )
+      printf( "%-17s %ld lookups returned the wrong item\n", "", errors );
+
+    delete hashTab;  hashTab  = 0;
+    delete rashTab;  rashTab  = 0;
+    delete chashTab; chashTab = 0;
+    return errors;
+  }
+}
+
+int main( int argc, char **argv )
+{
+  const char *which = 0;
+  int opt;
+  while( ( opt = getopt( argc, argv, "m:t:n:k:u:l:" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 'm': which    = optarg;                          break;
+      case 't': nThreads = atoi( optarg );                  break;
+      case 'n': nOps     = atol( optarg );                  break;
+      case 'k': nKeys    = atoi( optarg );                  break;
+      case 'u': upPct    = atoi( optarg );                  break;
+      case 'l': lifeTime = atoi( optarg );                  break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( nThreads < 1 || nOps < 1 || nKeys < 1 || upPct < 0 || upPct > 100 ||
+      lifeTime < 0 || ( which && strcmp( which, "hash" ) &&
+      strcmp( which, "rash" ) && strcmp( which, "chash" ) ) )
+    Usage( argv[0] );
+
+  char buff[32];
+  for( int i = 0; i < nKeys; ++i )
+  {
+    snprintf( buff, sizeof( buff ), "/user/%08x", i * 2654435761U );
+    keys.push_back( buff );
+    vals.push_back( i );
+  }
+
+  printf( "%d threads, %d keys, %d%% updates, %s\n", nThreads, nKeys, upPct,
+          lifeTime ? "items expire" : "items do not expire" );
+
+  long errors = 0;
+  if( !which || !strcmp( which, "hash" ) )  errors += Bench( mHash );
+  if( !which || !strcmp( which, "rash" ) )  errors += Bench( mRash );
+  if( !which || !strcmp( which, "chash" ) ) errors += Bench( mCHash );
+  return errors ? 1 : 0;
+}
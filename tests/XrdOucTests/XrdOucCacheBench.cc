@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Read through the XrdPosix RAM cache (XrdOucCacheDram) from many threads
+// at once and report the hit rate and the latency of the reads.
+//
+// Usage: xrdouc-cache-bench [-t <threads>] [-n <reads per thread>]
+//                           [-c <cache MB>] [-f <file MB>] [-p <page KB>]
+//                           [-r <read bytes>] [-h <hot %>] [-d <miss us>]
+//                           [-s] [-m]
+//
+// The files live in memory, every word of them holds its own offset so that
+// the data the cache returns can be checked. By default all the threads read
+// the same file, with -s every thread reads a file of its own. Nine reads out
+// of ten go to the hot part of the file, -h percent of it (default 10). With
+// -d every page that has to be fetched from the file takes that many extra
+// microseconds, -m tells the cache that it runs in a server.
+//------------------------------------------------------------------------------
+
+#include "BenchUtils.hh"
+#include "XrdOuc/XrdOucCache.hh"
+#include "XrdOuc/XrdOucCacheDram.hh"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // A file in memory
+  //----------------------------------------------------------------------------
+  class MemIO: public XrdOucCacheIO
+  {
+    public:
+      MemIO( long long size, int delay ): pSize( size ), pDelay( delay ) {}
+      virtual ~MemIO() {}
+
+      virtual long long   FSize() { return pSize; }
+      virtual const char *Path()  { return "membench"; }
+      virtual int         Sync()  { return 0; }
+      virtual int         Trunc( long long ) { return -EROFS; }
+      virtual int         Write( char *, long long, int ) { return -EROFS; }
+
+      virtual int Read( char *buffer, long long offset, int length )
+      {
+        if( offset >= pSize ) return 0;
+        if( offset + length > pSize ) length = pSize - offset;
+        if( pDelay ) usleep( pDelay );
+        long long *words = (long long*)buffer;
+        for( int i = 0; i < length / 8; ++i )
+          words[i] = offset + i * 8;
+        return length;
+      }
+
+    private:
+      long long pSize;
+      int       pDelay;
+  };
+
+  //----------------------------------------------------------------------------
+  // Settings and per thread state
+  //----------------------------------------------------------------------------
+  int       nThreads  = 8;
+  long      nReads    = 200000;
+  long long cacheSize = 64LL << 20;
+  long long fileSize  = 256LL << 20;
+  int       pageSize  = 32768;
+  int       readSize  = 4096;
+  int       hotPct    = 10;
+  int       missDelay = 0;
+  bool      separate  = false;
+  bool      server    = false;
+
+  struct Worker: public XrdBench::Worker
+  {
+    Worker(): io( 0 ) {}
+    XrdOucCacheIO *io;
+  };
+
+  //----------------------------------------------------------------------------
+  // Do the reads
+  //----------------------------------------------------------------------------
+  void *Run( void *arg )
+  {
+    Worker    *w      = (Worker*)arg;
+    char      *buffer = new char[readSize];
+    long long  blocks = fileSize / readSize;
+    long long  hot    = blocks * hotPct / 100;
+    if( hot < 1 ) hot = 1;
+
+    w->latency.reserve( nReads );
+    for( long i = 0; i < nReads; ++i )
+    {
+      uint64_t  r      = XrdBench::Next( w->seed );
+      long long block  = ( r % 10 ) ? ( r >> 8 ) % hot : ( r >> 8 ) % blocks;
+      long long offset = block * readSize;
+
+      uint64_t start = XrdBench::Now();
+      int      rc    = w->io->Read( buffer, offset, readSize );
+      XrdBench::Record( w->latency, start );
+
+      if( rc != readSize || *(long long*)buffer != offset ||
+          *(long long*)( buffer + readSize - 8 ) != offset + readSize - 8 )
+        ++w->errors;
+    }
+    delete [] buffer;
+    return 0;
+  }
+
+  void Usage( const char *prog )
+  {
+    XrdBench::Usage( prog, "[-t <threads>] [-n <reads per thread>] "
+                     "[-c <cache MB>] [-f <file MB>] [-p <page KB>] "
+                     "[-r <read bytes>] [-h <hot %>] [-d <miss us>] [-s] [-m]" );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  int opt;
+  while( ( opt = getopt( argc, argv, "t:n:c:f:p:r:h:d:sm" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 't': nThreads  = atoi( optarg );                  break;
+      case 'n': nReads    = atol( optarg );                  break;
+      case 'c': cacheSize = atoll( optarg ) << 20;           break;
+      case 'f': fileSize  = atoll( optarg ) << 20;           break;
+      case 'p': pageSize  = atoi( optarg ) << 10;            break;
+      case 'r': readSize  = atoi( optarg );                  break;
+      case 'h': hotPct    = atoi( optarg );                  break;
+      case 'd': missDelay = atoi( optarg );                  break;
+      case 's': separate  = true;                            break;
+      case 'm': server    = true;                            break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( nThreads < 1 || nReads < 1 || readSize < 8 || readSize % 8 ||
+      readSize > pageSize || fileSize < readSize || hotPct < 1 ||
+      hotPct > 100 )
+    Usage( argv[0] );
+
+  //----------------------------------------------------------------------------
+  // Create the cache the way XrdPosix does
+  //----------------------------------------------------------------------------
+  XrdOucCacheDram    dram;
+  XrdOucCache::Parms parms;
+  parms.CacheSize = cacheSize;
+  parms.PageSize  = pageSize;
+  parms.Max2Cache = pageSize;
+  parms.Options   = XrdOucCache::Serialized | XrdOucCache::ioMTSafe;
+  if( server ) parms.Options |= XrdOucCache::isServer;
+
+  XrdOucCache *cache = dram.Create( parms );
+  if( !cache )
+  {
+    fprintf( stderr, "Unable to create the cache: %s\n", strerror( errno ) );
+    return 1;
+  }
+
+  std::vector<MemIO*>         files;
+  std::vector<XrdOucCacheIO*> cached;
+  for( int i = 0; i < ( separate ? nThreads : 1 ); ++i )
+  {
+    files.push_back( new MemIO( fileSize, missDelay ) );
+    cached.push_back( cache->Attach( files.back() ) );
+    if( cached.back() == files.back() )
+    {
+      fprintf( stderr, "Unable to attach: %s\n", strerror( errno ) );
+      return 1;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Run
+  //----------------------------------------------------------------------------
+  std::vector<Worker> workers( nThreads );
+  for( int i = 0; i < nThreads; ++i )
+    workers[i].io = cached[separate ? i : 0];
+  double elapsed = XrdBench::Run( workers, Run );
+
+  //----------------------------------------------------------------------------
+  // Report
+  //----------------------------------------------------------------------------
+  std::vector<uint32_t> all;
+  long errors = XrdBench::Collect( workers, all );
+
+  long long hits = 0, miss = 0;
+  for( size_t i = 0; i < cached.size(); ++i )
+  {
+    hits += cached[i]->Statistics.Hits;
+    miss += cached[i]->Statistics.Miss;
+  }
+
+  printf( "%d threads, %s, %lld MB cache, %lld MB file(s), %d KB pages, "
+          "%d byte reads\n", nThreads, separate ? "own files" : "one file",
+          cacheSize >> 20, fileSize >> 20, pageSize >> 10, readSize );
+  printf( "%.0f reads/s, hit rate %.2f%%, %s\n", all.size() / elapsed,
+          hits + miss ? 100.0 * hits / ( hits + miss ) : 0.0,
+          XrdBench::Percentiles( all ).c_str() );
+  if( errors )
+    printf( "%ld reads returned wrong data\n", errors );
+
+  for( size_t i = 0; i < cached.size(); ++i )
+  {
+    cached[i]->Detach();
+    delete files[i];
+  }
+  delete cache;
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Sign write requests with the request protection (XrdSecProtect) the way
+// the client does and verify them the way the server does, report the
+// latency of both ends and the signed bytes per second.
+//
+// Usage: xrdsec-sign-bench [-n <requests>] [-m <MB per size>] [-d] [-a]
+//                          [-s <size>[,<size>...]]
+//
+// The protector is loaded from libXrdSecProt like in the server, the session
+// key is an aes-128-cbc key with a random IV per message, like gsi does it.
+// The write payload is signed only with -d (level ... data), with -a the
+// server offers the keyed hash (level ... hmac). For every size at most -n
+// requests are signed and at most -m MB of payload.
+//------------------------------------------------------------------------------
+
+#include "BenchUtils.hh"
+#include "XProtocol/XProtocol.hh"
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdSec/XrdSecInterface.hh"
+#include "XrdSec/XrdSecLoadSecurity.hh"
+#include "XrdSec/XrdSecProtect.hh"
+#include "XrdSec/XrdSecProtector.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+extern XrdSecProtector *XrdSecLoadProtection( XrdSysError &erP );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // An authentication protocol that only knows the session key
+  //----------------------------------------------------------------------------
+  class KeyProt: public XrdSecProtocol
+  {
+    public:
+      KeyProt( const unsigned char *key ): XrdSecProtocol( "bench" )
+      {
+        memcpy( pKey, key, sizeof( pKey ) );
+      }
+      virtual ~KeyProt() {}
+
+      virtual int Authenticate( XrdSecCredentials*, XrdSecParameters**,
+                                XrdOucErrInfo* ) { return 0; }
+      virtual XrdSecCredentials *getCredentials( XrdSecParameters*,
+                                                 XrdOucErrInfo* ) { return 0; }
+      virtual void Delete() { delete this; }
+
+      virtual int getKey( char *buff, int size )
+      {
+        if( buff && size >= (int)sizeof( pKey ) )
+          memcpy( buff, pKey, sizeof( pKey ) );
+        return sizeof( pKey );
+      }
+
+      virtual int Encrypt( const char *inbuff, int inlen,
+                           XrdSecBuffer **outbuff )
+      {
+        char *out = (char*)malloc( inlen + 2 * 16 );
+        int   len, fin;
+        RAND_bytes( (unsigned char*)out, 16 );
+        EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+        EVP_EncryptInit_ex( ctx, EVP_aes_128_cbc(), 0, pKey,
+                            (unsigned char*)out );
+        EVP_EncryptUpdate( ctx, (unsigned char*)out + 16, &len,
+                           (const unsigned char*)inbuff, inlen );
+        EVP_EncryptFinal_ex( ctx, (unsigned char*)out + 16 + len, &fin );
+        EVP_CIPHER_CTX_free( ctx );
+        *outbuff = new XrdSecBuffer( out, 16 + len + fin );
+        return 0;
+      }
+
+      virtual int Decrypt( const char *inbuff, int inlen,
+                           XrdSecBuffer **outbuff )
+      {
+        if( inlen <= 16 ) return -EINVAL;
+        char *out = (char*)malloc( inlen );
+        int   len, fin, ok;
+        EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+        EVP_DecryptInit_ex( ctx, EVP_aes_128_cbc(), 0, pKey,
+                            (const unsigned char*)inbuff );
+        EVP_DecryptUpdate( ctx, (unsigned char*)out, &len,
+                           (const unsigned char*)inbuff + 16, inlen - 16 );
+        ok = EVP_DecryptFinal_ex( ctx, (unsigned char*)out + len, &fin );
+        EVP_CIPHER_CTX_free( ctx );
+        if( !ok ) { free( out ); return -EINVAL; }
+        *outbuff = new XrdSecBuffer( out, len + fin );
+        return 0;
+      }
+
+    private:
+      unsigned char pKey[16];
+  };
+
+  double Pct( std::vector<uint32_t> &v, int pct )
+  {
+    return v[std::min( v.size() - 1, v.size() * pct / 100 )] / 1e3;
+  }
+
+  void Usage( const char *prog )
+  {
+    XrdBench::Usage( prog, "[-n <requests>] [-m <MB per size>] [-d] [-a] "
+                     "[-s <size>[,<size>...]]" );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  long              nReqs  = 100000;
+  long long         maxMB  = 1024;
+  bool              doData = false;
+  bool              doHmac = false;
+  std::vector<long> sizes;
+  int               opt;
+  char             *sp, *ep;
+
+  while( ( opt = getopt( argc, argv, "n:m:das:" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 'n': nReqs  = atol( optarg );                    break;
+      case 'm': maxMB  = atoll( optarg );                   break;
+      case 'd': doData = true;                              break;
+      case 'a': doHmac = true;                              break;
+      case 's': for( sp = optarg; *sp; sp = ( *ep ? ep + 1 : ep ) )
+                {
+                  sizes.push_back( strtol( sp, &ep, 10 ) );
+                  if( ep == sp || ( *ep && *ep != ',' ) ) Usage( argv[0] );
+                }
+                break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( nReqs < 1 || maxMB < 1 ) Usage( argv[0] );
+  if( sizes.empty() )
+  {
+    long defSizes[] = { 0, 4096, 65536, 1048576, 8388608 };
+    sizes.assign( defSizes, defSizes + 5 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Configure the server side and get the client its protocol response
+  //----------------------------------------------------------------------------
+  XrdSysLogger logger;
+  XrdSysError  eDest( &logger, "bench_" );
+  XrdSecProtector *protector = XrdSecLoadProtection( eDest );
+  if( !protector )
+  {
+    fprintf( stderr, "Unable to load the protection library\n" );
+    return 1;
+  }
+
+  XrdSecProtectParms parms;
+  parms.level = XrdSecProtectParms::secIntense;
+  if( doData ) parms.opts |= XrdSecProtectParms::doData;
+  if( doHmac ) parms.opts |= XrdSecProtectParms::doHmac;
+  if( !protector->Config( parms, parms, logger ) )
+  {
+    fprintf( stderr, "Unable to configure the protection\n" );
+    return 1;
+  }
+
+  ServerResponseBody_Protocol resp;
+  XrdNetAddr                  client;
+  memset( &resp, 0, sizeof( resp ) );
+  int rlen = protector->ProtResp( resp.secreq, client, kXR_PROTOCOLVERSION );
+
+  unsigned char key[16];
+  RAND_bytes( key, sizeof( key ) );
+  KeyProt clientProt( key ), serverProt( key );
+
+  XrdSecProtect *signer = 0;
+  if( XrdSecGetProtection( signer, clientProt, resp,
+                           rlen + kXR_ShortProtRespLen ) <= 0 || !signer )
+  {
+    fprintf( stderr, "The client did not get a protection object\n" );
+    return 1;
+  }
+  XrdSecProtect *verifier = protector->New4Server( serverProt,
+                                                   kXR_PROTOCOLVERSION );
+  if( !verifier )
+  {
+    fprintf( stderr, "The server did not get a protection object\n" );
+    return 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Sign and verify
+  //----------------------------------------------------------------------------
+  printf( "intense level, %s, %s\n",
+          doData ? "write data signed" : "write data not signed",
+          doHmac ? "hmac offered" : "hash + session key" );
+  printf( "%10s %8s %10s %10s %10s %10s %10s %10s\n", "bytes", "requests",
+          "sign p50", "sign p99", "verify p50", "verify p99", "sign MB/s",
+          "verify MB/s" );
+
+  long errors = 0;
+  for( size_t s = 0; s < sizes.size(); ++s )
+  {
+    long  size = sizes[s];
+    long  n    = nReqs;
+    if( size && n > ( maxMB << 20 ) / size ) n = ( maxMB << 20 ) / size;
+    if( n < 1 ) n = 1;
+
+    char *buff = (char*)malloc( sizeof( ClientRequest ) + size );
+    ClientRequest *req = (ClientRequest*)buff;
+    memset( req, 0, sizeof( ClientRequest ) );
+    for( long i = 0; i < size; ++i )
+      buff[sizeof( ClientRequest ) + i] = (char)( i * 131 );
+    req->write.requestid = htons( kXR_write );
+    req->write.dlen      = htonl( size );
+
+    std::vector<uint32_t> signLat, verLat;
+    signLat.reserve( n );
+    verLat.reserve( n );
+    uint64_t signTotal = 0, verTotal = 0;
+
+    for( long i = 0; i < n; ++i )
+    {
+      SecurityRequest *sig = 0;
+      req->write.streamid[0] = (kXR_char)i;
+      req->write.offset      = htonll( (kXR_int64)i * size );
+
+      uint64_t t0 = XrdBench::Now();
+      int rc = NEED2SECURE( signer )( *req ) ?
+                 signer->Secure( sig, *req, 0 ) : 0;
+      uint64_t t1 = XrdBench::Now();
+      if( rc <= 0 ) { ++errors; continue; }
+
+      const char *eText = verifier->Verify( *sig, *req,
+                                            buff + sizeof( ClientRequest ) );
+      uint64_t t2 = XrdBench::Now();
+      if( eText )
+      {
+        if( !errors ) fprintf( stderr, "Verify: %s\n", eText );
+        ++errors;
+      }
+      free( sig );
+
+      signLat.push_back( uint32_t( t1 - t0 ) );
+      verLat.push_back( uint32_t( t2 - t1 ) );
+      signTotal += t1 - t0;
+      verTotal  += t2 - t1;
+    }
+    free( buff );
+    if( signLat.empty() ) continue;
+
+    std::sort( signLat.begin(), signLat.end() );
+    std::sort( verLat.begin(), verLat.end() );
+    double bytes = doData ? double( size ) * signLat.size() : 0;
+    printf( "%10ld %8zu %10.2f %10.2f %10.2f %10.2f %10.1f %10.1f\n", size,
+            signLat.size(), Pct( signLat, 50 ), Pct( signLat, 99 ),
+            Pct( verLat, 50 ), Pct( verLat, 99 ),
+            bytes / 1048576 / ( signTotal / 1e9 ),
+            bytes / 1048576 / ( verTotal / 1e9 ) );
+  }
+  printf( "latency in us\n" );
+  if( errors )
+    printf( "%ld requests failed\n", errors );
+
+  signer->Delete();
+  verifier->Delete();
+  return errors ? 1 : 0;
+}
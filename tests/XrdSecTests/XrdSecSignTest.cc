@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Sign requests with the keyed hash (level ... hmac) the way the client does
+// and check that the server accepts them, and that it rejects
+//
+//   - a request whose payload, header or signature was changed
+//   - a keyed signature before the key was sent (kXR_hmackey missing)
+//   - a second key once one was accepted, which then stays in use
+//   - a replayed request
+//   - a keyed signature when the server did not offer the keyed hash
+//
+// Usage: xrdsec-sign-test
+//
+// The protector is loaded from libXrdSecProt like in the server, the session
+// key is an aes-128-cbc key with a random IV per message, like gsi does it.
+//------------------------------------------------------------------------------
+
+#include "XProtocol/XProtocol.hh"
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdSec/XrdSecInterface.hh"
+#include "XrdSec/XrdSecLoadSecurity.hh"
+#include "XrdSec/XrdSecProtect.hh"
+#include "XrdSec/XrdSecProtector.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+extern XrdSecProtector *XrdSecLoadProtection( XrdSysError &erP );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // An authentication protocol that only knows the session key
+  //----------------------------------------------------------------------------
+  class KeyProt: public XrdSecProtocol
+  {
+    public:
+      KeyProt( const unsigned char *key ): XrdSecProtocol( "test" )
+      {
+        memcpy( pKey, key, sizeof( pKey ) );
+      }
+      virtual ~KeyProt() {}
+
+      virtual int Authenticate( XrdSecCredentials*, XrdSecParameters**,
+                                XrdOucErrInfo* ) { return 0; }
+      virtual XrdSecCredentials *getCredentials( XrdSecParameters*,
+                                                 XrdOucErrInfo* ) { return 0; }
+      virtual void Delete() { delete this; }
+
+      virtual int getKey( char *buff, int size )
+      {
+        if( buff && size >= (int)sizeof( pKey ) )
+          memcpy( buff, pKey, sizeof( pKey ) );
+        return sizeof( pKey );
+      }
+
+      virtual int Encrypt( const char *inbuff, int inlen,
+                           XrdSecBuffer **outbuff )
+      {
+        char *out = (char*)malloc( inlen + 2 * 16 );
+        int   len, fin;
+        RAND_bytes( (unsigned char*)out, 16 );
+        EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+        EVP_EncryptInit_ex( ctx, EVP_aes_128_cbc(), 0, pKey,
+                            (unsigned char*)out );
+        EVP_EncryptUpdate( ctx, (unsigned char*)out + 16, &len,
+                           (const unsigned char*)inbuff, inlen );
+        EVP_EncryptFinal_ex( ctx, (unsigned char*)out + 16 + len, &fin );
+        EVP_CIPHER_CTX_free( ctx );
+        *outbuff = new XrdSecBuffer( out, 16 + len + fin );
+        return 0;
+      }
+
+      virtual int Decrypt( const char *inbuff, int inlen,
+                           XrdSecBuffer **outbuff )
+      {
+        if( inlen <= 16 ) return -EINVAL;
+        char *out = (char*)malloc( inlen );
+        int   len, fin, ok;
+        EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+        EVP_DecryptInit_ex( ctx, EVP_aes_128_cbc(), 0, pKey,
+                            (const unsigned char*)inbuff );
+        EVP_DecryptUpdate( ctx, (unsigned char*)out, &len,
+                           (const unsigned char*)inbuff + 16, inlen - 16 );
+        ok = EVP_DecryptFinal_ex( ctx, (unsigned char*)out + len, &fin );
+        EVP_CIPHER_CTX_free( ctx );
+        if( !ok ) { free( out ); return -EINVAL; }
+        *outbuff = new XrdSecBuffer( out, len + fin );
+        return 0;
+      }
+
+    private:
+      unsigned char pKey[16];
+  };
+
+  const int kPaySize = 1024;
+
+  int errors = 0;
+
+  void Fail( const std::string &test, const std::string &what )
+  {
+    fprintf( stderr, "%s: %s\n", test.c_str(), what.c_str() );
+    ++errors;
+  }
+
+  //----------------------------------------------------------------------------
+  // A signed write request with its payload
+  //----------------------------------------------------------------------------
+  struct Signed
+  {
+    Signed(): sig( 0 ), sigLen( 0 ) {}
+    ~Signed() { free( sig ); }
+
+    bool Sign( XrdSecProtect *signer, int n )
+    {
+      ClientRequest *req = (ClientRequest*)buff;
+      memset( buff, 0, sizeof( buff ) );
+      req->write.requestid   = htons( kXR_write );
+      req->write.dlen        = htonl( kPaySize );
+      req->write.streamid[0] = (kXR_char)n;
+      req->write.offset      = htonll( (kXR_int64)n * kPaySize );
+      for( int i = 0; i < kPaySize; ++i )
+        buff[sizeof( ClientRequest ) + i] = (char)( i * 131 + n );
+      free( sig );
+      sig    = 0;
+      sigLen = signer->Secure( sig, *req, 0 );
+      return sigLen > 0 && sig;
+    }
+
+    const char *Verify( XrdSecProtect *verifier )
+    {
+      return verifier->Verify( *sig, *(ClientRequest*)buff,
+                               buff + sizeof( ClientRequest ) );
+    }
+
+    unsigned char *Hash()
+    {
+      return (unsigned char*)sig + sizeof( SecurityRequest );
+    }
+
+    char             buff[sizeof( ClientRequest ) + kPaySize];
+    SecurityRequest *sig;
+    int              sigLen;
+  };
+
+  //----------------------------------------------------------------------------
+  // Configure the server, the options only ever add up
+  //----------------------------------------------------------------------------
+  XrdSysLogger     logger;
+  XrdSysError      eDest( &logger, "test_" );
+  XrdSecProtector *protector = 0;
+  unsigned char    sessionKey[16];
+
+  bool Configure( bool hmac )
+  {
+    XrdSecProtectParms parms;
+    parms.level = XrdSecProtectParms::secIntense;
+    parms.opts |= XrdSecProtectParms::doData;
+    if( hmac ) parms.opts |= XrdSecProtectParms::doHmac;
+    return protector->Config( parms, parms, logger );
+  }
+
+  XrdSecProtect *NewVerifier()
+  {
+    return protector->New4Server( *new KeyProt( sessionKey ),
+                                  kXR_PROTOCOLVERSION );
+  }
+
+  XrdSecProtect *NewSigner()
+  {
+    ServerResponseBody_Protocol resp;
+    XrdNetAddr                  client;
+    XrdSecProtect              *signer = 0;
+    memset( &resp, 0, sizeof( resp ) );
+    int rlen = protector->ProtResp( resp.secreq, client, kXR_PROTOCOLVERSION );
+    if( XrdSecGetProtection( signer, *new KeyProt( sessionKey ), resp,
+                             rlen + kXR_ShortProtRespLen ) <= 0 )
+      return 0;
+    return signer;
+  }
+
+  //----------------------------------------------------------------------------
+  // Expect a request to pass or to be rejected for the given reason
+  //----------------------------------------------------------------------------
+  void Accept( const std::string &test, Signed &req, XrdSecProtect *verifier )
+  {
+    const char *eText = req.Verify( verifier );
+    if( eText ) Fail( test, std::string( "rejected: " ) + eText );
+  }
+
+  void Reject( const std::string &test, Signed &req, XrdSecProtect *verifier,
+               const char *reason )
+  {
+    const char *eText = req.Verify( verifier );
+    if( !eText )
+      Fail( test, "accepted" );
+    else if( strcmp( eText, reason ) )
+      Fail( test, std::string( "rejected for '" ) + eText +
+                  "' instead of '" + reason + "'" );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  RAND_bytes( sessionKey, sizeof( sessionKey ) );
+  protector = XrdSecLoadProtection( eDest );
+  if( !protector )
+  {
+    fprintf( stderr, "Unable to load the protection library\n" );
+    return 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // A server that does not offer the keyed hash, then one that does
+  //----------------------------------------------------------------------------
+  XrdSecProtect *plain = 0;
+  if( Configure( false ) ) plain = NewVerifier();
+  if( !plain || !Configure( true ) )
+  {
+    fprintf( stderr, "Unable to configure the protection\n" );
+    return 1;
+  }
+
+  XrdSecProtect *signer   = NewSigner();
+  XrdSecProtect *verifier = NewVerifier();
+  if( !signer || !verifier )
+  {
+    fprintf( stderr, "Unable to get the protection objects\n" );
+    return 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // The first request carries the key
+  //----------------------------------------------------------------------------
+  Signed first, req;
+  if( !first.Sign( signer, 1 ) )
+  {
+    fprintf( stderr, "Unable to sign\n" );
+    return 1;
+  }
+  if( first.sig->sigver.crypto != kXR_HMAC256 ||
+      !( first.sig->sigver.flags & kXR_hmackey ) )
+    Fail( "first", "not signed with the keyed hash and the key" );
+
+  //----------------------------------------------------------------------------
+  // A server that did not offer the keyed hash does not take it
+  //----------------------------------------------------------------------------
+  Reject( "not offered", first, plain, "Unsupported signature hash" );
+
+  //----------------------------------------------------------------------------
+  // Without the key the keyed signature can't be checked
+  //----------------------------------------------------------------------------
+  {
+    XrdSecProtect *v = NewVerifier();
+    Signed noKey;
+    noKey.Sign( NewSigner(), 1 );
+    noKey.sig->sigver.flags &= ~kXR_hmackey;
+    noKey.sig->header.dlen   = htonl( 32 );
+    Reject( "missing key", noKey, v, "Missing signature key" );
+    v->Delete();
+  }
+
+  //----------------------------------------------------------------------------
+  // Changed payload in the request with the key, it is not taken
+  //----------------------------------------------------------------------------
+  {
+    XrdSecProtect *v = NewVerifier();
+    Signed changed;
+    changed.Sign( NewSigner(), 1 );
+    changed.buff[sizeof( ClientRequest ) + 7] ^= 0x01;
+    Reject( "first payload", changed, v, "Signature hash mismatch" );
+    changed.buff[sizeof( ClientRequest ) + 7] ^= 0x01;
+    Accept( "first payload", changed, v );
+    v->Delete();
+  }
+
+  //----------------------------------------------------------------------------
+  // Now for real
+  //----------------------------------------------------------------------------
+  Accept( "first", first, verifier );
+  Reject( "replay", first, verifier, "Incorrect signature sequence" );
+
+  req.Sign( signer, 2 );
+  if( req.sig->sigver.flags & kXR_hmackey )
+    Fail( "second", "the key was sent again" );
+  Accept( "second", req, verifier );
+
+  req.Sign( signer, 3 );
+  req.buff[sizeof( ClientRequest ) + kPaySize - 1] ^= 0x80;
+  Reject( "payload", req, verifier, "Signature hash mismatch" );
+
+  req.Sign( signer, 4 );
+  ((ClientRequest*)req.buff)->write.offset ^= 0x01;
+  Reject( "header", req, verifier, "Signature hash mismatch" );
+
+  req.Sign( signer, 5 );
+  req.Hash()[0] ^= 0x01;
+  Reject( "signature", req, verifier, "Signature hash mismatch" );
+
+  //----------------------------------------------------------------------------
+  // Another key is not taken, the first one stays in use
+  //----------------------------------------------------------------------------
+  {
+    Signed other;
+    other.Sign( NewSigner(), 1 );
+    other.sig->sigver.seqno = htonll( 100 );
+    Reject( "duplicate key", other, verifier, "Duplicate signature key" );
+  }
+
+  req.Sign( signer, 6 );
+  Accept( "after", req, verifier );
+
+  printf( "request signing: %d errors\n", errors );
+  return errors ? 1 : 0;
+}
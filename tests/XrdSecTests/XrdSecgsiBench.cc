@@ -0,0 +1,343 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Run gsi handshakes between a server and clients that keep reconnecting
+// with the same proxy, like the jobs of a batch farm, and report the
+// handshake rate and the cpu that the server spends on every handshake.
+//
+// Usage: xrdsecgsi-bench -d <CA dir> -c <server cert> -k <server key>
+//                        -p <user proxy> [-n <handshakes per client>]
+//                        [-t <clients>] [-o <server options>]
+//
+// The server runs in this process, every client in a process of its own
+// (the gsi library only does one side per process) and talks to the server
+// over a socket pair. gsi-bench.sh makes a CA and the certificates.
+//------------------------------------------------------------------------------
+
+#include "BenchUtils.hh"
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdOuc/XrdOucString.hh"
+#include "XrdSec/XrdSecInterface.hh"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  typedef char *(*Init_t)( const char, const char*, XrdOucErrInfo* );
+  typedef XrdSecProtocol *(*Object_t)( const char, const char*,
+                                       XrdNetAddrInfo&, const char*,
+                                       XrdOucErrInfo* );
+  Init_t   gsiInit;
+  Object_t gsiObject;
+
+  int  nShakes = 1000;
+  int  nClients = 1;
+
+  double CPU( int who )
+  {
+    struct rusage ru;
+    getrusage( who, &ru );
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+           ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+  }
+
+  //----------------------------------------------------------------------------
+  // Messages on the socket: status, length and the data
+  //----------------------------------------------------------------------------
+  bool Full( int fd, char *buff, int len, bool out )
+  {
+    while( len > 0 )
+    {
+      int n = out ? write( fd, buff, len ) : read( fd, buff, len );
+      if( n <= 0 ) { if( n < 0 && errno == EINTR ) continue; return false; }
+      buff += n; len -= n;
+    }
+    return true;
+  }
+
+  bool Send( int fd, int status, const char *data, int len )
+  {
+    int hdr[2] = { status, len };
+    return Full( fd, (char*)hdr, sizeof( hdr ), true ) &&
+           Full( fd, (char*)data, len, true );
+  }
+
+  bool Recv( int fd, int &status, char *&data, int &len )
+  {
+    int hdr[2];
+    if( !Full( fd, (char*)hdr, sizeof( hdr ), false ) ) return false;
+    status = hdr[0]; len = hdr[1];
+    data = (char*)malloc( len + 1 );
+    if( !Full( fd, data, len, false ) ) { free( data ); return false; }
+    data[len] = 0;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Server side of one client connection
+  //----------------------------------------------------------------------------
+  struct Conn
+  {
+    Conn(): fd( -1 ), shakes( 0 ), errors( 0 ) {}
+    int                   fd;
+    long                  shakes;
+    long                  errors;
+    std::vector<uint32_t> latency;
+  };
+
+  void *Serve( void *arg )
+  {
+    Conn       *c = (Conn*)arg;
+    XrdNetAddr  client;
+    client.Set( "localhost", 0 );
+
+    XrdSecProtocol *prot = 0;
+    int   status, len;
+    char *data;
+    while( Recv( c->fd, status, data, len ) )
+    {
+      // the client is done and sends the latencies
+      if( status )
+      {
+        uint32_t *lat = (uint32_t*)data;
+        c->latency.assign( lat, lat + len / sizeof( uint32_t ) );
+        free( data );
+        break;
+      }
+      if( !prot )
+      {
+        XrdOucErrInfo ei;
+        prot = gsiObject( 's', "localhost", client, 0, &ei );
+      }
+      XrdSecCredentials  cred( data, len );
+      XrdSecParameters  *parm = 0;
+      XrdOucErrInfo      ei;
+      int rc = prot ? prot->Authenticate( &cred, &parm, &ei ) : -1;
+      if( rc > 0 && parm )
+        Send( c->fd, 1, parm->buffer, parm->size );
+      else
+      {
+        if( rc == 0 ) ++c->shakes;
+        else
+        {
+          if( !c->errors )
+            fprintf( stderr, "Authenticate: %s\n", ei.getErrText() );
+          ++c->errors;
+        }
+        Send( c->fd, rc < 0 ? -1 : 0, 0, 0 );
+        if( prot ) prot->Delete();
+        prot = 0;
+      }
+      delete parm;
+    }
+    if( prot ) prot->Delete();
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Client: reconnect over and over, send the latencies at the end
+  //----------------------------------------------------------------------------
+  int Client( int fd, const char *srvParms )
+  {
+    XrdOucErrInfo ei;
+    if( !gsiInit( 'c', 0, &ei ) )
+    {
+      fprintf( stderr, "Client init: %s\n", ei.getErrText() );
+      return 1;
+    }
+    XrdNetAddr server;
+    server.Set( "localhost", 1094 );
+
+    std::vector<uint32_t> latency;
+    for( int i = 0; i < nShakes; ++i )
+    {
+      uint64_t        start = XrdBench::Now();
+      XrdSecProtocol *prot  = gsiObject( 'c', "localhost", server, srvParms,
+                                         &ei );
+      XrdSecParameters *parm = 0;
+      int status = 1;
+      while( prot && status > 0 )
+      {
+        XrdSecCredentials *cred = prot->getCredentials( parm, &ei );
+        delete parm; parm = 0;
+        if( !cred )
+        {
+          fprintf( stderr, "getCredentials: %s\n", ei.getErrText() );
+          status = -1;
+          break;
+        }
+        char *data; int len;
+        bool ok = Send( fd, 0, cred->buffer, cred->size ) &&
+                  Recv( fd, status, data, len );
+        delete cred;
+        if( !ok ) return 1;
+        if( status > 0 ) parm = new XrdSecParameters( data, len );
+        else free( data );
+      }
+      if( prot ) prot->Delete();
+      if( status < 0 ) return 1;
+      XrdBench::Record( latency, start );
+    }
+    return Send( fd, 1, (char*)&latency[0],
+                 latency.size() * sizeof( uint32_t ) ) ? 0 : 1;
+  }
+
+  void Usage( const char *prog )
+  {
+    XrdBench::Usage( prog, "-d <CA dir> -c <server cert> -k <server key> "
+                     "-p <user proxy> [-n <handshakes per client>] "
+                     "[-t <clients>] [-o <server options>]" );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  const char *caDir = 0, *cert = 0, *key = 0, *proxy = 0, *opts = "";
+  int opt;
+  while( ( opt = getopt( argc, argv, "d:c:k:p:n:t:o:" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 'd': caDir    = optarg;         break;
+      case 'c': cert     = optarg;         break;
+      case 'k': key      = optarg;         break;
+      case 'p': proxy    = optarg;         break;
+      case 'n': nShakes  = atoi( optarg ); break;
+      case 't': nClients = atoi( optarg ); break;
+      case 'o': opts     = optarg;         break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( !caDir || !cert || !key || !proxy || nShakes < 1 || nClients < 1 )
+    Usage( argv[0] );
+
+  void *lib = dlopen( "libXrdSecgsi-4.so", RTLD_NOW | RTLD_GLOBAL );
+  if( !lib )
+  {
+    fprintf( stderr, "%s\n", dlerror() );
+    return 1;
+  }
+  gsiInit   = (Init_t)dlsym( lib, "XrdSecProtocolgsiInit" );
+  gsiObject = (Object_t)dlsym( lib, "XrdSecProtocolgsiObject" );
+  if( !gsiInit || !gsiObject )
+  {
+    fprintf( stderr, "Not a gsi library\n" );
+    return 1;
+  }
+  signal( SIGPIPE, SIG_IGN );
+
+  //----------------------------------------------------------------------------
+  // Start the clients, they initialize after the fork
+  //----------------------------------------------------------------------------
+  XrdOucString srvOpts = "-certdir:";
+  srvOpts += caDir; srvOpts += " -cert:"; srvOpts += cert;
+  srvOpts += " -key:"; srvOpts += key; srvOpts += " -gmapopt:0 ";
+  srvOpts += opts;
+
+  setenv( "XrdSecGSICADIR",     caDir, 1 );
+  setenv( "XrdSecGSIUSERPROXY", proxy, 1 );
+  setenv( "XrdSecGSIUSERCERT",  "/dev/null", 1 );
+  setenv( "XrdSecGSIUSERKEY",   "/dev/null", 1 );
+
+  std::vector<Conn>  conns( nClients );
+  std::vector<pid_t> pids( nClients );
+  for( int i = 0; i < nClients; ++i )
+  {
+    int sp[2];
+    if( socketpair( AF_UNIX, SOCK_STREAM, 0, sp ) ) return 1;
+    if( !( pids[i] = fork() ) )
+    {
+      close( sp[0] );
+      char *srvParms = 0;
+      int   status, len;
+      if( !Recv( sp[1], status, srvParms, len ) ) _exit( 1 );
+      _exit( Client( sp[1], srvParms ) );
+    }
+    close( sp[1] );
+    conns[i].fd = sp[0];
+  }
+
+  //----------------------------------------------------------------------------
+  // Start the server
+  //----------------------------------------------------------------------------
+  XrdOucErrInfo ei;
+  char *srvParms = gsiInit( 's', srvOpts.c_str(), &ei );
+  if( !srvParms )
+  {
+    fprintf( stderr, "Server init: %s\n", ei.getErrText() );
+    return 1;
+  }
+  if( !strncmp( srvParms, "gsi,", 4 ) ) srvParms += 4;
+
+  double   cpu0  = CPU( RUSAGE_SELF );
+  uint64_t start = XrdBench::Now();
+  std::vector<pthread_t> tids( nClients );
+  for( int i = 0; i < nClients; ++i )
+  {
+    Send( conns[i].fd, 0, srvParms, strlen( srvParms ) );
+    pthread_create( &tids[i], 0, Serve, &conns[i] );
+  }
+  for( int i = 0; i < nClients; ++i )
+    pthread_join( tids[i], 0 );
+  double elapsed = ( XrdBench::Now() - start ) / 1e9;
+  double cpu     = CPU( RUSAGE_SELF ) - cpu0;
+
+  //----------------------------------------------------------------------------
+  // Collect the latencies and report
+  //----------------------------------------------------------------------------
+  std::vector<uint32_t> all;
+  long shakes = 0, errors = 0;
+  for( int i = 0; i < nClients; ++i )
+  {
+    int st;
+    waitpid( pids[i], &st, 0 );
+    if( !WIFEXITED( st ) || WEXITSTATUS( st ) ) ++errors;
+    shakes += conns[i].shakes;
+    errors += conns[i].errors;
+    all.insert( all.end(), conns[i].latency.begin(),
+                conns[i].latency.end() );
+  }
+  double clientCPU = CPU( RUSAGE_CHILDREN );
+  std::sort( all.begin(), all.end() );
+
+  printf( "%d clients, %ld handshakes in %.2f s: %.1f handshakes/s\n",
+          nClients, shakes, elapsed, shakes / elapsed );
+  if( shakes )
+    printf( "cpu per handshake: server %.3f ms, client %.3f ms\n",
+            cpu * 1e3 / shakes, clientCPU * 1e3 / shakes );
+  if( !all.empty() )
+    printf( "handshake %s\n", XrdBench::Percentiles( all, "ms" ).c_str() );
+  if( errors )
+    printf( "%ld handshakes failed\n", errors );
+  return errors ? 1 : 0;
+}
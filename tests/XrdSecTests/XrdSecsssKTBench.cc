@@ -0,0 +1,219 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Look up sss keys from many threads at once, the way the server does it for
+// every authentication, while the keytab is being reloaded, and report the
+// lookup rate and latency.
+//
+// Usage: xrdsecsss-kt-bench [-t <threads>] [-n <lookups per thread>]
+//                           [-k <keys>] [-r] [-N]
+//
+// A keytab with -k keys (one key name per ten keys) is written to a temporary
+// file. The threads look the keys up by key number like the server, with -N
+// by key name like the client. With -r the keytab file keeps being touched so
+// that the refresh thread reads it in again every second during the run.
+//------------------------------------------------------------------------------
+
+#include "BenchUtils.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdSecsss/XrdSecsssKT.hh"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Settings and per thread state
+  //----------------------------------------------------------------------------
+  int         nThreads = 8;
+  long        nLookups = 200000;
+  int         nKeys    = 1000;
+  bool        reload   = false;
+  bool        byName   = false;
+  XrdSecsssKT *keyTab  = 0;
+  volatile bool running = true;
+
+  struct Key
+  {
+    long long ID;
+    char      Name[XrdSecsssKT::ktEnt::NameSZ];
+    char      Val[XrdSecsssKT::ktEnt::maxKLen];
+    int       Len;
+  };
+  std::vector<Key> keys;
+
+  //----------------------------------------------------------------------------
+  // Do the lookups
+  //----------------------------------------------------------------------------
+  void *Run( void *arg )
+  {
+    XrdBench::Worker *w = (XrdBench::Worker*)arg;
+    w->latency.reserve( nLookups );
+    for( long i = 0; i < nLookups; ++i )
+    {
+      const Key &k = keys[XrdBench::Next( w->seed ) % keys.size()];
+      XrdSecsssKT::ktEnt ent;
+      if( byName ) strcpy( ent.Data.Name, k.Name );
+        else ent.Data.ID = k.ID;
+
+      uint64_t start = XrdBench::Now();
+      int      rc    = keyTab->getKey( ent );
+      XrdBench::Record( w->latency, start );
+
+      if( rc || strcmp( ent.Data.Name, k.Name ) ||
+          ( !byName && ( ent.Data.Len != k.Len ||
+                         memcmp( ent.Data.Val, k.Val, k.Len ) ) ) )
+        ++w->errors;
+    }
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Make the refresh thread see a new keytab file every so often
+  //----------------------------------------------------------------------------
+  void *Touch( void *arg )
+  {
+    const char *path = (const char*)arg;
+    time_t      mt   = time( 0 );
+    while( running )
+    {
+      usleep( 100000 );
+      struct timeval tv[2] = { { ++mt, 0 }, { mt, 0 } };
+      utimes( path, tv );
+    }
+    return 0;
+  }
+
+  void Usage( const char *prog )
+  {
+    XrdBench::Usage( prog, "[-t <threads>] [-n <lookups per thread>] "
+                     "[-k <keys>] [-r] [-N]" );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  int opt;
+  while( ( opt = getopt( argc, argv, "t:n:k:rN" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 't': nThreads = atoi( optarg );                  break;
+      case 'n': nLookups = atol( optarg );                  break;
+      case 'k': nKeys    = atoi( optarg );                  break;
+      case 'r': reload   = true;                            break;
+      case 'N': byName   = true;                            break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( nThreads < 1 || nLookups < 1 || nKeys < 1 )
+    Usage( argv[0] );
+
+  //----------------------------------------------------------------------------
+  // Write the keytab the way xrdsssadmin does
+  //----------------------------------------------------------------------------
+  char path[] = "/tmp/xrdsecsss-kt-bench.XXXXXX";
+  int  fd     = mkstemp( path );
+  if( fd < 0 )
+  {
+    perror( "mkstemp" );
+    return 1;
+  }
+  close( fd );
+  unlink( path );
+
+  XrdOucErrInfo eInfo;
+  XrdSecsssKT  *admin = new XrdSecsssKT( &eInfo, path, XrdSecsssKT::isAdmin );
+  for( int i = 0; i < nKeys; ++i )
+  {
+    XrdSecsssKT::ktEnt *ent = new XrdSecsssKT::ktEnt;
+    snprintf( ent->Data.Name, sizeof( ent->Data.Name ), "service%d", i / 10 );
+    snprintf( ent->Data.User, sizeof( ent->Data.User ), "user%d", i % 10 );
+    strcpy( ent->Data.Grup, "nogroup" );
+    ent->Data.Len = 32;
+    ent->Data.Exp = 0;
+    admin->addKey( *ent );
+  }
+  int numKeys, numTot, numExp, rc;
+  if( ( rc = admin->Rewrite( 0, numKeys, numTot, numExp ) ) )
+  {
+    fprintf( stderr, "Unable to write the keytab: %s\n", strerror( rc ) );
+    return 1;
+  }
+  delete admin;
+
+  //----------------------------------------------------------------------------
+  // Load it like the server and remember what the lookups should find
+  //----------------------------------------------------------------------------
+  keyTab = new XrdSecsssKT( &eInfo, path, XrdSecsssKT::isServer, 1 );
+  if( eInfo.getErrInfo() )
+  {
+    fprintf( stderr, "Unable to load the keytab: %s\n", eInfo.getErrText() );
+    unlink( path );
+    return 1;
+  }
+  for( XrdSecsssKT::ktEnt *ktP = keyTab->keyList(); ktP; ktP = ktP->Next )
+  {
+    if( byName && !keys.empty() &&
+        !strcmp( keys.back().Name, ktP->Data.Name ) )
+      continue;
+    Key k;
+    k.ID  = ktP->Data.ID;
+    k.Len = ktP->Data.Len;
+    strcpy( k.Name, ktP->Data.Name );
+    memcpy( k.Val, ktP->Data.Val, k.Len );
+    keys.push_back( k );
+  }
+
+  //----------------------------------------------------------------------------
+  // Run
+  //----------------------------------------------------------------------------
+  std::vector<XrdBench::Worker> workers( nThreads );
+  pthread_t                     toucher;
+  if( reload ) pthread_create( &toucher, 0, Touch, path );
+  double elapsed = XrdBench::Run( workers, Run );
+  running = false;
+  if( reload ) pthread_join( toucher, 0 );
+
+  //----------------------------------------------------------------------------
+  // Report
+  //----------------------------------------------------------------------------
+  std::vector<uint32_t> all;
+  long errors = XrdBench::Collect( workers, all );
+
+  printf( "%d threads, %d keys, lookups by %s, %s\n", nThreads, numKeys,
+          byName ? "name" : "number",
+          reload ? "keytab reloaded during the run" : "no reloads" );
+  printf( "%.0f lookups/s, %s\n", all.size() / elapsed,
+          XrdBench::Percentiles( all ).c_str() );
+  if( errors )
+    printf( "%ld lookups failed or returned the wrong key\n", errors );
+
+  delete keyTab;
+  unlink( path );
+  return errors ? 1 : 0;
+}
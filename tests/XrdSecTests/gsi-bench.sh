@@ -0,0 +1,69 @@
+#!/bin/bash
+#-------------------------------------------------------------------------------
+# GSI handshake benchmark: make a throw away CA, a host certificate and a user
+# proxy and run xrdsecgsi-bench with them.
+#
+# Usage: gsi-bench.sh <build dir> [handshakes per client] [clients]
+#                     [server options]
+#
+# The server options are given to the gsi server like in the sec.protocol
+# directive, e.g. "-chainto:300" to switch the verified chains cache on.
+#-------------------------------------------------------------------------------
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <build dir> [handshakes per client] [clients] [server options]" 1>&2
+  exit 1
+fi
+
+BUILD=`cd $1 && pwd`
+NUM=${2:-1000}
+CLIENTS=${3:-1}
+OPTS=$4
+
+BENCH=$BUILD/tests/XrdSecTests/xrdsecgsi-bench
+PROXY=$BUILD/src/xrdgsiproxy
+export LD_LIBRARY_PATH=$BUILD/src:$BUILD/src/XrdCl:$LD_LIBRARY_PATH
+
+WORK=`mktemp -d /tmp/gsi-bench.XXXXXX`
+mkdir -p $WORK/certs
+
+cleanup()
+{
+  rm -rf $WORK
+}
+trap cleanup EXIT
+
+#-------------------------------------------------------------------------------
+# The CA
+#-------------------------------------------------------------------------------
+openssl req -x509 -newkey rsa:2048 -nodes -days 2 -subj "/O=Bench/CN=Bench CA" \
+  -keyout $WORK/ca.key -out $WORK/ca.pem \
+  -addext basicConstraints=critical,CA:true \
+  -addext keyUsage=critical,keyCertSign,cRLSign > /dev/null 2>&1 || exit 1
+cp $WORK/ca.pem $WORK/certs/`openssl x509 -in $WORK/ca.pem -noout -hash`.0
+cp $WORK/ca.pem $WORK/certs/`openssl x509 -in $WORK/ca.pem -noout -subject_hash_old`.0
+
+#-------------------------------------------------------------------------------
+# The host and the user certificates and the user proxy
+#-------------------------------------------------------------------------------
+echo "keyUsage=critical,digitalSignature,keyEncipherment" > $WORK/ext
+echo "basicConstraints=critical,CA:false" >> $WORK/ext
+
+for WHO in srv:localhost usr:user; do
+  NAME=${WHO%%:*}
+  openssl req -newkey rsa:2048 -nodes -subj "/O=Bench/CN=${WHO#*:}" \
+    -keyout $WORK/$NAME.key -out $WORK/$NAME.csr > /dev/null 2>&1 || exit 1
+  openssl x509 -req -in $WORK/$NAME.csr -CA $WORK/ca.pem -CAkey $WORK/ca.key \
+    -CAcreateserial -days 2 -extfile $WORK/ext -out $WORK/$NAME.pem \
+    > /dev/null 2>&1 || exit 1
+  chmod 400 $WORK/$NAME.key
+done
+
+$PROXY init -cert $WORK/usr.pem -key $WORK/usr.key -certdir $WORK/certs \
+  -out $WORK/proxy -valid 24:00 > /dev/null || exit 1
+
+#-------------------------------------------------------------------------------
+# Run
+#-------------------------------------------------------------------------------
+$BENCH -d $WORK/certs -c $WORK/srv.pem -k $WORK/srv.key -p $WORK/proxy \
+  -n $NUM -t $CLIENTS ${OPTS:+-o "$OPTS"}
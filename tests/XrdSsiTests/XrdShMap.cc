@@ -34,6 +34,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <sys/wait.h>
 #include <string>
 #include <string.h>
 #include <stdio.h>
@@ -133,6 +136,16 @@ const char *attHelp[] =
  "    The 'r' argument attaches it as read/only while 'w' attaches it read/write."
 };
 
+const char *bchHelp[] =
+{"bench {r|u} <numkeys> <procs> <sec>",
+ "    Start <procs> processes that attach the exported map read/only and fetch",
+ "    random keys, formed as for 'verify', for <sec> seconds. The aggregate",
+ "    lookup rate is displayed along with any missing keys or incorrect values.",
+ "    Specify 'r' to only read or 'u' to have this process, which must be",
+ "    attached r/w, keep replacing keys meanwhile. The values it stores change",
+ "    on every pass but still tell the key, so torn reads are counted as well."
+};
+
 const char *creHelp[] =
 {"cr[eate] {[m][s][r][u][=]}",
  "    Create a shared memory identified by the -p command line option.",
@@ -292,6 +305,7 @@ theHelp helpInfo[] =
  theHelp("-t",  0,        CLtHelp, sizeof(CLtHelp)),
  theHelp("add", 0,        addHelp, sizeof(addHelp)),
  theHelp("att", "attach", attHelp, sizeof(attHelp)),
+ theHelp("bench",  0,     bchHelp, sizeof(bchHelp)),
  theHelp("cr",  "create", creHelp, sizeof(creHelp)),
  theHelp("del", "delete", dleHelp, sizeof(dleHelp)),
  theHelp("det", "detach", detHelp, sizeof(detHelp)),
@@ -495,6 +509,121 @@ int DoX32(const char *key)
    return (hval ? hval : 1);
 }
 
+/******************************************************************************/
+/*                               D o B e n c h                                */
+/******************************************************************************/
+
+namespace
+{
+struct BenchResult {long long gets; long long miss; long long bad;};
+
+double BenchTime()
+{
+   struct timeval tv;
+   gettimeofday(&tv, 0);
+   return tv.tv_sec + tv.tv_usec/1000000.0;
+}
+
+void BenchReader(int numkeys, int secs, int num, int wfd)
+{
+   XrdSsi::ShMap<int> rMap("int", hashF);
+   BenchResult res = {0, 0, 0};
+   unsigned int seed = getpid();
+   double tEnd;
+   char key[256];
+   int k, kval;
+
+// Attach the map, we want to measure lookups not the attach
+//
+   if (!rMap.Attach(path, XrdSsi::ReadOnly, tmo))
+      {UMSG("attach map in reader " <<num);
+       _exit(1);
+      }
+
+// Fetch random keys until the time is up
+//
+   tEnd = BenchTime() + secs;
+   do {for (int i = 0; i < 1024; i++)
+           {k = rand_r(&seed) % numkeys;
+            sprintf(key, "%s%d", keyPfx, k);
+            if (!rMap.Get(key, kval)) res.miss++;
+               else if (kval < 0 || kval % numkeys != k) res.bad++;
+           }
+       res.gets += 1024;
+      } while(BenchTime() < tEnd);
+
+// Report back
+//
+   if (write(wfd, &res, sizeof(res)) != (ssize_t)sizeof(res)) _exit(1);
+   _exit(0);
+}
+
+void DoBench(int numkeys, int procs, int secs, bool upd)
+{
+   BenchResult res, tot = {0, 0, 0};
+   long long reps = 0;
+   double tBeg, tEnd;
+   char key[256];
+   int pfd[2], n = 0, pass = 0, maxPass = 0x7fffffff/numkeys - 1;
+
+// Get a pipe to collect the results
+//
+   if (pipe(pfd)) {UMSG("create pipe"); return;}
+
+// Start the readers
+//
+   tBeg = BenchTime();
+   for (int i = 0; i < procs; i++)
+       {pid_t pid = fork();
+        if (!pid) {close(pfd[0]); BenchReader(numkeys, secs, i, pfd[1]);}
+        if (pid < 0) {UMSG("fork reader"); break;}
+        n++;
+       }
+   close(pfd[1]);
+
+// Keep updating the keys, if so wanted, while the readers run. Each pass
+// stores other values, all of them the key modulo the number of keys.
+//
+   if (upd)
+      {tEnd = tBeg + secs;
+       while(BenchTime() < tEnd)
+            {pass = (pass < maxPass ? pass+1 : 0);
+             for (int k = 0; k < numkeys && k < 1024; k++)
+                 {int kval = k + pass*numkeys;
+                  sprintf(key, "%s%d", keyPfx, k);
+                  if (!theMap->Rep(key, kval))
+                     {UMSG("rep key " <<key); break;}
+                  reps++;
+                 }
+            }
+       for (int k = 0; k < numkeys && k < 1024; k++)
+           {sprintf(key, "%s%d", keyPfx, k);
+            theMap->Rep(key, k);
+           }
+      }
+
+// Collect the results
+//
+   for (int i = 0; i < n; i++)
+       {if (read(pfd[0], &res, sizeof(res)) != (ssize_t)sizeof(res)) break;
+        tot.gets += res.gets; tot.miss += res.miss; tot.bad += res.bad;
+       }
+   while(wait(0) > 0) {}
+   close(pfd[0]);
+   tEnd = BenchTime() - tBeg;
+
+// Display what happened
+//
+   cout <<n <<" readers: " <<tot.gets <<" gets in " <<tEnd <<" sec = "
+        <<static_cast<long long>(tot.gets/tEnd) <<" gets/sec ("
+        <<static_cast<long long>(tot.gets/tEnd/(n ? n : 1)) <<" per reader)"
+        <<endl;
+   if (upd) cout <<reps <<" replacements done meanwhile" <<endl;
+   if (tot.miss) EMSG(tot.miss <<" keys not found!");
+   if (tot.bad)  EMSG(tot.bad  <<" keys with an incorrect value!");
+}
+}
+
 /******************************************************************************/
 /*                                D o D u m p                                 */
 /******************************************************************************/
@@ -527,7 +656,7 @@ void DoInfo()
 {
    const char *vname[] = {"flockro", "flockrw",  "indexsz",  "indexused",
                           "keys",    "keysfree", "maxkeylen",
-                          "multw",   "reuse",    "typesz", 0};
+                          "multw",   "reuse",    "seqlock",  "typesz", 0};
    int n, i = 0;
    char iBuff[256];
 
@@ -735,6 +864,27 @@ while(true)
             continue;
            }
 
+      IFCMD1("bench")
+           {int procs, secs;
+            if (!(theOp = Token("bench argument"))) continue;
+            if (strcmp(theOp, "r") && strcmp(theOp, "u"))
+               {EMSG("Unknown bench option - " <<theOp); continue;}
+            if (!(val = Token("bench key count"))) continue;
+            numkeys = strtol(val, &xval, 10);
+            if (numkeys <= 0 || *xval)
+               {EMSG("number of keys to fetch is invalid."); continue;}
+            if (!(val = Token("bench process count"))) continue;
+            procs = strtol(val, &xval, 10);
+            if (procs <= 0 || *xval)
+               {EMSG("number of processes is invalid."); continue;}
+            if (!(val = Token("bench seconds"))) continue;
+            secs = strtol(val, &xval, 10);
+            if (secs <= 0 || *xval)
+               {EMSG("number of seconds is invalid."); continue;}
+            DoBench(numkeys, procs, secs, *theOp == 'u');
+            continue;
+           }
+
       IFCMD2("cr", "create")
            {int attOpts = 0;
             if (!(theOp = Token("create argument"))) continue;
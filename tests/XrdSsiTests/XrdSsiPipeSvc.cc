@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Server side of the pipelined request test (see XrdSsiPipeTest.cc), loaded
+// with "ssi.svclib". The first byte of a request selects how it is answered:
+//
+//   d - respond with "resp:<request>" right away
+//   s - the same after a short sleep, so that the write reply comes first
+//   a - send an alert "alert:<request>" and then respond as for d
+//   e - respond with the error "err:<request>"
+//------------------------------------------------------------------------------
+
+#include "XrdSsi/XrdSsiProvider.hh"
+#include "XrdSsi/XrdSsiRequest.hh"
+#include "XrdSsi/XrdSsiResource.hh"
+#include "XrdSsi/XrdSsiResponder.hh"
+#include "XrdSsi/XrdSsiService.hh"
+#include "XrdVersion.hh"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Alert message, it deletes itself once sent
+  //----------------------------------------------------------------------------
+  class PipeAlert : public XrdSsiRespInfoMsg
+  {
+    public:
+      PipeAlert( const std::string &msg ):
+        XrdSsiRespInfoMsg( 0, 0 ), text( msg )
+      {
+        msgBuf = (char*)text.c_str();
+        msgLen = text.size();
+      }
+
+      void RecycleMsg( bool sent = true ) { delete this; }
+
+    private:
+      std::string text;
+  };
+
+  //----------------------------------------------------------------------------
+  // One request
+  //----------------------------------------------------------------------------
+  class PipeResponder : public XrdSsiResponder
+  {
+    public:
+      void Respond( XrdSsiRequest &rqst )
+      {
+        BindRequest( rqst );
+
+        int   dlen;
+        char *data = GetRequest( dlen );
+        std::string req( data ? data : "", data ? dlen : 0 );
+        ReleaseRequestBuffer();
+
+        char how = req.empty() ? 'd' : req[0];
+        if( how == 's' ) usleep( 2000 );
+        if( how == 'a' ) Alert( *new PipeAlert( "alert:" + req ) );
+        if( how == 'e' )
+        {
+          result = "err:" + req;
+          SetErrResponse( result.c_str(), EIO );
+          return;
+        }
+        result = "resp:" + req;
+        SetResponse( result.c_str(), result.size() );
+      }
+
+      void Finished( XrdSsiRequest &rqst, const XrdSsiRespInfo &rInfo,
+                     bool cancel = false )
+      {
+        UnBindRequest();
+        delete this;
+      }
+
+    private:
+      std::string result;
+  };
+
+  //----------------------------------------------------------------------------
+  // The service and the provider
+  //----------------------------------------------------------------------------
+  class PipeService : public XrdSsiService
+  {
+    public:
+      void ProcessRequest( XrdSsiRequest &rqst, XrdSsiResource &rsrc )
+      {
+        ( new PipeResponder() )->Respond( rqst );
+      }
+  };
+
+  class PipeProvider : public XrdSsiProvider
+  {
+    public:
+      XrdSsiService *GetService( XrdSsiErrInfo &eInfo,
+                                 const std::string &contact, int oHold = 256 )
+      {
+        return &service;
+      }
+
+      bool Init( XrdSsiLogger *logP, XrdSsiCluster *clsP, std::string cfgFn,
+                 std::string parms, int argc, char **argv )
+      {
+        return true;
+      }
+
+      rStat QueryResource( const char *rName, const char *contact = 0 )
+      {
+        return isPresent;
+      }
+
+    private:
+      PipeService service;
+  };
+
+  PipeProvider provider;
+}
+
+XrdSsiProvider *XrdSsiProviderServer = &provider;
+XrdSsiProvider *XrdSsiProviderLookup = &provider;
+
+XrdVERSIONINFO( XrdSsiProviderServer, XrdSsiPipeSvc );
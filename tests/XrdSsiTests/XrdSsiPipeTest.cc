@@ -0,0 +1,251 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Run requests against the XrdSsiPipeSvc service in multiplexed mode, where the
+// wait for the response is pipelined behind the request write, and check that
+// every request is answered exactly once with the right response, alert or
+// error, and that nothing is called back after Finished().
+//
+// Usage: xrdssi-pipe-test [-c] [-n <requests>] [-p <in flight>] <host:port>
+//
+// XRDSSIMUX is set unless -c is given, which runs the same requests in the
+// classic mode for comparison. See ssi-pipe-test.sh for a way to run it
+// against a throw away server.
+//------------------------------------------------------------------------------
+
+#include "XrdSsi/XrdSsiProvider.hh"
+#include "XrdSsi/XrdSsiRequest.hh"
+#include "XrdSsi/XrdSsiResource.hh"
+#include "XrdSsi/XrdSsiService.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+extern XrdSsiProvider *XrdSsiProviderClient;
+
+namespace
+{
+  XrdSysSemaphore inFlight( 0 );
+  XrdSysMutex     errMutex;
+  int             errors = 0;
+
+  void Fail( const std::string &req, const char *what )
+  {
+    XrdSysMutexHelper lck( errMutex );
+    fprintf( stderr, "request %s: %s\n", req.c_str(), what );
+    ++errors;
+  }
+
+  //----------------------------------------------------------------------------
+  // One request, it stays around until the end so that late callbacks are
+  // seen instead of landing in freed memory
+  //----------------------------------------------------------------------------
+  class PipeRequest : public XrdSsiRequest
+  {
+    public:
+      PipeRequest( const std::string &req ):
+        request( req ), responses( 0 ), alerts( 0 ), finished( false ) {}
+
+      ~PipeRequest() {}
+
+      char *GetRequest( int &dlen )
+      {
+        dlen = request.size();
+        return (char*)request.c_str();
+      }
+
+      void Alert( XrdSsiRespInfoMsg &aMsg )
+      {
+        int   mlen;
+        char *msg = aMsg.GetMsg( mlen );
+        {
+          XrdSysMutexHelper lck( myMutex );
+          if( finished ) Fail( request, "alert after Finished()" );
+          if( responses ) Fail( request, "alert after the response" );
+          ++alerts;
+        }
+        if( request[0] != 'a' ) Fail( request, "unexpected alert" );
+        else if( std::string( msg, mlen ) != "alert:" + request )
+          Fail( request, "wrong alert" );
+        aMsg.RecycleMsg();
+      }
+
+      bool ProcessResponse( const XrdSsiErrInfo &eInfo,
+                            const XrdSsiRespInfo &rInfo )
+      {
+        {
+          XrdSysMutexHelper lck( myMutex );
+          if( finished ) Fail( request, "response after Finished()" );
+          if( ++responses > 1 ) Fail( request, "second response" );
+        }
+
+        switch( rInfo.rType )
+        {
+          case XrdSsiRespInfo::isData:
+            Check( std::string( rInfo.buff, rInfo.blen ) );
+            break;
+          case XrdSsiRespInfo::isError:
+            Check( std::string( "err:" ) + ( rInfo.eMsg ? rInfo.eMsg : "" ) );
+            break;
+          case XrdSsiRespInfo::isStream:
+            GetResponseData( buff, sizeof( buff ) );
+            return true;
+          default:
+            Fail( request, "unexpected response type" );
+            Done();
+        }
+        return true;
+      }
+
+      PRD_Xeq ProcessResponseData( const XrdSsiErrInfo &eInfo, char *data,
+                                   int dlen, bool last )
+      {
+        if( dlen < 0 )
+        {
+          Check( "err:" + eInfo.Get() );
+          return PRD_Normal;
+        }
+        streamed.append( data, dlen );
+        if( last || !dlen )
+        {
+          Check( streamed );
+          return PRD_Normal;
+        }
+        GetResponseData( buff, sizeof( buff ) );
+        return PRD_Normal;
+      }
+
+      //------------------------------------------------------------------------
+      // Verify the final tally once everything has settled
+      //------------------------------------------------------------------------
+      void Verify()
+      {
+        XrdSysMutexHelper lck( myMutex );
+        if( responses != 1 ) Fail( request, "not answered exactly once" );
+        if( alerts != ( request[0] == 'a' ? 1 : 0 ) )
+          Fail( request, "wrong number of alerts" );
+      }
+
+    private:
+      void Check( const std::string &got )
+      {
+        std::string want = ( request[0] == 'e' ? "err:err:" : "resp:" );
+        if( got != want + request )
+          Fail( request, ( "wrong response '" + got + "'" ).c_str() );
+        Done();
+      }
+
+      void Done()
+      {
+        {
+          XrdSysMutexHelper lck( myMutex );
+          finished = true;
+        }
+        Finished();
+        inFlight.Post();
+      }
+
+      std::string  request;
+      std::string  streamed;
+      char         buff[4096];
+      XrdSysMutex  myMutex;
+      int          responses;
+      int          alerts;
+      bool         finished;
+  };
+
+  void Usage( const char *prog )
+  {
+    fprintf( stderr, "Usage: %s [-c] [-n <requests>] [-p <in flight>] "
+             "<host:port>\n", prog );
+    exit( 1 );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  int  nReqs = 2000, nPipe = 16, opt;
+  bool classic = false;
+  while( ( opt = getopt( argc, argv, "cn:p:" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 'c': classic = true; break;
+      case 'n': nReqs = atoi( optarg ); break;
+      case 'p': nPipe = atoi( optarg ); break;
+      default:  Usage( argv[0] );
+    }
+  }
+  if( optind != argc - 1 || nReqs < 1 || nPipe < 1 ) Usage( argv[0] );
+  if( classic ) unsetenv( "XRDSSIMUX" );
+    else setenv( "XRDSSIMUX", "1", 1 );
+
+  XrdSsiErrInfo  eInfo;
+  XrdSsiService *service = XrdSsiProviderClient->GetService( eInfo,
+                                                             argv[optind] );
+  if( !service )
+  {
+    fprintf( stderr, "Unable to get the service: %s\n",
+             eInfo.Get().c_str() );
+    return 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Cycle through the ways of answering with at most nPipe requests in flight
+  //----------------------------------------------------------------------------
+  static const char how[] = { 'd', 's', 'a', 'e' };
+  std::vector<PipeRequest*> reqs;
+  XrdSsiResource rsrc( "/pipetest", "", "", "", XrdSsiResource::Reusable );
+  char buff[32];
+
+  for( int i = 0; i < nPipe && i < nReqs; ++i ) inFlight.Post();
+  for( int i = 0; i < nReqs; ++i )
+  {
+    inFlight.Wait();
+    snprintf( buff, sizeof( buff ), "%c%d", how[i % sizeof( how )], i );
+    reqs.push_back( new PipeRequest( buff ) );
+    service->ProcessRequest( *reqs.back(), rsrc );
+  }
+  for( int i = 0; i < nPipe && i < nReqs; ++i ) inFlight.Wait();
+
+  //----------------------------------------------------------------------------
+  // Give stray callbacks a chance to show up, then check the tally
+  //----------------------------------------------------------------------------
+  sleep( 1 );
+  for( size_t i = 0; i < reqs.size(); ++i )
+  {
+    reqs[i]->Verify();
+    delete reqs[i];
+  }
+
+  printf( "%d requests, %d in flight%s: %d errors\n", nReqs, nPipe,
+          classic ? " (classic)" : "", errors );
+
+  //----------------------------------------------------------------------------
+  // The reusable session keeps the service busy, so it cannot be stopped and
+  // the client threads are still around. Don't tear them down at exit.
+  //----------------------------------------------------------------------------
+  fflush( stdout );
+  _exit( errors ? 1 : 0 );
+}
@@ -0,0 +1,66 @@
+#!/bin/bash
+#-------------------------------------------------------------------------------
+# Pipelined request test: start a throw away xrootd serving the XrdSsiPipeSvc
+# service and run xrdssi-pipe-test against it in multiplexed mode.
+#
+# Usage: ssi-pipe-test.sh <build dir> [requests] [in flight]
+#
+# The server listens on XRDSSI_PIPE_PORT, 21094 by default.
+#-------------------------------------------------------------------------------
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <build dir> [requests] [in flight]" 1>&2
+  exit 1
+fi
+
+BUILD=`cd $1 && pwd`
+NUM=${2:-2000}
+PIPE=${3:-16}
+PORT=${XRDSSI_PIPE_PORT:-21094}
+
+TEST=$BUILD/tests/XrdSsiTests/xrdssi-pipe-test
+SVC=$BUILD/tests/XrdSsiTests/libXrdSsiPipeSvc.so
+export LD_LIBRARY_PATH=$BUILD/src:$BUILD/src/XrdCl:$LD_LIBRARY_PATH
+
+WORK=`mktemp -d /tmp/ssi-pipe-test.XXXXXX`
+PID=
+
+cleanup()
+{
+  [ -n "$PID" ] && kill $PID 2> /dev/null && wait $PID 2> /dev/null
+  rm -rf $WORK
+}
+trap cleanup EXIT
+
+#-------------------------------------------------------------------------------
+# The server
+#-------------------------------------------------------------------------------
+cat > $WORK/xrootd.cfg <<EOF
+all.role server
+all.export /pipetest
+xrootd.fslib libXrdSsi.so
+ssi.svclib $SVC
+all.adminpath $WORK
+all.pidpath $WORK
+EOF
+
+RUNAS=""
+if [ `id -u` -eq 0 ]; then
+  RUNAS="-R nobody"
+  chown -R nobody $WORK
+fi
+
+$BUILD/src/xrootd -p $PORT -c $WORK/xrootd.cfg -l $WORK/xrootd.log -n pipe \
+  $RUNAS > /dev/null 2>&1 &
+PID=$!
+sleep 2
+if ! kill -0 $PID 2> /dev/null; then
+  echo "xrootd did not start, see below" 1>&2
+  cat `find $WORK -name 'xrootd.log*'` 1>&2
+  exit 1
+fi
+
+#-------------------------------------------------------------------------------
+# Run
+#-------------------------------------------------------------------------------
+$TEST -n $NUM -p $PIPE localhost:$PORT
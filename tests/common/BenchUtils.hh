@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef BENCH_UTILS_HH
+#define BENCH_UTILS_HH
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//! What the benchmarks have in common: the clock, the random numbers, the
+//! worker threads and the latency report
+//------------------------------------------------------------------------------
+namespace XrdBench
+{
+  //----------------------------------------------------------------------------
+  //! Monotonic time in nanoseconds
+  //----------------------------------------------------------------------------
+  inline uint64_t Now()
+  {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return uint64_t( ts.tv_sec ) * 1000000000ULL + ts.tv_nsec;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Next number of a xorshift generator, the state must not be zero
+  //----------------------------------------------------------------------------
+  inline uint64_t Next( uint64_t &x )
+  {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    return x;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Record the time since start, in nanoseconds, as one latency
+  //----------------------------------------------------------------------------
+  inline void Record( std::vector<uint32_t> &latency, uint64_t start )
+  {
+    latency.push_back( uint32_t( std::min<uint64_t>( Now() - start,
+                                                     0xffffffffULL ) ) );
+  }
+
+  //----------------------------------------------------------------------------
+  //! Print the usage and exit
+  //!
+  //! @param prog    name of the program
+  //! @param options the options it takes
+  //----------------------------------------------------------------------------
+  inline void Usage( const char *prog, const char *options )
+  {
+    fprintf( stderr, "Usage: %s %s\n", prog, options );
+    exit( 1 );
+  }
+
+  //----------------------------------------------------------------------------
+  //! State of a worker thread, the benchmarks add their own
+  //----------------------------------------------------------------------------
+  struct Worker
+  {
+    Worker(): seed( 0 ), errors( 0 ) {}
+    uint64_t               seed;
+    long                   errors;
+    std::vector<uint32_t>  latency;   // nanoseconds
+  };
+
+  //----------------------------------------------------------------------------
+  //! Seed the workers, run them on a thread each and wait for them
+  //!
+  //! @return the elapsed time in seconds
+  //----------------------------------------------------------------------------
+  template<class W>
+  double Run( std::vector<W> &workers, void *(*run)( void* ) )
+  {
+    std::vector<pthread_t> tids( workers.size() );
+    uint64_t start = Now();
+    for( size_t i = 0; i < workers.size(); ++i )
+    {
+      workers[i].seed = 0x9e3779b97f4a7c15ULL * ( i + 1 );
+      pthread_create( &tids[i], 0, run, &workers[i] );
+    }
+    for( size_t i = 0; i < workers.size(); ++i )
+      pthread_join( tids[i], 0 );
+    return ( Now() - start ) / 1e9;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Gather the latencies of the workers, sorted, and add up their errors
+  //----------------------------------------------------------------------------
+  template<class W>
+  long Collect( std::vector<W> &workers, std::vector<uint32_t> &all )
+  {
+    long errors = 0;
+    for( size_t i = 0; i < workers.size(); ++i )
+    {
+      all.insert( all.end(), workers[i].latency.begin(),
+                  workers[i].latency.end() );
+      errors += workers[i].errors;
+    }
+    std::sort( all.begin(), all.end() );
+    return errors;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Percentiles of sorted latencies
+  //!
+  //! @param all    the latencies in nanoseconds, sorted, not empty
+  //! @param unit   "us" or "ms"
+  //! @return       e.g. "latency us: p50 0.64 p90 1.06 p99 6.80 p99.9 19.96
+  //!               max 48050.50"
+  //----------------------------------------------------------------------------
+  inline std::string Percentiles( const std::vector<uint32_t> &all,
+                                  const std::string &unit = "us" )
+  {
+    bool   ms  = ( unit == "ms" );
+    double div = ms ? 1e6 : 1e3;
+    size_t n   = all.size();
+    char   buff[256];
+    snprintf( buff, sizeof( buff ), ms ?
+              "latency ms: p50 %.3f p90 %.3f p99 %.3f p99.9 %.3f max %.3f" :
+              "latency us: p50 %.2f p90 %.2f p99 %.2f p99.9 %.2f max %.2f",
+              all[n/2] / div, all[n*9/10] / div, all[n*99/100] / div,
+              all[n*999/1000] / div, all[n-1] / div );
+    return buff;
+  }
+}
+
+#endif // BENCH_UTILS_HH